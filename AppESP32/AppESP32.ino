@@ -3,12 +3,33 @@
 #include <EEPROM.h>
 #include <ArduinoJson.h>
 #include <esp_wifi.h>
+#include <WebSocketsServer.h>
+#include <WebSocketsClient.h>
+#include <WiFiUdp.h>
+#include <HTTPClient.h>
+#include "BodyHub.h"
+#include "ClockSync.h"
 
 #define EEPROM_SIZE 4096
 #define MAX_DEVICES 20
 #define BOOT_BUTTON_PIN 0  // GPIO0 для кнопки Boot
 #define SERIAL_COMMAND_BUFFER_SIZE 128
 
+// Хаб датчиков тела
+#define HUB_WS_PORT 81                 // клиенты получают кадр скелета здесь
+#define HUB_UDP_PORT 4211              // узлы с UDP потоком шлют кадры сюда
+#define HUB_TICK_US 20000UL            // кадр скелета 50 раз в секунду
+#define HUB_ALIGN_DELAY_US 40000UL     // кадр собирается на момент "такт - задержка"
+#define HUB_SYNC_INTERVAL_MS 1000UL    // сверка узлов со списком устройств
+#define HUB_UDP_RENEW_MS 10000UL       // продление UDP подписки (аренда на узле 30 с)
+#define HUB_UDP_SILENCE_MS 3000UL      // UDP узел молчит дольше - подключаемся заново
+#define HUB_PROBE_TIMEOUT_MS 300       // HTTP запрос подписки к узлу
+#define HUB_FRAME_BUFFER_SIZE 4096
+#define HUB_CONFIG_ADDR 2048           // после apConfig и MAX_DEVICES устройств
+#define HUB_CONFIG_MAGIC 0x42555548UL  // "HUB" - запись хаба есть
+#define HUB_SUBSCRIBE_STACK_SIZE 6144  // HTTPClient
+#define HUB_SUBSCRIBE_PRIORITY 1
+
 WebServer server(80);
 
 // Структура для хранения настроек устройства
@@ -46,6 +67,58 @@ unsigned long buttonPressStartTime = 0;
 char serialCommandBuffer[SERIAL_COMMAND_BUFFER_SIZE];
 int serialCommandIndex = 0;
 
+// Хаб: по узлу на каждое устройство с isDevice = true, индекс как в devices[].
+// Узел с UDP потоком (UdpPoseStream) подписывается по HTTP и шлет кадры на
+// один общий UDP сокет хаба; остальные узлы читаются WebSocket клиентом.
+enum HubTransport { HUB_NODE_OFF, HUB_NODE_PENDING, HUB_NODE_UDP, HUB_NODE_WS };
+
+struct HubNode {
+    HubTransport transport;
+    uint32_t ip;
+    unsigned long attachedMs;
+    unsigned long renewedMs;
+    unsigned long lastFrameMs;
+    HubNodeTrack track;
+};
+
+// Хаб включается командой hub on или POST /api/hub и помнит это в EEPROM
+struct HubConfig {
+    uint32_t magic;
+    bool enabled;
+};
+
+bool hubEnabled = false;
+HubNode hubNodes[MAX_DEVICES];
+WebSocketsClient hubNodeSockets[MAX_DEVICES];
+WebSocketsServer hubSocket(HUB_WS_PORT);
+WiFiUDP hubUdp;
+
+// Ведущие часы для узлов: micros() точки доступа - общее время,
+// узлы с ClockSync.h присылают отсчеты уже в нем
+WiFiUDP clockSyncUdp;
+ClockSyncServer<WiFiUDP> clockSyncServer(clockSyncUdp);
+uint32_t hubSequence = 0;
+unsigned long lastHubTick = 0;
+unsigned long lastHubSync = 0;
+char hubFrame[HUB_FRAME_BUFFER_SIZE];
+
+// HTTP подписка на UDP поток ждет ответа узла до 2 * HUB_PROBE_TIMEOUT_MS;
+// ее делает отдельная задача, loop() только ставит запрос и забирает ответ
+struct HubSubscribeRequest {
+    int index;
+    uint32_t ip;
+};
+
+struct HubSubscribeResult {
+    int index;
+    uint32_t ip;
+    bool subscribed;
+};
+
+QueueHandle_t hubSubscribeRequests = NULL;
+QueueHandle_t hubSubscribeResults = NULL;
+bool hubSubscribePending = false;   // Не больше одного запроса к узлам за раз
+
 // Вспомогательная функция для преобразования IP
 IPAddress uint32ToIP(uint32_t ip) {
     return IPAddress(ip);
@@ -70,6 +143,7 @@ void setup() {
     
     // Загрузка конфигурации
     loadConfig();
+    loadHubConfig();
     
     // Настройка AP
     setupAP();
@@ -88,9 +162,20 @@ void setup() {
     
     // Запуск сервера
     server.begin();
+    
+    // Хаб датчиков тела
+    hubSocket.begin();
+    hubUdp.begin(HUB_UDP_PORT);
+    clockSyncServer.begin();
+    hubSubscribeRequests = xQueueCreate(1, sizeof(HubSubscribeRequest));
+    hubSubscribeResults = xQueueCreate(1, sizeof(HubSubscribeResult));
+    xTaskCreate(hubSubscribeTask, "hubSubscribe", HUB_SUBSCRIBE_STACK_SIZE, NULL,
+                HUB_SUBSCRIBE_PRIORITY, NULL);
 }
 
 void loop() {
+    // Первым делом: задержка до ответа на запрос синхронизации не измеряется
+    clockSyncServer.poll();
     server.handleClient();
     
     // Обработка нажатия кнопки Boot
@@ -103,6 +188,9 @@ void loop() {
     if (millis() - lastScanTime > SCAN_INTERVAL && !scanInProgress) {
         scanNetwork();
     }
+    
+    // Хаб: прием кадров узлов и кадр скелета на каждом такте
+    hubLoop();
 }
 
 void printSerialInstructions() {
@@ -120,6 +208,7 @@ void printSerialInstructions() {
     Serial.println("adddevice MAC [COMMENT] - Add device (MAC format: XX:XX:XX:XX:XX:XX)");
     Serial.println("removedevice MAC - Remove device");
     Serial.println("setdevice MAC isDevice [COMMENT] - Set device properties");
+    Serial.println("hub on|off|status - Body tracking hub");
     Serial.println("========================\n");
 }
 
@@ -323,6 +412,18 @@ void processSerialCommand(const char* command) {
             }
         }
     }
+    else if (strcmp(token, "hub") == 0) {
+        token = strtok(NULL, " ");
+        if (token && strcmp(token, "on") == 0) {
+            setHubEnabled(true);
+            Serial.println("Hub enabled");
+        } else if (token && strcmp(token, "off") == 0) {
+            setHubEnabled(false);
+            Serial.println("Hub disabled");
+        } else {
+            printHubStatus();
+        }
+    }
     else {
         Serial.println("Unknown command. Type 'help' for available commands.");
     }
@@ -342,6 +443,7 @@ void clearEEPROM() {
     strcpy(apConfig.ssid, "ESP32_AP");
     strcpy(apConfig.password, "12345678");
     deviceCount = 0;
+    setHubEnabled(false);
     
     // Перезапускаем AP с настройками по умолчанию
     WiFi.softAPdisconnect(true);
@@ -569,6 +671,50 @@ void setupAPI() {
         scanNetwork();
         server.send(200, "application/json", "{\"status\":\"scanning\"}");
     });
+
+    // Состояние хаба и узлов
+    server.on("/api/hub", HTTP_GET, []() {
+        DynamicJsonDocument doc(4096);
+        doc["enabled"] = hubEnabled;
+        doc["port"] = HUB_WS_PORT;
+        doc["clients"] = hubSocket.connectedClients();
+        doc["frames"] = hubSequence;
+        doc["clockSyncRequests"] = clockSyncServer.requestsAnswered();
+        JsonArray nodes = doc.createNestedArray("nodes");
+        uint32_t now = micros();
+        
+        for (int i = 0; i < deviceCount; i++) {
+            if (!devices[i].isDevice) continue;
+            const HubNode& node = hubNodes[i];
+            JsonObject item = nodes.createNestedObject();
+            item["ip"] = uint32ToIP(devices[i].ip).toString();
+            item["name"] = devices[i].comment;
+            item["transport"] = hubTransportName(node.transport);
+            item["live"] = node.track.live(now);
+            item["frames"] = node.track.framesReceived();
+            item["stale"] = node.track.framesStale();
+            item["resyncs"] = node.track.clockResyncs();
+            item["sharedClock"] = node.track.sharedClock();
+            item["clockOffsetUs"] = node.track.clockOffsetUs();
+        }
+        
+        String response;
+        serializeJson(doc, response);
+        
+        server.send(200, "application/json", response);
+    });
+
+    // Включение/выключение хаба: {"enabled": true|false}
+    server.on("/api/hub", HTTP_POST, []() {
+        if (server.hasArg("plain")) {
+            DynamicJsonDocument doc(128);
+            deserializeJson(doc, server.arg("plain"));
+            setHubEnabled(doc["enabled"] | hubEnabled);
+            server.send(200, "application/json", "{\"status\":\"ok\"}");
+        } else {
+            server.send(400, "application/json", "{\"error\":\"No data\"}");
+        }
+    });
 }
 
 void sendHTML() {
@@ -886,3 +1032,305 @@ void loadConfig() {
         Serial.println("Invalid device count, resetting to 0");
     }
 }
+
+// ============================================================================
+// Хаб датчиков тела
+// ============================================================================
+
+const char* hubTransportName(HubTransport transport) {
+    switch (transport) {
+        case HUB_NODE_PENDING: return "pending";
+        case HUB_NODE_UDP: return "udp";
+        case HUB_NODE_WS: return "websocket";
+        default: return "off";
+    }
+}
+
+void setHubEnabled(bool enabled) {
+    if (enabled != hubEnabled) {
+        hubEnabled = enabled;
+        saveHubConfig();
+    }
+    if (!enabled) {
+        for (int i = 0; i < MAX_DEVICES; i++) detachHubNode(i);
+    }
+}
+
+void saveHubConfig() {
+    HubConfig config = { HUB_CONFIG_MAGIC, hubEnabled };
+    EEPROM.put(HUB_CONFIG_ADDR, config);
+    EEPROM.commit();
+}
+
+// Без записи (новая плата, clear) хаб выключен
+void loadHubConfig() {
+    HubConfig config;
+    EEPROM.get(HUB_CONFIG_ADDR, config);
+    hubEnabled = config.magic == HUB_CONFIG_MAGIC && config.enabled;
+    Serial.print("Hub: ");
+    Serial.println(hubEnabled ? "enabled" : "disabled");
+}
+
+void hubLoop() {
+    hubSocket.loop();
+    receiveHubSubscriptions();
+    if (!hubEnabled) return;
+    
+    unsigned long nowMs = millis();
+    if (nowMs - lastHubSync >= HUB_SYNC_INTERVAL_MS) {
+        lastHubSync = nowMs;
+        syncHubNodes();
+    }
+    
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        if (hubNodes[i].transport == HUB_NODE_WS) hubNodeSockets[i].loop();
+    }
+    receiveHubUdp();
+    
+    // Кадр скелета только если есть кому его отправлять
+    uint32_t nowUs = micros();
+    if (nowUs - lastHubTick >= HUB_TICK_US) {
+        lastHubTick = nowUs;
+        if (hubSocket.connectedClients() > 0) {
+            publishSkeletonFrame(nowUs - HUB_ALIGN_DELAY_US, nowUs);
+        }
+    }
+}
+
+// Узлы следуют за списком устройств: подключение новых, отключение
+// удаленных, продление UDP подписки. HTTP запрос к узлу уходит в задачу
+// подписки, и пока он не вернулся, новых не ставим
+void syncHubNodes() {
+    unsigned long nowMs = millis();
+    
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        HubNode& node = hubNodes[i];
+        bool wanted = i < deviceCount && devices[i].isDevice;
+        
+        if (node.transport != HUB_NODE_OFF && (!wanted || node.ip != devices[i].ip)) {
+            detachHubNode(i);
+        }
+        if (!wanted || hubSubscribePending) continue;
+        
+        if (node.transport == HUB_NODE_OFF) {
+            attachHubNode(i);
+        } else if (node.transport == HUB_NODE_UDP) {
+            unsigned long silentSince = node.lastFrameMs ? node.lastFrameMs : node.attachedMs;
+            if (nowMs - silentSince > HUB_UDP_SILENCE_MS) {
+                // Узел перезагрузился или ушел из сети - подписка потеряна
+                detachHubNode(i);
+            } else if (nowMs - node.renewedMs >= HUB_UDP_RENEW_MS) {
+                requestHubSubscription(i, node.ip);
+            }
+        }
+    }
+}
+
+// Сначала UDP подписка (один сокет на все узлы), иначе WebSocket клиент;
+// до ответа задачи подписки узел ждет в HUB_NODE_PENDING
+void attachHubNode(int index) {
+    HubNode& node = hubNodes[index];
+    node.ip = devices[index].ip;
+    node.track.reset();
+    node.attachedMs = millis();
+    node.renewedMs = node.attachedMs;
+    node.lastFrameMs = 0;
+    node.transport = HUB_NODE_PENDING;
+    requestHubSubscription(index, node.ip);
+}
+
+void requestHubSubscription(int index, uint32_t ip) {
+    HubSubscribeRequest request = { index, ip };
+    if (xQueueSend(hubSubscribeRequests, &request, 0) == pdTRUE) {
+        hubSubscribePending = true;
+    }
+}
+
+// Ответы задачи подписки; узел, который за это время отключили или
+// сменили, ответ не трогает
+void receiveHubSubscriptions() {
+    HubSubscribeResult result;
+    while (xQueueReceive(hubSubscribeResults, &result, 0) == pdTRUE) {
+        hubSubscribePending = false;
+        HubNode& node = hubNodes[result.index];
+        if (node.ip != result.ip) continue;
+        
+        if (node.transport == HUB_NODE_UDP) {
+            if (result.subscribed) node.renewedMs = millis();
+            continue;
+        }
+        if (node.transport != HUB_NODE_PENDING) continue;
+        
+        node.attachedMs = millis();
+        node.renewedMs = node.attachedMs;
+        if (result.subscribed) {
+            node.transport = HUB_NODE_UDP;
+        } else {
+            node.transport = HUB_NODE_WS;
+            int index = result.index;
+            WebSocketsClient& socket = hubNodeSockets[index];
+            socket.begin(uint32ToIP(node.ip), 81, "/");
+            socket.onEvent([index](WStype_t type, uint8_t* payload, size_t length) {
+                hubNodeEvent(index, type, payload, length);
+            });
+            socket.setReconnectInterval(2000);
+        }
+        
+        Serial.print("Hub node ");
+        Serial.print(uint32ToIP(node.ip));
+        Serial.print(" via ");
+        Serial.println(hubTransportName(node.transport));
+    }
+}
+
+// Задача подписки: блокирующие HTTP запросы к узлам вне loop()
+void hubSubscribeTask(void* parameter) {
+    for (;;) {
+        HubSubscribeRequest request;
+        if (xQueueReceive(hubSubscribeRequests, &request, portMAX_DELAY) != pdTRUE) continue;
+        HubSubscribeResult result = { request.index, request.ip, subscribeHubNodeUdp(request.ip) };
+        xQueueSend(hubSubscribeResults, &result, portMAX_DELAY);
+    }
+}
+
+// UDP подписку узел отпустит сам через 30 с (аренда UdpPoseStream)
+void detachHubNode(int index) {
+    HubNode& node = hubNodes[index];
+    if (node.transport == HUB_NODE_WS) hubNodeSockets[index].disconnect();
+    node.transport = HUB_NODE_OFF;
+    node.track.reset();
+}
+
+// V7: POST /api/udp/subscribe, Wifi_Head_MPU6050: GET /udp/subscribe.
+// Только из hubSubscribeTask
+bool subscribeHubNodeUdp(uint32_t ip) {
+    String base = "http://" + uint32ToIP(ip).toString();
+    String query = "?port=" + String(HUB_UDP_PORT);
+    HTTPClient http;
+    http.setConnectTimeout(HUB_PROBE_TIMEOUT_MS);
+    http.setTimeout(HUB_PROBE_TIMEOUT_MS);
+    
+    http.begin(base + "/api/udp/subscribe" + query);
+    int code = http.POST("");
+    http.end();
+    if (code == 200) return true;
+    if (code <= 0) return false;  // узел не отвечает по HTTP
+    
+    http.begin(base + "/udp/subscribe" + query);
+    code = http.GET();
+    http.end();
+    return code == 200;
+}
+
+void hubNodeEvent(int index, WStype_t type, uint8_t* payload, size_t length) {
+    if (type != WStype_TEXT && type != WStype_BIN) return;
+    HubPoseInput pose;
+    if (parseHubFrame(payload, length, type == WStype_BIN, pose)) {
+        hubNodes[index].track.push(pose, micros());
+        hubNodes[index].lastFrameMs = millis();
+    }
+}
+
+void receiveHubUdp() {
+    uint8_t packet[64];
+    // Не больше кадра от каждого узла за проход, остальное - на следующем
+    for (int n = 0; n < MAX_DEVICES; n++) {
+        int size = hubUdp.parsePacket();
+        if (size <= 0) return;
+        int length = hubUdp.read(packet, sizeof(packet));
+        uint32_t from = ipToUint32(hubUdp.remoteIP());
+        
+        HubPoseInput pose;
+        if (length <= 0 || !parseHubFrame(packet, length, true, pose)) continue;
+        for (int i = 0; i < MAX_DEVICES; i++) {
+            if (hubNodes[i].transport == HUB_NODE_UDP && hubNodes[i].ip == from) {
+                hubNodes[i].track.push(pose, micros());
+                hubNodes[i].lastFrameMs = millis();
+                break;
+            }
+        }
+    }
+}
+
+// Имя устройства в JSON строке: кавычки и обратная косая черта экранируются
+size_t appendJsonName(char* out, size_t capacity, const char* name) {
+    size_t length = 0;
+    for (const char* p = name; *p && length + 2 < capacity; p++) {
+        if (*p == '"' || *p == '\\') out[length++] = '\\';
+        else if ((uint8_t)*p < 0x20) continue;
+        out[length++] = *p;
+    }
+    out[length] = '\0';
+    return length;
+}
+
+// Один кадр скелета: позы всех узлов на момент targetUs (часы хаба)
+// {"type":"skeleton","seq":N,"t":<us>,"nodes":[{"ip":..,"name":..,"pitch":..,"roll":..,"yaw":..,
+//   "relPitch":..,"relRoll":..,"relYaw":..,"ageMs":..,"live":true}, ...]}
+void publishSkeletonFrame(uint32_t targetUs, uint32_t nowUs) {
+    size_t length = snprintf(hubFrame, sizeof(hubFrame),
+                             "{\"type\":\"skeleton\",\"seq\":%lu,\"t\":%lu,\"nodes\":[",
+                             (unsigned long)++hubSequence, (unsigned long)targetUs);
+    bool first = true;
+    
+    for (int i = 0; i < deviceCount; i++) {
+        const HubNode& node = hubNodes[i];
+        float absAngles[3], relAngles[3];
+        uint32_t ageUs;
+        if (node.transport == HUB_NODE_OFF || !node.track.poseAt(targetUs, absAngles, relAngles, ageUs)) {
+            continue;
+        }
+        
+        char name[96];
+        appendJsonName(name, sizeof(name), devices[i].comment);
+        IPAddress ip = uint32ToIP(node.ip);
+        int written = snprintf(hubFrame + length, sizeof(hubFrame) - length,
+                               "%s{\"ip\":\"%u.%u.%u.%u\",\"name\":\"%s\","
+                               "\"pitch\":%.2f,\"roll\":%.2f,\"yaw\":%.2f,"
+                               "\"relPitch\":%.2f,\"relRoll\":%.2f,\"relYaw\":%.2f,"
+                               "\"ageMs\":%lu,\"live\":%s}",
+                               first ? "" : ",", ip[0], ip[1], ip[2], ip[3], name,
+                               absAngles[0], absAngles[1], absAngles[2],
+                               relAngles[0], relAngles[1], relAngles[2],
+                               (unsigned long)(ageUs / 1000), node.track.live(nowUs) ? "true" : "false");
+        if (written < 0 || length + written >= sizeof(hubFrame) - 3) break;
+        length += written;
+        first = false;
+    }
+    
+    hubFrame[length++] = ']';
+    hubFrame[length++] = '}';
+    hubFrame[length] = '\0';
+    hubSocket.broadcastTXT(hubFrame, length);
+}
+
+void printHubStatus() {
+    Serial.println("\n=== BODY TRACKING HUB ===");
+    Serial.print("Enabled: ");
+    Serial.println(hubEnabled ? "Yes" : "No");
+    Serial.print("Clients: ");
+    Serial.println(hubSocket.connectedClients());
+    Serial.print("Skeleton frames: ");
+    Serial.println(hubSequence);
+    Serial.print("Clock sync requests: ");
+    Serial.println(clockSyncServer.requestsAnswered());
+    Serial.println("IP Address\t\tTransport\tFrames\tStale\tLive\tComment");
+    
+    uint32_t now = micros();
+    for (int i = 0; i < deviceCount; i++) {
+        if (!devices[i].isDevice) continue;
+        const HubNode& node = hubNodes[i];
+        Serial.print(uint32ToIP(devices[i].ip));
+        Serial.print("\t\t");
+        Serial.print(hubTransportName(node.transport));
+        Serial.print("\t\t");
+        Serial.print(node.track.framesReceived());
+        Serial.print("\t");
+        Serial.print(node.track.framesStale());
+        Serial.print("\t");
+        Serial.print(node.track.live(now) ? "Yes" : "No");
+        Serial.print("\t");
+        Serial.println(devices[i].comment);
+    }
+    Serial.println("=========================\n");
+}
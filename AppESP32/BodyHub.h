@@ -0,0 +1,354 @@
+/*
+  Хаб датчиков тела: разбор кадров узлов и выравнивание по времени отсчета
+
+  Каждый узел (голова, плечевая кость, тело ...) присылает позы в своем
+  формате и по своим часам. Хаб переводит время отсчета узла в свои
+  часы и на каждом такте берет позы всех узлов на один и тот же момент
+  (такт минус задержка выравнивания), так что суставы в кадре скелета
+  согласованы по времени, а не по моменту прихода пакета.
+
+  Поддерживаемые кадры узлов:
+    бинарный OrientationFrame (UDP или WebSocket)   seq, timestamp, скорости
+    текст PITCH:..,ROLL:..,YAW:..,REL_PITCH:..      TS:<us>, SYNC_US:<us>, SEQ:<n>, RATE_P:..
+    JSON {"type":"sensorData","pitch":..}           syncUs / sampleUs / timestamp (мс), seq
+  Без метки времени временем отсчета считается время прихода.
+
+  Узлы с ClockSync.h присылают время отсчета в общих часах (micros()
+  хаба): SYNC_US / syncUs, у бинарного кадра - флаг 0x08. Такое время
+  берется как есть, без оценки смещения.
+
+  Смещение часов узла = нижняя огибающая (приход - отсчет): минимум
+  сразу, рост медленно (HUB_OFFSET_RELAX_US на кадр) - так учитывается
+  дрейф часов, а задержка доставки не попадает в смещение. Скачок больше
+  HUB_RESYNC_US (перезагрузка узла) сбрасывает историю узла.
+
+  Поза на момент T:
+    - кадр со скоростями: последний кадр до T + скорость * (T - отсчет),
+      не дальше HUB_EXTRAPOLATE_US (как прогноз у клиента, SendPolicy.h)
+    - без скоростей: линейная интерполяция между соседними кадрами,
+      после последнего кадра - удержание
+*/
+
+#ifndef BODY_HUB_H
+#define BODY_HUB_H
+
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define HUB_HISTORY 8                 // кадров в истории узла
+#define HUB_OFFSET_RELAX_US 20        // рост смещения часов за кадр
+#define HUB_RESYNC_US 1000000L        // скачок часов узла, после которого история сбрасывается
+#define HUB_EXTRAPOLATE_US 100000UL   // горизонт прогноза по скоростям
+#define HUB_NODE_STALE_US 500000UL    // узел без кадров дольше - не живой
+#define HUB_SEQ_RESYNC_US 1000000UL   // без принятых кадров дольше - номер кадра не сравнивается
+
+// Поза из одного кадра узла
+struct HubPoseInput {
+    uint32_t sampleUs;
+    bool hasTimestamp;
+    bool sharedClock;       // sampleUs уже в часах хаба (ClockSync.h)
+    uint16_t seq;
+    bool hasSeq;
+    float absAngles[3];     // pitch, roll, yaw
+    float relAngles[3];     // относительно нулевой точки узла
+    float rates[3];         // °/с
+    bool hasRates;
+};
+
+inline float hubWrap180(float angle) {
+    while (angle > 180.0f) angle -= 360.0f;
+    while (angle < -180.0f) angle += 360.0f;
+    return angle;
+}
+
+// Значение "KEY:<число>" в текстовом кадре; ключ должен стоять в начале или после ','
+inline bool hubTextField(const char* text, const char* key, float& value) {
+    size_t keyLength = strlen(key);
+    for (const char* p = strstr(text, key); p; p = strstr(p + 1, key)) {
+        if (p == text || p[-1] == ',') {
+            char* end;
+            value = strtof(p + keyLength, &end);
+            return end != p + keyLength;
+        }
+    }
+    return false;
+}
+
+// Значение "\"key\":<число>" в JSON кадре
+inline bool hubJsonField(const char* json, const char* key, double& value) {
+    const char* p = strstr(json, key);
+    if (!p) return false;
+    p += strlen(key);
+    char* end;
+    value = strtod(p, &end);
+    return end != p;
+}
+
+// seq новее last с учетом переполнения uint16
+inline bool hubSeqNewer(uint16_t seq, uint16_t last) {
+    uint16_t delta = seq - last;
+    return delta != 0 && delta < 0x8000;
+}
+
+inline uint16_t hubFrameU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+inline uint32_t hubFrameU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Разбор кадра узла; false - это не кадр позы (статус, ответ на команду ...)
+inline bool parseHubFrame(const uint8_t* data, size_t length, bool binary, HubPoseInput& out) {
+    out.hasRates = false;
+    out.hasSeq = false;
+    out.hasTimestamp = false;
+    out.sharedClock = false;
+
+    if (binary) {
+        // OrientationFrame: magic 0xA5, 28 байт, 31 со скоростями (int8 по 4 °/с)
+        if (length < 28 || data[0] != 0xA5) return false;
+        out.seq = hubFrameU16(data + 4);
+        out.sampleUs = hubFrameU32(data + 6);
+        out.hasSeq = out.hasTimestamp = true;
+        out.sharedClock = (data[2] & 0x08) != 0;
+        for (uint8_t i = 0; i < 3; i++) {
+            out.relAngles[i] = (int16_t)hubFrameU16(data + 10 + i * 2) / 100.0f;
+            out.absAngles[i] = hubWrap180((int32_t)hubFrameU32(data + 16 + i * 4) / 100.0f);
+        }
+        if ((data[2] & 0x04) && length >= 31) {
+            for (uint8_t i = 0; i < 3; i++) out.rates[i] = (int8_t)data[28 + i] * 4.0f;
+            out.hasRates = true;
+        }
+        return true;
+    }
+
+    // Текстовые кадры приходят без завершающего нуля
+    char text[512];
+    if (length >= sizeof(text)) return false;
+    memcpy(text, data, length);
+    text[length] = '\0';
+
+    if (text[0] == '{') {
+        if (!strstr(text, "\"type\":\"sensorData\"")) return false;
+        double value;
+        static const char* const absKeys[3] = {"\"absPitch\":", "\"absRoll\":", "\"absYaw\":"};
+        static const char* const plainKeys[3] = {"\"pitch\":", "\"roll\":", "\"yaw\":"};
+        static const char* const relKeys[3] = {"\"relPitch\":", "\"relRoll\":", "\"relYaw\":"};
+        static const char* const rateKeys[3] = {"\"ratePitch\":", "\"rateRoll\":", "\"rateYaw\":"};
+        bool hasAbs = strstr(text, absKeys[0]) != NULL;
+        for (uint8_t i = 0; i < 3; i++) {
+            if (!hubJsonField(text, plainKeys[i], value)) return false;
+            float plain = value;
+            // С absPitch поле pitch относительное (Wifi_Head_MPU6050), иначе абсолютное
+            out.absAngles[i] = hasAbs && hubJsonField(text, absKeys[i], value) ? value : plain;
+            out.relAngles[i] = hubJsonField(text, relKeys[i], value) ? value : plain;
+            out.rates[i] = 0;
+            if (hubJsonField(text, rateKeys[i], value)) {
+                out.rates[i] = value;
+                out.hasRates = true;
+            }
+        }
+        if (hubJsonField(text, "\"syncUs\":", value)) {
+            out.sampleUs = (uint32_t)value;
+            out.hasTimestamp = out.sharedClock = true;
+        } else if (hubJsonField(text, "\"sampleUs\":", value)) {
+            out.sampleUs = (uint32_t)value;
+            out.hasTimestamp = true;
+        } else if (hubJsonField(text, "\"timestamp\":", value)) {
+            out.sampleUs = (uint32_t)(value * 1000.0);
+            out.hasTimestamp = true;
+        }
+        if (hubJsonField(text, "\"seq\":", value)) {
+            out.seq = (uint16_t)(uint32_t)value;
+            out.hasSeq = true;
+        }
+        return true;
+    }
+
+    static const char* const textKeys[3] = {"PITCH:", "ROLL:", "YAW:"};
+    static const char* const textRelKeys[3] = {"REL_PITCH:", "REL_ROLL:", "REL_YAW:"};
+    static const char* const textRateKeys[3] = {"RATE_P:", "RATE_R:", "RATE_Y:"};
+    float value;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!hubTextField(text, textKeys[i], out.absAngles[i])) return false;
+        out.relAngles[i] = hubTextField(text, textRelKeys[i], value) ? value : out.absAngles[i];
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        if (hubTextField(text, textRateKeys[i], out.rates[i])) {
+            out.hasRates = true;
+        } else {
+            out.rates[i] = 0;
+        }
+    }
+    const char* ts = strstr(text, ",SYNC_US:");
+    if (ts) {
+        out.sampleUs = strtoul(ts + 9, NULL, 10);
+        out.hasTimestamp = out.sharedClock = true;
+    } else if ((ts = strstr(text, ",TS:")) != NULL) {
+        out.sampleUs = strtoul(ts + 4, NULL, 10);
+        out.hasTimestamp = true;
+    }
+    if (hubTextField(text, "SEQ:", value)) {
+        out.seq = (uint16_t)(uint32_t)value;
+        out.hasSeq = true;
+    }
+    return true;
+}
+
+// История и часы одного узла
+class HubNodeTrack {
+  public:
+    HubNodeTrack() { reset(); }
+
+    void reset() {
+        count = 0;
+        head = 0;
+        haveOffset = false;
+        haveSeq = false;
+        shared = false;
+        frames = 0;
+        staleFrames = 0;
+        resyncs = 0;
+    }
+
+    // Кадр узла, arrivalUs - micros() хаба в момент приема
+    void push(const HubPoseInput& in, uint32_t arrivalUs) {
+        // Устаревший кадр (UDP переставил или продублировал) не используется;
+        // после долгой паузы (перезагрузка узла) номер начинается заново
+        if (in.hasSeq && haveSeq && arrivalUs - lastAcceptUs < HUB_SEQ_RESYNC_US &&
+            !hubSeqNewer(in.seq, lastSeq)) {
+            staleFrames++;
+            return;
+        }
+        lastAcceptUs = arrivalUs;
+
+        uint32_t hubUs = arrivalUs;
+        if (in.sharedClock != shared) {
+            // Узел синхронизировал (или потерял) часы - старые отсчеты в другой шкале
+            count = 0;
+            shared = in.sharedClock;
+        }
+        if (in.sharedClock) {
+            hubUs = in.sampleUs;
+        } else if (in.hasTimestamp) {
+            uint32_t delta = arrivalUs - in.sampleUs;
+            int32_t change = (int32_t)(delta - offsetUs);
+            if (!haveOffset || change < 0) {
+                offsetUs = delta;
+            } else if (change > HUB_RESYNC_US) {
+                // Часы узла прыгнули назад - перезагрузка узла
+                offsetUs = delta;
+                count = 0;
+                resyncs++;
+            } else {
+                offsetUs += change < HUB_OFFSET_RELAX_US ? change : HUB_OFFSET_RELAX_US;
+            }
+            haveOffset = true;
+            hubUs = in.sampleUs + offsetUs;
+        }
+
+        if (in.hasSeq) {
+            lastSeq = in.seq;
+            haveSeq = true;
+        }
+        if (count > 0 && (int32_t)(hubUs - newest().hubUs) < 0) {
+            // Отсчет раньше последнего из-за подстройки смещения - держим порядок
+            hubUs = newest().hubUs;
+        }
+
+        head = (head + 1) % HUB_HISTORY;
+        Sample& s = samples[head];
+        s.hubUs = hubUs;
+        for (uint8_t i = 0; i < 3; i++) {
+            s.absAngles[i] = in.absAngles[i];
+            s.relAngles[i] = in.relAngles[i];
+            s.rates[i] = in.hasRates ? in.rates[i] : 0;
+        }
+        s.hasRates = in.hasRates;
+        if (count < HUB_HISTORY) count++;
+        frames++;
+    }
+
+    // Узел присылал кадры недавно (по часам хаба)
+    bool live(uint32_t nowUs) const {
+        return count > 0 && (uint32_t)(nowUs - newest().hubUs) < HUB_NODE_STALE_US;
+    }
+
+    // Поза на момент targetUs (часы хаба); ageUs - от отсчета, на котором она основана
+    bool poseAt(uint32_t targetUs, float absAngles[3], float relAngles[3], uint32_t& ageUs) const {
+        if (count == 0) return false;
+
+        // Последний отсчет не позже targetUs; если все позже - самый старый
+        uint8_t index = head;
+        uint8_t steps = 0;
+        while (steps + 1 < count && (int32_t)(samples[index].hubUs - targetUs) > 0) {
+            index = (index + HUB_HISTORY - 1) % HUB_HISTORY;
+            steps++;
+        }
+        const Sample& s0 = samples[index];
+        int32_t since = (int32_t)(targetUs - s0.hubUs);
+        if (since <= 0) {
+            copyPose(s0, absAngles, relAngles);
+            ageUs = 0;
+            return true;
+        }
+        ageUs = since;
+
+        if (s0.hasRates) {
+            float dt = ((uint32_t)since < HUB_EXTRAPOLATE_US ? since : HUB_EXTRAPOLATE_US) / 1000000.0f;
+            for (uint8_t i = 0; i < 3; i++) {
+                absAngles[i] = hubWrap180(s0.absAngles[i] + s0.rates[i] * dt);
+                relAngles[i] = hubWrap180(s0.relAngles[i] + s0.rates[i] * dt);
+            }
+            return true;
+        }
+
+        if (steps == 0) {
+            copyPose(s0, absAngles, relAngles);
+            return true;
+        }
+        const Sample& s1 = samples[(index + 1) % HUB_HISTORY];
+        uint32_t span = s1.hubUs - s0.hubUs;
+        float k = span > 0 ? (float)since / span : 1.0f;
+        for (uint8_t i = 0; i < 3; i++) {
+            absAngles[i] = hubWrap180(s0.absAngles[i] + hubWrap180(s1.absAngles[i] - s0.absAngles[i]) * k);
+            relAngles[i] = hubWrap180(s0.relAngles[i] + hubWrap180(s1.relAngles[i] - s0.relAngles[i]) * k);
+        }
+        return true;
+    }
+
+    uint32_t framesReceived() const { return frames; }
+    uint32_t framesStale() const { return staleFrames; }
+    uint32_t clockResyncs() const { return resyncs; }
+    // Последний кадр пришел со временем в общих часах
+    bool sharedClock() const { return shared; }
+    // Смещение часов узла относительно хаба (включая минимальную задержку доставки)
+    int32_t clockOffsetUs() const { return haveOffset ? (int32_t)offsetUs : 0; }
+
+  private:
+    struct Sample {
+        uint32_t hubUs;
+        float absAngles[3];
+        float relAngles[3];
+        float rates[3];
+        bool hasRates;
+    };
+
+    Sample samples[HUB_HISTORY];
+    uint8_t count, head;
+    bool haveOffset, haveSeq, shared;
+    uint32_t offsetUs, lastAcceptUs;
+    uint16_t lastSeq;
+    uint32_t frames, staleFrames, resyncs;
+
+    const Sample& newest() const { return samples[head]; }
+
+    static void copyPose(const Sample& s, float absAngles[3], float relAngles[3]) {
+        for (uint8_t i = 0; i < 3; i++) {
+            absAngles[i] = s.absAngles[i];
+            relAngles[i] = s.relAngles[i];
+        }
+    }
+};
+
+#endif
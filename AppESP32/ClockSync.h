@@ -0,0 +1,324 @@
+/*
+  Lightweight clock synchronization between sensor nodes and the AP hub
+  NTP-style exchange over UDP; the AP (AppESP32) is the master and its
+  micros() is the shared time base, so the hub can use synced sample
+  timestamps directly.
+
+      node                       master
+      t1 = micros()  --- request --->  t2 = micros() on receive
+      t4 = micros()  <-- response ---  t3 = micros() before send
+
+      offset = ((t2 - t1) + (t3 - t4)) / 2     master - node
+      delay  = (t4 - t1) - (t3 - t2)           round trip on the air
+
+  Packet (16 bytes, little-endian):
+    0  uint8   magic (0xC5)
+    1  uint8   type (1 - request, 2 - response)
+    2  uint16  sequence number (echoed)
+    4  uint32  t1, node micros() at send (echoed)
+    8  uint32  t2, master micros() at receive (0 in requests)
+   12  uint32  t3, master micros() at send (0 in requests)
+
+  Queueing on the WiFi link only ever adds delay, so low-delay exchanges
+  carry the least error. Drift needs a long baseline: the lowest-delay
+  exchange of every CLOCK_SYNC_DRIFT_BLOCK becomes an anchor, and the
+  drift is the least-squares slope through the anchors with at most the
+  median delay, once those span CLOCK_SYNC_DRIFT_MIN_SPAN_US. The offset
+  is the drift-corrected mean over the last CLOCK_SYNC_WINDOW exchanges
+  whose delay is close to the smallest one. Shared time of a local
+  timestamp = local + offset + drift * (local - reference).
+
+  Usage (node):
+    WiFiUDP syncUdp;
+    ClockSyncClient<WiFiUDP> clockSync(syncUdp);
+    clockSync.begin(WiFi.gatewayIP());
+    ... in loop(): clockSync.poll(micros());
+    if (clockSync.synced()) sharedUs = clockSync.toShared(sampleUs);
+
+  Usage (master):
+    WiFiUDP syncUdp;
+    ClockSyncServer<WiFiUDP> clockSyncServer(syncUdp);
+    clockSyncServer.begin();
+    ... in loop(): clockSyncServer.poll();
+*/
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#define CLOCK_SYNC_PORT 4212
+#define CLOCK_SYNC_MAGIC 0xC5
+#define CLOCK_SYNC_REQUEST 1
+#define CLOCK_SYNC_RESPONSE 2
+#define CLOCK_SYNC_PACKET_SIZE 16
+
+#define CLOCK_SYNC_WINDOW 32               // exchanges kept for the fit (~30 s)
+#define CLOCK_SYNC_FAST_INTERVAL_US 200000UL   // until the first fit
+#define CLOCK_SYNC_INTERVAL_US 1000000UL       // afterwards
+#define CLOCK_SYNC_MIN_SAMPLES 4
+#define CLOCK_SYNC_VALID_US 10000000UL     // without a fresh fit longer - not synced
+#define CLOCK_SYNC_DELAY_SLACK_US 1000     // accepted delay above the window minimum
+#define CLOCK_SYNC_DRIFT_BLOCK 16          // exchanges per drift anchor
+#define CLOCK_SYNC_DRIFT_ANCHORS 32        // anchors kept for the drift (~8 min)
+#define CLOCK_SYNC_DRIFT_MIN_SPAN_US 20000000UL   // anchor span before the drift is used
+#define CLOCK_SYNC_MAX_DRIFT_PPM 500       // crystals are within ~50 ppm
+
+inline void putSyncU16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+inline void putSyncU32(uint8_t* p, uint32_t v) {
+  p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = (v >> 24) & 0xFF;
+}
+inline uint16_t getSyncU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+inline uint32_t getSyncU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Master side: answers every request, never initiates
+template <class UDP>
+class ClockSyncServer {
+  public:
+    ClockSyncServer(UDP &udp, uint16_t port = CLOCK_SYNC_PORT) : udp(udp), port(port), answered(0) {}
+
+    void begin() { udp.begin(port); }
+
+    // Call as often as possible: the time spent between receive and
+    // reply is measured (t3 - t2), but time before poll() is not
+    void poll() {
+      while (udp.parsePacket() > 0) {
+        uint32_t receivedUs = micros();
+        uint8_t packet[CLOCK_SYNC_PACKET_SIZE];
+        int length = udp.read(packet, sizeof(packet));
+        if (length != CLOCK_SYNC_PACKET_SIZE || packet[0] != CLOCK_SYNC_MAGIC ||
+            packet[1] != CLOCK_SYNC_REQUEST) {
+          continue;
+        }
+        packet[1] = CLOCK_SYNC_RESPONSE;
+        putSyncU32(packet + 8, receivedUs);
+        udp.beginPacket(udp.remoteIP(), udp.remotePort());
+        putSyncU32(packet + 12, micros());
+        udp.write(packet, sizeof(packet));
+        udp.endPacket();
+        answered++;
+      }
+    }
+
+    uint32_t requestsAnswered() const { return answered; }
+
+  private:
+    UDP &udp;
+    uint16_t port;
+    uint32_t answered;
+};
+
+// Node side: offset and drift to the master clock
+template <class UDP>
+class ClockSyncClient {
+  public:
+    ClockSyncClient(UDP &udp, uint16_t localPort = CLOCK_SYNC_PORT)
+      : udp(udp), localPort(localPort), masterPort(CLOCK_SYNC_PORT), started(false) {
+      reset();
+    }
+
+    void begin(const IPAddress &master, uint16_t port = CLOCK_SYNC_PORT) {
+      masterIp = master;
+      masterPort = port;
+      udp.begin(localPort);
+      started = true;
+      reset();
+    }
+
+    void reset() {
+      count = 0;
+      head = 0;
+      anchorCount = 0;
+      anchorHead = 0;
+      blockCount = 0;
+      sequence = 0;
+      haveFit = false;
+      requestPending = false;
+      requested = false;
+      exchanges = 0;
+      lostExchanges = 0;
+      offsetUs = 0;
+      driftPpm = 0;
+    }
+
+    // Every loop(): sends a request when due and reads the replies
+    void poll(uint32_t nowUs) {
+      if (!started) return;   // no master (e.g. fallback AP mode)
+      while (udp.parsePacket() > 0) {
+        uint32_t t4 = micros();
+        uint8_t packet[CLOCK_SYNC_PACKET_SIZE];
+        int length = udp.read(packet, sizeof(packet));
+        if (length == CLOCK_SYNC_PACKET_SIZE && packet[0] == CLOCK_SYNC_MAGIC &&
+            packet[1] == CLOCK_SYNC_RESPONSE && requestPending && getSyncU16(packet + 2) == sequence) {
+          requestPending = false;
+          addExchange(getSyncU32(packet + 4), getSyncU32(packet + 8), getSyncU32(packet + 12), t4);
+        }
+      }
+
+      uint32_t interval = haveFit ? CLOCK_SYNC_INTERVAL_US : CLOCK_SYNC_FAST_INTERVAL_US;
+      if (requested && nowUs - lastRequestUs < interval) return;
+      if (requestPending) lostExchanges++;   // no reply within the interval
+
+      uint8_t packet[CLOCK_SYNC_PACKET_SIZE] = {0};
+      packet[0] = CLOCK_SYNC_MAGIC;
+      packet[1] = CLOCK_SYNC_REQUEST;
+      putSyncU16(packet + 2, ++sequence);
+      udp.beginPacket(masterIp, masterPort);
+      lastRequestUs = micros();
+      putSyncU32(packet + 4, lastRequestUs);
+      udp.write(packet, sizeof(packet));
+      udp.endPacket();
+      requestPending = true;
+      requested = true;
+    }
+
+    bool synced() const {
+      return haveFit && (uint32_t)(micros() - fitLocalUs) < CLOCK_SYNC_VALID_US;
+    }
+
+    // Local micros() -> master micros()
+    uint32_t toShared(uint32_t localUs) const {
+      int32_t since = (int32_t)(localUs - referenceUs);
+      return localUs + (uint32_t)(int64_t)(offsetUs + driftPpm * 1e-6 * since);
+    }
+
+    double offset() const { return offsetUs; }     // master - node at the reference, us
+    double drift() const { return driftPpm; }      // ppm, master rate relative to the node
+    uint32_t lastDelayUs() const { return count ? window[head].delayUs : 0; }
+    uint32_t exchangeCount() const { return exchanges; }
+    uint32_t lostCount() const { return lostExchanges; }
+
+  private:
+    struct Exchange {
+      uint32_t localUs;   // t1 + round trip / 2 on the node clock
+      int32_t offsetUs;   // master - node, wraps with micros() like the clocks
+      uint32_t delayUs;
+    };
+
+    UDP &udp;
+    uint16_t localPort;
+    IPAddress masterIp;
+    uint16_t masterPort;
+    bool started;
+
+    Exchange window[CLOCK_SYNC_WINDOW];
+    uint8_t count, head;
+    Exchange anchors[CLOCK_SYNC_DRIFT_ANCHORS];
+    uint8_t anchorCount, anchorHead;
+    Exchange blockBest;
+    uint8_t blockCount;
+    uint16_t sequence;
+    bool requested, requestPending, haveFit;
+    uint32_t lastRequestUs, referenceUs, fitLocalUs;
+    uint32_t exchanges, lostExchanges;
+    double offsetUs, driftPpm;
+
+    void addExchange(uint32_t t1, uint32_t t2, uint32_t t3, uint32_t t4) {
+      uint32_t roundTrip = t4 - t1;
+      uint32_t serverTime = t3 - t2;
+      if (serverTime > roundTrip) return;   // corrupt or reordered
+      Exchange e;
+      e.delayUs = roundTrip - serverTime;
+      e.offsetUs = (int32_t)(((int64_t)(int32_t)(t2 - t1) + (int64_t)(int32_t)(t3 - t4)) / 2);
+      e.localUs = t1 + roundTrip / 2;
+
+      head = (head + 1) % CLOCK_SYNC_WINDOW;
+      window[head] = e;
+      if (count < CLOCK_SYNC_WINDOW) count++;
+      exchanges++;
+
+      if (blockCount == 0 || e.delayUs < blockBest.delayUs) blockBest = e;
+      if (++blockCount == CLOCK_SYNC_DRIFT_BLOCK) {
+        anchorHead = (anchorHead + 1) % CLOCK_SYNC_DRIFT_ANCHORS;
+        anchors[anchorHead] = blockBest;
+        if (anchorCount < CLOCK_SYNC_DRIFT_ANCHORS) anchorCount++;
+        blockCount = 0;
+      }
+      fit();
+    }
+
+    // i-th newest exchange
+    const Exchange &exchange(uint8_t i) const {
+      return window[(head + CLOCK_SYNC_WINDOW - i) % CLOCK_SYNC_WINDOW];
+    }
+
+    // i-th newest anchor
+    const Exchange &anchor(uint8_t i) const {
+      return anchors[(anchorHead + CLOCK_SYNC_DRIFT_ANCHORS - i) % CLOCK_SYNC_DRIFT_ANCHORS];
+    }
+
+    // Drift: least-squares slope through the anchors with at most the
+    // median delay; zero until they span CLOCK_SYNC_DRIFT_MIN_SPAN_US
+    double fitDrift() const {
+      if (anchorCount < 3) return 0;
+
+      uint32_t delays[CLOCK_SYNC_DRIFT_ANCHORS];
+      for (uint8_t i = 0; i < anchorCount; i++) {
+        uint32_t d = anchor(i).delayUs;
+        uint8_t j = i;
+        for (; j > 0 && delays[j - 1] > d; j--) delays[j] = delays[j - 1];
+        delays[j] = d;
+      }
+      uint32_t limit = delays[0] + CLOCK_SYNC_DELAY_SLACK_US;
+      if (delays[(anchorCount - 1) / 2] > limit) limit = delays[(anchorCount - 1) / 2];
+
+      const Exchange &newest = anchors[anchorHead];
+      double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, low = 0, high = 0;
+      for (uint8_t i = 0; i < anchorCount; i++) {
+        const Exchange &e = anchor(i);
+        if (e.delayUs > limit) continue;
+        double x = (int32_t)(e.localUs - newest.localUs);
+        double y = (int32_t)(e.offsetUs - newest.offsetUs);
+        n++;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        if (x < low) low = x;
+        if (x > high) high = x;
+      }
+      if (n < 3 || high - low < CLOCK_SYNC_DRIFT_MIN_SPAN_US) return 0;
+
+      double slope = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+      const double maxSlope = CLOCK_SYNC_MAX_DRIFT_PPM * 1e-6;
+      if (slope > maxSlope) slope = maxSlope;
+      if (slope < -maxSlope) slope = -maxSlope;
+      return slope;
+    }
+
+    // Offset: drift-corrected mean over the low-delay exchanges of the window
+    void fit() {
+      if (count < CLOCK_SYNC_MIN_SAMPLES) return;
+      double slope = fitDrift();
+
+      uint32_t minDelay = 0xFFFFFFFFUL;
+      for (uint8_t i = 0; i < count; i++) {
+        const Exchange &e = exchange(i);
+        if (e.delayUs < minDelay) minDelay = e.delayUs;
+      }
+      uint32_t limit = minDelay + CLOCK_SYNC_DELAY_SLACK_US;
+
+      // Times and offsets relative to the newest exchange keep the sums small
+      const Exchange &newest = window[head];
+      double n = 0, sum = 0;
+      for (uint8_t i = 0; i < count; i++) {
+        const Exchange &e = exchange(i);
+        if (e.delayUs > limit) continue;
+        double x = (int32_t)(e.localUs - newest.localUs);
+        double y = (int32_t)(e.offsetUs - newest.offsetUs);
+        n++;
+        sum += y - slope * x;
+      }
+
+      referenceUs = newest.localUs;
+      offsetUs = newest.offsetUs + sum / n;
+      driftPpm = slope * 1e6;
+      fitLocalUs = micros();
+      haveFit = true;
+    }
+};
+
+#endif
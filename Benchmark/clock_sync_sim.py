@@ -0,0 +1,363 @@
+"""
+Моделирование синхронизации часов узлов с хабом (ClockSync.h) и
+остаточная ошибка общего времени - для подбора параметров. Код прошивки
+(ClockSync.h на поддельной сети) проверяет host_test clock_sync_test в
+Benchmark/tests; этот скрипт - модель алгоритма, а не он сам. Задержка
+чтения на проходе loop() здесь случайна для каждого пакета, так что
+привязка ответа к фазе loop() с delay(10) (t4 - t1 всегда 10 мс) не
+видна, и ошибка выходит меньше, чем в clock_sync_test.
+
+Несколько узлов со своими часами (смещение, дрейф --drift-ppm) обмениваются
+с ведущим (AppESP32) запросами t1..t4 через сеть с задержкой, джиттером,
+редкими всплесками (ретрансляции WiFi) и потерями. Узел и ведущий читают
+пакеты только на своем проходе loop() (--node-poll-ms, --master-poll-ms),
+эта задержка в t4/t2 не видна и тоже попадает в ошибку.
+
+Узел - порт ClockSyncClient: дрейф - наклон прямой МНК через лучшие
+обмены блоков по CLOCK_SYNC_DRIFT_BLOCK (до CLOCK_SYNC_DRIFT_ANCHORS,
+~8 мин) с задержкой не больше медианы, когда они разнесены на
+CLOCK_SYNC_DRIFT_MIN_SPAN_US; смещение - среднее с поправкой на этот дрейф
+по обменам окна CLOCK_SYNC_WINDOW с задержкой не больше минимума окна +
+CLOCK_SYNC_DELAY_SLACK_US. Арифметика uint32 как у micros(), переполнение
+часов узла случается в каждом прогоне.
+
+Остаточная ошибка после --warmup-s в моменты отсчетов (каждые 10 мс):
+  node  - |общее время узла - часы ведущего| по каждому узлу
+  pair  - |ошибка узла A - ошибка узла B|: насколько расходятся метки
+          двух суставов одного момента (голова и плечо)
+Для сравнения - штамп по приходу кадра на хаб (без синхронизации):
+ошибка = разброс односторонней задержки.
+
+Ошибка оценки дрейфа - |оценка - истинный ход ведущего относительно узла|
+в конце прогона; больше --max-drift-error-ppm - код возврата 1.
+
+Примеры:
+  python3 clock_sync_sim.py
+  python3 clock_sync_sim.py --nodes 8 --jitter-ms 5 --spike-prob 0.1 --loss 0.05
+  python3 clock_sync_sim.py --max-error-us 2000 --report sync.json
+  python3 clock_sync_sim.py --duration-s 600 --max-drift-error-ppm 3
+"""
+
+import argparse
+import heapq
+import json
+import random
+import sys
+
+from latency_benchmark import percentile
+
+MASK32 = 0xFFFFFFFF
+
+# ClockSync.h
+CLOCK_SYNC_WINDOW = 32
+CLOCK_SYNC_FAST_INTERVAL_US = 200000
+CLOCK_SYNC_INTERVAL_US = 1000000
+CLOCK_SYNC_MIN_SAMPLES = 4
+CLOCK_SYNC_VALID_US = 10000000
+CLOCK_SYNC_DELAY_SLACK_US = 1000
+CLOCK_SYNC_DRIFT_BLOCK = 16
+CLOCK_SYNC_DRIFT_ANCHORS = 32
+CLOCK_SYNC_DRIFT_MIN_SPAN_US = 20000000
+CLOCK_SYNC_MAX_DRIFT_PPM = 500
+
+
+def s32(value):
+    """uint32 -> int32, как (int32_t) в прошивке"""
+    value &= MASK32
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+class ClockSyncClient:
+    """Порт ClockSyncClient (ClockSync.h) без сети: обмены подаются снаружи"""
+
+    def __init__(self):
+        self.window = []            # (local_us, offset_us, delay_us), новые в конце
+        self.anchors = []           # лучший обмен каждого блока, новые в конце
+        self.block_best = None
+        self.block_count = 0
+        self.have_fit = False
+        self.offset_us = 0.0
+        self.drift_ppm = 0.0
+        self.reference_us = 0
+        self.fit_local_us = 0
+
+    def interval_us(self):
+        return CLOCK_SYNC_INTERVAL_US if self.have_fit else CLOCK_SYNC_FAST_INTERVAL_US
+
+    def add_exchange(self, t1, t2, t3, t4):
+        round_trip = (t4 - t1) & MASK32
+        server_time = (t3 - t2) & MASK32
+        if server_time > round_trip:
+            return
+        delay = round_trip - server_time
+        total = s32(t2 - t1) + s32(t3 - t4)
+        offset = s32(int(total / 2))   # деление int64 в C округляет к нулю
+        local = (t1 + round_trip // 2) & MASK32
+        e = (local, offset, delay)
+        self.window.append(e)
+        if len(self.window) > CLOCK_SYNC_WINDOW:
+            self.window.pop(0)
+        if self.block_best is None or delay < self.block_best[2]:
+            self.block_best = e
+        self.block_count += 1
+        if self.block_count == CLOCK_SYNC_DRIFT_BLOCK:
+            self.anchors.append(self.block_best)
+            if len(self.anchors) > CLOCK_SYNC_DRIFT_ANCHORS:
+                self.anchors.pop(0)
+            self.block_best = None
+            self.block_count = 0
+        self.fit(t4)
+
+    def fit_drift(self):
+        if len(self.anchors) < 3:
+            return 0.0
+        # Опоры с задержкой не больше медианы (но не меньше минимума + запас)
+        delays = sorted(e[2] for e in self.anchors)
+        limit = max(delays[0] + CLOCK_SYNC_DELAY_SLACK_US, delays[(len(delays) - 1) // 2])
+        newest = self.anchors[-1]
+        n = sx = sy = sxx = sxy = 0.0
+        low = high = 0.0
+        for local, offset, delay in self.anchors:
+            if delay > limit:
+                continue
+            x = float(s32(local - newest[0]))
+            y = float(s32(offset - newest[1]))
+            n += 1
+            sx += x
+            sy += y
+            sxx += x * x
+            sxy += x * y
+            low = min(low, x)
+            high = max(high, x)
+        if n < 3 or high - low < CLOCK_SYNC_DRIFT_MIN_SPAN_US:
+            return 0.0
+        slope = (n * sxy - sx * sy) / (n * sxx - sx * sx)
+        limit = CLOCK_SYNC_MAX_DRIFT_PPM * 1e-6
+        return max(-limit, min(limit, slope))
+
+    def fit(self, now_local):
+        if len(self.window) < CLOCK_SYNC_MIN_SAMPLES:
+            return
+        slope = self.fit_drift()
+        limit = min(e[2] for e in self.window) + CLOCK_SYNC_DELAY_SLACK_US
+        newest = self.window[-1]
+        n = sum_offset = 0.0
+        for local, offset, delay in self.window:
+            if delay > limit:
+                continue
+            x = float(s32(local - newest[0]))
+            y = float(s32(offset - newest[1]))
+            n += 1
+            sum_offset += y - slope * x
+        self.reference_us = newest[0]
+        self.offset_us = newest[1] + sum_offset / n
+        self.drift_ppm = slope * 1e6
+        self.fit_local_us = now_local
+        self.have_fit = True
+
+    def synced(self, now_local):
+        return self.have_fit and ((now_local - self.fit_local_us) & MASK32) < CLOCK_SYNC_VALID_US
+
+    def to_shared(self, local_us):
+        since = s32(local_us - self.reference_us)
+        return (local_us + int(self.offset_us + self.drift_ppm * 1e-6 * since)) & MASK32
+
+
+class Network:
+    """Односторонняя задержка: база + экспоненциальный джиттер + редкие всплески"""
+
+    def __init__(self, args, rng):
+        self.base_us = args.base_delay_ms * 1000
+        self.jitter_us = args.jitter_ms * 1000
+        self.spike_prob = args.spike_prob
+        self.spike_us = args.spike_ms * 1000
+        self.loss = args.loss
+        self.rng = rng
+
+    def delay(self):
+        """Задержка в мкс или None, если пакет потерян"""
+        if self.rng.random() < self.loss:
+            return None
+        d = self.base_us + (self.rng.expovariate(1.0 / self.jitter_us) if self.jitter_us > 0 else 0)
+        if self.rng.random() < self.spike_prob:
+            d += self.rng.uniform(0.2, 1.0) * self.spike_us
+        return d
+
+
+class Node:
+    def __init__(self, index, args, rng):
+        self.index = index
+        self.rate = 1.0 + rng.uniform(-args.drift_ppm, args.drift_ppm) * 1e-6
+        self.base = rng.uniform(0, 1 << 32)
+        self.client = ClockSyncClient()
+        self.poll_us = args.node_poll_ms * 1000
+        self.rng = rng
+        self.sequence = 0
+        self.errors = []
+        self.exchanges = 0
+        self.lost = 0
+
+    def local(self, t):
+        """micros() узла в истинный момент t (мкс)"""
+        return int(self.base + t * self.rate) & MASK32
+
+    def poll_delay(self):
+        return self.rng.uniform(0, self.poll_us)
+
+
+def simulate(args):
+    rng = random.Random(args.seed)
+    network = Network(args, rng)
+    nodes = [Node(i, args, rng) for i in range(args.nodes)]
+    master_poll_us = args.master_poll_ms * 1000
+    duration_us = args.duration_s * 1e6
+    warmup_us = args.warmup_s * 1e6
+    sample_step_us = 10000
+
+    # События: (истинное время, порядок, вид, узел, данные)
+    events = []
+    counter = [0]
+
+    def schedule(t, kind, node, data=None):
+        counter[0] += 1
+        heapq.heappush(events, (t, counter[0], kind, node, data))
+
+    for node in nodes:
+        schedule(rng.uniform(0, 100000), "request", node)
+    schedule(warmup_us, "sample", None)
+
+    pair_errors = []
+    arrival_errors = []
+    while events:
+        t, _, kind, node, data = heapq.heappop(events)
+        if t > duration_us:
+            break
+
+        if kind == "request":
+            # Запрос уходит на проходе loop(), ответ на прошлый не пришел - потерян
+            if node.sequence > node.exchanges + node.lost:
+                node.lost += 1
+            node.sequence += 1
+            t1 = node.local(t)
+            d = network.delay()
+            if d is not None:
+                # Ведущий читает пакет на своем проходе loop(): t2 позже прихода
+                t_read = t + d + rng.uniform(0, master_poll_us)
+                t2 = int(t_read) & MASK32
+                t3 = int(t_read + 30) & MASK32
+                back = network.delay()
+                if back is not None:
+                    schedule(t_read + 30 + back + node.poll_delay(), "response", node,
+                             (node.sequence, t1, t2, t3))
+            schedule(t + node.client.interval_us(), "request", node)
+
+        elif kind == "response":
+            sequence, t1, t2, t3 = data
+            if sequence == node.sequence:
+                node.exchanges += 1
+                node.client.add_exchange(t1, t2, t3, node.local(t))
+
+        elif kind == "sample":
+            errors = []
+            for n in nodes:
+                local = n.local(t)
+                if not n.client.synced(local):
+                    errors.append(None)
+                    continue
+                error = s32(n.client.to_shared(local) - (int(t) & MASK32))
+                n.errors.append(abs(error))
+                errors.append(error)
+            for i in range(len(errors)):
+                for j in range(i + 1, len(errors)):
+                    if errors[i] is not None and errors[j] is not None:
+                        pair_errors.append(abs(errors[i] - errors[j]))
+            # Без синхронизации: штамп по приходу, ошибка пары = разность задержек
+            da, db = network.delay(), network.delay()
+            if da is not None and db is not None:
+                arrival_errors.append(abs(da - db))
+            schedule(t + sample_step_us, "sample", None)
+
+    return nodes, pair_errors, arrival_errors
+
+
+def stats(values):
+    if not values:
+        return {"mean": None, "p50": None, "p95": None, "p99": None, "max": None}
+    values = sorted(values)
+    return {
+        "mean": round(sum(values) / len(values), 1),
+        "p50": round(percentile(values, 50), 1),
+        "p95": round(percentile(values, 95), 1),
+        "p99": round(percentile(values, 99), 1),
+        "max": round(values[-1], 1),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Остаточная ошибка синхронизации часов узлов с хабом")
+    parser.add_argument("--nodes", type=int, default=4)
+    parser.add_argument("--duration-s", type=float, default=300.0)
+    parser.add_argument("--warmup-s", type=float, default=30.0, help="ошибка считается после")
+    parser.add_argument("--drift-ppm", type=float, default=50.0, help="разброс хода часов узлов, ±ppm")
+    parser.add_argument("--base-delay-ms", type=float, default=1.5, help="минимальная односторонняя задержка")
+    parser.add_argument("--jitter-ms", type=float, default=2.0, help="среднее экспоненциального джиттера")
+    parser.add_argument("--spike-prob", type=float, default=0.05, help="доля пакетов со всплеском задержки")
+    parser.add_argument("--spike-ms", type=float, default=50.0, help="максимальный всплеск")
+    parser.add_argument("--loss", type=float, default=0.02)
+    parser.add_argument("--node-poll-ms", type=float, default=10.0, help="период loop() узла (delay(10))")
+    parser.add_argument("--master-poll-ms", type=float, default=2.0, help="период loop() хаба")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--max-error-us", type=float, help="код возврата 1, если p95 ошибки пары больше")
+    parser.add_argument("--max-drift-error-ppm", type=float, default=10.0,
+                        help="код возврата 1, если ошибка оценки дрейфа узла больше")
+    parser.add_argument("--report", help="файл для JSON отчета")
+    args = parser.parse_args()
+
+    nodes, pair_errors, arrival_errors = simulate(args)
+
+    print("%-6s %9s %9s %9s %8s %8s %8s %8s %8s" % (
+        "node", "drift", "est.", "est.err", "mean", "p95", "p99", "max", "lost"))
+    report_nodes = []
+    drift_errors = []
+    for node in nodes:
+        s = stats(node.errors)
+        true_drift = (1.0 / node.rate - 1.0) * 1e6   # ход ведущего относительно узла
+        drift_error = abs(node.client.drift_ppm - true_drift)
+        drift_errors.append(drift_error)
+        print("%-6d %8.1fp %8.1fp %8.1fp %7.0fu %7.0fu %7.0fu %7.0fu %8d" % (
+            node.index, true_drift, node.client.drift_ppm, drift_error,
+            s["mean"] or 0, s["p95"] or 0, s["p99"] or 0, s["max"] or 0, node.lost))
+        report_nodes.append({"node": node.index, "drift_ppm": round(true_drift, 2),
+                             "estimated_drift_ppm": round(node.client.drift_ppm, 2),
+                             "drift_error_ppm": round(drift_error, 2),
+                             "exchanges": node.exchanges, "lost": node.lost, "error_us": s})
+
+    pair = stats(pair_errors)
+    arrival = stats(arrival_errors)
+    print("pair error, us:        mean %.0f  p95 %.0f  p99 %.0f  max %.0f" % (
+        pair["mean"], pair["p95"], pair["p99"], pair["max"]))
+    print("arrival stamping, us:  mean %.0f  p95 %.0f  p99 %.0f  max %.0f" % (
+        arrival["mean"], arrival["p95"], arrival["p99"], arrival["max"]))
+    print("drift estimate error, ppm:  mean %.1f  max %.1f" % (
+        sum(drift_errors) / len(drift_errors), max(drift_errors)))
+
+    if args.report:
+        report = {"params": vars(args), "nodes": report_nodes,
+                  "pair_error_us": pair, "arrival_stamping_error_us": arrival,
+                  "max_drift_error_ppm": round(max(drift_errors), 2)}
+        with open(args.report, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2, ensure_ascii=False)
+
+    failed = False
+    if args.max_error_us is not None and (pair["p95"] is None or pair["p95"] > args.max_error_us):
+        print("FAIL: pair p95 above %.0f us" % args.max_error_us)
+        failed = True
+    if max(drift_errors) > args.max_drift_error_ppm:
+        print("FAIL: drift estimate error above %.1f ppm" % args.max_drift_error_ppm)
+        failed = True
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,367 @@
+/*
+  Эмулятор прошивки для latency_benchmark.py emulate
+
+  Кадры собираются тем же кодом, что в прошивках, и уходят через pty или
+  WebSocket на 127.0.0.1:
+    text  строка данных Bluetooth_v5 (SENSOR_DATA_FIELDS и хвост
+          formatSensorData(), TelemetryFormat.h)
+    json  строка MPU6050_Serial (SENSOR_FIELDS и хвост, TelemetryFormat.h)
+    bin   OrientationFrame со скоростями: encodeOrientationFrame() и
+          appendOrientationRates() (OrientationFrame.h V7), только WebSocket
+  Время отсчета в кадре - CLOCK_MONOTONIC в мкс (младшие 32 бита): те же
+  часы, что time.monotonic() у клиента, поэтому задержка абсолютная.
+
+    frame_emitter --pty [--format text|json] [--rate HZ]
+        первая строка stdout - путь к slave pty; кадры (строки с \r\n)
+        начинают идти после строки в stdin
+    frame_emitter --ws [--format text|json|bin] [--rate HZ]
+        первая строка stdout - порт; один клиент, рукопожатие RFC 6455,
+        затем кадры до закрытия соединения
+  --duration S ограничивает работу (по умолчанию - пока не остановят).
+*/
+
+#include <Arduino.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/TelemetryFormat.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/OrientationFrame.h"
+
+// Как SENSOR_DATA_FIELDS в Bluetooth_v5.ino
+static const TelemetryField SENSOR_DATA_FIELDS[] = {
+  {"PITCH:", 1}, {",ROLL:", 1}, {",YAW:", 1},
+  {",REL_PITCH:", 2}, {",REL_ROLL:", 2}, {",REL_YAW:", 2},
+  {",ACC_PITCH:", 2}, {",ACC_ROLL:", 2}, {",ACC_YAW:", 2}
+};
+
+// Как SENSOR_FIELDS в MPU6050_Serial.ino
+static const TelemetryField SENSOR_FIELDS[] = {
+  {"{\"type\":\"sensorData\",\"pitch\":", 2}, {",\"roll\":", 2}, {",\"yaw\":", 2},
+  {",\"absPitch\":", 2}, {",\"absRoll\":", 2}, {",\"absYaw\":", 2}
+};
+
+enum Format { FORMAT_TEXT, FORMAT_JSON, FORMAT_BIN };
+
+static uint64_t monotonicUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// Поза кадра n: медленный поворот по тангажу и рысканию
+struct Pose {
+  float angles[3], rates[3];
+  double accumulated[3];
+};
+
+static Pose poseAt(uint32_t n, double rateHz) {
+  Pose p;
+  double t = n / rateHz;
+  p.accumulated[0] = 20.0 * sin(t);
+  p.accumulated[1] = 5.0 * sin(0.7 * t);
+  p.accumulated[2] = 36.0 * t;
+  p.rates[0] = (float)(20.0 * cos(t));
+  p.rates[1] = (float)(3.5 * cos(0.7 * t));
+  p.rates[2] = 36.0f;
+  for (int i = 0; i < 3; i++) p.angles[i] = (float)(fmod(p.accumulated[i] + 540.0, 360.0) - 180.0);
+  return p;
+}
+
+// Кадр n в формате прошивки; возвращает длину в out
+static size_t buildFrame(Format format, uint32_t n, double rateHz, bool lineEnding, uint8_t* out, size_t size) {
+  static TelemetryMessage<512> message;
+  Pose p = poseAt(n, rateHz);
+  uint32_t sampleUs = (uint32_t)monotonicUs();
+
+  if (format == FORMAT_BIN) {
+    if (size < ORIENTATION_FRAME_RATES_SIZE) return 0;
+    encodeOrientationFrame(out, (uint16_t)n, sampleUs, ORIENTATION_FLAG_ZERO_SET,
+                           p.angles[0], p.angles[1], p.angles[2],
+                           p.accumulated[0], p.accumulated[1], p.accumulated[2]);
+    return appendOrientationRates(out, p.rates[0], p.rates[1], p.rates[2]);
+  }
+
+  message.clear();
+  if (format == FORMAT_TEXT) {
+    const double values[] = {
+      p.angles[0], p.angles[1], p.angles[2],
+      p.angles[0], p.angles[1], p.angles[2],
+      p.accumulated[0], p.accumulated[1], p.accumulated[2]
+    };
+    message.fields(SENSOR_DATA_FIELDS, values)
+           .text(",ZERO_SET:").boolean(true)
+           .text(",UNLIMITED:true")
+           .text(",SEQ:").number((unsigned long)n)
+           .text(",TS:").number((unsigned long)sampleUs)
+           .text(",RATE_P:").fixed(p.rates[0], 1)
+           .text(",RATE_R:").fixed(p.rates[1], 1)
+           .text(",RATE_Y:").fixed(p.rates[2], 1);
+    if (lineEnding) message.text("\r\n");
+  } else {
+    const double values[] = {
+      p.angles[0], p.angles[1], p.angles[2],
+      p.angles[0], p.angles[1], p.angles[2]
+    };
+    message.fields(SENSOR_FIELDS, values)
+           .text(",\"zeroSet\":").boolean(true)
+           .text(",\"calibrated\":").boolean(true)
+           .text(",\"autoCalibration\":").boolean(false)
+           .text(",\"timestamp\":").number((unsigned long)(sampleUs / 1000))
+           .text(",\"seq\":").number((unsigned long)n)
+           .text(",\"sampleUs\":").number((unsigned long)sampleUs)
+           .text("}");
+    if (lineEnding) message.text("\r\n");
+  }
+  if (message.overflow() || message.length() > size) return 0;
+  memcpy(out, message.c_str(), message.length());
+  return message.length();
+}
+
+// SHA-1 (RFC 3174) - только для Sec-WebSocket-Accept
+static void sha1(const uint8_t* data, size_t length, uint8_t digest[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+  std::string message((const char*)data, length);
+  message += (char)0x80;
+  while (message.size() % 64 != 56) message += (char)0;
+  uint64_t bits = (uint64_t)length * 8;
+  for (int i = 7; i >= 0; i--) message += (char)(bits >> (i * 8));
+
+  for (size_t chunk = 0; chunk < message.size(); chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t* p = (const uint8_t*)message.data() + chunk + i * 4;
+      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; i++) {
+      uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = x << 1 | x >> 31;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t temp = (a << 5 | a >> 27) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = b << 30 | b >> 2;
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+  for (int i = 0; i < 20; i++) digest[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+}
+
+static std::string base64(const uint8_t* data, size_t length) {
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t v = (uint32_t)data[i] << 16;
+    if (i + 1 < length) v |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < length) v |= data[i + 2];
+    out += table[(v >> 18) & 63];
+    out += table[(v >> 12) & 63];
+    out += i + 1 < length ? table[(v >> 6) & 63] : '=';
+    out += i + 2 < length ? table[v & 63] : '=';
+  }
+  return out;
+}
+
+static bool sendAll(int fd, const uint8_t* data, size_t length) {
+  while (length > 0) {
+    ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    data += n;
+    length -= n;
+  }
+  return true;
+}
+
+// Принимает одного клиента и отвечает на рукопожатие; -1 при ошибке
+static int acceptWebSocket(int server) {
+  int fd = accept(server, NULL, NULL);
+  if (fd < 0) return -1;
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  std::string request;
+  char buf[1024];
+  while (request.find("\r\n\r\n") == std::string::npos) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      close(fd);
+      return -1;
+    }
+    request.append(buf, n);
+  }
+  const std::string header = "Sec-WebSocket-Key: ";
+  size_t at = request.find(header);
+  if (at == std::string::npos) {
+    close(fd);
+    return -1;
+  }
+  at += header.size();
+  std::string key = request.substr(at, request.find("\r\n", at) - at) + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  uint8_t digest[20];
+  sha1((const uint8_t*)key.data(), key.size(), digest);
+  std::string response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                         "Sec-WebSocket-Accept: " + base64(digest, sizeof(digest)) + "\r\n\r\n";
+  if (!sendAll(fd, (const uint8_t*)response.data(), response.size())) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Кадр сервера WebSocket (без маски), payload до 64 КБ
+static bool sendWebSocket(int fd, bool binary, const uint8_t* payload, size_t length) {
+  uint8_t wire[4 + 512];
+  size_t header = 2;
+  wire[0] = binary ? 0x82 : 0x81;
+  if (length < 126) {
+    wire[1] = (uint8_t)length;
+  } else {
+    wire[1] = 126;
+    wire[2] = (uint8_t)(length >> 8);
+    wire[3] = (uint8_t)length;
+    header = 4;
+  }
+  if (header + length > sizeof(wire)) return false;
+  memcpy(wire + header, payload, length);
+  return sendAll(fd, wire, header + length);
+}
+
+static void usage() {
+  fprintf(stderr, "usage: frame_emitter --pty|--ws [--format text|json|bin] [--rate HZ] [--duration S]\n");
+}
+
+int main(int argc, char** argv) {
+  Format format = FORMAT_TEXT;
+  bool pty = false, ws = false;
+  double rateHz = 100, durationS = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        usage();
+        exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--pty") pty = true;
+    else if (arg == "--ws") ws = true;
+    else if (arg == "--rate") rateHz = atof(next().c_str());
+    else if (arg == "--duration") durationS = atof(next().c_str());
+    else if (arg == "--format") {
+      std::string name = next();
+      if (name == "text") format = FORMAT_TEXT;
+      else if (name == "json") format = FORMAT_JSON;
+      else if (name == "bin") format = FORMAT_BIN;
+      else {
+        usage();
+        return 2;
+      }
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (pty == ws || rateHz <= 0) {
+    usage();
+    return 2;
+  }
+  if (pty && format == FORMAT_BIN) {
+    fprintf(stderr, "frame_emitter: over serial the firmware sends lines only (text/json)\n");
+    return 2;
+  }
+
+  int out = -1, server = -1;
+  if (pty) {
+    out = posix_openpt(O_RDWR | O_NOCTTY);
+    if (out < 0 || grantpt(out) != 0 || unlockpt(out) != 0) {
+      perror("frame_emitter: pty");
+      return 1;
+    }
+    // Raw с обеих сторон, как USB CDC: без эха и замены \r\n
+    int slave = open(ptsname(out), O_RDWR | O_NOCTTY);
+    struct termios raw;
+    if (slave < 0 || tcgetattr(slave, &raw) != 0) {
+      perror("frame_emitter: pty slave");
+      return 1;
+    }
+    cfmakeraw(&raw);
+    tcsetattr(slave, TCSANOW, &raw);
+    printf("%s\n", ptsname(out));
+    fflush(stdout);
+    // Клиент открыл порт - можно начинать
+    char go[16];
+    if (!fgets(go, sizeof(go), stdin)) return 0;
+  } else {
+    server = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+    if (server < 0 || bind(server, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(server, 1) != 0 ||
+        getsockname(server, (struct sockaddr*)&address, &addressLength) != 0) {
+      perror("frame_emitter: socket");
+      return 1;
+    }
+    printf("%u\n", ntohs(address.sin_port));
+    fflush(stdout);
+    out = acceptWebSocket(server);
+    if (out < 0) {
+      fprintf(stderr, "frame_emitter: WebSocket handshake failed\n");
+      return 1;
+    }
+  }
+
+  // Кадры по абсолютному расписанию, как таймер прошивки
+  const uint64_t periodNs = (uint64_t)(1e9 / rateHz);
+  struct timespec next;
+  clock_gettime(CLOCK_MONOTONIC, &next);
+  uint64_t endUs = durationS > 0 ? monotonicUs() + (uint64_t)(durationS * 1e6) : 0;
+  uint8_t frame[512];
+  uint32_t sent = 0;
+  for (uint32_t n = 1; endUs == 0 || monotonicUs() < endUs; n++) {
+    size_t length = buildFrame(format, n, rateHz, pty, frame, sizeof(frame));
+    bool ok = length > 0 && (pty ? write(out, frame, length) == (ssize_t)length
+                                 : sendWebSocket(out, format == FORMAT_BIN, frame, length));
+    if (!ok) break;
+    sent++;
+    uint64_t ns = next.tv_nsec + periodNs;
+    next.tv_sec += ns / 1000000000ULL;
+    next.tv_nsec = ns % 1000000000ULL;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+  }
+  fprintf(stderr, "frame_emitter: %u frames\n", sent);
+  close(out);
+  if (server >= 0) close(server);
+  return 0;
+}
@@ -0,0 +1,707 @@
+/*
+  Прогон всех вариантов ориентации по одним и тем же трассам IMU
+
+  В репозитории пять разошедшихся конвейеров ориентации (плюс второй
+  режим V7). Здесь каждый собран на ПК из тех же исходников, что и
+  прошивка: ядра ориентации подключаются прямо из папок скетчей
+  (HeadOrientation.h, BiasModelOrientation.h, SmoothedOrientation.h,
+  HeadTracker.h, QMC5883L.h), датчик читается через MPU6050Bus.h или
+  Adafruit_MPU6050 по шине Wire.h, а на шине вместо датчика - имитация
+  (Benchmark/host/MockMPU6050.h, MockQMC5883L.h), проигрывающая трассу
+  по поддельным часам. Классы ниже повторяют только setup() и loop()
+  скетча: порядок вызовов, периоды опроса и задержки.
+
+    v7_fixed      Wifi_Head_MPU6050_ESP8266_V7, FixedHeadOrientation (500 Гц)
+    v7_quat       то же, QuaternionHeadOrientation (Madgwick, 100 Гц)
+    ble_v5        Bluetooth_v5, BiasModelOrientation из FIFO (1 кГц)
+    serial_v4     MPU6050_Serial, SmoothedOrientation (100 Гц)
+    wifi_head     Wifi_Head_MPU6050, HeadTracker + сглаживание (взгляд
+                  считается из сглаженных углов и ограничен, сравнивается поза)
+    gy271         ESP8266_GY-271, QMC5883L: наклон и курс по магнитометру
+
+  Трассы (Benchmark/host/ImuTrace.h):
+    синтетические, с истинной ориентацией:
+      still  - 2 мин покоя, смещение гироскопа плывет с прогревом
+      head   - движения головой: рыскание ±70°, тангаж ±30°, крен ±15°
+      walk   - то же вполсилы + ускорения шагов (0.25g вертикально)
+      steps  - ступеньки 30° по тангажу, 20° по крену, 45° по рысканию за 0.3 с
+               (до 225°/с - в пределах ±250°/с гироскопа)
+    записанные: CSV из Benchmark/imu_log.py (decode --csv или replay), в том
+      числе из stdin ('-'); без истинной ориентации считаются только дрейф
+      в покое и стоимость. Необязательные столбцы mx,my,mz (LSB QMC5883L)
+      и pitch,roll,yaw (истина) подхватываются по заголовку.
+
+  Метрики (после 5 с - все калибровки при старте уже закончены):
+    tilt RMS      - СКО ошибки тангажа и крена, °
+    yaw RMS       - СКО ошибки рыскания, °
+    drift         - наклон ошибки рыскания в покое, °/мин (still или
+                    участки покоя записанной трассы)
+    step lag      - запаздывание пересечения 50% ступеньки, мс
+    overshoot     - перерегулирование ступеньки, %
+    settled       - средняя ошибка в последнюю секунду после ступеньки, °
+    ns/sample     - время прохода loop(), обработавшего отсчет, на ПК,
+                    вместе с имитацией шины (относительная величина:
+                    ESP8266/ESP32 медленнее в десятки раз, а float без FPU
+                    на ESP8266 - еще сильнее)
+    i2c/sample    - транзакций I2C на обработанный отсчет
+    state         - байт состояния ядра ориентации
+
+  Сборка и запуск (из корня репозитория, см. Benchmark/CMakeLists.txt):
+    cmake -S Benchmark -B build && cmake --build build
+    ./build/fusion_replay                            # все синтетические трассы
+    ./build/fusion_replay --trace head --verbose
+    ./build/fusion_replay --csv head.csv             # запись с трекера
+    python3 Benchmark/imu_log.py replay head.imulog --speed 0 | ./build/fusion_replay --csv -
+    ./build/fusion_replay --json results.json --write-traces /tmp/traces
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_MPU6050.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ImuTrace.h"
+#include "MockMPU6050.h"
+#include "MockQMC5883L.h"
+
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/HeadOrientation.h"
+#include "../../Bluetooth_ESP32/V5/Bluetooth_v5/BiasModelOrientation.h"
+#include "../../MPU6050_ESP8266_to_ESP32_I2C_v1/V4/MPU6050_Serial/SmoothedOrientation.h"
+#include "../../MPU6050_ESP8266_to_ESP32_I2C_v1/Wifi_Head_MPU6050/HeadTracker.h"
+#include "../../MPU6050_ESP8266_to_ESP32_I2C_v1/V5/ESP8266_GY-271/QMC5883L.h"
+
+#define MPU_ADDR 0x68
+
+// Остальная часть loop() (WiFi, BLE, Serial) между опросами датчика
+static const unsigned long LOOP_PASS_US = 100;
+
+// --- Конвейеры --------------------------------------------------------------
+// Каждый держит свою имитацию датчика на Wire. begin() - setup() скетча
+// (блокирующая калибровка проматывает часы через delay()), loop() - один
+// проход loop() скетча по текущим часам; true, если обработан новый отсчет.
+// pose() - последняя выданная поза, stateBytes() - размер ядра ориентации.
+// Память пустая (EEPROM стерт) - каждый скетч калибруется с нуля.
+
+// Wifi_Head_MPU6050_ESP8266_V7: setup() и loop(), ядро выбирает USE_FIXED_POINT_FILTER
+template <class Orientation>
+class V7Pipeline {
+  public:
+    static bool needsMag() { return false; }
+
+    explicit V7Pipeline(const Trace &trace) : sensor(trace) {}
+
+    void begin() {
+      Wire.attach(MPU_ADDR, &sensor);
+      mpu.begin(MPU_ADDR, &Wire);
+      mpu.setAccelerometerRange(MPU6050_RANGE_4_G);
+      mpu.setGyroRange(MPU6050_RANGE_250_DEG);
+      mpu.setFilterBandwidth(MPU6050_BAND_10_HZ);
+      float temperature = 0;
+      head.calibrate(mpuBus, temperature);
+    }
+
+    bool loop() {
+      unsigned long nowMicros = micros();
+      if (lastSampleMicros != 0 && nowMicros - lastSampleMicros < Orientation::SAMPLE_INTERVAL_US) return false;
+      unsigned long dtMicros = (lastSampleMicros == 0) ? Orientation::SAMPLE_INTERVAL_US : nowMicros - lastSampleMicros;
+      lastSampleMicros = nowMicros;
+
+      MPU6050Sample sample;
+      if (!mpuBus.readSample(sample)) return false;
+      head.update(sample, dtMicros);
+      return true;
+    }
+
+    Pose pose() const { return {head.pitch, head.roll, head.yaw}; }
+    size_t stateBytes() const { return sizeof(head); }
+
+  private:
+    MockMPU6050 sensor;
+    Adafruit_MPU6050 mpu;
+    MPU6050Bus<TwoWire> mpuBus{Wire, MPU_ADDR};
+    Orientation head;
+    unsigned long lastSampleMicros = 0;
+};
+
+class V7Fixed : public V7Pipeline<FixedHeadOrientation> {
+  public:
+    using V7Pipeline::V7Pipeline;
+    static const char *name() { return "v7_fixed"; }
+};
+
+class V7Quaternion : public V7Pipeline<QuaternionHeadOrientation> {
+  public:
+    using V7Pipeline::V7Pipeline;
+    static const char *name() { return "v7_quat"; }
+};
+
+// Bluetooth_v5: initMPU6050(), calibrateSensor(), initMPUFifo(); задача
+// чтения просыпается по DATA_RDY (раз в 1 мс) и вычитывает FIFO пачками,
+// отсчеты сразу идут в orientation.update(), как в задаче фьюжна
+class BleV5 {
+  public:
+    static const char *name() { return "ble_v5"; }
+    static bool needsMag() { return false; }
+
+    explicit BleV5(const Trace &trace) : sensor(trace) {}
+
+    void begin() {
+      Wire.attach(MPU_ADDR, &sensor);
+      mpuBus.writeRegister(0x6B, 0x00);
+      delay(100);
+      mpuBus.writeRegister(0x1B, 0x00);
+      delay(10);
+      mpuBus.writeRegister(0x1C, 0x00);
+      delay(10);
+      mpuBus.writeRegister(0x1A, 0x03);
+      delay(10);
+
+      BiasCalibrationStats stats;
+      orientation.calibrate(mpuBus, stats);
+      mpuBus.configureFifo(SAMPLE_RATE_DIV);
+    }
+
+    bool loop() {
+      if (micros() - lastDrainMicros < SAMPLE_PERIOD_US) return false;
+      lastDrainMicros = micros();
+      uint8_t buf[FIFO_BURST_SAMPLES * MPU6050_SAMPLE_BYTES];
+      int samples = mpuBus.drainFifo(buf, FIFO_BURST_SAMPLES, [this](const MPU6050Sample &sample, uint16_t age) {
+        (void)age;
+        orientation.update(sample, SAMPLE_PERIOD_US / 1000000.0f);
+      });
+      return samples > 0;
+    }
+
+    Pose pose() const { return {orientation.pitch, orientation.roll, orientation.yaw}; }
+    size_t stateBytes() const { return sizeof(orientation); }
+
+  private:
+    static const uint8_t SAMPLE_RATE_DIV = 0;          // MPU_SAMPLE_RATE_DIV
+    static const uint16_t FIFO_BURST_SAMPLES = 9;       // MPU_FIFO_BURST_SAMPLES
+    static const unsigned long SAMPLE_PERIOD_US = 1000;  // MPU_SAMPLE_PERIOD_US
+    MockMPU6050 sensor;
+    MPU6050Bus<TwoWire> mpuBus{Wire, MPU_ADDR};
+    BiasModelOrientation orientation;
+    unsigned long lastDrainMicros = 0;
+};
+
+// MPU6050_Serial: опрос раз в SAMPLE_INTERVAL_US, неблокирующая калибровка
+// (calibrateGyro()) и processSensorData()
+class SerialV4 {
+  public:
+    static const char *name() { return "serial_v4"; }
+    static bool needsMag() { return false; }
+
+    explicit SerialV4(const Trace &trace) : sensor(trace) {}
+
+    void begin() {
+      Wire.attach(MPU_ADDR, &sensor);
+      mpu.begin(MPU_ADDR, &Wire);
+      mpu.setAccelerometerRange(MPU6050_RANGE_4_G);
+      mpu.setGyroRange(MPU6050_RANGE_250_DEG);
+      mpu.setFilterBandwidth(MPU6050_BAND_10_HZ);
+      orientation.startCalibration();
+      calibrationStart = millis();
+    }
+
+    bool loop() {
+      unsigned long nowMicros = micros();
+      if (sampleMicros != 0 && nowMicros - sampleMicros < SAMPLE_INTERVAL_US) return false;
+      sampleMicros = nowMicros;
+
+      sensors_event_t a, g, temp;
+      if (!mpu.getEvent(&a, &g, &temp)) return false;
+      if (!orientation.isCalibrated()) {
+        orientation.calibrationStep(g, temp, millis() - calibrationStart);
+        return true;
+      }
+      float deltaTime = (sampleMicros - lastTime) / 1000000.0;
+      if (lastTime == 0) deltaTime = SAMPLE_INTERVAL_US / 1000000.0;
+      lastTime = sampleMicros;
+      orientation.update(a, g, deltaTime);
+      return true;
+    }
+
+    Pose pose() const { return {orientation.smoothedPitch, orientation.smoothedRoll, orientation.smoothedYaw}; }
+    size_t stateBytes() const { return sizeof(orientation); }
+
+  private:
+    static const unsigned long SAMPLE_INTERVAL_US = 10000;
+    MockMPU6050 sensor;
+    Adafruit_MPU6050 mpu;
+    SmoothedOrientation orientation;
+    unsigned long calibrationStart = 0;
+    unsigned long sampleMicros = 0;
+    unsigned long lastTime = 0;
+};
+
+// Wifi_Head_MPU6050: один отсчет на проход loop(), который кончается delay(10)
+class WifiHead {
+  public:
+    static const char *name() { return "wifi_head"; }
+    static bool needsMag() { return false; }
+
+    explicit WifiHead(const Trace &trace) : sensor(trace) {}
+
+    void begin() {
+      Wire.attach(MPU_ADDR, &sensor);
+      mpu.begin(MPU_ADDR, &Wire);
+      mpu.setAccelerometerRange(MPU6050_RANGE_4_G);
+      mpu.setGyroRange(MPU6050_RANGE_250_DEG);
+      mpu.setFilterBandwidth(MPU6050_BAND_10_HZ);
+      tracker.startCalibration(millis());
+    }
+
+    bool loop() {
+      SensorSample sample;
+      readSensorSample(mpu, sample);
+      if (!tracker.calibrated) {
+        tracker.calibrationStep(sample);
+      } else {
+        tracker.process(sample);
+      }
+      tracker.updateGaze(sample, false, 0, 0, 0);
+      tracker.checkIdle(sample);
+      delay(10);
+      return sample.valid;
+    }
+
+    Pose pose() const { return {tracker.smoothedPitch, tracker.smoothedRoll, tracker.smoothedYaw}; }
+    size_t stateBytes() const { return sizeof(tracker); }
+
+  private:
+    MockMPU6050 sensor;
+    Adafruit_MPU6050 mpu;
+    HeadTracker tracker;
+};
+
+// ESP8266_GY-271: initSensor(), затем read + calculateAngles() и delay(10)
+class Gy271 {
+  public:
+    static const char *name() { return "gy271"; }
+    static bool needsMag() { return true; }
+
+    explicit Gy271(const Trace &trace) : sensor(trace) {}
+
+    void begin() {
+      Wire.attach(QMC5883L_ADDR, &sensor);
+      compass.begin();
+      delay(10);
+    }
+
+    bool loop() {
+      int16_t x, y, z;
+      bool ok = compass.read(x, y, z);
+      if (ok) calculateCompassAngles(x, y, z, calibration, angles);
+      delay(10);
+      return ok;
+    }
+
+    Pose pose() const { return {angles.roll, angles.pitch, wrap180(-angles.heading)}; }
+    size_t stateBytes() const { return sizeof(angles) + sizeof(calibration); }
+
+  private:
+    MockQMC5883L sensor;
+    QMC5883L<TwoWire> compass{Wire};
+    CompassCalibration calibration = {-1286, 1532, -1395, 1156, -1298, 1427};
+    CompassAngles angles = CompassAngles();
+};
+
+// --- Метрики ----------------------------------------------------------------
+
+struct Result {
+  std::string pipeline, trace;
+  bool skipped = false;
+  size_t steps = 0;
+  double rateHz = 0;
+  double tiltRms = NAN, yawRms = NAN, tiltMax = NAN;
+  double yawDriftPerMin = NAN;
+  double stepLagMs = NAN, overshootPct = NAN, settledDeg = NAN;
+  double nsPerSample = NAN;
+  double i2cPerSample = NAN;
+  size_t stateBytes = 0;
+};
+
+// Наклон прямой МНК y(x)
+static double slope(const std::vector<double> &x, const std::vector<double> &y) {
+  double n = x.size(), sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (size_t i = 0; i < x.size(); i++) {
+    sx += x[i]; sy += y[i]; sxx += x[i] * x[i]; sxy += x[i] * y[i];
+  }
+  double d = n * sxx - sx * sx;
+  return d > 0 ? (n * sxy - sx * sy) / d : NAN;
+}
+
+static float axisValue(const Pose &p, int axis) {
+  return axis == 0 ? p.pitch : axis == 1 ? p.roll : p.yaw;
+}
+
+// Участки покоя без истины: |ω - среднее первых 3 с| < 1°/с не меньше 5 с
+static std::vector<std::pair<size_t, size_t>> stillSegments(const Trace &trace) {
+  std::vector<std::pair<size_t, size_t>> segments;
+  double bias[3] = {0, 0, 0};
+  size_t n = 0;
+  for (const ImuSample &s : trace.samples) {
+    if (s.tUs > 3000000) break;
+    for (int k = 0; k < 3; k++) bias[k] += s.gyro[k];
+    n++;
+  }
+  if (n == 0) return segments;
+  for (int k = 0; k < 3; k++) bias[k] /= n;
+  size_t start = 0;
+  bool inside = false;
+  for (size_t i = 0; i <= trace.samples.size(); i++) {
+    bool quiet = i < trace.samples.size() && trace.samples[i].tUs >= TRACE_SETTLE_S * 1e6;
+    if (quiet) {
+      for (int k = 0; k < 3; k++) {
+        if (fabs(trace.samples[i].gyro[k] - bias[k]) > 1.0) quiet = false;
+      }
+    }
+    if (quiet && !inside) {
+      start = i;
+      inside = true;
+    } else if (!quiet && inside) {
+      inside = false;
+      if (trace.samples[i - 1].tUs - trace.samples[start].tUs >= 5000000) segments.push_back({start, i});
+    }
+  }
+  return segments;
+}
+
+static void accuracy(const Trace &trace, const std::vector<Pose> &out, Result &r) {
+  if (trace.hasTruth) {
+    double tiltSq = 0, yawSq = 0, tiltMax = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+      if (trace.samples[i].tUs < TRACE_SETTLE_S * 1e6) continue;
+      double ep = wrap180(out[i].pitch - trace.truth[i].pitch);
+      double er = wrap180(out[i].roll - trace.truth[i].roll);
+      double ey = wrap180(out[i].yaw - trace.truth[i].yaw);
+      tiltSq += (ep * ep + er * er) / 2;
+      yawSq += ey * ey;
+      tiltMax = std::max(tiltMax, std::max(fabs(ep), fabs(er)));
+      n++;
+    }
+    if (n) {
+      r.tiltRms = sqrt(tiltSq / n);
+      r.yawRms = sqrt(yawSq / n);
+      r.tiltMax = tiltMax;
+    }
+  }
+
+  // Дрейф рыскания в покое: вся трасса still или участки покоя записи
+  std::vector<std::pair<size_t, size_t>> segments;
+  bool motionless = trace.hasTruth && trace.name == "still";
+  if (motionless) {
+    size_t from = 0;
+    while (from < out.size() && trace.samples[from].tUs < TRACE_SETTLE_S * 1e6) from++;
+    segments.push_back({from, out.size()});
+  } else if (!trace.hasTruth) {
+    segments = stillSegments(trace);
+  }
+  double weighted = 0, total = 0;
+  for (const auto &seg : segments) {
+    std::vector<double> x, y;
+    double unwrapped = 0;
+    for (size_t i = seg.first; i < seg.second; i++) {
+      double yaw = out[i].yaw - (trace.hasTruth ? trace.truth[i].yaw : 0);
+      if (!y.empty()) unwrapped += wrap180(yaw - unwrapped);
+      else unwrapped = yaw;
+      x.push_back(trace.samples[i].tUs / 60e6);
+      y.push_back(unwrapped);
+    }
+    double s = slope(x, y);
+    double w = x.back() - x.front();
+    if (!std::isnan(s)) {
+      weighted += s * w;
+      total += w;
+    }
+  }
+  if (total > 0) r.yawDriftPerMin = weighted / total;
+
+  // Ступеньки: запаздывание 50%, перерегулирование, ошибка в конце удержания
+  double lagSum = 0, overSum = 0, settledSum = 0;
+  int count = 0;
+  for (const Step &step : trace.steps) {
+    double span = step.to - step.from;
+    double truthHalf = (step.startS + step.endS) / 2;
+    double crossS = NAN, peak = 0, settled = 0;
+    int settledN = 0;
+    for (size_t i = 0; i < out.size(); i++) {
+      double t = trace.samples[i].tUs / 1e6;
+      if (t < step.startS || t >= step.holdEndS) continue;
+      double progress = wrap180(axisValue(out[i], step.axis) - step.from) / span;
+      if (std::isnan(crossS) && progress >= 0.5) crossS = t;
+      if (t >= step.endS) peak = std::max(peak, progress - 1.0);
+      if (t >= step.holdEndS - 1.0) {
+        settled += fabs(wrap180(axisValue(out[i], step.axis) - step.to));
+        settledN++;
+      }
+    }
+    if (std::isnan(crossS) || settledN == 0) continue;
+    lagSum += (crossS - truthHalf) * 1000;
+    overSum += peak * 100;
+    settledSum += settled / settledN;
+    count++;
+  }
+  if (count) {
+    r.stepLagMs = lagSum / count;
+    r.overshootPct = overSum / count;
+    r.settledDeg = settledSum / count;
+  } else if (!trace.steps.empty()) {
+    r.stepLagMs = INFINITY;   // оценка так и не дошла до половины ступеньки
+  }
+}
+
+
+static volatile float sink;
+
+// Скетч на трассе: setup() с начала трассы, затем loop() проход за проходом
+// по часам, пока они не дойдут до конца трассы. Поза записывается на
+// каждом отсчете трассы (последняя выданная скетчем)
+template <class P>
+static Result run(const Trace &trace, int repeats) {
+  Result r;
+  r.pipeline = P::name();
+  r.trace = trace.name;
+  if (P::needsMag() && !trace.hasMag) {
+    r.skipped = true;
+    return r;
+  }
+
+  // Замер: все проходы loop() вместе с имитацией шины, лучший из нескольких прогонов
+  double best = INFINITY;
+  std::vector<Pose> out;
+  for (int k = 0; k < repeats; k++) {
+    P pipeline(trace);
+    setHostMicros(0);
+    pipeline.begin();
+    Wire.resetStats();
+    r.stateBytes = pipeline.stateBytes();
+
+    out.clear();
+    out.reserve(trace.samples.size());
+    size_t steps = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < trace.samples.size(); i++) {
+      while (hostMicros <= trace.samples[i].tUs) {
+        if (pipeline.loop()) steps++;
+        advanceHostMicros(LOOP_PASS_US);
+      }
+      out.push_back(pipeline.pose());
+    }
+    auto end = std::chrono::steady_clock::now();
+    sink = pipeline.pose().yaw;
+    best = std::min(best, (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    r.steps = steps;
+    r.i2cPerSample = steps ? (double)Wire.stats().transactions() / steps : NAN;
+  }
+  Wire.detach(MPU_ADDR);
+  Wire.detach(QMC5883L_ADDR);
+
+  r.nsPerSample = r.steps ? best / r.steps : NAN;
+  double seconds = trace.samples.back().tUs / 1e6;
+  r.rateHz = seconds > 0 ? r.steps / seconds : 0;
+  accuracy(trace, out, r);
+  return r;
+}
+
+static std::vector<Result> runAll(const Trace &trace, int repeats) {
+  return {run<V7Fixed>(trace, repeats), run<V7Quaternion>(trace, repeats), run<BleV5>(trace, repeats),
+          run<SerialV4>(trace, repeats), run<WifiHead>(trace, repeats), run<Gy271>(trace, repeats)};
+}
+
+static const char *pipelineSources[][2] = {
+  {"v7_fixed", "Bluetooth_ESP32/V7 HeadOrientation.h, FixedHeadOrientation"},
+  {"v7_quat", "Bluetooth_ESP32/V7 HeadOrientation.h, QuaternionHeadOrientation"},
+  {"ble_v5", "Bluetooth_ESP32/V5 BiasModelOrientation.h"},
+  {"serial_v4", "MPU6050_Serial SmoothedOrientation.h"},
+  {"wifi_head", "Wifi_Head_MPU6050 HeadTracker.h"},
+  {"gy271", "ESP8266_GY-271 QMC5883L.h"},
+};
+
+// --- Вывод ------------------------------------------------------------------
+
+static std::string cell(double value, int decimals) {
+  if (std::isnan(value)) return "-";
+  if (std::isinf(value)) return "never";
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+  return buf;
+}
+
+static const Result *find(const std::vector<Result> &results, const std::string &pipeline, const std::string &trace) {
+  for (const Result &r : results) {
+    if (r.pipeline == pipeline && r.trace == trace && !r.skipped) return &r;
+  }
+  return nullptr;
+}
+
+static double pick(const Result *r, double Result::*field) { return r ? r->*field : NAN; }
+
+// Сводная таблица: по строке на конвейер, столбцы из тех трасс, где метрика имеет смысл
+static void printSummary(const std::vector<Result> &results, const std::vector<std::string> &traces) {
+  bool synthetic = std::find(traces.begin(), traces.end(), "head") != traces.end() ||
+                   std::find(traces.begin(), traces.end(), "still") != traces.end() ||
+                   std::find(traces.begin(), traces.end(), "walk") != traces.end() ||
+                   std::find(traces.begin(), traces.end(), "steps") != traces.end();
+  printf("\n%-10s %7s %9s %9s %9s %9s %8s %8s %8s %8s %6s %10s\n", "pipeline", "rate",
+         "tilt/head", "yaw/head", "tilt/walk", "drift", "lag", "oversh.", "settled", "ns/smp", "i2c", "state");
+  printf("%-10s %7s %9s %9s %9s %9s %8s %8s %8s %8s %6s %10s\n", "", "Hz", "RMS °", "RMS °", "RMS °",
+         "°/min", "ms", "%", "°", "host", "/smp", "bytes");
+  for (const auto &source : pipelineSources) {
+    std::string name = source[0];
+    double ns = 0, rate = 0;
+    size_t steps = 0, state = 0;
+    double nsWeighted = 0, i2c = NAN;
+    double drift = NAN;
+    for (const Result &r : results) {
+      if (r.pipeline != name || r.skipped) continue;
+      nsWeighted += r.nsPerSample * r.steps;
+      steps += r.steps;
+      rate = r.rateHz;
+      state = r.stateBytes;
+      i2c = r.i2cPerSample;
+      if (!std::isnan(r.yawDriftPerMin)) drift = r.yawDriftPerMin;
+    }
+    if (steps == 0) {
+      printf("%-10s %7s  (no input for this pipeline: needs magnetometer columns)\n", name.c_str(), "-");
+      continue;
+    }
+    ns = nsWeighted / steps;
+    const Result *head = find(results, name, "head");
+    const Result *walk = find(results, name, "walk");
+    const Result *stepRes = find(results, name, "steps");
+    printf("%-10s %7.0f %9s %9s %9s %9s %8s %8s %8s %8s %6s %10zu\n", name.c_str(), rate,
+           cell(pick(head, &Result::tiltRms), 2).c_str(), cell(pick(head, &Result::yawRms), 2).c_str(),
+           cell(pick(walk, &Result::tiltRms), 2).c_str(), cell(drift, 3).c_str(),
+           cell(pick(stepRes, &Result::stepLagMs), 0).c_str(), cell(pick(stepRes, &Result::overshootPct), 1).c_str(),
+           cell(pick(stepRes, &Result::settledDeg), 2).c_str(), cell(ns, 0).c_str(), cell(i2c, 2).c_str(), state);
+  }
+  if (!synthetic) {
+    printf("(recorded traces have no truth: only drift over still segments and cost)\n");
+  }
+}
+
+static void printDetail(const std::vector<Result> &results) {
+  printf("\n%-10s %-12s %7s %9s %9s %9s %9s %8s %8s %8s %8s %6s\n", "pipeline", "trace", "rate", "tilt RMS",
+         "tilt max", "yaw RMS", "drift", "lag ms", "oversh.", "settled", "ns/smp", "i2c");
+  for (const Result &r : results) {
+    if (r.skipped) {
+      printf("%-10s %-12s skipped (no magnetometer)\n", r.pipeline.c_str(), r.trace.c_str());
+      continue;
+    }
+    printf("%-10s %-12s %7.0f %9s %9s %9s %9s %8s %8s %8s %8s %6s\n", r.pipeline.c_str(), r.trace.c_str(), r.rateHz,
+           cell(r.tiltRms, 2).c_str(), cell(r.tiltMax, 1).c_str(), cell(r.yawRms, 2).c_str(),
+           cell(r.yawDriftPerMin, 3).c_str(), cell(r.stepLagMs, 0).c_str(), cell(r.overshootPct, 1).c_str(),
+           cell(r.settledDeg, 2).c_str(), cell(r.nsPerSample, 0).c_str(), cell(r.i2cPerSample, 2).c_str());
+  }
+}
+
+static std::string json(double value) {
+  if (std::isnan(value) || std::isinf(value)) return "null";
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.4g", value);
+  return buf;
+}
+
+static void writeJson(const std::string &path, const std::vector<Result> &results) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (!f) return;
+  fprintf(f, "[\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result &r = results[i];
+    fprintf(f, "  {\"pipeline\": \"%s\", \"trace\": \"%s\", \"skipped\": %s, \"rate_hz\": %s, "
+               "\"tilt_rms_deg\": %s, \"tilt_max_deg\": %s, \"yaw_rms_deg\": %s, \"yaw_drift_deg_per_min\": %s, "
+               "\"step_lag_ms\": %s, \"overshoot_pct\": %s, \"settled_deg\": %s, \"ns_per_sample\": %s, "
+               "\"i2c_per_sample\": %s, \"state_bytes\": %zu}%s\n",
+            r.pipeline.c_str(), r.trace.c_str(), r.skipped ? "true" : "false", json(r.rateHz).c_str(),
+            json(r.tiltRms).c_str(), json(r.tiltMax).c_str(), json(r.yawRms).c_str(),
+            json(r.yawDriftPerMin).c_str(), json(r.stepLagMs).c_str(), json(r.overshootPct).c_str(),
+            json(r.settledDeg).c_str(), json(r.nsPerSample).c_str(),
+            json(r.i2cPerSample).c_str(), r.stateBytes,
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(f, "]\n");
+  fclose(f);
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: fusion_replay [--trace still|head|walk|steps]... [--csv FILE|-]... [--seed N]\n"
+          "                     [--rate HZ] [--repeats N] [--verbose] [--json FILE] [--write-traces DIR]\n");
+}
+
+int main(int argc, char **argv) {
+  std::vector<std::string> traceNames, csvFiles;
+  std::string jsonPath, writeDir;
+  uint32_t seed = 1, rateHz = 1000;
+  int repeats = 3;
+  bool verbose = false;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        usage();
+        exit(2);
+      }
+      return argv[++i];
+    };
+    if (arg == "--trace") traceNames.push_back(next());
+    else if (arg == "--csv") csvFiles.push_back(next());
+    else if (arg == "--seed") seed = atoi(next().c_str());
+    else if (arg == "--rate") rateHz = atoi(next().c_str());
+    else if (arg == "--repeats") repeats = std::max(1, atoi(next().c_str()));
+    else if (arg == "--json") jsonPath = next();
+    else if (arg == "--write-traces") writeDir = next();
+    else if (arg == "--verbose") verbose = true;
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  std::vector<Trace> traces;
+  if (csvFiles.empty() || !traceNames.empty()) {
+    for (const Scenario &scenario : scenarios()) {
+      if (!traceNames.empty() &&
+          std::find(traceNames.begin(), traceNames.end(), scenario.name) == traceNames.end()) {
+        continue;
+      }
+      traces.push_back(synthesize(scenario, 1000000 / rateHz, seed));
+    }
+  }
+  for (const std::string &path : csvFiles) {
+    Trace trace;
+    std::string error;
+    if (!loadCsv(path, trace, error)) {
+      fprintf(stderr, "%s\n", error.c_str());
+      return 1;
+    }
+    traces.push_back(trace);
+  }
+  if (traces.empty()) {
+    usage();
+    return 2;
+  }
+
+  std::vector<Result> results;
+  std::vector<std::string> names;
+  for (const Trace &trace : traces) {
+    if (!writeDir.empty() && trace.hasTruth) writeCsv(writeDir + "/" + trace.name + ".csv", trace);
+    fprintf(stderr, "%s: %zu samples, %.1f s\n", trace.name.c_str(), trace.samples.size(),
+            trace.samples.back().tUs / 1e6);
+    std::vector<Result> part = runAll(trace, repeats);
+    results.insert(results.end(), part.begin(), part.end());
+    names.push_back(trace.name);
+  }
+
+  printSummary(results, names);
+  if (verbose) printDetail(results);
+  if (!jsonPath.empty()) writeJson(jsonPath, results);
+  return 0;
+}
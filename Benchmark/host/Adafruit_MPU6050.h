@@ -0,0 +1,137 @@
+/*
+  Замена Adafruit_MPU6050 для ПК: те же вызовы, что у библиотеки, поверх
+  Wire.h (а значит, поверх MockMPU6050.h). begin() настраивает датчик,
+  как Adafruit_MPU6050::_init(); getEvent() - одно пакетное чтение 14 байт
+  с 0x3B и те же коэффициенты перевода в м/с², рад/с и °C.
+*/
+
+#ifndef HOST_ADAFRUIT_MPU6050_H
+#define HOST_ADAFRUIT_MPU6050_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_Sensor.h>
+
+#define MPU6050_I2CADDR_DEFAULT 0x68
+
+typedef enum {
+  MPU6050_RANGE_2_G = 0,
+  MPU6050_RANGE_4_G = 1,
+  MPU6050_RANGE_8_G = 2,
+  MPU6050_RANGE_16_G = 3,
+} mpu6050_accel_range_t;
+
+typedef enum {
+  MPU6050_RANGE_250_DEG = 0,
+  MPU6050_RANGE_500_DEG = 1,
+  MPU6050_RANGE_1000_DEG = 2,
+  MPU6050_RANGE_2000_DEG = 3,
+} mpu6050_gyro_range_t;
+
+typedef enum {
+  MPU6050_BAND_260_HZ = 0,
+  MPU6050_BAND_184_HZ = 1,
+  MPU6050_BAND_94_HZ = 2,
+  MPU6050_BAND_44_HZ = 3,
+  MPU6050_BAND_21_HZ = 4,
+  MPU6050_BAND_10_HZ = 5,
+  MPU6050_BAND_5_HZ = 6,
+} mpu6050_bandwidth_t;
+
+class Adafruit_MPU6050 {
+  public:
+    bool begin(uint8_t address = MPU6050_I2CADDR_DEFAULT, TwoWire* wire = &Wire, int32_t sensorId = 0) {
+      (void)sensorId;
+      addr = address;
+      bus = wire;
+      uint8_t id = 0;
+      if (!readRegisters(0x75, &id, 1) || id != 0x68) return false;
+      writeRegister(0x6B, 0x80);          // DEVICE_RESET
+      delay(100);
+      writeRegister(0x68, 0x07);          // SIGNAL_PATH_RESET
+      delay(100);
+      writeRegister(0x19, 0);             // SMPLRT_DIV
+      setFilterBandwidth(MPU6050_BAND_260_HZ);
+      setGyroRange(MPU6050_RANGE_500_DEG);
+      setAccelerometerRange(MPU6050_RANGE_2_G);
+      writeRegister(0x6B, 0x01);          // Тактирование от PLL гироскопа X
+      delay(100);
+      return true;
+    }
+
+    void setAccelerometerRange(mpu6050_accel_range_t range) {
+      accelRange = range;
+      updateBits(0x1C, 0x18, range << 3);
+    }
+    mpu6050_accel_range_t getAccelerometerRange() const { return accelRange; }
+
+    void setGyroRange(mpu6050_gyro_range_t range) {
+      gyroRange = range;
+      updateBits(0x1B, 0x18, range << 3);
+    }
+    mpu6050_gyro_range_t getGyroRange() const { return gyroRange; }
+
+    void setFilterBandwidth(mpu6050_bandwidth_t bandwidth) {
+      filterBandwidth = bandwidth;
+      updateBits(0x1A, 0x07, bandwidth);
+    }
+    mpu6050_bandwidth_t getFilterBandwidth() const { return filterBandwidth; }
+
+    bool getEvent(sensors_event_t* accel, sensors_event_t* gyro, sensors_event_t* temp) {
+      uint8_t buf[14];
+      if (!readRegisters(0x3B, buf, sizeof(buf))) return false;
+      int16_t raw[7];
+      for (int i = 0; i < 7; i++) raw[i] = (int16_t)(buf[2 * i] << 8 | buf[2 * i + 1]);
+
+      static const float accelScales[] = {16384, 8192, 4096, 2048};
+      static const float gyroScales[] = {131, 65.5, 32.8, 16.4};
+      float accelScale = accelScales[accelRange];
+      float gyroScale = gyroScales[gyroRange];
+
+      memset(accel, 0, sizeof(*accel));
+      memset(gyro, 0, sizeof(*gyro));
+      memset(temp, 0, sizeof(*temp));
+      uint32_t timestamp = millis();
+      accel->timestamp = gyro->timestamp = temp->timestamp = timestamp;
+      accel->acceleration.x = ((float)raw[0] / accelScale) * SENSORS_GRAVITY_STANDARD;
+      accel->acceleration.y = ((float)raw[1] / accelScale) * SENSORS_GRAVITY_STANDARD;
+      accel->acceleration.z = ((float)raw[2] / accelScale) * SENSORS_GRAVITY_STANDARD;
+      temp->temperature = ((float)raw[3] / 340.0) + 36.53;
+      gyro->gyro.x = ((float)raw[4] / gyroScale) * SENSORS_DPS_TO_RADS;
+      gyro->gyro.y = ((float)raw[5] / gyroScale) * SENSORS_DPS_TO_RADS;
+      gyro->gyro.z = ((float)raw[6] / gyroScale) * SENSORS_DPS_TO_RADS;
+      return true;
+    }
+
+  private:
+    TwoWire* bus = &Wire;
+    uint8_t addr = MPU6050_I2CADDR_DEFAULT;
+    mpu6050_accel_range_t accelRange = MPU6050_RANGE_2_G;
+    mpu6050_gyro_range_t gyroRange = MPU6050_RANGE_500_DEG;
+    mpu6050_bandwidth_t filterBandwidth = MPU6050_BAND_260_HZ;
+
+    bool readRegisters(uint8_t reg, uint8_t* buf, size_t len) {
+      bus->beginTransmission(addr);
+      bus->write(reg);
+      if (bus->endTransmission(false) != 0) return false;
+      if (bus->requestFrom(addr, len, true) != len) return false;
+      for (size_t i = 0; i < len; i++) buf[i] = bus->read();
+      return true;
+    }
+
+    void writeRegister(uint8_t reg, uint8_t value) {
+      bus->beginTransmission(addr);
+      bus->write(reg);
+      bus->write(value);
+      bus->endTransmission(true);
+    }
+
+    // Adafruit_BusIO_RegisterBits: чтение регистра и запись с новыми битами
+    void updateBits(uint8_t reg, uint8_t mask, uint8_t bits) {
+      uint8_t value = 0;
+      readRegisters(reg, &value, 1);
+      writeRegister(reg, (value & ~mask) | (bits & mask));
+    }
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*
+  Замена Arduino.h для сборки кода скетчей на ПК (Benchmark/CMakeLists.txt)
+
+  Часы подделаны: время стоит, пока его не двинут - прогон трассы
+  (setHostMicros()), delay()/delayMicroseconds() или тест. Так прогоны
+  детерминированы, а код, который ждет через delay() (калибровка,
+  сброс FIFO), на ПК не спит, а проматывает время - и имитации датчиков
+  на шине (Wire.h) видят его ход.
+
+  Остальное - то, что нужно заголовкам и .cpp из папок скетчей: String
+  (WString.h), Serial, IPAddress, PROGMEM, strlcpy (в glibc ее нет),
+  dtostrf как в ядре ESP8266, ESP.restart().
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PGM_P const char*
+#define F(text) (text)
+#define FPSTR(p) ((const char*)(p))
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+
+// --- Часы -------------------------------------------------------------------
+
+inline uint64_t hostMicros = 0;
+
+inline void setHostMicros(uint64_t us) { hostMicros = us; }
+inline void advanceHostMicros(uint64_t us) { hostMicros += us; }
+
+inline unsigned long micros() { return (unsigned long)(uint32_t)hostMicros; }
+inline unsigned long millis() { return (unsigned long)(uint32_t)(hostMicros / 1000); }
+inline void delay(unsigned long ms) { hostMicros += (uint64_t)ms * 1000; }
+inline void delayMicroseconds(unsigned int us) { hostMicros += us; }
+inline void yield() {}
+
+// --- Математика и строки ----------------------------------------------------
+
+template <class T, class L, class H>
+inline T constrain(T x, L low, H high) {
+  return x < low ? (T)low : (x > high ? (T)high : x);
+}
+
+// Целочисленная, как в Arduino
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+inline long random(long low, long high) {
+  return high > low ? low + rand() % (high - low) : low;
+}
+inline long random(long high) { return random(0, high); }
+inline void randomSeed(unsigned long seed) { srand(seed); }
+
+#ifndef HOST_HAVE_STRLCPY
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t len = strlen(src);
+  if (size > 0) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+// core_esp8266_noniso.cpp (и stdlib_noniso.c ядра ESP32) - этим
+// String(value, decimals) печатает float/double; тот же алгоритм
+// побайтно, включая округление и извлечение цифр в double
+inline char* dtostrf(double number, signed char width, unsigned char prec, char* s) {
+  bool negative = false;
+
+  if (isnan(number)) {
+    strcpy(s, "nan");
+    return s;
+  }
+  if (isinf(number)) {
+    strcpy(s, "inf");
+    return s;
+  }
+
+  char* out = s;
+  int fillme = width;
+  if (prec > 0) fillme -= (prec + 1);
+
+  if (number < 0.0) {
+    negative = true;
+    fillme--;
+    number = -number;
+  }
+
+  double rounding = 2.0;
+  for (uint8_t i = 0; i < prec; ++i) rounding *= 10.0;
+  rounding = 1.0 / rounding;
+  number += rounding;
+
+  double tenpow = 1.0;
+  int digitcount = 1;
+  while (number >= 10.0 * tenpow) {
+    tenpow *= 10.0;
+    digitcount++;
+  }
+
+  number /= tenpow;
+  fillme -= digitcount;
+  while (fillme-- > 0) *out++ = ' ';
+  if (negative) *out++ = '-';
+
+  digitcount += prec;
+  int8_t digit = 0;
+  while (digitcount-- > 0) {
+    digit = (int8_t)number;
+    if (digit > 9) digit = 9;
+    *out++ = (char)('0' | digit);
+    if ((digitcount == prec) && (prec > 0)) *out++ = '.';
+    number -= digit;
+    number *= 10.0;
+  }
+  *out = 0;
+  return s;
+}
+
+#include "WString.h"
+
+// --- Вывод ------------------------------------------------------------------
+
+#define DEC 10
+#define HEX 16
+
+// Print без вывода: скетчи много печатают, прогонам это не нужно.
+// HOST_SERIAL_ECHO=1 в окружении - печать в stdout (отладка)
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return write(&c, 1); }
+    virtual size_t write(const uint8_t* data, size_t length) {
+      if (echo()) fwrite(data, 1, length, stdout);
+      return length;
+    }
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String &text) { return write((const uint8_t*)text.c_str(), text.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print(String((long)value, base)); }
+    size_t print(unsigned value, int base = DEC) { return print(String((unsigned long)value, base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(const T &value) { return print(value) + println(); }
+    template <class T> size_t println(const T &value, int format) { return print(value, format) + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+      char buf[256];
+      va_list args;
+      va_start(args, format);
+      int n = vsnprintf(buf, sizeof(buf), format, args);
+      va_end(args);
+      if (n < 0) return 0;
+      return write((const uint8_t*)buf, std::min((size_t)n, sizeof(buf) - 1));
+    }
+
+    void flush() {}
+
+  private:
+    static bool echo() {
+      static int enabled = -1;
+      if (enabled < 0) enabled = getenv("HOST_SERIAL_ECHO") != nullptr;
+      return enabled == 1;
+    }
+};
+
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    String readStringUntil(char) { return String(); }
+    operator bool() const { return true; }
+};
+
+inline HardwareSerial Serial;
+
+// --- Адреса -----------------------------------------------------------------
+
+class IPAddress {
+  public:
+    IPAddress() : address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : address((uint32_t)a | (uint32_t)b << 8 | (uint32_t)c << 16 | (uint32_t)d << 24) {}
+    IPAddress(uint32_t value) : address(value) {}
+
+    operator uint32_t() const { return address; }
+    uint8_t operator[](int index) const { return (uint8_t)(address >> (8 * index)); }
+    bool operator==(const IPAddress &other) const { return address == other.address; }
+    bool operator!=(const IPAddress &other) const { return address != other.address; }
+    bool isSet() const { return address != 0; }
+
+    bool fromString(const char* text) {
+      unsigned a, b, c, d;
+      if (sscanf(text, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+        return false;
+      }
+      *this = IPAddress(a, b, c, d);
+      return true;
+    }
+    bool fromString(const String &text) { return fromString(text.c_str()); }
+
+    String toString() const {
+      char buf[16];
+      snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+      return String(buf);
+    }
+
+  private:
+    uint32_t address;
+};
+
+// --- Плата ------------------------------------------------------------------
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+inline int analogRead(uint8_t) { return 0; }
+
+class EspClass {
+  public:
+    void restart() { restarts++; }
+    uint32_t getFreeHeap() const { return 40000; }
+    uint32_t getChipId() const { return 0x00C0FFEE; }
+    uint32_t restarts = 0;
+};
+
+inline EspClass ESP;
+
+#endif
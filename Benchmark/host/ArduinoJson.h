@@ -0,0 +1,539 @@
+/*
+  Замена ArduinoJson.h (API 6.x) для ПК: то подмножество, которым
+  пользуются скетчи - DynamicJsonDocument, JsonObject/JsonArray,
+  doc["key"] = значение и обратно (String, const char*, числа, bool),
+  containsKey(), createNestedArray()/createNestedObject(),
+  serializeJson() и deserializeJson().
+
+  Дерево лежит в обычной куче, capacity документа не ограничивает его -
+  для тестов логики этого хватает; памяти и скорости самой библиотеки
+  такая замена не измеряет.
+*/
+
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace host_json {
+
+struct Node {
+  enum Type { NUL, BOOL, INT, UINT, FLOAT, STRING, ARRAY, OBJECT } type = NUL;
+  bool b = false;
+  long long i = 0;
+  unsigned long long u = 0;
+  double f = 0;
+  std::string s;
+  std::vector<std::string> keys;                 // OBJECT
+  std::vector<std::unique_ptr<Node>> values;     // OBJECT и ARRAY, адреса не меняются
+
+  Node* find(const char* key) const {
+    if (type != OBJECT || key == nullptr) return nullptr;
+    for (size_t k = 0; k < keys.size(); k++) {
+      if (keys[k] == key) return values[k].get();
+    }
+    return nullptr;
+  }
+
+  Node* member(const char* key) {
+    if (type != OBJECT) {
+      *this = Node();
+      type = OBJECT;
+    }
+    Node* found = find(key);
+    if (found) return found;
+    keys.push_back(key);
+    values.emplace_back(new Node());
+    return values.back().get();
+  }
+
+  Node* append() {
+    if (type != ARRAY) {
+      *this = Node();
+      type = ARRAY;
+    }
+    values.emplace_back(new Node());
+    return values.back().get();
+  }
+
+  Node &operator=(Node &&other) = default;
+  Node() = default;
+  Node(const Node &) = delete;
+  Node &operator=(const Node &) = delete;
+
+  void setNull() { *this = Node(); }
+  void setString(const char* text) {
+    if (text == nullptr) {
+      setNull();
+      return;
+    }
+    *this = Node();
+    type = STRING;
+    s = text;
+  }
+  template <class T>
+  void setNumber(T value) {
+    *this = Node();
+    if (std::is_same<T, bool>::value) {
+      type = BOOL;
+      b = value;
+    } else if (std::is_floating_point<T>::value) {
+      type = FLOAT;
+      f = value;
+    } else if (std::is_signed<T>::value) {
+      type = INT;
+      i = (long long)value;
+    } else {
+      type = UINT;
+      u = (unsigned long long)value;
+    }
+  }
+
+  template <class T>
+  T number() const {
+    switch (type) {
+      case BOOL: return (T)b;
+      case INT: return (T)i;
+      case UINT: return (T)u;
+      case FLOAT: return (T)f;
+      default: return T();
+    }
+  }
+};
+
+inline void writeString(std::string &out, const std::string &text) {
+  out += '"';
+  for (char c : text) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out += buf;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+inline void write(std::string &out, const Node &node) {
+  char buf[32];
+  switch (node.type) {
+    case Node::NUL: out += "null"; break;
+    case Node::BOOL: out += node.b ? "true" : "false"; break;
+    case Node::INT: snprintf(buf, sizeof(buf), "%lld", node.i); out += buf; break;
+    case Node::UINT: snprintf(buf, sizeof(buf), "%llu", node.u); out += buf; break;
+    case Node::FLOAT: snprintf(buf, sizeof(buf), "%.9g", node.f); out += buf; break;
+    case Node::STRING: writeString(out, node.s); break;
+    case Node::ARRAY:
+      out += '[';
+      for (size_t k = 0; k < node.values.size(); k++) {
+        if (k) out += ',';
+        write(out, *node.values[k]);
+      }
+      out += ']';
+      break;
+    case Node::OBJECT:
+      out += '{';
+      for (size_t k = 0; k < node.values.size(); k++) {
+        if (k) out += ',';
+        writeString(out, node.keys[k]);
+        out += ':';
+        write(out, *node.values[k]);
+      }
+      out += '}';
+      break;
+  }
+}
+
+class Parser {
+  public:
+    explicit Parser(const char* text) : p(text) {}
+
+    bool parse(Node &node) {
+      if (!value(node)) return false;
+      skip();
+      return *p == '\0';
+    }
+
+  private:
+    const char* p;
+
+    void skip() {
+      while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    }
+
+    bool literal(const char* word) {
+      size_t n = strlen(word);
+      if (strncmp(p, word, n) != 0) return false;
+      p += n;
+      return true;
+    }
+
+    bool string(std::string &out) {
+      if (*p != '"') return false;
+      p++;
+      while (*p && *p != '"') {
+        if (*p == '\\') {
+          p++;
+          switch (*p) {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u': {
+              unsigned code = 0;
+              if (sscanf(p + 1, "%4x", &code) != 1) return false;
+              out += (char)(code < 0x80 ? code : '?');
+              p += 4;
+              break;
+            }
+            case '\0': return false;
+            default: out += *p;
+          }
+          p++;
+        } else {
+          out += *p++;
+        }
+      }
+      if (*p != '"') return false;
+      p++;
+      return true;
+    }
+
+    bool value(Node &node) {
+      skip();
+      if (*p == '{') {
+        p++;
+        node.setNull();
+        node.type = Node::OBJECT;
+        skip();
+        if (*p == '}') {
+          p++;
+          return true;
+        }
+        while (true) {
+          skip();
+          std::string key;
+          if (!string(key)) return false;
+          skip();
+          if (*p++ != ':') return false;
+          if (!value(*node.member(key.c_str()))) return false;
+          skip();
+          if (*p == ',') {
+            p++;
+            continue;
+          }
+          if (*p == '}') {
+            p++;
+            return true;
+          }
+          return false;
+        }
+      }
+      if (*p == '[') {
+        p++;
+        node.setNull();
+        node.type = Node::ARRAY;
+        skip();
+        if (*p == ']') {
+          p++;
+          return true;
+        }
+        while (true) {
+          if (!value(*node.append())) return false;
+          skip();
+          if (*p == ',') {
+            p++;
+            continue;
+          }
+          if (*p == ']') {
+            p++;
+            return true;
+          }
+          return false;
+        }
+      }
+      if (*p == '"') {
+        std::string text;
+        if (!string(text)) return false;
+        node.setString(text.c_str());
+        return true;
+      }
+      if (literal("true")) {
+        node.setNumber(true);
+        return true;
+      }
+      if (literal("false")) {
+        node.setNumber(false);
+        return true;
+      }
+      if (literal("null")) {
+        node.setNull();
+        return true;
+      }
+      char* end = nullptr;
+      const char* start = p;
+      bool isFloat = false;
+      for (const char* q = p; *q && strchr("+-0123456789.eE", *q); q++) {
+        if (*q == '.' || *q == 'e' || *q == 'E') isFloat = true;
+      }
+      if (isFloat) {
+        double f = strtod(start, &end);
+        if (end == start) return false;
+        node.setNumber(f);
+      } else if (*start == '-') {
+        long long i = strtoll(start, &end, 10);
+        if (end == start) return false;
+        node.setNumber(i);
+      } else {
+        unsigned long long u = strtoull(start, &end, 10);
+        if (end == start) return false;
+        node.setNumber(u);
+      }
+      p = end;
+      return true;
+    }
+};
+
+}  // namespace host_json
+
+class JsonArray;
+class JsonObject;
+
+// doc["key"] / object["key"]: чтение не создает член, запись - создает
+class JsonVariant {
+  public:
+    JsonVariant(host_json::Node* parent, const char* key) : parent(parent), key(key) {}
+
+    JsonVariant &operator=(const char* text) {
+      target()->setString(text);
+      return *this;
+    }
+    JsonVariant &operator=(const String &text) { return *this = text.c_str(); }
+    JsonVariant &operator=(std::nullptr_t) {
+      target()->setNull();
+      return *this;
+    }
+    template <class T, class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    JsonVariant &operator=(T value) {
+      target()->setNumber(value);
+      return *this;
+    }
+
+    template <class T>
+    T as() const;
+
+    template <class T>
+    operator T() const {
+      return as<T>();
+    }
+
+    bool isNull() const {
+      const host_json::Node* node = parent ? parent->find(key.c_str()) : nullptr;
+      return node == nullptr || node->type == host_json::Node::NUL;
+    }
+
+  private:
+    host_json::Node* parent;
+    std::string key;
+
+    host_json::Node* target() { return parent->member(key.c_str()); }
+    const host_json::Node* node() const { return parent ? parent->find(key.c_str()) : nullptr; }
+
+    template <class T>
+    T number() const {
+      const host_json::Node* n = node();
+      return n ? n->number<T>() : T();
+    }
+    const char* text() const {
+      const host_json::Node* n = node();
+      return n && n->type == host_json::Node::STRING ? n->s.c_str() : nullptr;
+    }
+    template <class T>
+    friend struct JsonVariantAs;
+};
+
+template <class T>
+struct JsonVariantAs {
+  static T get(const JsonVariant &v) { return v.number<T>(); }
+};
+template <>
+struct JsonVariantAs<const char*> {
+  static const char* get(const JsonVariant &v) { return v.text(); }
+};
+template <>
+struct JsonVariantAs<String> {
+  static String get(const JsonVariant &v) {
+    const char* text = v.text();
+    return text ? String(text) : String("null");
+  }
+};
+
+template <class T>
+T JsonVariant::as() const {
+  return JsonVariantAs<T>::get(*this);
+}
+
+class JsonObject {
+  public:
+    JsonObject(host_json::Node* node = nullptr) : node(node) {}
+
+    JsonVariant operator[](const char* key) const { return JsonVariant(node, key); }
+    JsonVariant operator[](const String &key) const { return JsonVariant(node, key.c_str()); }
+    bool containsKey(const char* key) const { return node && node->find(key) != nullptr; }
+    JsonArray createNestedArray(const char* key) const;
+    JsonObject createNestedObject(const char* key) const;
+    bool isNull() const { return node == nullptr; }
+    size_t size() const { return node ? node->values.size() : 0; }
+
+    host_json::Node* node;
+};
+
+class JsonArray {
+  public:
+    JsonArray(host_json::Node* node = nullptr) : node(node) {}
+
+    JsonObject createNestedObject() const {
+      host_json::Node* child = node->append();
+      child->type = host_json::Node::OBJECT;
+      return JsonObject(child);
+    }
+    JsonArray createNestedArray() const {
+      host_json::Node* child = node->append();
+      child->type = host_json::Node::ARRAY;
+      return JsonArray(child);
+    }
+    bool add(const char* text) const {
+      node->append()->setString(text);
+      return true;
+    }
+    bool add(const String &text) const { return add(text.c_str()); }
+    template <class T, class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    bool add(T value) const {
+      node->append()->setNumber(value);
+      return true;
+    }
+    size_t size() const { return node ? node->values.size() : 0; }
+    bool isNull() const { return node == nullptr; }
+
+    host_json::Node* node;
+};
+
+inline JsonArray JsonObject::createNestedArray(const char* key) const {
+  host_json::Node* child = node->member(key);
+  child->setNull();
+  child->type = host_json::Node::ARRAY;
+  return JsonArray(child);
+}
+
+inline JsonObject JsonObject::createNestedObject(const char* key) const {
+  host_json::Node* child = node->member(key);
+  child->setNull();
+  child->type = host_json::Node::OBJECT;
+  return JsonObject(child);
+}
+
+class JsonDocument {
+  public:
+    JsonVariant operator[](const char* key) { return JsonVariant(&root, key); }
+    JsonVariant operator[](const String &key) { return JsonVariant(&root, key.c_str()); }
+    bool containsKey(const char* key) const { return root.find(key) != nullptr; }
+    JsonArray createNestedArray(const char* key) { return object().createNestedArray(key); }
+    JsonObject createNestedObject(const char* key) { return object().createNestedObject(key); }
+    JsonArray to_array() {
+      root.setNull();
+      root.type = host_json::Node::ARRAY;
+      return JsonArray(&root);
+    }
+    void clear() { root.setNull(); }
+    bool isNull() const { return root.type == host_json::Node::NUL; }
+
+    host_json::Node root;
+
+  private:
+    JsonObject object() {
+      if (root.type != host_json::Node::OBJECT) {
+        root.setNull();
+        root.type = host_json::Node::OBJECT;
+      }
+      return JsonObject(&root);
+    }
+};
+
+class DynamicJsonDocument : public JsonDocument {
+  public:
+    explicit DynamicJsonDocument(size_t capacity) : capacity(capacity) {}
+    size_t capacity;
+};
+
+template <size_t CAPACITY>
+class StaticJsonDocument : public JsonDocument {};
+
+class DeserializationError {
+  public:
+    enum Code { Ok, EmptyInput, InvalidInput };
+    DeserializationError(Code code = Ok) : code(code) {}
+    explicit operator bool() const { return code != Ok; }
+    bool operator==(Code other) const { return code == other; }
+    const char* c_str() const {
+      switch (code) {
+        case Ok: return "Ok";
+        case EmptyInput: return "EmptyInput";
+        default: return "InvalidInput";
+      }
+    }
+
+  private:
+    Code code;
+};
+
+inline DeserializationError deserializeJson(JsonDocument &doc, const char* input) {
+  doc.clear();
+  if (input == nullptr || *input == '\0') return DeserializationError::EmptyInput;
+  host_json::Parser parser(input);
+  if (!parser.parse(doc.root)) {
+    doc.clear();
+    return DeserializationError::InvalidInput;
+  }
+  return DeserializationError::Ok;
+}
+inline DeserializationError deserializeJson(JsonDocument &doc, const String &input) {
+  return deserializeJson(doc, input.c_str());
+}
+inline DeserializationError deserializeJson(JsonDocument &doc, const uint8_t* input, size_t length) {
+  std::string text((const char*)input, length);
+  return deserializeJson(doc, text.c_str());
+}
+
+inline size_t serializeJson(const JsonDocument &doc, String &output) {
+  std::string text;
+  host_json::write(text, doc.root);
+  output = String(text.c_str(), text.size());
+  return text.size();
+}
+inline size_t serializeJson(const JsonDocument &doc, char* output, size_t size) {
+  std::string text;
+  host_json::write(text, doc.root);
+  if (size > 0) strlcpy(output, text.c_str(), size);
+  return std::min(text.size(), size ? size - 1 : 0);
+}
+inline size_t measureJson(const JsonDocument &doc) {
+  std::string text;
+  host_json::write(text, doc.root);
+  return text.size();
+}
+
+#endif
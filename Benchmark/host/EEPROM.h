@@ -0,0 +1,45 @@
+/*
+  Замена EEPROM.h для ПК: память в ОЗУ, как эмулированная EEPROM ESP8266/
+  ESP32 (begin(size), commit()). Счетчик commit() - сколько раз скетч
+  писал бы во флеш.
+*/
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <string.h>
+#include <stdint.h>
+
+#define HOST_EEPROM_SIZE 4096
+
+class EEPROMClass {
+  public:
+    void begin(size_t newSize) { used = newSize < HOST_EEPROM_SIZE ? newSize : HOST_EEPROM_SIZE; }
+    template <class T> T &get(int address, T &value) {
+      memcpy(&value, data + address, sizeof(T));
+      return value;
+    }
+    template <class T> const T &put(int address, const T &value) {
+      memcpy(data + address, &value, sizeof(T));
+      return value;
+    }
+    uint8_t read(int address) const { return data[address]; }
+    void write(int address, uint8_t value) { data[address] = value; }
+    bool commit() {
+      commits++;
+      return true;
+    }
+    void end() {}
+    size_t length() const { return used; }
+    void clear() { memset(data, 0xFF, sizeof(data)); }
+
+    uint32_t commits = 0;
+
+  private:
+    unsigned char data[HOST_EEPROM_SIZE] = {0};
+    size_t used = HOST_EEPROM_SIZE;
+};
+
+inline EEPROMClass EEPROM;
+
+#endif
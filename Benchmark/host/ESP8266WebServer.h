@@ -0,0 +1,153 @@
+/*
+  Замена ESP8266WebServer.h для ПК: маршруты и ответы без сокетов
+
+  Запрос подает тест (hostRequest()): сервер находит обработчик так же,
+  как библиотека (точный uri и метод, иначе onNotFound), а обработчик
+  читает аргументы и заголовки через обычные arg()/header(). Ответ не
+  уходит в сеть, а остается в response - код, тип, тело и заголовки.
+  Заголовок запроса виден через header(), только если его имя передано
+  в collectHeaders(), как в библиотеке.
+*/
+
+#ifndef HOST_ESP8266_WEB_SERVER_H
+#define HOST_ESP8266_WEB_SERVER_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <functional>
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+struct HostHttpResponse {
+  int code = 0;
+  String contentType;
+  String body;
+  std::vector<std::pair<String, String>> headers;
+
+  String header(const char* name) const {
+    for (auto &h : headers) {
+      if (h.first.equalsIgnoreCase(name)) return h.second;
+    }
+    return String();
+  }
+};
+
+class ESP8266WebServer {
+  public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    ESP8266WebServer(int port = 80) : serverPort(port) {}
+
+    void begin() { started = true; }
+    void handleClient() {}
+
+    void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction handler) {
+      routes.push_back({uri, method, handler});
+    }
+    void onNotFound(THandlerFunction handler) { notFound = handler; }
+
+    void collectHeaders(const char* headerKeys[], const size_t headerKeysCount) {
+      collected.clear();
+      for (size_t i = 0; i < headerKeysCount; i++) collected.push_back(headerKeys[i]);
+    }
+
+    // --- Запрос -------------------------------------------------------------
+
+    String uri() const { return requestUri; }
+    HTTPMethod method() const { return requestMethod; }
+    int args() const { return (int)requestArgs.size(); }
+    String arg(int i) const { return i < args() ? requestArgs[i].second : String(); }
+    String argName(int i) const { return i < args() ? requestArgs[i].first : String(); }
+    String arg(const String &name) const {
+      for (auto &a : requestArgs) {
+        if (a.first == name) return a.second;
+      }
+      return String();
+    }
+    bool hasArg(const String &name) const {
+      for (auto &a : requestArgs) {
+        if (a.first == name) return true;
+      }
+      return false;
+    }
+    String header(const String &name) const {
+      for (auto &h : requestHeaders) {
+        if (h.first.equalsIgnoreCase(name)) return h.second;
+      }
+      return String();
+    }
+    WiFiClient client() { return WiFiClient(); }
+
+    // --- Ответ --------------------------------------------------------------
+
+    void sendHeader(const String &name, const String &value, bool first = false) {
+      (void)first;
+      pendingHeaders.push_back({name, value});
+    }
+    void send(int code, const char* contentType = nullptr, const String &content = String()) {
+      response.code = code;
+      response.contentType = contentType ? contentType : "";
+      response.body = content;
+      response.headers = pendingHeaders;
+      pendingHeaders.clear();
+      responses++;
+    }
+    void send(int code, const String &contentType, const String &content) {
+      send(code, contentType.c_str(), content);
+    }
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength) {
+      send(code, contentType, String(content, contentLength));
+    }
+
+    // --- Для тестов ---------------------------------------------------------
+
+    // Один запрос: headers и args - пары имя/значение, тело POST - аргумент "plain"
+    const HostHttpResponse &hostRequest(HTTPMethod method, const char* path,
+                                        std::vector<std::pair<String, String>> headers = {},
+                                        std::vector<std::pair<String, String>> args = {}) {
+      requestMethod = method;
+      requestUri = path;
+      requestArgs = args;
+      requestHeaders.clear();
+      for (auto &h : headers) {
+        for (auto &name : collected) {
+          if (h.first.equalsIgnoreCase(name)) requestHeaders.push_back(h);
+        }
+      }
+      response = HostHttpResponse();
+      pendingHeaders.clear();
+      for (auto &route : routes) {
+        if (route.uri == requestUri && (route.method == HTTP_ANY || route.method == method)) {
+          route.handler();
+          return response;
+        }
+      }
+      if (notFound) notFound();
+      return response;
+    }
+
+    HostHttpResponse response;
+    uint32_t responses = 0;
+    bool started = false;
+
+  private:
+    struct Route {
+      String uri;
+      HTTPMethod method;
+      THandlerFunction handler;
+    };
+
+    int serverPort;
+    std::vector<Route> routes;
+    THandlerFunction notFound;
+    std::vector<String> collected;
+    String requestUri;
+    HTTPMethod requestMethod = HTTP_GET;
+    std::vector<std::pair<String, String>> requestArgs;
+    std::vector<std::pair<String, String>> requestHeaders;
+    std::vector<std::pair<String, String>> pendingHeaders;
+};
+
+#endif
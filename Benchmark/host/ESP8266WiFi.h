@@ -0,0 +1,146 @@
+/*
+  Замена ESP8266WiFi.h для ПК: поддельный драйвер WiFi
+
+  Ничего не ждет и никуда не подключается: состояние, которое на
+  устройстве меняет стек WiFi, тест выставляет сам (hostStatus,
+  hostScanResult, hostNetworks). Счетчики вызовов показывают, как часто
+  код опрашивает драйвер - WiFiJobs.h проверяется на нем.
+
+  Плюс то, что Wifi_ESP8266.cpp берет из SDK: WiFiClient, station_info,
+  wifi_softap_get_station_info().
+*/
+
+#ifndef HOST_ESP8266_WIFI_H
+#define HOST_ESP8266_WIFI_H
+
+#include <Arduino.h>
+#include <vector>
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_WRONG_PASSWORD = 6,
+  WL_DISCONNECTED = 7
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } WiFiMode_t;
+
+enum wl_enc_type { ENC_TYPE_WEP = 5, ENC_TYPE_TKIP = 2, ENC_TYPE_CCMP = 4, ENC_TYPE_NONE = 7, ENC_TYPE_AUTO = 8 };
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED  (-2)
+
+// Клиент TCP: вывод уходит в Print (по умолчанию - в никуда)
+class WiFiClient : public Print {
+  public:
+    uint8_t connected() { return 1; }
+    void stop() {}
+};
+
+struct HostNetwork {
+  String ssid;
+  int32_t rssi;
+  uint8_t encryption;
+};
+
+class ESP8266WiFiClass {
+  public:
+    // Что сейчас ответил бы стек WiFi
+    wl_status_t hostStatus = WL_DISCONNECTED;
+    int hostScanResult = WIFI_SCAN_RUNNING;   // scanComplete() во время скана
+    bool hostScanStartFails = false;
+    std::vector<HostNetwork> hostNetworks;
+    IPAddress hostLocalIP = IPAddress(192, 168, 1, 50);
+
+    // Сколько раз код обращался к драйверу
+    uint32_t beginCalls = 0, statusCalls = 0, disconnectCalls = 0;
+    uint32_t scanStarts = 0, scanPolls = 0, scanDeletes = 0;
+    String lastSsid, lastPassword;
+
+    wl_status_t begin(const char* ssid, const char* password = nullptr) {
+      beginCalls++;
+      lastSsid = ssid ? ssid : "";
+      lastPassword = password ? password : "";
+      hostStatus = WL_DISCONNECTED;
+      return hostStatus;
+    }
+    wl_status_t status() {
+      statusCalls++;
+      return hostStatus;
+    }
+    bool disconnect(bool wifioff = false) {
+      (void)wifioff;
+      disconnectCalls++;
+      hostStatus = WL_DISCONNECTED;
+      return true;
+    }
+
+    int8_t scanNetworks(bool async = false, bool showHidden = false) {
+      (void)showHidden;
+      scanStarts++;
+      if (hostScanStartFails) return WIFI_SCAN_FAILED;
+      if (!async) return (int8_t)hostNetworks.size();
+      hostScanResult = WIFI_SCAN_RUNNING;
+      return WIFI_SCAN_RUNNING;
+    }
+    int8_t scanComplete() {
+      scanPolls++;
+      return (int8_t)hostScanResult;
+    }
+    void scanDelete() { scanDeletes++; }
+    // Скан закончился: scanComplete() вернет число найденных сетей
+    void hostFinishScan() { hostScanResult = (int)hostNetworks.size(); }
+
+    String SSID() const { return lastSsid; }
+    String SSID(uint8_t i) const { return i < hostNetworks.size() ? hostNetworks[i].ssid : String(); }
+    int32_t RSSI() const { return -55; }
+    int32_t RSSI(uint8_t i) const { return i < hostNetworks.size() ? hostNetworks[i].rssi : 0; }
+    uint8_t encryptionType(uint8_t i) const { return i < hostNetworks.size() ? hostNetworks[i].encryption : 0; }
+
+    IPAddress localIP() const { return hostStatus == WL_CONNECTED ? hostLocalIP : IPAddress(); }
+    IPAddress softAPIP() const { return apIP; }
+
+    bool mode(WiFiMode_t newMode) {
+      currentMode = newMode;
+      return true;
+    }
+    WiFiMode_t getMode() const { return currentMode; }
+    bool softAPConfig(IPAddress local, IPAddress gateway, IPAddress subnet) {
+      (void)gateway;
+      (void)subnet;
+      apIP = local;
+      return true;
+    }
+    bool softAP(const char* ssid, const char* password = nullptr) {
+      (void)ssid;
+      (void)password;
+      return true;
+    }
+
+  private:
+    WiFiMode_t currentMode = WIFI_OFF;
+    IPAddress apIP = IPAddress(192, 168, 4, 1);
+};
+
+inline ESP8266WiFiClass WiFi;
+
+// SDK: список станций, подключенных к точке доступа (здесь всегда пуст)
+struct station_info {
+  struct {
+    struct station_info* stqe_next;
+  } next;
+  uint8_t bssid[6];
+  uint32_t ip;
+};
+
+#define STAILQ_NEXT(elm, field) ((elm)->field.stqe_next)
+
+inline struct station_info* wifi_softap_get_station_info() { return nullptr; }
+inline void wifi_softap_free_station_info() {}
+
+#endif
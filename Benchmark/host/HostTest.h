@@ -0,0 +1,34 @@
+/*
+  Проверки для тестов на ПК (Benchmark/tests): без фреймворка, как
+  --check в ws_dispatch_bench. Провал печатается с местом в файле и не
+  останавливает тест; hostTestResult() дает код выхода для ctest.
+*/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+inline int hostFailures = 0;
+inline int hostChecks = 0;
+
+inline bool hostCheck(bool ok, const char* what, const char* file, int line) {
+  hostChecks++;
+  if (!ok) {
+    printf("FAIL %s:%d: %s\n", file, line, what);
+    hostFailures++;
+  }
+  return ok;
+}
+
+#define CHECK(cond) hostCheck((cond), #cond, __FILE__, __LINE__)
+#define CHECK_NEAR(a, b, tolerance) \
+  hostCheck(fabs((double)(a) - (double)(b)) <= (tolerance), #a " ~ " #b, __FILE__, __LINE__)
+
+inline int hostTestResult(const char* name) {
+  printf("%s: %d checks, %d failed\n", name, hostChecks, hostFailures);
+  return hostFailures ? 1 : 0;
+}
+
+#endif
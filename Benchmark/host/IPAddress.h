@@ -0,0 +1,10 @@
+/*
+  Замена IPAddress.h для ПК: класс IPAddress объявлен в host/Arduino.h
+*/
+
+#ifndef HOST_IP_ADDRESS_H
+#define HOST_IP_ADDRESS_H
+
+#include <Arduino.h>
+
+#endif
@@ -0,0 +1,332 @@
+/*
+  Трассы IMU для прогонов на ПК: синтетические сценарии с истинной
+  ориентацией и записи с трекеров (CSV из Benchmark/imu_log.py).
+  Их проигрывают имитации датчиков на шине (MockMPU6050.h,
+  MockQMC5883L.h); fusion_replay и тесты берут трассы отсюда.
+*/
+
+#ifndef HOST_IMU_TRACE_H
+#define HOST_IMU_TRACE_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// С этого момента все калибровки при старте уже закончены
+static const double TRACE_SETTLE_S = 5.0;
+
+// Отсчет трассы в физических единицах (после квантования АЦП)
+struct ImuSample {
+  uint32_t tUs;        // от начала трассы
+  float accel[3];      // g
+  float gyro[3];       // °/с
+  float temp;          // °C
+  int16_t mag[3];      // LSB QMC5883L
+};
+
+struct Pose {
+  float pitch, roll, yaw;   // °, вокруг X, Y, Z
+};
+
+struct Step {
+  int axis;                 // 0 - pitch, 1 - roll, 2 - yaw
+  double startS, endS, holdEndS;
+  float from, to;
+};
+
+struct Trace {
+  std::string name;
+  uint32_t periodUs = 2000;
+  bool hasTruth = false;
+  bool hasMag = false;
+  std::vector<ImuSample> samples;
+  std::vector<Pose> truth;
+  std::vector<Step> steps;
+
+  // Номер последнего отсчета не позже tUs (датчик держит значение до следующего)
+  size_t indexAt(uint64_t tUs) const {
+    auto later = std::upper_bound(samples.begin(), samples.end(), tUs,
+                                  [](uint64_t t, const ImuSample &s) { return t < s.tUs; });
+    return later == samples.begin() ? 0 : (size_t)(later - samples.begin()) - 1;
+  }
+  const ImuSample &at(uint64_t tUs) const { return samples[indexAt(tUs)]; }
+  uint64_t endUs() const { return samples.empty() ? 0 : (uint64_t)samples.back().tUs + periodUs; }
+};
+
+inline float wrap180(float angle) {
+  while (angle > 180.0f) angle -= 360.0f;
+  while (angle < -180.0f) angle += 360.0f;
+  return angle;
+}
+
+inline double smoothstep(double x) {
+  if (x <= 0) return 0;
+  if (x >= 1) return 1;
+  return x * x * (3 - 2 * x);
+}
+
+// Поворот R = Rz(yaw) * Ry(roll) * Rx(pitch); vBody = R^T * vWorld
+inline void worldToBody(const double euler[3], const double v[3], double out[3]) {
+  double cp = cos(euler[0]), sp = sin(euler[0]);
+  double cr = cos(euler[1]), sr = sin(euler[1]);
+  double cy = cos(euler[2]), sy = sin(euler[2]);
+  double R[3][3] = {
+    {cy * cr, cy * sr * sp - sy * cp, cy * sr * cp + sy * sp},
+    {sy * cr, sy * sr * sp + cy * cp, sy * sr * cp - cy * sp},
+    {-sr, cr * sp, cr * cp}
+  };
+  for (int i = 0; i < 3; i++) {
+    out[i] = R[0][i] * v[0] + R[1][i] * v[1] + R[2][i] * v[2];
+  }
+}
+
+// Движение сценария: углы Эйлера (°) и линейное ускорение в мире (g)
+struct Scenario {
+  std::string name;
+  double seconds;
+  std::vector<Step> steps;
+  double headScale = 0;
+  bool walking = false;
+  bool warming = false;       // Линейный прогрев: 1 °C в минуту
+  double warmupC = 0;         // Экспоненциальный прогрев: +warmupC °C
+  double warmupTauS = 0;      // с постоянной времени warmupTauS, с
+
+  void euler(double t, double out[3]) const {
+    out[0] = out[1] = out[2] = 0;
+    if (headScale > 0 && t > TRACE_SETTLE_S - 1.0) {
+      double s = t - (TRACE_SETTLE_S - 1.0);
+      double envelope = smoothstep(s / 2.0);
+      out[0] = headScale * envelope * (22 * sin(2 * PI * 0.17 * s + 0.5) + 8 * sin(2 * PI * 0.61 * s));
+      out[1] = headScale * envelope * (12 * sin(2 * PI * 0.23 * s + 2.0) + 3 * sin(2 * PI * 0.9 * s));
+      out[2] = headScale * envelope * (50 * sin(2 * PI * 0.11 * s) + 20 * sin(2 * PI * 0.37 * s + 1.0));
+    }
+    for (const Step &step : steps) {
+      if (t < step.startS) continue;
+      double x = smoothstep((t - step.startS) / (step.endS - step.startS));
+      out[step.axis] += (step.to - step.from) * x;
+    }
+  }
+
+  void linearAccel(double t, double out[3]) const {
+    out[0] = out[1] = out[2] = 0;
+    if (!walking || t < TRACE_SETTLE_S) return;
+    out[0] = 0.08 * sin(2 * PI * 0.9 * t);
+    out[1] = 0.05 * sin(2 * PI * 0.9 * t + PI / 2);
+    out[2] = 0.25 * sin(2 * PI * 1.8 * t);
+  }
+};
+
+inline std::vector<Scenario> scenarios() {
+  std::vector<Scenario> list;
+
+  Scenario still;
+  still.name = "still";
+  still.seconds = 120;
+  still.warming = true;
+  list.push_back(still);
+
+  Scenario head;
+  head.name = "head";
+  head.seconds = 90;
+  head.headScale = 1.0;
+  list.push_back(head);
+
+  Scenario walk;
+  walk.name = "walk";
+  walk.seconds = 60;
+  walk.headScale = 0.5;
+  walk.walking = true;
+  list.push_back(walk);
+
+  Scenario steps;
+  steps.name = "steps";
+  const struct { int axis; float amplitude; } plan[] = {{0, 30}, {0, -30}, {1, 20}, {2, 45}, {2, -45}};
+  double t = 6.0;
+  for (const auto &p : plan) {
+    steps.steps.push_back({p.axis, t, t + 0.3, t + 4.0, 0, p.amplitude});
+    t += 4.0;
+    steps.steps.push_back({p.axis, t, t + 0.3, t + 4.0, p.amplitude, 0});
+    t += 4.0;
+  }
+  steps.seconds = t + 1.0;
+  list.push_back(steps);
+  return list;
+}
+
+// Модель MPU6050 (±4g, ±250°/с) и QMC5883L, отсчеты каждые periodUs
+inline Trace synthesize(const Scenario &scenario, uint32_t periodUs, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> gauss(0.0, 1.0);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+  const double accelLsb = 8192, gyroLsb = 131;
+  const double accelNoise = 0.003, gyroNoise = 0.05, magNoise = 4;   // g, °/с, LSB
+  double gyroBias[3], accelBias[3];
+  for (int i = 0; i < 3; i++) {
+    gyroBias[i] = 1.5 * uniform(rng);
+    accelBias[i] = 0.01 * uniform(rng);
+  }
+  // Прогрев: смещение гироскопа идет за температурой кристалла
+  const double biasSlope[3] = {0.05, -0.04, 0.08};   // °/с на °C
+  const double tempRamp = scenario.warming ? 1.0 : 0.1;   // °C в минуту
+
+  // Поле Земли: на север и вниз, наклонение 60°; калибровка как в ESP8266_GY-271
+  const double inclination = 60 * DEG_TO_RAD;
+  const double field[3] = {cos(inclination), 0, -sin(inclination)};
+  const double magCenter[3] = {(-1286 + 1532) / 2.0, (-1395 + 1156) / 2.0, (-1298 + 1427) / 2.0};
+  const double magHalf[3] = {(1532 + 1286) / 2.0, (1156 + 1395) / 2.0, (1427 + 1298) / 2.0};
+
+  Trace trace;
+  trace.name = scenario.name;
+  trace.periodUs = periodUs;
+  trace.hasTruth = true;
+  trace.hasMag = true;
+  trace.steps = scenario.steps;
+
+  auto clampRaw = [](double v) { return std::max(-32768.0, std::min(32767.0, std::round(v))); };
+  const double h = 1e-4;
+  for (uint64_t tUs = 0; tUs < scenario.seconds * 1e6; tUs += periodUs) {
+    double t = tUs / 1e6;
+    double e[3], e1[3], e0[3];
+    scenario.euler(t, e);
+    scenario.euler(t + h, e1);
+    scenario.euler(t - h, e0);
+    double er[3], rate[3];
+    for (int i = 0; i < 3; i++) {
+      er[i] = e[i] * DEG_TO_RAD;
+      rate[i] = (e1[i] - e0[i]) / (2 * h);   // °/с
+    }
+    // Скорости Эйлера -> угловая скорость в осях датчика (ZYX)
+    double sp = sin(er[0]), cp = cos(er[0]), sr = sin(er[1]), cr = cos(er[1]);
+    double body[3] = {
+      rate[0] - rate[2] * sr,
+      rate[1] * cp + rate[2] * cr * sp,
+      -rate[1] * sp + rate[2] * cr * cp
+    };
+
+    double lin[3];
+    scenario.linearAccel(t, lin);
+    double specific[3] = {lin[0], lin[1], lin[2] + 1.0};   // Акселерометр видит -g
+    double accel[3], mag[3];
+    worldToBody(er, specific, accel);
+    worldToBody(er, field, mag);
+
+    ImuSample s;
+    s.tUs = (uint32_t)tUs;
+    double temp = scenario.warmupTauS > 0 ? 30.0 + scenario.warmupC * (1 - exp(-t / scenario.warmupTauS))
+                                          : 30.0 + tempRamp * t / 60.0;
+    for (int i = 0; i < 3; i++) {
+      double g = body[i] + gyroBias[i] + biasSlope[i] * (temp - 30.0) + gyroNoise * gauss(rng);
+      double a = accel[i] + accelBias[i] + accelNoise * gauss(rng);
+      s.gyro[i] = clampRaw(g * gyroLsb) / gyroLsb;
+      s.accel[i] = clampRaw(a * accelLsb) / accelLsb;
+      s.mag[i] = (int16_t)clampRaw(magCenter[i] + magHalf[i] * mag[i] + magNoise * gauss(rng));
+    }
+    s.temp = clampRaw((temp - 36.53) * 340) / 340 + 36.53;
+    trace.samples.push_back(s);
+    trace.truth.push_back({(float)e[0], (float)e[1], (float)wrap180(e[2])});
+  }
+  return trace;
+}
+
+// CSV imu_log.py: "# imu_log period_us=... accel_lsb_per_g=... gyro_lsb_per_dps10=...",
+// затем заголовок t_us,ax,ay,az,temp,gx,gy,gz[,mx,my,mz][,pitch,roll,yaw]
+inline bool loadCsv(const std::string &path, Trace &trace, std::string &error) {
+  std::ifstream file;
+  std::istream *in = &std::cin;
+  if (path != "-") {
+    file.open(path);
+    if (!file) {
+      error = "cannot open " + path;
+      return false;
+    }
+    in = &file;
+  }
+  trace.name = path == "-" ? "stdin" : path.substr(path.find_last_of('/') + 1);
+  double accelLsb = 8192, gyroLsb = 131;
+  std::map<std::string, int> column;
+  std::string line;
+  while (std::getline(*in, line)) {
+    if (line.empty()) continue;
+    if (line[0] == '#') {
+      std::istringstream words(line.substr(1));
+      std::string word;
+      while (words >> word) {
+        size_t eq = word.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = word.substr(0, eq);
+        double value = atof(word.c_str() + eq + 1);
+        if (key == "period_us") trace.periodUs = (uint32_t)value;
+        if (key == "accel_lsb_per_g") accelLsb = value;
+        if (key == "gyro_lsb_per_dps10") gyroLsb = value / 10.0;
+      }
+      continue;
+    }
+    std::vector<std::string> cells;
+    std::istringstream row(line);
+    std::string cell;
+    while (std::getline(row, cell, ',')) cells.push_back(cell);
+    if (column.empty()) {
+      for (size_t i = 0; i < cells.size(); i++) column[cells[i]] = (int)i;
+      for (const char *name : {"t_us", "ax", "ay", "az", "temp", "gx", "gy", "gz"}) {
+        if (!column.count(name)) {
+          error = std::string("missing column ") + name;
+          return false;
+        }
+      }
+      trace.hasMag = column.count("mx") && column.count("my") && column.count("mz");
+      trace.hasTruth = column.count("pitch") && column.count("roll") && column.count("yaw");
+      continue;
+    }
+    auto get = [&](const char *name) { return atof(cells[column[name]].c_str()); };
+    ImuSample s;
+    s.tUs = (uint32_t)get("t_us");
+    s.accel[0] = get("ax") / accelLsb;
+    s.accel[1] = get("ay") / accelLsb;
+    s.accel[2] = get("az") / accelLsb;
+    s.gyro[0] = get("gx") / gyroLsb;
+    s.gyro[1] = get("gy") / gyroLsb;
+    s.gyro[2] = get("gz") / gyroLsb;
+    s.temp = get("temp") / 340.0f + 36.53f;
+    s.mag[0] = s.mag[1] = s.mag[2] = 0;
+    if (trace.hasMag) {
+      s.mag[0] = (int16_t)get("mx");
+      s.mag[1] = (int16_t)get("my");
+      s.mag[2] = (int16_t)get("mz");
+    }
+    trace.samples.push_back(s);
+    if (trace.hasTruth) trace.truth.push_back({(float)get("pitch"), (float)get("roll"), (float)get("yaw")});
+  }
+  if (trace.samples.empty()) {
+    error = "no samples in " + path;
+    return false;
+  }
+  return true;
+}
+
+inline void writeCsv(const std::string &path, const Trace &trace) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (!f) return;
+  fprintf(f, "# imu_log period_us=%u accel_lsb_per_g=8192 gyro_lsb_per_dps10=1310 gyro_offset=0,0,0\n",
+          trace.periodUs);
+  fprintf(f, "t_us,ax,ay,az,temp,gx,gy,gz,mx,my,mz,pitch,roll,yaw\n");
+  for (size_t i = 0; i < trace.samples.size(); i++) {
+    const ImuSample &s = trace.samples[i];
+    const Pose &p = trace.truth[i];
+    fprintf(f, "%u,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%d,%d,%d,%.3f,%.3f,%.3f\n", s.tUs,
+            lroundf(s.accel[0] * 8192), lroundf(s.accel[1] * 8192), lroundf(s.accel[2] * 8192),
+            lroundf((s.temp - 36.53f) * 340), lroundf(s.gyro[0] * 131), lroundf(s.gyro[1] * 131),
+            lroundf(s.gyro[2] * 131), s.mag[0], s.mag[1], s.mag[2], p.pitch, p.roll, p.yaw);
+  }
+  fclose(f);
+}
+
+
+#endif
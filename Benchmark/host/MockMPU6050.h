@@ -0,0 +1,247 @@
+/*
+  Имитация MPU6050 на шине I2C (Wire.h): регистровый файл, который
+  проигрывает трассу (ImuTrace.h) по часам ПК.
+
+  - Регистры данных 0x3B..0x48 отдают отсчет трассы на текущий момент
+    micros(), квантованный по диапазонам из ACCEL_CONFIG/GYRO_CONFIG.
+  - Датчик "измеряет" с частотой 1 кГц / (1 + SMPLRT_DIV) (8 кГц при
+    выключенном DLPF); на каждом измерении ставится DATA_RDY, и если
+    FIFO включен (USER_CTRL.FIFO_EN), в него пишутся байты датчиков из
+    FIFO_EN в порядке регистров. FIFO - 1024 байта; при переполнении
+    старые байты теряются и ставится FIFO_OFLOW, как у микросхемы.
+  - Чтение INT_STATUS сбрасывает флаги; FIFO_R_W при пакетном чтении
+    отдает очередные байты FIFO, остальные регистры - с автоинкрементом.
+  - WHO_AM_I = 0x68, PWR_MGMT_1.DEVICE_RESET возвращает регистры к
+    значениям после включения.
+
+  Usage:
+    Trace trace = synthesize(...);
+    MockMPU6050 mpu(trace);
+    Wire.attach(0x68, &mpu);
+*/
+
+#ifndef HOST_MOCK_MPU6050_H
+#define HOST_MOCK_MPU6050_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "ImuTrace.h"
+
+#define MOCK_MPU6050_FIFO_SIZE 1024
+
+struct MockMPU6050Stats {
+  uint32_t measurements;    // измерений датчика
+  uint32_t transactions;    // обращений по шине: запись или чтение
+  uint32_t dataReads;       // чтений, начатых с ACCEL_XOUT_H
+  uint32_t fifoBytesRead;
+  uint32_t fifoOverflows;
+  uint32_t fifoBytesLost;
+};
+
+class MockMPU6050 : public I2CDevice {
+  public:
+    explicit MockMPU6050(const Trace &trace) : trace(&trace) { powerOn(); }
+
+    void setTrace(const Trace &newTrace) {
+      trace = &newTrace;
+      powerOn();
+    }
+
+    void i2cWrite(const uint8_t* data, size_t length) override {
+      stat.transactions++;
+      if (length == 0) return;
+      catchUp();
+      pointer = data[0];
+      for (size_t i = 1; i < length; i++) writeRegister(pointer++, data[i]);
+    }
+
+    bool i2cRead(uint8_t* data, size_t length) override {
+      stat.transactions++;
+      catchUp();
+      if (pointer == 0x3B) stat.dataReads++;
+      if (pointer >= 0x3B && pointer <= 0x48) latchSample();
+      for (size_t i = 0; i < length; i++) {
+        if (pointer == REG_FIFO_R_W) {
+          data[i] = popFifo();
+        } else {
+          data[i] = readRegister(pointer++);
+        }
+      }
+      return true;
+    }
+
+    size_t fifoCount() {
+      catchUp();
+      return fifoUsed;
+    }
+    const MockMPU6050Stats &stats() const { return stat; }
+    uint8_t reg(uint8_t address) const { return regs[address & 0x7F]; }
+
+    // Отсчет трассы в регистрах (без часов) - для проверок в тестах
+    static void encode(const ImuSample &s, uint8_t accelRange, uint8_t gyroRange, uint8_t out[14]) {
+      const float accelLsb = 16384.0f / (1 << accelRange);
+      const float gyroLsb = 131.0f / (1 << gyroRange);
+      int16_t values[7] = {quantize(s.accel[0] * accelLsb), quantize(s.accel[1] * accelLsb),
+                           quantize(s.accel[2] * accelLsb), quantize((s.temp - 36.53f) * 340.0f),
+                           quantize(s.gyro[0] * gyroLsb), quantize(s.gyro[1] * gyroLsb),
+                           quantize(s.gyro[2] * gyroLsb)};
+      for (int i = 0; i < 7; i++) {
+        out[2 * i] = (uint8_t)((uint16_t)values[i] >> 8);
+        out[2 * i + 1] = (uint8_t)values[i];
+      }
+    }
+
+  private:
+    static const uint8_t REG_SMPLRT_DIV = 0x19;
+    static const uint8_t REG_CONFIG = 0x1A;
+    static const uint8_t REG_GYRO_CONFIG = 0x1B;
+    static const uint8_t REG_ACCEL_CONFIG = 0x1C;
+    static const uint8_t REG_FIFO_EN = 0x23;
+    static const uint8_t REG_INT_STATUS = 0x3A;
+    static const uint8_t REG_USER_CTRL = 0x6A;
+    static const uint8_t REG_PWR_MGMT_1 = 0x6B;
+    static const uint8_t REG_FIFO_COUNT_H = 0x72;
+    static const uint8_t REG_FIFO_COUNT_L = 0x73;
+    static const uint8_t REG_FIFO_R_W = 0x74;
+    static const uint8_t REG_WHO_AM_I = 0x75;
+
+    const Trace* trace;
+    uint8_t regs[128];
+    uint8_t latched[14];
+    uint8_t pointer = 0;
+    uint8_t fifo[MOCK_MPU6050_FIFO_SIZE];
+    size_t fifoHead = 0;
+    size_t fifoUsed = 0;
+    uint64_t nextMeasurementUs = 0;
+    uint16_t fifoCountLatch = 0;
+    MockMPU6050Stats stat = MockMPU6050Stats();
+
+    void powerOn() {
+      memset(regs, 0, sizeof(regs));
+      regs[REG_PWR_MGMT_1] = 0x40;
+      regs[REG_WHO_AM_I] = 0x68;
+      memset(latched, 0, sizeof(latched));
+      fifoHead = fifoUsed = 0;
+      nextMeasurementUs = hostMicros;
+    }
+
+    static int16_t quantize(float value) {
+      float raw = roundf(value);
+      if (raw > 32767) raw = 32767;
+      if (raw < -32768) raw = -32768;
+      return (int16_t)raw;
+    }
+
+    uint32_t measurementPeriodUs() const {
+      uint8_t dlpf = regs[REG_CONFIG] & 0x07;
+      uint32_t baseHz = (dlpf == 0 || dlpf == 7) ? 8000 : 1000;
+      return 1000000UL * (1 + regs[REG_SMPLRT_DIV]) / baseHz;
+    }
+
+    void sampleAt(uint64_t tUs, uint8_t out[14]) const {
+      encode(trace->at(tUs), (regs[REG_ACCEL_CONFIG] >> 3) & 3, (regs[REG_GYRO_CONFIG] >> 3) & 3, out);
+    }
+
+    // Регистры данных защелкиваются в начале пакетного чтения
+    void latchSample() { sampleAt(hostMicros, latched); }
+
+    // Измерения, которые датчик сделал с прошлого обращения
+    void catchUp() {
+      uint32_t period = measurementPeriodUs();
+      while (nextMeasurementUs <= hostMicros) {
+        measure(nextMeasurementUs);
+        nextMeasurementUs += period;
+      }
+    }
+
+    void measure(uint64_t tUs) {
+      stat.measurements++;
+      regs[REG_INT_STATUS] |= 0x01;   // DATA_RDY
+      if (!(regs[REG_USER_CTRL] & 0x40)) return;
+      uint8_t sample[14];
+      sampleAt(tUs, sample);
+      uint8_t enabled = regs[REG_FIFO_EN];
+      if (enabled & 0x08) pushFifo(sample, 6);          // ACCEL
+      if (enabled & 0x80) pushFifo(sample + 6, 2);      // TEMP
+      if (enabled & 0x40) pushFifo(sample + 8, 2);      // XG
+      if (enabled & 0x20) pushFifo(sample + 10, 2);     // YG
+      if (enabled & 0x10) pushFifo(sample + 12, 2);     // ZG
+    }
+
+    void pushFifo(const uint8_t* data, size_t length) {
+      for (size_t i = 0; i < length; i++) {
+        if (fifoUsed == MOCK_MPU6050_FIFO_SIZE) {
+          // Теряется самый старый байт - кадры сбиваются, как на микросхеме
+          fifoHead = (fifoHead + 1) % MOCK_MPU6050_FIFO_SIZE;
+          fifoUsed--;
+          stat.fifoBytesLost++;
+          if (!(regs[REG_INT_STATUS] & 0x10)) stat.fifoOverflows++;
+          regs[REG_INT_STATUS] |= 0x10;
+        }
+        fifo[(fifoHead + fifoUsed) % MOCK_MPU6050_FIFO_SIZE] = data[i];
+        fifoUsed++;
+      }
+    }
+
+    uint8_t popFifo() {
+      if (fifoUsed == 0) return 0xFF;
+      uint8_t value = fifo[fifoHead];
+      fifoHead = (fifoHead + 1) % MOCK_MPU6050_FIFO_SIZE;
+      fifoUsed--;
+      stat.fifoBytesRead++;
+      return value;
+    }
+
+    uint8_t readRegister(uint8_t address) {
+      address &= 0x7F;
+      if (address >= 0x3B && address <= 0x48) return latched[address - 0x3B];
+      switch (address) {
+        case REG_INT_STATUS: {
+          uint8_t status = regs[REG_INT_STATUS];
+          regs[REG_INT_STATUS] = 0;
+          return status;
+        }
+        case REG_FIFO_COUNT_H:
+          fifoCountLatch = (uint16_t)fifoUsed;
+          return (uint8_t)(fifoCountLatch >> 8);
+        case REG_FIFO_COUNT_L:
+          return (uint8_t)fifoCountLatch;
+        default:
+          return regs[address];
+      }
+    }
+
+    void writeRegister(uint8_t address, uint8_t value) {
+      address &= 0x7F;
+      switch (address) {
+        case REG_WHO_AM_I:
+        case REG_INT_STATUS:
+        case REG_FIFO_COUNT_H:
+        case REG_FIFO_COUNT_L:
+          return;   // только чтение
+        case REG_PWR_MGMT_1:
+          if (value & 0x80) {
+            powerOn();
+            return;
+          }
+          regs[address] = value;
+          return;
+        case REG_USER_CTRL:
+          if (value & 0x04) fifoHead = fifoUsed = 0;   // FIFO_RESET, сбрасывается сам
+          regs[address] = value & ~0x04;
+          return;
+        case REG_FIFO_R_W:
+          pushFifo(&value, 1);
+          return;
+        case REG_SMPLRT_DIV:
+        case REG_CONFIG:
+          regs[address] = value;
+          nextMeasurementUs = hostMicros + measurementPeriodUs();
+          return;
+        default:
+          regs[address] = value;
+      }
+    }
+};
+
+#endif
@@ -0,0 +1,70 @@
+/*
+  Имитация магнитометра QMC5883L (GY-271) на шине I2C (Wire.h):
+  проигрывает столбцы mx,my,mz трассы (ImuTrace.h) по часам ПК.
+
+  Регистры 0x00..0x05 - X, Y, Z младшим байтом вперед, 0x06 - статус
+  (DRDY), 0x09/0x0A - управление (0x0A.SOFT_RST сбрасывает), 0x0D - ID
+  0xFF. Указатель регистра после чтения автоинкрементируется.
+*/
+
+#ifndef HOST_MOCK_QMC5883L_H
+#define HOST_MOCK_QMC5883L_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "ImuTrace.h"
+
+class MockQMC5883L : public I2CDevice {
+  public:
+    explicit MockQMC5883L(const Trace &trace) : trace(&trace) { reset(); }
+
+    void i2cWrite(const uint8_t* data, size_t length) override {
+      if (length == 0) return;
+      pointer = data[0];
+      for (size_t i = 1; i < length; i++) {
+        uint8_t address = pointer++;
+        if (address == 0x0A && (data[i] & 0x80)) {
+          reset();
+          continue;
+        }
+        if (address < sizeof(regs)) regs[address] = data[i];
+      }
+    }
+
+    bool i2cRead(uint8_t* data, size_t length) override {
+      if (pointer <= 0x06) latchSample();
+      for (size_t i = 0; i < length; i++) {
+        uint8_t address = pointer++;
+        data[i] = address < sizeof(regs) ? regs[address] : 0;
+      }
+      reads++;
+      return true;
+    }
+
+    uint32_t readCount() const { return reads; }
+    uint8_t control1() const { return regs[0x09]; }
+
+  private:
+    const Trace* trace;
+    uint8_t regs[0x0E];
+    uint8_t pointer = 0;
+    uint32_t reads = 0;
+
+    void reset() {
+      memset(regs, 0, sizeof(regs));
+      regs[0x0D] = 0xFF;
+    }
+
+    // Непрерывный режим (MODE = 01) - свежие данные; standby - нули
+    void latchSample() {
+      if ((regs[0x09] & 0x03) != 0x01) return;
+      const ImuSample &s = trace->at(hostMicros);
+      for (int axis = 0; axis < 3; axis++) {
+        regs[2 * axis] = (uint8_t)s.mag[axis];
+        regs[2 * axis + 1] = (uint8_t)((uint16_t)s.mag[axis] >> 8);
+      }
+      regs[0x06] = 0x01;   // DRDY
+    }
+};
+
+#endif
@@ -0,0 +1,375 @@
+/*
+  String для ПК с поведением String ядра ESP8266, которое важно для
+  замеров: короткая строка (до HOST_STRING_SSO_SIZE - 1 символов) живет
+  внутри объекта (SSO), длинная - в куче, и буфер растет ровно до нужного
+  размера, без запаса. Память берется через operator new, так что
+  счетчики выделений в тестах (подмена operator new) видят каждую.
+  String(value, decimals) печатает через dtostrf, как на устройстве.
+*/
+
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#define HOST_STRING_SSO_SIZE 11   // SSOSIZE ядра ESP8266 (32 бита): 10 символов + ноль
+
+char* dtostrf(double number, signed char width, unsigned char prec, char* s);
+
+class String {
+  public:
+    String() { init(); }
+    String(const char* text) {
+      init();
+      if (text) copy(text, strlen(text));
+    }
+    String(const char* text, size_t length) {
+      init();
+      if (text) copy(text, length);
+    }
+    String(const String &other) {
+      init();
+      copy(other.c_str(), other.len);
+    }
+    String(String &&other) noexcept {
+      init();
+      move(other);
+    }
+    explicit String(char c) {
+      init();
+      copy(&c, 1);
+    }
+    explicit String(unsigned char value, unsigned char base = 10) { init(); formatUnsigned(value, base); }
+    explicit String(int value, unsigned char base = 10) { init(); formatSigned(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { init(); formatUnsigned(value, base); }
+    explicit String(long value, unsigned char base = 10) { init(); formatSigned(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { init(); formatUnsigned(value, base); }
+    explicit String(long long value, unsigned char base = 10) { init(); formatSigned(value, base); }
+    explicit String(unsigned long long value, unsigned char base = 10) { init(); formatUnsigned(value, base); }
+    explicit String(float value, unsigned char decimals = 2) { init(); formatDouble(value, decimals); }
+    explicit String(double value, unsigned char decimals = 2) { init(); formatDouble(value, decimals); }
+    ~String() { release(); }
+
+    String &operator=(const String &other) {
+      if (this != &other) copy(other.c_str(), other.len);
+      return *this;
+    }
+    String &operator=(String &&other) noexcept {
+      if (this != &other) move(other);
+      return *this;
+    }
+    String &operator=(const char* text) {
+      if (text) copy(text, strlen(text));
+      else invalidate();
+      return *this;
+    }
+
+    bool reserve(size_t size) {
+      if (size + 1 <= cap) return true;
+      return changeBuffer(size);
+    }
+
+    size_t length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    const char* c_str() const { return heap ? heap : sso; }
+    char* begin() { return buffer(); }
+    char* end() { return buffer() + len; }
+    const char* begin() const { return c_str(); }
+    const char* end() const { return c_str() + len; }
+
+    bool concat(const char* text, size_t length) {
+      if (text == nullptr) return false;
+      if (length == 0) return true;
+      size_t newLength = len + length;
+      // text может указывать внутрь этой же строки
+      uintptr_t from = (uintptr_t)c_str();
+      if ((uintptr_t)text >= from && (uintptr_t)text < from + len) {
+        size_t offset = (uintptr_t)text - from;
+        if (!reserve(newLength)) return false;
+        memmove(buffer() + len, buffer() + offset, length);
+      } else {
+        if (!reserve(newLength)) return false;
+        memcpy(buffer() + len, text, length);
+      }
+      len = newLength;
+      buffer()[len] = '\0';
+      return true;
+    }
+    bool concat(const char* text) { return text ? concat(text, strlen(text)) : false; }
+    bool concat(const String &other) { return concat(other.c_str(), other.len); }
+    bool concat(char c) { return concat(&c, 1); }
+    template <class T, class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    bool concat(T value) { return concat(String(value)); }
+
+    String &operator+=(const String &other) { concat(other); return *this; }
+    String &operator+=(const char* text) { concat(text); return *this; }
+    String &operator+=(char c) { concat(c); return *this; }
+    template <class T, class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    String &operator+=(T value) { concat(String(value)); return *this; }
+
+    int compareTo(const String &other) const { return strcmp(c_str(), other.c_str()); }
+    bool equals(const String &other) const { return len == other.len && memcmp(c_str(), other.c_str(), len) == 0; }
+    bool equals(const char* text) const { return text && strlen(text) == len && memcmp(c_str(), text, len) == 0; }
+    bool equalsIgnoreCase(const String &other) const {
+      if (len != other.len) return false;
+      for (size_t i = 0; i < len; i++) {
+        if (tolower((unsigned char)c_str()[i]) != tolower((unsigned char)other.c_str()[i])) return false;
+      }
+      return true;
+    }
+    bool operator==(const String &other) const { return equals(other); }
+    bool operator==(const char* text) const { return equals(text); }
+    bool operator!=(const String &other) const { return !equals(other); }
+    bool operator!=(const char* text) const { return !equals(text); }
+    bool operator<(const String &other) const { return compareTo(other) < 0; }
+
+    bool startsWith(const String &prefix, size_t offset = 0) const {
+      return offset + prefix.len <= len && memcmp(c_str() + offset, prefix.c_str(), prefix.len) == 0;
+    }
+    bool endsWith(const String &suffix) const {
+      return suffix.len <= len && memcmp(c_str() + len - suffix.len, suffix.c_str(), suffix.len) == 0;
+    }
+
+    char charAt(size_t index) const { return index < len ? c_str()[index] : 0; }
+    void setCharAt(size_t index, char c) { if (index < len) buffer()[index] = c; }
+    char operator[](size_t index) const { return charAt(index); }
+    char &operator[](size_t index) {
+      static char dummy;
+      if (index >= len) {
+        dummy = 0;
+        return dummy;
+      }
+      return buffer()[index];
+    }
+
+    void toCharArray(char* out, size_t size, size_t index = 0) const { getBytes((unsigned char*)out, size, index); }
+    void getBytes(unsigned char* out, size_t size, size_t index = 0) const {
+      if (size == 0 || out == nullptr) return;
+      if (index >= len) {
+        out[0] = 0;
+        return;
+      }
+      size_t n = std::min(size - 1, len - index);
+      memcpy(out, c_str() + index, n);
+      out[n] = 0;
+    }
+
+    int indexOf(char c, size_t from = 0) const {
+      if (from >= len) return -1;
+      const char* found = strchr(c_str() + from, c);
+      return found ? (int)(found - c_str()) : -1;
+    }
+    int indexOf(const String &text, size_t from = 0) const {
+      if (from > len) return -1;
+      const char* found = strstr(c_str() + from, text.c_str());
+      return found ? (int)(found - c_str()) : -1;
+    }
+    int lastIndexOf(char c) const {
+      const char* found = strrchr(c_str(), c);
+      return found ? (int)(found - c_str()) : -1;
+    }
+
+    String substring(size_t from) const { return substring(from, len); }
+    String substring(size_t from, size_t to) const {
+      if (from > to) std::swap(from, to);
+      if (from >= len) return String();
+      if (to > len) to = len;
+      return String(c_str() + from, to - from);
+    }
+
+    void remove(size_t index) { remove(index, (size_t)-1); }
+    void remove(size_t index, size_t count) {
+      if (index >= len) return;
+      if (count > len - index) count = len - index;
+      memmove(buffer() + index, buffer() + index + count, len - index - count + 1);
+      len -= count;
+    }
+
+    void replace(const String &find, const String &with) {
+      if (find.len == 0) return;
+      String out;
+      size_t i = 0;
+      while (i < len) {
+        if (i + find.len <= len && memcmp(c_str() + i, find.c_str(), find.len) == 0) {
+          out.concat(with);
+          i += find.len;
+        } else {
+          out.concat(c_str()[i++]);
+        }
+      }
+      *this = std::move(out);
+    }
+
+    void toLowerCase() { for (size_t i = 0; i < len; i++) buffer()[i] = tolower((unsigned char)buffer()[i]); }
+    void toUpperCase() { for (size_t i = 0; i < len; i++) buffer()[i] = toupper((unsigned char)buffer()[i]); }
+    void trim() {
+      size_t start = 0, stop = len;
+      while (start < stop && isspace((unsigned char)c_str()[start])) start++;
+      while (stop > start && isspace((unsigned char)c_str()[stop - 1])) stop--;
+      if (start > 0) memmove(buffer(), buffer() + start, stop - start);
+      len = stop - start;
+      buffer()[len] = '\0';
+    }
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return (float)atof(c_str()); }
+    double toDouble() const { return atof(c_str()); }
+
+  private:
+    char sso[HOST_STRING_SSO_SIZE];
+    char* heap;
+    size_t cap;   // байт вместе с нулем
+    size_t len;
+
+    void init() {
+      sso[0] = '\0';
+      heap = nullptr;
+      cap = HOST_STRING_SSO_SIZE;
+      len = 0;
+    }
+
+    char* buffer() { return heap ? heap : sso; }
+
+    void release() {
+      if (heap) ::operator delete(heap);
+      heap = nullptr;
+    }
+
+    void invalidate() {
+      release();
+      init();
+    }
+
+    // Ровно size символов + ноль, как String::changeBuffer() ядра
+    bool changeBuffer(size_t size) {
+      if (size + 1 <= HOST_STRING_SSO_SIZE) {
+        if (heap) {
+          char* old = heap;
+          heap = nullptr;
+          memcpy(sso, old, std::min(len, size) + 1);
+          ::operator delete(old);
+          cap = HOST_STRING_SSO_SIZE;
+        }
+        return true;
+      }
+      char* grown = (char*)::operator new(size + 1);
+      memcpy(grown, c_str(), len + 1);
+      release();
+      heap = grown;
+      cap = size + 1;
+      return true;
+    }
+
+    void copy(const char* text, size_t length) {
+      if (length + 1 > cap) {
+        // Старые данные не нужны: без переноса, как String::copy()
+        release();
+        init();
+        changeBuffer(length);
+      }
+      memmove(buffer(), text, length);
+      len = length;
+      buffer()[len] = '\0';
+    }
+
+    void move(String &other) {
+      release();
+      if (other.heap) {
+        heap = other.heap;
+        cap = other.cap;
+        len = other.len;
+        other.heap = nullptr;
+        other.init();
+      } else {
+        init();
+        memcpy(sso, other.sso, other.len + 1);
+        len = other.len;
+        other.init();
+      }
+    }
+
+    void formatUnsigned(unsigned long long value, unsigned char base) {
+      char buf[66];
+      char* p = buf + sizeof(buf) - 1;
+      *p = '\0';
+      if (base < 2) base = 10;
+      do {
+        int digit = value % base;
+        *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+        value /= base;
+      } while (value);
+      copy(p, strlen(p));
+    }
+
+    void formatSigned(long long value, unsigned char base) {
+      if (value < 0 && base == 10) {
+        formatUnsigned(0ULL - (unsigned long long)value, base);
+        String minus("-");
+        minus.concat(*this);
+        *this = std::move(minus);
+      } else {
+        formatUnsigned((unsigned long long)value, base);
+      }
+    }
+
+    void formatDouble(double value, unsigned char decimals) {
+      char buf[33 + 16];
+      dtostrf(value, decimals + 2, decimals, buf);
+      copy(buf, strlen(buf));
+    }
+};
+
+inline String operator+(const String &a, const String &b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+inline String operator+(const String &a, const char* b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+inline String operator+(const char* a, const String &b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+inline String operator+(const String &a, char b) {
+  String out(a);
+  out.concat(b);
+  return out;
+}
+template <class T, class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+inline String operator+(const String &a, T b) {
+  String out(a);
+  out.concat(String(b));
+  return out;
+}
+inline String operator+(String &&a, const String &b) {
+  a.concat(b);
+  return std::move(a);
+}
+inline String operator+(String &&a, const char* b) {
+  a.concat(b);
+  return std::move(a);
+}
+inline String operator+(String &&a, char b) {
+  a.concat(b);
+  return std::move(a);
+}
+template <class T, class = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+inline String operator+(String &&a, T b) {
+  a.concat(String(b));
+  return std::move(a);
+}
+
+inline bool operator==(const char* a, const String &b) { return b.equals(a); }
+
+#endif
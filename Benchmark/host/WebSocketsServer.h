@@ -0,0 +1,280 @@
+/*
+  Замена WebSocketsServer.h (arduinoWebSockets 2.4.x) для ПК
+
+  Повторяет то, на что опирается Wifi_ESP8266.h: иерархию WebSockets ->
+  WebSocketsServerCore -> WebSocketsServer, защищенные _clients,
+  clientIsConnected() и write(), WSclient_t со status, WEBSOCKETS_VERSION_INT.
+  Наследник, который лезет во что-то другое, на ПК не соберется так же,
+  как на устройстве.
+
+  Сети нет: клиента подключает и пишет ему тест (hostConnect(),
+  hostText(), hostFragment()), событие уходит в onEvent() так же, как из
+  loop() библиотеки. Отправка идет через sendFrame() с той же логикой
+  памяти, что в WebSockets.cpp при WEBSOCKETS_USE_BIG_MEM (ESP8266/ESP32):
+  короткий кадр без headerToPayload копируется в malloc(длина +
+  WEBSOCKETS_MAX_HEADER_SIZE) - выделения видны счетчикам теста. Байты,
+  которые ушли бы в TCP, считаются по клиентам.
+*/
+
+#ifndef HOST_WEB_SOCKETS_SERVER_H
+#define HOST_WEB_SOCKETS_SERVER_H
+
+#include <Arduino.h>
+#include <functional>
+
+#define WEBSOCKETS_VERSION "2.4.1"
+#define WEBSOCKETS_VERSION_MAJOR 2
+#define WEBSOCKETS_VERSION_MINOR 4
+#define WEBSOCKETS_VERSION_PATCH 1
+#define WEBSOCKETS_VERSION_INT 2004001
+
+#define WEBSOCKETS_SERVER_CLIENT_MAX 5
+#define WEBSOCKETS_MAX_HEADER_SIZE 14
+#define WEBSOCKETS_MAX_DATA_SIZE (15 * 1024)
+#define WEBSOCKETS_USE_BIG_MEM
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+typedef enum {
+  WSop_continuation = 0x00,
+  WSop_text = 0x01,
+  WSop_binary = 0x02,
+  WSop_close = 0x08,
+  WSop_ping = 0x09,
+  WSop_pong = 0x0A
+} WSopcode_t;
+
+typedef enum {
+  WSC_NOT_CONNECTED,
+  WSC_HEADER,
+  WSC_BODY,
+  WSC_CONNECTED
+} WSclientsStatus_t;
+
+typedef struct {
+  uint8_t num;
+  WSclientsStatus_t status;
+  bool tcpConnected;     // вместо WEBSOCKETS_NETWORK_CLASS * tcp
+  IPAddress remoteIP;
+  String cUrl;
+  // Что ушло бы в сокет
+  uint32_t writes;
+  uint32_t bytesWritten;
+} WSclient_t;
+
+class WebSockets {
+  public:
+    virtual ~WebSockets() {}
+
+  protected:
+    virtual void clientDisconnect(WSclient_t* client) = 0;
+
+    bool sendFrame(WSclient_t* client, WSopcode_t opcode, uint8_t* payload = nullptr, size_t length = 0,
+                   bool fin = true, bool headerToPayload = false) {
+      if (client->status != WSC_CONNECTED) return false;
+
+      uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE];
+      uint8_t headerSize = length < 126 ? 2 : (length < 0xFFFF ? 4 : 10);
+      uint8_t* payloadPtr = payload;
+      bool useInternBuffer = false;
+
+#ifdef WEBSOCKETS_USE_BIG_MEM
+      // Как в WebSockets.cpp: заголовок и данные - одним TCP-пакетом через копию
+      if (!headerToPayload && length > 0 && length < 1400 && ESP.getFreeHeap() > 6000) {
+        uint8_t* dataPtr = (uint8_t*)malloc(length + WEBSOCKETS_MAX_HEADER_SIZE);
+        if (dataPtr) {
+          memcpy(dataPtr + WEBSOCKETS_MAX_HEADER_SIZE, payload, length);
+          headerToPayload = true;
+          useInternBuffer = true;
+          payloadPtr = dataPtr;
+        }
+      }
+#endif
+
+      uint8_t* headerPtr = headerToPayload ? payloadPtr + (WEBSOCKETS_MAX_HEADER_SIZE - headerSize) : buffer;
+      headerPtr[0] = (fin ? 0x80 : 0x00) | opcode;
+      if (length < 126) {
+        headerPtr[1] = (uint8_t)length;
+      } else if (length < 0xFFFF) {
+        headerPtr[1] = 126;
+        headerPtr[2] = (uint8_t)(length >> 8);
+        headerPtr[3] = (uint8_t)length;
+      } else {
+        headerPtr[1] = 127;
+        for (int i = 0; i < 8; i++) headerPtr[2 + i] = (uint8_t)((uint64_t)length >> (56 - 8 * i));
+      }
+
+      bool ret = true;
+      if (headerToPayload) {
+        if (write(client, headerPtr, length + headerSize) != length + headerSize) ret = false;
+      } else {
+        if (write(client, buffer, headerSize) != headerSize) ret = false;
+        if (length > 0 && write(client, payloadPtr, length) != length) ret = false;
+      }
+      if (useInternBuffer) free(payloadPtr);
+      return ret;
+    }
+
+    size_t write(WSclient_t* client, uint8_t* out, size_t n) {
+      (void)out;
+      if (client == nullptr || !client->tcpConnected) return 0;
+      client->writes++;
+      client->bytesWritten += n;
+      return n;
+    }
+    size_t write(WSclient_t* client, const char* out) { return write(client, (uint8_t*)out, strlen(out)); }
+};
+
+class WebSocketsServerCore : protected WebSockets {
+  public:
+    typedef std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)> WebSocketServerEvent;
+
+    WebSocketsServerCore() {
+      for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        _clients[i] = WSclient_t();
+        _clients[i].num = i;
+        _clients[i].status = WSC_NOT_CONNECTED;
+      }
+    }
+
+    void onEvent(WebSocketServerEvent cbEvent) { _cbEvent = cbEvent; }
+
+    bool sendTXT(uint8_t num, uint8_t* payload, size_t length = 0, bool headerToPayload = false) {
+      if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return false;
+      if (length == 0) length = strlen((const char*)payload);
+      WSclient_t* client = &_clients[num];
+      if (!clientIsConnected(client)) return false;
+      return sendFrame(client, WSop_text, payload, length, true, headerToPayload);
+    }
+    bool sendTXT(uint8_t num, const uint8_t* payload, size_t length = 0) {
+      return sendTXT(num, (uint8_t*)payload, length);
+    }
+    bool sendTXT(uint8_t num, char* payload, size_t length = 0, bool headerToPayload = false) {
+      return sendTXT(num, (uint8_t*)payload, length, headerToPayload);
+    }
+    bool sendTXT(uint8_t num, const char* payload, size_t length = 0) {
+      return sendTXT(num, (uint8_t*)payload, length);
+    }
+    bool sendTXT(uint8_t num, String &payload) {
+      return sendTXT(num, (uint8_t*)payload.c_str(), payload.length());
+    }
+
+    bool broadcastTXT(uint8_t* payload, size_t length = 0, bool headerToPayload = false) {
+      bool ret = true;
+      if (length == 0) length = strlen((const char*)payload);
+      for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        WSclient_t* client = &_clients[i];
+        if (clientIsConnected(client)) {
+          if (!sendFrame(client, WSop_text, payload, length, true, headerToPayload)) ret = false;
+        }
+      }
+      return ret;
+    }
+    bool broadcastTXT(const uint8_t* payload, size_t length = 0) { return broadcastTXT((uint8_t*)payload, length); }
+    bool broadcastTXT(char* payload, size_t length = 0, bool headerToPayload = false) {
+      return broadcastTXT((uint8_t*)payload, length, headerToPayload);
+    }
+    bool broadcastTXT(const char* payload, size_t length = 0) { return broadcastTXT((uint8_t*)payload, length); }
+    bool broadcastTXT(String &payload) { return broadcastTXT((uint8_t*)payload.c_str(), payload.length()); }
+
+    void disconnect(uint8_t num) {
+      if (num < WEBSOCKETS_SERVER_CLIENT_MAX && clientIsConnected(&_clients[num])) clientDisconnect(&_clients[num]);
+    }
+
+    int connectedClients(bool ping = false) {
+      (void)ping;
+      int count = 0;
+      for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        if (_clients[i].status == WSC_CONNECTED) count++;
+      }
+      return count;
+    }
+
+    IPAddress remoteIP(uint8_t num) {
+      return num < WEBSOCKETS_SERVER_CLIENT_MAX ? _clients[num].remoteIP : IPAddress();
+    }
+
+    // --- Для тестов ---------------------------------------------------------
+
+    // Рукопожатие по url прошло: WStype_CONNECTED с путем, как у библиотеки
+    bool hostConnect(uint8_t num, const char* url) {
+      if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return false;
+      WSclient_t* client = &_clients[num];
+      client->tcpConnected = true;
+      client->status = WSC_CONNECTED;
+      client->remoteIP = IPAddress(192, 168, 4, 2 + num);
+      client->cUrl = url;
+      client->writes = client->bytesWritten = 0;
+      runCbEvent(num, WStype_CONNECTED, (uint8_t*)client->cUrl.c_str(), client->cUrl.length());
+      return true;
+    }
+    void hostDisconnect(uint8_t num) { disconnect(num); }
+    // Целое текстовое сообщение; библиотека завершает payload нулем
+    void hostText(uint8_t num, const char* text, size_t length) {
+      hostMessage(num, WStype_TEXT, text, length);
+    }
+    // Кусок фрагментированного сообщения (WStype_FRAGMENT_*)
+    void hostFragment(uint8_t num, WStype_t type, const char* data, size_t length) {
+      hostMessage(num, type, data, length);
+    }
+    const WSclient_t &hostClient(uint8_t num) const { return _clients[num]; }
+
+  protected:
+    WSclient_t _clients[WEBSOCKETS_SERVER_CLIENT_MAX];
+    WebSocketServerEvent _cbEvent;
+
+    bool clientIsConnected(WSclient_t* client) { return client->tcpConnected && client->status != WSC_NOT_CONNECTED; }
+
+    void clientDisconnect(WSclient_t* client) override {
+      client->tcpConnected = false;
+      client->status = WSC_NOT_CONNECTED;
+      runCbEvent(client->num, WStype_DISCONNECTED, nullptr, 0);
+    }
+
+    virtual void runCbEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+      if (_cbEvent) _cbEvent(num, type, payload, length);
+    }
+
+  private:
+    char rxBuffer[WEBSOCKETS_MAX_DATA_SIZE + 1];
+
+    void hostMessage(uint8_t num, WStype_t type, const char* data, size_t length) {
+      if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || _clients[num].status != WSC_CONNECTED) return;
+      if (length > WEBSOCKETS_MAX_DATA_SIZE) length = WEBSOCKETS_MAX_DATA_SIZE;
+      memcpy(rxBuffer, data, length);
+      rxBuffer[length] = '\0';
+      runCbEvent(num, type, (uint8_t*)rxBuffer, length);
+    }
+};
+
+class WebSocketsServer : public WebSocketsServerCore {
+  public:
+    WebSocketsServer(uint16_t port, const String &origin = "", const String &protocol = "arduino")
+      : _port(port) {
+      (void)origin;
+      (void)protocol;
+    }
+
+    void begin() { started = true; }
+    void close() { started = false; }
+    void loop() {}
+
+    bool started = false;
+
+  protected:
+    uint16_t _port;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+  Замена WiFiUdp.h для ПК: сети нет. Отправленные пакеты считаются и
+  отдаются в hostOnSend (если задан), входящие кладет тест через
+  hostReceive() и читает код через parsePacket()/read().
+
+  Сбои для тестов: hostBeginFails - beginPacket() возвращает 0,
+  hostWriteLimit - сколько байт пакета примет write(), hostEndFails -
+  endPacket() возвращает 0 (пакет не уходит). beginPacket() поверх
+  незакрытого пакета считается в hostAbandoned.
+*/
+
+#ifndef HOST_WIFI_UDP_H
+#define HOST_WIFI_UDP_H
+
+#include <Arduino.h>
+#include <deque>
+#include <functional>
+#include <vector>
+
+struct HostUdpPacket {
+  IPAddress ip;       // получатель для отправленных, отправитель для входящих
+  uint16_t port;
+  std::vector<uint8_t> data;
+};
+
+class WiFiUDP : public Print {
+  public:
+    uint8_t begin(uint16_t port) {
+      localPort = port;
+      return 1;
+    }
+    void stop() {}
+
+    int beginPacket(IPAddress ip, uint16_t port) {
+      if (packetOpen) hostAbandoned++;
+      packetOpen = !hostBeginFails;
+      if (hostBeginFails) return 0;
+      outgoing.ip = ip;
+      outgoing.port = port;
+      outgoing.data.clear();
+      return 1;
+    }
+    int beginPacket(const char* host, uint16_t port) {
+      (void)host;
+      return beginPacket(IPAddress(), port);
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* data, size_t length) override {
+      if (!packetOpen) return 0;
+      size_t room = hostWriteLimit > outgoing.data.size() ? hostWriteLimit - outgoing.data.size() : 0;
+      if (length > room) length = room;
+      outgoing.data.insert(outgoing.data.end(), data, data + length);
+      return length;
+    }
+    int endPacket() {
+      if (!packetOpen) return 0;
+      packetOpen = false;
+      if (hostEndFails) return 0;
+      packetsSent++;
+      bytesSent += outgoing.data.size();
+      if (hostOnSend) hostOnSend(outgoing);
+      return 1;
+    }
+
+    int parsePacket() {
+      if (hostInbox.empty()) return 0;
+      incoming = hostInbox.front();
+      hostInbox.pop_front();
+      readPosition = 0;
+      return (int)incoming.data.size();
+    }
+    int available() { return (int)(incoming.data.size() - readPosition); }
+    int read() { return available() > 0 ? incoming.data[readPosition++] : -1; }
+    int read(uint8_t* buffer, size_t length) {
+      size_t count = (size_t)available();
+      if (count > length) count = length;
+      memcpy(buffer, incoming.data.data() + readPosition, count);
+      readPosition += count;
+      return (int)count;
+    }
+    int read(char* buffer, size_t length) { return read((uint8_t*)buffer, length); }
+    IPAddress remoteIP() const { return incoming.ip; }
+    uint16_t remotePort() const { return incoming.port; }
+
+    // Входящий пакет для следующего parsePacket()
+    void hostReceive(IPAddress ip, uint16_t port, const uint8_t* data, size_t length) {
+      hostInbox.push_back({ip, port, std::vector<uint8_t>(data, data + length)});
+    }
+
+    uint16_t localPort = 0;
+    uint32_t packetsSent = 0;
+    uint32_t bytesSent = 0;
+
+    std::function<void(const HostUdpPacket &)> hostOnSend;
+    std::deque<HostUdpPacket> hostInbox;
+    bool hostBeginFails = false;
+    bool hostEndFails = false;
+    size_t hostWriteLimit = (size_t)-1;
+    uint32_t hostAbandoned = 0;
+
+  private:
+    bool packetOpen = false;
+    HostUdpPacket outgoing;
+    HostUdpPacket incoming;
+    size_t readPosition = 0;
+};
+
+#endif
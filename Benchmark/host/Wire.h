@@ -0,0 +1,117 @@
+/*
+  Шина I2C для ПК: TwoWire с интерфейсом Arduino, за которым вместо
+  проводов - зарегистрированные имитации устройств (MockMPU6050.h,
+  MockQMC5883L.h). Транзакция записи (beginTransmission..endTransmission)
+  целиком уходит устройству, requestFrom() забирает у него байты чтения.
+  Счетчики транзакций и байт позволяют тестам проверять, сколько раз
+  код ходит на шину за проход.
+*/
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class I2CDevice {
+  public:
+    virtual ~I2CDevice() {}
+    // Байты одной транзакции записи; первый обычно - номер регистра
+    virtual void i2cWrite(const uint8_t* data, size_t length) = 0;
+    // Чтение с текущего регистра; false - устройство не ответило
+    virtual bool i2cRead(uint8_t* data, size_t length) = 0;
+};
+
+struct WireStats {
+  uint32_t writes;        // endTransmission()
+  uint32_t reads;         // requestFrom()
+  uint32_t bytesWritten;
+  uint32_t bytesRead;
+  uint32_t nacks;         // на адресе никого нет
+  uint32_t transactions() const { return writes + reads; }
+};
+
+class TwoWire {
+  public:
+    static const size_t BUFFER_SIZE = 128;   // I2C_BUFFER_LENGTH ядра ESP32
+
+    void begin() {}
+    void begin(int, int) {}
+    void setClock(uint32_t hz) { clockHz = hz; }
+
+    void attach(uint8_t address, I2CDevice* device) { devices[address & 0x7F] = device; }
+    void detach(uint8_t address) { devices[address & 0x7F] = nullptr; }
+
+    void beginTransmission(uint8_t address) {
+      txAddress = address & 0x7F;
+      txLength = 0;
+    }
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+
+    size_t write(uint8_t value) {
+      if (txLength >= BUFFER_SIZE) return 0;
+      txBuffer[txLength++] = value;
+      return 1;
+    }
+    size_t write(const uint8_t* data, size_t length) {
+      size_t n = 0;
+      while (n < length && write(data[n])) n++;
+      return n;
+    }
+
+    // 0 - успех, 2 - NACK на адрес (как в Arduino)
+    uint8_t endTransmission(bool sendStop = true) {
+      (void)sendStop;
+      stat.writes++;
+      I2CDevice* device = devices[txAddress];
+      if (device == nullptr) {
+        stat.nacks++;
+        return 2;
+      }
+      device->i2cWrite(txBuffer, txLength);
+      stat.bytesWritten += txLength;
+      return 0;
+    }
+    uint8_t endTransmission(uint8_t sendStop) { return endTransmission(sendStop != 0); }
+
+    uint8_t requestFrom(uint8_t address, size_t length, bool sendStop = true) {
+      (void)sendStop;
+      stat.reads++;
+      rxLength = rxIndex = 0;
+      I2CDevice* device = devices[address & 0x7F];
+      if (length > BUFFER_SIZE) length = BUFFER_SIZE;
+      if (device == nullptr || !device->i2cRead(rxBuffer, length)) {
+        stat.nacks++;
+        return 0;
+      }
+      rxLength = length;
+      stat.bytesRead += length;
+      return (uint8_t)length;
+    }
+    uint8_t requestFrom(uint8_t address, uint8_t length) { return requestFrom(address, (size_t)length, true); }
+    uint8_t requestFrom(uint8_t address, uint8_t length, uint8_t sendStop) {
+      return requestFrom(address, (size_t)length, sendStop != 0);
+    }
+    uint8_t requestFrom(int address, int length) { return requestFrom((uint8_t)address, (size_t)length, true); }
+
+    int available() const { return (int)(rxLength - rxIndex); }
+    int read() { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+
+    const WireStats &stats() const { return stat; }
+    void resetStats() { stat = WireStats(); }
+    uint32_t clock() const { return clockHz; }
+
+  private:
+    I2CDevice* devices[128] = {nullptr};
+    uint8_t txAddress = 0;
+    uint8_t txBuffer[BUFFER_SIZE];
+    size_t txLength = 0;
+    uint8_t rxBuffer[BUFFER_SIZE];
+    size_t rxLength = 0;
+    size_t rxIndex = 0;
+    uint32_t clockHz = 100000;
+    WireStats stat = WireStats();
+};
+
+inline TwoWire Wire;
+
+#endif
@@ -0,0 +1,453 @@
+"""
+Лог сырых отсчетов MPU6050 с трекера (ImuLog.h): управление записью,
+выгрузка, декодирование и воспроизведение.
+
+Трекер V7 (Wifi_Head_MPU6050_ESP8266_V7) пишет каждый отсчет (14 байт
+регистров 0x3B..0x48 + micros()) в /imu.log на LittleFS:
+  POST /api/recorder/start[?maxKB=N]   новый лог (старый удаляется)
+  POST /api/recorder/stop
+  GET  /api/recorder/status            JSON со счетчиками
+  GET  /api/recorder/log?offset=&length=  кусок файла (до 16 КБ), размер в X-Log-Size
+
+Формат (подробно в ImuLog.h): блок заголовка и блоки данных по 1024 байта,
+у каждого блока данных CRC-32; отсчеты - zigzag varint разностей к
+предыдущему отсчету блока. Поврежденный блок пропускается, остальные
+декодируются.
+
+CSV для хостовой сборки (decode --csv, replay):
+  # imu_log period_us=2000 accel_lsb_per_g=8192 gyro_lsb_per_dps10=1310 gyro_offset=-12,40,7
+  t_us,ax,ay,az,temp,gx,gy,gz
+t_us - время от первого отсчета (переполнение micros() развернуто),
+остальное - сырые значения регистров.
+
+Режимы:
+  start/stop/status HOST  - управление записью на трекере
+  fetch HOST              - выгрузка лога кусками в файл
+  decode LOG              - сводка (частота, пропуски, битые блоки, сжатие), --csv
+  replay LOG              - CSV в stdout в темпе записи (--speed, 0 - без пауз)
+  synth                   - синтетический лог тем же кодировщиком (порт ImuLog.h),
+                            с --check декодирует обратно и сверяет
+
+Примеры:
+  python3 imu_log.py start 192.168.1.50 --max-kb 1024
+  python3 imu_log.py fetch 192.168.1.50 --out head.imulog
+  python3 imu_log.py decode head.imulog --csv head.csv
+  python3 imu_log.py replay head.imulog --speed 0 | ./fusion_replay --csv -
+  python3 imu_log.py synth --out synth.imulog --seconds 60 --check
+"""
+
+import argparse
+import json
+import math
+import random
+import struct
+import sys
+import time
+import urllib.parse
+import urllib.request
+import zlib
+
+IMU_LOG_MAGIC = 0x4C554D49          # "IMUL"
+IMU_LOG_BLOCK_MAGIC = 0x42554D49    # "IMUB"
+IMU_LOG_VERSION = 1
+IMU_LOG_BLOCK_SIZE = 1024
+IMU_LOG_BLOCK_HEADER = 20
+IMU_LOG_MAX_SAMPLE_BYTES = 26
+MPU6050_SAMPLE_BYTES = 14
+CHANNELS = ("ax", "ay", "az", "temp", "gx", "gy", "gz")
+
+
+def put_varint(out, value):
+    v = ((value << 1) ^ (value >> 31)) & 0xFFFFFFFF   # zigzag int32
+    while v >= 0x80:
+        out.append((v & 0x7F) | 0x80)
+        v >>= 7
+    out.append(v)
+
+
+def get_varint(data, pos, end):
+    """(значение, новая позиция) или None, если varint выходит за end"""
+    v = 0
+    for n in range(5):
+        if pos + n >= end:
+            return None
+        b = data[pos + n]
+        v |= (b & 0x7F) << (7 * n)
+        if not b & 0x80:
+            return (v >> 1) ^ -(v & 1), pos + n + 1
+    return None
+
+
+def to_int16(value):
+    value &= 0xFFFF
+    return value - 0x10000 if value & 0x8000 else value
+
+
+def to_int32(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+class LogHeader:
+    def __init__(self, period_us=2000, accel_lsb_per_g=8192, gyro_lsb_per_dps10=1310, gyro_offset=(0, 0, 0)):
+        self.period_us = period_us
+        self.accel_lsb_per_g = accel_lsb_per_g
+        self.gyro_lsb_per_dps10 = gyro_lsb_per_dps10
+        self.gyro_offset = tuple(gyro_offset)
+
+    def pack(self):
+        head = struct.pack("<IBBHIHH3hH", IMU_LOG_MAGIC, IMU_LOG_VERSION, MPU6050_SAMPLE_BYTES,
+                           IMU_LOG_BLOCK_SIZE, self.period_us, self.accel_lsb_per_g,
+                           self.gyro_lsb_per_dps10, *self.gyro_offset, 0)
+        head += struct.pack("<I", zlib.crc32(head))
+        return head + b"\xff" * (IMU_LOG_BLOCK_SIZE - len(head))
+
+    @staticmethod
+    def unpack(block):
+        fields = struct.unpack_from("<IBBHIHH3hHI", block)
+        magic, version, _, block_size, period, accel, gyro, ox, oy, oz, _, crc = fields
+        if magic != IMU_LOG_MAGIC or version != IMU_LOG_VERSION or block_size != IMU_LOG_BLOCK_SIZE:
+            raise ValueError("не лог ImuLog (магия/версия/размер блока)")
+        if crc != zlib.crc32(block[:24]):
+            raise ValueError("CRC заголовка не совпадает")
+        return LogHeader(period, accel, gyro, (ox, oy, oz))
+
+    def csv_comment(self):
+        return "# imu_log period_us=%d accel_lsb_per_g=%d gyro_lsb_per_dps10=%d gyro_offset=%d,%d,%d" % (
+            self.period_us, self.accel_lsb_per_g, self.gyro_lsb_per_dps10, *self.gyro_offset)
+
+
+class LogWriter:
+    """Порт ImuRecorder без файловой системы: блоки копятся в bytearray"""
+
+    def __init__(self, header):
+        self.header = header
+        self.data = bytearray(header.pack())
+        self.block_index = 0
+        self.payload = None
+        self.count = 0
+
+    def _open(self, time_us):
+        self.payload = bytearray()
+        self.count = 0
+        self.first_time = time_us & 0xFFFFFFFF
+        self.previous = [0] * 7
+
+    def _close(self):
+        head = struct.pack("<IIIHH", IMU_LOG_BLOCK_MAGIC, self.block_index, self.first_time,
+                           self.count, len(self.payload))
+        crc = zlib.crc32(bytes(self.payload), zlib.crc32(head))
+        block = head + struct.pack("<I", crc) + self.payload
+        self.data += block + b"\xff" * (IMU_LOG_BLOCK_SIZE - len(block))
+        self.block_index += 1
+        self.payload = None
+
+    def append(self, time_us, values):
+        if self.payload is not None and \
+                IMU_LOG_BLOCK_HEADER + len(self.payload) + IMU_LOG_MAX_SAMPLE_BYTES > IMU_LOG_BLOCK_SIZE:
+            self._close()
+        if self.payload is None:
+            self._open(time_us)
+        else:
+            dt = to_int32((time_us - self.last_time) & 0xFFFFFFFF)
+            put_varint(self.payload, dt - self.header.period_us)
+        for k, value in enumerate(values):
+            put_varint(self.payload, value - self.previous[k])
+            self.previous[k] = value
+        self.last_time = time_us & 0xFFFFFFFF
+        self.count += 1
+
+    def finish(self):
+        if self.payload is not None and self.count:
+            self._close()
+        return bytes(self.data)
+
+
+def decode_block(block, period_us):
+    """(номер блока, [(time_us uint32, [7 значений])]) или None, если блок поврежден"""
+    magic, index, first_time, count, length = struct.unpack_from("<IIIHH", block)
+    if magic != IMU_LOG_BLOCK_MAGIC or length > IMU_LOG_BLOCK_SIZE - IMU_LOG_BLOCK_HEADER:
+        return None
+    crc = struct.unpack_from("<I", block, 16)[0]
+    payload_end = IMU_LOG_BLOCK_HEADER + length
+    if crc != zlib.crc32(block[IMU_LOG_BLOCK_HEADER:payload_end], zlib.crc32(block[:16])):
+        return None
+    samples = []
+    pos = IMU_LOG_BLOCK_HEADER
+    t = first_time
+    previous = [0] * 7
+    for i in range(count):
+        if i > 0:
+            r = get_varint(block, pos, payload_end)
+            if r is None:
+                return None
+            value, pos = r
+            t = (t + period_us + value) & 0xFFFFFFFF
+        for k in range(7):
+            r = get_varint(block, pos, payload_end)
+            if r is None:
+                return None
+            value, pos = r
+            previous[k] = to_int16(previous[k] + value)
+        samples.append((t, list(previous)))
+    return index, samples
+
+
+def decode_log(data):
+    """(заголовок, отсчеты [(t_us от начала, [7])], статистика)"""
+    if len(data) < IMU_LOG_BLOCK_SIZE:
+        raise ValueError("файл короче блока заголовка")
+    header = LogHeader.unpack(data[:IMU_LOG_BLOCK_SIZE])
+    samples = []
+    bad_blocks = []
+    blocks = 0
+    last_index = -1
+    base = None
+    last_raw = None
+    unwrapped = 0
+    for offset in range(IMU_LOG_BLOCK_SIZE, len(data) - IMU_LOG_BLOCK_SIZE + 1, IMU_LOG_BLOCK_SIZE):
+        blocks += 1
+        decoded = decode_block(data[offset:offset + IMU_LOG_BLOCK_SIZE], header.period_us)
+        if decoded is None or decoded[0] <= last_index:   # битый или повтор
+            bad_blocks.append(offset // IMU_LOG_BLOCK_SIZE - 1)
+            continue
+        last_index = decoded[0]
+        for t, values in decoded[1]:
+            if last_raw is None:
+                base = t
+            else:
+                unwrapped += (t - last_raw) & 0xFFFFFFFF
+            last_raw = t
+            samples.append((unwrapped, values))
+    stats = {
+        "blocks": blocks,
+        "bad_blocks": bad_blocks,
+        "samples": len(samples),
+        "file_bytes": len(data),
+        "first_device_us": base,
+        "tail_bytes": len(data) % IMU_LOG_BLOCK_SIZE,
+    }
+    return header, samples, stats
+
+
+def summarize(header, samples, stats):
+    period = header.period_us
+    gaps = 0
+    longest = 0
+    for (t0, _), (t1, _) in zip(samples, samples[1:]):
+        dt = t1 - t0
+        if dt > 2 * period:
+            gaps += 1
+        longest = max(longest, dt)
+    duration_s = samples[-1][0] / 1e6 if samples else 0.0
+    payload = stats["file_bytes"] - IMU_LOG_BLOCK_SIZE
+    summary = dict(stats)
+    summary.update({
+        "period_us": period,
+        "duration_s": round(duration_s, 3),
+        "rate_hz": round((len(samples) - 1) / duration_s, 1) if duration_s > 0 else None,
+        "gaps": gaps,
+        "longest_gap_us": longest,
+        "bytes_per_sample": round(payload / len(samples), 2) if samples else None,
+        "raw_bytes_per_sample": MPU6050_SAMPLE_BYTES + 4,
+        "gyro_offset": header.gyro_offset,
+    })
+    return summary
+
+
+def write_csv(out, header, samples):
+    out.write(header.csv_comment() + "\n")
+    out.write("t_us," + ",".join(CHANNELS) + "\n")
+    for t, values in samples:
+        out.write("%d,%s\n" % (t, ",".join(str(v) for v in values)))
+
+
+def read_log(path):
+    with open(path, "rb") as f:
+        return decode_log(f.read())
+
+
+# --- Трекер -----------------------------------------------------------------
+
+def api(host, path, method="GET", params=None, timeout=5):
+    url = "http://%s%s" % (host, path)
+    if params:
+        url += "?" + urllib.parse.urlencode(params)
+    request = urllib.request.Request(url, method=method)
+    with urllib.request.urlopen(request, timeout=timeout) as response:
+        return response.read(), response.headers
+
+
+def cmd_control(args):
+    if args.mode == "start":
+        params = {"maxKB": args.max_kb} if args.max_kb else None
+        body, _ = api(args.host, "/api/recorder/start", "POST", params)
+    elif args.mode == "stop":
+        body, _ = api(args.host, "/api/recorder/stop", "POST")
+    else:
+        body, _ = api(args.host, "/api/recorder/status")
+    print(body.decode("utf-8", "replace"))
+
+
+def cmd_fetch(args):
+    data = bytearray()
+    size = None
+    started = time.monotonic()
+    while size is None or len(data) < size:
+        chunk, headers = api(args.host, "/api/recorder/log", params={"offset": len(data), "length": args.chunk},
+                             timeout=10)
+        size = int(headers.get("X-Log-Size", "0"))
+        if not chunk:
+            break
+        data += chunk
+        sys.stderr.write("\r%d / %d bytes" % (len(data), size))
+    elapsed = time.monotonic() - started
+    sys.stderr.write("\n%.1f KB/s\n" % (len(data) / 1024 / elapsed if elapsed > 0 else 0))
+    with open(args.out, "wb") as f:
+        f.write(data)
+    header, samples, stats = decode_log(bytes(data))
+    print(json.dumps(summarize(header, samples, stats), ensure_ascii=False))
+
+
+# --- Хост -------------------------------------------------------------------
+
+def cmd_decode(args):
+    header, samples, stats = read_log(args.log)
+    print(json.dumps(summarize(header, samples, stats), indent=2, ensure_ascii=False))
+    if args.csv:
+        with open(args.csv, "w") as f:
+            write_csv(f, header, samples)
+
+
+def cmd_replay(args):
+    header, samples, _ = read_log(args.log)
+    out = sys.stdout
+    out.write(header.csv_comment() + "\n")
+    out.write("t_us," + ",".join(CHANNELS) + "\n")
+    started = time.monotonic()
+    for t, values in samples:
+        if args.speed > 0:
+            wait = t / 1e6 / args.speed - (time.monotonic() - started)
+            if wait > 0:
+                out.flush()
+                time.sleep(wait)
+        out.write("%d,%s\n" % (t, ",".join(str(v) for v in values)))
+    out.flush()
+
+
+def synth_trace(seconds, period_us, seed, stall_every_s=2.0, stall_us=30000):
+    """Отсчеты как у V7: покой, затем повороты; шум, смещение гироскопа,
+    остановки записи во flash (пропуски по времени)"""
+    rng = random.Random(seed)
+    accel_lsb, gyro_lsb = 8192, 131.0
+    bias = [rng.randint(-60, 60) for _ in range(3)]
+    t = rng.randint(0, 0xFFFFFFFF)             # micros() переполнится в любой момент
+    elapsed = 0
+    next_stall = stall_every_s * 1e6
+    angle = [0.0, 0.0]
+    samples = []
+    while elapsed < seconds * 1e6:
+        s = elapsed / 1e6
+        moving = s > 5.0
+        rate = [40.0 * math.sin(2 * math.pi * 0.5 * s) if moving else 0.0,
+                25.0 * math.sin(2 * math.pi * 0.3 * s) if moving else 0.0,
+                30.0 * math.sin(2 * math.pi * 0.2 * s) if moving else 0.0]
+        angle[0] += rate[0] * period_us / 1e6
+        angle[1] += rate[1] * period_us / 1e6
+        p, r = math.radians(angle[0]), math.radians(angle[1])
+        ax = -math.sin(r)
+        ay = math.sin(p) * math.cos(r)
+        az = math.cos(p) * math.cos(r)
+        values = [
+            int(ax * accel_lsb + rng.gauss(0, 12)),
+            int(ay * accel_lsb + rng.gauss(0, 12)),
+            int(az * accel_lsb + rng.gauss(0, 12)),
+            int((30.0 - 36.53) * 340 + rng.gauss(0, 3)),
+            int(rate[0] * gyro_lsb + bias[0] + rng.gauss(0, 6)),
+            int(rate[1] * gyro_lsb + bias[1] + rng.gauss(0, 6)),
+            int(rate[2] * gyro_lsb + bias[2] + rng.gauss(0, 6)),
+        ]
+        values = [max(-32768, min(32767, v)) for v in values]
+        samples.append((t & 0xFFFFFFFF, values))
+        step = period_us + rng.randint(-20, 60)   # дрожание опроса loop()
+        if elapsed >= next_stall:
+            step += stall_us
+            next_stall += stall_every_s * 1e6
+        t += step
+        elapsed += step
+    return samples, bias
+
+
+def cmd_synth(args):
+    samples, bias = synth_trace(args.seconds, args.period_us, args.seed)
+    header = LogHeader(args.period_us, 8192, 1310, bias)
+    writer = LogWriter(header)
+    for t, values in samples:
+        writer.append(t, values)
+    data = writer.finish()
+    if args.corrupt:
+        # Порча одного байта в каждом N-м блоке данных
+        data = bytearray(data)
+        for offset in range(IMU_LOG_BLOCK_SIZE * 2, len(data), IMU_LOG_BLOCK_SIZE * args.corrupt):
+            data[offset + 40] ^= 0x5A
+        data = bytes(data)
+    with open(args.out, "wb") as f:
+        f.write(data)
+
+    decoded_header, decoded, stats = decode_log(data)
+    summary = summarize(decoded_header, decoded, stats)
+    print(json.dumps(summary, indent=2, ensure_ascii=False))
+    if args.check:
+        ok = decoded_header.gyro_offset == tuple(bias)
+        if not args.corrupt:
+            base = samples[0][0]
+            expected = [((t - base) & 0xFFFFFFFF, v) for t, v in samples]
+            ok = ok and [(t, v) for t, v in decoded] == expected
+        else:
+            ok = ok and len(stats["bad_blocks"]) > 0 and len(decoded) < len(samples)
+        print("check: %s" % ("OK" if ok else "FAIL"))
+        if not ok:
+            sys.exit(1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Лог сырых отсчетов MPU6050 (ImuLog.h)")
+    sub = parser.add_subparsers(dest="mode", required=True)
+
+    for mode, text in (("start", "начать запись"), ("stop", "остановить запись"), ("status", "счетчики записи")):
+        p = sub.add_parser(mode, help=text)
+        p.add_argument("host")
+        if mode == "start":
+            p.add_argument("--max-kb", type=int, help="ограничение размера лога")
+        p.set_defaults(func=cmd_control)
+
+    p = sub.add_parser("fetch", help="выгрузить лог с трекера")
+    p.add_argument("host")
+    p.add_argument("--out", default="imu.imulog")
+    p.add_argument("--chunk", type=int, default=16384)
+    p.set_defaults(func=cmd_fetch)
+
+    p = sub.add_parser("decode", help="сводка и CSV")
+    p.add_argument("log")
+    p.add_argument("--csv")
+    p.set_defaults(func=cmd_decode)
+
+    p = sub.add_parser("replay", help="CSV в stdout в темпе записи")
+    p.add_argument("log")
+    p.add_argument("--speed", type=float, default=1.0, help="множитель темпа, 0 - без пауз")
+    p.set_defaults(func=cmd_replay)
+
+    p = sub.add_parser("synth", help="синтетический лог")
+    p.add_argument("--out", default="synth.imulog")
+    p.add_argument("--seconds", type=float, default=30.0)
+    p.add_argument("--period-us", type=int, default=2000)
+    p.add_argument("--seed", type=int, default=1)
+    p.add_argument("--corrupt", type=int, default=0, help="испортить каждый N-й блок")
+    p.add_argument("--check", action="store_true", help="декодировать и сверить, код возврата 1 при расхождении")
+    p.set_defaults(func=cmd_synth)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,460 @@
+"""
+Замер задержки "отсчет датчика -> декодирование на клиенте" и пропускной
+способности для всех транспортов трекера.
+
+Прошивки помечают каждый кадр номером и временем отсчета (micros()):
+  текст (V7, Bluetooth_v5, MPU6050_Bluetooth)   ...,SEQ:<n>,TS:<us>
+  JSON  (Wifi_Head_MPU6050, MPU6050_Serial,
+         MPU6050_Serial_Only)                   ..."seq":<n>,"sampleUs":<us>}
+  бинарный кадр OrientationFrame (FORMAT:BIN)   seq uint16 @4, timestamp uint32 @6
+
+Источники:
+  serial  - USB serial или pty (/dev/ttyUSB0, /dev/pts/N), построчно
+  ws      - WebSocket клиент (ws://192.168.4.1:81/), --binary включает FORMAT:BIN
+  ble     - записанный захват BLE notify: строки "<время приема, с>\\t<payload>",
+            payload - текст или "hex:<байты>"
+  emulate - frame_emitter (Benchmark/frame_emitter): кадры собирают кодировщики
+            прошивок (TelemetryFormat.h, OrientationFrame.h) и шлют через pty
+            или WebSocket на 127.0.0.1 (--transport serial|ws); часы общие
+
+Часы устройства и хоста не синхронизированы, поэтому для реального
+устройства задержка считается относительно минимальной в прогоне
+(смещение часов = min(прием - отсчет)); в отчете это clock = "relative".
+Для эмулятора часы общие и задержка абсолютная (clock = "shared").
+
+Примеры:
+  python3 latency_benchmark.py serial /dev/ttyUSB0 --duration 30
+  python3 latency_benchmark.py ws ws://192.168.4.1:81/ --binary --report ws_bin.json
+  python3 latency_benchmark.py ble capture.tsv
+  python3 latency_benchmark.py emulate --transport ws --format bin --rate 500
+
+Отчет (JSON) печатается в stdout или пишется в файл --report.
+"""
+
+import argparse
+import base64
+import json
+import os
+import re
+import select
+import socket
+import struct
+import subprocess
+import sys
+import time
+
+ORIENTATION_FRAME_MAGIC = 0xA5
+ORIENTATION_FRAME_SIZE = 28
+
+TEXT_STAMP = re.compile(r"SEQ:(\d+),TS:(\d+)")
+JSON_STAMP = re.compile(r'"seq":(\d+),"sampleUs":(\d+)')
+
+
+def now_us():
+    """Монотонное время хоста в микросекундах"""
+    return time.monotonic_ns() // 1000
+
+
+# ---------------------------------------------------------------------------
+# Разбор кадров
+# ---------------------------------------------------------------------------
+
+def parse_frame(payload):
+    """Возвращает (формат, seq, timestamp_us, бит seq) или None"""
+    if isinstance(payload, (bytes, bytearray)):
+        if len(payload) >= ORIENTATION_FRAME_SIZE and payload[0] == ORIENTATION_FRAME_MAGIC:
+            seq, timestamp = struct.unpack_from("<HI", payload, 4)
+            return "bin", seq, timestamp, 16
+        try:
+            payload = payload.decode("utf-8")
+        except UnicodeDecodeError:
+            return None
+
+    match = JSON_STAMP.search(payload)
+    if match:
+        # Разбираем JSON целиком - это часть стоимости декодирования на клиенте
+        try:
+            json.loads(payload)
+        except ValueError:
+            return None
+        return "json", int(match.group(1)), int(match.group(2)), 32
+
+    match = TEXT_STAMP.search(payload)
+    if match:
+        # Разбор полей KEY:VALUE, как это делают веб-клиенты
+        dict(item.split(":", 1) for item in payload.split(",") if ":" in item)
+        return "text", int(match.group(1)), int(match.group(2)), 32
+    return None
+
+
+class Unwrapper:
+    """Разворачивает счетчик фиксированной разрядности в монотонный"""
+
+    def __init__(self, bits):
+        self.modulo = 1 << bits
+        self.last = None
+        self.base = 0
+
+    def __call__(self, value):
+        if self.last is not None and value < self.last and self.last - value > self.modulo // 2:
+            self.base += self.modulo
+        self.last = value
+        return self.base + value
+
+
+# ---------------------------------------------------------------------------
+# Статистика
+# ---------------------------------------------------------------------------
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return None
+    k = (len(sorted_values) - 1) * p / 100.0
+    lo = int(k)
+    hi = min(lo + 1, len(sorted_values) - 1)
+    return sorted_values[lo] + (sorted_values[hi] - sorted_values[lo]) * (k - lo)
+
+
+class LatencyStats:
+    def __init__(self, shared_clock):
+        self.shared_clock = shared_clock
+        self.offsets = []       # прием - отсчет, мкс
+        self.bytes = 0
+        self.frames = 0
+        self.ignored = 0
+        self.lost = 0
+        self.reordered = 0
+        self.formats = {}
+        self.first_us = None
+        self.last_us = None
+        self.seq_unwrap = None
+        self.ts_unwrap = Unwrapper(32)
+        self.last_seq = None
+
+    def add(self, payload, recv_us):
+        frame = parse_frame(payload)
+        decoded_us = now_us() if recv_us is None else recv_us
+        self.bytes += len(payload)
+        if frame is None:
+            self.ignored += 1
+            return
+        fmt, seq, timestamp, seq_bits = frame
+
+        if self.seq_unwrap is None:
+            self.seq_unwrap = Unwrapper(seq_bits)
+        seq = self.seq_unwrap(seq)
+        if self.last_seq is not None:
+            if seq > self.last_seq + 1:
+                self.lost += seq - self.last_seq - 1
+            elif seq <= self.last_seq:
+                self.reordered += 1
+        self.last_seq = seq if self.last_seq is None else max(seq, self.last_seq)
+
+        if self.first_us is None:
+            self.first_us = decoded_us
+        self.last_us = decoded_us
+        self.frames += 1
+        self.formats[fmt] = self.formats.get(fmt, 0) + 1
+        if self.shared_clock:
+            # Метка отсчета - младшие 32 бита тех же часов
+            self.offsets.append((decoded_us - timestamp) & 0xFFFFFFFF)
+        else:
+            self.offsets.append(decoded_us - self.ts_unwrap(timestamp))
+
+    def report(self, source):
+        if self.shared_clock:
+            latencies = sorted(self.offsets)
+        else:
+            base = min(self.offsets) if self.offsets else 0
+            latencies = sorted(value - base for value in self.offsets)
+
+        elapsed = (self.last_us - self.first_us) / 1e6 if self.frames > 1 else 0.0
+
+        def ms(value):
+            return None if value is None else round(value / 1000.0, 3)
+
+        return {
+            "source": source,
+            "clock": "shared" if self.shared_clock else "relative",
+            "formats": self.formats,
+            "frames": self.frames,
+            "ignored": self.ignored,
+            "lost": self.lost,
+            "reordered": self.reordered,
+            "duration_s": round(elapsed, 3),
+            "throughput": {
+                "frames_per_s": round((self.frames - 1) / elapsed, 2) if elapsed > 0 else None,
+                "bytes_per_s": round(self.bytes / elapsed, 1) if elapsed > 0 else None,
+            },
+            "latency_ms": {
+                "min": ms(latencies[0] if latencies else None),
+                "p50": ms(percentile(latencies, 50)),
+                "p90": ms(percentile(latencies, 90)),
+                "p99": ms(percentile(latencies, 99)),
+                "max": ms(latencies[-1] if latencies else None),
+            },
+        }
+
+
+# ---------------------------------------------------------------------------
+# Serial / pty
+# ---------------------------------------------------------------------------
+
+def open_serial(path, baudrate):
+    """Файловый дескриптор порта в raw режиме (pyserial не обязателен)"""
+    try:
+        import serial
+        conn = serial.Serial(path, baudrate=baudrate, timeout=0)
+        return conn.fileno(), conn
+    except ImportError:
+        import termios
+        import tty
+        fd = os.open(path, os.O_RDONLY | os.O_NOCTTY | os.O_NONBLOCK)
+        if os.isatty(fd):
+            tty.setraw(fd)
+            attrs = termios.tcgetattr(fd)
+            speed = getattr(termios, "B%d" % baudrate, termios.B115200)
+            attrs[4] = attrs[5] = speed
+            termios.tcsetattr(fd, termios.TCSANOW, attrs)
+        return fd, None
+
+
+def run_serial(path, baudrate, duration, stats, opened=None):
+    fd, keep = opened if opened is not None else open_serial(path, baudrate)
+    buffer = b""
+    deadline = time.monotonic() + duration
+    try:
+        while time.monotonic() < deadline:
+            ready, _, _ = select.select([fd], [], [], 0.1)
+            if not ready:
+                continue
+            try:
+                chunk = os.read(fd, 4096)
+            except BlockingIOError:
+                continue
+            except OSError:
+                break           # pty закрыт с другой стороны
+            if not chunk:
+                break
+            buffer += chunk
+            while b"\n" in buffer:
+                line, buffer = buffer.split(b"\n", 1)
+                line = line.rstrip(b"\r")
+                if line:
+                    stats.add(line, None)
+    finally:
+        if keep is not None:
+            keep.close()
+        else:
+            os.close(fd)
+
+
+# ---------------------------------------------------------------------------
+# WebSocket (минимальный клиент RFC 6455 на стандартной библиотеке)
+# ---------------------------------------------------------------------------
+
+def ws_connect(url):
+    match = re.match(r"ws://([^/:]+)(?::(\d+))?(/.*)?$", url)
+    if not match:
+        raise ValueError("Ожидается адрес вида ws://host:port/path")
+    host, port, path = match.group(1), int(match.group(2) or 80), match.group(3) or "/"
+    sock = socket.create_connection((host, port), timeout=5)
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    key = base64.b64encode(os.urandom(16)).decode()
+    request = ("GET %s HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+               "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n") % (path, host, port, key)
+    sock.sendall(request.encode())
+    response = b""
+    while b"\r\n\r\n" not in response:
+        chunk = sock.recv(1024)
+        if not chunk:
+            raise ConnectionError("Сервер закрыл соединение во время рукопожатия")
+        response += chunk
+    header, rest = response.split(b"\r\n\r\n", 1)
+    if b" 101 " not in header.split(b"\r\n", 1)[0]:
+        raise ConnectionError("Нет перехода на WebSocket: %r" % header.split(b"\r\n", 1)[0])
+    return sock, rest
+
+
+def ws_send_text(sock, text):
+    """Кадр клиента обязан быть замаскирован"""
+    data = text.encode()
+    mask = os.urandom(4)
+    masked = bytes(b ^ mask[i % 4] for i, b in enumerate(data))
+    header = bytes([0x81, 0x80 | len(data)]) if len(data) < 126 else \
+        bytes([0x81, 0x80 | 126]) + struct.pack(">H", len(data))
+    sock.sendall(header + mask + masked)
+
+
+class WsReader:
+    def __init__(self, sock, pending):
+        self.sock = sock
+        self.buffer = pending
+
+    def _need(self, count, deadline):
+        while len(self.buffer) < count:
+            timeout = deadline - time.monotonic()
+            if timeout <= 0:
+                return False
+            self.sock.settimeout(timeout)
+            try:
+                chunk = self.sock.recv(65536)
+            except socket.timeout:
+                return False
+            if not chunk:
+                raise ConnectionError("closed")
+            self.buffer += chunk
+        return True
+
+    def message(self, deadline):
+        """(opcode, payload) следующего кадра или None по таймауту"""
+        if not self._need(2, deadline):
+            return None
+        opcode = self.buffer[0] & 0x0F
+        length = self.buffer[1] & 0x7F
+        offset = 2
+        if length == 126:
+            if not self._need(4, deadline):
+                return None
+            length = struct.unpack_from(">H", self.buffer, 2)[0]
+            offset = 4
+        elif length == 127:
+            if not self._need(10, deadline):
+                return None
+            length = struct.unpack_from(">Q", self.buffer, 2)[0]
+            offset = 10
+        if not self._need(offset + length, deadline):
+            return None
+        payload = self.buffer[offset:offset + length]
+        self.buffer = self.buffer[offset + length:]
+        return opcode, payload
+
+
+def run_ws(url, binary, duration, stats):
+    sock, pending = ws_connect(url)
+    if binary:
+        ws_send_text(sock, "FORMAT:BIN")
+    reader = WsReader(sock, pending)
+    deadline = time.monotonic() + duration
+    try:
+        while time.monotonic() < deadline:
+            try:
+                message = reader.message(deadline)
+            except ConnectionError:
+                break
+            if message is None:
+                continue
+            opcode, payload = message
+            if opcode == 0x8:
+                break
+            if opcode in (0x1, 0x2):
+                stats.add(payload if opcode == 0x2 else payload.decode("utf-8", "replace"), None)
+    finally:
+        sock.close()
+
+
+# ---------------------------------------------------------------------------
+# Захват BLE notify
+# ---------------------------------------------------------------------------
+
+def run_ble_capture(path, stats):
+    """Строки "<время приема, с>\\t<payload>"; время приема берется из файла"""
+    with open(path, "r", encoding="utf-8") as capture:
+        for line in capture:
+            line = line.rstrip("\r\n")
+            if not line or line.startswith("#"):
+                continue
+            received, _, payload = line.partition("\t")
+            if payload.startswith("hex:"):
+                payload = bytes.fromhex(payload[4:])
+            stats.add(payload, int(float(received) * 1e6))
+
+
+# ---------------------------------------------------------------------------
+# Эмулятор прошивки (frame_emitter через pty или loopback)
+# ---------------------------------------------------------------------------
+
+# cmake -S Benchmark -B build из корня репозитория
+DEFAULT_EMITTER = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, "build", "frame_emitter")
+
+
+def emulate(emitter, transport, fmt, rate, duration, stats):
+    """Кадры дает frame_emitter (кодировщики прошивок), клиент - этот скрипт"""
+    if not os.access(emitter, os.X_OK):
+        raise SystemExit("Нет %s: соберите Benchmark (цель frame_emitter) или укажите --emitter" % emitter)
+    command = [emitter, "--pty" if transport == "serial" else "--ws", "--format", fmt, "--rate", str(rate)]
+    process = subprocess.Popen(command, stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+    try:
+        endpoint = process.stdout.readline().strip()
+        if not endpoint:
+            raise SystemExit("frame_emitter завершился без адреса")
+        if transport == "serial":
+            fd, keep = open_serial(endpoint, 115200)
+            # Порт открыт - эмулятор начинает слать кадры
+            process.stdin.write("go\n")
+            process.stdin.flush()
+            run_serial(endpoint, 115200, duration, stats, opened=(fd, keep))
+            return "emulate:serial:" + endpoint
+        # Кадр уже в нужном формате, FORMAT:BIN не нужен
+        run_ws("ws://127.0.0.1:%s/" % endpoint, False, duration, stats)
+        return "emulate:ws:127.0.0.1:" + endpoint
+    finally:
+        process.terminate()
+        process.wait()
+
+
+# ---------------------------------------------------------------------------
+
+def main():
+    parser = argparse.ArgumentParser(description="Задержка и пропускная способность транспортов трекера")
+    sub = parser.add_subparsers(dest="source", required=True)
+
+    p = sub.add_parser("serial", help="USB serial или pty")
+    p.add_argument("port")
+    p.add_argument("--baud", type=int, default=115200)
+
+    p = sub.add_parser("ws", help="WebSocket сервер трекера")
+    p.add_argument("url")
+    p.add_argument("--binary", action="store_true", help="запросить бинарные кадры (FORMAT:BIN)")
+
+    p = sub.add_parser("ble", help="записанный захват BLE notify")
+    p.add_argument("capture")
+
+    p = sub.add_parser("emulate", help="эмулятор прошивки через локальный pty/WebSocket")
+    p.add_argument("--transport", choices=["serial", "ws"], default="serial")
+    p.add_argument("--format", choices=["text", "json", "bin"], default="text")
+    p.add_argument("--rate", type=float, default=100.0, help="кадров в секунду")
+    p.add_argument("--emitter", default=DEFAULT_EMITTER, help="путь к frame_emitter (по умолчанию build/frame_emitter в корне репозитория)")
+
+    for p in sub.choices.values():
+        p.add_argument("--duration", type=float, default=10.0, help="длительность замера, с")
+        p.add_argument("--report", help="файл для JSON отчета (по умолчанию stdout)")
+
+    args = parser.parse_args()
+    if args.source == "emulate" and args.transport == "serial" and args.format == "bin":
+        parser.error("по serial прошивки передают только строки (text/json)")
+    stats = LatencyStats(shared_clock=args.source == "emulate")
+
+    if args.source == "serial":
+        run_serial(args.port, args.baud, args.duration, stats)
+        source = "serial:" + args.port
+    elif args.source == "ws":
+        run_ws(args.url, args.binary, args.duration, stats)
+        source = "ws:" + args.url
+    elif args.source == "ble":
+        run_ble_capture(args.capture, stats)
+        source = "ble:" + args.capture
+    else:
+        source = emulate(args.emitter, args.transport, args.format, args.rate, args.duration, stats)
+
+    report = json.dumps(stats.report(source), indent=2, ensure_ascii=False)
+    if args.report:
+        with open(args.report, "w", encoding="utf-8") as out:
+            out.write(report + "\n")
+    else:
+        print(report)
+    return 0 if stats.frames > 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,336 @@
+"""
+Сравнение политик отправки ориентации на записанной траектории:
+кадров в секунду против угловой ошибки позы, которую видит клиент.
+
+Политики:
+  threshold  - прежняя: кадр не чаще SEND_INTERVAL и только если угол
+               изменился на CHANGE_THRESHOLD; клиент держит последний кадр
+  predictive - SendPolicy.h: кадр, когда поза выходит из допуска вокруг
+               общего прогноза (кадр + скорость * min(dt, горизонт)) или
+               истек keepalive; клиент экстраполирует так же
+
+Ошибка считается в каждый момент отсчета траектории как максимум по осям
+|истинный угол - поза у клиента| (с переходом через +-180). Кадр доходит
+до клиента через --latency-ms (+ равномерный джиттер --jitter-ms), так что
+в ошибку входит и транспортная задержка.
+
+Траектория (--trace) - файл, по строке на отсчет, в одном из форматов:
+  <timestamp_us>,<pitch>,<roll>,<yaw>          CSV (заголовок пропускается)
+  ...PITCH:<p>,ROLL:<r>,YAW:<y>,...,TS:<us>    текстовые кадры прошивок
+  {..."absPitch":..,"absRoll":..,"absYaw":..,"sampleUs":..}  JSON кадры
+Траектория должна быть записана с полной частотой отсчетов (например,
+вывод MPU6050_Serial), а не прореженным потоком кадров.
+Без --trace используется синтетическое движение головы: покой, медленные
+и быстрые повороты, наклоны, шум датчика.
+
+PredictivePolicy здесь - порт SendPolicy.h на Python для подбора
+параметров и записанных траекторий. Числа для кода прошивки дает
+host-тест tests/send_policy_test.cpp: он гоняет сам SendPolicy.h на той
+же модели синтетического движения (генератор случайных чисел другой,
+так что траектории не совпадают отсчет в отсчет) и проверяет кадры/с и
+ошибку; с аргументом - файлом CSV - печатает ту же таблицу для записи.
+
+Примеры:
+  python3 send_policy_benchmark.py
+  python3 send_policy_benchmark.py --trace head.csv --latency-ms 15 --jitter-ms 10
+  python3 send_policy_benchmark.py --budgets 0.25,0.5,1 --report policy.json
+"""
+
+import argparse
+import json
+import math
+import random
+import re
+
+from latency_benchmark import percentile
+
+TEXT_POSE = re.compile(r"(?:^|,)PITCH:([-\d.]+),ROLL:([-\d.]+),YAW:([-\d.]+).*?TS:(\d+)")
+CSV_POSE = re.compile(r"^\s*(\d+)\s*[,;\t]\s*([-\d.eE+]+)\s*[,;\t]\s*([-\d.eE+]+)\s*[,;\t]\s*([-\d.eE+]+)")
+
+RATE_DEADBAND = 1.0   # SEND_POLICY_RATE_DEADBAND
+
+
+def wrap180(angle):
+    while angle > 180.0:
+        angle -= 360.0
+    while angle < -180.0:
+        angle += 360.0
+    return angle
+
+
+# ---------------------------------------------------------------------------
+# Траектории
+# ---------------------------------------------------------------------------
+
+def load_trace(path):
+    """Список (timestamp_us, pitch, roll, yaw)"""
+    samples = []
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            if line.startswith("{"):
+                try:
+                    data = json.loads(line)
+                except ValueError:
+                    continue
+                if "sampleUs" in data and "absPitch" in data:
+                    samples.append((int(data["sampleUs"]), float(data["absPitch"]),
+                                    float(data["absRoll"]), float(data["absYaw"])))
+                continue
+            match = TEXT_POSE.search(line)
+            if match:
+                samples.append((int(match.group(4)), float(match.group(1)),
+                                float(match.group(2)), float(match.group(3))))
+                continue
+            match = CSV_POSE.match(line)
+            if match:
+                samples.append((int(match.group(1)), float(match.group(2)),
+                                float(match.group(3)), float(match.group(4))))
+
+    # micros() переполняется каждые ~71 мин
+    unwrapped = []
+    base = 0
+    last = None
+    for ts, p, r, y in samples:
+        if last is not None and ts < last and last - ts > (1 << 31):
+            base += 1 << 32
+        last = ts
+        unwrapped.append((base + ts, p, r, y))
+    return unwrapped
+
+
+def synthetic_trace(duration_s, rate_hz, seed):
+    """Движение головы: сегменты покоя, плавных и резких поворотов"""
+    rng = random.Random(seed)
+    period_us = int(1000000 / rate_hz)
+    samples = []
+    pose = [0.0, 0.0, 0.0]
+    t_us = 0
+    end_us = int(duration_s * 1000000)
+
+    while t_us < end_us:
+        kind = rng.choice(["still", "still", "slow", "slow", "fast", "tilt"])
+        length = rng.uniform(0.5, 3.0) if kind != "fast" else rng.uniform(0.2, 0.6)
+        start = list(pose)
+        target = list(pose)
+        if kind == "slow":
+            target[2] += rng.uniform(-60, 60)
+        elif kind == "fast":
+            target[2] += rng.choice([-1, 1]) * rng.uniform(40, 120)
+            target[0] += rng.uniform(-15, 15)
+        elif kind == "tilt":
+            target[0] = rng.uniform(-35, 35)
+            target[1] = rng.uniform(-20, 20)
+
+        steps = max(1, int(length * rate_hz))
+        for i in range(1, steps + 1):
+            # Плавный профиль скорости (minimum jerk), как у поворота головы
+            s = i / steps
+            k = 10 * s ** 3 - 15 * s ** 4 + 6 * s ** 5
+            for axis in range(3):
+                pose[axis] = start[axis] + (target[axis] - start[axis]) * k
+            noisy = [wrap180(a + rng.gauss(0, 0.03)) for a in pose]
+            samples.append((t_us, noisy[0], noisy[1], noisy[2]))
+            t_us += period_us
+        pose = [wrap180(a) for a in pose]
+    return samples
+
+
+# ---------------------------------------------------------------------------
+# Политики отправки (поведение прошивок)
+# ---------------------------------------------------------------------------
+
+class ThresholdPolicy:
+    """dataChanged() + SEND_INTERVAL; клиент держит последний кадр"""
+
+    name = "threshold"
+
+    def __init__(self, threshold, interval_us):
+        self.threshold = threshold
+        self.interval_us = interval_us
+        self.last_us = None
+        self.sent = None
+
+    def params(self):
+        return {"change_threshold": self.threshold, "send_interval_ms": self.interval_us / 1000}
+
+    def step(self, ts, angles):
+        """Возвращает (поза, скорости) кадра или None"""
+        if self.last_us is not None and ts - self.last_us < self.interval_us:
+            return None
+        if self.sent is not None and all(abs(a - s) < self.threshold for a, s in zip(angles, self.sent)):
+            return None
+        self.sent = list(angles)
+        self.last_us = ts
+        return list(angles), [0.0, 0.0, 0.0]
+
+
+class PredictivePolicy:
+    """Порт PredictiveSendPolicy (SendPolicy.h)"""
+
+    name = "predictive"
+
+    def __init__(self, budget, keepalive_us, min_interval_us, horizon_us, smoothing=0.3):
+        self.budget = budget
+        self.keepalive_us = keepalive_us
+        self.min_interval_us = min_interval_us
+        self.horizon_us = horizon_us
+        self.smoothing = smoothing
+        self.rates = [0.0, 0.0, 0.0]
+        self.last = None
+        self.sent = None
+
+    def params(self):
+        return {"error_budget": self.budget, "keepalive_ms": self.keepalive_us / 1000,
+                "min_interval_ms": self.min_interval_us / 1000, "horizon_ms": self.horizon_us / 1000}
+
+    def rate(self, axis):
+        return 0.0 if abs(self.rates[axis]) < RATE_DEADBAND else self.rates[axis]
+
+    def observe(self, ts, angles):
+        if self.last is not None:
+            dt = ts - self.last[0]
+            if 0 < dt < self.horizon_us:
+                for i in range(3):
+                    rate = wrap180(angles[i] - self.last[1][i]) * 1000000.0 / dt
+                    self.rates[i] += self.smoothing * (rate - self.rates[i])
+            else:
+                self.rates = [0.0, 0.0, 0.0]
+        self.last = (ts, list(angles))
+
+    def due(self, ts, angles):
+        if self.sent is None:
+            return True
+        elapsed = ts - self.sent[0]
+        if elapsed < self.min_interval_us:
+            return False
+        if elapsed >= self.keepalive_us:
+            return True
+        dt = min(elapsed, self.horizon_us) / 1000000.0
+        error = max(abs(wrap180(a - (s + r * dt)))
+                    for a, s, r in zip(angles, self.sent[1], self.sent[2]))
+        return error > self.budget
+
+    def step(self, ts, angles):
+        self.observe(ts, angles)
+        if not self.due(ts, angles):
+            return None
+        rates = [self.rate(i) for i in range(3)]
+        self.sent = (ts, list(angles), rates)
+        return list(angles), rates
+
+
+# ---------------------------------------------------------------------------
+# Прогон
+# ---------------------------------------------------------------------------
+
+def replay(trace, policy, latency_us, jitter_us, horizon_us, seed):
+    """Кадры уходят по политике, клиент показывает прогноз в каждый момент отсчета"""
+    rng = random.Random(seed)
+    in_flight = []          # (время прихода, поза, скорости), по порядку отправки
+    shown = None            # (время прихода, поза, скорости) последнего кадра у клиента
+    frames = 0
+    errors = []
+
+    for ts, p, r, y in trace:
+        angles = (p, r, y)
+        frame = policy.step(ts, angles)
+        if frame is not None:
+            frames += 1
+            arrival = ts + latency_us + (rng.uniform(0, jitter_us) if jitter_us else 0)
+            # TCP/BLE доставляют по порядку: кадр не обгоняет предыдущий
+            if in_flight:
+                arrival = max(arrival, in_flight[-1][0])
+            in_flight.append((arrival, frame[0], frame[1]))
+
+        while in_flight and in_flight[0][0] <= ts:
+            shown = in_flight.pop(0)
+        if shown is None:
+            continue
+
+        dt = min(ts - shown[0], horizon_us) / 1000000.0
+        error = max(abs(wrap180(a - (s + rate * dt)))
+                    for a, s, rate in zip(angles, shown[1], shown[2]))
+        errors.append(error)
+
+    duration_s = (trace[-1][0] - trace[0][0]) / 1000000.0 if len(trace) > 1 else 0.0
+    errors.sort()
+    return {
+        "policy": policy.name,
+        "params": policy.params(),
+        "frames": frames,
+        "frames_per_s": round(frames / duration_s, 2) if duration_s > 0 else None,
+        "error_deg": {
+            "mean": round(sum(errors) / len(errors), 3) if errors else None,
+            "p50": round(percentile(errors, 50), 3) if errors else None,
+            "p95": round(percentile(errors, 95), 3) if errors else None,
+            "p99": round(percentile(errors, 99), 3) if errors else None,
+            "max": round(errors[-1], 3) if errors else None,
+        },
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Кадры/с против угловой ошибки для политик отправки")
+    parser.add_argument("--trace", help="файл траектории (по умолчанию синтетическая)")
+    parser.add_argument("--duration", type=float, default=120.0, help="длительность синтетической траектории, с")
+    parser.add_argument("--rate", type=float, default=250.0, help="частота синтетических отсчетов, Гц")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--latency-ms", type=float, default=10.0, help="задержка доставки кадра")
+    parser.add_argument("--jitter-ms", type=float, default=0.0, help="равномерный джиттер доставки")
+    parser.add_argument("--thresholds", default="0.5,1.0", help="CHANGE_THRESHOLD для прежней политики, °")
+    parser.add_argument("--send-interval-ms", type=float, default=50.0)
+    parser.add_argument("--budgets", default="0.25,0.5,1.0,2.0", help="допуски прогноза, °")
+    parser.add_argument("--keepalive-ms", type=float, default=250.0)
+    parser.add_argument("--min-interval-ms", type=float, default=10.0)
+    parser.add_argument("--horizon-ms", type=float, default=100.0)
+    parser.add_argument("--report", help="файл для JSON отчета")
+    args = parser.parse_args()
+
+    if args.trace:
+        trace = load_trace(args.trace)
+        source = args.trace
+    else:
+        trace = synthetic_trace(args.duration, args.rate, args.seed)
+        source = "synthetic"
+    if len(trace) < 2:
+        parser.error("в траектории меньше двух отсчетов")
+
+    latency_us = int(args.latency_ms * 1000)
+    jitter_us = int(args.jitter_ms * 1000)
+    horizon_us = int(args.horizon_ms * 1000)
+
+    results = []
+    for threshold in [float(v) for v in args.thresholds.split(",") if v]:
+        policy = ThresholdPolicy(threshold, int(args.send_interval_ms * 1000))
+        results.append(replay(trace, policy, latency_us, jitter_us, 0, args.seed))
+    for budget in [float(v) for v in args.budgets.split(",") if v]:
+        policy = PredictivePolicy(budget, int(args.keepalive_ms * 1000),
+                                  int(args.min_interval_ms * 1000), horizon_us)
+        results.append(replay(trace, policy, latency_us, jitter_us, horizon_us, args.seed))
+
+    print("%-11s %-22s %9s %8s %8s %8s %8s" % ("policy", "params", "frames/s", "mean°", "p95°", "p99°", "max°"))
+    for result in results:
+        params = result["params"]
+        label = ("threshold=%g" % params["change_threshold"] if result["policy"] == "threshold"
+                 else "budget=%g" % params["error_budget"])
+        e = result["error_deg"]
+        print("%-11s %-22s %9.1f %8.3f %8.3f %8.3f %8.3f" % (
+            result["policy"], label, result["frames_per_s"], e["mean"], e["p95"], e["p99"], e["max"]))
+
+    if args.report:
+        report = {
+            "trace": source,
+            "samples": len(trace),
+            "latency_ms": args.latency_ms,
+            "jitter_ms": args.jitter_ms,
+            "results": results,
+        }
+        with open(args.report, "w", encoding="utf-8") as f:
+            json.dump(report, f, indent=2, ensure_ascii=False)
+
+
+if __name__ == "__main__":
+    main()
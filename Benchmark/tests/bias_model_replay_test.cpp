@@ -0,0 +1,149 @@
+/*
+  Bluetooth_v5: модель смещения гироскопа на прогреве (BiasModelOrientation.h)
+
+  Трасса warmup: датчик неподвижен 12 мин после включения, кристалл
+  выходит на +15 °C по экспоненте с постоянной 3 мин (быстро в первые
+  минуты, к концу почти установился), смещение идет за температурой
+  (по Z 0.08 °/с на °C, ImuTrace.h). Отсчеты читаются с имитации MPU6050
+  по 1 кГц, как fusionTask.
+
+  - Первый запуск: модель пуста, до разброса температур в 1 °C наклона
+    нет, и среднее всех наблюдений отстает от смещения; это закрывает
+    слежение за остатком в покое. Дрейф курса после TRACE_SETTLE_S -
+    меньше 0.5 °/мин в среднем и меньше 1° за любую минуту, в том числе
+    в начале, когда температура растет на 5 °C в минуту.
+  - Второй запуск того же датчика с моделью из первого (GyroBiasRecord,
+    как из EEPROM): наклон известен сразу, дрейф еще меньше.
+  - Модель получила наблюдения по всему диапазону температур, и наклон
+    по Z близок к заданному.
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <algorithm>
+#include <vector>
+
+#include "HostTest.h"
+#include "ImuTrace.h"
+#include "MockMPU6050.h"
+#include "../../Bluetooth_ESP32/V5/Bluetooth_v5/BiasModelOrientation.h"
+
+#define MPU_ADDR 0x68
+static const uint32_t SAMPLE_PERIOD_US = 1000;
+
+// Прогрев после включения: +15 °C с постоянной 3 мин, 12 мин (4 постоянных)
+static Scenario warmupScenario() {
+  Scenario warmup;
+  warmup.name = "warmup";
+  warmup.seconds = 12 * 60;
+  warmup.warmupC = 15;
+  warmup.warmupTauS = 180;
+  return warmup;
+}
+
+struct WarmupResult {
+  double driftPerMin;      // наклон ошибки курса, °/мин
+  double worstMinute;      // наибольший уход курса за минуту, °
+  double finalYaw;         // °
+  uint32_t observations;
+  float slopeZ;            // °/с на °C
+  float tempSpread;        // разброс температур наблюдений, °C
+};
+
+// Наклон y(x) по МНК
+static double fitSlope(const std::vector<double> &x, const std::vector<double> &y) {
+  double mx = 0, my = 0;
+  for (size_t i = 0; i < x.size(); i++) {
+    mx += x[i];
+    my += y[i];
+  }
+  mx /= x.size();
+  my /= y.size();
+  double sxy = 0, sxx = 0;
+  for (size_t i = 0; i < x.size(); i++) {
+    sxy += (x[i] - mx) * (y[i] - my);
+    sxx += (x[i] - mx) * (x[i] - mx);
+  }
+  return sxx > 0 ? sxy / sxx : 0;
+}
+
+// setup() и fusionTask скетча; record - модель из прошлого запуска
+static WarmupResult runWarmup(const Trace &trace, BiasModelOrientation &orientation, const GyroBiasRecord *record) {
+  MockMPU6050 sensor(trace);
+  Wire.attach(MPU_ADDR, &sensor);
+  setHostMicros(0);
+
+  MPU6050Bus<TwoWire> bus(Wire, MPU_ADDR);
+  bus.writeRegister(0x6B, 0x00);
+  delay(100);
+  bus.writeRegister(0x1B, 0x00);
+  bus.writeRegister(0x1C, 0x00);
+  bus.writeRegister(0x1A, 0x03);
+  delay(10);
+
+  if (record) orientation.biasModel.fromRecord(*record);
+  BiasCalibrationStats stats;
+  orientation.calibrate(bus, stats);
+
+  std::vector<double> minutes, yaw;
+  double unwrapped = 0;
+  uint64_t next = hostMicros;
+  while (next + SAMPLE_PERIOD_US < trace.endUs()) {
+    next += SAMPLE_PERIOD_US;
+    setHostMicros(next);
+    MPU6050Sample sample;
+    if (!bus.readSample(sample)) continue;
+    orientation.update(sample, SAMPLE_PERIOD_US / 1000000.0f);
+    if (next < TRACE_SETTLE_S * 1e6) continue;
+    if (yaw.empty()) unwrapped = orientation.yaw;
+    else unwrapped += wrap180(orientation.yaw - unwrapped);
+    minutes.push_back(next / 60e6);
+    yaw.push_back(unwrapped);
+  }
+
+  WarmupResult result;
+  result.driftPerMin = fitSlope(minutes, yaw);
+  result.worstMinute = 0;
+  const size_t perMinute = 60000000 / SAMPLE_PERIOD_US;
+  for (size_t i = 0; i + perMinute < yaw.size(); i += perMinute / 4) {
+    result.worstMinute = std::max(result.worstMinute, fabs(yaw[i + perMinute] - yaw[i]));
+  }
+  result.finalYaw = yaw.empty() ? 0 : yaw.back();
+  result.observations = orientation.biasModel.count();
+  result.slopeZ = orientation.biasModel.getSlope(2);
+  result.tempSpread = orientation.biasModel.temperatureSpread();
+  return result;
+}
+
+int main() {
+  Trace trace = synthesize(warmupScenario(), SAMPLE_PERIOD_US, 8);
+  CHECK(trace.endUs() >= 600000000ULL);
+  // Половина прогрева - в первые 2 мин, за последние 2 мин меньше 0.5 °C
+  CHECK(trace.samples[120000].temp - trace.samples[0].temp > 6.0f);
+  CHECK(trace.samples.back().temp - trace.samples[trace.samples.size() - 120000].temp < 0.5f);
+
+  BiasModelOrientation first;
+  WarmupResult cold = runWarmup(trace, first, nullptr);
+  printf("first boot:  drift %.3f deg/min, worst minute %.2f deg, yaw %.2f deg at the end, %u observations, "
+         "slope Z %.3f deg/s/C\n",
+         cold.driftPerMin, cold.worstMinute, cold.finalYaw, cold.observations, cold.slopeZ);
+  CHECK(fabs(cold.driftPerMin) < 0.5);
+  CHECK(cold.worstMinute < 1.0);
+  CHECK(cold.observations >= 40);
+  CHECK(cold.tempSpread > 13.0f);
+
+  GyroBiasRecord record;
+  first.biasModel.toRecord(record, 0x68, MPU_ADDR, CALIBRATION_GYRO_DEG_S);
+
+  BiasModelOrientation second;
+  WarmupResult warm = runWarmup(trace, second, &record);
+  printf("second boot: drift %.3f deg/min, worst minute %.2f deg, yaw %.2f deg at the end, %u observations, "
+         "slope Z %.3f deg/s/C\n",
+         warm.driftPerMin, warm.worstMinute, warm.finalYaw, warm.observations, warm.slopeZ);
+  CHECK(fabs(warm.driftPerMin) < fabs(cold.driftPerMin));
+  CHECK(fabs(warm.driftPerMin) < 0.2);
+  CHECK(warm.worstMinute < cold.worstMinute);
+  CHECK_NEAR(warm.slopeZ, 0.08, 0.03);
+
+  return hostTestResult("bias_model_replay_test");
+}
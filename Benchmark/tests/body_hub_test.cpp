@@ -0,0 +1,237 @@
+/*
+  BodyHub.h (AppESP32): разбор кадров узлов и история узла
+
+  - Бинарный кадр собирается кодером прошивки (OrientationFrame.h V7):
+    28 байт без скоростей, 31 байт со скоростями int8 по 4 °/с (в том
+    числе насыщение), кадр со скоростями короче 31 байта - без скоростей,
+    флаг общих часов, чужой magic.
+  - Текст: PITCH/ROLL/YAW не путаются с REL_PITCH:, ACC_YAW: и т.п., даже
+    когда те стоят раньше; TS и SYNC_US; без YAW: - не кадр позы;
+    статусы и слишком длинный текст - не кадры.
+  - JSON: с absPitch (pitch относительный) и без; syncUs, sampleUs,
+    timestamp в мс; seq; другие type - не кадры.
+  - HubNodeTrack::push(): UDP переставил и продублировал кадры - старые
+    не принимаются; seq переходит через 65535; после долгой паузы номер
+    начинается заново. Перезагрузка узла (часы и seq с нуля) сбрасывает
+    историю и смещение. Смещение часов - задержка доставки снизу, поза
+    на момент такта интерполируется по времени отсчета, а не прихода.
+*/
+
+#include <Arduino.h>
+#include <random>
+#include <string>
+
+#include "HostTest.h"
+#include "../../AppESP32/BodyHub.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/OrientationFrame.h"
+
+static bool parseText(const std::string &text, HubPoseInput &out) {
+  return parseHubFrame((const uint8_t*)text.data(), text.size(), false, out);
+}
+
+static void testBinary() {
+  uint8_t frame[ORIENTATION_FRAME_RATES_SIZE];
+  HubPoseInput in;
+
+  size_t length = encodeOrientationFrame(frame, 4321, 0xFEDCBA98UL, ORIENTATION_FLAG_ZERO_SET,
+                                         12.34f, -56.78f, 179.99f, 370.5, -725.25, 1080.0);
+  CHECK(length == 28);
+  CHECK(parseHubFrame(frame, length, true, in));
+  CHECK(in.seq == 4321 && in.hasSeq);
+  CHECK(in.sampleUs == 0xFEDCBA98UL && in.hasTimestamp && !in.sharedClock);
+  CHECK_NEAR(in.relAngles[0], 12.34f, 0.006f);
+  CHECK_NEAR(in.relAngles[1], -56.78f, 0.006f);
+  CHECK_NEAR(in.relAngles[2], 179.99f, 0.006f);
+  // Накопленные углы - в +-180
+  CHECK_NEAR(in.absAngles[0], 10.5f, 0.006f);
+  CHECK_NEAR(in.absAngles[1], -5.25f, 0.006f);
+  CHECK_NEAR(in.absAngles[2], 0.0f, 0.006f);
+  CHECK(!in.hasRates);
+
+  length = appendOrientationRates(frame, 100.0f, -37.0f, 600.0f);
+  CHECK(length == 31);
+  CHECK(parseHubFrame(frame, length, true, in));
+  CHECK(in.hasRates);
+  CHECK(in.rates[0] == 100.0f);
+  CHECK(in.rates[1] == -36.0f);     // шаг 4 °/с
+  CHECK(in.rates[2] == 508.0f);     // насыщение int8
+  // Флаг скоростей есть, а байтов нет - скорости не читаются
+  CHECK(parseHubFrame(frame, 30, true, in));
+  CHECK(!in.hasRates);
+
+  setOrientationSharedTime(frame, 123456789UL);
+  CHECK(parseHubFrame(frame, length, true, in));
+  CHECK(in.sharedClock && in.sampleUs == 123456789UL);
+
+  CHECK(!parseHubFrame(frame, 27, true, in));
+  frame[0] = 0x5A;
+  CHECK(!parseHubFrame(frame, length, true, in));
+}
+
+static void testText() {
+  HubPoseInput in;
+  // Кадр V7
+  CHECK(parseText("PITCH:10.5,ROLL:-20.0,YAW:170.0,REL_PITCH:1.25,REL_ROLL:-2.50,REL_YAW:3.75,"
+                  "ACC_PITCH:370.50,ACC_ROLL:-20.00,ACC_YAW:890.00,ZERO_SET:true,SEQ:65535,TS:4000000000,"
+                  "RATE_P:12.5,RATE_R:0.0,RATE_Y:-90.0", in));
+  CHECK(in.absAngles[0] == 10.5f && in.absAngles[1] == -20.0f && in.absAngles[2] == 170.0f);
+  CHECK(in.relAngles[0] == 1.25f && in.relAngles[1] == -2.5f && in.relAngles[2] == 3.75f);
+  CHECK(in.seq == 65535 && in.hasSeq);
+  CHECK(in.sampleUs == 4000000000UL && in.hasTimestamp && !in.sharedClock);
+  CHECK(in.hasRates && in.rates[0] == 12.5f && in.rates[2] == -90.0f);
+
+  // REL_ и ACC_ раньше простых ключей: значение берется только у PITCH:, YAW:
+  CHECK(parseText("REL_PITCH:1.0,ACC_YAW:720.0,REL_YAW:-3.0,ACC_PITCH:-400.0,PITCH:5.0,ROLL:6.0,YAW:7.0,"
+                  "SYNC_US:99", in));
+  CHECK(in.absAngles[0] == 5.0f && in.absAngles[1] == 6.0f && in.absAngles[2] == 7.0f);
+  CHECK(in.relAngles[0] == 1.0f && in.relAngles[1] == 6.0f && in.relAngles[2] == -3.0f);
+  CHECK(in.sampleUs == 99 && in.sharedClock);
+  CHECK(!in.hasRates && !in.hasSeq);
+
+  // Только REL_YAW и ACC_YAW - YAW нет
+  CHECK(!parseText("PITCH:1.0,ROLL:2.0,REL_YAW:3.0,ACC_YAW:4.0", in));
+  CHECK(!parseText("PITCH:1.0,ROLL:2.0,YAW:", in));
+  CHECK(!parseText("ANGLES_RESET", in));
+  CHECK(!parseText("TEMPERATURE:36.50C", in));
+  // Без метки времени - время прихода
+  CHECK(parseText("PITCH:1,ROLL:2,YAW:3", in));
+  CHECK(!in.hasTimestamp);
+
+  std::string longText = "PITCH:1,ROLL:2,YAW:3," + std::string(600, 'x');
+  CHECK(!parseText(longText, in));
+}
+
+static void testJson() {
+  HubPoseInput in;
+  // Wifi_Head_MPU6050: pitch относительный, absPitch - абсолютный
+  CHECK(parseText("{\"type\":\"sensorData\",\"pitch\":1.5,\"roll\":2.5,\"yaw\":3.5,\"absPitch\":11.5,"
+                  "\"absRoll\":12.5,\"absYaw\":-170.5,\"seq\":70000,\"sampleUs\":123,\"syncUs\":456,"
+                  "\"ratePitch\":4.0,\"rateRoll\":0.0,\"rateYaw\":-8.0}", in));
+  CHECK(in.absAngles[0] == 11.5f && in.absAngles[2] == -170.5f);
+  CHECK(in.relAngles[0] == 1.5f && in.relAngles[2] == 3.5f);
+  CHECK(in.sampleUs == 456 && in.sharedClock);
+  CHECK(in.seq == (uint16_t)70000);
+  CHECK(in.hasRates && in.rates[2] == -8.0f);
+
+  // Без absPitch: pitch абсолютный
+  CHECK(parseText("{\"type\":\"sensorData\",\"pitch\":-1,\"roll\":-2,\"yaw\":-3,\"relPitch\":0.5,"
+                  "\"sampleUs\":4294967000}", in));
+  CHECK(in.absAngles[0] == -1.0f && in.relAngles[0] == 0.5f && in.relAngles[1] == -2.0f);
+  CHECK(in.sampleUs == 4294967000UL && !in.sharedClock && !in.hasSeq && !in.hasRates);
+
+  CHECK(parseText("{\"type\":\"sensorData\",\"pitch\":0,\"roll\":0,\"yaw\":0,\"timestamp\":1234}", in));
+  CHECK(in.sampleUs == 1234000UL && in.hasTimestamp);
+
+  CHECK(!parseText("{\"type\":\"status\",\"message\":\"Accumulated angles reset\"}", in));
+  CHECK(!parseText("{\"type\":\"format\",\"format\":\"binary\",\"version\":1}", in));
+  CHECK(!parseText("{\"type\":\"sensorData\",\"pitch\":1,\"roll\":2}", in));
+}
+
+static HubPoseInput pose(uint16_t seq, uint32_t sampleUs, float yaw) {
+  HubPoseInput in = HubPoseInput();
+  in.seq = seq;
+  in.hasSeq = true;
+  in.sampleUs = sampleUs;
+  in.hasTimestamp = true;
+  in.absAngles[2] = yaw;
+  in.relAngles[2] = yaw;
+  return in;
+}
+
+static float yawAt(const HubNodeTrack &track, uint32_t targetUs) {
+  float absAngles[3], relAngles[3];
+  uint32_t age;
+  if (!track.poseAt(targetUs, absAngles, relAngles, age)) return NAN;
+  return absAngles[2];
+}
+
+static void testSequence() {
+  HubNodeTrack track;
+  uint32_t t = 1000000;
+  // UDP: 10, 11, 13, 12 (переставлен), 13 (дубль), 14
+  const uint16_t order[] = {10, 11, 13, 12, 13, 14};
+  for (uint16_t seq : order) {
+    track.push(pose(seq, seq * 10000, seq), t);
+    t += 10000;
+  }
+  CHECK(track.framesReceived() == 4);
+  CHECK(track.framesStale() == 2);
+  // Переставленный 12 не попал в историю после 13
+  CHECK(yawAt(track, 14 * 10000 + track.clockOffsetUs()) == 14.0f);
+
+  // Переход через 65535
+  HubNodeTrack wrap;
+  const uint16_t wrapOrder[] = {65534, 65535, 0, 1, 65535, 2};
+  t = 1000000;
+  for (uint16_t seq : wrapOrder) {
+    wrap.push(pose(seq, t, 0), t);
+    t += 10000;
+  }
+  CHECK(wrap.framesReceived() == 5);
+  CHECK(wrap.framesStale() == 1);
+
+  // После паузы дольше HUB_SEQ_RESYNC_US старый номер снова принимается
+  wrap.push(pose(1, t + HUB_SEQ_RESYNC_US, 0), t + HUB_SEQ_RESYNC_US);
+  CHECK(wrap.framesReceived() == 6);
+}
+
+static void testClock() {
+  // Часы узла впереди хаба на 40 с, задержка доставки 2 мс + экспонента 3 мс
+  std::mt19937 rng(5);
+  std::exponential_distribution<double> jitter(1.0 / 3000);
+  HubNodeTrack track;
+  const uint32_t nodeAhead = 40000000;
+  const float rate = 30.0f;   // °/с по yaw, без скоростей в кадре
+  uint16_t seq = 0;
+  uint32_t nodeUs = 0, hubUs = 0;
+  float worst = 0;
+  for (int i = 0; i < 3000; i++) {
+    hubUs = i * 10000 + 5000;
+    nodeUs = hubUs + nodeAhead;
+    float yaw = hubWrap180(rate * hubUs / 1e6f);
+    track.push(pose(seq++, nodeUs, yaw), hubUs + 2000 + (uint32_t)jitter(rng));
+    // Такт хаба: поза на 40 мс назад по часам хаба (с задержкой доставки)
+    if (i > 100) {
+      uint32_t target = hubUs + 2000 - 40000;
+      float truth = hubWrap180(rate * (target - 2000) / 1e6f);
+      worst = std::max(worst, fabsf(hubWrap180(yawAt(track, target) - truth)));
+    }
+  }
+  int32_t offset = track.clockOffsetUs();
+  printf("clock: offset %d us (true %d + 2000 delay), worst pose error %.3f deg\n", offset,
+         -(int32_t)nodeAhead, worst);
+  CHECK(offset >= -(int32_t)nodeAhead + 2000);
+  CHECK(offset < -(int32_t)nodeAhead + 2500);
+  CHECK(worst < 0.05f);
+  CHECK(track.clockResyncs() == 0);
+
+  // Перезагрузка узла: 3 с тишины, часы и номер кадра с нуля
+  hubUs += 3000000;
+  track.push(pose(0, 1000, 45.0f), hubUs + 2000);
+  CHECK(track.clockResyncs() == 1);
+  CHECK(track.framesStale() == 0);
+  CHECK(track.clockOffsetUs() == (int32_t)(hubUs + 2000 - 1000));
+  track.push(pose(1, 11000, 46.0f), hubUs + 12000);
+  // История до перезагрузки не смешивается с новой
+  CHECK_NEAR(yawAt(track, hubUs + 7000), 45.5f, 0.01f);
+  CHECK_NEAR(yawAt(track, hubUs - 500000), 45.0f, 0.01f);
+  CHECK(track.live(hubUs + 12000));
+  CHECK(!track.live(hubUs + 12000 + HUB_NODE_STALE_US + 10000));
+
+  // Узел синхронизировал часы: время берется как есть, старая шкала забыта
+  HubPoseInput shared = pose(2, hubUs + 20000, 50.0f);
+  shared.sharedClock = true;
+  track.push(shared, hubUs + 23000);
+  CHECK(track.sharedClock());
+  CHECK_NEAR(yawAt(track, hubUs + 20000), 50.0f, 0.01f);
+  CHECK_NEAR(yawAt(track, hubUs + 7000), 50.0f, 0.01f);
+}
+
+int main() {
+  testBinary();
+  testText();
+  testJson();
+  testSequence();
+  testClock();
+  return hostTestResult("body_hub_test");
+}
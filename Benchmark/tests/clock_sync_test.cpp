@@ -0,0 +1,252 @@
+/*
+  ClockSync.h (AppESP32 и узлы): ClockSyncClient и ClockSyncServer на
+  поддельной сети из WiFiUdp.h
+
+  Ведущий и два узла со своими часами: у каждого micros() - база + ход,
+  перед каждым действием участника поддельные часы ставятся на его время.
+  Часы узла 0 переполняются на 100 с, ведущего - на 300 с; смещение
+  ведущий - узел 1 не влезает в int32. Сеть: односторонняя задержка
+  1.5 мс + экспоненциальный джиттер 2 мс, 5% пакетов со всплеском до
+  50 мс, 5% потерь, 2% дублей (приходят позже, уже чужим ответом).
+  Узел читает пакеты на проходе loop() раз в 10 мс (delay(10) в скетчах),
+  ведущий - раз в 2 мс.
+
+  - Остаточная ошибка общего времени узла после 30 с (каждые 10 мс):
+    p95 и максимум, в том числе вокруг переполнений часов. Главная ее
+    часть - фаза loop(): ответ почти всегда читается на следующем проходе,
+    t4 - t1 = 10 мс при любой задержке, и фильтр по задержке не отличает
+    хорошие обмены от плохих (~1.2 мс в среднем; с loop() раз в 1 мс -
+    ~0.25 мс).
+  - Оценка дрейфа к концу 10 мин прогона - в пределах 10 ppm от истинной.
+  - Потери считаются; без сети дольше CLOCK_SYNC_VALID_US узел не
+    synced(), после восстановления - снова synced() за пару обменов.
+
+  Benchmark/clock_sync_sim.py - только подбор параметров на модели того же
+  алгоритма; код прошивки проверяет этот тест.
+*/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include "HostTest.h"
+#include "../../AppESP32/ClockSync.h"
+
+static const double WARMUP_US = 30e6;
+static const double DURATION_US = 600e6;
+static const double NODE_LOOP_US = 10000;
+static const double MASTER_LOOP_US = 2000;
+static const double SAMPLE_US = 10000;
+
+// micros() участника в истинный момент t
+struct Clock {
+  double base, rate;
+  uint64_t at(double t) const { return (uint64_t)(base + t * rate); }
+  void set(double t) const { setHostMicros(at(t)); }
+};
+
+class Network {
+  public:
+    explicit Network(uint32_t seed) : rng(seed) {}
+
+    // Односторонняя задержка в мкс, < 0 - пакет потерян
+    double delay() {
+      if (outage || uniform(rng) < 0.05) return -1;
+      double d = 1500 + std::exponential_distribution<double>(1.0 / 2000)(rng);
+      if (uniform(rng) < 0.05) d += (0.2 + 0.8 * uniform(rng)) * 50000;
+      return d;
+    }
+    bool duplicate() { return uniform(rng) < 0.02; }
+
+    bool outage = false;
+
+  private:
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+};
+
+enum EventKind { NODE_LOOP, MASTER_LOOP, TO_MASTER, TO_NODE, SAMPLE };
+
+struct Event {
+  double t;
+  uint64_t order;
+  EventKind kind;
+  int node;
+  HostUdpPacket packet;
+  bool operator>(const Event &other) const { return t != other.t ? t > other.t : order > other.order; }
+};
+
+struct Node {
+  Clock clock;
+  IPAddress ip;
+  WiFiUDP udp;
+  ClockSyncClient<WiFiUDP> sync{udp};
+  std::vector<double> errors;
+  double wrapMaxError = 0;
+  uint32_t wrapSamples = 0;
+  Node(Clock clock, IPAddress ip) : clock(clock), ip(ip) {}
+};
+
+class Simulation {
+  public:
+    Simulation() : network(17) {
+      nodes.emplace_back(new Node({4294967296.0 - 100e6, 1.0 + 40e-6}, IPAddress(192, 168, 4, 2)));
+      nodes.emplace_back(new Node({123456789.0, 1.0 - 35e-6}, IPAddress(192, 168, 4, 3)));
+
+      masterUdp.hostOnSend = [this](const HostUdpPacket &packet) {
+        for (size_t i = 0; i < nodes.size(); i++) {
+          if (nodes[i]->ip == packet.ip) send(TO_NODE, (int)i, packet);
+        }
+      };
+      master.set(0);
+      server.begin();
+      for (size_t i = 0; i < nodes.size(); i++) {
+        Node &node = *nodes[i];
+        node.udp.hostOnSend = [this, i](const HostUdpPacket &packet) { send(TO_MASTER, (int)i, packet); };
+        node.clock.set(0);
+        node.sync.begin(MASTER_IP);
+        schedule(i * 3700.0, NODE_LOOP, (int)i);
+      }
+      schedule(0, MASTER_LOOP, -1);
+      schedule(WARMUP_US, SAMPLE, -1);
+    }
+
+    void run(double untilUs) {
+      while (!events.empty() && events.top().t <= untilUs) {
+        Event e = events.top();
+        events.pop();
+        now = e.t;
+        handle(e);
+      }
+      now = untilUs;
+    }
+
+    // Ход ведущего относительно узла, ppm
+    double trueDrift(const Node &node) const { return (master.rate / node.clock.rate - 1.0) * 1e6; }
+
+    static const IPAddress MASTER_IP;
+    Clock master{4294967296.0 - 300e6, 1.0};
+    WiFiUDP masterUdp;
+    ClockSyncServer<WiFiUDP> server{masterUdp};
+    std::vector<std::unique_ptr<Node>> nodes;
+    Network network;
+    double now = 0;
+
+  private:
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+    uint64_t order = 0;
+
+    void schedule(double t, EventKind kind, int node, const HostUdpPacket &packet = HostUdpPacket()) {
+      events.push({t, order++, kind, node, packet});
+    }
+
+    void send(EventKind kind, int node, const HostUdpPacket &packet) {
+      double d = network.delay();
+      if (d < 0) return;
+      schedule(now + d, kind, node, packet);
+      if (network.duplicate()) schedule(now + d + 20000, kind, node, packet);
+    }
+
+    void handle(const Event &e) {
+      switch (e.kind) {
+        case NODE_LOOP: {
+          Node &node = *nodes[e.node];
+          node.clock.set(now);
+          node.sync.poll(micros());
+          schedule(now + NODE_LOOP_US, NODE_LOOP, e.node);
+          break;
+        }
+        case MASTER_LOOP:
+          master.set(now);
+          server.poll();
+          schedule(now + MASTER_LOOP_US, MASTER_LOOP, -1);
+          break;
+        case TO_MASTER:
+          masterUdp.hostReceive(nodes[e.node]->ip, CLOCK_SYNC_PORT, e.packet.data.data(), e.packet.data.size());
+          break;
+        case TO_NODE:
+          nodes[e.node]->udp.hostReceive(MASTER_IP, CLOCK_SYNC_PORT, e.packet.data.data(), e.packet.data.size());
+          break;
+        case SAMPLE:
+          sample();
+          schedule(now + SAMPLE_US, SAMPLE, -1);
+          break;
+      }
+    }
+
+    void sample() {
+      uint32_t masterUs = (uint32_t)master.at(now);
+      for (auto &entry : nodes) {
+        Node &node = *entry;
+        node.clock.set(now);
+        if (!node.sync.synced()) continue;
+        double error = fabs((double)(int32_t)(node.sync.toShared(micros()) - masterUs));
+        node.errors.push_back(error);
+        // 5 с вокруг переполнения часов узла или ведущего
+        double nodeWrapUs = (4294967296.0 - node.clock.base) / node.clock.rate;
+        double masterWrapUs = 4294967296.0 - master.base;
+        if (fabs(now - nodeWrapUs) < 5e6 || fabs(now - masterWrapUs) < 5e6) {
+          node.wrapMaxError = std::max(node.wrapMaxError, error);
+          node.wrapSamples++;
+        }
+      }
+    }
+};
+
+const IPAddress Simulation::MASTER_IP(192, 168, 4, 1);
+
+static double percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  return values[(size_t)(p / 100.0 * (values.size() - 1))];
+}
+
+int main() {
+  Simulation sim;
+  for (auto &node : sim.nodes) CHECK(!node->sync.synced());
+
+  sim.run(DURATION_US);
+  printf("%-5s %9s %9s %8s %8s %8s %8s %9s %6s\n", "node", "drift", "est.", "mean", "p95", "max", "wrap max",
+         "exchanges", "lost");
+  for (size_t i = 0; i < sim.nodes.size(); i++) {
+    Node &node = *sim.nodes[i];
+    const std::vector<double> &errors = node.errors;
+    double mean = 0;
+    for (double e : errors) mean += e;
+    mean /= errors.size();
+    double p95 = percentile(errors, 95), max = percentile(errors, 100);
+    double driftError = fabs(node.sync.drift() - sim.trueDrift(node));
+    printf("%-5zu %8.1fp %8.1fp %7.0fu %7.0fu %7.0fu %8.0fu %9u %6u\n", i, sim.trueDrift(node),
+           node.sync.drift(), mean, p95, max, node.wrapMaxError, node.sync.exchangeCount(), node.sync.lostCount());
+
+    // Все отсчеты после прогрева - в synced(); их (600 - 30) с по 100 в секунду
+    CHECK(errors.size() + 100 >= (size_t)((DURATION_US - WARMUP_US) / SAMPLE_US));
+    CHECK(p95 < 2500);
+    CHECK(max < 5000);
+    CHECK(node.wrapSamples > 0);
+    CHECK(node.wrapMaxError < 5000);
+    CHECK(driftError < 10);
+    CHECK(node.sync.lostCount() > 0);
+    CHECK(node.sync.exchangeCount() > 500);
+  }
+  CHECK(sim.server.requestsAnswered() > 1000);
+
+  // Сеть пропала: после CLOCK_SYNC_VALID_US метки больше не общие
+  sim.network.outage = true;
+  sim.run(DURATION_US + CLOCK_SYNC_VALID_US + 2e6);
+  for (auto &node : sim.nodes) {
+    node->clock.set(sim.now);
+    CHECK(!node->sync.synced());
+  }
+  sim.network.outage = false;
+  sim.run(DURATION_US + CLOCK_SYNC_VALID_US + 6e6);
+  for (auto &node : sim.nodes) {
+    node->clock.set(sim.now);
+    CHECK(node->sync.synced());
+  }
+
+  return hostTestResult("clock_sync_test");
+}
@@ -0,0 +1,129 @@
+/*
+  Bluetooth_v5: чтение FIFO MPU6050 пачками (MPU6050Bus::drainFifo())
+
+  - Разбор: записанный поток байт FIFO (14 байт на отсчет, старший байт
+    вперед) дает те же значения, включая отрицательные.
+  - Без потерь: имитация датчика (MockMPU6050) пишет FIFO на 1 кГц, в
+    гироскоп X трассы зашит номер миллисекунды. Задача чтения просыпается
+    раз в 4-6 мс, как при нагрузке BLE; все номера должны прийти подряд,
+    без пропусков и повторов, а age последнего в пачке - 0.
+  - Переполнение: после паузы дольше емкости FIFO (1024 байта = 73 отсчета)
+    drainFifo() сообщает -1 и сбрасывает FIFO; следующие пачки снова
+    выровнены по отсчетам.
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <random>
+
+#include "HostTest.h"
+#include "ImuTrace.h"
+#include "MockMPU6050.h"
+#include "../../Bluetooth_ESP32/V5/Bluetooth_v5/MPU6050Bus.h"
+
+#define MPU_FIFO_BURST_SAMPLES 9   // как в Bluetooth_v5.ino
+
+// Гироскоп X отсчета i = i LSB (±250°/с: 131 LSB на °/с)
+static Trace numberedTrace(uint32_t seconds) {
+  Trace trace;
+  trace.name = "numbered";
+  trace.periodUs = 1000;
+  for (uint32_t i = 0; i < seconds * 1000; i++) {
+    ImuSample s = ImuSample();
+    s.tUs = i * 1000;
+    s.gyro[0] = (float)(i % 30000) / 131.0f;
+    s.gyro[1] = -1.0f;
+    s.accel[2] = 1.0f;
+    s.temp = 30.0f;
+    trace.samples.push_back(s);
+  }
+  return trace;
+}
+
+static void testParse() {
+  // Два отсчета из потока FIFO
+  const uint8_t stream[2 * MPU6050_SAMPLE_BYTES] = {
+    0x01, 0x02, 0xFF, 0xFE, 0x40, 0x00,  0xF2, 0x60,  0x00, 0x83, 0xFF, 0x7D, 0x80, 0x00,
+    0x7F, 0xFF, 0x00, 0x00, 0xC0, 0x00,  0x0B, 0xB8,  0x00, 0x00, 0x00, 0x01, 0xFF, 0xFF,
+  };
+  MPU6050Sample a, b;
+  parseMPU6050Sample(stream, a);
+  parseMPU6050Sample(stream + MPU6050_SAMPLE_BYTES, b);
+  CHECK(a.ax == 0x0102 && a.ay == -2 && a.az == 16384);
+  CHECK(a.temp == -3488);
+  CHECK(a.gx == 131 && a.gy == -131 && a.gz == -32768);
+  CHECK(b.ax == 32767 && b.ay == 0 && b.az == -16384);
+  CHECK_NEAR(mpu6050Temperature(b.temp), 3000 / 340.0 + 36.53, 1e-4);
+  CHECK(b.gx == 0 && b.gy == 1 && b.gz == -1);
+}
+
+static void testDrain() {
+  Trace trace = numberedTrace(12);
+  MockMPU6050 sensor(trace);
+  Wire.attach(0x68, &sensor);
+  setHostMicros(0);
+
+  MPU6050Bus<TwoWire> bus(Wire, 0x68);
+  bus.writeRegister(0x6B, 0x00);
+  bus.writeRegister(0x1B, 0x00);
+  bus.writeRegister(0x1C, 0x00);
+  bus.writeRegister(0x1A, 0x03);   // DLPF 44 Гц: 1 кГц
+  bus.configureFifo(0);
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> wake(4000, 6000);
+  uint8_t buf[MPU_FIFO_BURST_SAMPLES * MPU6050_SAMPLE_BYTES];
+  int total = 0, gaps = 0, wakeups = 0, badAge = 0, overflows = 0;
+  int expected = -1;
+  while (hostMicros < 10000000) {
+    advanceHostMicros(wake(rng));
+    int lastGx = -1, lastAge = -1;
+    int samples = bus.drainFifo(buf, MPU_FIFO_BURST_SAMPLES, [&](const MPU6050Sample &sample, uint16_t age) {
+      if (expected >= 0 && sample.gx != expected) gaps++;
+      expected = sample.gx + 1;
+      if (lastGx >= 0 && (int)age != lastAge - 1) badAge++;
+      lastGx = sample.gx;
+      lastAge = age;
+    });
+    if (samples < 0) overflows++;
+    if (samples > 0 && lastAge != 0) badAge++;
+    if (samples > 0) total += samples;
+    wakeups++;
+  }
+  // Все измерения датчика дошли до обработчика
+  CHECK(overflows == 0);
+  CHECK(gaps == 0);
+  CHECK(badAge == 0);
+  CHECK(total >= 9990 && sensor.stats().fifoBytesRead == (uint32_t)total * MPU6050_SAMPLE_BYTES);
+  CHECK(sensor.stats().fifoBytesLost == 0);
+  printf("%d wakeups, %d samples, %.1f per wakeup\n", wakeups, total, (double)total / wakeups);
+
+  // Пауза 100 мс: FIFO переполняется
+  advanceHostMicros(100000);
+  int samples = bus.drainFifo(buf, MPU_FIFO_BURST_SAMPLES, [](const MPU6050Sample &, uint16_t) {});
+  CHECK(samples == -1);
+  CHECK(sensor.stats().fifoOverflows == 1);
+
+  // После сброса - снова целые отсчеты подряд
+  expected = -1;
+  gaps = 0;
+  total = 0;
+  for (int i = 0; i < 100; i++) {
+    advanceHostMicros(5000);
+    int n = bus.drainFifo(buf, MPU_FIFO_BURST_SAMPLES, [&](const MPU6050Sample &sample, uint16_t) {
+      if (expected >= 0 && sample.gx != expected) gaps++;
+      if (sample.gy != -131 || sample.az != 16384) gaps++;
+      expected = sample.gx + 1;
+    });
+    if (n > 0) total += n;
+  }
+  CHECK(gaps == 0);
+  CHECK(total >= 495);
+  Wire.detach(0x68);
+}
+
+int main() {
+  testParse();
+  testDrain();
+  return hostTestResult("fifo_replay_test");
+}
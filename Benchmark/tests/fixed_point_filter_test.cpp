@@ -0,0 +1,196 @@
+/*
+  FixedPointFilter.h против того же фильтра в double
+
+  - fixedAtan2(): максимальная ошибка против atan2 по всей окружности и по
+    длинам вектора от 1 LSB до 2^26; fixedSqrt(): точный floor(sqrt).
+  - FixedPointFilter::update(): тот же дополнительный фильтр в double
+    (эталон) на сырых LSB трасс head, walk и steps при 500 Гц; ошибка
+    pitch/roll/yaw в любой момент - не больше 0.05°.
+  - Стоимость одного update(): такты (rdtsc на x86, иначе нс) и счет
+    операций - итерации CORDIC и корня, деления int64. На ESP8266 нет FPU:
+    эталон там - вызовы libgcc на каждую операцию float/double.
+*/
+
+#include <Arduino.h>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "HostTest.h"
+#include "ImuTrace.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/FixedPointFilter.h"
+
+static const double GYRO_LSB = 131, ACCEL_LSB = 8192;
+
+struct RawSample {
+  int16_t ax, ay, az, gx, gy, gz;
+};
+
+static int16_t toRaw(double value) {
+  double raw = lround(value);
+  if (raw > 32767) raw = 32767;
+  if (raw < -32768) raw = -32768;
+  return (int16_t)raw;
+}
+
+static std::vector<RawSample> rawTrace(const Trace &trace) {
+  std::vector<RawSample> raw;
+  for (const ImuSample &s : trace.samples) {
+    raw.push_back({toRaw(s.accel[0] * ACCEL_LSB), toRaw(s.accel[1] * ACCEL_LSB), toRaw(s.accel[2] * ACCEL_LSB),
+                   toRaw(s.gyro[0] * GYRO_LSB), toRaw(s.gyro[1] * GYRO_LSB), toRaw(s.gyro[2] * GYRO_LSB)});
+  }
+  return raw;
+}
+
+// FixedPointFilter::update() в double, шаг за шагом
+struct ReferenceFilter {
+  double pitch = 0, roll = 0, yaw = 0;
+  bool initialized = false;
+
+  static double wrap(double angle) {
+    while (angle > 180) angle -= 360;
+    while (angle < -180) angle += 360;
+    return angle;
+  }
+
+  void update(const RawSample &s, uint32_t dtMicros) {
+    double accelPitch = atan2((double)s.ay, (double)s.az) * RAD_TO_DEG;
+    double accelRoll = atan2(-(double)s.ax, sqrt((double)s.ay * s.ay + (double)s.az * s.az)) * RAD_TO_DEG;
+    if (!initialized) {
+      pitch = accelPitch;
+      roll = accelRoll;
+      initialized = true;
+      return;
+    }
+    double dt = dtMicros / 1e6;
+    pitch += s.gx / GYRO_LSB * dt;
+    roll += s.gy / GYRO_LSB * dt;
+    yaw = wrap(yaw + s.gz / GYRO_LSB * dt);
+    double magnitude = sqrt((double)s.ax * s.ax + (double)s.ay * s.ay + (double)s.az * s.az);
+    if (magnitude > ACCEL_LSB / 2 && magnitude < ACCEL_LSB * 3 / 2) {
+      pitch = wrap(pitch + wrap(accelPitch - pitch) * 0.04);
+      roll = wrap(roll + wrap(accelRoll - roll) * 0.04);
+    }
+  }
+};
+
+static void testAtan2() {
+  double maxError = 0;
+  for (int lengthBits = 0; lengthBits <= 26; lengthBits += 2) {
+    double length = ldexp(1.0, lengthBits);
+    for (int i = 0; i < 3600; i++) {
+      double angle = (i / 10.0 - 180.0) * DEG_TO_RAD;
+      int32_t x = (int32_t)lround(cos(angle) * length);
+      int32_t y = (int32_t)lround(sin(angle) * length);
+      if (x == 0 && y == 0) continue;
+      double exact = atan2((double)y, (double)x) * RAD_TO_DEG;
+      double error = fabs(ReferenceFilter::wrap(fixedToFloat(fixedAtan2(y, x)) - exact));
+      if (error > maxError) maxError = error;
+    }
+  }
+  printf("fixedAtan2: max error %.4f deg\n", maxError);
+  CHECK(maxError < 0.005);
+
+  bool sqrtExact = true;
+  for (uint64_t v = 0; v < (1ULL << 32); v += 65537 + (v >> 8)) {
+    uint32_t r = fixedSqrt((uint32_t)v);
+    if ((uint64_t)r * r > v || (uint64_t)(r + 1) * (r + 1) <= v) sqrtExact = false;
+  }
+  CHECK(sqrtExact);
+}
+
+static void testFilter() {
+  std::vector<Scenario> list = scenarios();
+  for (size_t index : {1, 2, 3}) {
+    Trace trace = synthesize(list[index], 2000, 11 + index);
+    std::vector<RawSample> raw = rawTrace(trace);
+    FixedPointFilter fixedFilter(131, 8192);
+    ReferenceFilter reference;
+    double maxError[3] = {0, 0, 0};
+    for (const RawSample &s : raw) {
+      fixedFilter.update(s.ax, s.ay, s.az, s.gx, s.gy, s.gz, trace.periodUs);
+      reference.update(s, trace.periodUs);
+      double errors[3] = {
+        ReferenceFilter::wrap(fixedToFloat(fixedFilter.pitch) - reference.pitch),
+        ReferenceFilter::wrap(fixedToFloat(fixedFilter.roll) - reference.roll),
+        ReferenceFilter::wrap(fixedToFloat(fixedFilter.yaw) - reference.yaw),
+      };
+      for (int axis = 0; axis < 3; axis++) {
+        if (fabs(errors[axis]) > maxError[axis]) maxError[axis] = fabs(errors[axis]);
+      }
+    }
+    printf("%-6s %zu samples: max error vs double pitch %.4f, roll %.4f, yaw %.4f deg\n",
+           trace.name.c_str(), raw.size(), maxError[0], maxError[1], maxError[2]);
+    CHECK(maxError[0] < 0.05);
+    CHECK(maxError[1] < 0.05);
+    CHECK(maxError[2] < 0.05);
+  }
+}
+
+static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Итерации циклов fixedSqrt() для этого значения (вне замера)
+static int sqrtSteps(uint32_t value) {
+  int steps = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    steps++;
+    bit >>= 2;
+  }
+  return steps;
+}
+
+static void benchmark() {
+  Trace trace = synthesize(scenarios()[1], 2000, 5);
+  std::vector<RawSample> raw = rawTrace(trace);
+
+  FixedPointFilter fixedFilter(131, 8192);
+  ReferenceFilter reference;
+  volatile double sink = 0;
+
+  uint64_t start = ticks();
+  for (const RawSample &s : raw) fixedFilter.update(s.ax, s.ay, s.az, s.gx, s.gy, s.gz, 2000);
+  double fixedTicks = (double)(ticks() - start) / raw.size();
+  sink = sink + fixedFilter.pitch;
+
+  start = ticks();
+  for (const RawSample &s : raw) reference.update(s, 2000);
+  double referenceTicks = (double)(ticks() - start) / raw.size();
+  sink = sink + reference.pitch;
+
+  // Операции одного update(): 2 atan2 по 16 шагов CORDIC (2 сдвига и 3
+  // сложения/сравнения на шаг), 2 корня (шаги - по величине), 3 деления
+  // int64 в gyroDelta(), 2 смешивания с умножением int64
+  double sqrtTotal = 0;
+  for (const RawSample &s : raw) {
+    sqrtTotal += sqrtSteps((uint32_t)((int32_t)s.ay * s.ay) + (uint32_t)((int32_t)s.az * s.az));
+    sqrtTotal += sqrtSteps((uint32_t)((int32_t)s.ax * s.ax) + (uint32_t)((int32_t)s.ay * s.ay) +
+                           (uint32_t)((int32_t)s.az * s.az));
+  }
+  printf("update(): fixed %.0f, double %.0f %s/sample; fixed ops: 32 CORDIC steps, %.1f sqrt steps, "
+         "3 int64 div, 2 int64 mul; double: 2 atan2, 2 sqrt, ~25 mul/add/div\n",
+         fixedTicks, referenceTicks,
+#if defined(__x86_64__) || defined(__i386__)
+         "cycles",
+#else
+         "ns",
+#endif
+         sqrtTotal / raw.size());
+}
+
+int main() {
+  testAtan2();
+  testFilter();
+  benchmark();
+  return hostTestResult("fixed_point_filter_test");
+}
@@ -0,0 +1,73 @@
+/*
+  HttpCache::notModified() (AppRestApi5): разбор If-None-Match
+
+  - совпадающий тег, тег с префиксом W/ (слабое сравнение), "*";
+  - список тегов через запятую с пробелами и табуляцией, совпадение в
+    начале, середине и конце списка;
+  - запятая внутри тега в кавычках - часть тега, а не разделитель;
+  - пустой заголовок, nullptr, только пробелы и запятые;
+  - несовпадающий тег, тег-префикс и тег длиннее etag.
+*/
+
+#include <Arduino.h>
+
+#include "HostTest.h"
+#include "../../OLD/VR_ESP8266_ServerClient_v3/AppRestApi5/HttpCache.h"
+
+using HttpCache::notModified;
+
+static const char* ETAG = "\"5f3a-1c\"";
+
+static void testMatch() {
+  CHECK(notModified("\"5f3a-1c\"", ETAG));
+  CHECK(notModified("  \"5f3a-1c\"  ", ETAG));
+  CHECK(notModified("W/\"5f3a-1c\"", ETAG));
+  CHECK(notModified("*", ETAG));
+  CHECK(notModified(" * ", ETAG));
+}
+
+static void testList() {
+  CHECK(notModified("\"5f3a-1c\", \"old\"", ETAG));
+  CHECK(notModified("\"old\", \"5f3a-1c\", \"older\"", ETAG));
+  CHECK(notModified("\"old\",\t\"older\",W/\"5f3a-1c\"", ETAG));
+  CHECK(notModified("\"old\",,\"5f3a-1c\"", ETAG));
+  CHECK(notModified("\"old\", *", ETAG));
+  CHECK(!notModified("\"old\", \"older\"", ETAG));
+}
+
+static void testQuotedComma() {
+  const char* etag = "\"a,b\"";
+  CHECK(notModified("\"a,b\"", etag));
+  CHECK(notModified("\"x\", \"a,b\"", etag));
+  CHECK(notModified("W/\"a,b\", \"x\"", etag));
+  // "a,b" - один тег: ни "a", ни "b" не совпадают с ним
+  CHECK(!notModified("\"a\", \"b\"", etag));
+  CHECK(!notModified("\"a,b\"", "\"a\""));
+  CHECK(!notModified("\"a,b\"", "\"b\""));
+}
+
+static void testEmpty() {
+  CHECK(!notModified("", ETAG));
+  CHECK(!notModified(nullptr, ETAG));
+  CHECK(!notModified("   ", ETAG));
+  CHECK(!notModified(" , ,", ETAG));
+  CHECK(!notModified("\"5f3a-1c\"", nullptr));
+}
+
+static void testMismatch() {
+  CHECK(!notModified("\"5f3a-1d\"", ETAG));
+  CHECK(!notModified("\"5f3a\"", ETAG));            // префикс тега
+  CHECK(!notModified("\"5f3a-1c0\"", ETAG));        // длиннее
+  CHECK(!notModified("5f3a-1c", ETAG));             // без кавычек
+  CHECK(!notModified("W/\"5f3a-1d\"", ETAG));
+  CHECK(!notModified("\"5f3a-1c", ETAG));           // незакрытая кавычка
+}
+
+int main() {
+  testMatch();
+  testList();
+  testQuotedComma();
+  testEmpty();
+  testMismatch();
+  return hostTestResult("http_cache_test");
+}
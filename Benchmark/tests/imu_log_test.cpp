@@ -0,0 +1,231 @@
+/*
+  ImuLog.h (V7): ImuRecorder пишет лог в память, декодирует его
+  readImuLogHeader() и decodeImuLogBlock() - тот же код, что в прошивке
+
+  - CRC-32: контрольное значение "123456789", битый байт блока данных
+    выбрасывает только этот блок, битый заголовок не читается.
+  - Zigzag varint: граничные значения туда и обратно, длина в байтах,
+    обрезанный varint не читается.
+  - Запись: 60 с по 500 Гц с шумом, редкими скачками на весь диапазон
+    int16, дрожанием времени, пропуском 30 мс и переполнением micros();
+    после декодирования все отсчеты и времена совпадают, блоки по
+    IMU_LOG_BLOCK_SIZE с номерами подряд, хвост блока 0xFF, первый отсчет
+    блока - с полным временем.
+  - maxBytes: запись останавливается на целом блоке, файл не больше
+    предела.
+*/
+
+#include <Arduino.h>
+#include <random>
+#include <vector>
+
+#include "HostTest.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/ImuLog.h"
+
+// Файл в памяти вместо fs::File на LittleFS
+class MemoryFile {
+  public:
+    MemoryFile() : data(nullptr) {}
+    explicit MemoryFile(std::vector<uint8_t>* data) : data(data) {}
+    explicit operator bool() const { return data != nullptr; }
+    size_t write(const uint8_t* buf, size_t length) {
+      if (failWrites) return 0;
+      data->insert(data->end(), buf, buf + length);
+      return length;
+    }
+    void flush() { flushes++; }
+    void close() { data = nullptr; }
+
+    static inline bool failWrites = false;
+    static inline uint32_t flushes = 0;
+
+  private:
+    std::vector<uint8_t>* data;
+};
+
+class MemoryFs {
+  public:
+    MemoryFile open(const char* path, const char* mode) {
+      (void)path;
+      if (mode[0] == 'w') content.clear();
+      return MemoryFile(&content);
+    }
+    std::vector<uint8_t> content;
+};
+
+typedef ImuRecorder<MemoryFs, MemoryFile> Recorder;
+
+static const ImuLogHeader HEADER = {2000, 8192, 1310, {-12, 40, 7}};
+
+static void testCrc() {
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  CHECK(imuLogCrc32(check, sizeof(check)) == 0xCBF43926UL);
+  // По частям - как CRC блока: заголовок, затем payload
+  CHECK(imuLogCrc32(check + 4, 5, imuLogCrc32(check, 4)) == 0xCBF43926UL);
+}
+
+static void testVarint() {
+  const int32_t values[] = {0, 1, -1, 63, -64, 64, -65, 8191, -8192, 8192, 32767, -32768, 65535, -65535,
+                            INT32_MAX, INT32_MIN};
+  const uint8_t lengths[] = {1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 5, 5};
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    uint8_t buf[8];
+    uint8_t n = imuLogPutVarint(buf, values[i]);
+    int32_t back = 12345;
+    CHECK(n == lengths[i]);
+    CHECK(imuLogGetVarint(buf, buf + n, back) == n);
+    CHECK(back == values[i]);
+    // Обрезанный: последний байт за концом буфера
+    if (n > 1) CHECK(imuLogGetVarint(buf, buf + n - 1, back) == 0);
+  }
+}
+
+struct Recording {
+  MemoryFs fs;
+  std::vector<ImuLogSample> samples;
+};
+
+// Отсчеты с шумом, скачками, дрожанием времени, пропуском и переполнением micros()
+static void record(Recording &rec, Recorder &recorder, uint32_t seconds, uint32_t maxBytes) {
+  std::mt19937 rng(19);
+  std::normal_distribution<double> noise(0, 6);
+  std::uniform_int_distribution<int> jitter(-40, 40);
+  std::uniform_int_distribution<int> full(-32768, 32767);
+
+  CHECK(recorder.start(HEADER, maxBytes));
+  uint32_t t = 0xFFFFFFFFUL - 20000000UL;   // переполнение через 20 с
+  const int16_t base[7] = {120, -340, 8100, -2400, 15, -8, 3};
+  uint32_t count = seconds * 1000000 / HEADER.periodUs;
+  for (uint32_t i = 0; i < count && recorder.recording(); i++) {
+    t += HEADER.periodUs + jitter(rng);
+    if (i == 7000) t += 30000;               // флеш занят
+    int16_t v[7];
+    for (int k = 0; k < 7; k++) {
+      double value = base[k] + noise(rng) + 200 * sin(i / 300.0 + k);
+      v[k] = (int16_t)value;
+    }
+    if (i % 997 == 0) v[i % 7] = (int16_t)full(rng);
+    if (i == 4321) v[6] = -32768;
+    if (i == 4322) v[6] = 32767;
+    ImuLogSample s;
+    s.timeUs = t;
+    s.raw = {v[0], v[1], v[2], v[3], v[4], v[5], v[6]};
+    setHostMicros(t);
+    recorder.append(t, s.raw);
+    if (recorder.recording()) rec.samples.push_back(s);
+  }
+  recorder.stop();
+}
+
+static bool sameSample(const ImuLogSample &a, const ImuLogSample &b) {
+  return a.timeUs == b.timeUs && a.raw.ax == b.raw.ax && a.raw.ay == b.raw.ay && a.raw.az == b.raw.az &&
+         a.raw.temp == b.raw.temp && a.raw.gx == b.raw.gx && a.raw.gy == b.raw.gy && a.raw.gz == b.raw.gz;
+}
+
+// Все блоки данных; -1 в counts - блок не декодировался
+static std::vector<ImuLogSample> decode(const std::vector<uint8_t> &file, std::vector<int> &counts) {
+  std::vector<ImuLogSample> out;
+  ImuLogHeader header;
+  if (file.size() < IMU_LOG_BLOCK_SIZE || !readImuLogHeader(file.data(), header)) return out;
+  for (size_t offset = IMU_LOG_BLOCK_SIZE; offset + IMU_LOG_BLOCK_SIZE <= file.size(); offset += IMU_LOG_BLOCK_SIZE) {
+    counts.push_back(decodeImuLogBlock(file.data() + offset, header.periodUs,
+                                       [&](const ImuLogSample &s) { out.push_back(s); }));
+  }
+  return out;
+}
+
+static void testRoundTrip() {
+  Recording rec;
+  Recorder recorder(rec.fs, "/imu.log");
+  record(rec, recorder, 60, 4 * 1024 * 1024);
+  const std::vector<uint8_t> &file = rec.fs.content;
+
+  CHECK(!recorder.failed());
+  CHECK(!recorder.stoppedFull());
+  CHECK(recorder.samples() == rec.samples.size());
+  CHECK(recorder.gaps() == 1);
+  CHECK(file.size() % IMU_LOG_BLOCK_SIZE == 0);
+  CHECK(file.size() == (recorder.blocks() + 1) * IMU_LOG_BLOCK_SIZE);
+  CHECK(file.size() == recorder.bytes());
+  CHECK(MemoryFile::flushes == recorder.blocks() / IMU_LOG_SYNC_BLOCKS);
+
+  ImuLogHeader header;
+  CHECK(readImuLogHeader(file.data(), header));
+  CHECK(header.periodUs == HEADER.periodUs && header.accelLsbPerG == HEADER.accelLsbPerG);
+  CHECK(header.gyroOffset[0] == -12 && header.gyroOffset[1] == 40 && header.gyroOffset[2] == 7);
+
+  std::vector<int> counts;
+  std::vector<ImuLogSample> decoded = decode(file, counts);
+  CHECK(decoded.size() == rec.samples.size());
+  size_t mismatches = 0;
+  for (size_t i = 0; i < decoded.size() && i < rec.samples.size(); i++) {
+    if (!sameSample(decoded[i], rec.samples[i])) mismatches++;
+  }
+  CHECK(mismatches == 0);
+
+  // Границы блоков: номера подряд, полное время первого отсчета, хвост 0xFF
+  size_t first = 0, badBlocks = 0;
+  for (size_t b = 0; b < counts.size(); b++) {
+    const uint8_t* block = file.data() + (b + 1) * IMU_LOG_BLOCK_SIZE;
+    uint16_t length = imuLogGet16(block + 14);
+    bool ok = counts[b] > 0 && imuLogGet32(block + 4) == b && imuLogGet32(block + 8) == rec.samples[first].timeUs;
+    for (size_t i = IMU_LOG_BLOCK_HEADER + length; i < IMU_LOG_BLOCK_SIZE; i++) ok = ok && block[i] == 0xFF;
+    // Полный блок: следующий отсчет мог не влезть
+    if (b + 1 < counts.size()) ok = ok && IMU_LOG_BLOCK_HEADER + length + IMU_LOG_MAX_SAMPLE_BYTES > IMU_LOG_BLOCK_SIZE;
+    if (!ok) badBlocks++;
+    first += counts[b] > 0 ? counts[b] : 0;
+  }
+  CHECK(badBlocks == 0);
+
+  double bytesPerSample = (double)(file.size() - IMU_LOG_BLOCK_SIZE) / rec.samples.size();
+  printf("round trip: %zu samples in %u blocks, %.1f bytes per sample\n", rec.samples.size(),
+         recorder.blocks(), bytesPerSample);
+  CHECK(bytesPerSample < 14);
+
+  // Битый байт в блоке 3: теряется только он
+  std::vector<uint8_t> damaged = file;
+  damaged[4 * IMU_LOG_BLOCK_SIZE + IMU_LOG_BLOCK_HEADER + 10] ^= 0x01;
+  std::vector<int> damagedCounts;
+  std::vector<ImuLogSample> rest = decode(damaged, damagedCounts);
+  CHECK(damagedCounts.size() == counts.size());
+  CHECK(damagedCounts[3] == -1);
+  CHECK(rest.size() == decoded.size() - counts[3]);
+  // Битый заголовок блока (число отсчетов) тоже ловит CRC
+  damaged = file;
+  damaged[2 * IMU_LOG_BLOCK_SIZE + 12] ^= 0x02;
+  CHECK(decodeImuLogBlock(damaged.data() + 2 * IMU_LOG_BLOCK_SIZE, HEADER.periodUs, [](const ImuLogSample &) {}) == -1);
+
+  damaged = file;
+  damaged[9] ^= 0x80;
+  CHECK(!readImuLogHeader(damaged.data(), header));
+}
+
+static void testLimit() {
+  Recording rec;
+  Recorder recorder(rec.fs, "/imu.log");
+  const uint32_t maxBytes = 8 * IMU_LOG_BLOCK_SIZE;
+  record(rec, recorder, 60, maxBytes);
+  CHECK(recorder.stoppedFull());
+  CHECK(!recorder.recording());
+  CHECK(rec.fs.content.size() == maxBytes);
+
+  std::vector<int> counts;
+  std::vector<ImuLogSample> decoded = decode(rec.fs.content, counts);
+  CHECK(counts.size() == 7);
+  CHECK(decoded.size() == rec.samples.size());
+
+  // Запись во флеш не удалась: запись останавливается
+  Recording failing;
+  Recorder failed(failing.fs, "/imu.log");
+  MemoryFile::failWrites = true;
+  CHECK(!failed.start(HEADER, maxBytes));
+  MemoryFile::failWrites = false;
+}
+
+int main() {
+  testCrc();
+  testVarint();
+  testRoundTrip();
+  testLimit();
+  return hostTestResult("imu_log_test");
+}
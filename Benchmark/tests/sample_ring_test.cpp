@@ -0,0 +1,151 @@
+/*
+  SampleRing.h (Bluetooth_v5, MPU6050_WIFI, MPU6050_Serial - одинаковые
+  копии): OrientationDecimator и SampleRing
+
+  - Блок через +-180: 179.9 и -179.9 дают 180, а не 0; среднее за 180
+    (179.9 и -179.5) возвращается в -179.8, а не 180.2. Поворот по yaw
+    на много оборотов: каждый выход в +-180 и совпадает с истинным
+    средним блока.
+  - Время - среднее время блока, в том числе через переполнение micros().
+  - Два потока (как fusionTask и задача отправки на разных ядрах):
+    производитель пишет номера подряд, потребитель читает их строго по
+    возрастанию, прочитанные + сброшенные = записанные; сбросы - только
+    во всплесках без ожидания.
+*/
+
+#include <Arduino.h>
+#include <atomic>
+#include <thread>
+
+#include "HostTest.h"
+#include "../../Bluetooth_ESP32/V5/Bluetooth_v5/SampleRing.h"
+
+// Расстояние между углами по кругу, градусы
+static float angleError(float a, float b) {
+  float d = fmodf(fabsf(a - b), 360.0f);
+  return d > 180.0f ? 360.0f - d : d;
+}
+
+static bool inRange(const OrientationSample &s) {
+  return fabsf(s.pitch) <= 180.0f && fabsf(s.roll) <= 180.0f && fabsf(s.yaw) <= 180.0f;
+}
+
+static void testWrapBlock() {
+  OrientationDecimator decimator(2);
+  OrientationSample out;
+  CHECK(!decimator.add(1000, 0, 179.9f, 179.9f, out));
+  CHECK(decimator.add(2000, 0, -179.9f, -179.9f, out));
+  CHECK(inRange(out));
+  CHECK(angleError(out.yaw, 180.0f) < 0.001f);
+  CHECK(angleError(out.roll, 180.0f) < 0.001f);
+  CHECK(out.timestampUs == 1500);
+  CHECK(out.samples == 2);
+
+  // Среднее за +180
+  CHECK(!decimator.add(3000, 179.9f, 0, 179.9f, out));
+  CHECK(decimator.add(4000, -179.5f, 0, -179.5f, out));
+  CHECK(inRange(out));
+  CHECK(fabsf(out.yaw - -179.8f) < 0.001f);
+  CHECK(fabsf(out.pitch - -179.8f) < 0.001f);
+
+  // И в другую сторону
+  CHECK(!decimator.add(5000, 0, 0, -179.9f, out));
+  CHECK(decimator.add(6000, 0, 0, 179.5f, out));
+  CHECK(fabsf(out.yaw - 179.8f) < 0.001f);
+}
+
+static void testSpin() {
+  OrientationDecimator decimator(5);
+  OrientationSample out;
+  const float rate = 0.7f;                   // градусов на отсчет: ~700 °/с при 1 кГц
+  uint32_t t = 0xFFFFFFFFUL - 2000000UL;     // micros() переполнится через 2 с
+  int blocks = 0, outOfRange = 0, wrong = 0, badTime = 0;
+  double angle = 0, blockSum = 0;
+  uint32_t blockStart = 0;
+  for (int i = 0; i < 20000; i++) {
+    if (i % 5 == 0) {
+      blockSum = 0;
+      blockStart = t;
+    }
+    blockSum += angle;
+    float yaw = (float)remainder(angle, 360.0);
+    if (decimator.add(t, -yaw / 2, yaw / 3, yaw, out)) {
+      blocks++;
+      if (!inRange(out)) outOfRange++;
+      if (angleError(out.yaw, (float)remainder(blockSum / 5, 360.0)) > 0.01f) wrong++;
+      if (out.timestampUs != blockStart + 2000) badTime++;
+    }
+    angle += rate;
+    t += 1000;
+  }
+  CHECK(blocks == 4000);
+  CHECK(outOfRange == 0);
+  CHECK(wrong == 0);
+  CHECK(badTime == 0);
+
+  // setFactor() начинает новый блок
+  CHECK(!decimator.add(0, 0, 0, 10, out));
+  decimator.setFactor(1);
+  CHECK(decimator.add(0, 0, 0, 20, out));
+  CHECK(out.yaw == 20 && out.samples == 1);
+}
+
+static void testTwoThreads() {
+  const uint32_t total = 500000;
+  SampleRing<uint32_t, 64> ring;
+  std::atomic<bool> done(false);
+  uint32_t popped = 0, outOfOrder = 0;
+
+  std::thread consumer([&] {
+    uint32_t last = 0, value;
+    while (true) {
+      bool finished = done.load();
+      while (ring.pop(value)) {
+        if (popped > 0 && value <= last) outOfOrder++;
+        last = value;
+        popped++;
+      }
+      if (finished) break;
+      std::this_thread::yield();
+    }
+  });
+  for (uint32_t i = 1; i <= total; i++) {
+    // Обычно производитель не обгоняет потребителя (фьюжн идет по часам),
+    // каждый 32-й отрезок - всплеск без ожидания, со сбросами
+    if ((i >> 10) % 32 != 0) {
+      while (ring.available() >= 48) std::this_thread::yield();
+    }
+    ring.push(i);
+  }
+  done = true;
+  consumer.join();
+
+  printf("two threads: %u pushed, %u popped, %u dropped\n", total, popped, ring.dropped());
+  CHECK(outOfOrder == 0);
+  CHECK(popped + ring.dropped() == total);
+  CHECK(popped > total / 2);
+  CHECK(ring.available() == 0);
+
+  // popLatest(): остается самый новый
+  for (uint32_t i = 1; i <= 10; i++) ring.push(i);
+  uint32_t latest = 0;
+  CHECK(ring.popLatest(latest));
+  CHECK(latest == 10);
+  CHECK(!ring.popLatest(latest));
+
+  // Полное кольцо: новый отсчет сбрасывается, старые не трогаются
+  uint32_t dropsBefore = ring.dropped();
+  for (uint32_t i = 0; i < 64; i++) CHECK(ring.push(i));
+  CHECK(!ring.push(64));
+  CHECK(ring.dropped() == dropsBefore + 1);
+  uint32_t first = 99;
+  CHECK(ring.pop(first));
+  CHECK(first == 0);
+}
+
+int main() {
+  testWrapBlock();
+  testSpin();
+  testTwoThreads();
+  return hostTestResult("sample_ring_test");
+}
@@ -0,0 +1,285 @@
+/*
+  SendPolicy.h (V5, V7, Wifi_Head_MPU6050 - одинаковые копии):
+  PredictiveSendPolicy на синтетическом движении головы
+
+  Траектория - та же модель, что в send_policy_benchmark.py: 120 с по
+  250 Гц, сегменты покоя, плавных и резких поворотов и наклонов с
+  профилем minimum jerk и шумом 0.03°. Кадр доходит до клиента через
+  10 мс, по порядку; клиент показывает кадр + скорость * min(dt, 100 мс).
+  Скорости клиент получает так, как их везут кадры: в тексте/JSON с
+  шагом 0.1 °/с, в бинарном кадре - int8 по ORIENTATION_FRAME_RATE_STEP
+  (frameRate() из OrientationFrame.h).
+
+  Для сравнения - прежняя политика (кадр не чаще 50 мс и только при
+  изменении угла на CHANGE_THRESHOLD, клиент держит последний кадр).
+
+  - Прогноз с допуском 0.5° (как в скетчах) шлет меньше кадров, чем
+    прежняя политика с порогом 0.5°, и ошибка у клиента меньше (p95).
+  - Без задержки ошибка p99 у клиента - в пределах допуска плюс шаг
+    проверки (minInterval) и округление скорости в кадре.
+  - В покое при допуске от 1° кадры идут по keepalive (~4 в секунду).
+    При 0.25 и 0.5° шум датчика в оценке скорости (разность соседних
+    отсчетов, сглаживание 0.3) уже выводит прогноз из допуска: в покое
+    ~13 и ~5 кадров/с - это видно в таблице, а не скрыто моделью.
+  - Чем больше допуск, тем меньше кадров.
+
+  Аргумент - файл траектории CSV (<timestamp_us>,<pitch>,<roll>,<yaw>),
+  тогда только печатается таблица.
+*/
+
+#include <Arduino.h>
+#include <algorithm>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "HostTest.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/SendPolicy.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/OrientationFrame.h"
+
+static const uint32_t KEEPALIVE_US = 250000;
+static const uint32_t MIN_INTERVAL_US = 10000;
+static const uint32_t HORIZON_US = 100000;
+static const uint32_t SEND_INTERVAL_US = 50000;   // прежняя политика
+
+struct Pose {
+  uint32_t timestampUs;
+  float angles[3];
+};
+
+static float wrap180(float angle) {
+  while (angle > 180.0f) angle -= 360.0f;
+  while (angle < -180.0f) angle += 360.0f;
+  return angle;
+}
+
+// Движение головы: сегменты покоя, плавных и резких поворотов, наклоны
+static std::vector<Pose> syntheticTrace(double seconds, double rateHz, uint32_t seed) {
+  std::mt19937 rng(seed);
+  auto uniform = [&](double a, double b) { return std::uniform_real_distribution<double>(a, b)(rng); };
+  std::normal_distribution<double> noise(0, 0.03);
+  const char* kinds[] = {"still", "still", "slow", "slow", "fast", "tilt"};
+  uint32_t periodUs = (uint32_t)(1000000 / rateHz);
+  double pose[3] = {0, 0, 0};
+  uint64_t t = 0, end = (uint64_t)(seconds * 1000000);
+  std::vector<Pose> trace;
+
+  while (t < end) {
+    std::string kind = kinds[std::uniform_int_distribution<int>(0, 5)(rng)];
+    double length = kind != "fast" ? uniform(0.5, 3.0) : uniform(0.2, 0.6);
+    double start[3] = {pose[0], pose[1], pose[2]};
+    double target[3] = {pose[0], pose[1], pose[2]};
+    if (kind == "slow") {
+      target[2] += uniform(-60, 60);
+    } else if (kind == "fast") {
+      target[2] += (uniform(0, 1) < 0.5 ? -1 : 1) * uniform(40, 120);
+      target[0] += uniform(-15, 15);
+    } else if (kind == "tilt") {
+      target[0] = uniform(-35, 35);
+      target[1] = uniform(-20, 20);
+    }
+    int steps = std::max(1, (int)(length * rateHz));
+    for (int i = 1; i <= steps; i++) {
+      double s = (double)i / steps;
+      double k = 10 * s * s * s - 15 * s * s * s * s + 6 * s * s * s * s * s;
+      Pose p;
+      p.timestampUs = (uint32_t)t;
+      for (int axis = 0; axis < 3; axis++) {
+        pose[axis] = start[axis] + (target[axis] - start[axis]) * k;
+        p.angles[axis] = wrap180((float)(pose[axis] + noise(rng)));
+      }
+      trace.push_back(p);
+      t += periodUs;
+    }
+    for (int axis = 0; axis < 3; axis++) pose[axis] = wrap180((float)pose[axis]);
+  }
+  return trace;
+}
+
+static std::vector<Pose> loadTrace(const char* path) {
+  std::vector<Pose> trace;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    Pose p;
+    unsigned long ts;
+    if (sscanf(line.c_str(), "%lu,%f,%f,%f", &ts, &p.angles[0], &p.angles[1], &p.angles[2]) == 4) {
+      p.timestampUs = (uint32_t)ts;
+      trace.push_back(p);
+    }
+  }
+  return trace;
+}
+
+// Скорость так, как ее получит клиент
+enum RateEncoding { RATE_TEXT, RATE_BINARY, RATE_NONE };
+
+static float deliveredRate(float rate, RateEncoding encoding) {
+  switch (encoding) {
+    case RATE_TEXT: return roundf(rate * 10.0f) / 10.0f;
+    case RATE_BINARY: return frameRate(rate) * ORIENTATION_FRAME_RATE_STEP;
+    default: return 0;
+  }
+}
+
+struct Frame {
+  uint32_t arrivalUs;
+  float angles[3], rates[3];
+};
+
+struct Result {
+  double framesPerSecond;
+  double mean, p95, p99, max;
+  double stillFramesPerSecond;   // в сегментах покоя
+};
+
+// Общая часть прогона: политика решает, клиент показывает прогноз в каждый отсчет
+template <typename Policy>
+static Result replay(const std::vector<Pose> &trace, Policy policy, uint32_t latencyUs, uint32_t horizonUs,
+                     RateEncoding encoding) {
+  std::deque<Frame> inFlight;
+  Frame shown;
+  bool haveShown = false;
+  uint32_t frames = 0, stillFrames = 0, stillSamples = 0;
+  std::vector<double> errors;
+
+  for (size_t n = 0; n < trace.size(); n++) {
+    const Pose &pose = trace[n];
+    float rates[3];
+    bool sent = policy(pose, rates);
+    // Покой: поза не сдвинулась дальше шума за 0.5 с вокруг отсчета
+    bool still = n >= 62 && n + 62 < trace.size();
+    for (int axis = 0; still && axis < 3; axis++) {
+      still = fabsf(wrap180(trace[n + 62].angles[axis] - trace[n - 62].angles[axis])) < 0.3f;
+    }
+    if (still) stillSamples++;
+    if (sent) {
+      frames++;
+      if (still) stillFrames++;
+      Frame frame;
+      frame.arrivalUs = pose.timestampUs + latencyUs;
+      for (int axis = 0; axis < 3; axis++) {
+        frame.angles[axis] = pose.angles[axis];
+        frame.rates[axis] = deliveredRate(rates[axis], encoding);
+      }
+      inFlight.push_back(frame);
+    }
+    while (!inFlight.empty() && (int32_t)(pose.timestampUs - inFlight.front().arrivalUs) >= 0) {
+      shown = inFlight.front();
+      inFlight.pop_front();
+      haveShown = true;
+    }
+    if (!haveShown) continue;
+
+    uint32_t elapsed = pose.timestampUs - shown.arrivalUs;
+    float dt = std::min(elapsed, horizonUs) / 1000000.0f;
+    float worst = 0;
+    for (int axis = 0; axis < 3; axis++) {
+      worst = std::max(worst, fabsf(wrap180(pose.angles[axis] - (shown.angles[axis] + shown.rates[axis] * dt))));
+    }
+    errors.push_back(worst);
+  }
+
+  std::sort(errors.begin(), errors.end());
+  double seconds = (trace.back().timestampUs - trace.front().timestampUs) / 1e6;
+  Result r;
+  r.framesPerSecond = frames / seconds;
+  r.mean = 0;
+  for (double e : errors) r.mean += e;
+  r.mean /= errors.size();
+  r.p95 = errors[(size_t)(0.95 * (errors.size() - 1))];
+  r.p99 = errors[(size_t)(0.99 * (errors.size() - 1))];
+  r.max = errors.back();
+  r.stillFramesPerSecond = stillSamples ? stillFrames / (stillSamples * 0.004) : 0;
+  return r;
+}
+
+static Result predictive(const std::vector<Pose> &trace, float budget, uint32_t latencyUs, RateEncoding encoding) {
+  PredictiveSendPolicy policy(budget, KEEPALIVE_US, MIN_INTERVAL_US, HORIZON_US);
+  return replay(trace, [&policy](const Pose &p, float rates[3]) {
+    policy.observe(p.timestampUs, p.angles[0], p.angles[1], p.angles[2]);
+    if (!policy.due(p.timestampUs, p.angles[0], p.angles[1], p.angles[2])) return false;
+    for (uint8_t axis = 0; axis < 3; axis++) rates[axis] = policy.rate(axis);
+    policy.sent(p.timestampUs, p.angles[0], p.angles[1], p.angles[2]);
+    return true;
+  }, latencyUs, HORIZON_US, encoding);
+}
+
+// dataChanged() + SEND_INTERVAL прежних скетчей
+static Result threshold(const std::vector<Pose> &trace, float changeThreshold, uint32_t latencyUs) {
+  struct State {
+    bool haveSent = false;
+    uint32_t lastUs = 0;
+    float sent[3] = {0, 0, 0};
+  } state;
+  return replay(trace, [&state, changeThreshold](const Pose &p, float rates[3]) {
+    if (state.haveSent && p.timestampUs - state.lastUs < SEND_INTERVAL_US) return false;
+    bool changed = !state.haveSent;
+    for (int axis = 0; axis < 3; axis++) changed = changed || fabsf(p.angles[axis] - state.sent[axis]) >= changeThreshold;
+    if (!changed) return false;
+    for (int axis = 0; axis < 3; axis++) {
+      state.sent[axis] = p.angles[axis];
+      rates[axis] = 0;
+    }
+    state.lastUs = p.timestampUs;
+    state.haveSent = true;
+    return true;
+  }, latencyUs, 0, RATE_NONE);
+}
+
+static void print(const char* policy, const char* params, const Result &r) {
+  printf("%-11s %-20s %9.1f %8.3f %8.3f %8.3f %8.3f %9.1f\n", policy, params, r.framesPerSecond, r.mean, r.p95,
+         r.p99, r.max, r.stillFramesPerSecond);
+}
+
+int main(int argc, char** argv) {
+  std::vector<Pose> trace = argc > 1 ? loadTrace(argv[1]) : syntheticTrace(120, 250, 1);
+  if (trace.size() < 2) {
+    printf("no samples in %s\n", argv[1]);
+    return 1;
+  }
+
+  printf("%-11s %-20s %9s %8s %8s %8s %8s %9s\n", "policy", "params", "frames/s", "mean", "p95", "p99", "max",
+         "still f/s");
+  Result old05 = threshold(trace, 0.5f, 10000);
+  Result old10 = threshold(trace, 1.0f, 10000);
+  print("threshold", "0.5 deg", old05);
+  print("threshold", "1.0 deg", old10);
+
+  const float budgets[] = {0.25f, 0.5f, 1.0f, 2.0f};
+  Result text[4], binary[4];
+  char params[32];
+  for (int i = 0; i < 4; i++) {
+    text[i] = predictive(trace, budgets[i], 10000, RATE_TEXT);
+    binary[i] = predictive(trace, budgets[i], 10000, RATE_BINARY);
+    snprintf(params, sizeof(params), "%.2g deg, text", budgets[i]);
+    print("predictive", params, text[i]);
+    snprintf(params, sizeof(params), "%.2g deg, binary", budgets[i]);
+    print("predictive", params, binary[i]);
+  }
+  if (argc > 1) return 0;
+
+  // Скетчи: допуск 0.5°
+  CHECK(text[1].framesPerSecond < old05.framesPerSecond);
+  CHECK(text[1].p95 < old05.p95);
+  CHECK(binary[1].framesPerSecond < old05.framesPerSecond);
+  CHECK(binary[1].p95 < old05.p95);
+
+  // Без задержки: допуск + движение за minInterval + округление скорости
+  for (int i = 0; i < 4; i++) {
+    Result now = predictive(trace, budgets[i], 0, RATE_TEXT);
+    Result nowBinary = predictive(trace, budgets[i], 0, RATE_BINARY);
+    CHECK(now.p99 < budgets[i] + 0.5);
+    CHECK(nowBinary.p99 < budgets[i] + 0.5 + ORIENTATION_FRAME_RATE_STEP / 2 * HORIZON_US / 1e6);
+  }
+
+  for (int i = 0; i < 4; i++) {
+    // В покое - keepalive, но не реже
+    CHECK(text[i].stillFramesPerSecond > 1e6 / KEEPALIVE_US - 1);
+    if (budgets[i] >= 1.0f) CHECK(text[i].stillFramesPerSecond < 1e6 / KEEPALIVE_US + 1);
+    if (i > 0) CHECK(text[i].framesPerSecond < text[i - 1].framesPerSecond);
+    if (i > 0) CHECK(text[i].stillFramesPerSecond <= text[i - 1].stillFramesPerSecond);
+  }
+  return hostTestResult("send_policy_test");
+}
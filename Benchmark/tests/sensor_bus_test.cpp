@@ -0,0 +1,71 @@
+/*
+  Wifi_Head_MPU6050: один пакетный отсчет MPU6050 на проход loop()
+
+  loop() читает датчик один раз (readSensorSample()), а калибровка,
+  фильтр, взгляд и детектор покоя работают с тем же SensorSample.
+  Проверяется на имитации датчика (MockMPU6050 за Adafruit_MPU6050):
+    - за проход ровно одна транзакция записи (номер регистра 0x3B) и одно
+      чтение 14 байт - и во время калибровки, и после;
+    - датчик видит ровно два обращения по шине за проход, и оба - в
+      readSensorSample() из HeadTracker.h (тот же код, что в скетче);
+    - стадии HeadTracker сами на шину не ходят.
+*/
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_MPU6050.h>
+#include "HostTest.h"
+#include "ImuTrace.h"
+#include "MockMPU6050.h"
+#include "../../MPU6050_ESP8266_to_ESP32_I2C_v1/Wifi_Head_MPU6050/HeadTracker.h"
+
+int main() {
+  Trace trace = synthesize(scenarios()[1], 1000, 1);   // head: датчик в движении
+  MockMPU6050 sensor(trace);
+  Wire.attach(0x68, &sensor);
+  setHostMicros(0);
+
+  Adafruit_MPU6050 mpu;
+  CHECK(mpu.begin(0x68, &Wire));
+  mpu.setAccelerometerRange(MPU6050_RANGE_4_G);
+  mpu.setGyroRange(MPU6050_RANGE_250_DEG);
+  mpu.setFilterBandwidth(MPU6050_BAND_10_HZ);
+
+  HeadTracker tracker;
+  tracker.startCalibration(millis());
+
+  const int ticks = 1000;   // 3 с калибровки и 7 с работы при delay(10)
+  int badTicks = 0, stageTraffic = 0, sensorTicks = 0;
+  for (int tick = 0; tick < ticks; tick++) {
+    Wire.resetStats();
+    MockMPU6050Stats before = sensor.stats();
+
+    SensorSample sample;
+    readSensorSample(mpu, sample);
+    WireStats afterRead = Wire.stats();
+
+    if (!tracker.calibrated) {
+      tracker.calibrationStep(sample);
+    } else {
+      tracker.process(sample);
+    }
+    tracker.updateGaze(sample, false, 0, 0, 0);
+    tracker.checkIdle(sample);
+
+    const WireStats &stats = Wire.stats();
+    if (stats.writes != 1 || stats.reads != 1 || stats.bytesWritten != 1 || stats.bytesRead != 14 ||
+        sensor.stats().dataReads - before.dataReads != 1) {
+      badTicks++;
+    }
+    if (sensor.stats().transactions - before.transactions != 2) sensorTicks++;
+    if (stats.transactions() != afterRead.transactions()) stageTraffic++;
+    delay(10);
+  }
+
+  CHECK(tracker.calibrated);
+  CHECK(badTicks == 0);
+  CHECK(stageTraffic == 0);
+  CHECK(sensorTicks == 0);
+  printf("%d ticks, %u I2C transactions per tick\n", ticks, Wire.stats().transactions());
+  return hostTestResult("sensor_bus_test");
+}
@@ -0,0 +1,162 @@
+/*
+  StationaryDetector.h на трассах покоя, движения и вибрации
+
+  Три настройки детектора, как в скетчах:
+    v5      N = 256, °/с и g, 1 кГц            (BiasModelOrientation.h)
+    metric  N = 32, рад/с и м/с², 100 Гц      (V7 кватернион, V4, ESP8266)
+    raw     N = 32, LSB ±250°/с и ±4g, 100 Гц (V7 FixedHeadOrientation)
+
+  Трассы (ImuTrace.h, 1 кГц; для 100 Гц - каждый десятый отсчет):
+    still    - покой с прогревом: после заполнения окна почти все отсчеты
+               неподвижны, а trackGyroBias() сводит смещение к среднему
+               сырому гироскопу в конце трассы;
+    moving   - движения головы (head): неподвижных отсчетов нет;
+    vibrating - покой, но акселерометр дрожит 0.1 g на 25 Гц (машина,
+               ходьба на месте): нет;
+    slow     - медленный поворот по курсу 3 °/с без шума сверх датчика: нет.
+*/
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+#include "HostTest.h"
+#include "ImuTrace.h"
+#include "../../Bluetooth_ESP32/V5/Bluetooth_v5/StationaryDetector.h"
+
+// Отсчет в единицах настройки: гироскоп без смещения, акселерометр
+struct Reading {
+  float g[3], a[3];
+};
+
+struct Config {
+  const char* name;
+  uint32_t stride;        // Каждый stride-й отсчет трассы 1 кГц
+  float trackingRate;     // trackGyroBias() при покое
+  std::function<Reading(const ImuSample &)> convert;
+  std::function<bool(const Reading &)> detect;
+  std::function<void()> reset;
+};
+
+struct RunResult {
+  uint32_t samples = 0, stationary = 0;
+  float bias[3] = {0, 0, 0};       // Конечное смещение в единицах настройки
+  float rawMean[3] = {0, 0, 0};    // Средний сырой гироскоп за последние 2 с, те же единицы
+};
+
+static RunResult run(const Config &config, const Trace &trace, double fromS) {
+  RunResult result;
+  config.reset();
+
+  // Калибровка: среднее первой секунды (трасса в покое до TRACE_SETTLE_S)
+  uint32_t calibrationSamples = 0;
+  for (size_t i = 0; i < trace.samples.size() && trace.samples[i].tUs < 1000000; i += config.stride) {
+    Reading r = config.convert(trace.samples[i]);
+    for (int axis = 0; axis < 3; axis++) result.bias[axis] += r.g[axis];
+    calibrationSamples++;
+  }
+  for (int axis = 0; axis < 3; axis++) result.bias[axis] /= calibrationSamples;
+
+  uint32_t tailSamples = 0;
+  for (size_t i = 0; i < trace.samples.size(); i += config.stride) {
+    const ImuSample &s = trace.samples[i];
+    Reading r = config.convert(s);
+    if (s.tUs + 2000000 >= trace.endUs()) {
+      for (int axis = 0; axis < 3; axis++) result.rawMean[axis] += r.g[axis];
+      tailSamples++;
+    }
+    for (int axis = 0; axis < 3; axis++) r.g[axis] -= result.bias[axis];
+    bool stationary = config.detect(r);
+    if (stationary) {
+      trackGyroBias(result.bias[0], result.bias[1], result.bias[2], r.g[0], r.g[1], r.g[2], config.trackingRate);
+    }
+    if (s.tUs >= fromS * 1e6) {
+      result.samples++;
+      if (stationary) result.stationary++;
+    }
+  }
+  for (int axis = 0; axis < 3; axis++) result.rawMean[axis] /= tailSamples;
+  return result;
+}
+
+// Покой с дрожащим акселерометром
+static Trace vibrating(const Trace &still) {
+  Trace trace = still;
+  trace.name = "vibrating";
+  for (ImuSample &s : trace.samples) {
+    double t = s.tUs / 1e6;
+    if (t < TRACE_SETTLE_S) continue;
+    s.accel[2] += 0.1f * sin(2 * PI * 25 * t);
+    s.accel[0] += 0.03f * sin(2 * PI * 25 * t + 1.0);
+  }
+  return trace;
+}
+
+// Покой и поворот по курсу с постоянной скоростью
+static Trace slowTurn(const Trace &still, float degPerS) {
+  Trace trace = still;
+  trace.name = "slow";
+  for (ImuSample &s : trace.samples) {
+    if (s.tUs >= TRACE_SETTLE_S * 1e6) s.gyro[2] += degPerS;
+  }
+  return trace;
+}
+
+int main() {
+  std::vector<Scenario> list = scenarios();
+  Trace still = synthesize(list[0], 1000, 21);
+  Trace moving = synthesize(list[1], 1000, 22);
+  Trace shaking = vibrating(still);
+  Trace slow = slowTurn(still, 3.0f);
+
+  StationaryDetector<256> v5Detector{0.6, 1.0, 0.02};
+  StationaryDetector<32> metricDetector{0.01, 0.02, 0.2};
+  StationaryDetector<32> rawDetector{80, 150, 164};
+
+  const float G = 9.80665f;
+  std::vector<Config> configs = {
+    {"v5", 1, 0.0002f,
+     [](const ImuSample &s) {
+       return Reading{{s.gyro[0], s.gyro[1], s.gyro[2]}, {s.accel[0], s.accel[1], s.accel[2]}};
+     },
+     [&](const Reading &r) { return v5Detector.update(r.g[0], r.g[1], r.g[2], r.a[0], r.a[1], r.a[2]); },
+     [&]() { v5Detector.reset(); }},
+    {"metric", 10, 0.002f,
+     [G](const ImuSample &s) {
+       return Reading{{s.gyro[0] * (float)DEG_TO_RAD, s.gyro[1] * (float)DEG_TO_RAD, s.gyro[2] * (float)DEG_TO_RAD},
+                      {s.accel[0] * G, s.accel[1] * G, s.accel[2] * G}};
+     },
+     [&](const Reading &r) { return metricDetector.update(r.g[0], r.g[1], r.g[2], r.a[0], r.a[1], r.a[2]); },
+     [&]() { metricDetector.reset(); }},
+    {"raw", 10, 0.002f,
+     [](const ImuSample &s) {
+       return Reading{{roundf(s.gyro[0] * 131), roundf(s.gyro[1] * 131), roundf(s.gyro[2] * 131)},
+                      {roundf(s.accel[0] * 8192), roundf(s.accel[1] * 8192), roundf(s.accel[2] * 8192)}};
+     },
+     [&](const Reading &r) { return rawDetector.update(r.g[0], r.g[1], r.g[2], r.a[0], r.a[1], r.a[2]); },
+     [&]() { rawDetector.reset(); }},
+  };
+
+  for (const Config &config : configs) {
+    // Окно заполняется за 0.26-0.32 с: считаем с 1 с
+    RunResult r = run(config, still, 1.0);
+    double fraction = (double)r.stationary / r.samples;
+    double gyroUnit = fabs(config.convert(ImuSample{0, {0, 0, 0}, {1, 0, 0}, 0, {0, 0, 0}}).g[0]);   // 1 °/с
+    double biasError = 0;
+    for (int axis = 0; axis < 3; axis++) biasError = fmax(biasError, fabs(r.bias[axis] - r.rawMean[axis]) / gyroUnit);
+    printf("%-7s still     %5.1f%% stationary, bias error %.3f deg/s\n", config.name, 100 * fraction, biasError);
+    CHECK(fraction > 0.95);
+    CHECK(biasError < 0.05);
+
+    const std::pair<const char*, const Trace*> rejected[] = {{"moving", &moving}, {"vibrating", &shaking},
+                                                            {"slow", &slow}};
+    for (const auto &entry : rejected) {
+      // После TRACE_SETTLE_S плюс окно
+      RunResult m = run(config, *entry.second, TRACE_SETTLE_S + 0.5);
+      printf("%-7s %-9s %5.1f%% stationary (%u of %u)\n", config.name, entry.first,
+             100.0 * m.stationary / m.samples, m.stationary, m.samples);
+      CHECK(m.stationary * 100 < m.samples);
+    }
+  }
+  return hostTestResult("stationary_detector_test");
+}
@@ -0,0 +1,300 @@
+/*
+  TelemetryFormat.h: TelemetryBuffer::fixed() против String(value, n)
+
+  - Побайтно: на случайных float и double, на сетке k/10^n, на точных
+    ничьих округления (x.5 в последнем знаке) и их соседях, на больших
+    значениях вывод fixed() совпадает с String(value, n) (dtostrf ядра) без
+    ведущих пробелов, которыми String дополняет n = 0.
+  - Особые значения: nan, inf, ovf, -0.00 для малых отрицательных.
+  - Замер: нс на вызов для fixed(), прежнего цикла в double (как
+    Print::printFloat) и String(value, n). На ПК double аппаратный, и все
+    три близки; на ESP8266 каждая операция с double - вызов libgcc.
+    fixed(v, n) делает одно умножение, одно сложение и два преобразования
+    при любом n, прежний цикл - n делений, сложение и по умножению,
+    вычитанию и два преобразования на каждый знак.
+  - Сообщение целиком: строка данных Bluetooth_v5 (SENSOR_DATA_FIELDS и
+    хвост formatSensorData()) через TelemetryMessage и прежней склейкой
+    "PITCH:" + String(...) + ...; те же байты, нс и выделения памяти на
+    сообщение. Выделения считаются подменой malloc() (через нее идут
+    operator new и String); у форматтера их нет.
+*/
+
+#include <Arduino.h>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "HostTest.h"
+#include "../../Bluetooth_ESP32/V5/Bluetooth_v5/TelemetryFormat.h"
+
+// Счетчик выделений памяти за весь процесс: malloc() glibc с подсчетом
+extern "C" void* __libc_malloc(size_t size);
+static size_t allocations = 0;
+
+extern "C" void* malloc(size_t size) {
+  allocations++;
+  return __libc_malloc(size);
+}
+
+static std::string viaString(double value, uint8_t decimals) {
+  String s(value, decimals);
+  const char* p = s.c_str();
+  while (*p == ' ') p++;
+  return p;
+}
+
+static std::string viaFixed(double value, uint8_t decimals) {
+  TelemetryMessage<40> msg;
+  msg.fixed(value, decimals);
+  return msg.c_str();
+}
+
+// Прежний TelemetryBuffer::fixed(): округление и цифры в double
+static void legacyFixed(TelemetryBuffer& out, double value, uint8_t decimals) {
+  if (value < 0.0) {
+    out.character('-');
+    value = -value;
+  }
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < decimals; i++) rounding /= 10.0;
+  value += rounding;
+  unsigned long integerPart = (unsigned long)value;
+  out.number(integerPart);
+  if (decimals == 0) return;
+  out.character('.');
+  double remainder = value - (double)integerPart;
+  while (decimals-- > 0) {
+    remainder *= 10.0;
+    uint8_t digit = (uint8_t)remainder;
+    out.character('0' + digit);
+    remainder -= digit;
+  }
+}
+
+static int mismatches = 0;
+
+static void compare(double value, uint8_t decimals) {
+  std::string expected = viaString(value, decimals);
+  std::string actual = viaFixed(value, decimals);
+  if (expected != actual) {
+    if (mismatches < 10) {
+      printf("  %.17g, %u: String \"%s\", fixed \"%s\"\n", value, decimals, expected.c_str(), actual.c_str());
+    }
+    mismatches++;
+  }
+}
+
+static void testSpecialValues() {
+  CHECK(viaFixed(0.0, 2) == "0.00");
+  CHECK(viaFixed(-0.001, 2) == "-0.00");
+  CHECK(viaFixed(12.345f, 2) == viaString(12.345f, 2));
+  CHECK(viaFixed(5.3, 0) == "5");               // String: " 5"
+  CHECK(viaFixed(-179.95, 1) == viaString(-179.95, 1));
+  CHECK(viaFixed(1e9, 2) == viaString(1e9, 2));  // 10^11 не влезает в uint32
+  CHECK(viaFixed(NAN, 2) == "nan");
+  CHECK(viaFixed(INFINITY, 2) == "inf");
+  CHECK(viaFixed(5e9, 2) == "ovf");
+  CHECK(viaFixed(-5e9, 2) == "ovf");
+
+  TelemetryMessage<8> small;
+  small.fixed(-123.456, 3);
+  CHECK(small.overflow());
+  CHECK(strcmp(small.c_str(), "-123.45") == 0);
+}
+
+static void testByteIdentity() {
+  std::mt19937_64 rng(4);
+  std::uniform_real_distribution<double> angle(-400.0, 400.0);
+  std::uniform_real_distribution<double> wide(-4e6, 4e6);
+  long compared = 0;
+
+  for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+    double scale = pow(10.0, decimals);
+    std::uniform_int_distribution<long> units(-(long)(400 * scale), (long)(400 * scale));
+    for (int i = 0; i < 200000; i++) {
+      compare((float)angle(rng), decimals);
+      compare(angle(rng), decimals);
+      compare((float)wide(rng), decimals);
+      // Сетка: ровно k/10^n, как после предыдущего округления
+      double grid = units(rng) / scale;
+      compare(grid, decimals);
+      compare((float)grid, decimals);
+      // Ничья и соседи по обе стороны
+      double tie = (units(rng) + 0.5) / scale;
+      compare(tie, decimals);
+      compare(nextafter(tie, 1e300), decimals);
+      compare(nextafter(tie, -1e300), decimals);
+      compare((float)tie, decimals);
+      compared += 9;
+    }
+  }
+  // Двоичные ничьи (x.25, x.125, ...) - точные в float
+  for (int k = -40000; k <= 40000; k++) {
+    compare(k / 8.0, 1);
+    compare(k / 8.0, 2);
+    compare(k / 32.0, 4);
+    compared += 3;
+  }
+  // Крупные значения вплоть до ovf
+  for (int i = 0; i < 100000; i++) {
+    double big = std::uniform_real_distribution<double>(-4294967040.0, 4294967040.0)(rng);
+    compare(big, i % 10);
+    compared++;
+  }
+
+  printf("byte identity: %ld values, %d mismatches\n", compared, mismatches);
+  CHECK(mismatches == 0);
+}
+
+template <typename F>
+static double nsPerCall(const std::vector<double>& values, F format) {
+  auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < 20; repeat++) {
+    for (double v : values) format(v);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / (20.0 * values.size());
+}
+
+static void benchmark() {
+  std::mt19937 rng(9);
+  std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+  std::vector<double> values(50000);
+  for (double& v : values) v = angle(rng);
+
+  size_t sink = 0;
+  TelemetryMessage<32> msg;
+  double fixedNs = nsPerCall(values, [&](double v) {
+    msg.clear();
+    msg.fixed(v, 2);
+    sink += msg.length();
+  });
+  double legacyNs = nsPerCall(values, [&](double v) {
+    msg.clear();
+    legacyFixed(msg, v, 2);
+    sink += msg.length();
+  });
+  double stringNs = nsPerCall(values, [&](double v) {
+    String s(v, 2);
+    sink += s.length();
+  });
+  printf("fixed(v, 2): %.1f ns, прежний цикл в double: %.1f ns, String(v, 2): %.1f ns  (%zu)\n",
+         fixedNs, legacyNs, stringNs, sink);
+}
+
+// Как SENSOR_DATA_FIELDS в Bluetooth_v5.ino
+static const TelemetryField SENSOR_DATA_FIELDS[] = {
+  {"PITCH:", 1}, {",ROLL:", 1}, {",YAW:", 1},
+  {",REL_PITCH:", 2}, {",REL_ROLL:", 2}, {",REL_YAW:", 2},
+  {",ACC_PITCH:", 2}, {",ACC_ROLL:", 2}, {",ACC_YAW:", 2}
+};
+
+struct SensorData {
+  double angles[9];     // display, rel, acc
+  bool zeroSet;
+  unsigned long seq, ts;
+  float rates[3];
+};
+
+// Тело formatSensorData()
+static void formatMessage(TelemetryBuffer &out, const SensorData &d) {
+  out.clear();
+  out.fields(SENSOR_DATA_FIELDS, d.angles)
+     .text(",ZERO_SET:").boolean(d.zeroSet)
+     .text(",UNLIMITED:true")
+     .text(",SEQ:").number(d.seq)
+     .text(",TS:").number(d.ts)
+     .text(",RATE_P:").fixed(d.rates[0], 1)
+     .text(",RATE_R:").fixed(d.rates[1], 1)
+     .text(",RATE_Y:").fixed(d.rates[2], 1);
+}
+
+// Прежний getSensorDataString() с тем же хвостом
+static String legacyMessage(const SensorData &d) {
+  return "PITCH:" + String(d.angles[0], 1) +
+         ",ROLL:" + String(d.angles[1], 1) +
+         ",YAW:" + String(d.angles[2], 1) +
+         ",REL_PITCH:" + String(d.angles[3], 2) +
+         ",REL_ROLL:" + String(d.angles[4], 2) +
+         ",REL_YAW:" + String(d.angles[5], 2) +
+         ",ACC_PITCH:" + String(d.angles[6], 2) +
+         ",ACC_ROLL:" + String(d.angles[7], 2) +
+         ",ACC_YAW:" + String(d.angles[8], 2) +
+         ",ZERO_SET:" + String(d.zeroSet ? "true" : "false") +
+         ",UNLIMITED:true" +
+         ",SEQ:" + String(d.seq) +
+         ",TS:" + String(d.ts) +
+         ",RATE_P:" + String(d.rates[0], 1) +
+         ",RATE_R:" + String(d.rates[1], 1) +
+         ",RATE_Y:" + String(d.rates[2], 1);
+}
+
+static void benchmarkMessage() {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+  std::uniform_real_distribution<double> accumulated(-2000.0, 2000.0);
+  std::uniform_real_distribution<float> rate(-300.0f, 300.0f);
+  std::vector<SensorData> data(20000);
+  for (size_t i = 0; i < data.size(); i++) {
+    SensorData &d = data[i];
+    for (int k = 0; k < 6; k++) d.angles[k] = angle(rng);
+    for (int k = 6; k < 9; k++) d.angles[k] = accumulated(rng);
+    d.zeroSet = i % 2;
+    d.seq = i + 1;
+    d.ts = 4000000000UL + i * 1000;
+    for (float &r : d.rates) r = rate(rng);
+  }
+
+  static TelemetryMessage<256> msg;
+  int different = 0;
+  for (const SensorData &d : data) {
+    formatMessage(msg, d);
+    if (msg.overflow() || legacyMessage(d) != msg.c_str()) different++;
+  }
+  printf("message: %zu values, %d differ from the String path\n", data.size(), different);
+  CHECK(different == 0);
+
+  const int REPEATS = 10;
+  const double messages = (double)REPEATS * data.size();
+  size_t sink = 0;
+
+  size_t allocationsBefore = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < REPEATS; repeat++) {
+    for (const SensorData &d : data) {
+      formatMessage(msg, d);
+      sink += msg.length();
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  double formatterNs = std::chrono::duration<double, std::nano>(end - start).count() / messages;
+  double formatterAllocs = (allocations - allocationsBefore) / messages;
+
+  allocationsBefore = allocations;
+  start = std::chrono::steady_clock::now();
+  for (int repeat = 0; repeat < REPEATS; repeat++) {
+    for (const SensorData &d : data) {
+      String s = legacyMessage(d);
+      sink += s.length();
+    }
+  }
+  end = std::chrono::steady_clock::now();
+  double stringNs = std::chrono::duration<double, std::nano>(end - start).count() / messages;
+  double stringAllocs = (allocations - allocationsBefore) / messages;
+
+  printf("%-22s %10s %12s\n", "sensor data message", "ns/msg", "allocs/msg");
+  printf("%-22s %10.1f %12.2f\n", "TelemetryMessage", formatterNs, formatterAllocs);
+  printf("%-22s %10.1f %12.2f  (%zu)\n", "String concatenation", stringNs, stringAllocs, sink);
+  CHECK(formatterAllocs == 0);
+  CHECK(stringAllocs > 0);
+}
+
+int main() {
+  testSpecialValues();
+  testByteIdentity();
+  benchmark();
+  benchmarkMessage();
+  return hostTestResult("telemetry_format_test");
+}
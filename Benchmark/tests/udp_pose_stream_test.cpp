@@ -0,0 +1,137 @@
+/*
+  UdpPoseStream.h (V7 и Wifi_Head_MPU6050 - одинаковые копии) на
+  поддельном WiFiUdp.h
+
+  - Аренда: без продления подписчик уходит через UDP_POSE_LEASE_MS,
+    повторная подписка продлевает; через переполнение millis() тоже.
+  - Таблица: UDP_POSE_MAX_SUBSCRIBERS мест, лишний не добавляется,
+    продление при полной таблице проходит; порт 0 не подписывается.
+  - unsubscribe(ip, 0) снимает все подписки этого ip и только их.
+  - send(): по датаграмме с тем же кадром на каждого подписчика и на
+    группу multicast.
+  - Сбои: beginPacket(), endPacket() и короткий write() считаются в
+    failedPackets(); после короткой записи пакет закрыт (hostAbandoned),
+    и следующий кадр уходит целым.
+*/
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <vector>
+
+#include "HostTest.h"
+#include "../../Bluetooth_ESP32/V7/Wifi_Head_MPU6050_ESP8266_V7/UdpPoseStream.h"
+
+static const IPAddress PHONE(192, 168, 4, 2);
+static const IPAddress LAPTOP(192, 168, 4, 3);
+
+static void testLease() {
+  WiFiUDP udp;
+  UdpPoseStream<WiFiUDP> stream(udp, 4211);
+  stream.begin();
+  CHECK(udp.localPort == 4211);
+  CHECK(!stream.active());
+
+  CHECK(stream.subscribe(PHONE, 4210, 1000));
+  CHECK(stream.active());
+  stream.expire(1000 + UDP_POSE_LEASE_MS);
+  CHECK(stream.subscriberCount() == 1);
+  // Продление за 1 мс до конца аренды
+  CHECK(stream.subscribe(PHONE, 4210, 1000 + UDP_POSE_LEASE_MS - 1));
+  CHECK(stream.subscriberCount() == 1);
+  stream.expire(1000 + 2 * UDP_POSE_LEASE_MS - 1);
+  CHECK(stream.subscriberCount() == 1);
+  stream.expire(1000 + 2 * UDP_POSE_LEASE_MS);
+  CHECK(stream.subscriberCount() == 0);
+  CHECK(!stream.active());
+
+  // Аренда через переполнение millis()
+  CHECK(stream.subscribe(LAPTOP, 5000, 0xFFFFFFFFUL - 1000));
+  stream.expire(10000);
+  CHECK(stream.subscriberCount() == 1);
+  stream.expire(UDP_POSE_LEASE_MS);
+  CHECK(stream.subscriberCount() == 0);
+}
+
+static void testTable() {
+  WiFiUDP udp;
+  UdpPoseStream<WiFiUDP> stream(udp, 4211);
+  CHECK(!stream.subscribe(PHONE, 0, 0));
+  for (uint16_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) CHECK(stream.subscribe(PHONE, 4210 + i, 0));
+  CHECK(!stream.subscribe(LAPTOP, 4210, 0));
+  CHECK(stream.subscribe(PHONE, 4210, 100));   // продление при полной таблице
+  CHECK(stream.subscriberCount() == UDP_POSE_MAX_SUBSCRIBERS);
+
+  // Освободилось одно место
+  CHECK(stream.unsubscribe(PHONE, 4211) == 1);
+  CHECK(stream.unsubscribe(PHONE, 4211) == 0);
+  CHECK(stream.subscribe(LAPTOP, 4210, 0));
+
+  // port == 0: все подписки PHONE, LAPTOP остается
+  CHECK(stream.unsubscribe(PHONE, 0) == UDP_POSE_MAX_SUBSCRIBERS - 1);
+  CHECK(stream.subscriberCount() == 1);
+  CHECK(stream.unsubscribe(PHONE, 0) == 0);
+  CHECK(stream.unsubscribe(LAPTOP, 0) == 1);
+  CHECK(!stream.active());
+}
+
+static void testSend() {
+  WiFiUDP udp;
+  UdpPoseStream<WiFiUDP> stream(udp, 4211);
+  std::vector<HostUdpPacket> sent;
+  udp.hostOnSend = [&sent](const HostUdpPacket &packet) { sent.push_back(packet); };
+
+  uint8_t frame[31];
+  for (uint8_t i = 0; i < sizeof(frame); i++) frame[i] = 0xA5 ^ i;
+  const std::vector<uint8_t> expected(frame, frame + sizeof(frame));
+
+  stream.subscribe(PHONE, 4210, 0);
+  stream.subscribe(LAPTOP, 4300, 0);
+  stream.setMulticast(IPAddress(239, 1, 2, 3), 4400, IPAddress(192, 168, 4, 1));
+  CHECK(stream.multicastEnabled());
+  stream.send(frame, sizeof(frame));
+  CHECK(sent.size() == 3);
+  CHECK(stream.sentPackets() == 3 && stream.failedPackets() == 0);
+  bool samePayload = true;
+  for (const HostUdpPacket &packet : sent) samePayload = samePayload && packet.data == expected;
+  CHECK(samePayload);
+  CHECK(sent[0].ip == PHONE && sent[0].port == 4210);
+  CHECK(sent[1].ip == LAPTOP && sent[1].port == 4300);
+  CHECK(sent[2].ip == IPAddress(239, 1, 2, 3) && sent[2].port == 4400);
+
+  stream.clearMulticast();
+  sent.clear();
+
+  // beginPacket() не прошел: пакета нет, сбой посчитан
+  udp.hostBeginFails = true;
+  stream.send(frame, sizeof(frame));
+  udp.hostBeginFails = false;
+  CHECK(stream.failedPackets() == 2);
+
+  // endPacket() не прошел
+  udp.hostEndFails = true;
+  stream.send(frame, sizeof(frame));
+  udp.hostEndFails = false;
+  CHECK(stream.failedPackets() == 4);
+
+  // Короткая запись: сбой, пакет закрыт, а не брошен открытым
+  udp.hostWriteLimit = 10;
+  stream.send(frame, sizeof(frame));
+  udp.hostWriteLimit = (size_t)-1;
+  CHECK(stream.failedPackets() == 6);
+  CHECK(stream.sentPackets() == 3);
+  CHECK(udp.hostAbandoned == 0);
+
+  // Следующий кадр - целый, без остатка прежнего
+  sent.clear();
+  stream.send(frame, sizeof(frame));
+  CHECK(udp.hostAbandoned == 0);
+  CHECK(stream.sentPackets() == 5);
+  CHECK(sent.size() == 2 && sent[0].data == expected && sent[1].data == expected);
+}
+
+int main() {
+  testLease();
+  testTable();
+  testSend();
+  return hostTestResult("udp_pose_stream_test");
+}
@@ -0,0 +1,245 @@
+/*
+  WiFiJobs.h (AppRestApi5) на поддельном драйвере ESP8266WiFi.h
+
+  - Подключение: begin() с теми ssid/паролем, ожидание, WL_CONNECTED ->
+    connected; WL_CONNECT_FAILED и WL_NO_SSID_AVAIL -> failed; пустой ssid
+    не запускается; disconnect() -> idle.
+  - Таймаут: за 1 мс до таймаута еще connecting, на таймауте - failed;
+    свой таймаут в startConnect().
+  - Позднее подключение: ядро дозвонилось после таймаута -> connected;
+    точка доступа пропала -> снова connecting и новый отсчет таймаута.
+  - Скан: асинхронный запуск, опрос до конца, число сетей; повторный запуск
+    во время скана ничего не делает; отказ при запуске и во время скана.
+  - Бюджет update(): поддельные часы не двигаются (ни delay(), ни ожидания),
+    за вызов не больше одного status() и одного scanComplete(), время вызова
+    на ПК - доли микросекунды.
+*/
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "HostTest.h"
+#include "../../OLD/VR_ESP8266_ServerClient_v3/AppRestApi5/WiFiJobs.h"
+
+typedef WiFiJobs<ESP8266WiFiClass> Jobs;
+
+// Смены состояния из onChange
+struct Changes {
+  int connect = 0, scan = 0;
+};
+
+static void watch(Jobs &jobs, Changes &changes) {
+  jobs.onChange([&changes](bool connectChanged) {
+    if (connectChanged) changes.connect++;
+    else changes.scan++;
+  });
+}
+
+static void testConnect() {
+  ESP8266WiFiClass wifi;
+  Jobs jobs(wifi);
+  Changes changes;
+  watch(jobs, changes);
+
+  CHECK(!jobs.startConnect("", "secret", 0));
+  CHECK(!jobs.startConnect(nullptr, "secret", 0));
+  CHECK(wifi.beginCalls == 0);
+
+  CHECK(jobs.startConnect("HomeNet", "secret", 1000));
+  CHECK(wifi.beginCalls == 1);
+  CHECK(wifi.lastSsid == "HomeNet");
+  CHECK(wifi.lastPassword == "secret");
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  CHECK(changes.connect == 1);
+
+  jobs.update(1500);
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  CHECK(jobs.connectElapsedMs(1500) == 500);
+
+  wifi.hostStatus = WL_CONNECTED;
+  jobs.update(2000);
+  CHECK(jobs.connectState() == Jobs::CONNECT_OK);
+  CHECK(changes.connect == 2);
+  CHECK(jobs.connectElapsedMs(2000) == 0);
+
+  // Без смены состояния onChange не вызывается
+  jobs.update(2100);
+  CHECK(changes.connect == 2);
+
+  jobs.disconnect();
+  CHECK(wifi.disconnectCalls == 1);
+  CHECK(jobs.connectState() == Jobs::CONNECT_IDLE);
+  CHECK(changes.connect == 3);
+
+  const wl_status_t failures[] = {WL_CONNECT_FAILED, WL_NO_SSID_AVAIL};
+  for (wl_status_t failure : failures) {
+    jobs.startConnect("HomeNet", "wrong", 3000);
+    wifi.hostStatus = failure;
+    jobs.update(3100);
+    CHECK(jobs.connectState() == Jobs::CONNECT_FAILED);
+  }
+  CHECK(strcmp(Jobs::connectStateName(jobs.connectState()), "failed") == 0);
+}
+
+static void testTimeout() {
+  ESP8266WiFiClass wifi;
+  Jobs jobs(wifi);
+
+  jobs.startConnect("SlowNet", "secret", 5000);
+  jobs.update(5000 + Jobs::DEFAULT_CONNECT_TIMEOUT_MS - 1);
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  jobs.update(5000 + Jobs::DEFAULT_CONNECT_TIMEOUT_MS);
+  CHECK(jobs.connectState() == Jobs::CONNECT_FAILED);
+
+  // Свой таймаут и переполнение millis()
+  unsigned long start = 0xFFFFFFFFUL - 1000;
+  jobs.startConnect("SlowNet", "secret", start, 3000);
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  jobs.update(start + 2999);
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  jobs.update(start + 3000);
+  CHECK(jobs.connectState() == Jobs::CONNECT_FAILED);
+}
+
+static void testLateAssociation() {
+  ESP8266WiFiClass wifi;
+  Jobs jobs(wifi);
+  Changes changes;
+  watch(jobs, changes);
+
+  jobs.startConnect("FarNet", "secret", 0, 2000);
+  jobs.update(2000);
+  CHECK(jobs.connectState() == Jobs::CONNECT_FAILED);
+
+  // Ядро продолжает попытки и дозванивается позже
+  jobs.update(2500);
+  CHECK(jobs.connectState() == Jobs::CONNECT_FAILED);
+  wifi.hostStatus = WL_CONNECTED;
+  jobs.update(4000);
+  CHECK(jobs.connectState() == Jobs::CONNECT_OK);
+  CHECK(wifi.beginCalls == 1);   // без нового begin()
+
+  // Точка доступа пропала: снова ждем, таймаут считается заново
+  wifi.hostStatus = WL_CONNECTION_LOST;
+  jobs.update(10000);
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  CHECK(jobs.connectElapsedMs(10500) == 500);
+  jobs.update(11999);
+  CHECK(jobs.connectState() == Jobs::CONNECT_WAITING);
+  wifi.hostStatus = WL_CONNECTED;
+  jobs.update(11999);
+  CHECK(jobs.connectState() == Jobs::CONNECT_OK);
+  CHECK(changes.connect == 5);   // waiting, failed, ok, waiting, ok
+}
+
+static void testScan() {
+  ESP8266WiFiClass wifi;
+  Jobs jobs(wifi);
+  Changes changes;
+  watch(jobs, changes);
+  wifi.hostNetworks = {{"A", -40, ENC_TYPE_CCMP}, {"B", -70, ENC_TYPE_NONE}, {"C", -85, ENC_TYPE_TKIP}};
+
+  CHECK(jobs.startScan());
+  CHECK(wifi.scanStarts == 1);
+  CHECK(wifi.scanDeletes == 1);
+  CHECK(jobs.scanState() == Jobs::SCAN_RUNNING);
+  CHECK(jobs.scanCount() == 0);
+
+  // Повторный запуск во время скана - без нового scanNetworks()
+  CHECK(jobs.startScan());
+  CHECK(wifi.scanStarts == 1);
+
+  for (int i = 0; i < 5; i++) jobs.update(i * 10);
+  CHECK(jobs.scanState() == Jobs::SCAN_RUNNING);
+  CHECK(wifi.scanPolls == 5);
+
+  wifi.hostFinishScan();
+  jobs.update(100);
+  CHECK(jobs.scanState() == Jobs::SCAN_DONE);
+  CHECK(jobs.scanCount() == 3);
+  jobs.update(110);
+  CHECK(wifi.scanPolls == 6);   // после конца скан не опрашивается
+  CHECK(changes.scan == 2);
+  CHECK(changes.connect == 0);
+
+  // Новый скан удаляет прошлый результат
+  CHECK(jobs.startScan());
+  CHECK(wifi.scanDeletes == 2);
+  wifi.hostScanResult = WIFI_SCAN_FAILED;
+  jobs.update(200);
+  CHECK(jobs.scanState() == Jobs::SCAN_FAILED);
+  CHECK(jobs.scanCount() == 0);
+
+  wifi.hostScanStartFails = true;
+  CHECK(!jobs.startScan());
+  CHECK(jobs.scanState() == Jobs::SCAN_FAILED);
+  CHECK(strcmp(Jobs::scanStateName(jobs.scanState()), "failed") == 0);
+}
+
+// update() в каждом состоянии: сколько он трогает драйвер и ждет ли
+static void testUpdateBudget() {
+  ESP8266WiFiClass wifi;
+  Jobs jobs(wifi);
+  wifi.hostNetworks = {{"A", -40, ENC_TYPE_CCMP}};
+
+  const int CALLS = 200000;
+  uint32_t maxStatus = 0, maxScanPolls = 0;
+  double maxNs = 0, totalNs = 0;
+  std::vector<double> times;
+  times.reserve(CALLS);
+  bool clockMoved = false;
+  setHostMicros(0);
+
+  for (int i = 0; i < CALLS; i++) {
+    // Сценарий меняется по ходу: подключение, скан, обрыв, таймаут, позднее подключение
+    int phase = (i / 1000) % 8;
+    if (i % 1000 == 0) {
+      if (phase == 0) jobs.startConnect("Net", "secret", millis(), 50);
+      if (phase == 2) jobs.startScan();
+      if (phase == 3) wifi.hostFinishScan();
+      if (phase == 4) wifi.hostStatus = WL_DISCONNECTED;
+      if (phase == 6) wifi.hostStatus = WL_CONNECTED;
+    }
+    if (phase == 1 && i % 1000 == 500) wifi.hostStatus = WL_CONNECTED;
+
+    uint32_t status = wifi.statusCalls, polls = wifi.scanPolls;
+    uint64_t before = hostMicros;
+    auto start = std::chrono::steady_clock::now();
+    jobs.update(millis());
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    if (hostMicros != before) clockMoved = true;
+    if (wifi.statusCalls - status > maxStatus) maxStatus = wifi.statusCalls - status;
+    if (wifi.scanPolls - polls > maxScanPolls) maxScanPolls = wifi.scanPolls - polls;
+    if (ns > maxNs) maxNs = ns;
+    totalNs += ns;
+    times.push_back(ns);
+    advanceHostMicros(100);   // проход loop()
+  }
+
+  std::sort(times.begin(), times.end());
+  double p99 = times[CALLS * 99 / 100];
+  printf("update(): %d calls, mean %.0f ns, p99 %.0f ns, max %.0f ns, per call at most %u status() and %u scanComplete()\n",
+         CALLS, totalNs / CALLS, p99, maxNs, maxStatus, maxScanPolls);
+  CHECK(!clockMoved);
+  CHECK(maxStatus <= 1);
+  CHECK(maxScanPolls <= 1);
+  // Без ожидания вызов на ПК занимает доли микросекунды (прежний
+  // connectToWiFi() ждал до 10 с). Отсутствие ожидания проверяют часы
+  // выше; максимум по стенным часам только печатается - в него попадает
+  // вытеснение процесса на загруженной машине
+  CHECK(p99 < 10000);
+  CHECK(totalNs / CALLS < 1000);
+}
+
+int main() {
+  testConnect();
+  testTimeout();
+  testLateAssociation();
+  testScan();
+  testUpdateBudget();
+  return hostTestResult("wifi_jobs_test");
+}
@@ -0,0 +1,372 @@
+"""
+Приемник UDP потока ориентации (UdpPoseStream.h) и проверка отбрасывания
+устаревших кадров на потерях и перестановках.
+
+Датаграмма - один кадр OrientationFrame (28 байт, 31 с угловыми
+скоростями), номер кадра uint16 по смещению 4. Кадр принимается, только
+если его номер новее последнего принятого (сравнение по модулю 2^16);
+старые и повторные кадры отбрасываются. Если принятых кадров нет дольше
+--resync-s (перезагрузка трекера), следующий кадр принимается как есть.
+
+Подписка идет через управляющий канал трекера:
+  v7      (Wifi_Head_MPU6050_ESP8266_V7)  POST /api/udp/subscribe?port=<p>
+  legacy  (Wifi_Head_MPU6050)             GET  /udp/subscribe?port=<p>
+Подписка живет UDP_POSE_LEASE_MS (30 с), приемник продлевает ее каждые
+--renew-s и отписывается при выходе. С --multicast приемник входит в
+группу, а трекер переключается на нее (…/udp/multicast).
+
+Режимы:
+  listen    - прием с реального трекера, статистика раз в секунду
+  simulate  - эмулятор трекера -> ретранслятор с потерями, дублями и
+              перестановками -> приемник, все на localhost; проверяет,
+              что принятые номера строго растут и счетчики сходятся.
+              Код возврата 1 при нарушении.
+
+Примеры:
+  python3 udp_pose_receiver.py listen 192.168.4.1 --api v7
+  python3 udp_pose_receiver.py listen 192.168.1.50 --api legacy --port 5000
+  python3 udp_pose_receiver.py listen 192.168.4.1 --multicast 239.1.2.3
+  python3 udp_pose_receiver.py simulate --loss 0.1 --reorder 0.2 --duplicate 0.05
+"""
+
+import argparse
+import heapq
+import json
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+import urllib.parse
+import urllib.request
+
+ORIENTATION_FRAME_MAGIC = 0xA5
+ORIENTATION_FRAME_SIZE = 28
+ORIENTATION_FRAME_RATES_SIZE = 31
+ORIENTATION_FRAME_RATE_STEP = 4.0     # °/с на единицу скорости
+ORIENTATION_FLAG_RATES = 0x04
+
+
+# ---------------------------------------------------------------------------
+# Кадры
+# ---------------------------------------------------------------------------
+
+def decode_frame(data):
+    """Словарь с полями кадра или None"""
+    if len(data) < ORIENTATION_FRAME_SIZE or data[0] != ORIENTATION_FRAME_MAGIC:
+        return None
+    _, version, flags, _, seq, timestamp, p, r, y, ap, ar, ay = struct.unpack_from("<BBBBHIhhhiii", data, 0)
+    frame = {
+        "version": version, "flags": flags, "seq": seq, "sampleUs": timestamp,
+        "pitch": p / 100.0, "roll": r / 100.0, "yaw": y / 100.0,
+        "absPitch": ap / 100.0, "absRoll": ar / 100.0, "absYaw": ay / 100.0,
+    }
+    if flags & ORIENTATION_FLAG_RATES and len(data) >= ORIENTATION_FRAME_RATES_SIZE:
+        rp, rr, ry = struct.unpack_from("<bbb", data, 28)
+        frame.update(ratePitch=rp * ORIENTATION_FRAME_RATE_STEP, rateRoll=rr * ORIENTATION_FRAME_RATE_STEP,
+                     rateYaw=ry * ORIENTATION_FRAME_RATE_STEP)
+    return frame
+
+
+def encode_frame(seq, timestamp_us, pitch, roll, yaw, rates=(0.0, 0.0, 0.0)):
+    """Кадр как у encodeOrientationFrame + appendOrientationRates"""
+    return struct.pack("<BBBBHIhhhiiibbb", ORIENTATION_FRAME_MAGIC, 1, ORIENTATION_FLAG_RATES, 0,
+                       seq & 0xFFFF, timestamp_us & 0xFFFFFFFF,
+                       round(pitch * 100), round(roll * 100), round(yaw * 100),
+                       round(pitch * 100), round(roll * 100), round(yaw * 100),
+                       *(max(-128, min(127, round(rate / ORIENTATION_FRAME_RATE_STEP))) for rate in rates))
+
+
+def seq_newer(seq, last):
+    """seq новее last с учетом переполнения uint16"""
+    return 0 < ((seq - last) & 0xFFFF) < 0x8000
+
+
+class StaleFilter:
+    """Пропускает только кадры новее последнего принятого"""
+
+    def __init__(self, resync_s=1.0):
+        self.resync_s = resync_s
+        self.last_seq = None
+        self.last_accept = 0.0
+        self.accepted = 0
+        self.stale = 0        # старые и повторные
+        self.lost = 0         # пропуски номеров между принятыми кадрами
+        self.invalid = 0
+        self.resyncs = 0
+
+    def accept(self, data, now):
+        """Кадр, если его надо использовать, иначе None"""
+        frame = decode_frame(data)
+        if frame is None:
+            self.invalid += 1
+            return None
+        seq = frame["seq"]
+        if self.last_seq is not None and now - self.last_accept > self.resync_s:
+            self.last_seq = None
+            self.resyncs += 1
+        if self.last_seq is not None:
+            if not seq_newer(seq, self.last_seq):
+                self.stale += 1
+                return None
+            self.lost += ((seq - self.last_seq) & 0xFFFF) - 1
+        self.last_seq = seq
+        self.last_accept = now
+        self.accepted += 1
+        return frame
+
+    def stats(self):
+        return {"accepted": self.accepted, "lost": self.lost, "stale": self.stale,
+                "invalid": self.invalid, "resyncs": self.resyncs}
+
+
+# ---------------------------------------------------------------------------
+# listen
+# ---------------------------------------------------------------------------
+
+def control_request(args, action, params):
+    """Вызов REST управления UDP потоком, возвращает ответ JSON"""
+    path = ("/api/udp/" if args.api == "v7" else "/udp/") + action
+    url = "http://%s%s?%s" % (args.host, path, urllib.parse.urlencode(params))
+    request = urllib.request.Request(url, method="POST" if args.api == "v7" else "GET")
+    with urllib.request.urlopen(request, timeout=3) as response:
+        body = response.read().decode("utf-8", "replace")
+    try:
+        return json.loads(body)
+    except ValueError:
+        return {"raw": body}
+
+
+def subscribe(args):
+    if args.multicast:
+        return control_request(args, "multicast", {"group": args.multicast, "port": args.port})
+    return control_request(args, "subscribe", {"port": args.port})
+
+
+def unsubscribe(args):
+    if args.multicast:
+        return control_request(args, "multicast", {})
+    return control_request(args, "unsubscribe", {"port": args.port})
+
+
+def run_listen(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(("", args.port))
+    if args.multicast:
+        membership = struct.pack("4s4s", socket.inet_aton(args.multicast), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, membership)
+    sock.settimeout(0.2)
+
+    print("subscribe:", subscribe(args), file=sys.stderr)
+    stale_filter = StaleFilter(args.resync_s)
+    start = time.monotonic()
+    last_renew = last_print = start
+    last_frame = None
+    try:
+        while args.duration <= 0 or time.monotonic() - start < args.duration:
+            try:
+                data, _ = sock.recvfrom(512)
+                frame = stale_filter.accept(data, time.monotonic())
+                if frame is not None:
+                    last_frame = frame
+                    if args.frames:
+                        print(json.dumps(frame))
+            except socket.timeout:
+                pass
+
+            now = time.monotonic()
+            if now - last_renew >= args.renew_s:
+                last_renew = now
+                try:
+                    subscribe(args)
+                except OSError as error:
+                    print("renew failed:", error, file=sys.stderr)
+            if not args.frames and now - last_print >= 1.0:
+                last_print = now
+                pose = ("P:%.2f R:%.2f Y:%.2f" % (last_frame["pitch"], last_frame["roll"], last_frame["yaw"])
+                        if last_frame else "-")
+                print("%s  %s" % (json.dumps(stale_filter.stats()), pose), file=sys.stderr)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        try:
+            print("unsubscribe:", unsubscribe(args), file=sys.stderr)
+        except OSError as error:
+            print("unsubscribe failed:", error, file=sys.stderr)
+        sock.close()
+    print(json.dumps(stale_filter.stats()))
+
+
+# ---------------------------------------------------------------------------
+# simulate
+# ---------------------------------------------------------------------------
+
+class LossyRelay(threading.Thread):
+    """UDP ретранслятор: теряет, дублирует и задерживает датаграммы"""
+
+    def __init__(self, target, loss, duplicate, reorder, max_delay_s, seed):
+        super().__init__(daemon=True)
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(("127.0.0.1", 0))
+        self.sock.settimeout(0.005)
+        self.address = self.sock.getsockname()
+        self.target = target
+        self.loss = loss
+        self.duplicate = duplicate
+        self.reorder = reorder
+        self.max_delay_s = max_delay_s
+        self.rng = random.Random(seed)
+        self.held = []          # (время выдачи, порядковый номер, данные)
+        self.counter = 0
+        self.received = self.dropped = self.duplicated = self.delayed = self.forwarded = 0
+        self.running = True
+
+    def hold(self, data, release):
+        heapq.heappush(self.held, (release, self.counter, data))
+        self.counter += 1
+
+    def run(self):
+        while self.running or self.held:
+            try:
+                data, _ = self.sock.recvfrom(512)
+                self.received += 1
+                now = time.monotonic()
+                if self.rng.random() < self.loss:
+                    self.dropped += 1
+                else:
+                    copies = 2 if self.rng.random() < self.duplicate else 1
+                    self.duplicated += copies - 1
+                    for _ in range(copies):
+                        delay = 0.0
+                        if self.rng.random() < self.reorder:
+                            delay = self.rng.uniform(0, self.max_delay_s)
+                            self.delayed += 1
+                        self.hold(data, now + delay)
+            except socket.timeout:
+                pass
+            now = time.monotonic()
+            while self.held and self.held[0][0] <= now:
+                _, _, data = heapq.heappop(self.held)
+                self.sock.sendto(data, self.target)
+                self.forwarded += 1
+        self.sock.close()
+
+
+def run_simulate(args):
+    receiver = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    receiver.bind(("127.0.0.1", 0))
+    receiver.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)
+    receiver.settimeout(0.5)
+
+    relay = LossyRelay(receiver.getsockname(), args.loss, args.duplicate, args.reorder,
+                       args.max_delay_ms / 1000.0, args.seed)
+    relay.start()
+
+    frames_total = int(args.duration * args.rate)
+    start_seq = args.start_seq
+
+    def sender():
+        # Эмулятор трекера: поворот по рысканию 90°/с, номера с переполнением uint16
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        period = 1.0 / args.rate
+        t0 = time.monotonic()
+        for i in range(frames_total):
+            target = t0 + i * period
+            delay = target - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            ts_us = int(i * period * 1000000)
+            yaw = ((i * period * 90.0 + 180.0) % 360.0) - 180.0
+            sock.sendto(encode_frame(start_seq + i, ts_us, 0.0, 0.0, yaw, (0.0, 0.0, 90.0)), relay.address)
+        sock.close()
+        relay.running = False
+
+    thread = threading.Thread(target=sender, daemon=True)
+    thread.start()
+
+    stale_filter = StaleFilter(args.resync_s)
+    received = 0
+    accepted_indices = []       # номера кадров без переполнения (i)
+    mismatched = 0
+    while True:
+        try:
+            data, _ = receiver.recvfrom(512)
+        except socket.timeout:
+            if not relay.is_alive():
+                break
+            continue
+        received += 1
+        frame = stale_filter.accept(data, time.monotonic())
+        if frame is None:
+            continue
+        # Восстанавливаем i по номеру относительно последнего принятого
+        seq_offset = (frame["seq"] - start_seq) & 0xFFFF
+        base = accepted_indices[-1] if accepted_indices else 0
+        index = base + ((seq_offset - base) & 0xFFFF)
+        accepted_indices.append(index)
+        expected_ts = int(index * (1.0 / args.rate) * 1000000) & 0xFFFFFFFF
+        if frame["sampleUs"] != expected_ts:
+            mismatched += 1
+    relay.join()
+    thread.join()
+    receiver.close()
+
+    stats = stale_filter.stats()
+    span = accepted_indices[-1] - accepted_indices[0] + 1 if accepted_indices else 0
+    checks = {
+        "strictly_increasing": all(b > a for a, b in zip(accepted_indices, accepted_indices[1:])),
+        "counts_add_up": received == stats["accepted"] + stats["stale"] + stats["invalid"],
+        "span_covered": stats["accepted"] + stats["lost"] == span,
+        "relay_delivered_all": received == relay.forwarded,
+        "frames_match_seq": mismatched == 0,
+        "no_resync": stats["resyncs"] == 0,
+    }
+    report = {
+        "sent": frames_total,
+        "relay": {"dropped": relay.dropped, "duplicated": relay.duplicated,
+                  "delayed": relay.delayed, "forwarded": relay.forwarded},
+        "received": received,
+        "filter": stats,
+        "used_ratio": round(stats["accepted"] / frames_total, 3) if frames_total else None,
+        "checks": checks,
+    }
+    print(json.dumps(report, indent=2))
+    return 0 if all(checks.values()) else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Прием UDP потока ориентации и проверка на потерях")
+    sub = parser.add_subparsers(dest="mode", required=True)
+
+    listen = sub.add_parser("listen", help="прием с трекера")
+    listen.add_argument("host", help="адрес трекера (192.168.4.1)")
+    listen.add_argument("--api", choices=["v7", "legacy"], default="v7", help="вид REST управления")
+    listen.add_argument("--port", type=int, default=4210, help="локальный UDP порт")
+    listen.add_argument("--multicast", help="группа multicast вместо unicast подписки")
+    listen.add_argument("--renew-s", type=float, default=10.0, help="период продления подписки")
+    listen.add_argument("--resync-s", type=float, default=1.0)
+    listen.add_argument("--duration", type=float, default=0.0, help="секунд, 0 - до Ctrl+C")
+    listen.add_argument("--frames", action="store_true", help="печатать принятые кадры JSON")
+
+    simulate = sub.add_parser("simulate", help="эмуляция потерь и перестановок на localhost")
+    simulate.add_argument("--duration", type=float, default=3.0)
+    simulate.add_argument("--rate", type=float, default=200.0, help="кадров в секунду")
+    simulate.add_argument("--loss", type=float, default=0.1)
+    simulate.add_argument("--duplicate", type=float, default=0.05)
+    simulate.add_argument("--reorder", type=float, default=0.2, help="доля задержанных датаграмм")
+    simulate.add_argument("--max-delay-ms", type=float, default=40.0, help="максимальная добавочная задержка")
+    simulate.add_argument("--start-seq", type=int, default=65300, help="первый номер (проверка переполнения)")
+    simulate.add_argument("--resync-s", type=float, default=1.0)
+    simulate.add_argument("--seed", type=int, default=1)
+
+    args = parser.parse_args()
+    if args.mode == "listen":
+        run_listen(args)
+    else:
+        sys.exit(run_simulate(args))
+
+
+if __name__ == "__main__":
+    main()
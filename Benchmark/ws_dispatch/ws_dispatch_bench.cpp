@@ -0,0 +1,424 @@
+/*
+  Скорость разбора входящих WebSocket-сообщений и рассылки в WiFiManager (AppRestApi5)
+
+  Замеряется настоящий WiFiManager: Wifi_ESP8266.cpp собран на ПК против
+  замен библиотек из Benchmark/host (WebSocketsServer.h повторяет
+  arduinoWebSockets 2.4.x, включая копию кадра в sendFrame()). Сообщения
+  подаются так, как их отдает loop() библиотеки - событием в onEvent()
+  (hostText(), hostFragment()), ответы уходят через sendTXT() библиотеки
+  или WebSocketsFanoutServer и считаются в байтах по клиентам.
+
+  Прием:
+    legacy  - модель кода до WebSocketDispatch.h (в дереве его больше нет):
+              каждое сообщение копируется в std::vector<String>
+              webSocketCommands[num] (push_back), вызываются все обычные
+              обработчики подряд, loop-обработчик читает очередь через
+              erase(begin())
+    routed  - WiFiManager::webSocket(): клиент привязан к обработчику по пути
+              при подключении, сообщение уходит ровно одному; для loop-пути -
+              в CommandQueue фиксированного размера
+    view    - WiFiManager::webSocketView(): обработчик получает
+              WebSocketMessage (указатель и длину payload) и отвечает через
+              sendWebSocketFrame()
+  Плюс сборка фрагментированных сообщений через FragmentBuffer (в legacy
+  фрагменты просто терялись).
+
+  Отправка (--clients получателей, поза ~80 байт JSON):
+    legacy String    - как было: копия String, затем broadcastTXT()
+    broadcastTXT     - sendWebSocketBroadcast(): sendFrame() библиотеки
+                       выделяет буфер заголовок + данные на каждого клиента
+    frame fan-out    - broadcastWebSocketFrame(): заголовок кодируется один
+                       раз, каждому клиенту - запись тех же байт
+
+  Выделения памяти считаются подменой malloc() (через нее идут и
+  operator new, и String, и sendFrame()). String ведет себя как на ESP8266:
+  до 10 символов внутри объекта, длиннее - в куче. Аллокатор ПК быстрее
+  umm_malloc на ESP8266, так что разница на устройстве больше.
+
+  Обработчики - как в AppRestApi5.ino: обычный отвечает "Echo: " + команда,
+  loop-обработчик вычитывает очереди всех клиентов; loop() скетча
+  (handleClient() и update()) проходит раз в --drain сообщений (legacy:
+  раз в 5 с update(), т.е. сотни сообщений).
+
+  Сборка и запуск (из корня репозитория, см. Benchmark/CMakeLists.txt):
+    cmake -S Benchmark -B build && cmake --build build
+    ./build/ws_dispatch_bench
+    ./build/ws_dispatch_bench --messages 2000000 --handlers 6 --drain 500
+    ./build/ws_dispatch_bench --check     # короткий прогон с проверками (ctest)
+*/
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Wifi_ESP8266.h"
+
+// Счетчик выделений памяти за весь процесс: malloc() glibc с подсчетом
+extern "C" void* __libc_malloc(size_t size);
+static size_t allocations = 0;
+
+extern "C" void* malloc(size_t size) {
+  allocations++;
+  return __libc_malloc(size);
+}
+
+struct Config {
+  size_t messages = 1000000;
+  int clients = 4;
+  int handlers = 3;        // обычных; плюс один loop-обработчик
+  size_t drain = 100;      // сообщений между проходами loop()
+  size_t fragment = 3;     // на сколько частей резать сообщение в fragmented
+};
+
+static const char* LOOP_PATH = "/api/web_socket_loop";
+
+static String handlerPath(int i) { return String("/api/web_socket") + String(i); }
+
+// Клиент i подключен к пути i % (число путей); последний путь - loop
+static String clientUrl(const Config &config, int i) {
+  int route = i % (config.handlers + 1);
+  return (route < config.handlers ? handlerPath(route) : String(LOOP_PATH)) + "?id=" + String(i);
+}
+
+static std::vector<std::string> makeCommands() {
+  return {"PING", "TIME", "STATUS", "GET_TEMP", "GET_HUMIDITY",
+          "SET_LED:1", "CALIBRATE", "{\"cmd\":\"pose\",\"yaw\":12.5,\"pitch\":-3.0,\"roll\":0.25}"};
+}
+
+// --- legacy -----------------------------------------------------------------
+
+// Модель старого handleWebSocketEvent(): ответы шли тем же sendTXT() библиотеки
+class Legacy {
+  public:
+    Legacy(const Config &config) : server(81) {
+      for (int i = 0; i < config.handlers; i++) {
+        callbacks.push_back([](const String &cmd) { return "Echo: " + cmd; });
+      }
+      for (int i = 0; i < config.clients; i++) server.hostConnect((uint8_t)i, clientUrl(config, i).c_str());
+    }
+
+    void text(uint8_t num, const char* payload, size_t length) {
+      (void)length;
+      String message = String(payload);
+      if (num < 10) commands[num].push_back(message);
+      for (auto &callback : callbacks) {
+        String response = callback(message);
+        if (response.length() > 0) server.sendTXT(num, response);
+      }
+    }
+
+    // Фрагменты не поддерживались
+    void fragment(uint8_t, WStype_t, const char*, size_t) {}
+
+    void loopPass(size_t &consumed) {
+      String command;
+      for (uint8_t num = 0; num < 10; num++) {
+        while (!commands[num].empty()) {
+          command = commands[num].front();
+          commands[num].erase(commands[num].begin());
+          consumed++;
+        }
+      }
+    }
+
+    size_t queued() const {
+      size_t total = 0;
+      for (auto &queue : commands) total += queue.size();
+      return total;
+    }
+
+    WebSocketsServer server;
+
+  private:
+    std::vector<std::function<String(const String&)>> callbacks;
+    std::vector<String> commands[10];
+};
+
+// --- WiFiManager ------------------------------------------------------------
+
+class Manager {
+  public:
+    Manager(const Config &config, bool view) : clients(config.clients) {
+      for (int i = 0; i < config.handlers; i++) {
+        if (view) {
+          manager.webSocketView(handlerPath(i), [this](uint8_t num, const WebSocketMessage &message) {
+            reply.clear();
+            reply.append("Echo: ");
+            reply.append((const uint8_t*)message.data, message.length);
+            manager.sendWebSocketFrame(num, reply);
+          });
+        } else {
+          manager.webSocket(handlerPath(i), [](const String &cmd) { return "Echo: " + cmd; });
+        }
+      }
+      // Как в AppRestApi5.ino: очередь каждого клиента вычитывается до конца
+      manager.webSocketLoop(LOOP_PATH, [this]() {
+        for (uint8_t i = 0; i < clients; i++) {
+          while (manager.readWebSocketCommand(i, command)) consumed++;
+        }
+      });
+      manager.begin();
+      for (int i = 0; i < config.clients; i++) server().hostConnect((uint8_t)i, clientUrl(config, i).c_str());
+    }
+
+    void text(uint8_t num, const char* payload, size_t length) { server().hostText(num, payload, length); }
+    void fragment(uint8_t num, WStype_t type, const char* data, size_t length) {
+      server().hostFragment(num, type, data, length);
+    }
+
+    void loopPass(size_t &total) {
+      manager.handleClient();
+      manager.update();
+      total = consumed;
+    }
+
+    size_t queued() {
+      // Остаток очередей: то, что loop-обработчик не успел забрать
+      size_t before = consumed;
+      for (uint8_t i = 0; i < clients; i++) {
+        while (manager.readWebSocketCommand(i, command)) consumed++;
+      }
+      size_t left = consumed - before;
+      consumed = before;
+      return left;
+    }
+
+    WebSocketsServer &server() { return manager.getWebSocketServer(); }
+
+    WiFiManager manager;
+
+  private:
+    uint8_t clients;
+    size_t consumed = 0;
+    String command;
+    WebSocketFrame<256> reply;
+};
+
+// --- прогон -----------------------------------------------------------------
+
+struct Result {
+  double seconds;
+  size_t writes, bytes, consumed, queuedAtEnd, allocations;
+};
+
+static void resetWire(WebSocketsServer &server, int clients, size_t &writes, size_t &bytes) {
+  writes = bytes = 0;
+  for (int i = 0; i < clients; i++) {
+    writes += server.hostClient((uint8_t)i).writes;
+    bytes += server.hostClient((uint8_t)i).bytesWritten;
+  }
+}
+
+template <class Dispatcher>
+static Result run(Dispatcher &dispatcher, WebSocketsServer &server, const Config &config,
+                  const std::vector<std::string> &commands, bool fragmented) {
+  size_t writesBefore, bytesBefore, consumed = 0;
+  resetWire(server, config.clients, writesBefore, bytesBefore);
+  size_t allocationsBefore = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < config.messages; i++) {
+    uint8_t num = (uint8_t)(i % config.clients);
+    const std::string &command = commands[i % commands.size()];
+    if (!fragmented) {
+      dispatcher.text(num, command.c_str(), command.size());
+    } else {
+      size_t parts = std::max<size_t>(1, std::min(config.fragment, command.size()));
+      size_t chunk = (command.size() + parts - 1) / parts;
+      for (size_t offset = 0; offset < command.size(); offset += chunk) {
+        size_t length = std::min(chunk, command.size() - offset);
+        WStype_t type = offset == 0 ? WStype_FRAGMENT_TEXT_START
+                        : offset + length >= command.size() ? WStype_FRAGMENT_FIN : WStype_FRAGMENT;
+        dispatcher.fragment(num, type, command.c_str() + offset, length);
+      }
+    }
+    if ((i + 1) % config.drain == 0) {
+      advanceHostMicros(1000);
+      dispatcher.loopPass(consumed);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  size_t allocationsUsed = allocations - allocationsBefore;
+  size_t writes, bytes;
+  resetWire(server, config.clients, writes, bytes);
+  return {std::chrono::duration<double>(end - start).count(), writes - writesBefore, bytes - bytesBefore, consumed,
+          dispatcher.queued(), allocationsUsed};
+}
+
+// --- отправка ---------------------------------------------------------------
+
+struct SendResult {
+  double seconds;
+  size_t allocations, bytes;
+};
+
+template <class Broadcast>
+static SendResult runSend(WebSocketsServer &server, const Config &config, Broadcast broadcast) {
+  size_t writesBefore, bytesBefore;
+  resetWire(server, config.clients, writesBefore, bytesBefore);
+  size_t allocationsBefore = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < config.messages; i++) broadcast(i);
+  auto end = std::chrono::steady_clock::now();
+  size_t allocationsUsed = allocations - allocationsBefore;
+  size_t writes, bytes;
+  resetWire(server, config.clients, writes, bytes);
+  return {std::chrono::duration<double>(end - start).count(), allocationsUsed, bytes - bytesBefore};
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: ws_dispatch_bench [--messages N] [--clients N] [--handlers N] [--drain N] [--fragment N]"
+          " [--check]\n");
+}
+
+int main(int argc, char **argv) {
+  Config config;
+  bool check = false;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--check") {
+      check = true;
+      config.messages = 20000;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      usage();
+      return 2;
+    }
+    long value = atol(argv[++i]);
+    if (arg == "--messages") config.messages = std::max(1L, value);
+    else if (arg == "--clients") config.clients = (int)std::min<long>(std::max(1L, value), WEBSOCKETS_SERVER_CLIENT_MAX);
+    else if (arg == "--handlers") config.handlers = (int)std::min<long>(std::max(1L, value), 100);
+    else if (arg == "--drain") config.drain = std::max(1L, value);
+    else if (arg == "--fragment") config.fragment = std::max(1L, value);
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  std::vector<std::string> commands = makeCommands();
+  // Сообщений клиентам обычных путей и loop-пути
+  size_t toLoop = 0;
+  for (size_t i = 0; i < config.messages; i++) {
+    if ((int)(i % config.clients) % (config.handlers + 1) == config.handlers) toLoop++;
+  }
+  size_t toHandlers = config.messages - toLoop;
+
+  printf("%zu messages, %d clients, %d handlers + 1 loop, loop() every %zu messages\n\n",
+         config.messages, config.clients, config.handlers, config.drain);
+  printf("%-22s %12s %10s %10s %10s %10s %10s %10s\n", "receive", "msgs/s", "ns/msg", "allocs/msg", "replies",
+         "reply B", "consumed", "queued");
+
+  auto report = [&](const char *name, const Result &r) {
+    printf("%-22s %12.0f %10.1f %10.2f %10zu %10zu %10zu %10zu\n", name, config.messages / r.seconds,
+           r.seconds * 1e9 / config.messages, (double)r.allocations / config.messages, r.writes, r.bytes,
+           r.consumed, r.queuedAtEnd);
+  };
+
+  {
+    Legacy legacy(config);
+    report("legacy text", run(legacy, legacy.server, config, commands, false));
+  }
+  {
+    Manager routed(config, false);
+    Result r = run(routed, routed.server(), config, commands, false);
+    report("routed text", r);
+    expect(r.writes == toHandlers, "routed: one reply per message to a handler path");
+    expect(r.consumed + r.queuedAtEnd <= toLoop, "routed: loop path gets only its own messages");
+    expect(r.consumed > 0, "routed: loop handler drained its queue");
+  }
+  {
+    Manager routed(config, false);
+    Result r = run(routed, routed.server(), config, commands, true);
+    report("routed fragmented", r);
+    expect(r.writes == toHandlers, "routed: fragmented messages assembled and answered");
+  }
+  {
+    Manager view(config, true);
+    Result r = run(view, view.server(), config, commands, false);
+    report("view text", r);
+    expect(r.writes == toHandlers, "view: one reply per message to a handler path");
+  }
+  {
+    Manager view(config, true);
+    report("view fragmented", run(view, view.server(), config, commands, true));
+  }
+  {
+    // Loop-обработчик только по сообщениям берет одну команду за вызов:
+    // пока очередь не пуста, update() зовет его снова, без новых сообщений
+    WiFiManager manager;
+    String command;
+    size_t calls = 0, taken = 0;
+    manager.webSocketLoop(LOOP_PATH, [&]() {
+      calls++;
+      if (manager.readWebSocketCommand(0, command)) taken++;
+    }, 0, LOOP_TRIGGER_MESSAGE);
+    manager.begin();
+    manager.getWebSocketServer().hostConnect(0, LOOP_PATH);
+    const char* burst = "GET_TEMP";
+    for (int i = 0; i < 5; i++) manager.getWebSocketServer().hostText(0, burst, strlen(burst));
+    for (int i = 0; i < 8; i++) {
+      advanceHostMicros(1000);
+      manager.update();
+    }
+    expect(taken == 5, "loop: queued commands drained without new messages");
+    expect(calls == 5, "loop: handler not called once its queue is empty");
+  }
+
+  printf("\n%-22s %12s %10s %10s %10s\n", "send (broadcast)", "msgs/s", "ns/msg", "allocs/msg", "wire B/msg");
+  auto reportSend = [&](const char *name, const SendResult &r) {
+    printf("%-22s %12.0f %10.1f %10.2f %10.1f\n", name, config.messages / r.seconds,
+           r.seconds * 1e9 / config.messages, (double)r.allocations / config.messages,
+           (double)r.bytes / config.messages);
+  };
+  Manager sender(config, true);
+  char pose[128];
+  auto formatPose = [&](size_t i) {
+    snprintf(pose, sizeof(pose), "{\"yaw\":%zu.25,\"pitch\":-3.50,\"roll\":0.75,\"seq\":%zu,\"sampleUs\":123456789}",
+             i % 360, i);
+  };
+  {
+    // Как раньше: sendWebSocketBroadcast(String) -> String msg = message -> broadcastTXT
+    String message;
+    SendResult r = runSend(sender.server(), config, [&](size_t i) {
+      formatPose(i);
+      message = pose;
+      String msg = message;
+      sender.server().broadcastTXT(msg);
+    });
+    reportSend("legacy String", r);
+  }
+  SendResult library = runSend(sender.server(), config, [&](size_t i) {
+    formatPose(i);
+    sender.manager.sendWebSocketBroadcast((const uint8_t*)pose, strlen(pose));
+  });
+  reportSend("broadcastTXT", library);
+  WebSocketFrame<128> frame;
+  SendResult fanout = runSend(sender.server(), config, [&](size_t i) {
+    frame.clear();
+    frame.appendf("{\"yaw\":%zu.25,\"pitch\":-3.50,\"roll\":0.75,\"seq\":%zu,\"sampleUs\":123456789}", i % 360, i);
+    sender.manager.broadcastWebSocketFrame(frame);
+  });
+  reportSend("frame fan-out", fanout);
+  expect(library.allocations == config.messages * config.clients,
+         "broadcastTXT: sendFrame() allocates once per client");
+  expect(fanout.allocations == 0, "frame fan-out: no allocations");
+  expect(fanout.bytes == library.bytes, "frame fan-out: same bytes on the wire as broadcastTXT");
+
+  if (check) printf("\n%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
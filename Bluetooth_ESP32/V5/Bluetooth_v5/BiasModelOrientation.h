@@ -0,0 +1,298 @@
+/*
+  Orientation core of Bluetooth_v5, independent of the board
+  Everything the fusion task does with one raw sample: accel/gyro offsets,
+  post-boot refinement of stored offsets, the temperature bias model and
+  its stationary observations, residual bias tracking on top of the model,
+  manual drift compensation, the gyro low-pass and the quaternion filter. No tasks, BLE or EEPROM here -
+  update() reports what changed and the sketch decides what to persist,
+  so the same code runs in the host replay (Benchmark/fusion_replay).
+
+  Units: gyro deg/s (+-250 deg/s, 131 LSB), accel g (+-2g, 16384 LSB).
+
+  Usage:
+    BiasModelOrientation orientation;
+    orientation.calibrate(mpuBus, stats);              // setup(), blocking
+    fusionTask: uint8_t changed = orientation.update(sample, deltaTime);
+                if (changed & BIAS_ORIENTATION_REFINED) store offsets;
+                orientation.pitch, orientation.roll, orientation.yaw
+*/
+
+#ifndef BIAS_MODEL_ORIENTATION_H
+#define BIAS_MODEL_ORIENTATION_H
+
+#include <Arduino.h>
+#include "MPU6050Bus.h"
+#include "CalibrationStore.h"
+#include "GyroBiasModel.h"
+#include "SensorFusion.h"
+#include "StationaryDetector.h"
+
+#ifndef CALIBRATION_SAMPLES
+#define CALIBRATION_SAMPLES 200
+#endif
+#ifndef CALIBRATION_DELAY
+#define CALIBRATION_DELAY 5
+#endif
+#define CALIBRATION_WARMUP_SAMPLES 50
+#define CALIBRATION_WARMUP_DELAY   10
+
+#ifndef REFINE_STILL_THRESHOLD
+#define REFINE_STILL_THRESHOLD 2.0   // deg/s from the stored offset
+#endif
+#ifndef REFINE_WINDOW_SAMPLES
+#define REFINE_WINDOW_SAMPLES 1000   // ~1 s still at 1 kHz
+#endif
+
+#ifndef BIAS_MAX_SLOPE
+#define BIAS_MAX_SLOPE 0.2               // deg/s per deg C
+#endif
+#ifndef BIAS_STILL_THRESHOLD
+#define BIAS_STILL_THRESHOLD 1.0         // deg/s, window mean after bias removal
+#endif
+#ifndef BIAS_NOISE_THRESHOLD
+#define BIAS_NOISE_THRESHOLD 0.6         // deg/s, gyro std dev in the window
+#endif
+#ifndef ACCEL_NOISE_THRESHOLD
+#define ACCEL_NOISE_THRESHOLD 0.02       // g, std dev of |accel| in the window
+#endif
+#ifndef STATIONARY_WINDOW
+#define STATIONARY_WINDOW 256            // ~0.26 s at 1 kHz
+#endif
+#ifndef BIAS_OBSERVATION_INTERVAL
+#define BIAS_OBSERVATION_INTERVAL 10000  // ms between model observations
+#endif
+#ifndef BIAS_CALIBRATION_WEIGHT
+#define BIAS_CALIBRATION_WEIGHT 5.0      // Full calibration weight relative to one window
+#endif
+#ifndef BIAS_TRACKING_RATE
+#define BIAS_TRACKING_RATE 0.0002        // Residual bias, ~5 s time constant at 1 kHz
+#endif
+
+#define GYRO_LPF_ALPHA 0.9f
+
+// update() result bits
+#define BIAS_ORIENTATION_REFINED        0x01   // Offsets refined, store the calibration
+#define BIAS_ORIENTATION_MODEL_CHANGED  0x02   // Bias model got an observation
+
+struct BiasCalibrationStats {
+  uint32_t samples;
+  float temperature;     // Mean over the calibration, deg C
+  float gyroStd[3];      // deg/s
+};
+
+class BiasModelOrientation {
+  public:
+    float pitch = 0, roll = 0, yaw = 0;
+
+    float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;    // deg/s
+    float accelOffsetX = 0, accelOffsetY = 0, accelOffsetZ = 0; // g
+    float gyroBiasX = 0, gyroBiasY = 0, gyroBiasZ = 0;          // Predicted by the model, deg/s
+    // What the model misses between observations (until the temperature
+    // spread allows a slope, its intercept averages all of them), followed
+    // while still and handed back to the model on each observation
+    float residualBiasX = 0, residualBiasY = 0, residualBiasZ = 0;
+    float pitchDriftCompensation = 0, rollDriftCompensation = 0, yawDriftCompensation = 0;
+
+    // Last processed sample: accel in g, filtered gyro in deg/s
+    float ax = 0, ay = 0, az = 0;
+    float gx = 0, gy = 0, gz = 0;
+    float temperature = 0;
+
+    SensorFusion fusion;
+    GyroBiasModel biasModel{BIAS_MAX_SLOPE};
+    StationaryDetector<STATIONARY_WINDOW> stationaryDetector{BIAS_NOISE_THRESHOLD, BIAS_STILL_THRESHOLD,
+                                                             ACCEL_NOISE_THRESHOLD};
+    CalibrationRefiner refiner{REFINE_STILL_THRESHOLD, REFINE_WINDOW_SAMPLES};
+
+    // Blocking full calibration of gyro and accel offsets; the result is
+    // also the first (heavy) observation of the bias model
+    template <class BusType>
+    void calibrate(BusType &bus, BiasCalibrationStats &stats) {
+      for (int i = 0; i < CALIBRATION_WARMUP_SAMPLES; i++) {
+        MPU6050Sample sample;
+        bus.readSample(sample);
+        delay(CALIBRATION_WARMUP_DELAY);
+      }
+
+      double sumG[3] = {0, 0, 0}, sumGG[3] = {0, 0, 0};
+      float sumAx = 0, sumAy = 0, sumAz = 0, sumTemp = 0;
+      for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
+        MPU6050Sample sample;
+        if (bus.readSample(sample)) {
+          sumTemp += mpu6050Temperature(sample.temp);
+          const float g[3] = { sample.gx / 131.0f, sample.gy / 131.0f, sample.gz / 131.0f };
+          for (uint8_t axis = 0; axis < 3; axis++) {
+            sumG[axis] += g[axis];
+            sumGG[axis] += (double)g[axis] * g[axis];
+          }
+          sumAx += sample.ax / 16384.0f;
+          sumAy += sample.ay / 16384.0f;
+          sumAz += sample.az / 16384.0f;
+        }
+        delay(CALIBRATION_DELAY);
+      }
+
+      gyroOffsetX = sumG[0] / CALIBRATION_SAMPLES;
+      gyroOffsetY = sumG[1] / CALIBRATION_SAMPLES;
+      gyroOffsetZ = sumG[2] / CALIBRATION_SAMPLES;
+      accelOffsetX = sumAx / CALIBRATION_SAMPLES;
+      accelOffsetY = sumAy / CALIBRATION_SAMPLES;
+      accelOffsetZ = (sumAz / CALIBRATION_SAMPLES) - 1.0f;   // Gravity (1g) stays in Z
+
+      stats.samples = CALIBRATION_SAMPLES;
+      stats.temperature = sumTemp / CALIBRATION_SAMPLES;
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        double mean = sumG[axis] / CALIBRATION_SAMPLES;
+        double variance = sumGG[axis] / CALIBRATION_SAMPLES - mean * mean;
+        stats.gyroStd[axis] = variance > 0 ? sqrt(variance) : 0;
+      }
+
+      resetOrientation();
+      refiner.finish();   // Fresh offsets need no refinement
+      addCalibrationObservation(stats.temperature);
+    }
+
+    // Warm start from EEPROM; true when the (empty) bias model was seeded
+    bool restore(const CalibrationRecord &record) {
+      gyroOffsetX = record.gyroOffset[0];
+      gyroOffsetY = record.gyroOffset[1];
+      gyroOffsetZ = record.gyroOffset[2];
+      accelOffsetX = record.accelOffset[0];
+      accelOffsetY = record.accelOffset[1];
+      accelOffsetZ = record.accelOffset[2];
+      resetOrientation();
+      refiner.reset();
+
+      if (biasModel.hasData()) return false;
+      addCalibrationObservation(record.temperature);
+      return true;
+    }
+
+    void storeOffsets(CalibrationRecord &record) const {
+      record.gyroOffset[0] = gyroOffsetX;
+      record.gyroOffset[1] = gyroOffsetY;
+      record.gyroOffset[2] = gyroOffsetZ;
+      record.accelOffset[0] = accelOffsetX;
+      record.accelOffset[1] = accelOffsetY;
+      record.accelOffset[2] = accelOffsetZ;
+    }
+
+    // Current calibration offsets as a model observation
+    void addCalibrationObservation(float temperature) {
+      biasModel.addObservation(temperature, gyroOffsetX, gyroOffsetY, gyroOffsetZ, BIAS_CALIBRATION_WEIGHT);
+    }
+
+    // Filters and angles back to zero (after a (re)calibration)
+    void resetOrientation() {
+      pitch = roll = yaw = 0;
+      fusion.reset();
+      filteredGx = filteredGy = filteredGz = 0;
+      stationaryDetector.reset();
+      residualBiasX = residualBiasY = residualBiasZ = 0;
+      pitchDriftCompensation = rollDriftCompensation = yawDriftCompensation = 0;
+    }
+
+    // Tilt is defined by gravity, only the heading is reset
+    void resetAngles() {
+      pitch = roll = yaw = 0;
+      fusion.resetYaw();
+    }
+
+    // One sample, deltaTime in seconds; returns BIAS_ORIENTATION_* bits
+    uint8_t update(const MPU6050Sample &sample, float deltaTime) {
+      uint8_t changed = 0;
+
+      float accelX = (sample.ax / 16384.0) - accelOffsetX;
+      float accelY = (sample.ay / 16384.0) - accelOffsetY;
+      float accelZ = (sample.az / 16384.0) - accelOffsetZ;
+      temperature = mpu6050Temperature(sample.temp);
+
+      // After a warm start the offsets are refined while the device is still
+      if (!refiner.isDone() &&
+          refiner.addSample(sample.gx / 131.0, sample.gy / 131.0, sample.gz / 131.0,
+                            gyroOffsetX, gyroOffsetY, gyroOffsetZ)) {
+        gyroOffsetX = refiner.offsetX();
+        gyroOffsetY = refiner.offsetY();
+        gyroOffsetZ = refiner.offsetZ();
+        addCalibrationObservation(temperature);
+        changed |= BIAS_ORIENTATION_REFINED | BIAS_ORIENTATION_MODEL_CHANGED;
+      }
+
+      // Gyro bias for the current temperature
+      biasModel.predict(temperature, gyroBiasX, gyroBiasY, gyroBiasZ);
+      float rateX = (sample.gx / 131.0) - gyroBiasX - residualBiasX;
+      float rateY = (sample.gy / 131.0) - gyroBiasY - residualBiasY;
+      float rateZ = (sample.gz / 131.0) - gyroBiasZ - residualBiasZ;
+
+      if (observeBias(rateX, rateY, rateZ, accelX, accelY, accelZ)) {
+        changed |= BIAS_ORIENTATION_MODEL_CHANGED;
+      }
+
+      rateX += pitchDriftCompensation;
+      rateY += rollDriftCompensation;
+      rateZ += yawDriftCompensation;
+
+      filteredGx = lowPass(rateX, filteredGx);
+      filteredGy = lowPass(rateY, filteredGy);
+      filteredGz = lowPass(rateZ, filteredGz);
+
+      ax = accelX; ay = accelY; az = accelZ;
+      gx = filteredGx; gy = filteredGy; gz = filteredGz;
+
+      // The accelerometer corrects tilt only near 1g, otherwise the
+      // quaternion follows the gyro alone
+      float accelMagnitude = sqrt(ax * ax + ay * ay + az * az);
+      bool accelValid = (accelMagnitude > 0.8 && accelMagnitude < 1.2);
+      fusion.update(gx * DEG_TO_RAD, gy * DEG_TO_RAD, gz * DEG_TO_RAD,
+                    accelValid ? ax : 0, accelValid ? ay : 0, accelValid ? az : 0,
+                    deltaTime);
+
+      pitch = fusion.getPitch();
+      roll = fusion.getRoll();
+      yaw = fusion.getYaw();
+      return changed;
+    }
+
+  private:
+    float filteredGx = 0, filteredGy = 0, filteredGz = 0;
+    unsigned long lastBiasObservation = 0;
+
+    static float lowPass(float current, float previous) {
+      return GYRO_LPF_ALPHA * previous + (1.0 - GYRO_LPF_ALPHA) * current;
+    }
+
+    // Residual tracking on every still sample, model observations from
+    // stationary windows at most every BIAS_OBSERVATION_INTERVAL. Rates
+    // come without the predicted and residual bias
+    bool observeBias(float rateX, float rateY, float rateZ, float accelX, float accelY, float accelZ) {
+      bool stationary = stationaryDetector.update(rateX, rateY, rateZ, accelX, accelY, accelZ);
+      if (!refiner.isDone()) return false;
+      if (stationary) {
+        trackGyroBias(residualBiasX, residualBiasY, residualBiasZ, rateX, rateY, rateZ, BIAS_TRACKING_RATE);
+      }
+
+      // Only windows that are still from end to end
+      if (!stationary || stationaryDetector.stillSamples() < STATIONARY_WINDOW) return false;
+      unsigned long now = millis();
+      if (now - lastBiasObservation < BIAS_OBSERVATION_INTERVAL) return false;
+
+      biasModel.addObservation(temperature,
+                               gyroBiasX + residualBiasX + stationaryDetector.gyroMean(0),
+                               gyroBiasY + residualBiasY + stationaryDetector.gyroMean(1),
+                               gyroBiasZ + residualBiasZ + stationaryDetector.gyroMean(2));
+      lastBiasObservation = now;
+
+      // The total bias stays where it was: the model takes over what it now explains
+      float biasX, biasY, biasZ;
+      biasModel.predict(temperature, biasX, biasY, biasZ);
+      residualBiasX += gyroBiasX - biasX;
+      residualBiasY += gyroBiasY - biasY;
+      residualBiasZ += gyroBiasZ - biasZ;
+      gyroBiasX = biasX;
+      gyroBiasY = biasY;
+      gyroBiasZ = biasZ;
+      return true;
+    }
+};
+
+#endif
@@ -4,7 +4,14 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <BLE2902.h>
+#include <EEPROM.h>
 #include <math.h>
+#include "TelemetryFormat.h"
+#include "CalibrationStore.h"
+#include "MPU6050Bus.h"
+#include "SampleRing.h"
+#include "TaskMetrics.h"
+#include "SendPolicy.h"
 
 // UUID для службы и характеристики
 #define SERVICE_UUID        "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
@@ -18,10 +25,58 @@
 // Настройка светодиода
 #define LED_PIN 2
 
+// Режим чтения MPU6050: 1 - FIFO + прерывание DATA_RDY, 0 - опрос регистров 0x3B
+#define USE_MPU_FIFO 1
+#define MPU_INT_PIN 4              // Вывод INT MPU6050
+#define MPU_SAMPLE_RATE_DIV 0      // Частота выборки = 1 кГц / (1 + DIV) при включенном DLPF
+#define MPU_SAMPLE_PERIOD ((1 + MPU_SAMPLE_RATE_DIV) / 1000.0)
+#define MPU_SAMPLE_PERIOD_US ((1 + MPU_SAMPLE_RATE_DIV) * 1000UL)
+#define MPU_SAMPLE_BYTES MPU6050_SAMPLE_BYTES  // ACCEL(6) + TEMP(2) + GYRO(6), тот же порядок что и 0x3B..0x48
+#define MPU_FIFO_BURST_SAMPLES 9   // 9 * 14 = 126 байт, укладывается в буфер Wire (128)
+#define MPU_POLL_PERIOD_MS 5       // Период опроса регистров при USE_MPU_FIFO 0
+
+// Конвейер: чтение (ядро 1) -> очередь -> фьюжн (ядро 1) -> кольцо -> отправка по BLE (ядро 0)
+#define ACQUISITION_CORE 1
+#define FUSION_CORE 1
+#define TRANSPORT_CORE 0
+#define ACQUISITION_PRIORITY 4
+#define FUSION_PRIORITY 3
+#define TRANSPORT_PRIORITY 2
+#define ACQUISITION_STACK_SIZE 4096
+#define FUSION_STACK_SIZE 4096
+#define TRANSPORT_STACK_SIZE 4096
+#define RAW_QUEUE_LENGTH 64        // ~64 мс сырых отсчетов при 1 кГц
+#define COMMAND_QUEUE_LENGTH 8     // Команды BLE для задачи отправки
+#define FUSION_COMMAND_QUEUE_LENGTH 4   // Команды BLE для задачи фьюжна
+#define REPLY_QUEUE_LENGTH 4       // Ответы на команды BLE
+#define REPLY_MAX_LENGTH 512       // Предел атрибута BLE
+#define OUTPUT_DECIMATION 4        // Усреднение: 1 кГц фьюжн -> 250 Гц в кольцо
+#define SAMPLE_RING_SIZE 64        // ~0.25 с при 250 Гц
+
 // Константы для калибровки
 #define CALIBRATION_SAMPLES 200
 #define CALIBRATION_DELAY 5
 
+// Хранение калибровки в EEPROM (быстрый старт без калибровки)
+#define CALIBRATION_EEPROM_SIZE 128
+#define CALIBRATION_EEPROM_ADDR 0
+#define REFINE_STILL_THRESHOLD 2.0   // °/с, отклонение от сохраненного смещения
+#define REFINE_WINDOW_SAMPLES 1000   // ~1 с неподвижности при 1 кГц
+
+// Температурная модель смещения гироскопа
+#define BIAS_MODEL_EEPROM_ADDR 64
+#define BIAS_MAX_SLOPE 0.2               // °/с на °C
+#define BIAS_STILL_THRESHOLD 1.0         // °/с, среднее по окну после вычета смещения
+#define BIAS_NOISE_THRESHOLD 0.6         // °/с, СКО гироскопа в окне
+#define ACCEL_NOISE_THRESHOLD 0.02       // g, СКО модуля ускорения в окне
+#define STATIONARY_WINDOW 256            // ~0.26 с при 1 кГц
+#define BIAS_OBSERVATION_INTERVAL 10000  // мс между наблюдениями модели
+#define BIAS_SAVE_INTERVAL 300000        // мс между записями модели в EEPROM
+#define BIAS_CALIBRATION_WEIGHT 5.0      // Вес полной калибровки относительно окна
+
+// Обработка отсчета (смещения, модель, фильтр) - с константами выше
+#include "BiasModelOrientation.h"
+
 BLEServer* pServer = NULL;
 BLECharacteristic* pCharacteristic = NULL;
 bool deviceConnected = false;
@@ -38,17 +93,22 @@ struct SensorData {
 // Основные переменные для углов
 float pitch = 0, roll = 0, yaw = 0;                      // Текущие углы (фильтрованные)
 float displayPitch = 0, displayRoll = 0, displayYaw = 0; // Углы для отображения (нормализованные -180..180)
-float lastSentPitch = 0, lastSentRoll = 0, lastSentYaw = 0;
 
-// Смещения (калибровочные значения)
-float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
-float accelOffsetX = 0, accelOffsetY = 0, accelOffsetZ = 0;
+// Смещения, модель смещения гироскопа и кватернионный фильтр (см. BiasModelOrientation.h);
+// тот же код гоняет Benchmark/fusion_replay на ПК
+BiasModelOrientation orientation;
 
 bool calibrated = false;
 unsigned long lastTime = 0;
 
-// Для комплементарного фильтра
-float compPitch = 0, compRoll = 0, compYaw = 0;
+// Сохраненная калибровка и ее уточнение в фоне после быстрого старта
+CalibrationRecord calibrationRecord;
+bool warmStarted = false;
+unsigned long firstOrientationMs = 0;   // Время от старта до первой ориентации
+
+// Запись модели смещения в EEPROM не чаще BIAS_SAVE_INTERVAL
+unsigned long lastBiasSave = 0;
+bool biasModelDirty = false;
 
 // Относительный ноль
 float zeroPitch = 0, zeroRoll = 0, zeroYaw = 0;
@@ -61,24 +121,101 @@ double accumulatedPitch = 0, accumulatedRoll = 0, accumulatedYaw = 0;
 float prevNormalizedPitch = 0, prevNormalizedRoll = 0, prevNormalizedYaw = 0;
 bool firstMeasurement = true;
 
-// Улучшенная компенсация дрейфа
-float yawDriftCompensation = 0.0;
-float pitchDriftCompensation = 0.0;
-float rollDriftCompensation = 0.0;
+// Настройки отправки данных: кадр уходит, когда поза выходит из допуска
+// относительно общего с клиентом прогноза (см. SendPolicy.h)
+const float SEND_ERROR_BUDGET = 0.3;                // Допуск прогноза, °
+const unsigned long SEND_KEEPALIVE_US = 250000;     // Кадр не реже 4 Гц
+const unsigned long SEND_MIN_INTERVAL_US = 8000;    // Не чаще 125 Гц
+const unsigned long SEND_PREDICTION_HORIZON_US = 100000;
+const size_t SENSOR_DATA_MAX_LENGTH = 272;
+PredictiveSendPolicy sendPolicy(SEND_ERROR_BUDGET, SEND_KEEPALIVE_US,
+                                SEND_MIN_INTERVAL_US, SEND_PREDICTION_HORIZON_US);
 
-// Фильтр низких частот для гироскопа
-const float GYRO_LPF_ALPHA = 0.9;
-float filteredGx = 0, filteredGy = 0, filteredGz = 0;
+// Метки кадра для измерения задержки: номер кадра и время отсчета (micros())
+uint32_t frameSequence = 0;
+unsigned long lastSampleMicros = 0;   // Время отсчета, который сейчас отправляется
+unsigned long sampleMicros = 0;       // Время отсчета, который сейчас обрабатывается
 
-// Настройки отправки данных
-unsigned long lastDataSend = 0;
-const unsigned long SEND_INTERVAL = 50;
-const float CHANGE_THRESHOLD = 0.5;
+// Сырой отсчет из задачи чтения в задачу фьюжна
+struct RawSample {
+  MPU6050Sample sample;
+  uint32_t timestampUs;
+  float deltaTime;
+  bool fence;           // Не отсчет: фьюжн доработал все, что было в очереди до него
+};
+
+// Команды задаче отправки: ей принадлежат display*/accumulated*/zero* и отправка
+enum TransportCommand : uint8_t {
+  TRANSPORT_SEND_FRAME,       // GET_DATA
+  TRANSPORT_ANGLES_RESET,     // Фильтр сброшен по RESET_ANGLES
+  TRANSPORT_RECALIBRATED,     // Перекалибровка закончена
+  TRANSPORT_BIAS_MODEL_RESET, // Модель смещения начата заново
+  TRANSPORT_SET_ZERO,
+  TRANSPORT_RESET_ZERO,
+  TRANSPORT_RESET_PITCH,
+  TRANSPORT_RESET_ROLL,
+  TRANSPORT_RESET_YAW
+};
 
-// Глобальные массивы для калибровки (только для гироскопа, чтобы экономить память)
-float gxSamples[CALIBRATION_SAMPLES];
-float gySamples[CALIBRATION_SAMPLES];
-float gzSamples[CALIBRATION_SAMPLES];
+// Команды задаче фьюжна: ей принадлежат orientation (дрейф, модель
+// смещения, детектор покоя) и sensorData; ответ она кладет в replyQueue
+enum FusionCommand : uint8_t {
+  FUSION_ADJUST_DRIFT,
+  FUSION_RESET_DRIFT_COMP,
+  FUSION_BIAS_MODEL,
+  FUSION_STATUS,
+  FUSION_TEMP,
+  FUSION_DATA,
+  FUSION_ACCEL,
+  FUSION_GYRO
+};
+
+// Ответ на команду BLE, который отправит задача отправки
+struct BluetoothReply {
+  uint16_t length;
+  char text[REPLY_MAX_LENGTH];
+};
+
+// Задача чтения владеет I2C, задача фьюжна - pitch/roll/yaw и фильтрами,
+// задача отправки - display*/accumulated*. Между ними только очередь и кольцо.
+QueueHandle_t rawQueue = NULL;
+SampleRing<OrientationSample, SAMPLE_RING_SIZE> orientationRing;
+OrientationDecimator outputDecimator(OUTPUT_DECIMATION);
+TaskHandle_t acquisitionTaskHandle = NULL;
+TaskHandle_t fusionTaskHandle = NULL;
+TaskHandle_t transportTaskHandle = NULL;
+unsigned long ringSamples = 0;
+unsigned long rawQueueDrops = 0;
+
+// Перекалибровка: фьюжн отдает семафор, когда дошел до метки в rawQueue
+SemaphoreHandle_t fusionDrained = NULL;
+
+// Команды и ответы BLE - в задачу отправки; записи EEPROM (одна последняя
+// каждого вида) - тоже в нее, чтобы EEPROM.commit() не стоял в фьюжне
+QueueHandle_t commandQueue = NULL;
+QueueHandle_t fusionCommandQueue = NULL;
+QueueHandle_t replyQueue = NULL;
+QueueHandle_t calibrationSaveQueue = NULL;
+QueueHandle_t biasModelSaveQueue = NULL;
+
+// Нагрузка и стек задач (команда TASKS)
+TaskMetrics acquisitionMetrics;
+TaskMetrics fusionMetrics;
+TaskMetrics transportMetrics;
+
+// Команды, которые трогают I2C или фильтр, выполняют задачи чтения и фьюжна
+volatile bool recalibrateRequested = false;
+volatile bool resetAnglesRequested = false;
+volatile bool resetBiasModelRequested = false;
+
+// Весь обмен с MPU6050 по I2C идет через mpuBus (см. MPU6050Bus.h)
+MPU6050Bus<TwoWire> mpuBus(Wire, MPU_ADDR);
+uint8_t mpuWhoAmI = 0;   // WHO_AM_I читается один раз в setup()
+
+// Состояние FIFO
+volatile bool mpuDataReady = false;
+unsigned long fifoOverflows = 0;
+unsigned long fifoSamples = 0;
 
 // Установка относительного нуля
 void setZeroPoint() {
@@ -173,103 +310,41 @@ double getRelativeYaw() {
   return accumulatedYaw - zeroYaw;
 }
 
-// Фильтр низких частот
-float lowPassFilter(float current, float previous, float alpha) {
-  return alpha * previous + (1.0 - alpha) * current;
-}
-
-// Калибровка сенсора - упрощенная версия без массивов для акселерометра
+// Калибровка сенсора: смещения гироскопа и акселерометра
 void calibrateSensor() {
   Serial.println("Calibrating MPU6050...");
   
-  float sumGx = 0, sumGy = 0, sumGz = 0;
-  float sumAx = 0, sumAy = 0, sumAz = 0;
-  
-  // Прогрев
-  for (int i = 0; i < 50; i++) {
-    Wire.beginTransmission(MPU_ADDR);
-    Wire.write(0x43);
-    Wire.endTransmission(false);
-    Wire.requestFrom(MPU_ADDR, 6, true);
-    while (Wire.available() < 6);
-    Wire.read(); Wire.read(); Wire.read(); Wire.read(); Wire.read(); Wire.read();
-    delay(10);
-  }
-  
-  // Калибровка гироскопа и акселерометра
-  for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
-    Wire.beginTransmission(MPU_ADDR);
-    Wire.write(0x3B);
-    Wire.endTransmission(false);
-    Wire.requestFrom(MPU_ADDR, 14, true);
-    
-    if (Wire.available() >= 14) {
-      int16_t ax_raw = Wire.read() << 8 | Wire.read();
-      int16_t ay_raw = Wire.read() << 8 | Wire.read();
-      int16_t az_raw = Wire.read() << 8 | Wire.read();
-      
-      Wire.read(); Wire.read(); // Температура
-      
-      int16_t gx_raw = Wire.read() << 8 | Wire.read();
-      int16_t gy_raw = Wire.read() << 8 | Wire.read();
-      int16_t gz_raw = Wire.read() << 8 | Wire.read();
-      
-      // Гироскоп
-      float gx = gx_raw / 131.0;
-      float gy = gy_raw / 131.0;
-      float gz = gz_raw / 131.0;
-      
-      // Сохраняем только гироскоп в массивы для вычисления стандартного отклонения
-      gxSamples[i] = gx;
-      gySamples[i] = gy;
-      gzSamples[i] = gz;
-      
-      sumGx += gx;
-      sumGy += gy;
-      sumGz += gz;
-      
-      // Акселерометр - только суммируем, не сохраняем в массивы
-      float ax = ax_raw / 16384.0;
-      float ay = ay_raw / 16384.0;
-      float az = az_raw / 16384.0;
-      
-      sumAx += ax;
-      sumAy += ay;
-      sumAz += az;
-    }
-    delay(CALIBRATION_DELAY);
-    
-    if (i % 20 == 0) Serial.print(".");
-  }
-  Serial.println();
-  
-  // Вычисляем смещения
-  gyroOffsetX = sumGx / CALIBRATION_SAMPLES;
-  gyroOffsetY = sumGy / CALIBRATION_SAMPLES;
-  gyroOffsetZ = sumGz / CALIBRATION_SAMPLES;
-  
-  accelOffsetX = sumAx / CALIBRATION_SAMPLES;
-  accelOffsetY = sumAy / CALIBRATION_SAMPLES;
-  accelOffsetZ = (sumAz / CALIBRATION_SAMPLES) - 1.0; // Вычитаем гравитацию (1g)
-  
-  // Вычисляем стандартное отклонение только для гироскопа
-  float stdGx = 0, stdGy = 0, stdGz = 0;
-  
-  for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
-    stdGx += pow(gxSamples[i] - gyroOffsetX, 2);
-    stdGy += pow(gySamples[i] - gyroOffsetY, 2);
-    stdGz += pow(gzSamples[i] - gyroOffsetZ, 2);
-  }
+  BiasCalibrationStats stats;
+  orientation.calibrate(mpuBus, stats);
+  resetOrientationState();
+  calibrated = true;
   
-  stdGx = sqrt(stdGx / CALIBRATION_SAMPLES);
-  stdGy = sqrt(stdGy / CALIBRATION_SAMPLES);
-  stdGz = sqrt(stdGz / CALIBRATION_SAMPLES);
+  // Свежая калибровка не требует уточнения, сохраняем ее
+  warmStarted = false;
+  storeCalibration(stats.temperature, stats.samples);
+  requestBiasModelSave();
   
-  // Сбрасываем все состояния
-  calibrated = true;
+  Serial.println("\nCalibration complete!");
+  Serial.print("Gyro Offsets - X: "); Serial.print(orientation.gyroOffsetX, 6);
+  Serial.print(" Y: "); Serial.print(orientation.gyroOffsetY, 6);
+  Serial.print(" Z: "); Serial.println(orientation.gyroOffsetZ, 6);
+  Serial.print("Accel Offsets - X: "); Serial.print(orientation.accelOffsetX, 6);
+  Serial.print(" Y: "); Serial.print(orientation.accelOffsetY, 6);
+  Serial.print(" Z: "); Serial.println(orientation.accelOffsetZ, 6);
+  Serial.print("Gyro Std Dev - X: "); Serial.print(stats.gyroStd[0], 6);
+  Serial.print(" Y: "); Serial.print(stats.gyroStd[1], 6);
+  Serial.print(" Z: "); Serial.println(stats.gyroStd[2], 6);
+}
+
+// Сброс углов фьюжна после (пере)калибровки; фильтры сбрасывает orientation
+void resetOrientationState() {
   pitch = 0;
   roll = 0;
   yaw = 0;
+}
+
+// Сброс углов задачи отправки (RESET_ANGLES, перекалибровка)
+void resetTransportAngles() {
   displayPitch = 0;
   displayRoll = 0;
   displayYaw = 0;
@@ -282,33 +357,77 @@ void calibrateSensor() {
   prevNormalizedRoll = 0;
   prevNormalizedYaw = 0;
   firstMeasurement = true;
+}
+
+// Текущие смещения - в очередь записи EEPROM (пишет задача отправки)
+void storeCalibration(float temperature, uint32_t samples) {
+  CalibrationRecord record;
+  initCalibrationRecord(record, mpuWhoAmI, MPU_ADDR, CALIBRATION_GYRO_DEG_S);
+  orientation.storeOffsets(record);
+  record.temperature = temperature;
+  record.sampleCount = samples;
+  xQueueOverwrite(calibrationSaveQueue, &record);
+}
+
+// Быстрый старт: смещения из EEPROM, если датчик и температура совпадают
+bool loadStoredCalibration() {
+  MPU6050Sample sample;
+  if (!mpuBus.readSample(sample)) return false;
+  float temperature = mpu6050Temperature(sample.temp);
   
-  compPitch = 0;
-  compRoll = 0;
-  compYaw = 0;
-  filteredGx = 0;
-  filteredGy = 0;
-  filteredGz = 0;
+  if (!loadCalibration(CALIBRATION_EEPROM_ADDR, calibrationRecord, mpuWhoAmI, MPU_ADDR,
+                       CALIBRATION_GYRO_DEG_S, temperature)) {
+    return false;
+  }
   
-  // Сбрасываем компенсацию дрейфа
-  pitchDriftCompensation = 0;
-  rollDriftCompensation = 0;
-  yawDriftCompensation = 0;
+  // Модель без данных начинается с сохраненной калибровки
+  if (orientation.restore(calibrationRecord)) {
+    biasModelDirty = true;
+  }
+  resetOrientationState();
+  calibrated = true;
+  warmStarted = true;
   
-  Serial.println("\nCalibration complete!");
-  Serial.print("Gyro Offsets - X: "); Serial.print(gyroOffsetX, 6);
-  Serial.print(" Y: "); Serial.print(gyroOffsetY, 6);
-  Serial.print(" Z: "); Serial.println(gyroOffsetZ, 6);
-  Serial.print("Accel Offsets - X: "); Serial.print(accelOffsetX, 6);
-  Serial.print(" Y: "); Serial.print(accelOffsetY, 6);
-  Serial.print(" Z: "); Serial.println(accelOffsetZ, 6);
-  Serial.print("Gyro Std Dev - X: "); Serial.print(stdGx, 6);
-  Serial.print(" Y: "); Serial.print(stdGy, 6);
-  Serial.print(" Z: "); Serial.println(stdGz, 6);
-}
-
-// Формирование строки с данными для отправки
-String getSensorDataString() {
+  Serial.print("Calibration loaded from EEPROM (stored T=");
+  Serial.print(calibrationRecord.temperature, 1);
+  Serial.print("C, now T="); Serial.print(temperature, 1); Serial.println("C)");
+  Serial.print("Gyro Offsets - X: "); Serial.print(orientation.gyroOffsetX, 6);
+  Serial.print(" Y: "); Serial.print(orientation.gyroOffsetY, 6);
+  Serial.print(" Z: "); Serial.println(orientation.gyroOffsetZ, 6);
+  return true;
+}
+
+// Копия модели смещения - в очередь записи EEPROM
+void requestBiasModelSave() {
+  xQueueOverwrite(biasModelSaveQueue, &orientation.biasModel);
+  biasModelDirty = false;
+  lastBiasSave = millis();
+}
+
+// Запись в EEPROM того, что накопилось в очередях (задача отправки)
+void persistPendingRecords() {
+  CalibrationRecord record;
+  if (xQueueReceive(calibrationSaveQueue, &record, 0) == pdTRUE) {
+    saveCalibration(CALIBRATION_EEPROM_ADDR, record);
+    Serial.print("Calibration saved to EEPROM, T=");
+    Serial.print(record.temperature, 1); Serial.println("C");
+  }
+  
+  static GyroBiasModel model(BIAS_MAX_SLOPE);
+  if (xQueueReceive(biasModelSaveQueue, &model, 0) == pdTRUE) {
+    saveGyroBiasModel(BIAS_MODEL_EEPROM_ADDR, model, mpuWhoAmI, MPU_ADDR, CALIBRATION_GYRO_DEG_S);
+  }
+}
+
+// Поля строки данных: PITCH:..,ROLL:..,...,ACC_YAW:..
+static const TelemetryField SENSOR_DATA_FIELDS[] = {
+  {"PITCH:", 1}, {",ROLL:", 1}, {",YAW:", 1},
+  {",REL_PITCH:", 2}, {",REL_ROLL:", 2}, {",REL_YAW:", 2},
+  {",ACC_PITCH:", 2}, {",ACC_ROLL:", 2}, {",ACC_YAW:", 2}
+};
+
+// Формирование строки с данными для отправки (без выделения памяти в куче)
+void formatSensorData(TelemetryBuffer &out) {
   // Обновляем накопленные углы
   updateAccumulatedAngles();
   
@@ -316,32 +435,87 @@ String getSensorDataString() {
   float relRoll = getRelativeRoll();
   float relYaw = getRelativeYaw();
   
-  String data = "PITCH:" + String(displayPitch, 1) + 
-                ",ROLL:" + String(displayRoll, 1) + 
-                ",YAW:" + String(displayYaw, 1) +
-                ",REL_PITCH:" + String(relPitch, 2) +
-                ",REL_ROLL:" + String(relRoll, 2) +
-                ",REL_YAW:" + String(relYaw, 2) +
-                ",ACC_PITCH:" + String(accumulatedPitch, 2) +
-                ",ACC_ROLL:" + String(accumulatedRoll, 2) +
-                ",ACC_YAW:" + String(accumulatedYaw, 2) +
-                ",ZERO_SET:" + String(zeroSet ? "true" : "false") +
-                ",UNLIMITED:true";
+  const double values[] = {
+    displayPitch, displayRoll, displayYaw,
+    relPitch, relRoll, relYaw,
+    accumulatedPitch, accumulatedRoll, accumulatedYaw
+  };
   
-  return data;
+  out.clear();
+  out.fields(SENSOR_DATA_FIELDS, values)
+     .text(",ZERO_SET:").boolean(zeroSet)
+     .text(",UNLIMITED:true")
+     .text(",SEQ:").number(++frameSequence)
+     .text(",TS:").number(lastSampleMicros)
+     .text(",RATE_P:").fixed(sendPolicy.rate(0), 1)
+     .text(",RATE_R:").fixed(sendPolicy.rate(1), 1)
+     .text(",RATE_Y:").fixed(sendPolicy.rate(2), 1);
 }
 
-// Проверка изменения данных для отправки
-bool dataChanged() {
-  return (abs(displayPitch - lastSentPitch) >= CHANGE_THRESHOLD ||
-          abs(displayRoll - lastSentRoll) >= CHANGE_THRESHOLD ||
-          abs(displayYaw - lastSentYaw) >= CHANGE_THRESHOLD);
+// Прерывание DATA_RDY: только выставляем флаг, чтение FIFO в loop()
+void IRAM_ATTR onMPUDataReady() {
+  mpuDataReady = true;
+  if (acquisitionTaskHandle != NULL) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(acquisitionTaskHandle, &woken);
+    if (woken) portYIELD_FROM_ISR();
+  }
 }
 
-// Основная функция расчета углов
-void calculateAngles() {
+// Сброс и включение FIFO (после калибровки и при переполнении)
+void resetMPUFifo() {
+  mpuBus.resetFifo();
+}
+
+// Настройка FIFO и прерывания DATA_RDY
+void initMPUFifo() {
+  mpuBus.configureFifo(MPU_SAMPLE_RATE_DIV);  // SMPLRT_DIV, FIFO_EN, прерывания, сброс FIFO
+  
+  pinMode(MPU_INT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(MPU_INT_PIN), onMPUDataReady, RISING);
+  
+  Serial.println("MPU6050 FIFO enabled");
+}
+
+// Вычитывание всех накопленных в FIFO отсчетов пачками
+void drainMPUFifo() {
+  if (!mpuDataReady) return;
+  mpuDataReady = false;
+  
+  uint8_t buf[MPU_FIFO_BURST_SAMPLES * MPU_SAMPLE_BYTES];
+  
+  // Последний отсчет в FIFO снят примерно сейчас, предыдущие - на период раньше каждый
+  unsigned long readMicros = micros();
+  int samples = mpuBus.drainFifo(buf, MPU_FIFO_BURST_SAMPLES,
+    [readMicros](const MPU6050Sample &sample, uint16_t age) {
+      queueRawSample(sample, readMicros - (unsigned long)age * MPU_SAMPLE_PERIOD_US, MPU_SAMPLE_PERIOD);
+    });
+  if (samples < 0) {
+    fifoOverflows++;
+  } else {
+    fifoSamples += samples;
+  }
+}
+
+// Отсчет в очередь фьюжна; если фьюжн не успевает - отсчет теряется, чтение не ждет
+void queueRawSample(const MPU6050Sample &sample, uint32_t timestampUs, float deltaTime) {
+  RawSample item;
+  item.sample = sample;
+  item.timestampUs = timestampUs;
+  item.deltaTime = deltaTime;
+  item.fence = false;
+  if (xQueueSend(rawQueue, &item, 0) != pdTRUE) {
+    rawQueueDrops++;
+  }
+}
+
+// Чтение новых отсчетов MPU6050 (FIFO или регистры)
+void acquireMPUSamples() {
   if (!calibrated) return;
   
+#if USE_MPU_FIFO
+  drainMPUFifo();
+#else
   static unsigned long lastCalcTime = 0;
   unsigned long currentTime = micros();
   float deltaTime = (currentTime - lastCalcTime) / 1000000.0;
@@ -351,107 +525,321 @@ void calculateAngles() {
   }
   lastCalcTime = currentTime;
   
-  Wire.beginTransmission(MPU_ADDR);
-  Wire.write(0x3B);
-  Wire.endTransmission(false);
-  Wire.requestFrom(MPU_ADDR, 14, true);
-  
-  if (Wire.available() >= 14) {
-    int16_t ax_raw = Wire.read() << 8 | Wire.read();
-    int16_t ay_raw = Wire.read() << 8 | Wire.read();
-    int16_t az_raw = Wire.read() << 8 | Wire.read();
-    
-    int16_t temp_raw = Wire.read() << 8 | Wire.read();
-    
-    int16_t gx_raw = Wire.read() << 8 | Wire.read();
-    int16_t gy_raw = Wire.read() << 8 | Wire.read();
-    int16_t gz_raw = Wire.read() << 8 | Wire.read();
-    
-    // Конвертация с учетом калибровки
-    float ax = (ax_raw / 16384.0) - accelOffsetX;
-    float ay = (ay_raw / 16384.0) - accelOffsetY;
-    float az = (az_raw / 16384.0) - accelOffsetZ;
-    
-    sensorData.temperature = (temp_raw / 340.0) + 36.53;
-    
-    // Гироскоп с компенсацией смещения
-    float gx = (gx_raw / 131.0) - gyroOffsetX;
-    float gy = (gy_raw / 131.0) - gyroOffsetY;
-    float gz = (gz_raw / 131.0) - gyroOffsetZ;
+  MPU6050Sample sample;
+  if (mpuBus.readSample(sample)) {
+    queueRawSample(sample, currentTime, deltaTime);
+  }
+#endif
+}
+
+// Обработка одного отсчета с заданным периодом интегрирования
+void processMPUSample(const MPU6050Sample &sample, float deltaTime) {
+  uint8_t changed = orientation.update(sample, deltaTime);
+  
+  // После быстрого старта смещения уточняются, пока устройство неподвижно
+  if (changed & BIAS_ORIENTATION_REFINED) {
+    storeCalibration(orientation.temperature, orientation.refiner.samples());
+    Serial.print("Calibration refined - X: "); Serial.print(orientation.gyroOffsetX, 6);
+    Serial.print(" Y: "); Serial.print(orientation.gyroOffsetY, 6);
+    Serial.print(" Z: "); Serial.println(orientation.gyroOffsetZ, 6);
+  }
+  if (changed & BIAS_ORIENTATION_MODEL_CHANGED) {
+    biasModelDirty = true;
+  }
+  if (biasModelDirty && millis() - lastBiasSave >= BIAS_SAVE_INTERVAL) {
+    requestBiasModelSave();
+  }
+  
+  // Сохраняем данные для команд DATA/ACCEL/GYRO/TEMP
+  sensorData.ax = orientation.ax;
+  sensorData.ay = orientation.ay;
+  sensorData.az = orientation.az;
+  sensorData.gx = orientation.gx;
+  sensorData.gy = orientation.gy;
+  sensorData.gz = orientation.gz;
+  sensorData.temperature = orientation.temperature;
+  sensorData.uptime = millis() / 1000;
+  
+  if (firstOrientationMs == 0) {
+    firstOrientationMs = millis();
+  }
+  
+  // Текущие углы
+  pitch = orientation.pitch;
+  roll = orientation.roll;
+  yaw = orientation.yaw;
+  
+  // Усредненные блоки по OUTPUT_DECIMATION отсчетов уходят в кольцо для отправки
+  OrientationSample out;
+  if (outputDecimator.add(sampleMicros, pitch, roll, yaw, out)) {
+    orientationRing.push(out);
+  }
+}
+
+// Задача чтения: единственная, кто обращается к MPU6050 по I2C
+void acquisitionTask(void* parameter) {
+  acquisitionMetrics.attach(xTaskGetCurrentTaskHandle());
+#if !USE_MPU_FIFO
+  TickType_t lastWake = xTaskGetTickCount();
+#endif
+  
+  for (;;) {
+#if USE_MPU_FIFO
+    // Просыпаемся по DATA_RDY; по таймауту читаем FIFO на случай потерянного фронта
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(5)) == 0) {
+      mpuDataReady = true;
+    }
+#else
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(MPU_POLL_PERIOD_MS));
+#endif
+    acquisitionMetrics.begin();
     
-    // Применяем компенсацию дрейфа
-    gx += pitchDriftCompensation;
-    gy += rollDriftCompensation;
-    gz += yawDriftCompensation;
+    if (recalibrateRequested) {
+      // Останавливаем поток отсчетов и ставим метку в конец очереди: когда
+      // фьюжн до нее дошел, все отсчеты обработаны, и он ждет новых
+      calibrated = false;
+      RawSample fence = {};
+      fence.fence = true;
+      xQueueSend(rawQueue, &fence, portMAX_DELAY);
+      xSemaphoreTake(fusionDrained, portMAX_DELAY);
+      calibrateSensor();
+#if USE_MPU_FIFO
+      resetMPUFifo();
+#endif
+      outputDecimator.reset();
+      recalibrateRequested = false;
+      queueTransportCommand(TRANSPORT_RECALIBRATED);
+    }
     
-    // Применяем фильтр низких частот для уменьшения шума
-    filteredGx = lowPassFilter(gx, filteredGx, GYRO_LPF_ALPHA);
-    filteredGy = lowPassFilter(gy, filteredGy, GYRO_LPF_ALPHA);
-    filteredGz = lowPassFilter(gz, filteredGz, GYRO_LPF_ALPHA);
+    acquireMPUSamples();
+    acquisitionMetrics.end();
+  }
+}
+
+// Команды BLE, которые читают или меняют состояние фильтра: выполняются
+// между отсчетами, ответ уходит через задачу отправки
+void handleFusionCommands() {
+  static TelemetryMessage<REPLY_MAX_LENGTH> msg;
+  FusionCommand command;
+  while (xQueueReceive(fusionCommandQueue, &command, 0) == pdTRUE) {
+    msg.clear();
+    switch (command) {
+      case FUSION_ADJUST_DRIFT:
+        // Ручная корректировка дрейфа на основе текущих показаний
+        orientation.yawDriftCompensation -= sensorData.gz * 0.5;
+        orientation.pitchDriftCompensation -= sensorData.gx * 0.5;
+        orientation.rollDriftCompensation -= sensorData.gy * 0.5;
+        msg.text("DRIFT_ADJUSTED:P=").fixed(orientation.pitchDriftCompensation, 6)
+           .text(",R=").fixed(orientation.rollDriftCompensation, 6)
+           .text(",Y=").fixed(orientation.yawDriftCompensation, 6);
+        break;
+      case FUSION_RESET_DRIFT_COMP:
+        orientation.pitchDriftCompensation = 0;
+        orientation.rollDriftCompensation = 0;
+        orientation.yawDriftCompensation = 0;
+        msg.text("DRIFT_COMPENSATION_RESET");
+        break;
+      case FUSION_BIAS_MODEL: {
+        const GyroBiasModel &biasModel = orientation.biasModel;
+        msg.text("BIAS_MODEL:Obs=").number(biasModel.count())
+           .text(",Spread=").fixed(biasModel.temperatureSpread(), 1).text("C")
+           .text(",SlopeX=").fixed(biasModel.getSlope(0), 5)
+           .text(",SlopeY=").fixed(biasModel.getSlope(1), 5)
+           .text(",SlopeZ=").fixed(biasModel.getSlope(2), 5)
+           .text(",BiasZ=").fixed(orientation.gyroBiasZ, 5)
+           .text(",ResidualZ=").fixed(orientation.residualBiasZ, 5);
+        break;
+      }
+      case FUSION_STATUS:
+        msg.text("STATUS:StableUnlimited,Uptime:").number(millis() / 1000)
+           .text("s,Calibrated:").text(calibrated ? "Yes" : "No")
+           .text(",ZeroSet:").text(zeroSet ? "Yes" : "No")
+           .text(",Temp:").fixed(sensorData.temperature, 1).text("C")
+           .text(",DriftP:").fixed(orientation.pitchDriftCompensation, 6)
+           .text(",DriftR:").fixed(orientation.rollDriftCompensation, 6)
+           .text(",DriftY:").fixed(orientation.yawDriftCompensation, 6)
+           .text(",CalSource:").text(warmStarted ? "Stored" : "Fresh")
+           .text(",CalRefined:").text(orientation.refiner.isDone() ? "Yes" : "No")
+           .text(",FirstOrientation:").number(firstOrientationMs).text("ms")
+           .text(",Stationary:").text(orientation.stationaryDetector.isStationary() ? "Yes" : "No")
+           .text(",BiasObs:").number(orientation.biasModel.count())
+           .text(",BiasSlopeZ:").fixed(orientation.biasModel.getSlope(2), 5);
+#if USE_MPU_FIFO
+        msg.text(",FifoSamples:").number(fifoSamples)
+           .text(",FifoOverflows:").number(fifoOverflows);
+#endif
+        msg.text(",Decimation:").number(outputDecimator.getFactor())
+           .text(",RingDrops:").number(orientationRing.dropped());
+        break;
+      case FUSION_TEMP:
+        msg.text("TEMPERATURE:").fixed(sensorData.temperature, 2).text("C");
+        break;
+      case FUSION_DATA:
+        msg.text("RAW:AX:").fixed(sensorData.ax, 3)
+           .text(",AY:").fixed(sensorData.ay, 3)
+           .text(",AZ:").fixed(sensorData.az, 3)
+           .text(",GX:").fixed(sensorData.gx, 3)
+           .text(",GY:").fixed(sensorData.gy, 3)
+           .text(",GZ:").fixed(sensorData.gz, 3)
+           .text(",TEMP:").fixed(sensorData.temperature, 2);
+        break;
+      case FUSION_ACCEL:
+        msg.text("ACCEL:AX:").fixed(sensorData.ax, 3)
+           .text(",AY:").fixed(sensorData.ay, 3)
+           .text(",AZ:").fixed(sensorData.az, 3);
+        break;
+      case FUSION_GYRO:
+        msg.text("GYRO:GX:").fixed(sensorData.gx, 3)
+           .text(",GY:").fixed(sensorData.gy, 3)
+           .text(",GZ:").fixed(sensorData.gz, 3);
+        break;
+    }
+    replyBluetooth(msg);
+  }
+}
+
+// Задача фьюжна: фильтр для каждого отсчета из очереди, результат - в кольцо
+void fusionTask(void* parameter) {
+  fusionMetrics.attach(xTaskGetCurrentTaskHandle());
+  
+  for (;;) {
+    RawSample item;
+    if (xQueueReceive(rawQueue, &item, portMAX_DELAY) != pdTRUE) continue;
+    if (item.fence) {
+      xSemaphoreGive(fusionDrained);
+      continue;
+    }
+    fusionMetrics.begin();
     
-    // Используем отфильтрованные значения
-    gx = filteredGx;
-    gy = filteredGy;
-    gz = filteredGz;
+    if (resetAnglesRequested) {
+      orientation.resetAngles();
+      pitch = 0;
+      roll = 0;
+      yaw = 0;
+      outputDecimator.reset();
+      resetAnglesRequested = false;
+      queueTransportCommand(TRANSPORT_ANGLES_RESET);
+    }
     
-    // Сохраняем сырые данные
-    sensorData.ax = ax;
-    sensorData.ay = ay;
-    sensorData.az = az;
-    sensorData.gx = gx;
-    sensorData.gy = gy;
-    sensorData.gz = gz;
-    sensorData.uptime = millis() / 1000;
+    if (resetBiasModelRequested) {
+      // Модель начинается заново с текущей калибровки
+      orientation.biasModel.reset();
+      orientation.addCalibrationObservation(orientation.temperature);
+      requestBiasModelSave();
+      resetBiasModelRequested = false;
+      queueTransportCommand(TRANSPORT_BIAS_MODEL_RESET);
+    }
     
-    // ДЕЛЬТЫ углов
-    float deltaPitch = gx * deltaTime;
-    float deltaRoll = gy * deltaTime;
-    float deltaYaw = gz * deltaTime;
+    handleFusionCommands();
     
-    // Расчет углов по акселерометру
-    float accelPitch = 0, accelRoll = 0;
-    float accelMagnitude = sqrt(ax*ax + ay*ay + az*az);
+    sampleMicros = item.timestampUs;
+    processMPUSample(item.sample, item.deltaTime);
     
-    if (accelMagnitude > 0.8 && accelMagnitude < 1.2) {
-      accelPitch = atan2(ay, sqrt(ax*ax + az*az)) * 180.0 / PI;
-      accelRoll = atan2(-ax, sqrt(ay*ay + az*az)) * 180.0 / PI;
+    fusionMetrics.end();
+  }
+}
+
+// Последний усредненный отсчет из кольца становится текущим для отправки
+bool takeLatestOrientation() {
+  OrientationSample sample;
+  if (!orientationRing.popLatest(sample)) return false;
+  
+  displayPitch = normalizeAngle(sample.pitch);
+  displayRoll = normalizeAngle(sample.roll);
+  displayYaw = normalizeAngle(sample.yaw);
+  lastSampleMicros = sample.timestampUs;
+  ringSamples++;
+  return true;
+}
+
+// Кадр с углами: формирует и отправляет только задача отправки
+void sendSensorFrame() {
+  static TelemetryMessage<SENSOR_DATA_MAX_LENGTH> data;
+  formatSensorData(data);
+  sendBluetoothMessage(data);
+}
+
+// Отсчеты в кольце до сброса углов фьюжна больше не нужны
+void discardStaleOrientation() {
+  OrientationSample stale;
+  orientationRing.popLatest(stale);
+}
+
+// Команды из колбэка BLE и сигналы задач чтения и фьюжна
+void handleTransportCommands() {
+  TransportCommand command;
+  while (xQueueReceive(commandQueue, &command, 0) == pdTRUE) {
+    switch (command) {
+      case TRANSPORT_SEND_FRAME:
+        sendSensorFrame();
+        break;
+      case TRANSPORT_ANGLES_RESET:
+        discardStaleOrientation();
+        resetTransportAngles();
+        sendPolicy.reset();
+        if (zeroSet) {
+          zeroPitch = 0;
+          zeroRoll = 0;
+          zeroYaw = 0;
+        }
+        sendBluetoothMessage("ANGLES_RESET");
+        sendSensorFrame();
+        break;
+      case TRANSPORT_RECALIBRATED:
+        discardStaleOrientation();
+        resetTransportAngles();
+        sendBluetoothMessage("RECALIBRATION_COMPLETE");
+        break;
+      case TRANSPORT_BIAS_MODEL_RESET:
+        sendBluetoothMessage("BIAS_MODEL_RESET");
+        break;
+      case TRANSPORT_SET_ZERO:
+        setZeroPoint();
+        sendBluetoothMessage("ZERO_POINT_SET");
+        break;
+      case TRANSPORT_RESET_ZERO:
+        resetZeroPoint();
+        sendBluetoothMessage("ZERO_POINT_RESET");
+        break;
+      case TRANSPORT_RESET_PITCH:
+        accumulatedPitch = 0;
+        sendBluetoothMessage("PITCH_RESET_TO_ZERO");
+        break;
+      case TRANSPORT_RESET_ROLL:
+        accumulatedRoll = 0;
+        sendBluetoothMessage("ROLL_RESET_TO_ZERO");
+        break;
+      case TRANSPORT_RESET_YAW:
+        accumulatedYaw = 0;
+        sendBluetoothMessage("YAW_RESET_TO_ZERO");
+        break;
     }
-    
-    // Комплементарный фильтр
-    static float lastAccelPitch = 0, lastAccelRoll = 0;
-    
-    if (accelMagnitude > 0.8 && accelMagnitude < 1.2) {
-      if (abs(accelPitch - lastAccelPitch) < 30) {
-        compPitch = 0.98 * (compPitch + deltaPitch) + 0.02 * accelPitch;
-      } else {
-        compPitch += deltaPitch;
-      }
-      
-      if (abs(accelRoll - lastAccelRoll) < 30) {
-        compRoll = 0.98 * (compRoll + deltaRoll) + 0.02 * accelRoll;
-      } else {
-        compRoll += deltaRoll;
-      }
-      
-      lastAccelPitch = accelPitch;
-      lastAccelRoll = accelRoll;
-    } else {
-      compPitch += deltaPitch;
-      compRoll += deltaRoll;
+  }
+  
+  static BluetoothReply reply;
+  while (xQueueReceive(replyQueue, &reply, 0) == pdTRUE) {
+    sendBluetoothMessage(reply.text, reply.length);
+  }
+}
+
+// Задача отправки: BLE notify, записи EEPROM и отладочный вывод, сколько бы они ни длились
+void transportTask(void* parameter) {
+  transportMetrics.attach(xTaskGetCurrentTaskHandle());
+  
+  for (;;) {
+    transportMetrics.begin();
+    if (takeLatestOrientation()) {
+      sendPolicy.observe(lastSampleMicros, displayPitch, displayRoll, displayYaw);
     }
     
-    // Для Yaw используем только гироскоп
-    compYaw += deltaYaw;
+    handleTransportCommands();
+    persistPendingRecords();
     
-    // Текущие углы
-    pitch = compPitch;
-    roll = compRoll;
-    yaw = compYaw;
-    
-    // Углы для отображения (нормализованные -180..180)
-    displayPitch = normalizeAngle(pitch);
-    displayRoll = normalizeAngle(roll);
-    displayYaw = normalizeAngle(yaw);
+    if (deviceConnected &&
+        sendPolicy.due(lastSampleMicros, displayPitch, displayRoll, displayYaw)) {
+      sendSensorFrame();
+      sendPolicy.sent(lastSampleMicros, displayPitch, displayRoll, displayYaw);
+    }
     
     // Отладочный вывод каждые 10 секунд
     static unsigned long lastDebugPrint = 0;
@@ -464,27 +852,92 @@ void calculateAngles() {
       Serial.print("°, R="); Serial.print(accumulatedRoll, 1);
       Serial.print("°, Y="); Serial.print(accumulatedYaw, 1); Serial.println("°");
       
-      Serial.print("Gyro: X="); Serial.print(gx, 3);
-      Serial.print("°/s, Y="); Serial.print(gy, 3);
-      Serial.print("°/s, Z="); Serial.print(gz, 3); Serial.println("°/s");
+      Serial.print("Gyro: X="); Serial.print(sensorData.gx, 3);
+      Serial.print("°/s, Y="); Serial.print(sensorData.gy, 3);
+      Serial.print("°/s, Z="); Serial.print(sensorData.gz, 3); Serial.println("°/s");
+      
+      Serial.print("Ring: drops="); Serial.print(orientationRing.dropped());
+      Serial.print(", taken="); Serial.println(ringSamples);
       
       lastDebugPrint = millis();
     }
+    
+    transportMetrics.end();
+    vTaskDelay(1);
   }
 }
 
+// Нагрузка (% ядра), итераций в секунду, самая долгая итерация и свободный стек задачи
+void formatTaskMetrics(TelemetryBuffer &out, const char* name, const TaskMetrics &metrics) {
+  out.text(name)
+     .text(":LOAD=").fixed(metrics.load() / 10.0, 1)
+     .text("%,RATE=").number(metrics.rate())
+     .text(",MAX_US=").number(metrics.maxIterationUs())
+     .text(",STACK_FREE=").number(metrics.stackFree());
+}
+
+void formatPipelineStatus(TelemetryBuffer &out) {
+  out.clear();
+  out.text("TASKS:");
+  formatTaskMetrics(out, "ACQ", acquisitionMetrics);
+  out.text(";");
+  formatTaskMetrics(out, "FUSION", fusionMetrics);
+  out.text(";");
+  formatTaskMetrics(out, "TX", transportMetrics);
+  out.text(";OUTPUT_HZ=").number(fusionMetrics.rate() / outputDecimator.getFactor())
+     .text(",RAW_QUEUE=").number((unsigned long)uxQueueMessagesWaiting(rawQueue))
+     .text(",RAW_DROPS=").number(rawQueueDrops)
+     .text(",RING_DROPS=").number(orientationRing.dropped());
+}
+
 // Отправка сообщения через Bluetooth
-void sendBluetoothMessage(String message) {
+void sendBluetoothMessage(const char* message, size_t length) {
   if (deviceConnected && pCharacteristic != NULL) {
-    pCharacteristic->setValue(message.c_str());
+    pCharacteristic->setValue((uint8_t*)message, length);
     pCharacteristic->notify();
   }
 }
 
+void sendBluetoothMessage(const TelemetryBuffer &message) {
+  sendBluetoothMessage(message.c_str(), message.length());
+}
+
+void sendBluetoothMessage(String message) {
+  sendBluetoothMessage(message.c_str(), message.length());
+}
+
+// Команда задаче отправки; из колбэка BLE и из задач чтения и фьюжна
+void queueTransportCommand(TransportCommand command) {
+  xQueueSend(commandQueue, &command, 0);
+}
+
+// Команда задаче фьюжна из колбэка BLE
+void queueFusionCommand(FusionCommand command) {
+  xQueueSend(fusionCommandQueue, &command, 0);
+}
+
+// Ответ из колбэка BLE: notify делает задача отправки
+void replyBluetooth(const char* message, size_t length) {
+  static BluetoothReply reply;   // Колбэки BLE идут по одному из задачи стека
+  if (length > REPLY_MAX_LENGTH) length = REPLY_MAX_LENGTH;
+  reply.length = length;
+  memcpy(reply.text, message, length);
+  xQueueSend(replyQueue, &reply, 0);
+}
+
+void replyBluetooth(const TelemetryBuffer &message) {
+  replyBluetooth(message.c_str(), message.length());
+}
+
+void replyBluetooth(String message) {
+  replyBluetooth(message.c_str(), message.length());
+}
+
 // Класс обратного вызова для BLE сервера
 class MyServerCallbacks: public BLEServerCallbacks {
     void onConnect(BLEServer* pServer) {
       deviceConnected = true;
+      sendPolicy.invalidate();   // Новому клиенту сразу отправляется полный кадр
       Serial.println("Устройство подключено по Bluetooth");
       digitalWrite(LED_PIN, HIGH);
     };
@@ -505,136 +958,83 @@ class MyCallbacks: public BLECharacteristicCallbacks {
         Serial.print("Получено по Bluetooth: ");
         Serial.println(value);
         
+        // Углы, фильтр и модель меняют задачи, которым они принадлежат;
+        // отвечает и шлет кадры только задача отправки
         if (value == "GET_DATA") {
-          String data = getSensorDataString();
-          sendBluetoothMessage(data);
+          queueTransportCommand(TRANSPORT_SEND_FRAME);
         }
         else if (value == "RECALIBRATE") {
-          calibrated = false;
-          calibrateSensor();
-          sendBluetoothMessage("RECALIBRATION_COMPLETE");
+          // Калибровка идет в задаче опроса, ответ RECALIBRATION_COMPLETE шлет задача отправки
+          recalibrateRequested = true;
         }
         else if (value == "RESET_ANGLES") {
-          accumulatedPitch = 0;
-          accumulatedRoll = 0;
-          accumulatedYaw = 0;
-          pitch = 0;
-          roll = 0;
-          yaw = 0;
-          displayPitch = 0;
-          displayRoll = 0;
-          displayYaw = 0;
-          compPitch = 0;
-          compRoll = 0;
-          compYaw = 0;
-          lastSentPitch = 0;
-          lastSentRoll = 0;
-          lastSentYaw = 0;
-          
-          // Сбрасываем состояния накопления
-          prevNormalizedPitch = 0;
-          prevNormalizedRoll = 0;
-          prevNormalizedYaw = 0;
-          firstMeasurement = true;
-          
-          if (zeroSet) {
-            zeroPitch = 0;
-            zeroRoll = 0;
-            zeroYaw = 0;
-          }
-          
-          sendBluetoothMessage("ANGLES_RESET");
-          String data = getSensorDataString();
-          sendBluetoothMessage(data);
+          // Фильтр сбрасывает фьюжн, накопленные углы и ответ - задача отправки
+          resetAnglesRequested = true;
         }
         else if (value == "SET_ZERO") {
-          setZeroPoint();
-          sendBluetoothMessage("ZERO_POINT_SET");
+          queueTransportCommand(TRANSPORT_SET_ZERO);
         }
         else if (value == "RESET_ZERO") {
-          resetZeroPoint();
-          sendBluetoothMessage("ZERO_POINT_RESET");
+          queueTransportCommand(TRANSPORT_RESET_ZERO);
         }
         else if (value == "ADJUST_DRIFT") {
-          // Ручная корректировка дрейфа на основе текущих показаний
-          yawDriftCompensation -= sensorData.gz * 0.5;
-          pitchDriftCompensation -= sensorData.gx * 0.5;
-          rollDriftCompensation -= sensorData.gy * 0.5;
-          
-          String msg = "DRIFT_ADJUSTED:P=" + String(pitchDriftCompensation, 6) +
-                       ",R=" + String(rollDriftCompensation, 6) +
-                       ",Y=" + String(yawDriftCompensation, 6);
-          sendBluetoothMessage(msg);
+          // Дрейф, модель смещения и sensorData принадлежат фьюжну
+          queueFusionCommand(FUSION_ADJUST_DRIFT);
         }
         else if (value == "RESET_DRIFT_COMP") {
-          pitchDriftCompensation = 0;
-          rollDriftCompensation = 0;
-          yawDriftCompensation = 0;
-          sendBluetoothMessage("DRIFT_COMPENSATION_RESET");
+          queueFusionCommand(FUSION_RESET_DRIFT_COMP);
+        }
+        else if (value == "BIAS_MODEL") {
+          queueFusionCommand(FUSION_BIAS_MODEL);
+        }
+        else if (value == "RESET_BIAS_MODEL") {
+          // Модель сбрасывает фьюжн, запись в EEPROM и ответ - задача отправки
+          resetBiasModelRequested = true;
         }
         else if (value == "LED ON") {
           digitalWrite(LED_PIN, HIGH);
-          sendBluetoothMessage("LED_ON");
+          replyBluetooth("LED_ON");
         }
         else if (value == "LED OFF") {
           digitalWrite(LED_PIN, LOW);
-          sendBluetoothMessage("LED_OFF");
+          replyBluetooth("LED_OFF");
         }
         else if (value == "STATUS") {
-          String status = "STATUS:StableUnlimited,Uptime:" + String(millis() / 1000) + 
-                         "s,Calibrated:" + (calibrated ? "Yes" : "No") +
-                         ",ZeroSet:" + (zeroSet ? "Yes" : "No") +
-                         ",Temp:" + String(sensorData.temperature, 1) + "C" +
-                         ",DriftP:" + String(pitchDriftCompensation, 6) +
-                         ",DriftR:" + String(rollDriftCompensation, 6) +
-                         ",DriftY:" + String(yawDriftCompensation, 6);
-          sendBluetoothMessage(status);
+          queueFusionCommand(FUSION_STATUS);
+        }
+        else if (value == "TASKS") {
+          TelemetryMessage<256> msg;
+          formatPipelineStatus(msg);
+          replyBluetooth(msg);
         }
         else if (value == "TEMP") {
-          String tempMsg = "TEMPERATURE:" + String(sensorData.temperature, 2) + "C";
-          sendBluetoothMessage(tempMsg);
+          queueFusionCommand(FUSION_TEMP);
         }
         else if (value == "DATA") {
-          String rawData = "RAW:AX:" + String(sensorData.ax, 3) + 
-                           ",AY:" + String(sensorData.ay, 3) + 
-                           ",AZ:" + String(sensorData.az, 3) + 
-                           ",GX:" + String(sensorData.gx, 3) + 
-                           ",GY:" + String(sensorData.gy, 3) + 
-                           ",GZ:" + String(sensorData.gz, 3) + 
-                           ",TEMP:" + String(sensorData.temperature, 2);
-          sendBluetoothMessage(rawData);
+          queueFusionCommand(FUSION_DATA);
         }
         else if (value == "ACCEL") {
-          String accelData = "ACCEL:AX:" + String(sensorData.ax, 3) + 
-                             ",AY:" + String(sensorData.ay, 3) + 
-                             ",AZ:" + String(sensorData.az, 3);
-          sendBluetoothMessage(accelData);
+          queueFusionCommand(FUSION_ACCEL);
         }
         else if (value == "GYRO") {
-          String gyroData = "GYRO:GX:" + String(sensorData.gx, 3) + 
-                            ",GY:" + String(sensorData.gy, 3) + 
-                            ",GZ:" + String(sensorData.gz, 3);
-          sendBluetoothMessage(gyroData);
+          queueFusionCommand(FUSION_GYRO);
         }
         else if (value == "SET_ANGLE:PITCH") {
-          accumulatedPitch = 0;
-          sendBluetoothMessage("PITCH_RESET_TO_ZERO");
+          queueTransportCommand(TRANSPORT_RESET_PITCH);
         }
         else if (value == "SET_ANGLE:ROLL") {
-          accumulatedRoll = 0;
-          sendBluetoothMessage("ROLL_RESET_TO_ZERO");
+          queueTransportCommand(TRANSPORT_RESET_ROLL);
         }
         else if (value == "SET_ANGLE:YAW") {
-          accumulatedYaw = 0;
-          sendBluetoothMessage("YAW_RESET_TO_ZERO");
+          queueTransportCommand(TRANSPORT_RESET_YAW);
         }
         else if (value == "RESTART") {
-          sendBluetoothMessage("RESTARTING...");
-          delay(100);
+          replyBluetooth("RESTARTING...");
+          delay(200);   // Ответ уходит из задачи отправки
           ESP.restart();
         } 
         else {
-          sendBluetoothMessage("ECHO:" + value);
+          replyBluetooth("ECHO:" + value);
         }
       }
     }
@@ -642,28 +1042,16 @@ class MyCallbacks: public BLECharacteristicCallbacks {
 
 // Инициализация MPU6050
 void initMPU6050() {
-  Wire.beginTransmission(MPU_ADDR);
-  Wire.write(0x6B);
-  Wire.write(0x00);
-  Wire.endTransmission(true);
+  mpuBus.writeRegister(0x6B, 0x00);  // PWR_MGMT_1: выход из сна
   delay(100);
   
-  Wire.beginTransmission(MPU_ADDR);
-  Wire.write(0x1B);
-  Wire.write(0x00);
-  Wire.endTransmission(true);
+  mpuBus.writeRegister(0x1B, 0x00);  // GYRO_CONFIG: ±250°/с
   delay(10);
   
-  Wire.beginTransmission(MPU_ADDR);
-  Wire.write(0x1C);
-  Wire.write(0x00);
-  Wire.endTransmission(true);
+  mpuBus.writeRegister(0x1C, 0x00);  // ACCEL_CONFIG: ±2g
   delay(10);
   
-  Wire.beginTransmission(MPU_ADDR);
-  Wire.write(0x1A);
-  Wire.write(0x03);
-  Wire.endTransmission(true);
+  mpuBus.writeRegister(0x1A, 0x03);  // CONFIG: DLPF 44 Гц
   delay(10);
   
   Serial.println("MPU6050 initialized");
@@ -695,9 +1083,32 @@ void setup() {
   }
   
   initMPU6050();
+  mpuWhoAmI = mpuBus.whoAmI();
   
-  Serial.println("Starting calibration... (keep device stationary!)");
-  calibrateSensor();
+  // Очереди до калибровки: ее записи в EEPROM сделает задача отправки
+  rawQueue = xQueueCreate(RAW_QUEUE_LENGTH, sizeof(RawSample));
+  commandQueue = xQueueCreate(COMMAND_QUEUE_LENGTH, sizeof(TransportCommand));
+  fusionCommandQueue = xQueueCreate(FUSION_COMMAND_QUEUE_LENGTH, sizeof(FusionCommand));
+  replyQueue = xQueueCreate(REPLY_QUEUE_LENGTH, sizeof(BluetoothReply));
+  calibrationSaveQueue = xQueueCreate(1, sizeof(CalibrationRecord));
+  biasModelSaveQueue = xQueueCreate(1, sizeof(GyroBiasModel));
+  fusionDrained = xSemaphoreCreateBinary();
+  
+  EEPROM.begin(CALIBRATION_EEPROM_SIZE);
+  if (loadGyroBiasModel(BIAS_MODEL_EEPROM_ADDR, orientation.biasModel, mpuWhoAmI, MPU_ADDR,
+                        CALIBRATION_GYRO_DEG_S)) {
+    Serial.print("Gyro bias model loaded, observations: ");
+    Serial.println(orientation.biasModel.count());
+  }
+  if (!loadStoredCalibration()) {
+    Serial.println("Starting calibration... (keep device stationary!)");
+    calibrateSensor();
+  }
+  
+#if USE_MPU_FIFO
+  // FIFO включаем после калибровки, чтобы он не переполнился за время калибровки
+  initMPUFifo();
+#endif
   
   Serial.println("Initializing BLE server...");
   BLEDevice::init("VR_Head_Stable_Fixed");
@@ -747,29 +1158,17 @@ void setup() {
     delay(300);
   }
   
-  lastDataSend = millis();
+  // Чтение и фьюжн на ядре 1, отправка на ядре 0 вместе со стеком BLE;
+  // loop() остается только рекламе BLE
+  xTaskCreatePinnedToCore(fusionTask, "fusion", FUSION_STACK_SIZE, NULL,
+                          FUSION_PRIORITY, &fusionTaskHandle, FUSION_CORE);
+  xTaskCreatePinnedToCore(acquisitionTask, "acquisition", ACQUISITION_STACK_SIZE, NULL,
+                          ACQUISITION_PRIORITY, &acquisitionTaskHandle, ACQUISITION_CORE);
+  xTaskCreatePinnedToCore(transportTask, "transport", TRANSPORT_STACK_SIZE, NULL,
+                          TRANSPORT_PRIORITY, &transportTaskHandle, TRANSPORT_CORE);
 }
 
 void loop() {
-  calculateAngles();
-  
-  if (deviceConnected) {
-    unsigned long currentTime = millis();
-    
-    if (currentTime - lastDataSend >= SEND_INTERVAL) {
-      if (dataChanged() || lastDataSend == 0) {
-        String data = getSensorDataString();
-        pCharacteristic->setValue(data.c_str());
-        pCharacteristic->notify();
-        
-        lastSentPitch = displayPitch;
-        lastSentRoll = displayRoll;
-        lastSentYaw = displayYaw;
-        lastDataSend = currentTime;
-      }
-    }
-  }
-  
   if (!deviceConnected && oldDeviceConnected) {
     delay(500);
     pServer->startAdvertising();
@@ -781,5 +1180,5 @@ void loop() {
     oldDeviceConnected = deviceConnected;
   }
   
-  delay(5);
+  delay(50);
 }
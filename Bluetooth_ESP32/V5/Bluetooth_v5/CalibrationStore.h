@@ -0,0 +1,170 @@
+/*
+  Persistent IMU calibration store (EEPROM / emulated EEPROM in flash)
+  Keeps gyro/accel offsets between boots so the tracker can warm-start
+  instead of running the blocking calibration every time.
+
+  Record layout (CalibrationRecord), protected by CRC-32:
+    magic, version, record size
+    sensor identity: WHO_AM_I register + I2C address
+    gyro units (the offsets are stored in the sketch's own units)
+    gyro and accel offsets, die temperature at calibration, sample count
+
+  A stored record is used only when everything matches and the current
+  temperature is within CALIBRATION_MAX_TEMP_DELTA of the stored one.
+
+  Usage:
+    CalibrationRecord record;
+    if (loadCalibration(CALIBRATION_EEPROM_ADDR, record, whoAmI, MPU_ADDR, CALIBRATION_GYRO_DEG_S, temperature)) {
+      ... use record.gyroOffset[], start CalibrationRefiner ...
+    }
+    saveCalibration(CALIBRATION_EEPROM_ADDR, record);
+
+  On ESP8266/ESP32 EEPROM.begin(size) must be called before load/save.
+*/
+
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <math.h>
+
+#define CALIBRATION_MAGIC           0x314C4143UL   // "CAL1"
+#define CALIBRATION_VERSION         1
+#define CALIBRATION_MAX_TEMP_DELTA  10.0f          // deg C
+
+// Units of CalibrationRecord::gyroOffset
+#define CALIBRATION_GYRO_DEG_S  1
+#define CALIBRATION_GYRO_RAD_S  2
+#define CALIBRATION_GYRO_RAW    3
+
+struct CalibrationRecord {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  uint8_t sensorId;       // WHO_AM_I (0x68 for MPU6050)
+  uint8_t sensorAddress;  // I2C address
+  uint8_t gyroUnits;      // CALIBRATION_GYRO_*
+  uint8_t reserved;
+  float gyroOffset[3];
+  float accelOffset[3];
+  float temperature;      // deg C at calibration time
+  uint32_t sampleCount;
+  uint32_t crc;           // CRC-32 of all fields above
+};
+
+inline uint32_t calibrationCrc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFFUL;
+  while (length--) {
+    crc ^= *data++;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : (crc >> 1);
+    }
+  }
+  return ~crc;
+}
+
+inline uint32_t calibrationRecordCrc(const CalibrationRecord& record) {
+  return calibrationCrc32((const uint8_t*)&record, offsetof(CalibrationRecord, crc));
+}
+
+// Fills magic/version/size/identity, offsets are set by the caller
+inline void initCalibrationRecord(CalibrationRecord& record, uint8_t sensorId, uint8_t sensorAddress, uint8_t gyroUnits) {
+  memset(&record, 0, sizeof(record));
+  record.magic = CALIBRATION_MAGIC;
+  record.version = CALIBRATION_VERSION;
+  record.size = sizeof(CalibrationRecord);
+  record.sensorId = sensorId;
+  record.sensorAddress = sensorAddress;
+  record.gyroUnits = gyroUnits;
+}
+
+// Returns true if a valid record for this sensor and temperature was found
+inline bool loadCalibration(int address, CalibrationRecord& record,
+                            uint8_t sensorId, uint8_t sensorAddress, uint8_t gyroUnits, float temperature) {
+  EEPROM.get(address, record);
+
+  if (record.magic != CALIBRATION_MAGIC) return false;
+  if (record.version != CALIBRATION_VERSION) return false;
+  if (record.size != sizeof(CalibrationRecord)) return false;
+  if (record.crc != calibrationRecordCrc(record)) return false;
+  if (record.sensorId != sensorId || record.sensorAddress != sensorAddress) return false;
+  if (record.gyroUnits != gyroUnits) return false;
+  if (fabsf(temperature - record.temperature) > CALIBRATION_MAX_TEMP_DELTA) return false;
+  return true;
+}
+
+inline void saveCalibration(int address, CalibrationRecord& record) {
+  record.crc = calibrationRecordCrc(record);
+  EEPROM.put(address, record);
+#if defined(ESP8266) || defined(ESP32)
+  EEPROM.commit();
+#endif
+}
+
+// Invalidates the stored record (next boot runs the full calibration)
+inline void eraseCalibration(int address) {
+  EEPROM.put(address, (uint32_t)0);
+#if defined(ESP8266) || defined(ESP32)
+  EEPROM.commit();
+#endif
+}
+
+/*
+  Background refinement of warm-started gyro offsets.
+  Collects a window of consecutive still samples (every axis within
+  stillThreshold of the current offset) without blocking the loop.
+  Any movement restarts the window.
+*/
+class CalibrationRefiner {
+  public:
+    CalibrationRefiner(float stillThreshold, uint16_t windowSamples)
+      : threshold(stillThreshold), window(windowSamples) {
+      reset();
+    }
+
+    void reset() {
+      sumX = sumY = sumZ = 0;
+      count = 0;
+      done = false;
+    }
+
+    // Nothing to refine (offsets come from a fresh full calibration)
+    void finish() { done = true; }
+
+    bool isDone() const { return done; }
+
+    // Raw rates (offsets not removed) and the offsets currently in use.
+    // Returns true once, when a full still window has been collected.
+    bool addSample(float gx, float gy, float gz, float offsetX, float offsetY, float offsetZ) {
+      if (done) return false;
+
+      if (fabsf(gx - offsetX) > threshold || fabsf(gy - offsetY) > threshold || fabsf(gz - offsetZ) > threshold) {
+        sumX = sumY = sumZ = 0;
+        count = 0;
+        return false;
+      }
+
+      sumX += gx;
+      sumY += gy;
+      sumZ += gz;
+      if (++count < window) return false;
+
+      done = true;
+      return true;
+    }
+
+    float offsetX() const { return count ? (float)(sumX / count) : 0; }
+    float offsetY() const { return count ? (float)(sumY / count) : 0; }
+    float offsetZ() const { return count ? (float)(sumZ / count) : 0; }
+    uint16_t samples() const { return count; }
+
+  private:
+    float threshold;
+    uint16_t window;
+    double sumX, sumY, sumZ;
+    uint16_t count;
+    bool done;
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*
+  Temperature-compensated gyro bias model
+  MPU6050 gyro bias moves with die temperature (head units warm up for
+  10+ minutes after power-on). The model fits, per axis,
+
+    bias(T) = intercept + slope * (T - GYRO_BIAS_REF_TEMP)
+
+  by weighted least squares over stationary observations (mean raw rate
+  of a still window + mean temperature). Old observations fade with a
+  forgetting factor, so the fit follows slow changes of the sensor.
+
+  Until the observed temperature spread reaches minTempSpread the slope
+  is kept at 0 and the model behaves like a plain offset.
+
+  Usage:
+    GyroBiasModel model(0.2);                 // max |slope|, units/deg C
+    model.addObservation(temperature, bx, by, bz);
+    model.predict(temperature, bx, by, bz);   // every sample
+
+  The fitted sums are stored in EEPROM (GyroBiasRecord, CRC-32) so the
+  fit continues across boots. Requires CalibrationStore.h.
+*/
+
+#ifndef GYRO_BIAS_MODEL_H
+#define GYRO_BIAS_MODEL_H
+
+#include <Arduino.h>
+#include "CalibrationStore.h"
+
+#define GYRO_BIAS_MAGIC       0x314D4247UL   // "GBM1"
+#define GYRO_BIAS_VERSION     1
+#define GYRO_BIAS_REF_TEMP    25.0f          // deg C, centers the sums
+
+struct GyroBiasRecord {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  uint8_t sensorId;       // WHO_AM_I
+  uint8_t sensorAddress;  // I2C address
+  uint8_t gyroUnits;      // CALIBRATION_GYRO_*
+  uint8_t reserved;
+  float weight;           // Sum of weights
+  float sumT, sumTT;      // Temperature sums (relative to GYRO_BIAS_REF_TEMP)
+  float sumB[3];          // Bias sums
+  float sumTB[3];         // Temperature * bias sums
+  float minTemp, maxTemp; // Observed temperature range
+  uint32_t observations;
+  uint32_t crc;
+};
+
+class GyroBiasModel {
+  public:
+    GyroBiasModel(float maxSlope, float minTempSpread = 1.0f, float forgetting = 0.995f)
+      : maxSlope(maxSlope), minTempSpread(minTempSpread), forgetting(forgetting) {
+      reset();
+    }
+
+    void reset() {
+      weight = sumT = sumTT = 0;
+      for (uint8_t i = 0; i < 3; i++) {
+        sumB[i] = sumTB[i] = 0;
+        intercept[i] = slope[i] = 0;
+      }
+      minTemp = 1000;
+      maxTemp = -1000;
+      observations = 0;
+    }
+
+    // Mean raw rate of a stationary window at the given temperature
+    void addObservation(float temperature, float bx, float by, float bz, float w = 1.0f) {
+      float t = temperature - GYRO_BIAS_REF_TEMP;
+      const float b[3] = { bx, by, bz };
+
+      weight = weight * forgetting + w;
+      sumT = sumT * forgetting + w * t;
+      sumTT = sumTT * forgetting + w * t * t;
+      for (uint8_t i = 0; i < 3; i++) {
+        sumB[i] = sumB[i] * forgetting + w * b[i];
+        sumTB[i] = sumTB[i] * forgetting + w * t * b[i];
+      }
+      if (temperature < minTemp) minTemp = temperature;
+      if (temperature > maxTemp) maxTemp = temperature;
+      observations++;
+      fit();
+    }
+
+    void predict(float temperature, float &bx, float &by, float &bz) const {
+      float t = temperature - GYRO_BIAS_REF_TEMP;
+      bx = intercept[0] + slope[0] * t;
+      by = intercept[1] + slope[1] * t;
+      bz = intercept[2] + slope[2] * t;
+    }
+
+    bool hasData() const { return observations > 0; }
+    bool hasSlope() const { return slope[0] != 0 || slope[1] != 0 || slope[2] != 0; }
+    uint32_t count() const { return observations; }
+    float getSlope(uint8_t axis) const { return slope[axis]; }
+    float temperatureSpread() const { return observations ? maxTemp - minTemp : 0; }
+
+    void toRecord(GyroBiasRecord &record, uint8_t sensorId, uint8_t sensorAddress, uint8_t gyroUnits) const {
+      memset(&record, 0, sizeof(record));
+      record.magic = GYRO_BIAS_MAGIC;
+      record.version = GYRO_BIAS_VERSION;
+      record.size = sizeof(GyroBiasRecord);
+      record.sensorId = sensorId;
+      record.sensorAddress = sensorAddress;
+      record.gyroUnits = gyroUnits;
+      record.weight = weight;
+      record.sumT = sumT;
+      record.sumTT = sumTT;
+      for (uint8_t i = 0; i < 3; i++) {
+        record.sumB[i] = sumB[i];
+        record.sumTB[i] = sumTB[i];
+      }
+      record.minTemp = minTemp;
+      record.maxTemp = maxTemp;
+      record.observations = observations;
+    }
+
+    void fromRecord(const GyroBiasRecord &record) {
+      weight = record.weight;
+      sumT = record.sumT;
+      sumTT = record.sumTT;
+      for (uint8_t i = 0; i < 3; i++) {
+        sumB[i] = record.sumB[i];
+        sumTB[i] = record.sumTB[i];
+      }
+      minTemp = record.minTemp;
+      maxTemp = record.maxTemp;
+      observations = record.observations;
+      fit();
+    }
+
+  private:
+    float maxSlope;
+    float minTempSpread;
+    float forgetting;
+    float weight, sumT, sumTT;
+    float sumB[3], sumTB[3];
+    float intercept[3], slope[3];
+    float minTemp, maxTemp;
+    uint32_t observations;
+
+    void fit() {
+      if (weight <= 0) return;
+      float meanT = sumT / weight;
+      float varT = sumTT / weight - meanT * meanT;
+      bool useSlope = (maxTemp - minTemp) >= minTempSpread && varT > 1e-4f;
+
+      for (uint8_t i = 0; i < 3; i++) {
+        float meanB = sumB[i] / weight;
+        float k = 0;
+        if (useSlope) {
+          k = (sumTB[i] / weight - meanT * meanB) / varT;
+          if (k > maxSlope) k = maxSlope;
+          if (k < -maxSlope) k = -maxSlope;
+        }
+        slope[i] = k;
+        intercept[i] = meanB - k * meanT;
+      }
+    }
+};
+
+inline bool loadGyroBiasModel(int address, GyroBiasModel &model,
+                              uint8_t sensorId, uint8_t sensorAddress, uint8_t gyroUnits) {
+  GyroBiasRecord record;
+  EEPROM.get(address, record);
+
+  if (record.magic != GYRO_BIAS_MAGIC) return false;
+  if (record.version != GYRO_BIAS_VERSION) return false;
+  if (record.size != sizeof(GyroBiasRecord)) return false;
+  if (record.crc != calibrationCrc32((const uint8_t*)&record, offsetof(GyroBiasRecord, crc))) return false;
+  if (record.sensorId != sensorId || record.sensorAddress != sensorAddress) return false;
+  if (record.gyroUnits != gyroUnits) return false;
+
+  model.fromRecord(record);
+  return true;
+}
+
+inline void saveGyroBiasModel(int address, const GyroBiasModel &model,
+                              uint8_t sensorId, uint8_t sensorAddress, uint8_t gyroUnits) {
+  GyroBiasRecord record;
+  model.toRecord(record, sensorId, sensorAddress, gyroUnits);
+  record.crc = calibrationCrc32((const uint8_t*)&record, offsetof(GyroBiasRecord, crc));
+  EEPROM.put(address, record);
+#if defined(ESP8266) || defined(ESP32)
+  EEPROM.commit();
+#endif
+}
+
+#endif
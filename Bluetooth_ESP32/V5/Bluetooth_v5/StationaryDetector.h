@@ -0,0 +1,161 @@
+/*
+  Windowed stationarity detector and background gyro bias tracking
+  Replaces single-sample threshold checks: the decision is made over the
+  last N samples, so one quiet sample during motion or one spike while
+  resting does not flip the state.
+
+  Per sample (O(1), ring buffer of N entries):
+    gyro      - running mean per axis and total variance (x + y + z)
+    accel     - running mean and variance of the magnitude
+
+  The device is stationary when the window is full and
+    |mean gyro| < gyroRateMax on every axis   (no slow rotation)
+    gyro std     < gyroNoiseMax                (no shaking)
+    accel std    < accelNoiseMax               (no vibration / walking)
+
+  Units are the caller's (rad/s, deg/s or raw LSB; m/s^2, g or raw LSB),
+  gyro values are passed with the current bias already removed.
+
+  Usage:
+    StationaryDetector<32> detector(0.01, 0.02, 0.2);
+    if (detector.update(gx, gy, gz, ax, ay, az)) {
+      trackGyroBias(offsetX, offsetY, offsetZ, gx, gy, gz, 0.002);
+    }
+*/
+
+#ifndef STATIONARY_DETECTOR_H
+#define STATIONARY_DETECTOR_H
+
+#include <Arduino.h>
+#include <math.h>
+
+// Running sums are rebuilt from the buffer every this many wraps,
+// so float round-off from add/subtract does not accumulate
+#define STATIONARY_RESUM_WRAPS 16
+
+template <uint16_t N>
+class StationaryDetector {
+  public:
+    StationaryDetector(float gyroNoiseMax, float gyroRateMax, float accelNoiseMax)
+      : gyroNoiseMax(gyroNoiseMax), gyroRateMax(gyroRateMax), accelNoiseMax(accelNoiseMax) {
+      reset();
+    }
+
+    void reset() {
+      head = 0;
+      count = 0;
+      wraps = 0;
+      stationary = false;
+      stillCount = 0;
+      clearSums();
+    }
+
+    bool update(float gx, float gy, float gz, float ax, float ay, float az) {
+      float accel = sqrtf(ax * ax + ay * ay + az * az);
+
+      if (count == N) {
+        remove(head);
+      } else {
+        count++;
+      }
+      gyro[head][0] = gx;
+      gyro[head][1] = gy;
+      gyro[head][2] = gz;
+      accelMag[head] = accel;
+      add(head);
+
+      if (++head == N) {
+        head = 0;
+        if (++wraps >= STATIONARY_RESUM_WRAPS) {
+          wraps = 0;
+          resum();
+        }
+      }
+
+      stationary = count == N &&
+                   fabsf(gyroMean(0)) < gyroRateMax &&
+                   fabsf(gyroMean(1)) < gyroRateMax &&
+                   fabsf(gyroMean(2)) < gyroRateMax &&
+                   gyroStd() < gyroNoiseMax &&
+                   accelStd() < accelNoiseMax;
+      stillCount = stationary ? stillCount + 1 : 0;
+      return stationary;
+    }
+
+    bool isStationary() const { return stationary; }
+    bool isFull() const { return count == N; }
+    // Consecutive stationary samples
+    uint32_t stillSamples() const { return stillCount; }
+
+    float gyroMean(uint8_t axis) const { return count ? sumG[axis] / count : 0; }
+
+    float gyroStd() const {
+      if (count == 0) return 0;
+      float variance = sumGG / count;
+      for (uint8_t i = 0; i < 3; i++) {
+        float mean = sumG[i] / count;
+        variance -= mean * mean;
+      }
+      return variance > 0 ? sqrtf(variance) : 0;
+    }
+
+    float accelMean() const { return count ? sumA / count : 0; }
+
+    float accelStd() const {
+      if (count == 0) return 0;
+      float mean = sumA / count;
+      float variance = sumAA / count - mean * mean;
+      return variance > 0 ? sqrtf(variance) : 0;
+    }
+
+  private:
+    float gyroNoiseMax, gyroRateMax, accelNoiseMax;
+    float gyro[N][3];
+    float accelMag[N];
+    float sumG[3], sumGG, sumA, sumAA;
+    uint16_t head, count;
+    uint8_t wraps;
+    bool stationary;
+    uint32_t stillCount;
+
+    void clearSums() {
+      sumG[0] = sumG[1] = sumG[2] = 0;
+      sumGG = sumA = sumAA = 0;
+    }
+
+    void add(uint16_t i) {
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        sumG[axis] += gyro[i][axis];
+        sumGG += gyro[i][axis] * gyro[i][axis];
+      }
+      sumA += accelMag[i];
+      sumAA += accelMag[i] * accelMag[i];
+    }
+
+    void remove(uint16_t i) {
+      for (uint8_t axis = 0; axis < 3; axis++) {
+        sumG[axis] -= gyro[i][axis];
+        sumGG -= gyro[i][axis] * gyro[i][axis];
+      }
+      sumA -= accelMag[i];
+      sumAA -= accelMag[i] * accelMag[i];
+    }
+
+    void resum() {
+      clearSums();
+      for (uint16_t i = 0; i < count; i++) {
+        add(i);
+      }
+    }
+};
+
+// Moves the bias towards the bias-removed rate while stationary
+// (exponential average, time constant = 1 / rate samples)
+inline void trackGyroBias(float &biasX, float &biasY, float &biasZ,
+                          float gx, float gy, float gz, float rate) {
+  biasX += gx * rate;
+  biasY += gy * rate;
+  biasZ += gz * rate;
+}
+
+#endif
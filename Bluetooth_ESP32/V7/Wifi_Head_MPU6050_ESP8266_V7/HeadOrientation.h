@@ -0,0 +1,253 @@
+/*
+  Orientation core of Wifi_Head_MPU6050_ESP8266_V7, independent of the board
+  Everything loop() does between reading a sample and publishing the
+  angles: gyro offsets, post-boot refinement of stored offsets, stationary
+  detection with background bias tracking, and the filter itself. No
+  WiFi, EEPROM or Serial here - the sketch persists the offsets when
+  update() reports a refinement, so the same code runs in the host replay
+  (Benchmark/fusion_replay) against a recorded or synthetic trace.
+
+  Two variants with the same interface, selected by USE_FIXED_POINT_FILTER
+  (quaternion by default, fixed point opt-in on ESP8266):
+    FixedHeadOrientation       raw LSB, FixedPointFilter (no float per sample), 500 Hz
+    QuaternionHeadOrientation  rad/s and m/s^2, SensorFusion (Madgwick), 100 Hz
+
+  Both expect the sensor at +-4g / +-250 deg/s.
+
+  Usage:
+    QuaternionHeadOrientation head;
+    head.calibrate(mpuBus, temperature);               // setup(), blocking
+    loop(): MPU6050Sample sample; mpuBus.readSample(sample);
+            if (head.update(sample, dtMicros)) store offsets;
+            head.pitch, head.roll, head.yaw
+*/
+
+#ifndef HEAD_ORIENTATION_H
+#define HEAD_ORIENTATION_H
+
+#include <Arduino.h>
+#include "MPU6050Bus.h"
+#include "CalibrationStore.h"
+#include "FixedPointFilter.h"
+#include "SensorFusion.h"
+#include "StationaryDetector.h"
+
+#define HEAD_CALIBRATION_SAMPLES   500
+#define HEAD_CALIBRATION_DELAY_MS  2
+#define HEAD_BIAS_TRACKING_RATE    0.002f   // ~5 s time constant at 100 Hz
+#define HEAD_STATIONARY_RATE_US    10000    // Detector and bias tracking run at 100 Hz in both variants
+
+#define HEAD_ACCEL_LSB_PER_G   8192.0f      // +-4g
+#define HEAD_GYRO_LSB_PER_DPS  131.0f       // +-250 deg/s
+
+class FixedHeadOrientation {
+  public:
+    static const unsigned long SAMPLE_INTERVAL_US = 2000;
+    static const uint8_t CALIBRATION_UNITS = CALIBRATION_GYRO_RAW;
+
+    float pitch = 0, roll = 0, yaw = 0;
+    int32_t gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;   // LSB
+
+    FixedPointFilter filter{131, 8192};
+    // LSB: noise 0.6 deg/s, rotation 1.1 deg/s, acceleration 0.02g
+    StationaryDetector<32> stationaryDetector{80, 150, 164};
+    CalibrationRefiner refiner{262, 500};     // 2 deg/s, 1 s
+    float biasFractionX = 0, biasFractionY = 0, biasFractionZ = 0;   // Sub-LSB part of the tracked bias
+    uint8_t stationaryDivider = 0;
+
+    // Blocking full calibration; returns the samples used and their mean temperature
+    template <class BusType>
+    uint32_t calibrate(BusType &bus, float &temperature) {
+      stationaryDetector.reset();
+      int32_t sumX = 0, sumY = 0, sumZ = 0;
+      float sumTemp = 0;
+      uint32_t samples = 0;
+      for (int i = 0; i < HEAD_CALIBRATION_SAMPLES; i++) {
+        MPU6050Sample sample;
+        if (bus.readSample(sample)) {
+          sumX += sample.gx;
+          sumY += sample.gy;
+          sumZ += sample.gz;
+          sumTemp += mpu6050Temperature(sample.temp);
+          samples++;
+        }
+        delay(HEAD_CALIBRATION_DELAY_MS);
+      }
+      if (samples > 0) {
+        gyroOffsetX = sumX / (int32_t)samples;
+        gyroOffsetY = sumY / (int32_t)samples;
+        gyroOffsetZ = sumZ / (int32_t)samples;
+        sumTemp /= samples;
+      }
+      temperature = sumTemp;
+      filter.reset();
+      refiner.finish();   // Fresh offsets need no refinement
+      return samples;
+    }
+
+    // Warm start from EEPROM; offsets are refined once the device is still
+    void restore(const CalibrationRecord &record) {
+      gyroOffsetX = lroundf(record.gyroOffset[0]);
+      gyroOffsetY = lroundf(record.gyroOffset[1]);
+      gyroOffsetZ = lroundf(record.gyroOffset[2]);
+      filter.reset();
+      refiner.reset();
+    }
+
+    void storeOffsets(CalibrationRecord &record) const {
+      record.gyroOffset[0] = gyroOffsetX;
+      record.gyroOffset[1] = gyroOffsetY;
+      record.gyroOffset[2] = gyroOffsetZ;
+    }
+
+    // One sample; true when the stored offsets were just refined (persist them)
+    bool update(const MPU6050Sample &sample, unsigned long dtMicros) {
+      bool refined = false;
+      if (!refiner.isDone() &&
+          refiner.addSample(sample.gx, sample.gy, sample.gz, gyroOffsetX, gyroOffsetY, gyroOffsetZ)) {
+        gyroOffsetX = lroundf(refiner.offsetX());
+        gyroOffsetY = lroundf(refiner.offsetY());
+        gyroOffsetZ = lroundf(refiner.offsetZ());
+        refined = true;
+      }
+
+      int32_t gx = sample.gx - gyroOffsetX;
+      int32_t gy = sample.gy - gyroOffsetY;
+      int32_t gz = sample.gz - gyroOffsetZ;
+      updateStationary(gx, gy, gz, sample.ax, sample.ay, sample.az);
+
+      filter.update(sample.ax, sample.ay, sample.az, gx, gy, gz, dtMicros);
+      pitch = fixedToFloat(filter.pitch);
+      roll = fixedToFloat(filter.roll);
+      yaw = fixedToFloat(filter.yaw);
+      return refined;
+    }
+
+    void resetAngles() {
+      filter.pitch = 0;
+      filter.roll = 0;
+      filter.yaw = 0;
+      pitch = roll = yaw = 0;
+    }
+
+  private:
+    static const uint8_t STATIONARY_DECIMATION = HEAD_STATIONARY_RATE_US / SAMPLE_INTERVAL_US;
+
+    // Bias is tracked in float and moved into the integer offsets a whole LSB at a time
+    void updateStationary(int32_t gx, int32_t gy, int32_t gz, int16_t ax, int16_t ay, int16_t az) {
+      if (++stationaryDivider < STATIONARY_DECIMATION) return;
+      stationaryDivider = 0;
+      if (!stationaryDetector.update(gx, gy, gz, ax, ay, az)) return;
+      if (!refiner.isDone()) return;   // The one-off refinement after boot comes first
+
+      trackGyroBias(biasFractionX, biasFractionY, biasFractionZ, gx, gy, gz, HEAD_BIAS_TRACKING_RATE);
+      int32_t stepX = (int32_t)biasFractionX;
+      int32_t stepY = (int32_t)biasFractionY;
+      int32_t stepZ = (int32_t)biasFractionZ;
+      gyroOffsetX += stepX; biasFractionX -= stepX;
+      gyroOffsetY += stepY; biasFractionY -= stepY;
+      gyroOffsetZ += stepZ; biasFractionZ -= stepZ;
+    }
+};
+
+class QuaternionHeadOrientation {
+  public:
+    static const unsigned long SAMPLE_INTERVAL_US = 10000;
+    static const uint8_t CALIBRATION_UNITS = CALIBRATION_GYRO_RAD_S;
+
+    float pitch = 0, roll = 0, yaw = 0;
+    float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;   // rad/s
+
+    SensorFusion fusion;
+    StationaryDetector<32> stationaryDetector{0.01, 0.02, 0.2};   // rad/s, rad/s, m/s^2
+    CalibrationRefiner refiner{0.035, 100};                      // 2 deg/s, 1 s
+    uint8_t stationaryDivider = 0;
+
+    // Raw registers to the units Adafruit_MPU6050::getEvent() reports
+    static float accelMs2(int16_t raw) { return raw / HEAD_ACCEL_LSB_PER_G * 9.80665f; }
+    static float gyroRads(int16_t raw) { return raw / HEAD_GYRO_LSB_PER_DPS * 0.017453293f; }
+
+    template <class BusType>
+    uint32_t calibrate(BusType &bus, float &temperature) {
+      stationaryDetector.reset();
+      float sumX = 0, sumY = 0, sumZ = 0, sumTemp = 0;
+      uint32_t samples = 0;
+      for (int i = 0; i < HEAD_CALIBRATION_SAMPLES; i++) {
+        MPU6050Sample sample;
+        if (bus.readSample(sample)) {
+          sumX += gyroRads(sample.gx);
+          sumY += gyroRads(sample.gy);
+          sumZ += gyroRads(sample.gz);
+          sumTemp += mpu6050Temperature(sample.temp);
+          samples++;
+        }
+        delay(HEAD_CALIBRATION_DELAY_MS);
+      }
+      if (samples > 0) {
+        gyroOffsetX = sumX / samples;
+        gyroOffsetY = sumY / samples;
+        gyroOffsetZ = sumZ / samples;
+        sumTemp /= samples;
+      }
+      temperature = sumTemp;
+      fusion.reset();
+      refiner.finish();
+      return samples;
+    }
+
+    void restore(const CalibrationRecord &record) {
+      gyroOffsetX = record.gyroOffset[0];
+      gyroOffsetY = record.gyroOffset[1];
+      gyroOffsetZ = record.gyroOffset[2];
+      fusion.reset();
+      refiner.reset();
+    }
+
+    void storeOffsets(CalibrationRecord &record) const {
+      record.gyroOffset[0] = gyroOffsetX;
+      record.gyroOffset[1] = gyroOffsetY;
+      record.gyroOffset[2] = gyroOffsetZ;
+    }
+
+    bool update(const MPU6050Sample &sample, unsigned long dtMicros) {
+      float rawX = gyroRads(sample.gx), rawY = gyroRads(sample.gy), rawZ = gyroRads(sample.gz);
+      float ax = accelMs2(sample.ax), ay = accelMs2(sample.ay), az = accelMs2(sample.az);
+
+      bool refined = false;
+      if (!refiner.isDone() && refiner.addSample(rawX, rawY, rawZ, gyroOffsetX, gyroOffsetY, gyroOffsetZ)) {
+        gyroOffsetX = refiner.offsetX();
+        gyroOffsetY = refiner.offsetY();
+        gyroOffsetZ = refiner.offsetZ();
+        refined = true;
+      }
+
+      float gx = rawX - gyroOffsetX;
+      float gy = rawY - gyroOffsetY;
+      float gz = rawZ - gyroOffsetZ;
+      if (++stationaryDivider >= STATIONARY_DECIMATION) {
+        stationaryDivider = 0;
+        if (stationaryDetector.update(gx, gy, gz, ax, ay, az) && refiner.isDone()) {
+          trackGyroBias(gyroOffsetX, gyroOffsetY, gyroOffsetZ, gx, gy, gz, HEAD_BIAS_TRACKING_RATE);
+        }
+      }
+
+      fusion.update(gx, gy, gz, ax, ay, az, dtMicros / 1000000.0f);
+      pitch = fusion.getPitch();
+      roll = fusion.getRoll();
+      yaw = fusion.getYaw();
+      return refined;
+    }
+
+    // Tilt is defined by gravity, only the heading is reset
+    void resetAngles() {
+      fusion.resetYaw();
+      pitch = fusion.getPitch();
+      roll = fusion.getRoll();
+      yaw = fusion.getYaw();
+    }
+
+  private:
+    static const uint8_t STATIONARY_DECIMATION = HEAD_STATIONARY_RATE_US / SAMPLE_INTERVAL_US;
+};
+
+#endif
@@ -0,0 +1,317 @@
+/*
+  Raw IMU recorder: every MPU6050 sample at full rate into a flash log
+  The 20 Hz pose stream hides what the filter actually saw; the log keeps
+  the raw registers (the same 14-byte burst as MPU6050Bus::readSample)
+  with their micros() timestamps, so a capture can be replayed on a PC.
+
+  File = header block + data blocks, all IMU_LOG_BLOCK_SIZE bytes. The
+  recorder only appends whole blocks, so every flash write covers whole
+  pages and nothing written is ever rewritten. Unused bytes are 0xFF
+  (erased flash).
+
+  Header block:
+    0  uint32  magic "IMUL"
+    4  uint8   version
+    5  uint8   bytes per raw sample (14)
+    6  uint16  block size
+    8  uint32  nominal sample period, us
+   12  uint16  accel LSB per g
+   14  uint16  gyro LSB per deg/s * 10
+   16  int16   gyro offsets X, Y, Z in use when recording started, LSB
+   22  uint16  reserved (0)
+   24  uint32  CRC-32 of bytes 0..23
+
+  Data block (each one decodes on its own, a damaged block loses only
+  its own samples):
+    0  uint32  magic "IMUB"
+    4  uint32  block index
+    8  uint32  time of the first sample, us
+   12  uint16  sample count
+   14  uint16  payload length
+   16  uint32  CRC-32 of bytes 0..15 and the payload
+   20  payload
+
+  Payload, per sample, zigzag varints (LEB128):
+    time  - (dt - nominal period); absent for the first sample of a block
+    ax, ay, az, temp, gx, gy, gz - difference to the previous sample of
+            the block (to 0 for the first one)
+  Sensor noise keeps the differences small: about 11 bytes per sample
+  instead of 18 (14 raw + timestamp).
+
+  Usage:
+    ImuRecorder<fs::FS, fs::File> recorder(LittleFS, "/imu.log");
+    ImuLogHeader header = {2000, 8192, 1310, {offsetX, offsetY, offsetZ}};
+    recorder.start(header, maxBytes);
+    ... after each read: recorder.append(micros(), sample);
+    recorder.stop();
+*/
+
+#ifndef IMU_LOG_H
+#define IMU_LOG_H
+
+#include <Arduino.h>
+#include "MPU6050Bus.h"
+
+#define IMU_LOG_MAGIC 0x4C554D49UL         // "IMUL"
+#define IMU_LOG_BLOCK_MAGIC 0x42554D49UL   // "IMUB"
+#define IMU_LOG_VERSION 1
+#define IMU_LOG_BLOCK_SIZE 1024
+#define IMU_LOG_BLOCK_HEADER 20
+#define IMU_LOG_MAX_SAMPLE_BYTES 26        // 5 (time) + 7 * 3
+#define IMU_LOG_SYNC_BLOCKS 16             // file.flush() every ~16 KB
+
+inline uint32_t imuLogCrc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : (crc >> 1);
+    }
+  }
+  return ~crc;
+}
+
+inline void imuLogPut16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+inline void imuLogPut32(uint8_t* p, uint32_t v) {
+  p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = (v >> 24) & 0xFF;
+}
+inline uint16_t imuLogGet16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+inline uint32_t imuLogGet32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline uint8_t imuLogPutVarint(uint8_t* p, int32_t value) {
+  uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);   // zigzag
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (v & 0x7F) | 0x80;
+    v >>= 7;
+  }
+  p[n++] = v;
+  return n;
+}
+
+// Bytes used, 0 if the varint runs past end
+inline uint8_t imuLogGetVarint(const uint8_t* p, const uint8_t* end, int32_t &value) {
+  uint32_t v = 0;
+  for (uint8_t n = 0; n < 5 && p + n < end; n++) {
+    v |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+    if (!(p[n] & 0x80)) {
+      value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+      return n + 1;
+    }
+  }
+  return 0;
+}
+
+struct ImuLogHeader {
+  uint32_t periodUs;
+  uint16_t accelLsbPerG;
+  uint16_t gyroLsbPerDps10;
+  int16_t gyroOffset[3];
+};
+
+struct ImuLogSample {
+  uint32_t timeUs;
+  MPU6050Sample raw;
+};
+
+inline void writeImuLogHeader(uint8_t* block, const ImuLogHeader &header) {
+  memset(block, 0xFF, IMU_LOG_BLOCK_SIZE);
+  imuLogPut32(block, IMU_LOG_MAGIC);
+  block[4] = IMU_LOG_VERSION;
+  block[5] = MPU6050_SAMPLE_BYTES;
+  imuLogPut16(block + 6, IMU_LOG_BLOCK_SIZE);
+  imuLogPut32(block + 8, header.periodUs);
+  imuLogPut16(block + 12, header.accelLsbPerG);
+  imuLogPut16(block + 14, header.gyroLsbPerDps10);
+  for (uint8_t k = 0; k < 3; k++) imuLogPut16(block + 16 + 2 * k, header.gyroOffset[k]);
+  imuLogPut16(block + 22, 0);
+  imuLogPut32(block + 24, imuLogCrc32(block, 24));
+}
+
+inline bool readImuLogHeader(const uint8_t* block, ImuLogHeader &header) {
+  if (imuLogGet32(block) != IMU_LOG_MAGIC || block[4] != IMU_LOG_VERSION ||
+      imuLogGet16(block + 6) != IMU_LOG_BLOCK_SIZE ||
+      imuLogGet32(block + 24) != imuLogCrc32(block, 24)) {
+    return false;
+  }
+  header.periodUs = imuLogGet32(block + 8);
+  header.accelLsbPerG = imuLogGet16(block + 12);
+  header.gyroLsbPerDps10 = imuLogGet16(block + 14);
+  for (uint8_t k = 0; k < 3; k++) header.gyroOffset[k] = (int16_t)imuLogGet16(block + 16 + 2 * k);
+  return true;
+}
+
+// Samples of one data block in order, -1 if the block is damaged
+template <class Callback>
+int decodeImuLogBlock(const uint8_t* block, uint32_t periodUs, Callback onSample) {
+  uint16_t count = imuLogGet16(block + 12);
+  uint16_t length = imuLogGet16(block + 14);
+  if (imuLogGet32(block) != IMU_LOG_BLOCK_MAGIC || length > IMU_LOG_BLOCK_SIZE - IMU_LOG_BLOCK_HEADER) {
+    return -1;
+  }
+  uint32_t crc = imuLogCrc32(block, 16);
+  if (imuLogGet32(block + 16) != imuLogCrc32(block + IMU_LOG_BLOCK_HEADER, length, crc)) return -1;
+
+  const uint8_t* p = block + IMU_LOG_BLOCK_HEADER;
+  const uint8_t* end = p + length;
+  ImuLogSample s;
+  s.timeUs = imuLogGet32(block + 8);
+  int32_t prev[7] = {0, 0, 0, 0, 0, 0, 0};
+  for (uint16_t i = 0; i < count; i++) {
+    int32_t value;
+    uint8_t n;
+    if (i > 0) {
+      if (!(n = imuLogGetVarint(p, end, value))) return -1;
+      p += n;
+      s.timeUs += periodUs + value;
+    }
+    for (uint8_t k = 0; k < 7; k++) {
+      if (!(n = imuLogGetVarint(p, end, value))) return -1;
+      p += n;
+      prev[k] = (int16_t)(prev[k] + value);
+    }
+    s.raw.ax = prev[0]; s.raw.ay = prev[1]; s.raw.az = prev[2];
+    s.raw.temp = prev[3];
+    s.raw.gx = prev[4]; s.raw.gy = prev[5]; s.raw.gz = prev[6];
+    onSample(s);
+  }
+  return count;
+}
+
+// Append-only recorder; FileSystem/FileType are e.g. fs::FS/fs::File
+template <class FileSystem, class FileType>
+class ImuRecorder {
+  public:
+    ImuRecorder(FileSystem &fs, const char* path) : fs(fs), path(path), active(false) {
+      clearStats();
+    }
+
+    // Truncates the previous log; maxBytes caps the file size
+    bool start(const ImuLogHeader &logHeader, uint32_t maxBytes) {
+      stop();
+      clearStats();
+      file = fs.open(path, "w");
+      if (!file) return false;
+      header = logHeader;
+      limit = maxBytes;
+      writeImuLogHeader(block, header);
+      if (!writeBlock()) {
+        file.close();
+        return false;
+      }
+      openBlock();
+      active = true;
+      return true;
+    }
+
+    // Writes the partial block and closes the file
+    void stop() {
+      if (!active) return;
+      if (blockSamples > 0) closeBlock();
+      file.close();
+      active = false;
+    }
+
+    bool recording() const { return active; }
+
+    // Called once per raw read; writes a block when it fills up
+    void append(uint32_t timeUs, const MPU6050Sample &sample) {
+      if (!active) return;
+      if (blockSamples > 0 && used + IMU_LOG_MAX_SAMPLE_BYTES > IMU_LOG_BLOCK_SIZE) {
+        if (!closeBlock()) {
+          stop();
+          return;
+        }
+        if (written + IMU_LOG_BLOCK_SIZE > limit) {   // next block would not fit
+          full = true;
+          stop();
+          return;
+        }
+        openBlock();
+      }
+
+      const int32_t values[7] = {sample.ax, sample.ay, sample.az, sample.temp,
+                                 sample.gx, sample.gy, sample.gz};
+      if (blockSamples == 0) {
+        imuLogPut32(block + 8, timeUs);
+      } else {
+        int32_t dt = (int32_t)(timeUs - lastTimeUs);
+        if (dt > 2 * (int32_t)header.periodUs) gapCount++;
+        used += imuLogPutVarint(block + used, dt - (int32_t)header.periodUs);
+      }
+      for (uint8_t k = 0; k < 7; k++) {
+        used += imuLogPutVarint(block + used, values[k] - previous[k]);
+        previous[k] = values[k];
+      }
+      lastTimeUs = timeUs;
+      blockSamples++;
+      sampleCount++;
+    }
+
+    uint32_t samples() const { return sampleCount; }
+    uint32_t blocks() const { return blockCount; }
+    uint32_t bytes() const { return written; }
+    uint32_t gaps() const { return gapCount; }          // dt above two periods
+    uint32_t slowestWriteUs() const { return maxWriteUs; }
+    bool stoppedFull() const { return full; }
+    bool failed() const { return writeFailed; }
+
+  private:
+    FileSystem &fs;
+    const char* path;
+    FileType file;
+    bool active, full, writeFailed;
+    ImuLogHeader header;
+    uint8_t block[IMU_LOG_BLOCK_SIZE];
+    uint16_t used, blockSamples;
+    int32_t previous[7];
+    uint32_t lastTimeUs, limit;
+    uint32_t sampleCount, blockCount, written, gapCount, maxWriteUs;
+
+    void clearStats() {
+      full = false;
+      writeFailed = false;
+      sampleCount = 0;
+      blockCount = 0;
+      written = 0;
+      gapCount = 0;
+      maxWriteUs = 0;
+    }
+
+    void openBlock() {
+      memset(block, 0xFF, IMU_LOG_BLOCK_SIZE);
+      imuLogPut32(block, IMU_LOG_BLOCK_MAGIC);
+      imuLogPut32(block + 4, blockCount);
+      used = IMU_LOG_BLOCK_HEADER;
+      blockSamples = 0;
+      for (uint8_t k = 0; k < 7; k++) previous[k] = 0;
+    }
+
+    bool closeBlock() {
+      uint16_t length = used - IMU_LOG_BLOCK_HEADER;
+      imuLogPut16(block + 12, blockSamples);
+      imuLogPut16(block + 14, length);
+      uint32_t crc = imuLogCrc32(block, 16);
+      imuLogPut32(block + 16, imuLogCrc32(block + IMU_LOG_BLOCK_HEADER, length, crc));
+      blockCount++;
+      blockSamples = 0;
+      return writeBlock();
+    }
+
+    // The sensor is not read while flash is busy: the stall shows up as a
+    // gap in the sample times and in slowestWriteUs()
+    bool writeBlock() {
+      uint32_t startUs = micros();
+      bool ok = file.write(block, IMU_LOG_BLOCK_SIZE) == IMU_LOG_BLOCK_SIZE;
+      written += IMU_LOG_BLOCK_SIZE;
+      if (ok && written % (IMU_LOG_SYNC_BLOCKS * IMU_LOG_BLOCK_SIZE) == 0) file.flush();
+      uint32_t took = micros() - startUs;
+      if (took > maxWriteUs) maxWriteUs = took;
+      if (!ok) writeFailed = true;
+      return ok;
+    }
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+  Binary orientation frame for WebSocket head trackers
+  Sent with broadcastBIN/sendBIN to clients that asked for the binary format.
+  Text frames remain the default.
+
+  Format negotiation (client -> device, WebSocket text):
+    "FORMAT:BIN" / "FORMAT:TEXT"             canonical spelling
+    "setFormat:binary" / "setFormat:text"    older pages, accepted as well
+  The device acknowledges with one JSON text message in every sketch
+  (formatOrientationFormatReply()):
+    {"type":"format","format":"binary","version":1}
+    {"type":"format","format":"text"}
+
+  Schema version 1, little-endian, 28 bytes:
+    0  uint8   magic (0xA5)
+    1  uint8   schema version
+    2  uint8   flags (bit0 - zero point set, bit1 - device idle,
+                  bit2 - angular rates appended,
+                  bit3 - timestamp in the hub's shared time, ClockSync.h)
+    3  uint8   reserved (0)
+    4  uint16  frame sequence number
+    6  uint32  sample timestamp, microseconds (micros())
+   10  int16   pitch, roll, yaw in 0.01 deg, wrapped to -180..180
+   16  int32   accumulated pitch, roll, yaw in 0.01 deg (unbounded)
+
+  With bit2 set the frame is 31 bytes, still under 32; decoders that only
+  know the 28-byte layout read the same fields and ignore the tail:
+   28  int8    pitch, roll, yaw rates in 4 deg/s (for client prediction),
+               saturated at +-508 deg/s
+*/
+
+#ifndef ORIENTATION_FRAME_H
+#define ORIENTATION_FRAME_H
+
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+#define ORIENTATION_FRAME_MAGIC    0xA5
+#define ORIENTATION_FRAME_VERSION  1
+#define ORIENTATION_FRAME_SIZE     28
+#define ORIENTATION_FRAME_RATES_SIZE 31
+#define ORIENTATION_FRAME_RATE_STEP  4.0f   // deg/s per rate unit
+
+#define ORIENTATION_FLAG_ZERO_SET  0x01
+#define ORIENTATION_FLAG_IDLE      0x02
+#define ORIENTATION_FLAG_RATES     0x04
+#define ORIENTATION_FLAG_SHARED_CLOCK 0x08
+
+#define ORIENTATION_FORMAT_BIN_COMMAND   "FORMAT:BIN"
+#define ORIENTATION_FORMAT_TEXT_COMMAND  "FORMAT:TEXT"
+#define ORIENTATION_FORMAT_BIN_ALIAS     "setFormat:binary"
+#define ORIENTATION_FORMAT_TEXT_ALIAS    "setFormat:text"
+
+enum OrientationFormatRequest {
+  ORIENTATION_FORMAT_NONE,
+  ORIENTATION_FORMAT_BINARY,
+  ORIENTATION_FORMAT_TEXT
+};
+
+// Recognizes either spelling of the format command anywhere in a message,
+// so it also matches inside a JSON wrapper
+inline OrientationFormatRequest parseOrientationFormatRequest(const char* message) {
+  if (strstr(message, ORIENTATION_FORMAT_BIN_COMMAND) || strstr(message, ORIENTATION_FORMAT_BIN_ALIAS)) {
+    return ORIENTATION_FORMAT_BINARY;
+  }
+  if (strstr(message, ORIENTATION_FORMAT_TEXT_COMMAND) || strstr(message, ORIENTATION_FORMAT_TEXT_ALIAS)) {
+    return ORIENTATION_FORMAT_TEXT;
+  }
+  return ORIENTATION_FORMAT_NONE;
+}
+
+#define ORIENTATION_FORMAT_REPLY_SIZE 64
+
+// Acknowledgement for a format request; returns the reply length, 0 for
+// ORIENTATION_FORMAT_NONE (nothing to send)
+inline size_t formatOrientationFormatReply(char* buf, size_t size, OrientationFormatRequest format) {
+  int length = 0;
+  if (format == ORIENTATION_FORMAT_BINARY) {
+    length = snprintf(buf, size, "{\"type\":\"format\",\"format\":\"binary\",\"version\":%u}",
+                      (unsigned)ORIENTATION_FRAME_VERSION);
+  } else if (format == ORIENTATION_FORMAT_TEXT) {
+    length = snprintf(buf, size, "{\"type\":\"format\",\"format\":\"text\"}");
+  }
+  if (length < 0 || (size_t)length >= size) length = 0;
+  if (length == 0 && size > 0) buf[0] = '\0';
+  return (size_t)length;
+}
+
+inline void putFrameU16(uint8_t* buf, uint16_t value) {
+  buf[0] = value & 0xFF;
+  buf[1] = (value >> 8) & 0xFF;
+}
+
+inline void putFrameU32(uint8_t* buf, uint32_t value) {
+  buf[0] = value & 0xFF;
+  buf[1] = (value >> 8) & 0xFF;
+  buf[2] = (value >> 16) & 0xFF;
+  buf[3] = (value >> 24) & 0xFF;
+}
+
+// Angle in degrees -> int16 in 0.01 deg, wrapped to -180..180
+inline int16_t frameAngle(float degrees) {
+  float wrapped = fmodf(degrees, 360.0f);
+  if (wrapped > 180.0f) wrapped -= 360.0f;
+  if (wrapped < -180.0f) wrapped += 360.0f;
+  return (int16_t)lroundf(wrapped * 100.0f);
+}
+
+// Accumulated angle in degrees -> int32 in 0.01 deg, saturated
+inline int32_t frameAccumulatedAngle(double degrees) {
+  double scaled = degrees * 100.0;
+  if (scaled > 2147483647.0) return 2147483647L;
+  if (scaled < -2147483648.0) return (-2147483647L - 1);
+  return (int32_t)lround(scaled);
+}
+
+// Rate in deg/s -> int8 in ORIENTATION_FRAME_RATE_STEP, saturated
+inline int8_t frameRate(float degreesPerSecond) {
+  float scaled = degreesPerSecond / ORIENTATION_FRAME_RATE_STEP;
+  if (scaled > 127.0f) return 127;
+  if (scaled < -128.0f) return -128;
+  return (int8_t)lroundf(scaled);
+}
+
+// Fills buf (ORIENTATION_FRAME_SIZE bytes), returns frame length
+inline size_t encodeOrientationFrame(uint8_t* buf, uint16_t sequence, uint32_t timestampUs, uint8_t flags,
+                                     float pitch, float roll, float yaw,
+                                     double accPitch, double accRoll, double accYaw) {
+  buf[0] = ORIENTATION_FRAME_MAGIC;
+  buf[1] = ORIENTATION_FRAME_VERSION;
+  buf[2] = flags;
+  buf[3] = 0;
+  putFrameU16(buf + 4, sequence);
+  putFrameU32(buf + 6, timestampUs);
+  putFrameU16(buf + 10, (uint16_t)frameAngle(pitch));
+  putFrameU16(buf + 12, (uint16_t)frameAngle(roll));
+  putFrameU16(buf + 14, (uint16_t)frameAngle(yaw));
+  putFrameU32(buf + 16, (uint32_t)frameAccumulatedAngle(accPitch));
+  putFrameU32(buf + 20, (uint32_t)frameAccumulatedAngle(accRoll));
+  putFrameU32(buf + 24, (uint32_t)frameAccumulatedAngle(accYaw));
+  return ORIENTATION_FRAME_SIZE;
+}
+
+// Appends angular rates to a frame from encodeOrientationFrame
+// (buf has ORIENTATION_FRAME_RATES_SIZE bytes), returns the new frame length
+inline size_t appendOrientationRates(uint8_t* buf, float pitchRate, float rollRate, float yawRate) {
+  buf[2] |= ORIENTATION_FLAG_RATES;
+  buf[28] = (uint8_t)frameRate(pitchRate);
+  buf[29] = (uint8_t)frameRate(rollRate);
+  buf[30] = (uint8_t)frameRate(yawRate);
+  return ORIENTATION_FRAME_RATES_SIZE;
+}
+
+// Replaces the sample timestamp with the same instant in shared time
+inline void setOrientationSharedTime(uint8_t* buf, uint32_t sharedUs) {
+  buf[2] |= ORIENTATION_FLAG_SHARED_CLOCK;
+  putFrameU32(buf + 6, sharedUs);
+}
+
+#endif
@@ -0,0 +1,157 @@
+/*
+  Opt-in UDP stream of binary orientation frames
+  TCP (WebSocket) delivers poses in order, so one lost segment holds back
+  every later pose until it is retransmitted. Over UDP a lost datagram
+  is simply replaced by the next one; receivers drop frames whose
+  sequence number is not newer than the last one they used.
+
+  Datagram = OrientationFrame (OrientationFrame.h), one frame per packet,
+  sequence number at offset 4.
+
+  Destinations:
+    - up to UDP_POSE_MAX_SUBSCRIBERS unicast subscribers (ip:port), each
+      with a lease of UDP_POSE_LEASE_MS; subscribing again renews it
+    - one multicast group (ip:port), enabled/disabled explicitly
+  Subscriptions come in over the existing control channel (WebSocket
+  command or REST call); the stream itself never receives.
+
+  Usage:
+    WiFiUDP poseUdp;
+    UdpPoseStream<WiFiUDP> poseStream(poseUdp, UDP_POSE_LOCAL_PORT);
+    poseStream.begin();
+    poseStream.subscribe(webSocket.remoteIP(num), 4210, millis());
+    ...
+    poseStream.expire(millis());
+    if (poseStream.active()) poseStream.send(frame, frameLength);
+*/
+
+#ifndef UDP_POSE_STREAM_H
+#define UDP_POSE_STREAM_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#define UDP_POSE_MAX_SUBSCRIBERS 4
+#define UDP_POSE_LEASE_MS 30000UL
+
+template <class UDP>
+class UdpPoseStream {
+  public:
+    UdpPoseStream(UDP &udp, uint16_t localPort)
+      : udp(udp), localPort(localPort), multicastPort(0), packets(0), failures(0) {
+      for (uint8_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) subscribers[i].port = 0;
+    }
+
+    // Binds the source port so receivers see a stable sender
+    void begin() { udp.begin(localPort); }
+
+    // Adds or renews a unicast subscriber, false if the table is full
+    bool subscribe(const IPAddress &ip, uint16_t port, uint32_t nowMs) {
+      if (port == 0) return false;
+      int8_t freeSlot = -1;
+      for (uint8_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) {
+        Subscriber &s = subscribers[i];
+        if (s.port == port && s.ip == ip) {
+          s.renewedMs = nowMs;
+          return true;
+        }
+        if (s.port == 0 && freeSlot < 0) freeSlot = i;
+      }
+      if (freeSlot < 0) return false;
+      subscribers[freeSlot].ip = ip;
+      subscribers[freeSlot].port = port;
+      subscribers[freeSlot].renewedMs = nowMs;
+      return true;
+    }
+
+    // Removes ip:port, or every subscription of ip when port is 0
+    uint8_t unsubscribe(const IPAddress &ip, uint16_t port) {
+      uint8_t removed = 0;
+      for (uint8_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) {
+        Subscriber &s = subscribers[i];
+        if (s.port != 0 && s.ip == ip && (port == 0 || s.port == port)) {
+          s.port = 0;
+          removed++;
+        }
+      }
+      return removed;
+    }
+
+    // Multicast group; interfaceAddress is the station (or AP) IP
+    void setMulticast(const IPAddress &group, uint16_t port, const IPAddress &interfaceAddress) {
+      multicastGroup = group;
+      multicastPort = port;
+      multicastInterface = interfaceAddress;
+    }
+    void clearMulticast() { multicastPort = 0; }
+
+    // Drops subscribers that have not renewed within the lease
+    void expire(uint32_t nowMs) {
+      for (uint8_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) {
+        Subscriber &s = subscribers[i];
+        if (s.port != 0 && nowMs - s.renewedMs > UDP_POSE_LEASE_MS) s.port = 0;
+      }
+    }
+
+    bool active() const { return multicastPort != 0 || subscriberCount() > 0; }
+
+    uint8_t subscriberCount() const {
+      uint8_t count = 0;
+      for (uint8_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].port != 0) count++;
+      }
+      return count;
+    }
+
+    bool multicastEnabled() const { return multicastPort != 0; }
+    uint32_t sentPackets() const { return packets; }
+    uint32_t failedPackets() const { return failures; }
+
+    // One datagram per destination; a failed send is counted, never retried
+    void send(const uint8_t* frame, size_t length) {
+      for (uint8_t i = 0; i < UDP_POSE_MAX_SUBSCRIBERS; i++) {
+        const Subscriber &s = subscribers[i];
+        if (s.port == 0) continue;
+        count(udp.beginPacket(s.ip, s.port) && write(frame, length));
+      }
+      if (multicastPort != 0) {
+#if defined(ESP8266)
+        count(udp.beginPacketMulticast(multicastGroup, multicastPort, multicastInterface) &&
+              write(frame, length));
+#else
+        count(udp.beginPacket(multicastGroup, multicastPort) && write(frame, length));
+#endif
+      }
+    }
+
+  private:
+    struct Subscriber {
+      IPAddress ip;
+      uint16_t port;          // 0 - free slot
+      uint32_t renewedMs;
+    };
+
+    UDP &udp;
+    uint16_t localPort;
+    Subscriber subscribers[UDP_POSE_MAX_SUBSCRIBERS];
+    IPAddress multicastGroup, multicastInterface;
+    uint16_t multicastPort;
+    uint32_t packets, failures;
+
+    // A short write still closes the packet: otherwise the next
+    // beginPacket() would start on top of the unfinished one
+    bool write(const uint8_t* frame, size_t length) {
+      bool complete = udp.write(frame, length) == length;
+      return udp.endPacket() && complete;
+    }
+
+    void count(bool ok) {
+      if (ok) {
+        packets++;
+      } else {
+        failures++;
+      }
+    }
+};
+
+#endif
@@ -4,8 +4,37 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <WebSocketsServer.h>
+#include <WiFiUdp.h>
+#include <EEPROM.h>
+#include <LittleFS.h>
+#include "OrientationFrame.h"
+#include "TelemetryFormat.h"
+#include "MPU6050Bus.h"
+#include "CalibrationStore.h"
+#include "HeadOrientation.h"
+#include "SendPolicy.h"
+#include "UdpPoseStream.h"
+#include "ImuLog.h"
+
+// Фильтр ориентации: по умолчанию кватернион float (Madgwick, SensorFusion.h).
+// 1 - целочисленный Q16.16 (CORDIC atan2) для ESP8266, когда не хватает
+// времени на float: дешевле, но курс только по гироскопу и хуже
+// (Benchmark/fusion_replay: v7_fixed против v7_quat)
+#ifndef USE_FIXED_POINT_FILTER
+#define USE_FIXED_POINT_FILTER 0
+#endif
+#if USE_FIXED_POINT_FILTER && !defined(ESP8266)
+#error "USE_FIXED_POINT_FILTER is meant for ESP8266 only"
+#endif
+#define MPU_ADDR 0x68
+
+// Хранение калибровки в EEPROM (быстрый старт без калибровки)
+#define CALIBRATION_EEPROM_SIZE 64
+#define CALIBRATION_EEPROM_ADDR 0
 
 Adafruit_MPU6050 mpu;
+// Сырые регистры MPU6050 читаются через mpuBus (см. MPU6050Bus.h)
+MPU6050Bus<TwoWire> mpuBus(Wire, MPU_ADDR);
 
 // Настройки WiFi сети
 const char* ssid = "ESP8266_AP";
@@ -17,12 +46,38 @@ String newHostname = "VR_Head_Hom_001";
 ESP8266WebServer server(80);
 WebSocketsServer webSocket = WebSocketsServer(81);
 
+// UDP поток бинарных кадров (по подписке, см. UdpPoseStream.h)
+#define UDP_POSE_LOCAL_PORT 4210
+#define UDP_POSE_REFRESH_US 20000   // Без новых кадров повторяем позу каждые 20 мс
+WiFiUDP poseUdp;
+UdpPoseStream<WiFiUDP> poseStream(poseUdp, UDP_POSE_LOCAL_PORT);
+uint16_t udpSequence = 0;            // Свой счетчик: потери UDP не смешиваются с WebSocket
+unsigned long lastUdpFrameMicros = 0;
+
+// Запись сырых отсчетов MPU6050 во flash (LittleFS, см. ImuLog.h), управление через /api/recorder/*
+#define IMU_LOG_PATH "/imu.log"
+#define IMU_LOG_RESERVE_BYTES 16384   // Оставляем свободным для файловой системы
+#define IMU_LOG_CHUNK_MAX 16384       // Максимум байт за один GET /api/recorder/log
+ImuRecorder<fs::FS, fs::File> imuRecorder(LittleFS, IMU_LOG_PATH);
+bool logStorageReady = false;
+
 // Sensor data
 float pitch = 0, roll = 0, yaw = 0;
-float lastSentPitch = 0, lastSentRoll = 0, lastSentYaw = 0;
-float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
-unsigned long lastTime = 0;
+
+// Смещения, подстройка в покое и фильтр - в HeadOrientation.h (тот же код
+// гоняет Benchmark/fusion_replay на ПК)
+#if USE_FIXED_POINT_FILTER
+FixedHeadOrientation head;          // Целочисленный Q16.16, 500 Гц, сырые LSB
+#else
+QuaternionHeadOrientation head;     // Madgwick (SensorFusion.h), 100 Гц
+#endif
+const unsigned long SAMPLE_INTERVAL_US = head.SAMPLE_INTERVAL_US;
+
+// Сохраненная калибровка (уточняется в фоне после быстрого старта)
+CalibrationRecord calibrationRecord;
+bool warmStarted = false;
+unsigned long firstOrientationMs = 0;   // Время от старта до первой ориентации
 
 // Относительный ноль
 float zeroPitch = 0, zeroRoll = 0, zeroYaw = 0;
@@ -35,9 +90,20 @@ bool firstMeasurement = true;
 
 // WebSocket connection management
 bool clientConnected = false;
-unsigned long lastDataSend = 0;
-const unsigned long SEND_INTERVAL = 50;
-const float CHANGE_THRESHOLD = 1.0;
+// Кадр уходит, когда поза выходит из допуска относительно прогноза,
+// который клиент строит по скоростям из прошлого кадра (см. SendPolicy.h)
+const float SEND_ERROR_BUDGET = 0.5;                // Допуск прогноза, °
+const unsigned long SEND_KEEPALIVE_US = 250000;     // Кадр не реже 4 Гц
+const unsigned long SEND_MIN_INTERVAL_US = 10000;   // Не чаще 100 Гц
+const unsigned long SEND_PREDICTION_HORIZON_US = 100000;
+PredictiveSendPolicy sendPolicy(SEND_ERROR_BUDGET, SEND_KEEPALIVE_US,
+                                SEND_MIN_INTERVAL_US, SEND_PREDICTION_HORIZON_US);
+
+// Формат кадров для каждого клиента: текст (по умолчанию) или бинарный
+// (FORMAT:BIN или setFormat:binary, см. OrientationFrame.h)
+bool binaryClients[WEBSOCKETS_SERVER_CLIENT_MAX] = {false};
+uint16_t frameSequence = 0;
+unsigned long lastSampleMicros = 0;
 
 // Установка относительного нуля
 void setZeroPoint() {
@@ -134,23 +200,46 @@ double getRelativeYaw() {
   return accumulatedYaw - zeroYaw;
 }
 
-void calibrateSensor() {
-  Serial.println("Calibrating...");
-  float sumX = 0, sumY = 0, sumZ = 0;
-  
-  for (int i = 0; i < 500; i++) {
-    sensors_event_t a, g, temp;
-    mpu.getEvent(&a, &g, &temp);
-    sumX += g.gyro.x;
-    sumY += g.gyro.y;
-    sumZ += g.gyro.z;
-    delay(2);
+// Запись текущих смещений в EEPROM
+void storeCalibration(float temperature, uint32_t samples) {
+  initCalibrationRecord(calibrationRecord, mpuBus.whoAmI(), MPU_ADDR, head.CALIBRATION_UNITS);
+  head.storeOffsets(calibrationRecord);
+  calibrationRecord.temperature = temperature;
+  calibrationRecord.sampleCount = samples;
+  saveCalibration(CALIBRATION_EEPROM_ADDR, calibrationRecord);
+  
+  Serial.printf("Calibration saved to EEPROM, T=%.1fC\n", temperature);
+}
+
+// Быстрый старт: смещения из EEPROM, если датчик и температура совпадают
+bool loadStoredCalibration() {
+  MPU6050Sample sample;
+  if (!mpuBus.readSample(sample)) return false;
+  float temperature = mpu6050Temperature(sample.temp);
+  
+  if (!loadCalibration(CALIBRATION_EEPROM_ADDR, calibrationRecord, mpuBus.whoAmI(), MPU_ADDR,
+                       head.CALIBRATION_UNITS, temperature)) {
+    return false;
   }
   
-  gyroOffsetX = sumX / 500;
-  gyroOffsetY = sumY / 500;
-  gyroOffsetZ = sumZ / 500;
+  head.restore(calibrationRecord);
   calibrated = true;
+  warmStarted = true;
+  
+  Serial.printf("Calibration loaded from EEPROM (stored T=%.1fC, now T=%.1fC)\n",
+                calibrationRecord.temperature, temperature);
+  return true;
+}
+
+void calibrateSensor() {
+  Serial.println("Calibrating...");
+  float temperature = 0;
+  uint32_t samples = head.calibrate(mpuBus, temperature);
+  calibrated = true;
+  
+  // Свежая калибровка не требует уточнения, сохраняем ее
+  warmStarted = false;
+  storeCalibration(temperature, samples);
   
   Serial.println("Calibration complete");
 }
@@ -164,27 +253,133 @@ void sendSensorData() {
   double relRoll = getRelativeRoll();
   double relYaw = getRelativeYaw();
   
-  String data = "PITCH:" + String(pitch, 1) + 
-                ",ROLL:" + String(roll, 1) + 
-                ",YAW:" + String(yaw, 1) +
-                ",REL_PITCH:" + String(relPitch, 2) +
-                ",REL_ROLL:" + String(relRoll, 2) +
-                ",REL_YAW:" + String(relYaw, 2) +
-                ",ACC_PITCH:" + String(accumulatedPitch, 2) +
-                ",ACC_ROLL:" + String(accumulatedRoll, 2) +
-                ",ACC_YAW:" + String(accumulatedYaw, 2) +
-                ",ZERO_SET:" + String(zeroSet ? "true" : "false");
+  // Какие форматы нужны подключенным клиентам
+  bool anyTextClient = false;
+  bool anyBinaryClient = false;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (!webSocket.clientIsConnected(i)) continue;
+    if (binaryClients[i]) {
+      anyBinaryClient = true;
+    } else {
+      anyTextClient = true;
+    }
+  }
+  frameSequence++;
+  
+  // Бинарный кадр собирается на стеке, без String
+  if (anyBinaryClient) {
+    uint8_t frame[ORIENTATION_FRAME_RATES_SIZE];
+    size_t frameLength = encodePoseFrame(frame, frameSequence);
+    if (!anyTextClient) {
+      webSocket.broadcastBIN(frame, frameLength);
+    } else {
+      for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        if (binaryClients[i] && webSocket.clientIsConnected(i)) {
+          webSocket.sendBIN(i, frame, frameLength);
+        }
+      }
+    }
+  }
   
-  webSocket.broadcastTXT(data);
-  lastSentPitch = pitch;
-  lastSentRoll = roll;
-  lastSentYaw = yaw;
+  if (anyTextClient) {
+    String data = "PITCH:" + String(pitch, 1) + 
+                  ",ROLL:" + String(roll, 1) + 
+                  ",YAW:" + String(yaw, 1) +
+                  ",REL_PITCH:" + String(relPitch, 2) +
+                  ",REL_ROLL:" + String(relRoll, 2) +
+                  ",REL_YAW:" + String(relYaw, 2) +
+                  ",ACC_PITCH:" + String(accumulatedPitch, 2) +
+                  ",ACC_ROLL:" + String(accumulatedRoll, 2) +
+                  ",ACC_YAW:" + String(accumulatedYaw, 2) +
+                  ",ZERO_SET:" + String(zeroSet ? "true" : "false") +
+                  ",SEQ:" + String(frameSequence) +
+                  ",TS:" + String(lastSampleMicros) +
+                  ",RATE_P:" + String(sendPolicy.rate(0), 1) +
+                  ",RATE_R:" + String(sendPolicy.rate(1), 1) +
+                  ",RATE_Y:" + String(sendPolicy.rate(2), 1);
+    
+    if (!anyBinaryClient) {
+      webSocket.broadcastTXT(data);
+    } else {
+      for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+        if (!binaryClients[i] && webSocket.clientIsConnected(i)) {
+          webSocket.sendTXT(i, data);
+        }
+      }
+    }
+  }
+  sendUdpPoseFrame();
+  sendPolicy.sent(lastSampleMicros, pitch, roll, yaw);
+}
+
+// Бинарный кадр текущей позы со скоростями для прогноза на клиенте
+size_t encodePoseFrame(uint8_t* frame, uint16_t sequence) {
+  encodeOrientationFrame(frame, sequence, lastSampleMicros,
+                         zeroSet ? ORIENTATION_FLAG_ZERO_SET : 0,
+                         pitch, roll, yaw,
+                         accumulatedPitch, accumulatedRoll, accumulatedYaw);
+  return appendOrientationRates(frame, sendPolicy.rate(0), sendPolicy.rate(1), sendPolicy.rate(2));
+}
+
+// Кадр подписчикам UDP; потерянный кадр заменяется следующим, а не пересылается
+void sendUdpPoseFrame() {
+  if (!poseStream.active()) return;
+  uint8_t frame[ORIENTATION_FRAME_RATES_SIZE];
+  size_t frameLength = encodePoseFrame(frame, ++udpSequence);
+  poseStream.send(frame, frameLength);
+  lastUdpFrameMicros = lastSampleMicros;
+}
+
+// "4210" или "192.168.1.20:4210"; без IP - адрес отправителя команды
+bool parseUdpEndpoint(const String &spec, const IPAddress &defaultIp, IPAddress &ip, uint16_t &port) {
+  int colon = spec.lastIndexOf(':');
+  ip = defaultIp;
+  if (colon >= 0 && !ip.fromString(spec.substring(0, colon))) return false;
+  long value = spec.substring(colon + 1).toInt();
+  if (value <= 0 || value > 65535) return false;
+  port = (uint16_t)value;
+  return true;
 }
 
-bool dataChanged() {
-  return (abs(pitch - lastSentPitch) >= CHANGE_THRESHOLD ||
-          abs(roll - lastSentRoll) >= CHANGE_THRESHOLD ||
-          abs(yaw - lastSentYaw) >= CHANGE_THRESHOLD);
+String udpStatusText() {
+  return "UDP:STATUS,SUBSCRIBERS:" + String(poseStream.subscriberCount()) +
+         ",MULTICAST:" + String(poseStream.multicastEnabled() ? "true" : "false") +
+         ",SENT:" + String(poseStream.sentPackets()) +
+         ",FAILED:" + String(poseStream.failedPackets());
+}
+
+// Команды UDP:... по WebSocket, ответ - строка для отправителя
+String handleUdpCommand(const String &command, const IPAddress &remoteIp) {
+  IPAddress ip;
+  uint16_t port;
+  if (command.startsWith("UDP:SUBSCRIBE:")) {
+    if (!parseUdpEndpoint(command.substring(14), remoteIp, ip, port)) return "UDP:ERROR:BAD_ENDPOINT";
+    if (!poseStream.subscribe(ip, port, millis())) return "UDP:ERROR:FULL";
+    return "UDP:SUBSCRIBED,IP:" + ip.toString() + ",PORT:" + String(port) +
+           ",LEASE_MS:" + String(UDP_POSE_LEASE_MS);
+  }
+  if (command == "UDP:UNSUBSCRIBE") {
+    return "UDP:UNSUBSCRIBED:" + String(poseStream.unsubscribe(remoteIp, 0));
+  }
+  if (command.startsWith("UDP:UNSUBSCRIBE:")) {
+    if (!parseUdpEndpoint(command.substring(16), remoteIp, ip, port)) return "UDP:ERROR:BAD_ENDPOINT";
+    return "UDP:UNSUBSCRIBED:" + String(poseStream.unsubscribe(ip, port));
+  }
+  if (command == "UDP:MULTICAST:OFF") {
+    poseStream.clearMulticast();
+    return "UDP:MULTICAST:OFF";
+  }
+  if (command.startsWith("UDP:MULTICAST:")) {
+    if (!parseUdpEndpoint(command.substring(14), IPAddress(), ip, port) || ip[0] < 224 || ip[0] > 239) {
+      return "UDP:ERROR:BAD_GROUP";
+    }
+    poseStream.setMulticast(ip, port, WiFi.localIP());
+    return "UDP:MULTICAST:" + ip.toString() + ":" + String(port);
+  }
+  if (command == "UDP:STATUS") {
+    return udpStatusText();
+  }
+  return "UDP:ERROR:UNKNOWN_COMMAND";
 }
 
 void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length) {
@@ -192,13 +387,16 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
     case WStype_DISCONNECTED:
       Serial.printf("[%u] Disconnected!\n", num);
       clientConnected = (webSocket.connectedClients() > 0);
+      binaryClients[num] = false;
       break;
       
     case WStype_CONNECTED:
       {
+        binaryClients[num] = false;
         IPAddress ip = webSocket.remoteIP(num);
         Serial.printf("[%u] Connected from %d.%d.%d.%d\n", num, ip[0], ip[1], ip[2], ip[3]);
         clientConnected = true;
+        sendPolicy.invalidate();
         sendSensorData();
       }
       break;
@@ -207,6 +405,7 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
       {
         String message = String((char*)payload);
         Serial.printf("[%u] Received: %s\n", num, message);
+        OrientationFormatRequest format = parseOrientationFormatRequest(message.c_str());
         
         if (message == "GET_DATA") {
           sendSensorData();
@@ -218,8 +417,10 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
           webSocket.broadcastTXT(calMessage);
         }
         else if (message == "RESET_ANGLES") {
-          pitch = 0; roll = 0; yaw = 0;
-          lastSentPitch = 0; lastSentRoll = 0; lastSentYaw = 0;
+          // В кватернионном режиме наклон задается гравитацией, сбрасывается только курс
+          head.resetAngles();
+          pitch = head.pitch; roll = head.roll; yaw = head.yaw;
+          sendPolicy.reset();
           resetZeroPoint();
           String resetMessage = "ANGLES_RESET";
           webSocket.broadcastTXT(resetMessage);
@@ -233,6 +434,16 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
           resetZeroPoint();
           webSocket.broadcastTXT("ZERO_POINT_RESET");
         }
+        else if (format != ORIENTATION_FORMAT_NONE) {
+          binaryClients[num] = format == ORIENTATION_FORMAT_BINARY;
+          char reply[ORIENTATION_FORMAT_REPLY_SIZE];
+          size_t length = formatOrientationFormatReply(reply, sizeof(reply), format);
+          webSocket.sendTXT(num, reply, length);
+        }
+        else if (message.startsWith("UDP:")) {
+          String reply = handleUdpCommand(message, webSocket.remoteIP(num));
+          webSocket.sendTXT(num, reply);
+        }
       }
       break;
   }
@@ -252,21 +463,31 @@ void handleOptions() {
 
 void handleAPIStatus() {
   addCORSHeaders();
-  String json = "{";
-  json += "\"status\":\"running\",";
-  json += "\"ip\":\"" + WiFi.localIP().toString() + "\",";
-  json += "\"pitch\":" + String(pitch, 2) + ",";
-  json += "\"roll\":" + String(roll, 2) + ",";
-  json += "\"yaw\":" + String(yaw, 2) + ",";
-  json += "\"relPitch\":" + String(getRelativePitch(), 2) + ",";
-  json += "\"relRoll\":" + String(getRelativeRoll(), 2) + ",";
-  json += "\"relYaw\":" + String(getRelativeYaw(), 2) + ",";
-  json += "\"accPitch\":" + String(accumulatedPitch, 2) + ",";
-  json += "\"accRoll\":" + String(accumulatedRoll, 2) + ",";
-  json += "\"accYaw\":" + String(accumulatedYaw, 2) + ",";
-  json += "\"zeroSet\":" + String(zeroSet ? "true" : "false");
-  json += "}";
-  server.send(200, "application/json", json);
+  
+  static const TelemetryField STATUS_FIELDS[] = {
+    {"\",\"pitch\":", 2}, {",\"roll\":", 2}, {",\"yaw\":", 2},
+    {",\"relPitch\":", 2}, {",\"relRoll\":", 2}, {",\"relYaw\":", 2},
+    {",\"accPitch\":", 2}, {",\"accRoll\":", 2}, {",\"accYaw\":", 2}
+  };
+  const double values[] = {
+    pitch, roll, yaw,
+    getRelativePitch(), getRelativeRoll(), getRelativeYaw(),
+    accumulatedPitch, accumulatedRoll, accumulatedYaw
+  };
+  
+  IPAddress ip = WiFi.localIP();
+  TelemetryMessage<384> json;
+  json.text("{\"status\":\"running\",\"ip\":\"")
+      .number(ip[0]).character('.').number(ip[1]).character('.')
+      .number(ip[2]).character('.').number(ip[3])
+      .fields(STATUS_FIELDS, values)
+      .text(",\"zeroSet\":").boolean(zeroSet)
+      .text(",\"calibrationSource\":\"").text(warmStarted ? "stored" : "fresh")
+      .text("\",\"calibrationRefined\":").boolean(head.refiner.isDone())
+      .text(",\"firstOrientationMs\":").number(firstOrientationMs)
+      .text(",\"stationary\":").boolean(head.stationaryDetector.isStationary())
+      .text("}");
+  server.send(200, "application/json", json.c_str(), json.length());
 }
 
 void handleSetZero() {
@@ -283,6 +504,141 @@ void handleResetZero() {
   server.send(200, "application/json", response);
 }
 
+// POST /api/udp/subscribe?port=4210[&ip=192.168.1.20] - без ip подписывается вызывающий
+void handleUdpSubscribe() {
+  addCORSHeaders();
+  String spec = server.hasArg("ip") ? server.arg("ip") + ":" + server.arg("port") : server.arg("port");
+  String reply = handleUdpCommand("UDP:SUBSCRIBE:" + spec, server.client().remoteIP());
+  server.send(reply.startsWith("UDP:ERROR") ? 400 : 200, "text/plain", reply);
+}
+
+// POST /api/udp/unsubscribe[?port=4210][&ip=...] - без port снимаются все подписки адреса
+void handleUdpUnsubscribe() {
+  addCORSHeaders();
+  String command = "UDP:UNSUBSCRIBE";
+  if (server.hasArg("port")) {
+    command += ":" + (server.hasArg("ip") ? server.arg("ip") + ":" : String("")) + server.arg("port");
+  }
+  String reply = handleUdpCommand(command, server.client().remoteIP());
+  server.send(reply.startsWith("UDP:ERROR") ? 400 : 200, "text/plain", reply);
+}
+
+// POST /api/udp/multicast?group=239.1.2.3&port=4210, без group - выключить
+void handleUdpMulticast() {
+  addCORSHeaders();
+  String command = server.hasArg("group") ?
+                   "UDP:MULTICAST:" + server.arg("group") + ":" + server.arg("port") :
+                   String("UDP:MULTICAST:OFF");
+  String reply = handleUdpCommand(command, server.client().remoteIP());
+  server.send(reply.startsWith("UDP:ERROR") ? 400 : 200, "text/plain", reply);
+}
+
+void handleUdpStatus() {
+  addCORSHeaders();
+  server.send(200, "text/plain", udpStatusText());
+}
+
+// POST /api/recorder/start[?maxKB=512] - начинает новый лог (старый удаляется)
+void handleRecorderStart() {
+  addCORSHeaders();
+  if (!logStorageReady) {
+    server.send(503, "text/plain", "RECORDER:ERROR:NO_FS");
+    return;
+  }
+  imuRecorder.stop();
+  LittleFS.remove(IMU_LOG_PATH);
+
+  FSInfo info;
+  LittleFS.info(info);
+  uint32_t freeBytes = info.totalBytes - info.usedBytes;
+  uint32_t maxBytes = freeBytes > IMU_LOG_RESERVE_BYTES ? freeBytes - IMU_LOG_RESERVE_BYTES : 0;
+  if (server.hasArg("maxKB")) {
+    uint32_t requested = server.arg("maxKB").toInt() * 1024UL;
+    if (requested > 0 && requested < maxBytes) maxBytes = requested;
+  }
+
+  // ±4g, ±250°/с; смещения гироскопа в LSB - какими их видел фильтр
+  ImuLogHeader header = {SAMPLE_INTERVAL_US, 8192, 1310, {0, 0, 0}};
+#if USE_FIXED_POINT_FILTER
+  header.gyroOffset[0] = head.gyroOffsetX;
+  header.gyroOffset[1] = head.gyroOffsetY;
+  header.gyroOffset[2] = head.gyroOffsetZ;
+#else
+  header.gyroOffset[0] = lroundf(head.gyroOffsetX * RAD_TO_DEG * 131);
+  header.gyroOffset[1] = lroundf(head.gyroOffsetY * RAD_TO_DEG * 131);
+  header.gyroOffset[2] = lroundf(head.gyroOffsetZ * RAD_TO_DEG * 131);
+#endif
+  if (maxBytes < 2 * IMU_LOG_BLOCK_SIZE || !imuRecorder.start(header, maxBytes)) {
+    server.send(507, "text/plain", "RECORDER:ERROR:NO_SPACE");
+    return;
+  }
+  Serial.printf("IMU log started, up to %u bytes\n", maxBytes);
+  server.send(200, "text/plain", "RECORDER:STARTED:" + String(maxBytes));
+}
+
+void handleRecorderStop() {
+  addCORSHeaders();
+  imuRecorder.stop();
+  server.send(200, "text/plain", "RECORDER:STOPPED:" + String(imuRecorder.samples()));
+}
+
+void handleRecorderStatus() {
+  addCORSHeaders();
+  uint32_t logBytes = 0;
+  if (logStorageReady && !imuRecorder.recording() && LittleFS.exists(IMU_LOG_PATH)) {
+    File logFile = LittleFS.open(IMU_LOG_PATH, "r");
+    logBytes = logFile.size();
+    logFile.close();
+  }
+  TelemetryMessage<320> json;
+  json.text("{\"recording\":").boolean(imuRecorder.recording())
+      .text(",\"samples\":").number(imuRecorder.samples())
+      .text(",\"blocks\":").number(imuRecorder.blocks())
+      .text(",\"bytes\":").number(imuRecorder.bytes())
+      .text(",\"gaps\":").number(imuRecorder.gaps())
+      .text(",\"slowestWriteUs\":").number(imuRecorder.slowestWriteUs())
+      .text(",\"stopReason\":\"")
+      .text(imuRecorder.failed() ? "error" : imuRecorder.stoppedFull() ? "full" : "")
+      .text("\",\"logBytes\":").number(logBytes)
+      .text(",\"blockSize\":").number(IMU_LOG_BLOCK_SIZE)
+      .text("}");
+  server.send(200, "application/json", json.c_str(), json.length());
+}
+
+// GET /api/recorder/log?offset=0&length=16384 - кусок файла лога как есть,
+// полный размер в заголовке X-Log-Size (декодер: Benchmark/imu_log.py)
+void handleRecorderLog() {
+  addCORSHeaders();
+  if (imuRecorder.recording()) {
+    server.send(409, "text/plain", "RECORDER:ERROR:RECORDING");
+    return;
+  }
+  File logFile = logStorageReady ? LittleFS.open(IMU_LOG_PATH, "r") : File();
+  if (!logFile) {
+    server.send(404, "text/plain", "RECORDER:ERROR:NO_LOG");
+    return;
+  }
+  uint32_t size = logFile.size();
+  uint32_t offset = server.hasArg("offset") ? server.arg("offset").toInt() : 0;
+  uint32_t length = server.hasArg("length") ? server.arg("length").toInt() : IMU_LOG_CHUNK_MAX;
+  if (offset > size) offset = size;
+  if (length > IMU_LOG_CHUNK_MAX) length = IMU_LOG_CHUNK_MAX;
+  if (length > size - offset) length = size - offset;
+
+  logFile.seek(offset);
+  server.sendHeader("X-Log-Size", String(size));
+  server.setContentLength(length);
+  server.send(200, "application/octet-stream", "");
+  uint8_t buffer[512];
+  while (length > 0) {
+    size_t n = logFile.read(buffer, length < sizeof(buffer) ? length : sizeof(buffer));
+    if (n == 0) break;
+    server.sendContent((const char*)buffer, n);
+    length -= n;
+  }
+  logFile.close();
+}
+
 void handleRoot() {
   String html = R"rawliteral(
 <!DOCTYPE html>
@@ -462,6 +818,9 @@ void handleRoot() {
                     const accRollMatch = data.match(/ACC_ROLL:([-\d.]+)/);
                     const accYawMatch = data.match(/ACC_YAW:([-\d.]+)/);
                     const zeroSetMatch = data.match(/ZERO_SET:(true|false)/);
+                    const ratePitchMatch = data.match(/RATE_P:([-\d.]+)/);
+                    const rateRollMatch = data.match(/RATE_R:([-\d.]+)/);
+                    const rateYawMatch = data.match(/RATE_Y:([-\d.]+)/);
                     
                     if (pitchMatch) {
                         const pitch = parseFloat(pitchMatch[1]);
@@ -505,8 +864,16 @@ void handleRoot() {
                         zeroStatusSpan.style.color = zeroSet ? '#28a745' : '#dc3545';
                     }
                     
-                    // Update 3D visualization
-                    update3DVisualization(pitchMatch[1], rollMatch[1], yawMatch[1]);
+                    // The cube is drawn by the predictor on every animation frame
+                    if (pitchMatch && rollMatch && yawMatch) {
+                        posePredictor.update(parseFloat(pitchMatch[1]), parseFloat(rollMatch[1]), parseFloat(yawMatch[1]),
+                            ratePitchMatch ? parseFloat(ratePitchMatch[1]) : 0,
+                            rateRollMatch ? parseFloat(rateRollMatch[1]) : 0,
+                            rateYawMatch ? parseFloat(rateYawMatch[1]) : 0);
+                    }
+                }
+                if (event.data === 'ANGLES_RESET') {
+                    posePredictor.reset();
                 }
                 
                 // Parse zero point messages
@@ -532,6 +899,7 @@ void handleRoot() {
             
             ws.onclose = function() {
                 console.log('WebSocket disconnected');
+                posePredictor.reset();
                 statusDiv.textContent = 'Disconnected';
                 statusDiv.className = 'status disconnected';
                 
@@ -548,6 +916,48 @@ void handleRoot() {
             cube.style.transform = `rotateX(${roll}deg) rotateY(${yaw}deg) rotateZ(${pitch}deg)`;
         }
         
+        // Dead-reckoning pose predictor, same model as the device (SendPolicy.h):
+        // pose = last frame + rate * min(time since frame, horizon).
+        // The device only sends a frame when the real pose leaves this prediction
+        // by more than its error budget, so the cube keeps moving between frames.
+        const PREDICTION_HORIZON_MS = 100;
+        const posePredictor = {
+            frame: null,
+            
+            update(pitch, roll, yaw, ratePitch, rateRoll, rateYaw) {
+                this.frame = {
+                    pitch, roll, yaw,
+                    ratePitch, rateRoll, rateYaw,
+                    receivedAt: performance.now()
+                };
+            },
+            
+            reset() {
+                this.frame = null;
+            },
+            
+            predict(now) {
+                const f = this.frame;
+                if (!f) return null;
+                const dt = Math.min(Math.max(now - f.receivedAt, 0), PREDICTION_HORIZON_MS) / 1000;
+                const wrap = (angle) => ((angle + 180) % 360 + 360) % 360 - 180;
+                return {
+                    pitch: wrap(f.pitch + f.ratePitch * dt),
+                    roll: wrap(f.roll + f.rateRoll * dt),
+                    yaw: wrap(f.yaw + f.rateYaw * dt)
+                };
+            }
+        };
+        
+        function renderPredictedPose(now) {
+            const pose = posePredictor.predict(now);
+            if (pose) {
+                update3DVisualization(pose.pitch, pose.roll, pose.yaw);
+            }
+            requestAnimationFrame(renderPredictedPose);
+        }
+        requestAnimationFrame(renderPredictedPose);
+        
         function sendCommand(command) {
             if (ws && ws.readyState === WebSocket.OPEN) {
                 ws.send(command);
@@ -619,12 +1029,27 @@ void setup() {
   mpu.setGyroRange(MPU6050_RANGE_250_DEG);
   mpu.setFilterBandwidth(MPU6050_BAND_10_HZ);
   
-  calibrateSensor();
+  EEPROM.begin(CALIBRATION_EEPROM_SIZE);
+  logStorageReady = LittleFS.begin();
+  if (!logStorageReady) {
+    Serial.println("LittleFS mount failed, IMU recorder disabled");
+  }
+  if (!loadStoredCalibration()) {
+    calibrateSensor();
+  }
   
   server.on("/", handleRoot);
   server.on("/api/status", HTTP_GET, handleAPIStatus);
   server.on("/api/setZero", HTTP_POST, handleSetZero);
   server.on("/api/resetZero", HTTP_POST, handleResetZero);
+  server.on("/api/udp/subscribe", HTTP_POST, handleUdpSubscribe);
+  server.on("/api/udp/unsubscribe", HTTP_POST, handleUdpUnsubscribe);
+  server.on("/api/udp/multicast", HTTP_POST, handleUdpMulticast);
+  server.on("/api/udp/status", HTTP_GET, handleUdpStatus);
+  server.on("/api/recorder/start", HTTP_POST, handleRecorderStart);
+  server.on("/api/recorder/stop", HTTP_POST, handleRecorderStop);
+  server.on("/api/recorder/status", HTTP_GET, handleRecorderStatus);
+  server.on("/api/recorder/log", HTTP_GET, handleRecorderLog);
   
   server.on("/api/status", HTTP_OPTIONS, handleOptions);
   server.on("/api/setZero", HTTP_OPTIONS, handleOptions);
@@ -635,11 +1060,11 @@ void setup() {
   
   webSocket.begin();
   webSocket.onEvent(webSocketEvent);
+  poseStream.begin();
   
   Serial.println("HTTP server started on port 80");
   Serial.println("WebSocket server started on port 81");
-  
-  lastDataSend = millis();
+  Serial.println("UDP pose stream on port " + String(UDP_POSE_LOCAL_PORT) + " (subscribe via UDP:SUBSCRIBE)");
 }
 
 void loop() {
@@ -648,35 +1073,37 @@ void loop() {
   
   if (!calibrated) return;
   
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
-  
-  unsigned long currentTime = millis();
-  float deltaTime = (currentTime - lastTime) / 1000.0;
-  if (lastTime == 0) deltaTime = 0.01;
-  lastTime = currentTime;
-  
-  float gyroX = g.gyro.x - gyroOffsetX;
-  float gyroY = g.gyro.y - gyroOffsetY;
-  float gyroZ = g.gyro.z - gyroOffsetZ;
+  // Опрос датчика с фиксированным периодом (без delay())
+  unsigned long nowMicros = micros();
+  if (lastSampleMicros != 0 && nowMicros - lastSampleMicros < SAMPLE_INTERVAL_US) return;
+  unsigned long dtMicros = (lastSampleMicros == 0) ? SAMPLE_INTERVAL_US : nowMicros - lastSampleMicros;
+  lastSampleMicros = nowMicros;
   
-  float accelPitch = atan2(a.acceleration.y, a.acceleration.z) * 180.0 / PI;
-  float accelRoll = atan2(-a.acceleration.x, sqrt(a.acceleration.y * a.acceleration.y + a.acceleration.z * a.acceleration.z)) * 180.0 / PI;
+  // Один пакетный отсчет на проход в обоих режимах: его же видит фильтр и пишет рекордер
+  MPU6050Sample sample;
+  if (!mpuBus.readSample(sample)) return;
   
-  pitch += gyroX * deltaTime * 180.0 / PI;
-  roll += gyroY * deltaTime * 180.0 / PI;
-  yaw += gyroZ * deltaTime * 180.0 / PI;
+  // После быстрого старта смещения уточняются, пока устройство неподвижно
+  if (head.update(sample, dtMicros)) {
+    storeCalibration(mpu6050Temperature(sample.temp), head.refiner.samples());
+    Serial.println("Calibration refined");
+  }
+  imuRecorder.append(lastSampleMicros, sample);
   
-  float alpha = 0.96;
-  pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
-  roll = alpha * roll + (1.0 - alpha) * accelRoll;
+  pitch = head.pitch;
+  roll = head.roll;
+  yaw = head.yaw;
   
-  if (clientConnected && (currentTime - lastDataSend >= SEND_INTERVAL)) {
-    if (dataChanged() || lastDataSend == 0) {
-      sendSensorData();
-      lastDataSend = currentTime;
-    }
+  if (firstOrientationMs == 0) {
+    firstOrientationMs = millis();
   }
   
-  delay(10);
+  sendPolicy.observe(lastSampleMicros, pitch, roll, yaw);
+  poseStream.expire(millis());
+  if ((clientConnected || poseStream.active()) && sendPolicy.due(lastSampleMicros, pitch, roll, yaw)) {
+    sendSensorData();
+  } else if (poseStream.active() && lastSampleMicros - lastUdpFrameMicros >= UDP_POSE_REFRESH_US) {
+    // Потерянную датаграмму никто не перешлет - следующая должна прийти скоро
+    sendUdpPoseFrame();
+  }
 }
@@ -26,6 +26,10 @@ float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
 unsigned long lastTime = 0;
 
+// Метки кадра для измерения задержки: номер кадра и время отсчета (micros())
+uint32_t frameSequence = 0;
+unsigned long lastSampleMicros = 0;
+
 // Относительный ноль
 float zeroPitch = 0, zeroRoll = 0, zeroYaw = 0;
 bool zeroSet = false;
@@ -402,7 +406,9 @@ void sendSensorData() {
                 ",ACC_PITCH:" + String(accumulatedPitch, 2) +
                 ",ACC_ROLL:" + String(accumulatedRoll, 2) +
                 ",ACC_YAW:" + String(accumulatedYaw, 2) +
-                ",ZERO_SET:" + String(zeroSet ? "true" : "false");
+                ",ZERO_SET:" + String(zeroSet ? "true" : "false") +
+                ",SEQ:" + String(++frameSequence) +
+                ",TS:" + String(lastSampleMicros);
   
   // Отправка через Serial
   Serial.println(data);
@@ -768,6 +774,7 @@ void loop() {
   // Чтение данных с датчика
   sensors_event_t a, g, temp;
   if (mpu.getEvent(&a, &g, &temp)) {
+    lastSampleMicros = micros();
     unsigned long currentTime = millis();
     float deltaTime = (currentTime - lastTime) / 1000.0;
     if (lastTime == 0) deltaTime = 0.01;
@@ -6,6 +6,8 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include <SPIFFS.h>
+#include "SampleRing.h"
+#include "TaskMetrics.h"
 
 Adafruit_MPU6050 mpu;
 
@@ -14,6 +16,21 @@ Adafruit_MPU6050 mpu;
 #define CHARACTERISTIC_UUID "beb5483e-36e1-4688-b7f5-ea07361b26a8"
 #define DEVICE_NAME         "ESP32_MPU6050_BLE"
 
+// Конвейер: чтение (ядро 1) -> очередь -> фильтр (ядро 1) -> кольцо -> отправка по BLE (ядро 0)
+#define ACQUISITION_CORE 1
+#define FUSION_CORE 1
+#define TRANSPORT_CORE 0
+#define ACQUISITION_PRIORITY 4
+#define FUSION_PRIORITY 3
+#define TRANSPORT_PRIORITY 2
+#define ACQUISITION_STACK_SIZE 4096
+#define FUSION_STACK_SIZE 3072
+#define TRANSPORT_STACK_SIZE 4096
+#define SAMPLE_PERIOD_MS 2         // Чтение и фильтр на 500 Гц
+#define RAW_QUEUE_LENGTH 32        // ~64 мс сырых отсчетов
+#define OUTPUT_DECIMATION 2        // Усреднение: 500 Гц -> 250 Гц в кольцо
+#define SAMPLE_RING_SIZE 64
+
 void sendSensorData();
 void calibrateSensor();
 void resetZeroPoint();
@@ -27,7 +44,8 @@ bool deviceConnected = false;
 bool oldDeviceConnected = false;
 
 // Sensor data
-float pitch = 0, roll = 0, yaw = 0;
+float pitch = 0, roll = 0, yaw = 0;                      // Состояние фильтра (задача опроса)
+float displayPitch = 0, displayRoll = 0, displayYaw = 0; // Последний отсчет из кольца (задача отправки)
 float lastSentPitch = 0, lastSentRoll = 0, lastSentYaw = 0;
 float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
@@ -62,6 +80,40 @@ String sensorDataString = "";
 // HTML страница
 String htmlPage = "";
 
+// Сырой отсчет из задачи чтения в задачу фильтра
+struct RawSample {
+  float ax, ay, az;       // м/с²
+  float gx, gy, gz;       // рад/с, без смещения
+  uint32_t timestampUs;
+  bool fence;             // Не отсчет: фильтр доработал все, что было в очереди до него
+};
+
+// Задача чтения владеет I2C, задача фильтра - pitch/roll/yaw,
+// задача отправки - display*/accumulated*. Между ними только очередь и кольцо.
+QueueHandle_t rawQueue = NULL;
+SampleRing<OrientationSample, SAMPLE_RING_SIZE> orientationRing;
+OrientationDecimator outputDecimator(OUTPUT_DECIMATION);
+TaskHandle_t acquisitionTaskHandle = NULL;
+TaskHandle_t fusionTaskHandle = NULL;
+TaskHandle_t transportTaskHandle = NULL;
+unsigned long rawQueueDrops = 0;
+SemaphoreHandle_t fusionDrained = NULL;   // Фильтр дошел до метки в rawQueue
+volatile bool fusionRestartRequested = false;   // После калибровки/сканирования - заново начать фильтр
+
+// Нагрузка и стек задач (команда TASKS)
+TaskMetrics acquisitionMetrics;
+TaskMetrics fusionMetrics;
+TaskMetrics transportMetrics;
+
+// Команды, которые трогают I2C (задача чтения) или фильтр (задача фильтра),
+// ответ отправляет задача отправки
+#define SENSOR_COMMAND_NONE        0
+#define SENSOR_COMMAND_RECALIBRATE 1
+#define SENSOR_COMMAND_SCAN_I2C    2
+#define SENSOR_COMMAND_RESET       3
+volatile uint8_t sensorCommand = SENSOR_COMMAND_NONE;
+volatile uint8_t sensorCommandDone = SENSOR_COMMAND_NONE;
+
 // Класс коллбэков для сервера
 class MyServerCallbacks: public BLEServerCallbacks {
     void onConnect(BLEServer* pServer) {
@@ -98,14 +150,11 @@ class MyCallbacks: public BLECharacteristicCallbacks {
           sendSensorData();
         }
         else if (value == "RECALIBRATE") {
-          calibrated = false;
-          calibrateSensor();
-          String calMessage = "RECALIBRATION_COMPLETE";
-          pCharacteristic->setValue(calMessage.c_str());
-          pCharacteristic->notify();
+          sensorCommand = SENSOR_COMMAND_RECALIBRATE;
         }
         else if (value == "RESET_ANGLES") {
-          pitch = 0; roll = 0; yaw = 0;
+          sensorCommand = SENSOR_COMMAND_RESET;   // Углы фильтра сбрасывает задача опроса
+          displayPitch = 0; displayRoll = 0; displayYaw = 0;
           lastSentPitch = 0; lastSentRoll = 0; lastSentYaw = 0;
           resetZeroPoint();
           String resetMessage = "ANGLES_RESET";
@@ -144,18 +193,19 @@ class MyCallbacks: public BLECharacteristicCallbacks {
           pCharacteristic->notify();
         }
         else if (value == "SCAN_I2C") {
-          scanI2C();
-          String scanMessage = "I2C_SCAN_COMPLETE:ADDR:0x";
-          if (mpuAddress < 16) scanMessage += "0";
-          scanMessage += String(mpuAddress, HEX);
-          scanMessage += ",FOUND:" + String(mpuFound ? "true" : "false");
-          pCharacteristic->setValue(scanMessage.c_str());
+          sensorCommand = SENSOR_COMMAND_SCAN_I2C;
+        }
+        else if (value == "TASKS") {
+          String tasks = formatPipelineStatus();
+          pCharacteristic->setValue(tasks.c_str());
           pCharacteristic->notify();
         }
         else if (value == "STATUS") {
           String status = "STATUS:MPU6050:" + String(mpuFound ? "FOUND" : "NOT_FOUND") + 
                          ",CALIBRATED:" + String(calibrated ? "YES" : "NO") + 
-                         ",UPTIME:" + String(millis() / 1000) + "s";
+                         ",UPTIME:" + String(millis() / 1000) + "s" +
+                         ",DECIMATION:" + String(outputDecimator.getFactor()) +
+                         ",RING_DROPS:" + String(orientationRing.dropped());
           pCharacteristic->setValue(status.c_str());
           pCharacteristic->notify();
         }
@@ -226,18 +276,18 @@ void scanI2C() {
 
 // Установка относительного нуля
 void setZeroPoint() {
-  zeroPitch = pitch;
-  zeroRoll = roll;
-  zeroYaw = yaw;
+  zeroPitch = displayPitch;
+  zeroRoll = displayRoll;
+  zeroYaw = displayYaw;
   zeroSet = true;
   
   // Сбрасываем накопленные углы при установке нуля
   accumulatedPitch = 0;
   accumulatedRoll = 0;
   accumulatedYaw = 0;
-  prevPitch = pitch;
-  prevRoll = roll;
-  prevYaw = yaw;
+  prevPitch = displayPitch;
+  prevRoll = displayRoll;
+  prevYaw = displayYaw;
   
   Serial.println("Zero point set");
   Serial.print("Zero Pitch: "); Serial.print(zeroPitch);
@@ -265,9 +315,9 @@ void resetZeroPoint() {
   accumulatedPitch = 0;
   accumulatedRoll = 0;
   accumulatedYaw = 0;
-  prevPitch = pitch;
-  prevRoll = roll;
-  prevYaw = yaw;
+  prevPitch = displayPitch;
+  prevRoll = displayRoll;
+  prevYaw = displayYaw;
   
   Serial.println("Zero point reset");
   
@@ -280,17 +330,17 @@ void resetZeroPoint() {
 // Расчет накопленных углов (без ограничений)
 void updateAccumulatedAngles() {
   if (firstMeasurement) {
-    prevPitch = pitch;
-    prevRoll = roll;
-    prevYaw = yaw;
+    prevPitch = displayPitch;
+    prevRoll = displayRoll;
+    prevYaw = displayYaw;
     firstMeasurement = false;
     return;
   }
   
   // Вычисляем разницу углов с учетом переходов через 180/-180
-  float deltaPitch = pitch - prevPitch;
-  float deltaRoll = roll - prevRoll;
-  float deltaYaw = yaw - prevYaw;
+  float deltaPitch = displayPitch - prevPitch;
+  float deltaRoll = displayRoll - prevRoll;
+  float deltaYaw = displayYaw - prevYaw;
   
   // Корректируем разницу для переходов через границу ±180
   if (deltaPitch > 180) deltaPitch -= 360;
@@ -307,9 +357,9 @@ void updateAccumulatedAngles() {
   accumulatedRoll += deltaRoll;
   accumulatedYaw += deltaYaw;
   
-  prevPitch = pitch;
-  prevRoll = roll;
-  prevYaw = yaw;
+  prevPitch = displayPitch;
+  prevRoll = displayRoll;
+  prevYaw = displayYaw;
 }
 
 // Получение относительных углов (без ограничений)
@@ -359,9 +409,9 @@ void sendSensorData() {
   double relYaw = getRelativeYaw();
   
   // Формируем строку с данными
-  sensorDataString = "PITCH:" + String(pitch, 1) + 
-                ",ROLL:" + String(roll, 1) + 
-                ",YAW:" + String(yaw, 1) +
+  sensorDataString = "PITCH:" + String(displayPitch, 1) + 
+                ",ROLL:" + String(displayRoll, 1) + 
+                ",YAW:" + String(displayYaw, 1) +
                 ",REL_PITCH:" + String(relPitch, 2) +
                 ",REL_ROLL:" + String(relRoll, 2) +
                 ",REL_YAW:" + String(relYaw, 2) +
@@ -378,16 +428,16 @@ void sendSensorData() {
     pCharacteristic->notify();
   }
   
-  lastSentPitch = pitch;
-  lastSentRoll = roll;
-  lastSentYaw = yaw;
+  lastSentPitch = displayPitch;
+  lastSentRoll = displayRoll;
+  lastSentYaw = displayYaw;
   lastDataSend = millis();
 }
 
 bool dataChanged() {
-  return (abs(pitch - lastSentPitch) >= CHANGE_THRESHOLD ||
-          abs(roll - lastSentRoll) >= CHANGE_THRESHOLD ||
-          abs(yaw - lastSentYaw) >= CHANGE_THRESHOLD);
+  return (abs(displayPitch - lastSentPitch) >= CHANGE_THRESHOLD ||
+          abs(displayRoll - lastSentRoll) >= CHANGE_THRESHOLD ||
+          abs(displayYaw - lastSentYaw) >= CHANGE_THRESHOLD);
 }
 
 // Загрузка HTML страницы из SPIFFS
@@ -1396,8 +1446,9 @@ void setup() {
   
   Serial.println("Starting ESP32 with MPU6050 and BLE...");
   
-  // Инициализация I2C
+  // Инициализация I2C (400 кГц, чтобы чтение укладывалось в период 2 мс)
   Wire.begin();
+  Wire.setClock(400000);
   
   // Сканирование I2C шины
   scanI2C();
@@ -1477,14 +1528,194 @@ void setup() {
   Serial.println("Characteristic UUID: " + String(CHARACTERISTIC_UUID));
   Serial.println("MPU6050: " + String(mpuFound ? "Found" : "Not found"));
   Serial.println("Waiting for BLE connections...");
+  
+  // Чтение и фильтр на ядре 1, отправка на ядре 0 вместе со стеком BLE;
+  // loop() остается только рекламе BLE
+  rawQueue = xQueueCreate(RAW_QUEUE_LENGTH, sizeof(RawSample));
+  fusionDrained = xSemaphoreCreateBinary();
+  xTaskCreatePinnedToCore(fusionTask, "fusion", FUSION_STACK_SIZE, NULL,
+                          FUSION_PRIORITY, &fusionTaskHandle, FUSION_CORE);
+  xTaskCreatePinnedToCore(acquisitionTask, "acquisition", ACQUISITION_STACK_SIZE, NULL,
+                          ACQUISITION_PRIORITY, &acquisitionTaskHandle, ACQUISITION_CORE);
+  xTaskCreatePinnedToCore(transportTask, "transport", TRANSPORT_STACK_SIZE, NULL,
+                          TRANSPORT_PRIORITY, &transportTaskHandle, TRANSPORT_CORE);
 }
 
-void loop() {
-  if (!mpuFound || !calibrated) {
-    delay(100);
+// Задача чтения: единственная, кто обращается к MPU6050 по I2C
+void acquisitionTask(void* parameter) {
+  acquisitionMetrics.attach(xTaskGetCurrentTaskHandle());
+  TickType_t lastWake = xTaskGetTickCount();
+  
+  for (;;) {
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(SAMPLE_PERIOD_MS));
+    acquisitionMetrics.begin();
+    
+    uint8_t command = sensorCommand;
+    if (command == SENSOR_COMMAND_RECALIBRATE || command == SENSOR_COMMAND_SCAN_I2C) {
+      // Останавливаем поток отсчетов и ставим метку в конец очереди: когда
+      // фильтр до нее дошел, все отсчеты обработаны, и он ждет новых
+      bool wasCalibrated = calibrated;
+      calibrated = false;
+      RawSample fence = {};
+      fence.fence = true;
+      xQueueSend(rawQueue, &fence, portMAX_DELAY);
+      xSemaphoreTake(fusionDrained, portMAX_DELAY);
+      if (command == SENSOR_COMMAND_RECALIBRATE) {
+        calibrateSensor();
+      } else {
+        scanI2C();
+        calibrated = wasCalibrated;
+      }
+      fusionRestartRequested = true;
+      sensorCommand = SENSOR_COMMAND_NONE;
+      sensorCommandDone = command;
+      lastWake = xTaskGetTickCount();
+    }
+    
+    if (mpuFound && calibrated) {
+      sensors_event_t a, g, temp;
+      mpu.getEvent(&a, &g, &temp);
+      
+      RawSample item;
+      item.timestampUs = micros();
+      item.ax = a.acceleration.x;
+      item.ay = a.acceleration.y;
+      item.az = a.acceleration.z;
+      item.gx = g.gyro.x - gyroOffsetX;
+      item.gy = g.gyro.y - gyroOffsetY;
+      item.gz = g.gyro.z - gyroOffsetZ;
+      item.fence = false;
+      
+      // Если фильтр не успевает - отсчет теряется, чтение не ждет
+      if (xQueueSend(rawQueue, &item, 0) != pdTRUE) {
+        rawQueueDrops++;
+      }
+    }
+    acquisitionMetrics.end();
+  }
+}
+
+// Задача фильтра: комплементарный фильтр для каждого отсчета, результат - в кольцо
+void fusionTask(void* parameter) {
+  fusionMetrics.attach(xTaskGetCurrentTaskHandle());
+  
+  for (;;) {
+    RawSample item;
+    // Таймаут, чтобы RESET выполнялся и без потока отсчетов
+    bool received = xQueueReceive(rawQueue, &item, pdMS_TO_TICKS(20)) == pdTRUE;
+    
+    if (sensorCommand == SENSOR_COMMAND_RESET) {
+      pitch = 0; roll = 0; yaw = 0;
+      fusionRestartRequested = true;
+      sensorCommand = SENSOR_COMMAND_NONE;
+      sensorCommandDone = SENSOR_COMMAND_RESET;
+    }
+    if (fusionRestartRequested) {
+      fusionRestartRequested = false;
+      outputDecimator.reset();
+      lastTime = 0;
+    }
+    if (!received) continue;
+    if (item.fence) {
+      xSemaphoreGive(fusionDrained);
+      continue;
+    }
+    fusionMetrics.begin();
+    
+    float deltaTime = (item.timestampUs - lastTime) / 1000000.0;
+    if (lastTime == 0 || deltaTime > 0.1) deltaTime = SAMPLE_PERIOD_MS / 1000.0;
+    lastTime = item.timestampUs;
+    
+    float accelPitch = atan2(item.ay, item.az) * 180.0 / PI;
+    float accelRoll = atan2(-item.ax, sqrt(item.ay * item.ay + item.az * item.az)) * 180.0 / PI;
+    
+    pitch += item.gx * deltaTime * 180.0 / PI;
+    roll += item.gy * deltaTime * 180.0 / PI;
+    yaw += item.gz * deltaTime * 180.0 / PI;
+    
+    float alpha = 0.96;
+    pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
+    roll = alpha * roll + (1.0 - alpha) * accelRoll;
+    
+    OrientationSample out;
+    if (outputDecimator.add(item.timestampUs, pitch, roll, yaw, out)) {
+      orientationRing.push(out);
+    }
+    
+    fusionMetrics.end();
+  }
+}
+
+// Ответ на команду, выполненную задачей чтения
+void sendSensorCommandReply(uint8_t command) {
+  String message;
+  if (command == SENSOR_COMMAND_RECALIBRATE) {
+    message = "RECALIBRATION_COMPLETE";
+  } else if (command == SENSOR_COMMAND_SCAN_I2C) {
+    message = "I2C_SCAN_COMPLETE:ADDR:0x";
+    if (mpuAddress < 16) message += "0";
+    message += String(mpuAddress, HEX);
+    message += ",FOUND:" + String(mpuFound ? "true" : "false");
+  } else {
     return;
   }
+  if (deviceConnected && pCharacteristic) {
+    pCharacteristic->setValue(message.c_str());
+    pCharacteristic->notify();
+  }
+}
+
+// Задача отправки: последний отсчет из кольца уходит по BLE, сколько бы ни длился notify
+void transportTask(void* parameter) {
+  transportMetrics.attach(xTaskGetCurrentTaskHandle());
   
+  for (;;) {
+    transportMetrics.begin();
+    OrientationSample sample;
+    if (orientationRing.popLatest(sample)) {
+      displayPitch = sample.pitch;
+      displayRoll = sample.roll;
+      displayYaw = sample.yaw;
+    }
+    
+    uint8_t done = sensorCommandDone;
+    if (done != SENSOR_COMMAND_NONE) {
+      sensorCommandDone = SENSOR_COMMAND_NONE;
+      sendSensorCommandReply(done);
+    }
+    
+    // Автоматическая отправка данных при включенном потоке
+    if (deviceConnected && shouldSendData && mpuFound && calibrated) {
+      if (dataChanged() || (millis() - lastDataSend >= SEND_INTERVAL)) {
+        sendSensorData();
+      }
+    }
+    
+    transportMetrics.end();
+    vTaskDelay(1);
+  }
+}
+
+// Нагрузка (% ядра), итераций в секунду, самая долгая итерация и свободный стек задачи
+String formatTaskMetrics(const char* name, const TaskMetrics &metrics) {
+  return String(name) +
+         ":LOAD=" + String(metrics.load() / 10.0, 1) +
+         "%,RATE=" + String(metrics.rate()) +
+         ",MAX_US=" + String(metrics.maxIterationUs()) +
+         ",STACK_FREE=" + String(metrics.stackFree());
+}
+
+String formatPipelineStatus() {
+  return "TASKS:" + formatTaskMetrics("ACQ", acquisitionMetrics) +
+         ";" + formatTaskMetrics("FUSION", fusionMetrics) +
+         ";" + formatTaskMetrics("TX", transportMetrics) +
+         ";OUTPUT_HZ=" + String(fusionMetrics.rate() / outputDecimator.getFactor()) +
+         ",RAW_QUEUE=" + String((unsigned long)uxQueueMessagesWaiting(rawQueue)) +
+         ",RAW_DROPS=" + String(rawQueueDrops) +
+         ",RING_DROPS=" + String(orientationRing.dropped());
+}
+
+void loop() {
   // Обработка подключения/отключения BLE
   if (!deviceConnected && oldDeviceConnected) {
     delay(500); // Даем время для завершения соединения
@@ -1497,36 +1728,5 @@ void loop() {
     oldDeviceConnected = deviceConnected;
   }
   
-  // Чтение данных с MPU6050
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
-  
-  unsigned long currentTime = millis();
-  float deltaTime = (currentTime - lastTime) / 1000.0;
-  if (lastTime == 0) deltaTime = 0.01;
-  lastTime = currentTime;
-  
-  float gyroX = g.gyro.x - gyroOffsetX;
-  float gyroY = g.gyro.y - gyroOffsetY;
-  float gyroZ = g.gyro.z - gyroOffsetZ;
-  
-  float accelPitch = atan2(a.acceleration.y, a.acceleration.z) * 180.0 / PI;
-  float accelRoll = atan2(-a.acceleration.x, sqrt(a.acceleration.y * a.acceleration.y + a.acceleration.z * a.acceleration.z)) * 180.0 / PI;
-  
-  pitch += gyroX * deltaTime * 180.0 / PI;
-  roll += gyroY * deltaTime * 180.0 / PI;
-  yaw += gyroZ * deltaTime * 180.0 / PI;
-  
-  float alpha = 0.96;
-  pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
-  roll = alpha * roll + (1.0 - alpha) * accelRoll;
-  
-  // Автоматическая отправка данных при включенном потоке
-  if (deviceConnected && shouldSendData) {
-    if (dataChanged() || (currentTime - lastDataSend >= SEND_INTERVAL)) {
-      sendSensorData();
-    }
-  }
-  
-  delay(10);
+  delay(50);
 }
@@ -0,0 +1,82 @@
+/*
+  Per-task load and stack metrics for the FreeRTOS pipeline
+  Arduino-ESP32 is built without FreeRTOS run-time stats, so each task
+  times its own work: begin() after the blocking wait returns, end()
+  before the next wait. Busy time over a 1 s window gives the load.
+
+  Usage:
+    TaskMetrics fusionMetrics;
+    fusionMetrics.attach(xTaskGetCurrentTaskHandle());
+    for (;;) {
+      xQueueReceive(queue, &item, portMAX_DELAY);
+      fusionMetrics.begin();
+      ...
+      fusionMetrics.end();
+    }
+
+  Readers on other tasks/cores get values of the last complete window;
+  a torn read only shows a value from the previous window.
+*/
+
+#ifndef TASK_METRICS_H
+#define TASK_METRICS_H
+
+#include <Arduino.h>
+
+#define TASK_METRICS_WINDOW_US 1000000UL
+
+class TaskMetrics {
+  public:
+    TaskMetrics() : handle(NULL) { reset(); }
+
+    void attach(TaskHandle_t task) { handle = task; }
+
+    void reset() {
+      windowStart = micros();
+      busyUs = 0;
+      iterations = 0;
+      windowMaxUs = 0;
+      loadPermille = 0;
+      rateHz = 0;
+      maxUs = 0;
+    }
+
+    void begin() { startUs = micros(); }
+
+    void end() {
+      uint32_t now = micros();
+      uint32_t busy = now - startUs;
+      busyUs += busy;
+      iterations++;
+      if (busy > windowMaxUs) windowMaxUs = busy;
+
+      uint32_t window = now - windowStart;
+      if (window >= TASK_METRICS_WINDOW_US) {
+        loadPermille = (uint16_t)((uint64_t)busyUs * 1000 / window);
+        rateHz = (uint32_t)((uint64_t)iterations * 1000000 / window);
+        maxUs = windowMaxUs;
+        windowStart = now;
+        busyUs = 0;
+        iterations = 0;
+        windowMaxUs = 0;
+      }
+    }
+
+    // Share of one core spent in this task, 0.1 % units
+    uint16_t load() const { return loadPermille; }
+    // Work iterations per second
+    uint32_t rate() const { return rateHz; }
+    // Longest single iteration in the last window, us
+    uint32_t maxIterationUs() const { return maxUs; }
+    // Minimum free stack since start (bytes on ESP32)
+    uint32_t stackFree() const { return handle ? uxTaskGetStackHighWaterMark(handle) : 0; }
+
+  private:
+    TaskHandle_t handle;
+    uint32_t windowStart, startUs;
+    uint32_t busyUs, iterations, windowMaxUs;
+    volatile uint16_t loadPermille;
+    volatile uint32_t rateHz, maxUs;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/*
+  Fixed-point complementary filter for the FPU-less ESP8266
+  Works directly on raw MPU6050 register values, no float math per sample.
+
+  Angles are Q16.16 degrees (int32_t, 1.0 deg = 65536).
+  atan2 uses CORDIC (16 iterations, shift/add only), sqrt is integer.
+
+  Usage:
+    FixedPointFilter filter(131, 8192);      // gyro LSB per deg/s, accel LSB per g
+    filter.update(ax, ay, az, gx, gy, gz, dtMicros);
+    float pitch = fixedToFloat(filter.pitch);
+*/
+
+#ifndef FIXED_POINT_FILTER_H
+#define FIXED_POINT_FILTER_H
+
+#include <Arduino.h>
+
+typedef int32_t q16_t;
+
+#define Q16_ONE          65536L
+#define Q16_DEG_180      (180L * Q16_ONE)
+#define Q16_DEG_360      (360L * Q16_ONE)
+
+inline float fixedToFloat(q16_t value) {
+  return value * (1.0f / Q16_ONE);
+}
+
+// atan(2^-i) in Q16.16 degrees
+static const int32_t CORDIC_ATAN_TABLE[16] = {
+  2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+  14668, 7334, 3667, 1833, 917, 458, 229, 115
+};
+
+// atan2(y, x) in Q16.16 degrees, -180..180
+inline q16_t fixedAtan2(int32_t y, int32_t x) {
+  if (x == 0 && y == 0) return 0;
+
+  // Scale into 2^24..2^26: enough bits for the shifts, and the CORDIC
+  // gain (x1.647) stays well inside int32
+  while (x > 0x3FFFFFF || x < -0x3FFFFFF || y > 0x3FFFFFF || y < -0x3FFFFFF) {
+    x >>= 1;
+    y >>= 1;
+  }
+  while (x < 0x1000000 && x > -0x1000000 && y < 0x1000000 && y > -0x1000000) {
+    x <<= 1;
+    y <<= 1;
+  }
+
+  // Rotate into the right half-plane first
+  q16_t angle = 0;
+  if (x < 0) {
+    int32_t t = x;
+    if (y >= 0) {
+      x = y;
+      y = -t;
+      angle = 90L * Q16_ONE;
+    } else {
+      x = -y;
+      y = t;
+      angle = -90L * Q16_ONE;
+    }
+  }
+
+  for (uint8_t i = 0; i < 16; i++) {
+    int32_t dx = x >> i;
+    int32_t dy = y >> i;
+    if (y > 0) {
+      x += dy;
+      y -= dx;
+      angle += CORDIC_ATAN_TABLE[i];
+    } else {
+      x -= dy;
+      y += dx;
+      angle -= CORDIC_ATAN_TABLE[i];
+    }
+  }
+  return angle;
+}
+
+// Integer square root
+inline uint32_t fixedSqrt(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value) bit >>= 2;
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+inline q16_t wrapFixedAngle(q16_t angle) {
+  while (angle > Q16_DEG_180) angle -= Q16_DEG_360;
+  while (angle < -Q16_DEG_180) angle += Q16_DEG_360;
+  return angle;
+}
+
+class FixedPointFilter {
+  public:
+    q16_t pitch = 0;   // Rotation about X
+    q16_t roll = 0;    // Rotation about Y
+    q16_t yaw = 0;     // Rotation about Z, gyro only
+
+    // gyroLsbPerDeg: 131 for +-250 deg/s; accelLsbPerG: 8192 for +-4g
+    FixedPointFilter(int32_t gyroLsbPerDeg, int32_t accelLsbPerG, q16_t alpha = 62915 /* 0.96 */)
+      : gyroScale(gyroLsbPerDeg), accelOneG(accelLsbPerG), alpha(alpha) {}
+
+    void reset() {
+      pitch = roll = yaw = 0;
+      initialized = false;
+    }
+
+    // Raw sensor values with gyro offsets already removed
+    void update(int16_t ax, int16_t ay, int16_t az,
+                int32_t gx, int32_t gy, int32_t gz, uint32_t dtMicros) {
+      q16_t accelPitch = fixedAtan2(ay, az);
+      q16_t accelRoll = fixedAtan2(-(int32_t)ax, (int32_t)fixedSqrt((uint32_t)((int32_t)ay * ay) + (uint32_t)((int32_t)az * az)));
+
+      if (!initialized) {
+        pitch = accelPitch;
+        roll = accelRoll;
+        initialized = true;
+        return;
+      }
+
+      // Gyro integration: raw * dt / (LSB per deg/s * 1e6) in Q16.16
+      pitch += gyroDelta(gx, dtMicros);
+      roll += gyroDelta(gy, dtMicros);
+      yaw = wrapFixedAngle(yaw + gyroDelta(gz, dtMicros));
+
+      // Complementary filter, accel correction only near 1g
+      int32_t magnitude = fixedSqrt((uint32_t)((int32_t)ax * ax) + (uint32_t)((int32_t)ay * ay) + (uint32_t)((int32_t)az * az));
+      if (magnitude > accelOneG / 2 && magnitude < accelOneG * 3 / 2) {
+        pitch = blend(pitch, accelPitch);
+        roll = blend(roll, accelRoll);
+      }
+    }
+
+  private:
+    int32_t gyroScale;
+    int32_t accelOneG;
+    q16_t alpha;
+    bool initialized = false;
+
+    q16_t gyroDelta(int32_t rate, uint32_t dtMicros) const {
+      return (q16_t)(((int64_t)rate * dtMicros * Q16_ONE) / ((int64_t)gyroScale * 1000000L));
+    }
+
+    q16_t blend(q16_t gyroAngle, q16_t accelAngle) const {
+      // Follow the accel angle across the +-180 boundary
+      q16_t diff = wrapFixedAngle(accelAngle - gyroAngle);
+      return wrapFixedAngle(gyroAngle + (q16_t)(((int64_t)diff * (Q16_ONE - alpha)) >> 16));
+    }
+};
+
+#endif
@@ -0,0 +1,170 @@
+/*
+  MPU6050 register access, independent of the board
+  Sensor processing works on MPU6050Sample values only; everything that
+  touches I2C goes through MPU6050Bus.
+
+  The transport is a template parameter with the Arduino Wire interface
+  (beginTransmission, write, endTransmission, requestFrom, available,
+  read). On the device it is TwoWire; any object with the same methods,
+  e.g. one that replays a recorded register dump, can be used instead.
+
+  Usage:
+    MPU6050Bus<TwoWire> mpuBus(Wire, 0x68);
+    MPU6050Sample sample;
+    if (mpuBus.readSample(sample)) { ... sample.gx / 131.0 ... }
+*/
+
+#ifndef MPU6050_BUS_H
+#define MPU6050_BUS_H
+
+#include <Arduino.h>
+
+#define MPU6050_REG_SMPLRT_DIV    0x19
+#define MPU6050_REG_FIFO_EN       0x23
+#define MPU6050_REG_INT_PIN_CFG   0x37
+#define MPU6050_REG_INT_ENABLE    0x38
+#define MPU6050_REG_INT_STATUS    0x3A
+#define MPU6050_REG_ACCEL_XOUT_H  0x3B
+#define MPU6050_REG_USER_CTRL     0x6A
+#define MPU6050_REG_FIFO_COUNT_H  0x72
+#define MPU6050_REG_FIFO_R_W      0x74
+#define MPU6050_REG_WHO_AM_I      0x75
+
+#define MPU6050_INT_FIFO_OFLOW    0x10
+#define MPU6050_SAMPLE_BYTES      14   // ACCEL(6) + TEMP(2) + GYRO(6)
+
+// Raw values of one sample
+struct MPU6050Sample {
+  int16_t ax, ay, az;
+  int16_t temp;
+  int16_t gx, gy, gz;
+};
+
+// 14 bytes, big-endian - same layout for registers 0x3B..0x48 and FIFO
+inline void parseMPU6050Sample(const uint8_t* buf, MPU6050Sample &sample) {
+  sample.ax = (int16_t)(buf[0] << 8 | buf[1]);
+  sample.ay = (int16_t)(buf[2] << 8 | buf[3]);
+  sample.az = (int16_t)(buf[4] << 8 | buf[5]);
+  sample.temp = (int16_t)(buf[6] << 8 | buf[7]);
+  sample.gx = (int16_t)(buf[8] << 8 | buf[9]);
+  sample.gy = (int16_t)(buf[10] << 8 | buf[11]);
+  sample.gz = (int16_t)(buf[12] << 8 | buf[13]);
+}
+
+// Die temperature in deg C
+inline float mpu6050Temperature(int16_t raw) {
+  return (raw / 340.0f) + 36.53f;
+}
+
+template <class WireType>
+class MPU6050Bus {
+  public:
+    MPU6050Bus(WireType &wire, uint8_t address = 0x68) : wire(wire), addr(address) {}
+
+    uint8_t address() const { return addr; }
+
+    // Burst read starting at reg
+    bool readRegisters(uint8_t reg, uint8_t* buf, size_t len) {
+      wire.beginTransmission(addr);
+      wire.write(reg);
+      wire.endTransmission(false);
+      wire.requestFrom((uint8_t)addr, (uint8_t)len, (uint8_t)true);
+
+      if (wire.available() < (int)len) return false;
+      for (size_t i = 0; i < len; i++) {
+        buf[i] = wire.read();
+      }
+      return true;
+    }
+
+    void writeRegister(uint8_t reg, uint8_t value) {
+      wire.beginTransmission(addr);
+      wire.write(reg);
+      wire.write(value);
+      wire.endTransmission(true);
+    }
+
+    uint8_t whoAmI() {
+      uint8_t value = 0;
+      readRegisters(MPU6050_REG_WHO_AM_I, &value, 1);
+      return value;
+    }
+
+    bool readSample(MPU6050Sample &sample) {
+      uint8_t buf[MPU6050_SAMPLE_BYTES];
+      if (!readRegisters(MPU6050_REG_ACCEL_XOUT_H, buf, MPU6050_SAMPLE_BYTES)) return false;
+      parseMPU6050Sample(buf, sample);
+      return true;
+    }
+
+    // FIFO with all sensors (14 bytes per sample) and DATA_RDY + overflow interrupts
+    void configureFifo(uint8_t sampleRateDiv) {
+      writeRegister(MPU6050_REG_SMPLRT_DIV, sampleRateDiv);
+      writeRegister(MPU6050_REG_FIFO_EN, 0xF8);      // TEMP + XG + YG + ZG + ACCEL
+      writeRegister(MPU6050_REG_INT_PIN_CFG, 0x00);  // Active high, 50 us pulse
+      writeRegister(MPU6050_REG_INT_ENABLE, 0x11);   // FIFO_OFLOW + DATA_RDY
+      resetFifo();
+    }
+
+    void resetFifo() {
+      writeRegister(MPU6050_REG_USER_CTRL, 0x04);    // FIFO_RESET
+      delay(1);
+      writeRegister(MPU6050_REG_USER_CTRL, 0x40);    // FIFO_EN
+    }
+
+    // Reading INT_STATUS clears the interrupt flags
+    bool readInterruptStatus(uint8_t &status) {
+      return readRegisters(MPU6050_REG_INT_STATUS, &status, 1);
+    }
+
+    bool readFifoCount(uint16_t &count) {
+      uint8_t buf[2];
+      if (!readRegisters(MPU6050_REG_FIFO_COUNT_H, buf, 2)) return false;
+      count = (uint16_t)(buf[0] << 8 | buf[1]);
+      return true;
+    }
+
+    bool readFifo(uint8_t* buf, size_t len) {
+      return readRegisters(MPU6050_REG_FIFO_R_W, buf, len);
+    }
+
+    // Reads every complete sample in the FIFO in bursts of up to burstSamples
+    // (buf holds burstSamples * MPU6050_SAMPLE_BYTES). onSample(sample, age) is
+    // called oldest first; age is the number of sample periods before the
+    // newest one. Returns the samples read, or -1 after an overflow (the FIFO
+    // is reset, its contents are misaligned).
+    template <class Handler>
+    int drainFifo(uint8_t* buf, uint16_t burstSamples, Handler onSample) {
+      uint8_t status;
+      if (!readInterruptStatus(status)) return 0;
+      if (status & MPU6050_INT_FIFO_OFLOW) {
+        resetFifo();
+        return -1;
+      }
+
+      uint16_t count;
+      if (!readFifoCount(count)) return 0;
+      uint16_t samples = count / MPU6050_SAMPLE_BYTES;
+      int read = 0;
+
+      while (samples > 0) {
+        uint16_t burst = samples < burstSamples ? samples : burstSamples;
+        if (!readFifo(buf, burst * MPU6050_SAMPLE_BYTES)) break;
+
+        for (uint16_t i = 0; i < burst; i++) {
+          MPU6050Sample sample;
+          parseMPU6050Sample(buf + i * MPU6050_SAMPLE_BYTES, sample);
+          onSample(sample, (uint16_t)(samples - 1 - i));
+        }
+        read += burst;
+        samples -= burst;
+      }
+      return read;
+    }
+
+  private:
+    WireType &wire;
+    uint8_t addr;
+};
+
+#endif
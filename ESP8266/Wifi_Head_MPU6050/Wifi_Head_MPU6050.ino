@@ -4,8 +4,17 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <WebSocketsServer.h>
+#include "FixedPointFilter.h"
+#include "MPU6050Bus.h"
+#include "StationaryDetector.h"
+
+// Фильтр ориентации: 1 - целочисленный Q16.16 (CORDIC atan2), 0 - float
+#define USE_FIXED_POINT_FILTER 1
+#define MPU_ADDR 0x68
 
 Adafruit_MPU6050 mpu;
+// Сырые регистры MPU6050 читаются через mpuBus (см. MPU6050Bus.h)
+MPU6050Bus<TwoWire> mpuBus(Wire, MPU_ADDR);
 
 // WiFi credentials
 const char* ssid = "ESP_APP_VR";
@@ -23,7 +32,25 @@ float pitch = 0, roll = 0, yaw = 0;
 float lastSentPitch = 0, lastSentRoll = 0, lastSentYaw = 0;
 float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
-unsigned long lastTime = 0;
+
+// Период опроса датчика (без delay() в loop)
+#if USE_FIXED_POINT_FILTER
+const unsigned long SAMPLE_INTERVAL_US = 2000;   // 500 Гц
+FixedPointFilter fixedFilter(131, 8192);        // ±250°/с, ±4g
+int32_t rawGyroOffsetX = 0, rawGyroOffsetY = 0, rawGyroOffsetZ = 0;
+// Детектор неподвижности в LSB: шум 0.6°/с, вращение 1.1°/с, ускорение 0.02g
+StationaryDetector<32> stationaryDetector(80, 150, 164);
+float biasFractionX = 0, biasFractionY = 0, biasFractionZ = 0;  // Дробная часть подстройки, LSB
+#else
+const unsigned long SAMPLE_INTERVAL_US = 10000;  // 100 Гц
+StationaryDetector<32> stationaryDetector(0.01, 0.02, 0.2);   // рад/с, рад/с, м/с²
+#endif
+unsigned long lastSampleMicros = 0;
+
+// Детектор и подстройка смещения работают на 100 Гц в обоих режимах
+const uint8_t STATIONARY_DECIMATION = 10000 / SAMPLE_INTERVAL_US;
+const float BIAS_TRACKING_RATE = 0.002;   // ~5 с постоянная времени при 100 Гц
+uint8_t stationaryDivider = 0;
 
 // Относительный ноль
 float zeroPitch = 0, zeroRoll = 0, zeroYaw = 0;
@@ -135,8 +162,52 @@ double getRelativeYaw() {
   return accumulatedYaw - zeroYaw;
 }
 
+// Окно неподвижности; пока устройство неподвижно, смещение гироскопа
+// подстраивается в фоне (гироскоп передается уже без смещения)
+void updateStationary(float gx, float gy, float gz, float ax, float ay, float az) {
+  if (++stationaryDivider < STATIONARY_DECIMATION) return;
+  stationaryDivider = 0;
+  
+  if (!stationaryDetector.update(gx, gy, gz, ax, ay, az)) return;
+  
+#if USE_FIXED_POINT_FILTER
+  trackGyroBias(biasFractionX, biasFractionY, biasFractionZ, gx, gy, gz, BIAS_TRACKING_RATE);
+  int32_t stepX = (int32_t)biasFractionX;
+  int32_t stepY = (int32_t)biasFractionY;
+  int32_t stepZ = (int32_t)biasFractionZ;
+  rawGyroOffsetX += stepX; biasFractionX -= stepX;
+  rawGyroOffsetY += stepY; biasFractionY -= stepY;
+  rawGyroOffsetZ += stepZ; biasFractionZ -= stepZ;
+#else
+  trackGyroBias(gyroOffsetX, gyroOffsetY, gyroOffsetZ, gx, gy, gz, BIAS_TRACKING_RATE);
+#endif
+}
+
 void calibrateSensor() {
   Serial.println("Calibrating...");
+  stationaryDetector.reset();
+#if USE_FIXED_POINT_FILTER
+  int32_t sumX = 0, sumY = 0, sumZ = 0;
+  int samples = 0;
+  
+  for (int i = 0; i < 500; i++) {
+    MPU6050Sample sample;
+    if (mpuBus.readSample(sample)) {
+      sumX += sample.gx;
+      sumY += sample.gy;
+      sumZ += sample.gz;
+      samples++;
+    }
+    delay(2);
+  }
+  
+  if (samples > 0) {
+    rawGyroOffsetX = sumX / samples;
+    rawGyroOffsetY = sumY / samples;
+    rawGyroOffsetZ = sumZ / samples;
+  }
+  fixedFilter.reset();
+#else
   float sumX = 0, sumY = 0, sumZ = 0;
   
   for (int i = 0; i < 500; i++) {
@@ -151,6 +222,7 @@ void calibrateSensor() {
   gyroOffsetX = sumX / 500;
   gyroOffsetY = sumY / 500;
   gyroOffsetZ = sumZ / 500;
+#endif
   calibrated = true;
   
   Serial.println("Calibration complete");
@@ -220,6 +292,9 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
         }
         else if (message == "RESET_ANGLES") {
           pitch = 0; roll = 0; yaw = 0;
+#if USE_FIXED_POINT_FILTER
+          fixedFilter.pitch = 0; fixedFilter.roll = 0; fixedFilter.yaw = 0;
+#endif
           lastSentPitch = 0; lastSentRoll = 0; lastSentYaw = 0;
           resetZeroPoint();
           String resetMessage = "ANGLES_RESET";
@@ -265,7 +340,8 @@ void handleAPIStatus() {
   json += "\"accPitch\":" + String(accumulatedPitch, 2) + ",";
   json += "\"accRoll\":" + String(accumulatedRoll, 2) + ",";
   json += "\"accYaw\":" + String(accumulatedYaw, 2) + ",";
-  json += "\"zeroSet\":" + String(zeroSet ? "true" : "false");
+  json += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
+  json += "\"stationary\":" + String(stationaryDetector.isStationary() ? "true" : "false");
   json += "}";
   server.send(200, "application/json", json);
 }
@@ -650,17 +726,37 @@ void loop() {
   
   if (!calibrated) return;
   
+  // Опрос датчика с фиксированным периодом
+  unsigned long nowMicros = micros();
+  if (lastSampleMicros != 0 && nowMicros - lastSampleMicros < SAMPLE_INTERVAL_US) return;
+  unsigned long dtMicros = (lastSampleMicros == 0) ? SAMPLE_INTERVAL_US : nowMicros - lastSampleMicros;
+  lastSampleMicros = nowMicros;
+  unsigned long currentTime = millis();
+  
+#if USE_FIXED_POINT_FILTER
+  MPU6050Sample sample;
+  if (!mpuBus.readSample(sample)) return;
+  
+  int32_t gx = sample.gx - rawGyroOffsetX;
+  int32_t gy = sample.gy - rawGyroOffsetY;
+  int32_t gz = sample.gz - rawGyroOffsetZ;
+  updateStationary(gx, gy, gz, sample.ax, sample.ay, sample.az);
+  
+  fixedFilter.update(sample.ax, sample.ay, sample.az, gx, gy, gz, dtMicros);
+  
+  pitch = fixedToFloat(fixedFilter.pitch);
+  roll = fixedToFloat(fixedFilter.roll);
+  yaw = fixedToFloat(fixedFilter.yaw);
+#else
   sensors_event_t a, g, temp;
   mpu.getEvent(&a, &g, &temp);
   
-  unsigned long currentTime = millis();
-  float deltaTime = (currentTime - lastTime) / 1000.0;
-  if (lastTime == 0) deltaTime = 0.01;
-  lastTime = currentTime;
+  float deltaTime = dtMicros / 1000000.0;
   
   float gyroX = g.gyro.x - gyroOffsetX;
   float gyroY = g.gyro.y - gyroOffsetY;
   float gyroZ = g.gyro.z - gyroOffsetZ;
+  updateStationary(gyroX, gyroY, gyroZ, a.acceleration.x, a.acceleration.y, a.acceleration.z);
   
   float accelPitch = atan2(a.acceleration.y, a.acceleration.z) * 180.0 / PI;
   float accelRoll = atan2(-a.acceleration.x, sqrt(a.acceleration.y * a.acceleration.y + a.acceleration.z * a.acceleration.z)) * 180.0 / PI;
@@ -672,6 +768,7 @@ void loop() {
   float alpha = 0.96;
   pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
   roll = alpha * roll + (1.0 - alpha) * accelRoll;
+#endif
   
   if (clientConnected && (currentTime - lastDataSend >= SEND_INTERVAL)) {
     if (dataChanged() || lastDataSend == 0) {
@@ -679,6 +776,4 @@ void loop() {
       lastDataSend = currentTime;
     }
   }
-  
-  delay(10);
 }
@@ -31,7 +31,8 @@ const float smoothingFactor = 0.3;
 float pitch = 0, roll = 0, yaw = 0;
 float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
-unsigned long lastTime = 0;
+unsigned long lastTime = 0;  // micros() of the last sample, also stamps the frames
+uint32_t frameSequence = 0;  // JSON frame number (latency / loss measurement)
 unsigned long calibrationStart = 0;
 const unsigned long calibrationTime = 3000;
 
@@ -738,7 +739,9 @@ void sendOrientationData(unsigned long currentTime) {
   json += "\"zeroYaw\":" + String(zeroYaw, 2) + ",";
   json += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
   json += "\"idle\":" + String(isDeviceIdle ? "true" : "false") + ",";
-  json += "\"timestamp\":" + String(currentTime);
+  json += "\"timestamp\":" + String(currentTime) + ",";
+  json += "\"seq\":" + String(++frameSequence) + ",";
+  json += "\"sampleUs\":" + String(lastTime);
   json += "}";
   
   Serial.println(json);
@@ -49,9 +49,12 @@ int yawDirection = 0;
 float prevPitch = 0, prevRoll = 0, prevYaw = 0;
 const float MOVEMENT_THRESHOLD = 0.5;
 
-// Время для интеграции
+// Время для интеграции (micros() последнего отсчета, им же помечаются кадры)
 unsigned long lastTime = 0;
 
+// Номер кадра JSON для измерения задержки и потерь
+uint32_t frameSequence = 0;
+
 // Адрес I2C
 uint8_t current_i2c_address = 0x68;
 
@@ -308,7 +311,13 @@ void outputVRData() {
   Serial.print(rollDirection);
   Serial.print(",\"yaw\":");
   Serial.print(yawDirection);
-  Serial.print("}");
+  Serial.print("},");
+  
+  // Метки кадра: номер и время отсчета
+  Serial.print("\"seq\":");
+  Serial.print(++frameSequence);
+  Serial.print(",\"sampleUs\":");
+  Serial.print(lastTime);
   
   Serial.println("}");
 }
@@ -6,30 +6,60 @@
 
 #include <Wire.h>
 #include <Adafruit_MPU6050.h>
+#include <EEPROM.h>
+#include "TelemetryFormat.h"
+#include "CalibrationStore.h"
+#include "SmoothedOrientation.h"
+#include "SampleRing.h"
+
+#define MPU_ADDR 0x68
+
+// Хранение калибровки в EEPROM (быстрый старт без калибровки)
+#define CALIBRATION_EEPROM_SIZE 64
+#define CALIBRATION_EEPROM_ADDR 0
+
+// Опрос датчика с фиксированным периодом, отправка - из кольца усредненных отсчетов
+#define SAMPLE_INTERVAL_US 10000        // 100 Гц, под эту частоту настроены фильтры
+#define OUTPUT_DECIMATION 2             // 100 Гц -> 50 Гц в кольцо
+#define SAMPLE_RING_SIZE 16
 
 // MPU6050 датчик подключен напрямую к I2C
 Adafruit_MPU6050 mpu;
 bool mpuConnected = false;
 
-// Переменные для данных сенсора
-float pitch = 0, roll = 0, yaw = 0;
-float smoothedPitch = 0, smoothedRoll = 0, smoothedYaw = 0;
-const float smoothingFactor = 0.3;
-
-// Переменные комплементарного фильтра
-float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
-bool calibrated = false;
+// Калибровка, смещения, подстройка в покое, кватернионный фильтр и сглаживание
+// (см. SmoothedOrientation.h); тот же код гоняет Benchmark/fusion_replay на ПК
+SmoothedOrientation orientation;
 unsigned long lastTime = 0;
 unsigned long calibrationStart = 0;
-const unsigned long calibrationTime = 3000;
+
+// Метки кадра для измерения задержки: номер кадра и время отсчета (micros())
+uint32_t frameSequence = 0;
+unsigned long lastSampleMicros = 0;   // Время отсчета в отправляемом кадре
+unsigned long sampleMicros = 0;       // Время последнего опроса датчика
+
+// Опрос пишет усредненные углы в кольцо, отправка забирает последний
+SampleRing<OrientationSample, SAMPLE_RING_SIZE> orientationRing;
+OrientationDecimator outputDecimator(OUTPUT_DECIMATION);
+float sentPitch = 0, sentRoll = 0, sentYaw = 0;
+
+// Кадр JSON уходит в Serial порциями по availableForWrite(), loop() не ждет UART
+const char* serialFrame = NULL;
+size_t serialFrameLength = 0;
+size_t serialFrameSent = 0;
+unsigned long skippedFrames = 0;
+
+// Сохраненная калибровка и ее уточнение в фоне после быстрого старта
+CalibrationRecord calibrationRecord;
+bool warmStarted = false;
 
 // Точка нуля (референсная позиция)
 float zeroPitch = 0, zeroRoll = 0, zeroYaw = 0;
 bool zeroSet = false;
 
-// Автокалибровка
-bool autoCalibrationEnabled = true;
-const unsigned long AUTO_CALIBRATION_INTERVAL = 60000;
+// Автокалибровка: смещения подстраиваются в фоне, пока датчик неподвижен
+// (orientation.autoCalibration), здесь только отчет о ней
+const unsigned long AUTO_CALIBRATION_INTERVAL = 60000;  // Период отчета об автокалибровке
 unsigned long lastAutoCalibration = 0;
 
 // Управление отправкой данных
@@ -72,7 +102,15 @@ void setup() {
     Serial.println("   SDA -> 21, SCL -> 22 (ESP32)");
   }
   
-  // Начинаем калибровку
+#if defined(ESP8266) || defined(ESP32)
+  EEPROM.begin(CALIBRATION_EEPROM_SIZE);
+#endif
+  
+  // Быстрый старт по сохраненной калибровке, иначе полная калибровка
+  if (mpuConnected && loadStoredCalibration()) {
+    return;
+  }
+  orientation.startCalibration();
   calibrationStart = millis();
   Serial.println("🔧 Калибруем гироскоп... Держите датчик неподвижно 3 секунды!");
 }
@@ -91,212 +129,239 @@ void loop() {
     }
   }
   
-  // Обрабатываем данные сенсора
-  if (mpuConnected) {
+  // Опрашиваем датчик с фиксированным периодом (без delay())
+  unsigned long nowMicros = micros();
+  if (mpuConnected && (sampleMicros == 0 || nowMicros - sampleMicros >= SAMPLE_INTERVAL_US)) {
+    sampleMicros = nowMicros;
     processSensorData();
   }
   
   // Проверяем автокалибровку
   checkAutoCalibration();
   
-  // Отправляем данные через Serial
+  // Дописываем начатый кадр и отправляем новый
+  serviceSerialFrame();
   unsigned long currentTime = millis();
   if (currentTime - lastDataSend >= DATA_SEND_INTERVAL) {
     sendSensorData(currentTime);
     lastDataSend = currentTime;
   }
-  
-  delay(10);
+}
+
+// Пишет в Serial столько байт кадра, сколько помещается в буфер без ожидания
+void serviceSerialFrame() {
+  if (serialFrame == NULL) return;
+  
+  int room = Serial.availableForWrite();
+  if (room <= 0) return;
+  
+  size_t count = serialFrameLength - serialFrameSent;
+  if (count > (size_t)room) count = room;
+  Serial.write((const uint8_t*)serialFrame + serialFrameSent, count);
+  serialFrameSent += count;
+  if (serialFrameSent >= serialFrameLength) {
+    serialFrame = NULL;
+  }
+}
+
+// Дописывает кадр целиком - перед любым другим выводом в Serial
+void finishSerialFrame() {
+  while (serialFrame != NULL) {
+    serviceSerialFrame();
+    yield();
+  }
 }
 
 void processSensorData() {
-  if (!calibrated) {
+  if (!orientation.isCalibrated()) {
     calibrateGyro();
     return;
   }
   
   sensors_event_t a, g, temp;
   if (!mpu.getEvent(&a, &g, &temp)) {
+    finishSerialFrame();
     Serial.println("Error reading MPU6050 data");
     return;
   }
   
-  unsigned long currentTime = millis();
-  float deltaTime = (currentTime - lastTime) / 1000.0;
+  float deltaTime = (sampleMicros - lastTime) / 1000000.0;
   if (lastTime == 0) {
-    deltaTime = 0.01;
+    deltaTime = SAMPLE_INTERVAL_US / 1000000.0;
+  }
+  lastTime = sampleMicros;
+  
+  // После быстрого старта смещения уточняются, пока датчик неподвижен
+  if (orientation.update(a, g, deltaTime)) {
+    storeCalibration(temp.temperature, orientation.refiner.samples());
+    
+    String statusMsg = "{\"type\":\"status\",\"message\":\"Calibration refined\"}";
+    Serial.println(statusMsg);
+  }
+  
+  OrientationSample out;
+  if (outputDecimator.add(sampleMicros, orientation.smoothedPitch, orientation.smoothedRoll,
+                          orientation.smoothedYaw, out)) {
+    orientationRing.push(out);
   }
-  lastTime = currentTime;
-  
-  // Компенсируем смещение гироскопа
-  float gyroX = g.gyro.x - gyroOffsetX;
-  float gyroY = g.gyro.y - gyroOffsetY;
-  float gyroZ = g.gyro.z - gyroOffsetZ;
-  
-  // Вычисляем углы из акселерометра
-  float accelPitch = atan2(a.acceleration.y, a.acceleration.z) * 180.0 / PI;
-  float accelRoll = atan2(-a.acceleration.x, sqrt(a.acceleration.y * a.acceleration.y + a.acceleration.z * a.acceleration.z)) * 180.0 / PI;
-  
-  // Интеграция гироскопа
-  pitch += gyroX * deltaTime * 180.0 / PI;
-  roll += gyroY * deltaTime * 180.0 / PI;
-  yaw += gyroZ * deltaTime * 180.0 / PI;
-  
-  // Комплементарный фильтр для pitch и roll
-  float alpha = 0.96;
-  pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
-  roll = alpha * roll + (1.0 - alpha) * accelRoll;
-  
-  // Сглаживание для отображения
-  smoothedPitch = smoothedPitch * (1 - smoothingFactor) + pitch * smoothingFactor;
-  smoothedRoll = smoothedRoll * (1 - smoothingFactor) + roll * smoothingFactor;
-  smoothedYaw = smoothedYaw * (1 - smoothingFactor) + yaw * smoothingFactor;
 }
 
 void calibrateGyro() {
-  if (calibrated) return;
-  
   sensors_event_t a, g, temp;
   mpu.getEvent(&a, &g, &temp);
   
-  static int sampleCount = 0;
-  static float sumX = 0, sumY = 0, sumZ = 0;
-  
-  if (millis() - calibrationStart < calibrationTime) {
-    sumX += g.gyro.x;
-    sumY += g.gyro.y;
-    sumZ += g.gyro.z;
-    sampleCount++;
-    
-    if (sampleCount % 50 == 0) {
-      int progress = (millis() - calibrationStart) * 100 / calibrationTime;
+  if (!orientation.calibrationStep(g, temp, millis() - calibrationStart)) {
+    int sampleCount = orientation.calibrationSamples();
+    if (sampleCount > 0 && sampleCount % 50 == 0 && millis() - calibrationStart < SMOOTHED_CALIBRATION_TIME_MS) {
+      int progress = (millis() - calibrationStart) * 100 / SMOOTHED_CALIBRATION_TIME_MS;
       Serial.print("Calibration progress: ");
       Serial.print(progress);
       Serial.println("%");
     }
-  } else {
-    gyroOffsetX = sumX / sampleCount;
-    gyroOffsetY = sumY / sampleCount;
-    gyroOffsetZ = sumZ / sampleCount;
-    calibrated = true;
-    
-    Serial.println("✅ Калибровка гироскопа завершена!");
-    Serial.print("Offsets - X:");
-    Serial.print(gyroOffsetX, 6);
-    Serial.print(", Y:");
-    Serial.print(gyroOffsetY, 6);
-    Serial.print(", Z:");
-    Serial.println(gyroOffsetZ, 6);
-    Serial.print("Обработано сэмплов: ");
-    Serial.println(sampleCount);
-    
-    // Отправляем статус калибровки
-    String statusMsg = "{\"type\":\"status\",\"message\":\"Calibration complete\"}";
-    Serial.println(statusMsg);
+    return;
   }
+  
+  Serial.println("✅ Калибровка гироскопа завершена!");
+  Serial.print("Offsets - X:");
+  Serial.print(orientation.gyroOffsetX, 6);
+  Serial.print(", Y:");
+  Serial.print(orientation.gyroOffsetY, 6);
+  Serial.print(", Z:");
+  Serial.println(orientation.gyroOffsetZ, 6);
+  Serial.print("Обработано сэмплов: ");
+  Serial.println(orientation.calibrationSamples());
+  
+  // Свежая калибровка не требует уточнения, сохраняем ее
+  warmStarted = false;
+  storeCalibration(orientation.calibrationTemperature(), orientation.calibrationSamples());
+  
+  // Отправляем статус калибровки
+  String statusMsg = "{\"type\":\"status\",\"message\":\"Calibration complete\"}";
+  Serial.println(statusMsg);
 }
 
-void checkAutoCalibration() {
-  unsigned long currentTime = millis();
-  
-  if (mpuConnected && autoCalibrationEnabled && calibrated) {
-    if (currentTime - lastAutoCalibration >= AUTO_CALIBRATION_INTERVAL) {
-      // Проверяем, неподвижен ли сенсор для автокалибровки
-      if (isSensorStationary()) {
-        Serial.println("🔄 Автокалибровка...");
-        performAutoCalibration();
-        lastAutoCalibration = currentTime;
-        
-        // Отправляем уведомление
-        String autoCalMsg = "{\"type\":\"autoCalibration\",\"message\":\"Auto-calibration performed\"}";
-        Serial.println(autoCalMsg);
-      }
-    }
-  }
+uint8_t readMPUWhoAmI() {
+  Wire.beginTransmission(MPU_ADDR);
+  Wire.write(0x75);
+  Wire.endTransmission(false);
+  Wire.requestFrom((uint8_t)MPU_ADDR, (uint8_t)1, (uint8_t)true);
+  return Wire.available() ? Wire.read() : 0;
 }
 
-bool isSensorStationary() {
-  // Простая проверка: если значения гироскопа близки к нулю, сенсор вероятно неподвижен
-  sensors_event_t a, g, temp;
-  if (!mpu.getEvent(&a, &g, &temp)) {
-    return false;
-  }
-  
-  float gyroX = abs(g.gyro.x - gyroOffsetX);
-  float gyroY = abs(g.gyro.y - gyroOffsetY);
-  float gyroZ = abs(g.gyro.z - gyroOffsetZ);
-  
-  // Порог для определения неподвижности (можно настраивать)
-  float stationaryThreshold = 0.01;
-  
-  return (gyroX < stationaryThreshold && gyroY < stationaryThreshold && gyroZ < stationaryThreshold);
+// Запись текущих смещений в EEPROM
+void storeCalibration(float temperature, uint32_t samples) {
+  initCalibrationRecord(calibrationRecord, readMPUWhoAmI(), MPU_ADDR, CALIBRATION_GYRO_RAD_S);
+  orientation.storeOffsets(calibrationRecord);
+  calibrationRecord.temperature = temperature;
+  calibrationRecord.sampleCount = samples;
+  saveCalibration(CALIBRATION_EEPROM_ADDR, calibrationRecord);
+  
+  finishSerialFrame();
+  Serial.print("💾 Калибровка сохранена в EEPROM, T=");
+  Serial.println(temperature, 1);
 }
 
-void performAutoCalibration() {
-  // Быстрое обновление калибровки
+// Быстрый старт: смещения из EEPROM, если датчик и температура совпадают
+bool loadStoredCalibration() {
   sensors_event_t a, g, temp;
-  int samples = 20;
-  float sumX = 0, sumY = 0, sumZ = 0;
-  
-  for (int i = 0; i < samples; i++) {
-    mpu.getEvent(&a, &g, &temp);
-    sumX += g.gyro.x;
-    sumY += g.gyro.y;
-    sumZ += g.gyro.z;
-    delay(10);
+  if (!mpu.getEvent(&a, &g, &temp)) return false;
+  
+  if (!loadCalibration(CALIBRATION_EEPROM_ADDR, calibrationRecord, readMPUWhoAmI(), MPU_ADDR,
+                       CALIBRATION_GYRO_RAD_S, temp.temperature)) {
+    return false;
   }
   
-  // Обновляем смещения со сглаживанием
-  float alpha = 0.3; // Коэффициент сглаживания для автокалибровки
-  gyroOffsetX = gyroOffsetX * (1 - alpha) + (sumX / samples) * alpha;
-  gyroOffsetY = gyroOffsetY * (1 - alpha) + (sumY / samples) * alpha;
-  gyroOffsetZ = gyroOffsetZ * (1 - alpha) + (sumZ / samples) * alpha;
+  orientation.restore(calibrationRecord);
+  warmStarted = true;
   
-  Serial.print("🔄 Автокалибровка выполнена. Новые смещения - X:");
-  Serial.print(gyroOffsetX, 6);
+  Serial.println("✅ Калибровка загружена из EEPROM");
+  Serial.print("Offsets - X:");
+  Serial.print(orientation.gyroOffsetX, 6);
   Serial.print(", Y:");
-  Serial.print(gyroOffsetY, 6);
+  Serial.print(orientation.gyroOffsetY, 6);
   Serial.print(", Z:");
-  Serial.println(gyroOffsetZ, 6);
+  Serial.println(orientation.gyroOffsetZ, 6);
+  return true;
+}
+
+// Отчет о фоновой подстройке смещений (сама подстройка идет в processSensorData)
+void checkAutoCalibration() {
+  unsigned long currentTime = millis();
+  
+  if (mpuConnected && orientation.autoCalibration && orientation.isCalibrated()) {
+    if (currentTime - lastAutoCalibration >= AUTO_CALIBRATION_INTERVAL && orientation.biasTrackedSamples > 0) {
+      finishSerialFrame();
+      Serial.print("🔄 Автокалибровка выполнена. Новые смещения - X:");
+      Serial.print(orientation.gyroOffsetX, 6);
+      Serial.print(", Y:");
+      Serial.print(orientation.gyroOffsetY, 6);
+      Serial.print(", Z:");
+      Serial.println(orientation.gyroOffsetZ, 6);
+      lastAutoCalibration = currentTime;
+      orientation.biasTrackedSamples = 0;
+      
+      // Отправляем уведомление
+      String autoCalMsg = "{\"type\":\"autoCalibration\",\"message\":\"Auto-calibration performed\"}";
+      Serial.println(autoCalMsg);
+    }
+  }
 }
 
 void sendSensorData(unsigned long currentTime) {
-  if (!mpuConnected || !calibrated) return;
+  if (!mpuConnected || !orientation.isCalibrated()) return;
+  
+  // Предыдущий кадр еще в UART - этот пропускаем, опрос датчика не ждет
+  if (serialFrame != NULL) {
+    skippedFrames++;
+    return;
+  }
+  
+  // Последний усредненный отсчет из кольца
+  OrientationSample sample;
+  if (orientationRing.popLatest(sample)) {
+    sentPitch = sample.pitch;
+    sentRoll = sample.roll;
+    sentYaw = sample.yaw;
+    lastSampleMicros = sample.timestampUs;
+  }
   
   // Вычисляем относительные углы
-  float relPitch = calculateRelativeAngle(smoothedPitch, zeroPitch);
-  float relRoll = calculateRelativeAngle(smoothedRoll, zeroRoll);
-  float relYaw = calculateRelativeAngle(smoothedYaw, zeroYaw);
-  
-  // Формируем JSON данные
-  String json = "{";
-  json += "\"type\":\"sensorData\",";
-  json += "\"pitch\":" + String(relPitch, 2) + ",";
-  json += "\"roll\":" + String(relRoll, 2) + ",";
-  json += "\"yaw\":" + String(relYaw, 2) + ",";
-  json += "\"absPitch\":" + String(smoothedPitch, 2) + ",";
-  json += "\"absRoll\":" + String(smoothedRoll, 2) + ",";
-  json += "\"absYaw\":" + String(smoothedYaw, 2) + ",";
-  json += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
-  json += "\"calibrated\":" + String(calibrated ? "true" : "false") + ",";
-  json += "\"autoCalibration\":" + String(autoCalibrationEnabled ? "true" : "false") + ",";
-  json += "\"timestamp\":" + String(currentTime);
-  json += "}";
-  
-  // Отправляем через Serial
-  Serial.println(json);
-  
-  // Отладочный вывод каждые 2 секунды
+  float relPitch = calculateRelativeAngle(sentPitch, zeroPitch);
+  float relRoll = calculateRelativeAngle(sentRoll, zeroRoll);
+  float relYaw = calculateRelativeAngle(sentYaw, zeroYaw);
+  
+  // Формируем JSON данные в статическом буфере (без String)
+  static const TelemetryField SENSOR_FIELDS[] = {
+    {"{\"type\":\"sensorData\",\"pitch\":", 2}, {",\"roll\":", 2}, {",\"yaw\":", 2},
+    {",\"absPitch\":", 2}, {",\"absRoll\":", 2}, {",\"absYaw\":", 2}
+  };
+  const double values[] = {
+    relPitch, relRoll, relYaw,
+    sentPitch, sentRoll, sentYaw
+  };
+  
+  static TelemetryMessage<256> json;
+  json.clear();
+  json.fields(SENSOR_FIELDS, values)
+      .text(",\"zeroSet\":").boolean(zeroSet)
+      .text(",\"calibrated\":").boolean(orientation.isCalibrated())
+      .text(",\"autoCalibration\":").boolean(orientation.autoCalibration)
+      .text(",\"timestamp\":").number(currentTime)
+      .text(",\"seq\":").number(++frameSequence)
+      .text(",\"sampleUs\":").number(lastSampleMicros)
+      .text("}\r\n");
+  
+  // Отладочный вывод каждые 2 секунды (до кадра, пока UART свободен)
   static unsigned long lastDebug = 0;
   if (currentTime - lastDebug >= 2000) {
     lastDebug = currentTime;
     
     Serial.print("📤 Данные: P:");
-    Serial.print(smoothedPitch, 1);
+    Serial.print(sentPitch, 1);
     Serial.print("° R:");
-    Serial.print(smoothedRoll, 1);
+    Serial.print(sentRoll, 1);
     Serial.print("° Y:");
-    Serial.print(smoothedYaw, 1);
+    Serial.print(sentYaw, 1);
     Serial.print("° | REL P:");
     Serial.print(relPitch, 1);
     Serial.print("° R:");
@@ -304,11 +369,22 @@ void sendSensorData(unsigned long currentTime) {
     Serial.print("° Y:");
     Serial.print(relYaw, 1);
     Serial.print("° | AutoCal:");
-    Serial.println(autoCalibrationEnabled ? "ON" : "OFF");
+    Serial.print(orientation.autoCalibration ? "ON" : "OFF");
+    Serial.print(" | Skipped:");
+    Serial.print(skippedFrames);
+    Serial.print(" RingDrops:");
+    Serial.println(orientationRing.dropped());
   }
+  
+  // Отправляем через Serial без ожидания, остаток допишет serviceSerialFrame()
+  serialFrame = json.c_str();
+  serialFrameLength = json.length();
+  serialFrameSent = 0;
+  serviceSerialFrame();
 }
 
 void handleCommand(String command) {
+  finishSerialFrame();
   Serial.print("📨 Получена команда: ");
   Serial.println(command);
   
@@ -368,9 +444,12 @@ void handleCommand(String command) {
     // Отправляем полный статус
     String status = "{\"type\":\"fullStatus\",";
     status += "\"mpuConnected\":" + String(mpuConnected ? "true" : "false") + ",";
-    status += "\"calibrated\":" + String(calibrated ? "true" : "false") + ",";
+    status += "\"calibrated\":" + String(orientation.isCalibrated() ? "true" : "false") + ",";
     status += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
-    status += "\"autoCalibration\":" + String(autoCalibrationEnabled ? "true" : "false") + ",";
+    status += "\"autoCalibration\":" + String(orientation.autoCalibration ? "true" : "false") + ",";
+    status += "\"calibrationSource\":\"" + String(warmStarted ? "stored" : "fresh") + "\",";
+    status += "\"stationary\":" + String(orientation.stationaryDetector.isStationary() ? "true" : "false") + ",";
+    status += "\"calibrationRefined\":" + String(orientation.refiner.isDone() ? "true" : "false") + ",";
     status += "\"timestamp\":" + String(millis());
     status += "}";
     Serial.println(status);
@@ -386,9 +465,9 @@ float calculateRelativeAngle(float absoluteAngle, float zeroAngle) {
 }
 
 void setZeroPoint() {
-  zeroPitch = smoothedPitch;
-  zeroRoll = smoothedRoll;
-  zeroYaw = smoothedYaw;
+  zeroPitch = orientation.smoothedPitch;
+  zeroRoll = orientation.smoothedRoll;
+  zeroYaw = orientation.smoothedYaw;
   zeroSet = true;
   
   Serial.print("💾 Точка нуля установлена - Pitch:");
@@ -410,22 +489,20 @@ void resetZeroPoint() {
 }
 
 void recalibrate() {
-  calibrated = false;
-  pitch = roll = yaw = 0;
+  orientation.startCalibration();
   calibrationStart = millis();
   
   Serial.println("🔄 Перекалибровка начата");
 }
 
 void resetYaw() {
-  yaw = 0;
-  smoothedYaw = 0;
+  orientation.resetYaw();
   
   Serial.println("🔄 Yaw сброшен");
 }
 
 void setAutoCalibration(bool enable) {
-  autoCalibrationEnabled = enable;
+  orientation.autoCalibration = enable;
   if (enable) {
     lastAutoCalibration = millis(); // Сбрасываем таймер при включении
   }
@@ -0,0 +1,142 @@
+/*
+  Lock-free sample ring between the sampling and transport stages
+  Fusion runs at a fixed rate in the producer; the transport drains
+  the ring whenever it gets to it, so a slow notify/broadcast never
+  delays integration.
+
+  SampleRing<T, N> - single producer / single consumer, N power of two.
+    The producer only writes head, the consumer only writes tail, so no
+    lock is needed (one task/core each, or loop() + the same loop()).
+    When the ring is full the new sample is dropped and counted; the
+    producer never waits.
+
+  OrientationDecimator - averages every `factor` fused samples into one
+    ring entry. Angles are averaged as offsets from the first sample of
+    the block, so blocks that cross +-180 do not collapse to 0; the
+    result is wrapped back to +-180. The timestamp is the mean
+    sample time (the averaged pose is that old).
+
+  Usage:
+    SampleRing<OrientationSample, 64> ring;
+    OrientationDecimator decimator(5);          // 1 kHz fusion -> 200 Hz ring
+    // producer
+    OrientationSample out;
+    if (decimator.add(micros(), pitch, roll, yaw, out)) ring.push(out);
+    // consumer
+    OrientationSample sample;
+    while (ring.pop(sample)) { ... }
+*/
+
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <Arduino.h>
+
+struct OrientationSample {
+  uint32_t timestampUs;   // micros() of the (mean) sample time
+  float pitch, roll, yaw; // degrees
+  uint16_t samples;       // fused samples averaged into this entry
+};
+
+template <class T, uint16_t N>
+class SampleRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SampleRing size must be a power of two");
+
+  public:
+    SampleRing() : head(0), tail(0), drops(0) {}
+
+    // Producer side
+    bool push(const T &item) {
+      uint16_t h = head;
+      if ((uint16_t)(h - tail) >= N) {
+        drops++;
+        return false;
+      }
+      items[h & (N - 1)] = item;
+      __sync_synchronize();   // item is visible before the new head
+      head = h + 1;
+      return true;
+    }
+
+    // Consumer side
+    bool pop(T &item) {
+      uint16_t t = tail;
+      if (t == head) return false;
+      __sync_synchronize();   // read the item after seeing the head
+      item = items[t & (N - 1)];
+      __sync_synchronize();
+      tail = t + 1;
+      return true;
+    }
+
+    // Drops everything but the newest entry, returns false if empty
+    bool popLatest(T &item) {
+      if (!pop(item)) return false;
+      while (pop(item)) {}
+      return true;
+    }
+
+    uint16_t available() const { return (uint16_t)(head - tail); }
+    uint32_t dropped() const { return drops; }
+
+  private:
+    T items[N];
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    volatile uint32_t drops;
+};
+
+class OrientationDecimator {
+  public:
+    OrientationDecimator(uint8_t factor) : factor(factor ? factor : 1) { reset(); }
+
+    void setFactor(uint8_t value) {
+      factor = value ? value : 1;
+      reset();
+    }
+    uint8_t getFactor() const { return factor; }
+
+    void reset() {
+      count = 0;
+      sumPitch = sumRoll = sumYaw = 0;
+      sumTime = 0;
+    }
+
+    // Returns true and fills out when a block of `factor` samples is complete
+    bool add(uint32_t timestampUs, float pitch, float roll, float yaw, OrientationSample &out) {
+      if (count == 0) {
+        basePitch = pitch;
+        baseRoll = roll;
+        baseYaw = yaw;
+        baseTime = timestampUs;
+      }
+      sumPitch += wrap180(pitch - basePitch);
+      sumRoll += wrap180(roll - baseRoll);
+      sumYaw += wrap180(yaw - baseYaw);
+      sumTime += timestampUs - baseTime;
+      if (++count < factor) return false;
+
+      out.timestampUs = baseTime + sumTime / count;
+      out.pitch = wrap180(basePitch + sumPitch / count);
+      out.roll = wrap180(baseRoll + sumRoll / count);
+      out.yaw = wrap180(baseYaw + sumYaw / count);
+      out.samples = count;
+      reset();
+      return true;
+    }
+
+  private:
+    uint8_t factor;
+    uint8_t count;
+    float basePitch, baseRoll, baseYaw;
+    float sumPitch, sumRoll, sumYaw;
+    uint32_t baseTime, sumTime;
+
+    static float wrap180(float angle) {
+      while (angle > 180.0f) angle -= 360.0f;
+      while (angle < -180.0f) angle += 360.0f;
+      return angle;
+    }
+};
+
+#endif
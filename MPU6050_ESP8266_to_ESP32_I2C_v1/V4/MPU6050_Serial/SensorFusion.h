@@ -0,0 +1,216 @@
+/*
+  Quaternion sensor fusion (Madgwick / Mahony, 6DOF: gyro + accel)
+  Replaces independent per-axis Euler integration: the orientation is kept
+  as a unit quaternion, so there is no gimbal lock near +-90 deg.
+
+  Kernel is selected per build:
+    #define FUSION_ALGORITHM FUSION_MAHONY   // before #include "SensorFusion.h"
+
+  Units: gyro in rad/s, accel in any unit (only direction is used), dt in s.
+  Euler output in degrees, same axes as the sketches:
+    pitch - rotation about X (-180..180)
+    roll  - rotation about Y (-90..90)
+    yaw   - rotation about Z (-180..180)
+
+  All math is single-precision float.
+*/
+
+#ifndef SENSOR_FUSION_H
+#define SENSOR_FUSION_H
+
+#include <math.h>
+
+#define FUSION_MADGWICK 1
+#define FUSION_MAHONY   2
+
+#ifndef FUSION_ALGORITHM
+#define FUSION_ALGORITHM FUSION_MADGWICK
+#endif
+
+#define FUSION_RAD_TO_DEG 57.29577951f
+
+class SensorFusion {
+  public:
+    SensorFusion() { reset(); }
+
+    void reset() {
+      q0 = 1.0f; q1 = 0.0f; q2 = 0.0f; q3 = 0.0f;
+      integralX = 0.0f; integralY = 0.0f; integralZ = 0.0f;
+      initialized = false;
+    }
+
+    // Madgwick: gradient step size
+    void setBeta(float value) { beta = value; }
+    // Mahony: proportional and integral gains
+    void setGains(float kp, float ki) { twoKp = 2.0f * kp; twoKi = 2.0f * ki; }
+
+    void update(float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+      // First sample: start from the accelerometer tilt instead of level
+      if (!initialized) {
+        initFromAccel(ax, ay, az);
+        return;
+      }
+#if FUSION_ALGORITHM == FUSION_MAHONY
+      updateMahony(gx, gy, gz, ax, ay, az, dt);
+#else
+      updateMadgwick(gx, gy, gz, ax, ay, az, dt);
+#endif
+    }
+
+    // Removes the rotation about Z, keeping tilt
+    void resetYaw() {
+      float halfYaw = 0.5f * atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3));
+      float c = cosf(halfYaw);
+      float s = sinf(halfYaw);
+      // q = qz(-yaw) * q
+      float n0 = c * q0 + s * q3;
+      float n1 = c * q1 + s * q2;
+      float n2 = c * q2 - s * q1;
+      float n3 = c * q3 - s * q0;
+      q0 = n0; q1 = n1; q2 = n2; q3 = n3;
+      normalize();
+    }
+
+    void getQuaternion(float &w, float &x, float &y, float &z) const {
+      w = q0; x = q1; y = q2; z = q3;
+    }
+
+    float getPitch() const {
+      return atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2)) * FUSION_RAD_TO_DEG;
+    }
+
+    float getRoll() const {
+      float s = 2.0f * (q0 * q2 - q3 * q1);
+      if (s > 1.0f) s = 1.0f;
+      if (s < -1.0f) s = -1.0f;
+      return asinf(s) * FUSION_RAD_TO_DEG;
+    }
+
+    float getYaw() const {
+      return atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3)) * FUSION_RAD_TO_DEG;
+    }
+
+  private:
+    float q0, q1, q2, q3;
+    float beta = 0.1f;
+    float twoKp = 2.0f * 0.5f;
+    float twoKi = 2.0f * 0.0f;
+    float integralX, integralY, integralZ;
+    bool initialized;
+
+    static float invSqrt(float x) {
+      return 1.0f / sqrtf(x);
+    }
+
+    void normalize() {
+      float norm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+      q0 *= norm; q1 *= norm; q2 *= norm; q3 *= norm;
+    }
+
+    void initFromAccel(float ax, float ay, float az) {
+      if (ax == 0.0f && ay == 0.0f && az == 0.0f) return;
+      float halfPitch = 0.5f * atan2f(ay, az);
+      float halfRoll = 0.5f * atan2f(-ax, sqrtf(ay * ay + az * az));
+      float cp = cosf(halfPitch), sp = sinf(halfPitch);
+      float cr = cosf(halfRoll), sr = sinf(halfRoll);
+      q0 = cp * cr;
+      q1 = sp * cr;
+      q2 = cp * sr;
+      q3 = -sp * sr;
+      initialized = true;
+    }
+
+    void integrateGyro(float gx, float gy, float gz, float dt) {
+      gx *= 0.5f * dt; gy *= 0.5f * dt; gz *= 0.5f * dt;
+      float a = q0, b = q1, c = q2;
+      q0 += (-b * gx - c * gy - q3 * gz);
+      q1 += (a * gx + c * gz - q3 * gy);
+      q2 += (a * gy - b * gz + q3 * gx);
+      q3 += (a * gz + b * gy - c * gx);
+      normalize();
+    }
+
+    void updateMadgwick(float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+      // Rate of change of quaternion from gyroscope
+      float qDot1 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+      float qDot2 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+      float qDot3 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+      float qDot4 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+      // Accelerometer feedback only when the measurement is valid
+      if (!(ax == 0.0f && ay == 0.0f && az == 0.0f)) {
+        float recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+        ax *= recipNorm; ay *= recipNorm; az *= recipNorm;
+
+        float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+        float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+        float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        // Gradient descent corrective step
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+        float sNorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (sNorm > 0.0f) {
+          recipNorm = invSqrt(sNorm);
+          qDot1 -= beta * s0 * recipNorm;
+          qDot2 -= beta * s1 * recipNorm;
+          qDot3 -= beta * s2 * recipNorm;
+          qDot4 -= beta * s3 * recipNorm;
+        }
+      }
+
+      q0 += qDot1 * dt;
+      q1 += qDot2 * dt;
+      q2 += qDot3 * dt;
+      q3 += qDot4 * dt;
+      normalize();
+    }
+
+    void updateMahony(float gx, float gy, float gz, float ax, float ay, float az, float dt) {
+      if (!(ax == 0.0f && ay == 0.0f && az == 0.0f)) {
+        float recipNorm = invSqrt(ax * ax + ay * ay + az * az);
+        ax *= recipNorm; ay *= recipNorm; az *= recipNorm;
+
+        // Estimated direction of gravity
+        float vx = q1 * q3 - q0 * q2;
+        float vy = q0 * q1 + q2 * q3;
+        float vz = q0 * q0 - 0.5f + q3 * q3;
+
+        // Error is cross product between estimated and measured gravity
+        float ex = ay * vz - az * vy;
+        float ey = az * vx - ax * vz;
+        float ez = ax * vy - ay * vx;
+
+        if (twoKi > 0.0f) {
+          integralX += twoKi * ex * dt;
+          integralY += twoKi * ey * dt;
+          integralZ += twoKi * ez * dt;
+          gx += integralX;
+          gy += integralY;
+          gz += integralZ;
+        }
+
+        gx += twoKp * ex;
+        gy += twoKp * ey;
+        gz += twoKp * ez;
+      }
+
+      integrateGyro(gx, gy, gz, dt);
+    }
+};
+
+// Exponential smoothing of an angle in degrees that handles the +-180 wrap
+inline float smoothAngle(float smoothed, float target, float factor) {
+  float delta = target - smoothed;
+  while (delta > 180.0f) delta -= 360.0f;
+  while (delta < -180.0f) delta += 360.0f;
+  smoothed += delta * factor;
+  while (smoothed > 180.0f) smoothed -= 360.0f;
+  while (smoothed < -180.0f) smoothed += 360.0f;
+  return smoothed;
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*
+  Orientation core of MPU6050_Serial, independent of the board
+  What processSensorData() does with one Adafruit_MPU6050 event: the
+  non-blocking startup calibration, post-boot refinement of stored
+  offsets, stationary bias tracking, the quaternion filter and the
+  display smoothing. No Serial or EEPROM here - the sketch persists the
+  offsets when a step reports it, so the same code runs in the host
+  replay (Benchmark/fusion_replay).
+
+  Units as reported by getEvent(): rad/s and m/s^2. Tuned for 100 Hz.
+
+  Usage:
+    SmoothedOrientation orientation;
+    orientation.startCalibration();
+    every 10 ms: mpu.getEvent(&a, &g, &temp);
+      if (!orientation.isCalibrated()) { orientation.calibrationStep(g, temp, elapsedMs); }
+      else if (orientation.update(a, g, dt)) store offsets;
+      orientation.smoothedPitch, orientation.smoothedRoll, orientation.smoothedYaw
+*/
+
+#ifndef SMOOTHED_ORIENTATION_H
+#define SMOOTHED_ORIENTATION_H
+
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+#include "CalibrationStore.h"
+#include "SensorFusion.h"
+#include "StationaryDetector.h"
+
+#define SMOOTHED_CALIBRATION_TIME_MS  3000
+#define SMOOTHED_SMOOTHING_FACTOR     0.3f
+#define SMOOTHED_BIAS_TRACKING_RATE   0.002f   // ~5 s time constant at 100 Hz
+
+class SmoothedOrientation {
+  public:
+    float pitch = 0, roll = 0, yaw = 0;
+    float smoothedPitch = 0, smoothedRoll = 0, smoothedYaw = 0;
+    float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;   // rad/s
+
+    SensorFusion fusion;
+    StationaryDetector<32> stationaryDetector{0.01, 0.02, 0.2};   // rad/s, rad/s, m/s^2
+    CalibrationRefiner refiner{0.035, 100};                      // 2 deg/s, ~1 s
+    bool autoCalibration = true;        // Bias tracking while still
+    unsigned long biasTrackedSamples = 0;
+
+    bool isCalibrated() const { return calibrated; }
+    int calibrationSamples() const { return sampleCount; }
+    float calibrationTemperature() const { return sampleCount ? sumTemp / sampleCount : 0; }
+
+    // Starts (or restarts) the startup calibration; angles and filters go to zero
+    void startCalibration() {
+      calibrated = false;
+      sampleCount = 0;
+      sumX = sumY = sumZ = sumTemp = 0;
+      pitch = roll = yaw = 0;
+      fusion.reset();
+      stationaryDetector.reset();
+    }
+
+    // One calibration sample while elapsedMs < SMOOTHED_CALIBRATION_TIME_MS;
+    // true once, when the offsets are ready (store them)
+    bool calibrationStep(const sensors_event_t &g, const sensors_event_t &temp, unsigned long elapsedMs) {
+      if (calibrated) return false;
+      if (elapsedMs < SMOOTHED_CALIBRATION_TIME_MS) {
+        sumX += g.gyro.x;
+        sumY += g.gyro.y;
+        sumZ += g.gyro.z;
+        sumTemp += temp.temperature;
+        sampleCount++;
+        return false;
+      }
+      if (sampleCount == 0) return false;
+
+      gyroOffsetX = sumX / sampleCount;
+      gyroOffsetY = sumY / sampleCount;
+      gyroOffsetZ = sumZ / sampleCount;
+      calibrated = true;
+      refiner.finish();   // Fresh offsets need no refinement
+      return true;
+    }
+
+    // Warm start from EEPROM; offsets are refined once the device is still
+    void restore(const CalibrationRecord &record) {
+      gyroOffsetX = record.gyroOffset[0];
+      gyroOffsetY = record.gyroOffset[1];
+      gyroOffsetZ = record.gyroOffset[2];
+      fusion.reset();
+      calibrated = true;
+      refiner.reset();
+    }
+
+    void storeOffsets(CalibrationRecord &record) const {
+      record.gyroOffset[0] = gyroOffsetX;
+      record.gyroOffset[1] = gyroOffsetY;
+      record.gyroOffset[2] = gyroOffsetZ;
+    }
+
+    // One sample, deltaTime in seconds; true when the stored offsets were
+    // just refined (persist them)
+    bool update(const sensors_event_t &a, const sensors_event_t &g, float deltaTime) {
+      bool refined = false;
+      if (!refiner.isDone() &&
+          refiner.addSample(g.gyro.x, g.gyro.y, g.gyro.z, gyroOffsetX, gyroOffsetY, gyroOffsetZ)) {
+        gyroOffsetX = refiner.offsetX();
+        gyroOffsetY = refiner.offsetY();
+        gyroOffsetZ = refiner.offsetZ();
+        refined = true;
+      }
+
+      float gyroX = g.gyro.x - gyroOffsetX;
+      float gyroY = g.gyro.y - gyroOffsetY;
+      float gyroZ = g.gyro.z - gyroOffsetZ;
+
+      // Stationary over a window of samples; while still, follow the bias
+      if (stationaryDetector.update(gyroX, gyroY, gyroZ,
+                                    a.acceleration.x, a.acceleration.y, a.acceleration.z) &&
+          autoCalibration) {
+        trackGyroBias(gyroOffsetX, gyroOffsetY, gyroOffsetZ, gyroX, gyroY, gyroZ, SMOOTHED_BIAS_TRACKING_RATE);
+        biasTrackedSamples++;
+      }
+
+      fusion.update(gyroX, gyroY, gyroZ,
+                    a.acceleration.x, a.acceleration.y, a.acceleration.z, deltaTime);
+      pitch = fusion.getPitch();
+      roll = fusion.getRoll();
+      yaw = fusion.getYaw();
+
+      // Display smoothing, aware of the +-180 wrap
+      smoothedPitch = smoothAngle(smoothedPitch, pitch, SMOOTHED_SMOOTHING_FACTOR);
+      smoothedRoll = smoothAngle(smoothedRoll, roll, SMOOTHED_SMOOTHING_FACTOR);
+      smoothedYaw = smoothAngle(smoothedYaw, yaw, SMOOTHED_SMOOTHING_FACTOR);
+      return refined;
+    }
+
+    void resetYaw() {
+      fusion.resetYaw();
+      yaw = 0;
+      smoothedYaw = 0;
+    }
+
+  private:
+    bool calibrated = false;
+    int sampleCount = 0;
+    float sumX = 0, sumY = 0, sumZ = 0, sumTemp = 0;
+};
+
+#endif
@@ -1,14 +1,9 @@
 #include <Wire.h>
 #include <math.h>
+#include "QMC5883L.h"
 
-// Адрес датчика QMC5883L
-#define QMC5883L_ADDR 0x0D
-
-// Регистры датчика
-#define QMC5883L_REG_DATA 0x00
-#define QMC5883L_REG_STATUS 0x06
-#define QMC5883L_REG_CONTROL1 0x09
-#define QMC5883L_REG_CONTROL2 0x0A
+// Датчик и расчет углов - в QMC5883L.h (тот же код гоняет Benchmark/fusion_replay на ПК)
+QMC5883L<TwoWire> compass(Wire);
 
 // Структура для хранения данных
 struct SensorData {
@@ -24,9 +19,7 @@ unsigned long lastPrintTime = 0;
 const unsigned long printInterval = 500; // Интервал вывода в мс
 
 // Калибровочные значения (замените на свои после калибровки)
-int calMinX = -1286, calMaxX = 1532;
-int calMinY = -1395, calMaxY = 1156;
-int calMinZ = -1298, calMaxZ = 1427;
+CompassCalibration calibration = {-1286, 1532, -1395, 1156, -1298, 1427};
 
 // Настройки
 String outputMode = "full"; // "full", "compact", "angles", "raw"
@@ -61,85 +54,26 @@ void loop() {
   delay(10);
 }
 
-// Инициализация датчика
+// Инициализация датчика: сброс, затем режим - непрерывное измерение, 200Hz, 8Гаусс, 512 отсчетов
+// (сброс после настройки возвращал датчик в режим ожидания)
 void initSensor() {
-  Wire.beginTransmission(QMC5883L_ADDR);
-  Wire.write(QMC5883L_REG_CONTROL1);
-  Wire.write(0x1D); // Режим: непрерывное измерение, 200Hz, 8Гаусс, 512 отсчетов
-  Wire.endTransmission();
-  
-  Wire.beginTransmission(QMC5883L_ADDR);
-  Wire.write(QMC5883L_REG_CONTROL2);
-  Wire.write(0x80); // Сброс
-  Wire.endTransmission();
-  
+  compass.begin();
   delay(10);
 }
 
 // Чтение данных с датчика
 bool readSensor() {
-  Wire.beginTransmission(QMC5883L_ADDR);
-  Wire.write(QMC5883L_REG_DATA);
-  if (Wire.endTransmission() != 0) {
-    return false;
-  }
-  
-  Wire.requestFrom(QMC5883L_ADDR, 6);
-  if (Wire.available() < 6) {
-    return false;
-  }
-  
-  // Чтение данных (X, Y, Z) - порядок байт: LSB, MSB
-  uint8_t x_low = Wire.read();
-  uint8_t x_high = Wire.read();
-  uint8_t y_low = Wire.read();
-  uint8_t y_high = Wire.read();
-  uint8_t z_low = Wire.read();
-  uint8_t z_high = Wire.read();
-  
-  data.x = (int16_t)(x_high << 8 | x_low);
-  data.y = (int16_t)(y_high << 8 | y_low);
-  data.z = (int16_t)(z_high << 8 | z_low);
-  
-  return true;
+  return compass.read(data.x, data.y, data.z);
 }
 
 // Расчет углов в градусах
 void calculateAngles() {
-  // Применение калибровки
-  int calX = map(data.x, calMinX, calMaxX, -1000, 1000);
-  int calY = map(data.y, calMinY, calMaxY, -1000, 1000);
-  int calZ = map(data.z, calMinZ, calMaxZ, -1000, 1000);
-  
-  // Расчет крена (Roll) - вращение вокруг оси X
-  if (calZ != 0) {
-    data.roll = atan2((float)calY, (float)calZ) * 180.0 / M_PI;
-  } else {
-    data.roll = 0;
-  }
-  
-  // Расчет тангажа (Pitch) - вращение вокруг оси Y
-  float denominator = sqrt((float)calY * calY + (float)calZ * calZ);
-  if (denominator != 0) {
-    data.pitch = atan2((float)-calX, denominator) * 180.0 / M_PI;
-  } else {
-    data.pitch = 0;
-  }
-  
-  // Расчет курса (Heading) - вращение вокруг оси Z
-  if (calX != 0 || calY != 0) {
-    data.heading = atan2((float)calY, (float)calX) * 180.0 / M_PI;
-    if (data.heading < 0) {
-      data.heading += 360.0;
-    }
-  } else {
-    data.heading = 0;
-  }
-  
-  // Расчет азимута (0-359 градусов)
-  data.azimuth = (int)data.heading;
-  if (data.azimuth >= 360) data.azimuth -= 360;
-  if (data.azimuth < 0) data.azimuth += 360;
+  CompassAngles angles;
+  calculateCompassAngles(data.x, data.y, data.z, calibration, angles);
+  data.roll = angles.roll;
+  data.pitch = angles.pitch;
+  data.heading = angles.heading;
+  data.azimuth = angles.azimuth;
   
   // Определение направления
   data.direction = getDirection(data.azimuth);
@@ -257,7 +191,7 @@ void handleCommands() {
       // Установка калибровочных значений: calibration:minX,maxX,minY,maxY,minZ,maxZ
       parseCalibration(command.substring(12));
     } else if (command == "status") {
-      Serial.println("{\"status\":\"running\",\"mode\":\"" + outputMode + "\",\"auto_output\":" + String(autoOutput ? "true" : "false") + ",\"calibration\":{\"x\":[" + String(calMinX) + "," + String(calMaxX) + "],\"y\":[" + String(calMinY) + "," + String(calMaxY) + "],\"z\":[" + String(calMinZ) + "," + String(calMaxZ) + "]}}");
+      Serial.println("{\"status\":\"running\",\"mode\":\"" + outputMode + "\",\"auto_output\":" + String(autoOutput ? "true" : "false") + ",\"calibration\":{\"x\":[" + String(calibration.minX) + "," + String(calibration.maxX) + "],\"y\":[" + String(calibration.minY) + "," + String(calibration.maxY) + "],\"z\":[" + String(calibration.minZ) + "," + String(calibration.maxZ) + "]}}");
     } else if (command == "help") {
       Serial.println("{\"commands\":[\"mode:full\",\"mode:compact\",\"mode:angles\",\"mode:raw\",\"calibrate\",\"auto:on\",\"auto:off\",\"get\",\"calibration:minX,maxX,minY,maxY,minZ,maxZ\",\"status\",\"help\"]}");
     } else {
@@ -283,25 +217,25 @@ void parseCalibration(String calStr) {
   }
   
   if (index == 6) {
-    calMinX = values[0];
-    calMaxX = values[1];
-    calMinY = values[2];
-    calMaxY = values[3];
-    calMinZ = values[4];
-    calMaxZ = values[5];
+    calibration.minX = values[0];
+    calibration.maxX = values[1];
+    calibration.minY = values[2];
+    calibration.maxY = values[3];
+    calibration.minZ = values[4];
+    calibration.maxZ = values[5];
     
     Serial.print("{\"calibration_set\":{\"x\":[");
-    Serial.print(calMinX);
+    Serial.print(calibration.minX);
     Serial.print(",");
-    Serial.print(calMaxX);
+    Serial.print(calibration.maxX);
     Serial.print("],\"y\":[");
-    Serial.print(calMinY);
+    Serial.print(calibration.minY);
     Serial.print(",");
-    Serial.print(calMaxY);
+    Serial.print(calibration.maxY);
     Serial.print("],\"z\":[");
-    Serial.print(calMinZ);
+    Serial.print(calibration.minZ);
     Serial.print(",");
-    Serial.print(calMaxZ);
+    Serial.print(calibration.maxZ);
     Serial.println("]}}");
   } else {
     Serial.println("{\"error\":\"invalid_calibration_format\",\"expected\":\"minX,maxX,minY,maxY,minZ,maxZ\"}");
@@ -356,42 +290,42 @@ void calibrate() {
   }
   
   // Сохранение калибровочных значений
-  calMinX = minX;
-  calMaxX = maxX;
-  calMinY = minY;
-  calMaxY = maxY;
-  calMinZ = minZ;
-  calMaxZ = maxZ;
+  calibration.minX = minX;
+  calibration.maxX = maxX;
+  calibration.minY = minY;
+  calibration.maxY = maxY;
+  calibration.minZ = minZ;
+  calibration.maxZ = maxZ;
   
   // Вывод результатов калибровки
   Serial.print("{\"calibration\":\"complete\",\"values\":{\"x\":[");
-  Serial.print(calMinX);
+  Serial.print(calibration.minX);
   Serial.print(",");
-  Serial.print(calMaxX);
+  Serial.print(calibration.maxX);
   Serial.print("],\"y\":[");
-  Serial.print(calMinY);
+  Serial.print(calibration.minY);
   Serial.print(",");
-  Serial.print(calMaxY);
+  Serial.print(calibration.maxY);
   Serial.print("],\"z\":[");
-  Serial.print(calMinZ);
+  Serial.print(calibration.minZ);
   Serial.print(",");
-  Serial.print(calMaxZ);
+  Serial.print(calibration.maxZ);
   Serial.println("]}}");
   
   // Вывод кода для вставки в программу
-  Serial.print("{\"calibration_code\":\"int calMinX = ");
-  Serial.print(calMinX);
-  Serial.print(", calMaxX = ");
-  Serial.print(calMaxX);
-  Serial.print("; int calMinY = ");
-  Serial.print(calMinY);
-  Serial.print(", calMaxY = ");
-  Serial.print(calMaxY);
-  Serial.print("; int calMinZ = ");
-  Serial.print(calMinZ);
-  Serial.print(", calMaxZ = ");
-  Serial.print(calMaxZ);
-  Serial.println(";\"}");
+  Serial.print("{\"calibration_code\":\"CompassCalibration calibration = {");
+  Serial.print(calibration.minX);
+  Serial.print(", ");
+  Serial.print(calibration.maxX);
+  Serial.print(", ");
+  Serial.print(calibration.minY);
+  Serial.print(", ");
+  Serial.print(calibration.maxY);
+  Serial.print(", ");
+  Serial.print(calibration.minZ);
+  Serial.print(", ");
+  Serial.print(calibration.maxZ);
+  Serial.println("};\"}");
 }
 
 // Вспомогательные функции для сравнения (если нужны)
@@ -0,0 +1,111 @@
+/*
+  QMC5883L (GY-271) register access and compass angles, independent of the board
+  The transport is a template parameter with the Arduino Wire interface,
+  like MPU6050Bus.h: TwoWire on the device, a register mock on the host
+  (Benchmark/host/MockQMC5883L.h).
+
+  Usage:
+    QMC5883L<TwoWire> compass(Wire);
+    compass.begin();
+    int16_t x, y, z;
+    if (compass.read(x, y, z)) calculateCompassAngles(x, y, z, calibration, angles);
+*/
+
+#ifndef QMC5883L_H
+#define QMC5883L_H
+
+#include <Arduino.h>
+
+#define QMC5883L_ADDR          0x0D
+#define QMC5883L_REG_DATA      0x00
+#define QMC5883L_REG_STATUS    0x06
+#define QMC5883L_REG_CONTROL1  0x09
+#define QMC5883L_REG_CONTROL2  0x0A
+#define QMC5883L_REG_SET_RESET 0x0B
+
+#define QMC5883L_SOFT_RESET    0x80
+#define QMC5883L_CONTINUOUS_200HZ_8G_OSR512 0x1D
+
+// Min/max raw readings per axis, taken while rotating the sensor
+struct CompassCalibration {
+  int minX, maxX;
+  int minY, maxY;
+  int minZ, maxZ;
+};
+
+struct CompassAngles {
+  float roll, pitch, heading;   // degrees; heading 0..360
+  int azimuth;                  // 0..359
+};
+
+template <class WireType>
+class QMC5883L {
+  public:
+    QMC5883L(WireType &wire, uint8_t address = QMC5883L_ADDR) : wire(wire), addr(address) {}
+
+    // Soft reset restores every register to its default (standby), so it
+    // goes first and the measurement mode is written after it
+    void begin() {
+      writeRegister(QMC5883L_REG_CONTROL2, QMC5883L_SOFT_RESET);
+      delay(10);
+      writeRegister(QMC5883L_REG_SET_RESET, 0x01);   // SET/RESET period, as the datasheet recommends
+      writeRegister(QMC5883L_REG_CONTROL1, QMC5883L_CONTINUOUS_200HZ_8G_OSR512);
+    }
+
+    // X, Y, Z, LSB first
+    bool read(int16_t &x, int16_t &y, int16_t &z) {
+      wire.beginTransmission(addr);
+      wire.write(QMC5883L_REG_DATA);
+      if (wire.endTransmission() != 0) return false;
+
+      wire.requestFrom(addr, (uint8_t)6);
+      if (wire.available() < 6) return false;
+
+      uint8_t buf[6];
+      for (uint8_t i = 0; i < 6; i++) buf[i] = wire.read();
+      x = (int16_t)(buf[1] << 8 | buf[0]);
+      y = (int16_t)(buf[3] << 8 | buf[2]);
+      z = (int16_t)(buf[5] << 8 | buf[4]);
+      return true;
+    }
+
+  private:
+    WireType &wire;
+    uint8_t addr;
+
+    void writeRegister(uint8_t reg, uint8_t value) {
+      wire.beginTransmission(addr);
+      wire.write(reg);
+      wire.write(value);
+      wire.endTransmission();
+    }
+};
+
+// Tilt and heading from the calibrated field alone (no accelerometer)
+inline void calculateCompassAngles(int16_t x, int16_t y, int16_t z, const CompassCalibration &cal,
+                                   CompassAngles &angles) {
+  int calX = map(x, cal.minX, cal.maxX, -1000, 1000);
+  int calY = map(y, cal.minY, cal.maxY, -1000, 1000);
+  int calZ = map(z, cal.minZ, cal.maxZ, -1000, 1000);
+
+  // Roll - rotation about X
+  angles.roll = calZ != 0 ? atan2((float)calY, (float)calZ) * 180.0 / M_PI : 0;
+
+  // Pitch - rotation about Y
+  float denominator = sqrt((float)calY * calY + (float)calZ * calZ);
+  angles.pitch = denominator != 0 ? atan2((float)-calX, denominator) * 180.0 / M_PI : 0;
+
+  // Heading - rotation about Z
+  if (calX != 0 || calY != 0) {
+    angles.heading = atan2((float)calY, (float)calX) * 180.0 / M_PI;
+    if (angles.heading < 0) angles.heading += 360.0;
+  } else {
+    angles.heading = 0;
+  }
+
+  angles.azimuth = (int)angles.heading;
+  if (angles.azimuth >= 360) angles.azimuth -= 360;
+  if (angles.azimuth < 0) angles.azimuth += 360;
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include <QMC5883LCompass.h>
+#include "TelemetryFormat.h"
 
 QMC5883LCompass compass;
 
@@ -26,7 +27,7 @@ float calculateRoll(int x, int y, int z);
 float calculateTilt(int x, int y, int z);
 float calculateHeading(int x, int y);
 float calculateTiltCompensatedHeading(int x, int y, int z, float pitch, float roll);
-String getDirection(int azimuth);
+const char* getDirection(int azimuth);
 void printAllAngles(int x, int y, int z);
 void sendChangeData(unsigned long timestamp, unsigned int count,
                     int x, int y, int z,
@@ -259,7 +260,7 @@ float calculateTiltCompensatedHeading(int x, int y, int z, float pitch, float ro
 /**
  * Определение направления по азимуту
  */
-String getDirection(int azimuth) {
+const char* getDirection(int azimuth) {
   int normalizedAzimuth = azimuth % 360;
   if (normalizedAzimuth < 0) {
     normalizedAzimuth += 360;
@@ -321,83 +322,62 @@ void sendChangeData(unsigned long timestamp, unsigned int count,
   // Расчет дополнительных значений
   float simpleHeading = calculateHeading(x, y);
   float tiltCompHeading = calculateTiltCompensatedHeading(x, y, z, pitch, roll);
-  String direction = getDirection((int)simpleHeading);
-  String tiltCompDirection = getDirection((int)tiltCompHeading);
+  const char* direction = getDirection((int)simpleHeading);
+  const char* tiltCompDirection = getDirection((int)tiltCompHeading);
+  
+  // Сообщение собирается в статическом буфере, без String
+  static TelemetryMessage<512> json;
+  json.clear();
   
   // Определение типа изменения
-  String changeType = "";
-  if (abs(pitch - prevPitch) >= angleThreshold) changeType += "pitch ";
-  if (abs(roll - prevRoll) >= angleThreshold) changeType += "roll ";
-  if (abs(tilt - prevTilt) >= angleThreshold) changeType += "tilt ";
-  if (abs(azimuth - prevAzimuth) >= azimuthThreshold) changeType += "azimuth ";
+  json.text("{\"event\":\"position_change\",\"timestamp\":").number(timestamp)
+      .text(",\"reading\":").number(count)
+      .text(",\"change_type\":\"");
+  const char* separator = "";
+  if (abs(pitch - prevPitch) >= angleThreshold) { json.text(separator).text("pitch"); separator = " "; }
+  if (abs(roll - prevRoll) >= angleThreshold) { json.text(separator).text("roll"); separator = " "; }
+  if (abs(tilt - prevTilt) >= angleThreshold) { json.text(separator).text("tilt"); separator = " "; }
+  if (abs(azimuth - prevAzimuth) >= azimuthThreshold) { json.text(separator).text("azimuth"); separator = " "; }
   if (abs(x - prevX) >= rawThreshold || 
       abs(y - prevY) >= rawThreshold || 
-      abs(z - prevZ) >= rawThreshold) changeType += "raw";
-  changeType.trim();
-  
-  // Формирование JSON
-  Serial.print("{");
-  Serial.print("\"event\":\"position_change\",");
-  Serial.print("\"timestamp\":");
-  Serial.print(timestamp);
-  Serial.print(",\"reading\":");
-  Serial.print(count);
-  Serial.print(",\"change_type\":\"");
-  Serial.print(changeType);
+      abs(z - prevZ) >= rawThreshold) json.text(separator).text("raw");
   
   // Сырые значения и изменения
-  Serial.print("\",\"raw\":{\"x\":");
-  Serial.print(x);
-  Serial.print(",\"y\":");
-  Serial.print(y);
-  Serial.print(",\"z\":");
-  Serial.print(z);
-  Serial.print(",\"dx\":");
-  Serial.print(x - prevX);
-  Serial.print(",\"dy\":");
-  Serial.print(y - prevY);
-  Serial.print(",\"dz\":");
-  Serial.print(z - prevZ);
+  json.text("\",\"raw\":{\"x\":").number(x)
+      .text(",\"y\":").number(y)
+      .text(",\"z\":").number(z)
+      .text(",\"dx\":").number(x - prevX)
+      .text(",\"dy\":").number(y - prevY)
+      .text(",\"dz\":").number(z - prevZ);
   
   // Углы наклона
-  Serial.print("},\"angles\":{\"pitch\":");
-  Serial.print(pitch, 2);
-  Serial.print(",\"roll\":");
-  Serial.print(roll, 2);
-  Serial.print(",\"tilt\":");
-  Serial.print(tilt, 2);
-  Serial.print(",\"dpitch\":");
-  Serial.print(pitch - prevPitch, 2);
-  Serial.print(",\"droll\":");
-  Serial.print(roll - prevRoll, 2);
-  Serial.print(",\"dtilt\":");
-  Serial.print(tilt - prevTilt, 2);
+  json.text("},\"angles\":{\"pitch\":").fixed(pitch, 2)
+      .text(",\"roll\":").fixed(roll, 2)
+      .text(",\"tilt\":").fixed(tilt, 2)
+      .text(",\"dpitch\":").fixed(pitch - prevPitch, 2)
+      .text(",\"droll\":").fixed(roll - prevRoll, 2)
+      .text(",\"dtilt\":").fixed(tilt - prevTilt, 2);
   
   // Ориентация (компас)
-  Serial.print("},\"orientation\":{\"simple\":");
-  Serial.print(simpleHeading, 1);
-  Serial.print(",\"simple_dir\":\"");
-  Serial.print(direction);
-  Serial.print("\",\"tilt_comp\":");
-  Serial.print(tiltCompHeading, 1);
-  Serial.print(",\"tilt_comp_dir\":\"");
-  Serial.print(tiltCompDirection);
-  Serial.print("\",\"azimuth\":");
-  Serial.print(azimuth);
-  Serial.print(",\"dazimuth\":");
-  Serial.print(azimuth - prevAzimuth);
+  json.text("},\"orientation\":{\"simple\":").fixed(simpleHeading, 1)
+      .text(",\"simple_dir\":\"").text(direction)
+      .text("\",\"tilt_comp\":").fixed(tiltCompHeading, 1)
+      .text(",\"tilt_comp_dir\":\"").text(tiltCompDirection)
+      .text("\",\"azimuth\":").number(azimuth)
+      .text(",\"dazimuth\":").number(azimuth - prevAzimuth);
   
   // Статус положения
-  Serial.print("},\"status\":\"");
+  json.text("},\"status\":\"");
   if (abs(pitch) < 3 && abs(roll) < 3) {
-    Serial.print("LEVEL");
+    json.text("LEVEL");
   } else if (abs(pitch) > 45 || abs(roll) > 45) {
-    Serial.print("EXTREME_TILT");
+    json.text("EXTREME_TILT");
   } else {
-    Serial.print("TILTED");
+    json.text("TILTED");
   }
+  json.text("\"}");
   
-  Serial.println("\"}");
+  Serial.println(json.c_str());
 }
 
 /**
@@ -0,0 +1,177 @@
+/*
+  Allocation-free telemetry formatter
+  Writes text/JSON messages into a caller-supplied buffer instead of
+  concatenating Arduino String objects on the heap.
+
+  Usage:
+    TelemetryMessage<128> msg;               // stack or static storage
+    msg.text("{\"pitch\":").fixed(pitch, 2).text("}");
+    Serial.println(msg.c_str());
+
+  Field lists are fixed at compile time:
+    static const TelemetryField FIELDS[] = { {"PITCH:", 1}, {",ROLL:", 1} };
+    const double values[] = { pitch, roll };
+    msg.fields(FIELDS, values);              // count checked by the compiler
+
+  Numbers are formatted like String(value, decimals), without its padding.
+  When the buffer is full the output is truncated and overflow() is set.
+*/
+
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <Arduino.h>
+#include <math.h>
+
+struct TelemetryField {
+  const char* prefix;   // Text written before the value (name, separators)
+  uint8_t decimals;     // Digits after the decimal point
+};
+
+class TelemetryBuffer {
+  public:
+    TelemetryBuffer(char* buffer, size_t size)
+      : _buffer(buffer), _size(size), _length(0), _overflow(false) {
+      _buffer[0] = '\0';
+    }
+
+    void clear() {
+      _length = 0;
+      _overflow = false;
+      _buffer[0] = '\0';
+    }
+
+    const char* c_str() const { return _buffer; }
+    size_t length() const { return _length; }
+    bool overflow() const { return _overflow; }
+
+    TelemetryBuffer& character(char c) {
+      if (_length + 1 < _size) {
+        _buffer[_length++] = c;
+        _buffer[_length] = '\0';
+      } else {
+        _overflow = true;
+      }
+      return *this;
+    }
+
+    TelemetryBuffer& text(const char* s) {
+      while (*s) {
+        character(*s++);
+      }
+      return *this;
+    }
+
+    TelemetryBuffer& boolean(bool value) {
+      return text(value ? "true" : "false");
+    }
+
+    TelemetryBuffer& number(unsigned long value) {
+      char digits[20];
+      uint8_t count = 0;
+      do {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+      } while (value > 0);
+      while (count > 0) {
+        character(digits[--count]);
+      }
+      return *this;
+    }
+
+    TelemetryBuffer& number(long value) {
+      if (value < 0) {
+        character('-');
+        return number((unsigned long)(-(value + 1)) + 1UL);
+      }
+      return number((unsigned long)value);
+    }
+
+    TelemetryBuffer& number(int value) { return number((long)value); }
+    TelemetryBuffer& number(unsigned int value) { return number((unsigned long)value); }
+
+    // Float-to-ascii, byte-identical to String(value, decimals) (dtostrf)
+    // minus its leading pad. The value is scaled by 10^decimals once and
+    // the digits come from integer division (doubles are soft-float on
+    // ESP8266). Only when the scaled value sits on a rounding tie, where
+    // dtostrf's own double error picks the last digit, is dtostrf called.
+    // Magnitudes above 4294967040 print "ovf" like Print::print(); at most
+    // 9 decimals.
+    TelemetryBuffer& fixed(double value, uint8_t decimals) {
+      if (isnan(value)) return text("nan");
+      if (isinf(value)) return text("inf");
+      if (value > 4294967040.0) return text("ovf");
+      if (value < -4294967040.0) return text("ovf");
+      if (decimals > 9) decimals = 9;
+
+      uint32_t scale = 1;
+      for (uint8_t i = 0; i < decimals; i++) {
+        scale *= 10;
+      }
+      // Rounded half up; within 0.001 of a tie dtostrf's error (under 1e-5
+      // of the last digit below 2^32) could round either way
+      double rounded = (value < 0.0 ? -value : value) * scale + 0.5;
+      if (rounded < 4294967295.0) {
+        uint32_t units = (uint32_t)rounded;
+        double above = rounded - units;
+        if (above >= 0.001 && above <= 0.999) {
+          if (value < 0.0) character('-');
+          return scaledNumber(units, scale, decimals);
+        }
+      }
+
+      char buffer[24];
+      dtostrf(value, decimals + 2, decimals, buffer);
+      const char* digits = buffer;
+      while (*digits == ' ') {
+        digits++;
+      }
+      return text(digits);
+    }
+
+    template <size_t N>
+    TelemetryBuffer& fields(const TelemetryField (&list)[N], const double (&values)[N]) {
+      for (size_t i = 0; i < N; i++) {
+        text(list[i].prefix);
+        fixed(values[i], list[i].decimals);
+      }
+      return *this;
+    }
+
+  private:
+    // units / 10^decimals with exactly `decimals` digits after the point
+    TelemetryBuffer& scaledNumber(uint32_t units, uint32_t scale, uint8_t decimals) {
+      uint32_t integerPart = units / scale;
+      number((unsigned long)integerPart);
+      if (decimals == 0) return *this;
+
+      character('.');
+      uint32_t fraction = units - integerPart * scale;
+      char digits[9];
+      for (uint8_t i = decimals; i > 0; i--) {
+        digits[i - 1] = '0' + (fraction % 10);
+        fraction /= 10;
+      }
+      for (uint8_t i = 0; i < decimals; i++) {
+        character(digits[i]);
+      }
+      return *this;
+    }
+
+    char* _buffer;
+    size_t _size;
+    size_t _length;
+    bool _overflow;
+};
+
+// Formatter with its own storage (place on the stack or make it static)
+template <size_t N>
+class TelemetryMessage : public TelemetryBuffer {
+  public:
+    TelemetryMessage() : TelemetryBuffer(_storage, N) {}
+
+  private:
+    char _storage[N];
+};
+
+#endif
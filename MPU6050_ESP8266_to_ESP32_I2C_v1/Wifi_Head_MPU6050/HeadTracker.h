@@ -0,0 +1,242 @@
+/*
+  Orientation core of Wifi_Head_MPU6050, independent of the board
+  Everything loop() does with the one sensor sample of a tick: the
+  time-based startup gyro calibration, the complementary filter with yaw
+  drift compensation, display smoothing, gaze direction and idle
+  detection with background bias tracking. No WiFi, WebSocket or Serial
+  here, so the same code runs in the host replay (Benchmark/fusion_replay).
+
+  Units as reported by Adafruit_MPU6050::getEvent(): rad/s and m/s^2;
+  angles in degrees.
+
+  Usage:
+    HeadTracker tracker;
+    tracker.startCalibration(millis());
+    loop(): readSensorSample(mpu, sample);
+            if (tracker.calibrationStep(sample)) { calibration done }
+            tracker.process(sample);
+            tracker.updateGaze(sample, zeroSet, zeroPitch, zeroRoll, zeroYaw);
+            idle = tracker.checkIdle(sample);
+*/
+
+#ifndef HEAD_TRACKER_H
+#define HEAD_TRACKER_H
+
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+#include "StationaryDetector.h"
+
+#define HEAD_TRACKER_CALIBRATION_TIME_MS  3000
+#define HEAD_TRACKER_SMOOTHING            0.3f
+#define HEAD_TRACKER_YAW_DRIFT_COMPENSATION 0.01f  // Small compensation factor
+#define HEAD_TRACKER_IDLE_THRESHOLD       0.5f     // deg/s
+#define HEAD_TRACKER_BIAS_TRACKING_RATE   0.002f   // ~5 s time constant at 100 Hz
+#define HEAD_TRACKER_MAX_GAZE_PITCH       30.0f    // Maximum vertical gaze angle
+#define HEAD_TRACKER_MAX_GAZE_YAW         60.0f    // Maximum horizontal gaze angle
+#define HEAD_TRACKER_MOVEMENT_SMOOTHING   0.9f
+
+// One sensor sample per loop tick, shared by all processing stages
+struct SensorSample {
+  sensors_event_t accel;
+  sensors_event_t gyro;
+  sensors_event_t temp;
+  unsigned long timestamp;  // millis() when the sample was read
+  unsigned long timestampUs; // micros() when the sample was read
+  bool valid;
+};
+
+// Single burst read of accel, gyro and temperature into the tick's sample;
+// Sensor is Adafruit_MPU6050 (a template, so this header needs no driver)
+template <typename Sensor>
+bool readSensorSample(Sensor &mpu, SensorSample &sample) {
+  sample.valid = mpu.getEvent(&sample.accel, &sample.gyro, &sample.temp);
+  sample.timestamp = millis();
+  sample.timestampUs = micros();
+  return sample.valid;
+}
+
+class HeadTracker {
+  public:
+    // Complementary filter output and its display smoothing, degrees
+    float pitch = 0, roll = 0, yaw = 0;
+    float smoothedPitch = 0, smoothedRoll = 0, smoothedYaw = 0;
+
+    float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;   // rad/s
+    float yawDrift = 0;
+    bool calibrated = false;
+
+    // Gaze direction from the head orientation, degrees
+    float gazePitch = 0, gazeYaw = 0, gazeRoll = 0;
+    float headMovementFiltered = 0;
+
+    // Windowed idle detection (~0.3 s at 100 Hz)
+    StationaryDetector<32> idleDetector{0.01, HEAD_TRACKER_IDLE_THRESHOLD * PI / 180.0, 0.2}; // rad/s, rad/s, m/s^2
+
+    int calibrationSamples() const { return sampleCount; }
+
+    // Starts (or restarts) the gyro calibration at nowMs
+    void startCalibration(unsigned long nowMs) {
+      calibrated = false;
+      calibrationStart = nowMs;
+      sampleCount = 0;
+      sumX = sumY = sumZ = 0;
+      pitch = roll = yaw = 0;
+      yawDrift = 0;
+      idleDetector.reset();
+    }
+
+    // Collects calibration samples for HEAD_TRACKER_CALIBRATION_TIME_MS;
+    // true once, when the offsets are ready
+    bool calibrationStep(const SensorSample &sample) {
+      if (calibrated) return false;
+
+      if (sample.timestamp - calibrationStart < HEAD_TRACKER_CALIBRATION_TIME_MS) {
+        if (!sample.valid) return false;
+        sumX += sample.gyro.gyro.x;
+        sumY += sample.gyro.gyro.y;
+        sumZ += sample.gyro.gyro.z;
+        sampleCount++;
+        return false;
+      }
+
+      gyroOffsetX = sumX / sampleCount;
+      gyroOffsetY = sumY / sampleCount;
+      gyroOffsetZ = sumZ / sampleCount;
+      calibrated = true;
+
+      // Use Z-axis offset as initial drift estimate
+      yawDrift = gyroOffsetZ;
+      return true;
+    }
+
+    // Percent of the calibration time elapsed at the given sample
+    int calibrationProgress(const SensorSample &sample) const {
+      return (sample.timestamp - calibrationStart) * 100 / HEAD_TRACKER_CALIBRATION_TIME_MS;
+    }
+
+    void process(const SensorSample &sample) {
+      if (!calibrated || !sample.valid) return;
+      const sensors_event_t &a = sample.accel;
+      const sensors_event_t &g = sample.gyro;
+
+      unsigned long currentTime = sample.timestamp;
+      float deltaTime = (currentTime - lastTime) / 1000.0;
+      if (lastTime == 0) {
+        deltaTime = 0.01; // Initial small value
+      }
+      lastTime = currentTime;
+
+      // Compensate for gyro offset
+      float gyroX = g.gyro.x - gyroOffsetX;
+      float gyroY = g.gyro.y - gyroOffsetY;
+      float gyroZ = g.gyro.z - gyroOffsetZ;
+
+      // Calculate angles from accelerometer (MPU6050_004 logic)
+      float accelPitch = atan2(a.acceleration.y, a.acceleration.z) * 180.0 / PI;
+      float accelRoll = atan2(-a.acceleration.x, sqrt(a.acceleration.y * a.acceleration.y + a.acceleration.z * a.acceleration.z)) * 180.0 / PI;
+
+      // Apply yaw drift compensation
+      if (fabsf(gyroZ) < 0.01) { // Only compensate when gyro is nearly stationary
+        gyroZ -= yawDrift * HEAD_TRACKER_YAW_DRIFT_COMPENSATION;
+      }
+
+      // Gyro integration
+      pitch += gyroX * deltaTime * 180.0 / PI;
+      roll += gyroY * deltaTime * 180.0 / PI;
+      yaw += gyroZ * deltaTime * 180.0 / PI;
+
+      // Complementary filter for pitch and roll (MPU6050_004 logic)
+      float alpha = 0.96;
+      pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
+      roll = alpha * roll + (1.0 - alpha) * accelRoll;
+
+      // Additional yaw stabilization when device is relatively stable (MPU6050_004 logic)
+      float totalAccel = sqrt(a.acceleration.x * a.acceleration.x +
+                              a.acceleration.y * a.acceleration.y +
+                              a.acceleration.z * a.acceleration.z);
+
+      // If device is relatively stable (not moving much), apply small yaw correction
+      if (fabsf(totalAccel - 9.8) < 0.5 && fabsf(gyroZ) < 0.005) {
+        yaw *= 0.999; // Very slow decay to prevent drift
+      }
+
+      // Apply additional smoothing for display
+      smoothedPitch = smoothedPitch * (1 - HEAD_TRACKER_SMOOTHING) + pitch * HEAD_TRACKER_SMOOTHING;
+      smoothedRoll = smoothedRoll * (1 - HEAD_TRACKER_SMOOTHING) + roll * HEAD_TRACKER_SMOOTHING;
+      smoothedYaw = smoothedYaw * (1 - HEAD_TRACKER_SMOOTHING) + yaw * HEAD_TRACKER_SMOOTHING;
+    }
+
+    void updateGaze(const SensorSample &sample, bool zeroSet, float zeroPitch, float zeroRoll, float zeroYaw) {
+      if (!sample.valid) return;
+      const sensors_event_t &g = sample.gyro;
+
+      // Head movement intensity for gaze stabilization
+      float headMovement = sqrt(g.gyro.x * g.gyro.x + g.gyro.y * g.gyro.y + g.gyro.z * g.gyro.z);
+      headMovementFiltered = headMovementFiltered * HEAD_TRACKER_MOVEMENT_SMOOTHING +
+                             headMovement * (1 - HEAD_TRACKER_MOVEMENT_SMOOTHING);
+
+      // During rapid head movements, gaze direction is less affected
+      float gazeSmoothing = 0.7;
+      if (headMovementFiltered > 0.5) {
+        gazeSmoothing = 0.3; // Less smoothing during rapid movements
+      }
+
+      // Pitch affects vertical gaze (looking up/down)
+      float targetGazePitch = constrain(smoothedPitch, -HEAD_TRACKER_MAX_GAZE_PITCH, HEAD_TRACKER_MAX_GAZE_PITCH);
+      float targetGazeYaw = constrain(smoothedYaw, -HEAD_TRACKER_MAX_GAZE_YAW, HEAD_TRACKER_MAX_GAZE_YAW);
+
+      gazePitch = gazePitch * gazeSmoothing + targetGazePitch * (1 - gazeSmoothing);
+      gazeYaw = gazeYaw * gazeSmoothing + targetGazeYaw * (1 - gazeSmoothing);
+      gazeRoll = gazeRoll * gazeSmoothing + smoothedRoll * (1 - gazeSmoothing);
+
+      // Apply zero point correction if set
+      if (zeroSet) {
+        gazePitch = gazePitch - zeroPitch;
+        gazeYaw = gazeYaw - zeroYaw;
+        gazeRoll = gazeRoll - zeroRoll;
+      }
+
+      gazePitch = constrain(gazePitch, -HEAD_TRACKER_MAX_GAZE_PITCH, HEAD_TRACKER_MAX_GAZE_PITCH);
+      gazeYaw = constrain(gazeYaw, -HEAD_TRACKER_MAX_GAZE_YAW, HEAD_TRACKER_MAX_GAZE_YAW);
+
+      // Keep roll within reasonable bounds
+      while (gazeRoll > 180) gazeRoll -= 360;
+      while (gazeRoll < -180) gazeRoll += 360;
+    }
+
+    void resetGaze() {
+      gazePitch = gazeYaw = gazeRoll = 0;
+    }
+
+    // Idle = quiet window of gyro and accel samples; while idle the gyro
+    // bias is followed in the background
+    bool checkIdle(const SensorSample &sample) {
+      if (!sample.valid || !calibrated) return false;
+      const sensors_event_t &g = sample.gyro;
+      const sensors_event_t &a = sample.accel;
+
+      float gyroX = g.gyro.x - gyroOffsetX;
+      float gyroY = g.gyro.y - gyroOffsetY;
+      float gyroZ = g.gyro.z - gyroOffsetZ;
+
+      bool idle = idleDetector.update(gyroX, gyroY, gyroZ,
+                                      a.acceleration.x, a.acceleration.y, a.acceleration.z);
+      if (idle) {
+        trackGyroBias(gyroOffsetX, gyroOffsetY, gyroOffsetZ, gyroX, gyroY, gyroZ, HEAD_TRACKER_BIAS_TRACKING_RATE);
+      }
+      return idle;
+    }
+
+    void resetYaw() {
+      yaw = 0;
+      smoothedYaw = 0;
+    }
+
+  private:
+    unsigned long lastTime = 0;
+    unsigned long calibrationStart = 0;
+    int sampleCount = 0;
+    float sumX = 0, sumY = 0, sumZ = 0;
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*
+  Predictive (dead-reckoning) send policy for orientation streams
+  Sender and receiver both extrapolate the last frame with the angular
+  rate it carried:
+
+      predicted = sent + rate * min(t - sentTime, horizon)
+
+  A new frame goes out only when the fused pose leaves the error budget
+  around that shared prediction, or when the keepalive expires. Slow
+  turns are sent as soon as they drift past the budget (no visible 1 deg
+  steps), fast turns are limited only by minInterval, and a steady turn
+  costs almost nothing because the receiver already predicts it.
+
+  The receiver predicts from the frame arrival time instead of the sample
+  time; the difference is the transport latency, which the threshold
+  policy had as well.
+
+  Usage:
+    PredictiveSendPolicy sendPolicy(0.5, 250000, 10000, 100000);
+    // every fused sample
+    sendPolicy.observe(timestampUs, pitch, roll, yaw);
+    if (sendPolicy.due(timestampUs, pitch, roll, yaw)) {
+      ... frame with pitch/roll/yaw and sendPolicy.rate(0..2) ...
+      sendPolicy.sent(timestampUs, pitch, roll, yaw);
+    }
+*/
+
+#ifndef SEND_POLICY_H
+#define SEND_POLICY_H
+
+#include <Arduino.h>
+#include <math.h>
+
+#define SEND_POLICY_RATE_DEADBAND 1.0f   // deg/s, slower rates are sent as 0
+
+class PredictiveSendPolicy {
+  public:
+    PredictiveSendPolicy(float errorBudget, uint32_t keepaliveUs, uint32_t minIntervalUs,
+                         uint32_t horizonUs, float rateSmoothing = 0.3f)
+      : errorBudget(errorBudget), keepaliveUs(keepaliveUs), minIntervalUs(minIntervalUs),
+        horizonUs(horizonUs), rateSmoothing(rateSmoothing) {
+      reset();
+    }
+
+    // Forgets the rate estimate and forces the next frame
+    void reset() {
+      haveSample = false;
+      haveSent = false;
+      for (uint8_t i = 0; i < 3; i++) {
+        rates[i] = 0;
+        sentAngles[i] = 0;
+        sentRates[i] = 0;
+      }
+      lastError = 0;
+      frames = 0;
+    }
+
+    // Forces the next frame (zero point changed, client connected, ...)
+    void invalidate() { haveSent = false; }
+
+    void setErrorBudget(float degrees) { errorBudget = degrees; }
+    float getErrorBudget() const { return errorBudget; }
+
+    // Every fused sample: updates the angular rate estimate
+    void observe(uint32_t timestampUs, float pitch, float roll, float yaw) {
+      const float angles[3] = {pitch, roll, yaw};
+      if (haveSample) {
+        uint32_t dt = timestampUs - lastSampleUs;
+        if (dt > 0 && dt < horizonUs) {
+          for (uint8_t i = 0; i < 3; i++) {
+            float rate = wrap180(angles[i] - lastAngles[i]) * 1000000.0f / dt;
+            rates[i] += rateSmoothing * (rate - rates[i]);
+          }
+        } else {
+          for (uint8_t i = 0; i < 3; i++) rates[i] = 0;
+        }
+      }
+      for (uint8_t i = 0; i < 3; i++) lastAngles[i] = angles[i];
+      lastSampleUs = timestampUs;
+      haveSample = true;
+    }
+
+    // True if the pose has to be sent now
+    bool due(uint32_t timestampUs, float pitch, float roll, float yaw) {
+      if (!haveSent) return true;
+      uint32_t elapsed = timestampUs - sentUs;
+      if (elapsed < minIntervalUs) return false;
+      if (elapsed >= keepaliveUs) return true;
+
+      lastError = predictionError(elapsed, pitch, roll, yaw);
+      return lastError > errorBudget;
+    }
+
+    // Call with the pose that went out in the frame
+    void sent(uint32_t timestampUs, float pitch, float roll, float yaw) {
+      sentAngles[0] = pitch;
+      sentAngles[1] = roll;
+      sentAngles[2] = yaw;
+      for (uint8_t i = 0; i < 3; i++) sentRates[i] = rate(i);
+      sentUs = timestampUs;
+      haveSent = true;
+      frames++;
+    }
+
+    // Rate that goes into the frame, deg/s (axis 0 - pitch, 1 - roll, 2 - yaw)
+    float rate(uint8_t axis) const {
+      return fabsf(rates[axis]) < SEND_POLICY_RATE_DEADBAND ? 0.0f : rates[axis];
+    }
+
+    // Largest axis deviation from the shared prediction at the last check, deg
+    float error() const { return lastError; }
+    uint32_t framesSent() const { return frames; }
+
+  private:
+    float errorBudget;
+    uint32_t keepaliveUs, minIntervalUs, horizonUs;
+    float rateSmoothing;
+
+    bool haveSample, haveSent;
+    uint32_t lastSampleUs, sentUs;
+    float lastAngles[3], rates[3];
+    float sentAngles[3], sentRates[3];
+    float lastError;
+    uint32_t frames;
+
+    float predictionError(uint32_t elapsedUs, float pitch, float roll, float yaw) const {
+      const float angles[3] = {pitch, roll, yaw};
+      float dt = (elapsedUs < horizonUs ? elapsedUs : horizonUs) / 1000000.0f;
+      float worst = 0;
+      for (uint8_t i = 0; i < 3; i++) {
+        float e = fabsf(wrap180(angles[i] - (sentAngles[i] + sentRates[i] * dt)));
+        if (e > worst) worst = e;
+      }
+      return worst;
+    }
+
+    static float wrap180(float angle) {
+      while (angle > 180.0f) angle -= 360.0f;
+      while (angle < -180.0f) angle += 360.0f;
+      return angle;
+    }
+};
+
+#endif
@@ -10,6 +10,9 @@
   Added idle yaw increment feature
   Added gaze direction calculation based on head orientation
   Integrated web interface
+  Single I2C read per loop shared by fusion, gaze and idle detection
+  Optional binary orientation frames (see OrientationFrame.h)
+  Windowed idle detection with background gyro bias tracking (see StationaryDetector.h)
 */
 
 #include <Wire.h>
@@ -18,7 +21,13 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <WebSocketsServer.h>
+#include <WiFiUdp.h>
 #include <EEPROM.h>
+#include "OrientationFrame.h"
+#include "HeadTracker.h"
+#include "SendPolicy.h"
+#include "UdpPoseStream.h"
+#include "ClockSync.h"
 
 // HTML Parts - объявляем в начале файла
 const char HTML_HEAD[] PROGMEM = R"rawliteral(
@@ -545,6 +554,7 @@ const char HTML_SCRIPT[] PROGMEM = R"rawliteral(
                 };
                 
                 ws.onclose = function(event) {
+                    posePredictor.reset();
                     console.log(`❌ WebSocket disconnected from ${currentIP}`);
                     connectionStatus.textContent = `🔴 Disconnected from ${currentIP}`;
                     connectionStatus.className = 'connection-status disconnected';
@@ -575,7 +585,9 @@ const char HTML_SCRIPT[] PROGMEM = R"rawliteral(
         function handleSensorData(data) {
             if (data.type === 'sensorData') {
                 updateDashboard(data);
-                update3DVisualization(data);
+                // The cube is drawn by the predictor on every animation frame
+                posePredictor.update(data.pitch, data.roll, data.yaw,
+                    data.ratePitch || 0, data.rateRoll || 0, data.rateYaw || 0);
                 updateSystemStatus(data);
             } else if (data.type === 'status') {
                 console.log('System message:', data.message);
@@ -644,6 +656,47 @@ const char HTML_SCRIPT[] PROGMEM = R"rawliteral(
             // При YAW=90 и PITCH=90 FACE также смотрит вверх (а не RIGHT)
         }
         
+        // Dead-reckoning pose predictor, same model as the device (SendPolicy.h):
+        // pose = last frame + rate * min(time since frame, horizon).
+        // The device only sends a frame when the real pose leaves this prediction
+        // by more than its error budget, so the cube keeps moving between frames.
+        const PREDICTION_HORIZON_MS = 100;
+        const posePredictor = {
+            frame: null,
+            
+            update(pitch, roll, yaw, ratePitch, rateRoll, rateYaw) {
+                this.frame = {
+                    pitch, roll, yaw,
+                    ratePitch, rateRoll, rateYaw,
+                    receivedAt: performance.now()
+                };
+            },
+            
+            reset() {
+                this.frame = null;
+            },
+            
+            predict(now) {
+                const f = this.frame;
+                if (!f) return null;
+                const dt = Math.min(Math.max(now - f.receivedAt, 0), PREDICTION_HORIZON_MS) / 1000;
+                return {
+                    pitch: f.pitch + f.ratePitch * dt,
+                    roll: f.roll + f.rateRoll * dt,
+                    yaw: f.yaw + f.rateYaw * dt
+                };
+            }
+        };
+        
+        function renderPredictedPose(now) {
+            const pose = posePredictor.predict(now);
+            if (pose) {
+                update3DVisualization(pose);
+            }
+            requestAnimationFrame(renderPredictedPose);
+        }
+        requestAnimationFrame(renderPredictedPose);
+        
         function smoothValue(axis, value) {
             // Add new value to history
             orientationHistory[axis].push(value);
@@ -822,19 +875,9 @@ const char* password = "GP08004568";
 ESP8266WebServer server(80);
 WebSocketsServer webSocket = WebSocketsServer(81);
 
-// Variables for data smoothing and orientation tracking
-float smoothedPitch = 0;
-float smoothedRoll = 0;
-float smoothedYaw = 0;
-const float smoothingFactor = 0.3;
-
-// Complementary filter variables
-float pitch = 0, roll = 0, yaw = 0;
-float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
-bool calibrated = false;
-unsigned long lastTime = 0;
-unsigned long calibrationStart = 0;
-const unsigned long calibrationTime = 3000;
+// Calibration, complementary filter, smoothing, gaze and idle detection
+// (see HeadTracker.h); Benchmark/fusion_replay runs the same code on a PC
+HeadTracker tracker;
 
 // Zero point (reference position)
 float zeroPitch = 0;
@@ -860,20 +903,30 @@ int pitchDirection = 0;
 int rollDirection = 0;
 int yawDirection = 0;
 
-// Threshold for detecting significant changes (in degrees)
-const float CHANGE_THRESHOLD = 1.0;
-float lastSentPitch = 0;
-float lastSentRoll = 0;
-float lastSentYaw = 0;
+// Predictive send policy: a frame goes out when the smoothed pose leaves the
+// error budget around the client's prediction from the last frame (SendPolicy.h)
+const float SEND_ERROR_BUDGET = 0.5;                // degrees
+const unsigned long SEND_KEEPALIVE_US = 250000;     // at least 4 frames/s
+const unsigned long SEND_MIN_INTERVAL_US = 20000;   // at most 50 frames/s
+const unsigned long SEND_PREDICTION_HORIZON_US = 100000;
+PredictiveSendPolicy sendPolicy(SEND_ERROR_BUDGET, SEND_KEEPALIVE_US,
+                                SEND_MIN_INTERVAL_US, SEND_PREDICTION_HORIZON_US);
 
 // WebSocket connection management
 bool clientConnected = false;
-unsigned long lastDataSend = 0;
-const unsigned long MIN_SEND_INTERVAL = 50; // Minimum 50ms between sends
 
-// Yaw drift compensation
-float yawDrift = 0;
-const float YAW_DRIFT_COMPENSATION = 0.01; // Small compensation factor
+// Opt-in UDP stream of binary frames (see UdpPoseStream.h)
+#define UDP_POSE_LOCAL_PORT 4210
+#define UDP_POSE_REFRESH_US 20000   // Repeat the pose every 20 ms when no frame is due
+WiFiUDP poseUdp;
+UdpPoseStream<WiFiUDP> poseStream(poseUdp, UDP_POSE_LOCAL_PORT);
+uint16_t udpSequence = 0;            // Own counter so UDP loss does not show up as WebSocket gaps
+unsigned long lastUdpFrameMicros = 0;
+
+// Shared time with the AP hub (see ClockSync.h): the access point is the master
+WiFiUDP clockSyncUdp;
+ClockSyncClient<WiFiUDP> clockSync(clockSyncUdp);
+bool clockSyncReported = false;
 
 // Serial mode detection
 bool serialMode = false;
@@ -892,18 +945,14 @@ const int ZERO_SET_ADDR = sizeof(float) * 3;
 unsigned long lastIdleYawIncrement = 0;
 const unsigned long IDLE_YAW_INCREMENT_INTERVAL = 5000; // 5 seconds
 bool isDeviceIdle = false;
-const float IDLE_THRESHOLD = 0.5; // Idle threshold in degrees/second
 
-// Gaze direction calculation
-float gazePitch = 0;    // Vertical gaze direction (-90° to +90°)
-float gazeYaw = 0;      // Horizontal gaze direction (-180° to +180°)
-float gazeRoll = 0;     // Head tilt for gaze
-const float MAX_GAZE_PITCH = 30.0;  // Maximum vertical gaze angle
-const float MAX_GAZE_YAW = 60.0;    // Maximum horizontal gaze angle
+// One sensor sample per loop tick, shared by all processing stages
+SensorSample currentSample;
 
-// Head movement smoothing for gaze
-float headMovementFiltered = 0;
-const float HEAD_MOVEMENT_SMOOTHING = 0.9;
+// Per-client frame format, negotiated with "FORMAT:BIN" / "FORMAT:TEXT"
+// (or the older "setFormat:binary" / "setFormat:text", see OrientationFrame.h)
+bool binaryClients[WEBSOCKETS_SERVER_CLIENT_MAX] = {false};
+uint16_t frameSequence = 0;
 
 void setup() {
   // Initialize EEPROM
@@ -948,6 +997,7 @@ void setup() {
   }
   
   if (WiFi.status() == WL_CONNECTED) {
+    clockSync.begin(WiFi.gatewayIP());
     if (serialMode) {
       Serial.println("\n✅ Connected to WiFi!");
       Serial.print("📡 IP Address: ");
@@ -991,7 +1041,7 @@ void setup() {
   mpu.setFilterBandwidth(MPU6050_BAND_10_HZ);      // Lower bandwidth for smoother head tracking
   
   // Start calibration
-  calibrationStart = millis();
+  tracker.startCalibration(millis());
   if (serialMode) {
     Serial.println("🔧 Calibrating gyro... Keep head still for 3 seconds!");
     if (zeroSet) {
@@ -1007,6 +1057,10 @@ void setup() {
   server.on("/setZero", HTTP_GET, handleSetZero);
   server.on("/resetZero", HTTP_GET, handleResetZero);
   server.on("/resetGaze", HTTP_GET, handleResetGaze);
+  server.on("/udp/subscribe", HTTP_GET, handleUdpSubscribe);
+  server.on("/udp/unsubscribe", HTTP_GET, handleUdpUnsubscribe);
+  server.on("/udp/multicast", HTTP_GET, handleUdpMulticast);
+  server.on("/udp/status", HTTP_GET, handleUdpStatus);
   server.onNotFound(handleNotFound);
   
   // Enable CORS
@@ -1016,10 +1070,12 @@ void setup() {
   server.begin();
   webSocket.begin();
   webSocket.onEvent(webSocketEvent);
+  poseStream.begin();
   
   if (serialMode) {
     Serial.println("✅ HTTP server started on port 80");
     Serial.println("✅ WebSocket server started on port 81");
+    Serial.printf("✅ UDP pose stream ready (source port %d, subscribe via /udp/subscribe)\n", UDP_POSE_LOCAL_PORT);
     Serial.println("🌐 Use this URL: http://" + WiFi.localIP().toString());
     Serial.println("🎯 Head tracking with gaze direction activated");
   }
@@ -1036,26 +1092,36 @@ void loop() {
     lastSerialCheck = currentTime;
   }
   
+  // Clock sync exchange with the hub (non-blocking)
+  clockSync.poll(micros());
+  if (serialMode && clockSync.synced() != clockSyncReported) {
+    clockSyncReported = clockSync.synced();
+    Serial.printf("🕒 Clock sync %s (offset %.0f us, drift %.1f ppm)\n",
+                  clockSyncReported ? "locked" : "lost", clockSync.offset(), clockSync.drift());
+  }
+  
+  // Read the sensor once; every stage below works on the same sample
+  readSensorSample(currentSample);
+  
   // Process sensor data
-  processSensorData();
+  processSensorData(currentSample);
   
   // Calculate gaze direction based on head orientation
-  calculateGazeDirection();
+  calculateGazeDirection(currentSample);
   
   // Check if device is idle
-  isDeviceIdle = checkIfDeviceIdle();
+  isDeviceIdle = checkIfDeviceIdle(currentSample);
   
   // If device is idle and zero point is set, handle idle yaw increment
   if (isDeviceIdle && zeroSet) {
     handleIdleYawIncrement();
   }
   
-  // Send data only if client is connected via WebSocket
-  if (clientConnected) {
-    if (currentTime - lastDataSend >= MIN_SEND_INTERVAL) {
-      sendOrientationData(currentTime);
-      lastDataSend = currentTime;
-    }
+  // Send data only if a WebSocket client or a UDP subscriber is there
+  sendPolicy.observe(currentSample.timestampUs, tracker.smoothedPitch, tracker.smoothedRoll, tracker.smoothedYaw);
+  poseStream.expire(currentTime);
+  if (clientConnected || poseStream.active()) {
+    sendOrientationData(currentTime);
   }
   
   // Always output to serial if connected
@@ -1066,71 +1132,23 @@ void loop() {
   delay(10); // Small delay for stability
 }
 
-void calculateGazeDirection() {
-  // Calculate head movement intensity for gaze stabilization
-  sensors_event_t a, g, temp;
-  if (!mpu.getEvent(&a, &g, &temp)) {
-    return;
-  }
-  
-  // Calculate head movement magnitude
-  float headMovement = sqrt(g.gyro.x * g.gyro.x + g.gyro.y * g.gyro.y + g.gyro.z * g.gyro.z);
-  headMovementFiltered = headMovementFiltered * HEAD_MOVEMENT_SMOOTHING + 
-                        headMovement * (1 - HEAD_MOVEMENT_SMOOTHING);
-  
-  // Gaze direction is based on head orientation with some filtering
-  // During rapid head movements, gaze direction is less affected
-  float gazeSmoothing = 0.7;
-  if (headMovementFiltered > 0.5) {
-    gazeSmoothing = 0.3; // Less smoothing during rapid movements
-  }
-  
-  // Calculate gaze direction from head orientation
-  // Pitch affects vertical gaze (looking up/down)
-  float targetGazePitch = constrain(smoothedPitch, -MAX_GAZE_PITCH, MAX_GAZE_PITCH);
-  float targetGazeYaw = constrain(smoothedYaw, -MAX_GAZE_YAW, MAX_GAZE_YAW);
+bool readSensorSample(SensorSample &sample) {
+  readSensorSample(mpu, sample);
   
-  gazePitch = gazePitch * gazeSmoothing + targetGazePitch * (1 - gazeSmoothing);
-  gazeYaw = gazeYaw * gazeSmoothing + targetGazeYaw * (1 - gazeSmoothing);
-  gazeRoll = gazeRoll * gazeSmoothing + smoothedRoll * (1 - gazeSmoothing);
-  
-  // Apply zero point correction if set
-  if (zeroSet) {
-    gazePitch = gazePitch - zeroPitch;
-    gazeYaw = gazeYaw - zeroYaw;
-    gazeRoll = gazeRoll - zeroRoll;
+  if (!sample.valid && serialMode) {
+    Serial.println("Error reading MPU6050 data");
   }
-  
-  // Normalize gaze angles
-  gazePitch = constrain(gazePitch, -MAX_GAZE_PITCH, MAX_GAZE_PITCH);
-  gazeYaw = constrain(gazeYaw, -MAX_GAZE_YAW, MAX_GAZE_YAW);
-  
-  // Keep roll within reasonable bounds
-  while (gazeRoll > 180) gazeRoll -= 360;
-  while (gazeRoll < -180) gazeRoll += 360;
+  return sample.valid;
 }
 
-bool checkIfDeviceIdle() {
-  // Check if device is moving (using gyro data)
-  sensors_event_t a, g, temp;
-  if (!mpu.getEvent(&a, &g, &temp)) {
-    return false;
-  }
-  
-  // Compensate for offsets
-  float gyroX = g.gyro.x - gyroOffsetX;
-  float gyroY = g.gyro.y - gyroOffsetY;
-  float gyroZ = g.gyro.z - gyroOffsetZ;
-  
-  // Convert to degrees per second
-  float gyroXDeg = gyroX * 180.0 / PI;
-  float gyroYDeg = gyroY * 180.0 / PI;
-  float gyroZDeg = gyroZ * 180.0 / PI;
-  
-  // If all angular velocities are below threshold - device is idle
-  return (abs(gyroXDeg) < IDLE_THRESHOLD && 
-          abs(gyroYDeg) < IDLE_THRESHOLD && 
-          abs(gyroZDeg) < IDLE_THRESHOLD);
+void calculateGazeDirection(const SensorSample &sample) {
+  // Gaze follows the head orientation, less smoothed during rapid movements
+  tracker.updateGaze(sample, zeroSet, zeroPitch, zeroRoll, zeroYaw);
+}
+
+bool checkIfDeviceIdle(const SensorSample &sample) {
+  // Idle = quiet window of gyro and accel samples; while idle the gyro bias is tracked
+  return tracker.checkIdle(sample);
 }
 
 void handleIdleYawIncrement() {
@@ -1153,8 +1171,8 @@ void handleIdleYawIncrement() {
     // Update direction
     yawDirection = 1;
     
-    // Reset timer for next direction update
-    lastDataSend = currentTime - MIN_SEND_INTERVAL;
+    // Idle increment is not predictable - send the next frame right away
+    sendPolicy.invalidate();
   }
 }
 
@@ -1174,9 +1192,9 @@ void loadZeroPoint() {
 }
 
 void saveZeroPoint() {
-  zeroPitch = smoothedPitch;
-  zeroRoll = smoothedRoll;
-  zeroYaw = smoothedYaw;
+  zeroPitch = tracker.smoothedPitch;
+  zeroRoll = tracker.smoothedRoll;
+  zeroYaw = tracker.smoothedYaw;
   zeroSet = true;
   
   // Reset accumulated angles when setting new zero point
@@ -1185,21 +1203,19 @@ void saveZeroPoint() {
   accumulatedYaw = 0;
   
   // Reset continuous tracking
-  contPitch = smoothedPitch;
-  contRoll = smoothedRoll;
-  contYaw = smoothedYaw;
-  prevAbsPitch = smoothedPitch;
-  prevAbsRoll = smoothedRoll;
-  prevAbsYaw = smoothedYaw;
+  contPitch = tracker.smoothedPitch;
+  contRoll = tracker.smoothedRoll;
+  contYaw = tracker.smoothedYaw;
+  prevAbsPitch = tracker.smoothedPitch;
+  prevAbsRoll = tracker.smoothedRoll;
+  prevAbsYaw = tracker.smoothedYaw;
   prevContPitch = 0;
   prevContRoll = 0;
   prevContYaw = 0;
   firstMeasurement = true;
   
   // Reset gaze direction
-  gazePitch = 0;
-  gazeYaw = 0;
-  gazeRoll = 0;
+  tracker.resetGaze();
   
   // Reset direction
   pitchDirection = 0;
@@ -1243,9 +1259,7 @@ void resetZeroPoint() {
   firstMeasurement = true;
   
   // Reset gaze direction
-  gazePitch = 0;
-  gazeYaw = 0;
-  gazeRoll = 0;
+  tracker.resetGaze();
   
   // Reset direction
   pitchDirection = 0;
@@ -1262,9 +1276,7 @@ void resetZeroPoint() {
 }
 
 void resetGazeDirection() {
-  gazePitch = 0;
-  gazeYaw = 0;
-  gazeRoll = 0;
+  tracker.resetGaze();
   
   if (serialMode) {
     Serial.println("🔄 Gaze direction reset to center");
@@ -1303,9 +1315,9 @@ float calculateContinuousRelativeAngle(float absoluteAngle, float zeroAngle, flo
 
 void updateAccumulatedAngles() {
   // Calculate continuous relative angles (accounts for zero-crossing)
-  float continuousRelPitch = calculateContinuousRelativeAngle(smoothedPitch, zeroPitch, prevAbsPitch, contPitch);
-  float continuousRelRoll = calculateContinuousRelativeAngle(smoothedRoll, zeroRoll, prevAbsRoll, contRoll);
-  float continuousRelYaw = calculateContinuousRelativeAngle(smoothedYaw, zeroYaw, prevAbsYaw, contYaw);
+  float continuousRelPitch = calculateContinuousRelativeAngle(tracker.smoothedPitch, zeroPitch, prevAbsPitch, contPitch);
+  float continuousRelRoll = calculateContinuousRelativeAngle(tracker.smoothedRoll, zeroRoll, prevAbsRoll, contRoll);
+  float continuousRelYaw = calculateContinuousRelativeAngle(tracker.smoothedYaw, zeroYaw, prevAbsYaw, contYaw);
   
   // Calculate deltas for direction detection
   float deltaPitch = continuousRelPitch - prevContPitch;
@@ -1357,14 +1369,14 @@ void outputSerialData(unsigned long currentTime) {
   if (currentTime - lastSerialOutput >= SERIAL_OUTPUT_INTERVAL) {
     lastSerialOutput = currentTime;
     
-    float relPitch = calculateRelativeAngle(smoothedPitch, zeroPitch);
-    float relRoll = calculateRelativeAngle(smoothedRoll, zeroRoll);
-    float relYaw = calculateRelativeAngle(smoothedYaw, zeroYaw);
+    float relPitch = calculateRelativeAngle(tracker.smoothedPitch, zeroPitch);
+    float relRoll = calculateRelativeAngle(tracker.smoothedRoll, zeroRoll);
+    float relYaw = calculateRelativeAngle(tracker.smoothedYaw, zeroYaw);
     
     Serial.printf("HEAD Pitch:%.1f° Roll:%.1f° Yaw:%.1f° | ", 
-                 smoothedPitch, smoothedRoll, smoothedYaw);
+                 tracker.smoothedPitch, tracker.smoothedRoll, tracker.smoothedYaw);
     Serial.printf("GAZE Pitch:%.1f° Yaw:%.1f° Roll:%.1f° | ", 
-                 gazePitch, gazeYaw, gazeRoll);
+                 tracker.gazePitch, tracker.gazeYaw, tracker.gazeRoll);
     Serial.printf("REL Pitch:%.1f° Roll:%.1f° Yaw:%.1f° | ", 
                  relPitch, relRoll, relYaw);
     Serial.printf("ACC Pitch:%.1f° Roll:%.1f° Yaw:%.1f° | ", 
@@ -1377,157 +1389,124 @@ void outputSerialData(unsigned long currentTime) {
   }
 }
 
-void calibrateGyro() {
-  if (calibrated) return;
-  
-  sensors_event_t a, g, temp;
-  mpu.getEvent(&a, &g, &temp);
-  
-  static int sampleCount = 0;
-  static float sumX = 0, sumY = 0, sumZ = 0;
-  
-  if (millis() - calibrationStart < calibrationTime) {
-    sumX += g.gyro.x;
-    sumY += g.gyro.y;
-    sumZ += g.gyro.z;
-    sampleCount++;
-    
+void calibrateGyro(const SensorSample &sample) {
+  if (!tracker.calibrationStep(sample)) {
     // Show calibration progress only in serial mode
-    if (serialMode && sampleCount % 50 == 0) {
-      int progress = (millis() - calibrationStart) * 100 / calibrationTime;
-      Serial.printf("Calibration progress: %d%%\n", progress);
-    }
-  } else {
-    gyroOffsetX = sumX / sampleCount;
-    gyroOffsetY = sumY / sampleCount;
-    gyroOffsetZ = sumZ / sampleCount;
-    calibrated = true;
-    
-    // Calculate initial yaw drift compensation
-    yawDrift = gyroOffsetZ; // Use Z-axis offset as initial drift estimate
-    
-    if (serialMode) {
-      Serial.println("✅ Gyro calibration complete!");
-      Serial.printf("Offsets - X:%.6f, Y:%.6f, Z:%.6f\n", gyroOffsetX, gyroOffsetY, gyroOffsetZ);
-      Serial.printf("Yaw drift compensation: %.6f\n", yawDrift);
-      Serial.printf("Samples processed: %d\n", sampleCount);
-    }
-    
-    // Notify all clients
-    webSocket.broadcastTXT("{\"type\":\"status\",\"message\":\"Calibration complete\"}");
-  }
-}
-
-void processSensorData() {
-  if (!calibrated) {
-    calibrateGyro();
-    return;
-  }
-  
-  sensors_event_t a, g, temp;
-  if (!mpu.getEvent(&a, &g, &temp)) {
-    if (serialMode) {
-      Serial.println("Error reading MPU6050 data");
+    if (serialMode && !tracker.calibrated && sample.valid &&
+        tracker.calibrationSamples() > 0 && tracker.calibrationSamples() % 50 == 0) {
+      Serial.printf("Calibration progress: %d%%\n", tracker.calibrationProgress(sample));
     }
     return;
   }
   
-  unsigned long currentTime = millis();
-  float deltaTime = (currentTime - lastTime) / 1000.0;
-  if (lastTime == 0) {
-    deltaTime = 0.01; // Initial small value
-  }
-  lastTime = currentTime;
-  
-  // Compensate for gyro offset
-  float gyroX = g.gyro.x - gyroOffsetX;
-  float gyroY = g.gyro.y - gyroOffsetY;
-  float gyroZ = g.gyro.z - gyroOffsetZ;
-  
-  // Calculate angles from accelerometer (MPU6050_004 logic)
-  float accelPitch = atan2(a.acceleration.y, a.acceleration.z) * 180.0 / PI;
-  float accelRoll = atan2(-a.acceleration.x, sqrt(a.acceleration.y * a.acceleration.y + a.acceleration.z * a.acceleration.z)) * 180.0 / PI;
-  
-  // Apply yaw drift compensation
-  if (abs(gyroZ) < 0.01) { // Only compensate when gyro is nearly stationary
-    gyroZ -= yawDrift * YAW_DRIFT_COMPENSATION;
+  if (serialMode) {
+    Serial.println("✅ Gyro calibration complete!");
+    Serial.printf("Offsets - X:%.6f, Y:%.6f, Z:%.6f\n", tracker.gyroOffsetX, tracker.gyroOffsetY, tracker.gyroOffsetZ);
+    Serial.printf("Yaw drift compensation: %.6f\n", tracker.yawDrift);
+    Serial.printf("Samples processed: %d\n", tracker.calibrationSamples());
   }
   
-  // Gyro integration
-  pitch += gyroX * deltaTime * 180.0 / PI;
-  roll += gyroY * deltaTime * 180.0 / PI;
-  yaw += gyroZ * deltaTime * 180.0 / PI;
-  
-  // Complementary filter for pitch and roll (MPU6050_004 logic)
-  float alpha = 0.96;
-  pitch = alpha * pitch + (1.0 - alpha) * accelPitch;
-  roll = alpha * roll + (1.0 - alpha) * accelRoll;
-  
-  // Additional yaw stabilization when device is relatively stable (MPU6050_004 logic)
-  float totalAccel = sqrt(a.acceleration.x * a.acceleration.x + 
-                         a.acceleration.y * a.acceleration.y + 
-                         a.acceleration.z * a.acceleration.z);
-  
-  // If device is relatively stable (not moving much), apply small yaw correction
-  if (abs(totalAccel - 9.8) < 0.5 && abs(gyroZ) < 0.005) {
-    yaw *= 0.999; // Very slow decay to prevent drift
+  // Notify all clients
+  webSocket.broadcastTXT("{\"type\":\"status\",\"message\":\"Calibration complete\"}");
+}
+
+void processSensorData(const SensorSample &sample) {
+  if (!tracker.calibrated) {
+    calibrateGyro(sample);
+    return;
   }
-  
-  // Apply additional smoothing for display
-  smoothedPitch = smoothedPitch * (1 - smoothingFactor) + pitch * smoothingFactor;
-  smoothedRoll = smoothedRoll * (1 - smoothingFactor) + roll * smoothingFactor;
-  smoothedYaw = smoothedYaw * (1 - smoothingFactor) + yaw * smoothingFactor;
+  tracker.process(sample);
 }
 
 void sendOrientationData(unsigned long currentTime) {
-  // Check if data has changed significantly
-  bool pitchChanged = abs(smoothedPitch - lastSentPitch) >= CHANGE_THRESHOLD;
-  bool rollChanged = abs(smoothedRoll - lastSentRoll) >= CHANGE_THRESHOLD;
-  bool yawChanged = abs(smoothedYaw - lastSentYaw) >= CHANGE_THRESHOLD;
-  
-  // Always send data if it's the first time or if any value changed
-  if (pitchChanged || rollChanged || yawChanged || lastDataSend == 0) {
+  // Send only if the client's prediction from the last frame is off by more than the budget
+  if (sendPolicy.due(currentSample.timestampUs, tracker.smoothedPitch, tracker.smoothedRoll, tracker.smoothedYaw)) {
     // Update accumulated angles with zero-crossing detection
     updateAccumulatedAngles();
     
     // Calculate relative angles (for backward compatibility)
-    float relPitch = calculateRelativeAngle(smoothedPitch, zeroPitch);
-    float relRoll = calculateRelativeAngle(smoothedRoll, zeroRoll);
-    float relYaw = calculateRelativeAngle(smoothedYaw, zeroYaw);
+    float relPitch = calculateRelativeAngle(tracker.smoothedPitch, zeroPitch);
+    float relRoll = calculateRelativeAngle(tracker.smoothedRoll, zeroRoll);
+    float relYaw = calculateRelativeAngle(tracker.smoothedYaw, zeroYaw);
+    
+    // Find out which formats the connected clients expect
+    bool anyTextClient = false;
+    bool anyBinaryClient = false;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+      if (!webSocket.clientIsConnected(i)) continue;
+      if (binaryClients[i]) {
+        anyBinaryClient = true;
+      } else {
+        anyTextClient = true;
+      }
+    }
+    frameSequence++;
+    
+    if (anyBinaryClient) {
+      uint8_t frame[ORIENTATION_FRAME_RATES_SIZE];
+      size_t frameLength = encodePoseFrame(frame, frameSequence, relPitch, relRoll, relYaw);
+      if (!anyTextClient) {
+        webSocket.broadcastBIN(frame, frameLength);
+      } else {
+        for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+          if (binaryClients[i] && webSocket.clientIsConnected(i)) {
+            webSocket.sendBIN(i, frame, frameLength);
+          }
+        }
+      }
+    }
     
-    // Create JSON message with both absolute and relative values
-    String json = "{";
-    json += "\"type\":\"sensorData\",";
-    json += "\"pitch\":" + String(relPitch, 2) + ",";        // Relative pitch (backward compatibility)
-    json += "\"roll\":" + String(relRoll, 2) + ",";          // Relative roll (backward compatibility)
-    json += "\"yaw\":" + String(relYaw, 2) + ",";            // Relative yaw (backward compatibility)
-    json += "\"absPitch\":" + String(smoothedPitch, 2) + ","; // Absolute pitch
-    json += "\"absRoll\":" + String(smoothedRoll, 2) + ",";   // Absolute roll
-    json += "\"absYaw\":" + String(smoothedYaw, 2) + ",";     // Absolute yaw
-    json += "\"accPitch\":" + String(accumulatedPitch, 2) + ","; // Accumulated pitch
-    json += "\"accRoll\":" + String(accumulatedRoll, 2) + ",";   // Accumulated roll
-    json += "\"accYaw\":" + String(accumulatedYaw, 2) + ",";     // Accumulated yaw
-    json += "\"gazePitch\":" + String(gazePitch, 2) + ",";    // Gaze pitch
-    json += "\"gazeYaw\":" + String(gazeYaw, 2) + ",";        // Gaze yaw
-    json += "\"gazeRoll\":" + String(gazeRoll, 2) + ",";      // Gaze roll
-    json += "\"dirPitch\":" + String(pitchDirection) + ",";   // Pitch direction
-    json += "\"dirRoll\":" + String(rollDirection) + ",";     // Roll direction
-    json += "\"dirYaw\":" + String(yawDirection) + ",";       // Yaw direction
-    json += "\"zeroPitch\":" + String(zeroPitch, 2) + ",";    // Zero point pitch
-    json += "\"zeroRoll\":" + String(zeroRoll, 2) + ",";      // Zero point roll
-    json += "\"zeroYaw\":" + String(zeroYaw, 2) + ",";        // Zero point yaw
-    json += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
-    json += "\"idle\":" + String(isDeviceIdle ? "true" : "false") + ","; // Idle state
-    json += "\"timestamp\":" + String(currentTime);
-    json += "}";
+    if (anyTextClient) {
+      // Create JSON message with both absolute and relative values
+      String json = "{";
+      json += "\"type\":\"sensorData\",";
+      json += "\"pitch\":" + String(relPitch, 2) + ",";        // Relative pitch (backward compatibility)
+      json += "\"roll\":" + String(relRoll, 2) + ",";          // Relative roll (backward compatibility)
+      json += "\"yaw\":" + String(relYaw, 2) + ",";            // Relative yaw (backward compatibility)
+      json += "\"absPitch\":" + String(tracker.smoothedPitch, 2) + ","; // Absolute pitch
+      json += "\"absRoll\":" + String(tracker.smoothedRoll, 2) + ",";   // Absolute roll
+      json += "\"absYaw\":" + String(tracker.smoothedYaw, 2) + ",";     // Absolute yaw
+      json += "\"accPitch\":" + String(accumulatedPitch, 2) + ","; // Accumulated pitch
+      json += "\"accRoll\":" + String(accumulatedRoll, 2) + ",";   // Accumulated roll
+      json += "\"accYaw\":" + String(accumulatedYaw, 2) + ",";     // Accumulated yaw
+      json += "\"gazePitch\":" + String(tracker.gazePitch, 2) + ",";    // Gaze pitch
+      json += "\"gazeYaw\":" + String(tracker.gazeYaw, 2) + ",";        // Gaze yaw
+      json += "\"gazeRoll\":" + String(tracker.gazeRoll, 2) + ",";      // Gaze roll
+      json += "\"dirPitch\":" + String(pitchDirection) + ",";   // Pitch direction
+      json += "\"dirRoll\":" + String(rollDirection) + ",";     // Roll direction
+      json += "\"dirYaw\":" + String(yawDirection) + ",";       // Yaw direction
+      json += "\"zeroPitch\":" + String(zeroPitch, 2) + ",";    // Zero point pitch
+      json += "\"zeroRoll\":" + String(zeroRoll, 2) + ",";      // Zero point roll
+      json += "\"zeroYaw\":" + String(zeroYaw, 2) + ",";        // Zero point yaw
+      json += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
+      json += "\"idle\":" + String(isDeviceIdle ? "true" : "false") + ","; // Idle state
+      json += "\"timestamp\":" + String(currentTime) + ",";
+      json += "\"seq\":" + String(frameSequence) + ",";      // Frame sequence number
+      json += "\"sampleUs\":" + String(currentSample.timestampUs) + ","; // Sample time, micros()
+      if (clockSync.synced()) {
+        json += "\"syncUs\":" + String(clockSync.toShared(currentSample.timestampUs)) + ","; // Sample time, hub clock
+      }
+      json += "\"ratePitch\":" + String(sendPolicy.rate(0), 1) + ","; // Angular rates for client prediction, deg/s
+      json += "\"rateRoll\":" + String(sendPolicy.rate(1), 1) + ",";
+      json += "\"rateYaw\":" + String(sendPolicy.rate(2), 1);
+      json += "}";
     
-    // Send to all connected clients
-    webSocket.broadcastTXT(json);
+      // Send to all text clients
+      if (!anyBinaryClient) {
+        webSocket.broadcastTXT(json);
+      } else {
+        for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+          if (!binaryClients[i] && webSocket.clientIsConnected(i)) {
+            webSocket.sendTXT(i, json);
+          }
+        }
+      }
+    }
+    
+    sendUdpPoseFrame(relPitch, relRoll, relYaw);
     
-    // Update last sent values
-    lastSentPitch = smoothedPitch;
-    lastSentRoll = smoothedRoll;
-    lastSentYaw = smoothedYaw;
+    // The client now predicts from this frame
+    sendPolicy.sent(currentSample.timestampUs, tracker.smoothedPitch, tracker.smoothedRoll, tracker.smoothedYaw);
     
     // Debug output only in serial mode
     if (serialMode) {
@@ -1535,12 +1514,110 @@ void sendOrientationData(unsigned long currentTime) {
       if (currentTime - lastDebug >= 1000) {
         lastDebug = currentTime;
         Serial.printf("📤 WebSocket: HEAD[P:%.1f° R:%.1f° Y:%.1f°] GAZE[P:%.1f° Y:%.1f° R:%.1f°] REL[P:%.1f° R:%.1f° Y:%.1f°] ACC[P:%.1f° R:%.1f° Y:%.1f°] DIR[P:%d R:%d Y:%d] Idle:%s\n", 
-                     smoothedPitch, smoothedRoll, smoothedYaw, gazePitch, gazeYaw, gazeRoll,
+                     tracker.smoothedPitch, tracker.smoothedRoll, tracker.smoothedYaw, tracker.gazePitch, tracker.gazeYaw, tracker.gazeRoll,
                      relPitch, relRoll, relYaw, accumulatedPitch, accumulatedRoll, accumulatedYaw, 
                      pitchDirection, rollDirection, yawDirection, isDeviceIdle ? "YES" : "NO");
       }
     }
+  } else if (poseStream.active() && currentSample.timestampUs - lastUdpFrameMicros >= UDP_POSE_REFRESH_US) {
+    // A lost datagram is never resent, so keep the next one coming soon
+    sendUdpPoseFrame(calculateRelativeAngle(tracker.smoothedPitch, zeroPitch),
+                     calculateRelativeAngle(tracker.smoothedRoll, zeroRoll),
+                     calculateRelativeAngle(tracker.smoothedYaw, zeroYaw));
+  }
+}
+
+// Binary frame of the current pose with rates for client-side prediction
+size_t encodePoseFrame(uint8_t* frame, uint16_t sequence, float relPitch, float relRoll, float relYaw) {
+  uint8_t flags = 0;
+  if (zeroSet) flags |= ORIENTATION_FLAG_ZERO_SET;
+  if (isDeviceIdle) flags |= ORIENTATION_FLAG_IDLE;
+  
+  encodeOrientationFrame(frame, sequence, currentSample.timestampUs, flags,
+                         relPitch, relRoll, relYaw,
+                         accumulatedPitch, accumulatedRoll, accumulatedYaw);
+  return appendOrientationRates(frame, sendPolicy.rate(0), sendPolicy.rate(1), sendPolicy.rate(2));
+}
+
+// Frame to the UDP subscribers; a lost frame is replaced by the next one, not resent
+void sendUdpPoseFrame(float relPitch, float relRoll, float relYaw) {
+  if (!poseStream.active()) return;
+  uint8_t frame[ORIENTATION_FRAME_RATES_SIZE];
+  size_t frameLength = encodePoseFrame(frame, ++udpSequence, relPitch, relRoll, relYaw);
+  // The hub merges nodes in its own clock; browsers keep the local timestamp
+  if (clockSync.synced()) {
+    setOrientationSharedTime(frame, clockSync.toShared(currentSample.timestampUs));
+  }
+  poseStream.send(frame, frameLength);
+  lastUdpFrameMicros = currentSample.timestampUs;
+}
+
+// "4210" or "192.168.1.20:4210"; without an IP the sender of the command subscribes
+bool parseUdpEndpoint(const String &spec, const IPAddress &defaultIp, IPAddress &ip, uint16_t &port) {
+  int colon = spec.lastIndexOf(':');
+  ip = defaultIp;
+  if (colon >= 0 && !ip.fromString(spec.substring(0, colon))) return false;
+  long value = spec.substring(colon + 1).toInt();
+  if (value <= 0 || value > 65535) return false;
+  port = (uint16_t)value;
+  return true;
+}
+
+String udpStatusJson() {
+  String json = "{\"type\":\"udp\",\"subscribers\":" + String(poseStream.subscriberCount());
+  json += ",\"multicast\":" + String(poseStream.multicastEnabled() ? "true" : "false");
+  json += ",\"sent\":" + String(poseStream.sentPackets());
+  json += ",\"failed\":" + String(poseStream.failedPackets());
+  json += ",\"leaseMs\":" + String(UDP_POSE_LEASE_MS) + "}";
+  return json;
+}
+
+// UDP stream control, shared by the WebSocket commands and the REST handlers:
+//   udpSubscribe:<port> | udpSubscribe:<ip>:<port>
+//   udpUnsubscribe | udpUnsubscribe:<port> | udpUnsubscribe:<ip>:<port>
+//   udpMulticast:<group>:<port> | udpMulticast:off
+//   udpStatus
+String handleUdpCommand(const String &command, const IPAddress &remoteIp) {
+  IPAddress ip;
+  uint16_t port;
+  if (command.startsWith("udpSubscribe:")) {
+    if (!parseUdpEndpoint(command.substring(13), remoteIp, ip, port)) {
+      return "{\"type\":\"error\",\"message\":\"Bad UDP endpoint\"}";
+    }
+    if (!poseStream.subscribe(ip, port, millis())) {
+      return "{\"type\":\"error\",\"message\":\"UDP subscriber table full\"}";
+    }
+    return "{\"type\":\"udpSubscribed\",\"ip\":\"" + ip.toString() + "\",\"port\":" + String(port) +
+           ",\"leaseMs\":" + String(UDP_POSE_LEASE_MS) + "}";
+  }
+  if (command.startsWith("udpUnsubscribe")) {
+    uint8_t removed;
+    if (command.length() > 15 && command.charAt(14) == ':') {
+      if (!parseUdpEndpoint(command.substring(15), remoteIp, ip, port)) {
+        return "{\"type\":\"error\",\"message\":\"Bad UDP endpoint\"}";
+      }
+      removed = poseStream.unsubscribe(ip, port);
+    } else {
+      removed = poseStream.unsubscribe(remoteIp, 0);
+    }
+    return "{\"type\":\"udpUnsubscribed\",\"removed\":" + String(removed) + "}";
+  }
+  if (command == "udpMulticast:off") {
+    poseStream.clearMulticast();
+    return "{\"type\":\"udpMulticast\",\"enabled\":false}";
+  }
+  if (command.startsWith("udpMulticast:")) {
+    if (!parseUdpEndpoint(command.substring(13), IPAddress(), ip, port) || ip[0] < 224 || ip[0] > 239) {
+      return "{\"type\":\"error\",\"message\":\"Bad multicast group\"}";
+    }
+    poseStream.setMulticast(ip, port, WiFi.localIP());
+    return "{\"type\":\"udpMulticast\",\"enabled\":true,\"group\":\"" + ip.toString() +
+           "\",\"port\":" + String(port) + "}";
   }
+  if (command == "udpStatus") {
+    return udpStatusJson();
+  }
+  return "{\"type\":\"error\",\"message\":\"Unknown UDP command\"}";
 }
 
 void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length) {
@@ -1550,15 +1627,18 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
         Serial.printf("🔌 [%u] Disconnected!\n", num);
       }
       clientConnected = (webSocket.connectedClients() > 0);
+      binaryClients[num] = false;
       break;
       
     case WStype_CONNECTED:
       {
+        binaryClients[num] = false;
         IPAddress ip = webSocket.remoteIP(num);
         if (serialMode) {
           Serial.printf("✅ [%u] Connected from %d.%d.%d.%d\n", num, ip[0], ip[1], ip[2], ip[3]);
         }
         clientConnected = true;
+        sendPolicy.invalidate();   // Full frame for the new client
         
         // Send welcome message
         String welcome = "{\"type\":\"status\",\"message\":\"Connected to MPU6050 Head Tracker with Gaze Direction\"}";
@@ -1589,12 +1669,13 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
       // Parse JSON message
       String message = String((char*)payload);
       
+      // UDP stream control (checked first: the other commands match by substring)
+      if (message.startsWith("udp")) {
+        webSocket.sendTXT(num, handleUdpCommand(message, webSocket.remoteIP(num)));
+      }
       // Handle recalibrate command
-      if (message.indexOf("recalibrate") != -1) {
-        calibrated = false;
-        calibrationStart = millis();
-        pitch = roll = yaw = 0;
-        yawDrift = 0;
+      else if (message.indexOf("recalibrate") != -1) {
+        tracker.startCalibration(millis());
         firstMeasurement = true;
         webSocket.sendTXT(num, "{\"type\":\"status\",\"message\":\"Recalibrating gyro...\"}");
         if (serialMode) {
@@ -1648,14 +1729,22 @@ void webSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length
           Serial.println("Accumulated angles reset");
         }
       }
+      // Handle frame format negotiation
+      else if (parseOrientationFormatRequest(message.c_str()) != ORIENTATION_FORMAT_NONE) {
+        OrientationFormatRequest format = parseOrientationFormatRequest(message.c_str());
+        binaryClients[num] = format == ORIENTATION_FORMAT_BINARY;
+        char reply[ORIENTATION_FORMAT_REPLY_SIZE];
+        size_t length = formatOrientationFormatReply(reply, sizeof(reply), format);
+        webSocket.sendTXT(num, reply, length);
+      }
       // Handle reset yaw command
       else if (message.indexOf("resetYaw") != -1) {
-        yaw = 0;
-        smoothedYaw = 0;
+        tracker.resetYaw();
         accumulatedYaw = 0;
         contYaw = 0;
         prevAbsYaw = 0;
         prevContYaw = 0;
+        sendPolicy.reset();
         webSocket.sendTXT(num, "{\"type\":\"status\",\"message\":\"Yaw reset\"}");
         if (serialMode) {
           Serial.println("Yaw reset");
@@ -1687,26 +1776,26 @@ void handleRoot() {
 
 void handleData() {
   // Calculate relative angles
-  float relPitch = calculateRelativeAngle(smoothedPitch, zeroPitch);
-  float relRoll = calculateRelativeAngle(smoothedRoll, zeroRoll);
-  float relYaw = calculateRelativeAngle(smoothedYaw, zeroYaw);
+  float relPitch = calculateRelativeAngle(tracker.smoothedPitch, zeroPitch);
+  float relRoll = calculateRelativeAngle(tracker.smoothedRoll, zeroRoll);
+  float relYaw = calculateRelativeAngle(tracker.smoothedYaw, zeroYaw);
   
   String json = "{";
   json += "\"pitch\":" + String(relPitch, 2) + ",";
   json += "\"roll\":" + String(relRoll, 2) + ",";
   json += "\"yaw\":" + String(relYaw, 2) + ",";
-  json += "\"absPitch\":" + String(smoothedPitch, 2) + ",";
-  json += "\"absRoll\":" + String(smoothedRoll, 2) + ",";
-  json += "\"absYaw\":" + String(smoothedYaw, 2) + ",";
+  json += "\"absPitch\":" + String(tracker.smoothedPitch, 2) + ",";
+  json += "\"absRoll\":" + String(tracker.smoothedRoll, 2) + ",";
+  json += "\"absYaw\":" + String(tracker.smoothedYaw, 2) + ",";
   json += "\"relPitch\":" + String(relPitch, 2) + ",";
   json += "\"relRoll\":" + String(relRoll, 2) + ",";
   json += "\"relYaw\":" + String(relYaw, 2) + ",";
   json += "\"accPitch\":" + String(accumulatedPitch, 2) + ",";
   json += "\"accRoll\":" + String(accumulatedRoll, 2) + ",";
   json += "\"accYaw\":" + String(accumulatedYaw, 2) + ",";
-  json += "\"gazePitch\":" + String(gazePitch, 2) + ",";
-  json += "\"gazeYaw\":" + String(gazeYaw, 2) + ",";
-  json += "\"gazeRoll\":" + String(gazeRoll, 2) + ",";
+  json += "\"gazePitch\":" + String(tracker.gazePitch, 2) + ",";
+  json += "\"gazeYaw\":" + String(tracker.gazeYaw, 2) + ",";
+  json += "\"gazeRoll\":" + String(tracker.gazeRoll, 2) + ",";
   json += "\"dirPitch\":" + String(pitchDirection) + ",";
   json += "\"dirRoll\":" + String(rollDirection) + ",";
   json += "\"dirYaw\":" + String(yawDirection) + ",";
@@ -1729,20 +1818,52 @@ void handleStatus() {
   json += "\"ssid\":\"" + String(ssid) + "\",";
   json += "\"signal\":" + String(WiFi.RSSI()) + ",";
   json += "\"clients\":" + String(webSocket.connectedClients()) + ",";
-  json += "\"calibrated\":" + String(calibrated ? "true" : "false") + ",";
+  json += "\"calibrated\":" + String(tracker.calibrated ? "true" : "false") + ",";
   json += "\"zeroSet\":" + String(zeroSet ? "true" : "false") + ",";
   json += "\"serialMode\":" + String(serialMode ? "true" : "false") + ",";
+  json += "\"clockSynced\":" + String(clockSync.synced() ? "true" : "false") + ",";
+  json += "\"clockOffsetUs\":" + String(clockSync.offset(), 0) + ",";
+  json += "\"clockDriftPpm\":" + String(clockSync.drift(), 1) + ",";
   json += "\"uptime\":" + String(millis());
   json += "}";
   
   server.send(200, "application/json", json);
 }
 
+// GET /udp/subscribe?port=4210[&ip=192.168.1.20] - without ip the caller subscribes
+void handleUdpSubscribe() {
+  String spec = server.hasArg("ip") ? server.arg("ip") + ":" + server.arg("port") : server.arg("port");
+  sendUdpReply(handleUdpCommand("udpSubscribe:" + spec, server.client().remoteIP()));
+}
+
+// GET /udp/unsubscribe[?port=4210][&ip=...] - without port every subscription of the address is removed
+void handleUdpUnsubscribe() {
+  String command = "udpUnsubscribe";
+  if (server.hasArg("port")) {
+    command += ":" + (server.hasArg("ip") ? server.arg("ip") + ":" : String("")) + server.arg("port");
+  }
+  sendUdpReply(handleUdpCommand(command, server.client().remoteIP()));
+}
+
+// GET /udp/multicast?group=239.1.2.3&port=4210, without group - off
+void handleUdpMulticast() {
+  String command = server.hasArg("group") ?
+                   "udpMulticast:" + server.arg("group") + ":" + server.arg("port") :
+                   String("udpMulticast:off");
+  sendUdpReply(handleUdpCommand(command, server.client().remoteIP()));
+}
+
+void handleUdpStatus() {
+  sendUdpReply(udpStatusJson());
+}
+
+void sendUdpReply(const String &json) {
+  server.sendHeader("Access-Control-Allow-Origin", "*");
+  server.send(json.indexOf("\"type\":\"error\"") != -1 ? 400 : 200, "application/json", json);
+}
+
 void handleRecalibrate() {
-  calibrated = false;
-  calibrationStart = millis();
-  pitch = roll = yaw = 0;
-  yawDrift = 0;
+  tracker.startCalibration(millis());
   firstMeasurement = true;
   
   String json = "{\"status\":\"recalibrating\",\"message\":\"Gyro recalibration started\"}";
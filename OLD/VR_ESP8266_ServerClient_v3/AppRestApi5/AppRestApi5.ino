@@ -29,36 +29,44 @@ void setup() {
   });
   
   // Пример 2: Loop обработчик WebSocket
+  // Вызывается сразу после прихода команды и раз в 100 мс для рассылки.
+  // Без delay(): пока он работает, остальные обработчики и сервер ждут
   wifiManager.webSocketLoop("/api/web_socket_loop", []() {
     static unsigned long lastBroadcast = 0;
+    static String command;             // буфер переходит в очередь и обратно
+    static WebSocketFrame<64> reply;   // ответ пишется сразу в кадр
     
     // Проверяем подключенных клиентов
     for (uint8_t i = 0; i < 10; i++) {
       if (wifiManager.isWebSocketClientConnected(i)) {
-        // Читаем команды из буфера
-        String command = wifiManager.readWebSocketCommand(i);
-        if (command.length() > 0) {
+        // Читаем все команды из буфера, а не по одной за вызов
+        while (wifiManager.readWebSocketCommand(i, command)) {
           // Обрабатываем команду
+          reply.clear();
           if (command == "GET_TEMP") {
             float temp = 25.0 + (random(0, 100) / 100.0); // Имитация температуры
-            wifiManager.sendWebSocketMessage(i, String("TEMP:") + String(temp));
+            reply.appendf("TEMP:%.2f", temp);
           } else if (command == "GET_HUMIDITY") {
             float humidity = 50.0 + (random(0, 100) / 100.0); // Имитация влажности
-            wifiManager.sendWebSocketMessage(i, String("HUMIDITY:") + String(humidity));
+            reply.appendf("HUMIDITY:%.2f", humidity);
+          }
+          if (reply.length() > 0) {
+            wifiManager.sendWebSocketFrame(i, reply);
           }
         }
       }
     }
     
-    // Периодическая рассылка данных всем клиентам
+    // Периодическая рассылка данных всем клиентам: заголовок кадра
+    // кодируется один раз, каждому клиенту - одна запись тех же байт
     if (millis() - lastBroadcast > 10000) { // Каждые 10 секунд
-      String broadcastMsg = String("BROADCAST: System time: ") + String(millis());
-      wifiManager.sendWebSocketBroadcast(broadcastMsg);
+      static WebSocketFrame<64> broadcastMsg;
+      broadcastMsg.clear();
+      broadcastMsg.appendf("BROADCAST: System time: %lu", millis());
+      wifiManager.broadcastWebSocketFrame(broadcastMsg);
       lastBroadcast = millis();
     }
-    
-    delay(100); // Небольшая пауза для экономии ресурсов
-  });
+  }, 100, LOOP_TRIGGER_PERIOD | LOOP_TRIGGER_MESSAGE | LOOP_TRIGGER_CONNECT);
   
   // Добавление кастомных маршрутов
   wifiManager.getServer().on("/api/custom", HTTP_GET, []() {
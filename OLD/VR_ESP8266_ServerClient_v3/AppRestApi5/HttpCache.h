@@ -0,0 +1,49 @@
+/*
+  Условный GET для статических страниц (RFC 7232, If-None-Match)
+
+  notModified() решает, можно ли ответить 304 вместо тела: заголовок
+  If-None-Match содержит "*" или хотя бы один тег из списка совпадает с
+  etag. Для If-None-Match сравнение слабое - префикс W/ игнорируется,
+  так что тег, который прокси пометил слабым, тоже подходит.
+  Без String и без выделения памяти: разбор идет прямо по строке заголовка.
+*/
+
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+#include <string.h>
+
+namespace HttpCache {
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+// ifNoneMatch - значение заголовка (может быть nullptr или пустым),
+// etag - тег в кавычках, как он уходит в заголовке ETag: "\"abc\""
+inline bool notModified(const char* ifNoneMatch, const char* etag) {
+  if (ifNoneMatch == nullptr || etag == nullptr) return false;
+  size_t etagLen = strlen(etag);
+  const char* p = ifNoneMatch;
+  while (*p) {
+    while (isSpace(*p) || *p == ',') p++;
+    if (*p == '\0') break;
+    if (*p == '*') return true;
+    if (p[0] == 'W' && p[1] == '/') p += 2;
+    // Тег в кавычках; запятая внутри кавычек - часть тега
+    const char* start = p;
+    if (*p == '"') {
+      p++;
+      while (*p && *p != '"') p++;
+      if (*p == '"') p++;
+    } else {
+      while (*p && *p != ',' && !isSpace(*p)) p++;
+    }
+    size_t len = p - start;
+    if (len == etagLen && strncmp(start, etag, len) == 0) return true;
+    while (*p && *p != ',') p++;
+  }
+  return false;
+}
+
+}  // namespace HttpCache
+
+#endif
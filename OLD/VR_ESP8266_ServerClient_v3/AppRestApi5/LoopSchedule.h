@@ -0,0 +1,82 @@
+/*
+  Расписание loop-обработчика WebSocket в WiFiManager
+
+  Раньше все loop-обработчики вызывались из update() раз в 5 с, вместе с
+  updateConnectedDevices(): команда в очереди ждала до 5 с, а delay() в
+  одном обработчике останавливал всех. Теперь update() на каждом проходе
+  спрашивает у расписания каждого обработчика, пора ли его звать:
+    - по периоду (periodMs, 0 - только по событиям);
+    - по событию: пришло сообщение на его путь, подключился клиент.
+  Планировщик кооперативный: обработчик не прерывается, поэтому он должен
+  быстро вернуться и не звать delay(). Время каждого вызова сравнивается
+  с бюджетом budgetUs; превышения считаются в статистике.
+
+  Время передается снаружи (millis()/micros() на устройстве), так что
+  расписание проверяется и на ПК.
+*/
+
+#ifndef LOOP_SCHEDULE_H
+#define LOOP_SCHEDULE_H
+
+#include <stdint.h>
+
+#define LOOP_TRIGGER_PERIOD   0x01
+#define LOOP_TRIGGER_MESSAGE  0x02  // сообщение в очередь клиента на этом пути
+#define LOOP_TRIGGER_CONNECT  0x04  // клиент подключился к этому пути
+
+struct LoopScheduleStats {
+  uint32_t runs;
+  uint32_t overruns;    // вызовы дольше бюджета
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+};
+
+class LoopSchedule {
+  public:
+    LoopSchedule(uint32_t periodMs = 0, uint8_t triggers = LOOP_TRIGGER_PERIOD, uint32_t budgetUs = 0)
+      : periodMs(periodMs), triggers(triggers), budgetUs(budgetUs) {
+      if (periodMs == 0) this->triggers &= ~LOOP_TRIGGER_PERIOD;
+    }
+
+    // Событие для обработчика; учитывается, только если он на него подписан
+    void signal(uint8_t trigger) {
+      if (triggers & trigger) pending = true;
+    }
+
+    bool due(unsigned long nowMs) const {
+      if (pending) return true;
+      return (triggers & LOOP_TRIGGER_PERIOD) && (long)(nowMs - nextRunMs) >= 0;
+    }
+
+    // После вызова: nowMs - момент начала, durationUs - сколько он занял.
+    // Вызов по событию период не сдвигает; отставший обработчик не
+    // догоняет пропущенные периоды пачкой
+    void ran(unsigned long nowMs, uint32_t durationUs) {
+      pending = false;
+      if ((triggers & LOOP_TRIGGER_PERIOD) && (long)(nowMs - nextRunMs) >= 0) {
+        nextRunMs += periodMs;
+        if ((long)(nowMs - nextRunMs) >= 0) nextRunMs = nowMs + periodMs;
+      }
+      stat.runs++;
+      stat.lastUs = durationUs;
+      stat.totalUs += durationUs;
+      if (durationUs > stat.maxUs) stat.maxUs = durationUs;
+      if (budgetUs > 0 && durationUs > budgetUs) stat.overruns++;
+    }
+
+    uint32_t period() const { return periodMs; }
+    uint32_t budget() const { return budgetUs; }
+    uint8_t triggerMask() const { return triggers; }
+    const LoopScheduleStats &stats() const { return stat; }
+
+  private:
+    uint32_t periodMs;
+    uint8_t triggers;
+    uint32_t budgetUs;
+    unsigned long nextRunMs = 0;
+    bool pending = false;
+    LoopScheduleStats stat = {0, 0, 0, 0, 0};
+};
+
+#endif
@@ -0,0 +1,207 @@
+/*
+  Очереди команд, маршруты и сборка фрагментов для WebSocket в WiFiManager
+
+  CommandQueue - кольцевой буфер команд одного клиента фиксированного
+  размера: push/pop за O(1) без сдвига и без перевыделения (строки в
+  ячейках обмениваются или пишутся поверх, и их буферы переиспользуются).
+  При переполнении - политика: выбросить самую старую команду или новую.
+  Счетчики: принято, выброшено, максимум заполнения.
+
+  WebSocketRoutes - таблица "клиент -> обработчик". Путь из URL
+  подключения сопоставляется с зарегистрированными путями один раз в
+  WStype_CONNECTED, дальше каждое сообщение уходит ровно одному
+  обработчику по индексу, без перебора.
+
+  FragmentBuffer - сборка фрагментированного сообщения
+  (WStype_FRAGMENT_*_START / FRAGMENT / FRAGMENT_FIN) в заранее выделенный
+  буфер. Собирается одно сообщение за раз; фрагменты другого клиента и
+  сообщения длиннее буфера отбрасываются целиком и считаются.
+
+  Строка - параметр шаблона (String на устройстве, std::string на ПК),
+  остальное не зависит от Arduino, поэтому тот же код гоняет
+  Benchmark/ws_dispatch на ПК.
+*/
+
+#ifndef WEB_SOCKET_DISPATCH_H
+#define WEB_SOCKET_DISPATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <utility>
+
+#define WS_DISPATCH_MAX_CLIENTS  10
+#define WS_DISPATCH_NO_ROUTE     0xFF
+
+enum CommandQueuePolicy {
+  QUEUE_DROP_OLDEST,  // свежая команда важнее (управление, запросы данных)
+  QUEUE_DROP_NEWEST   // сохранить порядок уже принятых
+};
+
+struct CommandQueueStats {
+  uint32_t pushed;
+  uint32_t dropped;
+  uint16_t highWater;
+};
+
+template <class StringType, size_t SIZE>
+class CommandQueue {
+  public:
+    CommandQueue() { clear(); }
+
+    void setPolicy(CommandQueuePolicy newPolicy) { policy = newPolicy; }
+
+    // false - команда не принята (очередь полна, QUEUE_DROP_NEWEST)
+    bool push(StringType &command) {
+      StringType* slot = reserve();
+      if (slot == nullptr) return false;
+      std::swap(*slot, command);
+      return true;
+    }
+
+    // Копия текста в буфер ячейки: после прогрева без выделения памяти
+    bool push(const char* command) {
+      StringType* slot = reserve();
+      if (slot == nullptr) return false;
+      *slot = command;
+      return true;
+    }
+
+    bool pop(StringType &command) {
+      if (count == 0) return false;
+      std::swap(command, slots[head]);
+      head = (head + 1) % SIZE;
+      count--;
+      return true;
+    }
+
+    void clear() {
+      head = 0;
+      count = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static size_t capacity() { return SIZE; }
+    const CommandQueueStats &stats() const { return stat; }
+
+  private:
+    StringType slots[SIZE];
+    size_t head;
+    size_t count;
+    CommandQueuePolicy policy = QUEUE_DROP_OLDEST;
+    CommandQueueStats stat = {0, 0, 0};
+
+    StringType* reserve() {
+      stat.pushed++;
+      if (count == SIZE) {
+        stat.dropped++;
+        if (policy == QUEUE_DROP_NEWEST) return nullptr;
+        head = (head + 1) % SIZE;
+        count--;
+      }
+      StringType* slot = &slots[(head + count) % SIZE];
+      count++;
+      if (count > stat.highWater) stat.highWater = count;
+      return slot;
+    }
+};
+
+class WebSocketRoutes {
+  public:
+    WebSocketRoutes() { clear(); }
+
+    // Путь URL подключения ("/api/x?token=1") совпадает с route ("/api/x")
+    static bool pathMatches(const char* url, const char* route) {
+      if (url == nullptr || route == nullptr) return false;
+      size_t len = strlen(route);
+      if (strncmp(url, route, len) != 0) return false;
+      return url[len] == '\0' || url[len] == '?' || url[len] == '#';
+    }
+
+    void bind(uint8_t client, uint8_t route) {
+      if (client < WS_DISPATCH_MAX_CLIENTS) routes[client] = route;
+    }
+
+    void unbind(uint8_t client) { bind(client, WS_DISPATCH_NO_ROUTE); }
+
+    uint8_t route(uint8_t client) const {
+      return client < WS_DISPATCH_MAX_CLIENTS ? routes[client] : WS_DISPATCH_NO_ROUTE;
+    }
+
+    void clear() { memset(routes, WS_DISPATCH_NO_ROUTE, sizeof(routes)); }
+
+  private:
+    uint8_t routes[WS_DISPATCH_MAX_CLIENTS];
+};
+
+struct FragmentStats {
+  uint32_t assembled;
+  uint32_t overflowed;
+  uint32_t interleaved;
+};
+
+template <size_t SIZE>
+class FragmentBuffer {
+  public:
+    // Первый фрагмент; false - буфер занят другим клиентом или мал
+    bool start(uint8_t client, bool text, const uint8_t* data, size_t length) {
+      if (busy && client != owner) {
+        stat.interleaved++;
+        return false;
+      }
+      busy = true;
+      overflow = false;
+      owner = client;
+      isText = text;
+      used = 0;
+      return append(client, data, length);
+    }
+
+    bool append(uint8_t client, const uint8_t* data, size_t length) {
+      if (!busy || client != owner || overflow) return false;
+      if (used + length > SIZE - 1) {
+        overflow = true;
+        return false;
+      }
+      memcpy(buffer + used, data, length);
+      used += length;
+      return true;
+    }
+
+    // Последний фрагмент. true - сообщение собрано: data()/length()
+    // действительны до следующего start(); текст завершен нулем
+    bool finish(uint8_t client, const uint8_t* data, size_t length) {
+      if (!busy || client != owner) return false;
+      bool ok = append(client, data, length);
+      busy = false;
+      if (!ok) {
+        stat.overflowed++;
+        return false;
+      }
+      buffer[used] = '\0';
+      stat.assembled++;
+      return true;
+    }
+
+    // Клиент отключился посреди сообщения
+    void abandon(uint8_t client) {
+      if (busy && client == owner) busy = false;
+    }
+
+    const char* data() const { return buffer; }
+    size_t length() const { return used; }
+    bool text() const { return isText; }
+    const FragmentStats &stats() const { return stat; }
+
+  private:
+    char buffer[SIZE];
+    size_t used = 0;
+    uint8_t owner = WS_DISPATCH_NO_ROUTE;
+    bool busy = false;
+    bool overflow = false;
+    bool isText = true;
+    FragmentStats stat = {0, 0, 0};
+};
+
+#endif
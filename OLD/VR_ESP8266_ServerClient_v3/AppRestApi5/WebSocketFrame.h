@@ -0,0 +1,135 @@
+/*
+  Готовый WebSocket-кадр и невладеющий вид на входящее сообщение
+
+  WebSocketFrame - буфер фиксированного размера с запасом
+  WEBSOCKETS_MAX_HEADER_SIZE перед данными. Сообщение пишется прямо в
+  буфер (append/appendf), finish() один раз кладет перед ним заголовок
+  кадра сервера (FIN, опкод, длина, без маски), и готовые байты wire()
+  уходят каждому клиенту одним write() без malloc и без копии. Раньше
+  sendWebSocketMessage()/sendWebSocketBroadcast() копировали String, а
+  библиотека для каждого клиента еще выделяла буфер под заголовок + данные.
+
+  WebSocketMessage - указатель и длина входящего текста: обработчик
+  читает payload библиотеки (или собранный FragmentBuffer) на месте, без
+  String((char*)payload) на каждое сообщение. Действителен только внутри
+  вызова обработчика.
+
+  Не зависит от Arduino и WebSocketsServer - тот же код собирается в
+  Benchmark/ws_dispatch.
+*/
+
+#ifndef WEB_SOCKET_FRAME_H
+#define WEB_SOCKET_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef WEBSOCKETS_MAX_HEADER_SIZE
+#define WEBSOCKETS_MAX_HEADER_SIZE 14
+#endif
+
+#define WS_FRAME_OPCODE_TEXT    0x1
+#define WS_FRAME_OPCODE_BINARY  0x2
+
+struct WebSocketMessage {
+  const char* data;     // завершен нулем (так отдает библиотека и FragmentBuffer)
+  size_t length;
+
+  bool equals(const char* text) const {
+    return strlen(text) == length && memcmp(data, text, length) == 0;
+  }
+
+  bool startsWith(const char* prefix) const {
+    size_t prefixLength = strlen(prefix);
+    return prefixLength <= length && memcmp(data, prefix, prefixLength) == 0;
+  }
+};
+
+template <size_t SIZE>
+class WebSocketFrame {
+  public:
+    WebSocketFrame() { clear(); }
+
+    void clear() {
+      used = 0;
+      headerSize = 0;
+      overflow = false;
+      buffer[WEBSOCKETS_MAX_HEADER_SIZE] = '\0';
+    }
+
+    bool append(const uint8_t* data, size_t length) {
+      if (overflow || used + length > SIZE) {
+        overflow = true;
+        return false;
+      }
+      memcpy(buffer + WEBSOCKETS_MAX_HEADER_SIZE + used, data, length);
+      used += length;
+      buffer[WEBSOCKETS_MAX_HEADER_SIZE + used] = '\0';
+      headerSize = 0;
+      return true;
+    }
+
+    bool append(const char* text) { return append((const uint8_t*)text, strlen(text)); }
+
+    bool appendf(const char* format, ...) {
+      if (overflow) return false;
+      char* out = (char*)buffer + WEBSOCKETS_MAX_HEADER_SIZE + used;
+      va_list args;
+      va_start(args, format);
+      int written = vsnprintf(out, SIZE - used + 1, format, args);
+      va_end(args);
+      if (written < 0 || used + (size_t)written > SIZE) {
+        out[0] = '\0';
+        overflow = true;
+        return false;
+      }
+      used += written;
+      headerSize = 0;
+      return true;
+    }
+
+    // Заголовок кадра сервера перед данными; false - данные не влезли
+    bool finish(uint8_t opcode = WS_FRAME_OPCODE_TEXT) {
+      if (overflow) return false;
+      uint8_t header[WEBSOCKETS_MAX_HEADER_SIZE];
+      header[0] = 0x80 | (opcode & 0x0F);
+      if (used < 126) {
+        header[1] = (uint8_t)used;
+        headerSize = 2;
+      } else if (used <= 0xFFFF) {
+        header[1] = 126;
+        header[2] = (uint8_t)(used >> 8);
+        header[3] = (uint8_t)used;
+        headerSize = 4;
+      } else {
+        header[1] = 127;
+        uint64_t length = used;
+        for (int i = 0; i < 8; i++) header[2 + i] = (uint8_t)(length >> (8 * (7 - i)));
+        headerSize = 10;
+      }
+      memcpy(buffer + WEBSOCKETS_MAX_HEADER_SIZE - headerSize, header, headerSize);
+      return true;
+    }
+
+    bool finished() const { return headerSize > 0; }
+
+    // Кадр целиком (после finish()): заголовок + данные
+    uint8_t* wire() { return buffer + WEBSOCKETS_MAX_HEADER_SIZE - headerSize; }
+    size_t wireLength() const { return headerSize + used; }
+
+    // Данные без заголовка
+    const char* c_str() const { return (const char*)buffer + WEBSOCKETS_MAX_HEADER_SIZE; }
+    size_t length() const { return used; }
+    static size_t capacity() { return SIZE; }
+
+  private:
+    uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE + SIZE + 1];
+    size_t used;
+    size_t headerSize;
+    bool overflow;
+};
+
+#endif
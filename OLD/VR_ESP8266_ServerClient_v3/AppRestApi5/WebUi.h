@@ -0,0 +1,332 @@
+/*
+  Сгенерировано webui/build_webui.py из webui/index.html - не править вручную
+  Исходник: 23705 байт, gzip: 5054 байт
+*/
+
+#ifndef WEB_UI_H
+#define WEB_UI_H
+
+#include <Arduino.h>
+
+static const char WEB_UI_INDEX_ETAG[] = "\"27a4c22ef20712b2\"";
+static const size_t WEB_UI_INDEX_GZ_LEN = 5054;
+static const uint8_t WEB_UI_INDEX_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xdd, 0x3c, 0xfd, 0x73, 0xdb, 0xc6,
+  0x95, 0xbf, 0xfb, 0xaf, 0xd8, 0x30, 0xad, 0x41, 0x8e, 0xf9, 0x21, 0xca, 0x92, 0xad, 0x90, 0x94,
+  0x32, 0x8e, 0x2c, 0xcf, 0xe9, 0x26, 0xb2, 0x35, 0x23, 0xe5, 0x9c, 0x5e, 0xa7, 0xe7, 0x82, 0xc0,
+  0x52, 0x44, 0x0d, 0x02, 0x2c, 0x00, 0x4a, 0x56, 0x1c, 0xce, 0xc4, 0x4a, 0x93, 0x5c, 0xc7, 0x99,
+  0xfa, 0xe6, 0x26, 0x33, 0xd7, 0xb9, 0xb9, 0xd6, 0xd7, 0xb9, 0x7f, 0x40, 0x76, 0xac, 0x44, 0xf1,
+  0x87, 0xfc, 0x2f, 0x80, 0xff, 0x51, 0xdf, 0xdb, 0xc5, 0x37, 0x16, 0x20, 0x48, 0x29, 0xbd, 0xb4,
+  0xd2, 0x24, 0xa6, 0x80, 0xdd, 0xb7, 0xef, 0xbd, 0x7d, 0xdf, 0xfb, 0x96, 0x9d, 0x77, 0x6e, 0xde,
+  0x59, 0xdf, 0xfd, 0xc5, 0xf6, 0x06, 0xe9, 0x3b, 0x03, 0x7d, 0xed, 0x52, 0xc7, 0xff, 0x87, 0xca,
+  0xea, 0xda, 0x25, 0x02, 0x3f, 0x1d, 0x47, 0x73, 0x74, 0xba, 0xb6, 0xb1, 0xb3, 0xbd, 0xb2, 0x78,
+  0xed, 0x1a, 0x59, 0x37, 0x8d, 0x9e, 0xb6, 0x37, 0xb2, 0x64, 0x47, 0x33, 0x8d, 0x4e, 0x83, 0xbf,
+  0xe4, 0x03, 0x07, 0xd4, 0x91, 0x89, 0xd2, 0x97, 0x2d, 0x9b, 0x3a, 0xab, 0xa5, 0x8f, 0x76, 0x6f,
+  0xd5, 0x56, 0x4a, 0xd1, 0x57, 0x86, 0x3c, 0xa0, 0xab, 0xa5, 0x7d, 0x8d, 0x1e, 0x0c, 0x4d, 0xcb,
+  0x29, 0x11, 0xc5, 0x34, 0x1c, 0x6a, 0xc0, 0xd0, 0x03, 0x4d, 0x75, 0xfa, 0xab, 0x2a, 0xdd, 0xd7,
+  0x14, 0x5a, 0x63, 0x7f, 0x54, 0x89, 0x66, 0x68, 0x8e, 0x26, 0xeb, 0x35, 0x5b, 0x91, 0x75, 0xba,
+  0xda, 0xac, 0x2f, 0xf8, 0xa0, 0x6c, 0xe7, 0xd0, 0x5f, 0x11, 0x7f, 0xba, 0xa6, 0x7a, 0x48, 0x1e,
+  0x92, 0x1e, 0xc0, 0xaa, 0xf5, 0xe4, 0x81, 0xa6, 0x1f, 0xb6, 0xc8, 0x0d, 0x0b, 0x66, 0x56, 0x89,
+  0x2d, 0x1b, 0x76, 0xcd, 0xa6, 0x96, 0xd6, 0x6b, 0x93, 0x81, 0x6c, 0xed, 0x69, 0x46, 0x8b, 0x2c,
+  0xb4, 0xc9, 0x50, 0x56, 0x55, 0xcd, 0xd8, 0x6b, 0x91, 0xc5, 0x85, 0xe1, 0x83, 0x36, 0xe9, 0xca,
+  0xca, 0xfd, 0x3d, 0xcb, 0x1c, 0x19, 0x6a, 0x4d, 0x31, 0x75, 0xd3, 0x6a, 0x91, 0x77, 0x7b, 0xcb,
+  0xf8, 0xdb, 0x26, 0xe3, 0x60, 0x95, 0x3a, 0xe2, 0x2a, 0x6b, 0x06, 0xb5, 0x60, 0xad, 0x81, 0xfc,
+  0x80, 0x63, 0xd9, 0x22, 0x2b, 0x0b, 0x0c, 0x46, 0x00, 0x9d, 0xc8, 0x23, 0xc7, 0x8c, 0xc2, 0x6c,
+  0x91, 0x83, 0xbe, 0xe6, 0xd0, 0xf4, 0xaa, 0xa6, 0xa5, 0x52, 0xab, 0x66, 0xc9, 0xaa, 0x36, 0xb2,
+  0x5b, 0xa4, 0xe9, 0x3d, 0x7c, 0x50, 0xb3, 0xfb, 0xb2, 0x6a, 0x1e, 0x20, 0xa8, 0xc5, 0xe1, 0x03,
+  0xf6, 0x9c, 0x58, 0x7b, 0x5d, 0xb9, 0xbc, 0x50, 0x65, 0xbf, 0xf5, 0x66, 0x25, 0x86, 0x97, 0x23,
+  0x77, 0x01, 0x23, 0x73, 0x9f, 0x5a, 0x3d, 0x1d, 0xa7, 0xf5, 0x35, 0x55, 0xa5, 0x86, 0x0f, 0x1f,
+  0x00, 0xc3, 0x7c, 0xdb, 0xd4, 0x35, 0x95, 0xbc, 0xab, 0x28, 0x8a, 0x98, 0xda, 0x26, 0xfe, 0xa6,
+  0x50, 0x5a, 0x86, 0x99, 0xf8, 0xdf, 0x02, 0xf2, 0x2c, 0xb1, 0x62, 0x77, 0xe4, 0x38, 0xa6, 0x01,
+  0x0b, 0xa7, 0xc1, 0x69, 0x46, 0x1f, 0x38, 0xee, 0xb4, 0x09, 0xe0, 0x23, 0x3b, 0x2d, 0xa2, 0xd3,
+  0x9e, 0x13, 0xa2, 0x63, 0x98, 0x06, 0xf0, 0xc2, 0x1c, 0x39, 0x3a, 0xf0, 0xd2, 0xff, 0x53, 0x19,
+  0x59, 0x36, 0x4e, 0x1d, 0x9a, 0x1a, 0x08, 0x84, 0x15, 0xe1, 0x55, 0x73, 0x09, 0x79, 0x70, 0x0d,
+  0x79, 0xe3, 0x58, 0xb0, 0x9b, 0x1a, 0x0a, 0x1d, 0xf0, 0xa6, 0x7e, 0xd5, 0x6e, 0xf3, 0x2d, 0xb7,
+  0xb5, 0x4f, 0x00, 0x4e, 0xf3, 0x3a, 0x0e, 0x11, 0x22, 0xd9, 0xea, 0x23, 0x73, 0x84, 0xa8, 0xbe,
+  0xab, 0xaa, 0x6a, 0xc6, 0xac, 0xba, 0xac, 0x38, 0xda, 0x3e, 0x15, 0x4f, 0x5b, 0x5a, 0xbf, 0x71,
+  0x6b, 0x19, 0x98, 0xe2, 0xfd, 0xed, 0x6d, 0x70, 0x1c, 0x8e, 0x27, 0xdb, 0x00, 0x40, 0xd5, 0xec,
+  0xa1, 0x2e, 0x1f, 0xfa, 0xc4, 0x0a, 0xe5, 0x40, 0xb0, 0x4f, 0x7c, 0x33, 0x1c, 0x73, 0xe8, 0x4f,
+  0x4c, 0x6c, 0x0f, 0x6c, 0x8b, 0xbf, 0x45, 0xb1, 0xb5, 0x7b, 0xa6, 0x35, 0xa8, 0x21, 0xc2, 0x43,
+  0x26, 0xa9, 0x28, 0x97, 0xb5, 0xae, 0x09, 0x34, 0x0d, 0x60, 0x91, 0xc4, 0x60, 0x5d, 0xee, 0x52,
+  0x3d, 0x8a, 0x62, 0x57, 0x37, 0x95, 0xfb, 0xed, 0xe4, 0x34, 0x36, 0x8b, 0x71, 0xfb, 0x80, 0x6a,
+  0x7b, 0x7d, 0xd8, 0xd4, 0xae, 0xa9, 0xc7, 0x38, 0xa7, 0x19, 0xc3, 0x91, 0x03, 0x0a, 0x47, 0x75,
+  0xaa, 0xc0, 0xbf, 0x0e, 0x7d, 0xe0, 0xc8, 0x16, 0x95, 0x01, 0xb4, 0xa7, 0x27, 0xcd, 0x85, 0x85,
+  0x9f, 0x47, 0x68, 0x5f, 0xc9, 0x20, 0x9d, 0x6d, 0x48, 0x82, 0xd0, 0xa5, 0x40, 0x33, 0xb4, 0x4f,
+  0xd8, 0x64, 0xef, 0x3d, 0x3c, 0x8a, 0xa2, 0x90, 0x23, 0x92, 0x19, 0x1b, 0x16, 0x4a, 0x19, 0x2a,
+  0x19, 0xe7, 0x4d, 0x5c, 0x4e, 0x45, 0x98, 0xa4, 0x84, 0xd5, 0xd7, 0xfd, 0x04, 0x6f, 0xa7, 0x4b,
+  0xdf, 0xd2, 0xb2, 0xbc, 0xb0, 0xf4, 0x5e, 0x74, 0x0e, 0xc8, 0x8d, 0x4e, 0x93, 0x4c, 0xf3, 0x90,
+  0x80, 0x59, 0xba, 0x3c, 0xb4, 0x41, 0xd8, 0xfd, 0x4f, 0xc1, 0x3e, 0x31, 0x21, 0xe1, 0x16, 0x24,
+  0x02, 0x0b, 0x6c, 0xa8, 0xa3, 0xe2, 0xca, 0x19, 0x6c, 0x8e, 0x6f, 0x06, 0x6e, 0x59, 0x4d, 0xd6,
+  0xb5, 0x3d, 0xc3, 0x57, 0xd9, 0x28, 0x28, 0x31, 0x01, 0xbd, 0x45, 0xfc, 0x8d, 0x49, 0xdf, 0xc0,
+  0x54, 0x65, 0x5d, 0x20, 0xf4, 0xa6, 0xaf, 0xba, 0x3d, 0xed, 0x01, 0x85, 0xc5, 0x3f, 0xa9, 0x69,
+  0x86, 0x4a, 0x1f, 0x00, 0x56, 0x6d, 0xb6, 0x1c, 0x33, 0xcc, 0x8c, 0x0e, 0xf8, 0x37, 0x46, 0x7e,
+  0xdf, 0x13, 0x39, 0x8f, 0x19, 0x29, 0x2c, 0x62, 0xc6, 0x71, 0xa9, 0x92, 0xc6, 0xa6, 0x16, 0xaa,
+  0xa2, 0x88, 0x06, 0x8a, 0xbf, 0xe1, 0x2e, 0x36, 0x97, 0x7f, 0xee, 0xd9, 0xf0, 0xe9, 0x8a, 0xba,
+  0xb2, 0xb2, 0x12, 0x20, 0xbb, 0x82, 0xd8, 0x45, 0x1c, 0xc3, 0xf2, 0x82, 0xc8, 0xcc, 0x27, 0x95,
+  0x55, 0xd1, 0x4d, 0x1b, 0x37, 0xdc, 0xc7, 0x46, 0x96, 0xe5, 0xc0, 0x70, 0x5a, 0x48, 0x77, 0xcc,
+  0xca, 0x2d, 0xae, 0x64, 0x28, 0x62, 0x4a, 0x26, 0x93, 0x4b, 0x04, 0x62, 0xe8, 0x2d, 0xd4, 0xd5,
+  0x65, 0xd4, 0xf3, 0xc8, 0xb0, 0x03, 0xad, 0xa7, 0xd5, 0x0c, 0xea, 0x1c, 0x98, 0xd6, 0xfd, 0x22,
+  0x42, 0xd3, 0x8c, 0xf9, 0x3d, 0xe6, 0x27, 0xc4, 0xfa, 0x92, 0x5c, 0x03, 0x76, 0xc3, 0x00, 0x23,
+  0x41, 0x55, 0xf1, 0x7e, 0xd0, 0x95, 0xde, 0x32, 0x5d, 0x49, 0x4f, 0x03, 0x81, 0x9a, 0x32, 0x53,
+  0xe0, 0xb4, 0x51, 0x9f, 0x34, 0xe3, 0xbe, 0x9d, 0x43, 0xb7, 0x07, 0x14, 0x64, 0xb3, 0x66, 0x3b,
+  0xb2, 0x33, 0xb2, 0x01, 0x78, 0x82, 0x48, 0x11, 0x55, 0x81, 0xb8, 0x2c, 0x70, 0xca, 0xd3, 0x10,
+  0xb3, 0xd0, 0x54, 0x97, 0xa8, 0xaa, 0xca, 0x81, 0x2d, 0x7a, 0xb7, 0xb9, 0xbc, 0x7c, 0x7d, 0x71,
+  0x29, 0x06, 0xa1, 0x00, 0xad, 0x2b, 0xea, 0xf5, 0x28, 0x90, 0xeb, 0x8b, 0x4d, 0x25, 0x04, 0xd2,
+  0x69, 0x44, 0x62, 0xa4, 0x8e, 0xad, 0x58, 0xda, 0xd0, 0x09, 0x03, 0xa6, 0x46, 0x83, 0xdc, 0xa5,
+  0xdd, 0x1d, 0x30, 0xf4, 0xd4, 0x21, 0x93, 0xdf, 0x4d, 0x3e, 0x77, 0xdf, 0xb8, 0x2f, 0x27, 0x5f,
+  0xba, 0xa7, 0xee, 0x29, 0x71, 0x5f, 0xb8, 0xaf, 0x26, 0x4f, 0x88, 0x7b, 0x36, 0x79, 0x04, 0x4f,
+  0xcf, 0xdc, 0xe7, 0xec, 0xff, 0x3f, 0x90, 0xc9, 0xa3, 0xc9, 0xd1, 0xe4, 0x33, 0xf7, 0x18, 0xfe,
+  0x3c, 0x9d, 0x7c, 0x39, 0x79, 0x1c, 0x7a, 0x10, 0x80, 0x31, 0x80, 0xb8, 0xe8, 0xee, 0x0e, 0x59,
+  0x25, 0xc6, 0x48, 0xd7, 0xdb, 0xc1, 0xab, 0xe0, 0x43, 0x6f, 0x64, 0x30, 0x06, 0x13, 0x8f, 0xa8,
+  0x2d, 0x1c, 0xef, 0x63, 0x50, 0xae, 0x90, 0x87, 0xc1, 0x48, 0xfc, 0x81, 0x41, 0xb6, 0x43, 0x0e,
+  0xec, 0x8f, 0x2c, 0x1d, 0x40, 0x4a, 0x07, 0x76, 0xab, 0xd1, 0x90, 0xc8, 0x15, 0xd0, 0x33, 0x03,
+  0xe2, 0xa2, 0x3a, 0x38, 0x28, 0x16, 0x79, 0xd6, 0xfb, 0xa6, 0xed, 0x60, 0x40, 0x09, 0xaf, 0xa4,
+  0xd6, 0x4a, 0xb3, 0x21, 0x0f, 0xb5, 0xc6, 0x01, 0xed, 0xde, 0xb3, 0x19, 0x58, 0xa9, 0x1d, 0x03,
+  0x1a, 0xa2, 0x48, 0x0f, 0x42, 0xea, 0xcb, 0x6c, 0x95, 0x4a, 0x7c, 0xa8, 0x60, 0x5e, 0xdd, 0x34,
+  0xcc, 0x21, 0x35, 0x60, 0xba, 0x4f, 0x4a, 0x0a, 0x6b, 0x1f, 0x73, 0x53, 0xa7, 0x80, 0xe2, 0x5e,
+  0x59, 0x42, 0x22, 0x23, 0x7c, 0x0e, 0xf6, 0x53, 0x4a, 0x2c, 0x87, 0x3f, 0xa3, 0xa1, 0x2a, 0x3b,
+  0x34, 0x18, 0xbc, 0xc3, 0xe4, 0xb0, 0x2c, 0x65, 0xce, 0x19, 0x17, 0xc1, 0x98, 0x9b, 0x96, 0x73,
+  0xa0, 0x1c, 0x95, 0xc2, 0x19, 0xb0, 0x9e, 0x36, 0x0d, 0xc4, 0xcf, 0x7d, 0x0a, 0x42, 0xf5, 0x76,
+  0xf2, 0x78, 0x72, 0xe4, 0xbe, 0x74, 0x8f, 0x89, 0xfb, 0xd6, 0x3d, 0x01, 0xe1, 0x3a, 0x81, 0x7f,
+  0xcf, 0x40, 0x00, 0x5f, 0x82, 0x08, 0xfe, 0x61, 0xf2, 0x15, 0xfc, 0x8d, 0xc2, 0xf6, 0x84, 0xe0,
+  0x47, 0xf6, 0xfa, 0x7b, 0x72, 0x15, 0x04, 0x11, 0x3e, 0xbc, 0x64, 0x32, 0xfb, 0x22, 0x22, 0x86,
+  0xfe, 0x0f, 0x24, 0x1e, 0xbb, 0xda, 0x80, 0x42, 0x7c, 0x59, 0x16, 0x09, 0x5b, 0x95, 0x5c, 0x5d,
+  0x58, 0x58, 0x98, 0x87, 0x9b, 0x03, 0x6a, 0xdb, 0xf2, 0x5e, 0x8c, 0x9f, 0x74, 0x1f, 0x9c, 0xca,
+  0x54, 0xa6, 0x86, 0xfc, 0xf4, 0x40, 0xb4, 0xa4, 0x2a, 0x61, 0x53, 0xeb, 0xc0, 0x3e, 0x59, 0xc0,
+  0xa0, 0xbe, 0x6c, 0xa8, 0x7a, 0xc8, 0xd7, 0x2d, 0x3e, 0xad, 0x9c, 0x39, 0xa7, 0x10, 0xfe, 0xd4,
+  0xb2, 0x4c, 0x2b, 0x86, 0x3d, 0x3e, 0xc8, 0xc3, 0x9e, 0x0d, 0x88, 0xe2, 0xcf, 0x1e, 0x30, 0xec,
+  0xd9, 0xd4, 0xc2, 0x02, 0xc1, 0x86, 0xe7, 0x88, 0xf0, 0x38, 0xc7, 0x62, 0x88, 0x41, 0x72, 0x43,
+  0x2d, 0x36, 0x1c, 0xfc, 0xdd, 0x86, 0x4e, 0x07, 0xe8, 0xf2, 0x57, 0x89, 0x6a, 0x2a, 0x23, 0xfc,
+  0x58, 0xdf, 0xa3, 0x8e, 0xf7, 0xf4, 0x83, 0xc3, 0x4d, 0xb5, 0x2c, 0x81, 0xad, 0xb0, 0x23, 0x40,
+  0x93, 0x08, 0x6a, 0x3d, 0x52, 0x8e, 0xc1, 0x12, 0xf1, 0x2a, 0x36, 0xa0, 0x8e, 0x21, 0xd4, 0xba,
+  0x17, 0x6b, 0x80, 0xe5, 0x0a, 0xb0, 0x6e, 0x11, 0xb4, 0x5f, 0x7c, 0x6c, 0x7b, 0x0a, 0x0c, 0x45,
+  0x97, 0x6d, 0xfb, 0x36, 0x9a, 0x35, 0x80, 0x90, 0xf6, 0x4d, 0x08, 0x28, 0x05, 0x01, 0x7f, 0x3c,
+  0x5c, 0xc9, 0xea, 0x6a, 0x38, 0x0f, 0xf4, 0x8f, 0xbc, 0x1f, 0xfb, 0x0b, 0x30, 0xc9, 0x53, 0xcf,
+  0x71, 0xa1, 0x3d, 0xc9, 0x90, 0x4f, 0x4f, 0xbc, 0x93, 0x6c, 0x42, 0x75, 0xff, 0xb3, 0xfb, 0x8c,
+  0x39, 0x8f, 0x67, 0xe0, 0x57, 0x3c, 0x95, 0x7f, 0x3e, 0xf9, 0x02, 0x95, 0x7d, 0xf2, 0x64, 0xf2,
+  0x7b, 0x50, 0xf2, 0x2f, 0x50, 0xaf, 0xcf, 0xe0, 0xf7, 0x19, 0xfc, 0xc9, 0xf4, 0x1e, 0x7c, 0x4e,
+  0xb0, 0x42, 0x0a, 0xde, 0xff, 0xc0, 0xc8, 0xef, 0xd0, 0x33, 0xa1, 0xbf, 0x82, 0x49, 0x00, 0xfa,
+  0x39, 0x40, 0x39, 0x9a, 0x7c, 0x8d, 0x70, 0x9e, 0xc3, 0x2a, 0x7f, 0x20, 0xee, 0x2b, 0x78, 0xf3,
+  0x2d, 0x00, 0x02, 0x63, 0x41, 0xdc, 0xef, 0x61, 0xe0, 0x09, 0x38, 0xb1, 0xaf, 0x53, 0x7b, 0xec,
+  0xa1, 0x5d, 0x07, 0xfe, 0x59, 0x8e, 0x7d, 0x57, 0x73, 0xfa, 0x65, 0xe9, 0xe6, 0xc6, 0xbf, 0x6c,
+  0xae, 0x6f, 0xdc, 0xfb, 0x68, 0xfb, 0xe6, 0x8d, 0xdd, 0x0d, 0xa9, 0x22, 0xda, 0x79, 0x08, 0xd1,
+  0xd4, 0x75, 0x9f, 0x8f, 0x37, 0x59, 0xe1, 0xc2, 0x2e, 0x27, 0xd9, 0x49, 0xa8, 0x0e, 0x26, 0x38,
+  0x6b, 0x95, 0xbb, 0x9b, 0xb7, 0x36, 0xef, 0xed, 0xac, 0xdf, 0xb8, 0xdd, 0x52, 0x41, 0x3f, 0xa5,
+  0x0a, 0xf9, 0xf4, 0x53, 0x92, 0x3f, 0xae, 0x27, 0x6b, 0x3a, 0xee, 0x5a, 0x16, 0x42, 0x77, 0xb5,
+  0x5b, 0xda, 0x6d, 0x1e, 0xc2, 0xcd, 0x85, 0xcc, 0xfa, 0x9d, 0xdb, 0xb7, 0x37, 0xd6, 0x77, 0x5b,
+  0xf9, 0x2b, 0x78, 0x4a, 0x38, 0x97, 0xec, 0xd8, 0xd4, 0x50, 0x8b, 0x4a, 0x0e, 0x43, 0x95, 0xfb,
+  0xed, 0xcb, 0x97, 0x7d, 0x4b, 0x06, 0x49, 0xa5, 0x7a, 0x88, 0x18, 0x50, 0x26, 0xea, 0x01, 0xac,
+  0xfa, 0x9d, 0xed, 0x8d, 0xdb, 0x22, 0xac, 0xbd, 0x79, 0xb8, 0x70, 0xb0, 0x90, 0x90, 0x33, 0xd9,
+  0x96, 0xf0, 0x40, 0xb6, 0x8c, 0xa8, 0x21, 0x34, 0xcc, 0x1c, 0x7f, 0x9e, 0xcb, 0x07, 0x14, 0xde,
+  0xff, 0x00, 0xd9, 0x3f, 0x42, 0xff, 0x97, 0x76, 0x76, 0xee, 0x09, 0xf8, 0x42, 0xd0, 0x94, 0x53,
+  0x14, 0xd8, 0x63, 0xf7, 0xdb, 0xc9, 0x67, 0xe0, 0xe8, 0xbe, 0x87, 0x31, 0x27, 0xd9, 0x01, 0x58,
+  0x60, 0xdf, 0x20, 0x66, 0xdd, 0x40, 0x17, 0xf1, 0xa1, 0x66, 0x83, 0x05, 0xa2, 0x60, 0xba, 0x6f,
+  0xde, 0xd9, 0xf2, 0xcc, 0xd1, 0x87, 0xb0, 0x75, 0x80, 0x6a, 0x35, 0x3b, 0x18, 0x10, 0x87, 0x66,
+  0x39, 0x9e, 0x05, 0x49, 0xf9, 0x26, 0x50, 0x3e, 0x08, 0x1a, 0x81, 0x84, 0xd7, 0x0c, 0x4d, 0xf7,
+  0x18, 0x50, 0xfd, 0x7c, 0xf2, 0x28, 0x12, 0x4a, 0xb8, 0xcf, 0x09, 0x50, 0xf7, 0x06, 0xde, 0x81,
+  0x27, 0x9f, 0xfc, 0x0e, 0x86, 0xfe, 0x30, 0x79, 0x94, 0x69, 0xbc, 0x77, 0xe5, 0x6e, 0x9e, 0xe1,
+  0x9e, 0x66, 0xaf, 0x61, 0x7a, 0x96, 0x5f, 0xcb, 0x71, 0x0f, 0x0a, 0x48, 0x96, 0x43, 0xbd, 0x17,
+  0x18, 0xc5, 0xec, 0x8b, 0x82, 0x97, 0xb8, 0xb1, 0x86, 0xac, 0x08, 0x23, 0xd4, 0x84, 0x23, 0x39,
+  0xa7, 0x89, 0x8f, 0x19, 0xe8, 0xf6, 0xdc, 0x2e, 0xa7, 0x10, 0x18, 0x60, 0x55, 0x5d, 0x33, 0x6c,
+  0x6a, 0x39, 0x1f, 0xd0, 0x9e, 0x69, 0xd1, 0xb8, 0xc7, 0xab, 0x46, 0x46, 0xf5, 0x34, 0xcb, 0x76,
+  0xd6, 0xfb, 0x9a, 0xae, 0x66, 0xcb, 0xbb, 0xf7, 0x06, 0xb2, 0x8f, 0x48, 0xc6, 0x91, 0x4a, 0x3f,
+  0x02, 0x5b, 0x80, 0x21, 0x35, 0x80, 0x86, 0xc0, 0x06, 0x2b, 0x46, 0x72, 0x17, 0x59, 0x92, 0xdc,
+  0xb8, 0x7d, 0xd9, 0x22, 0x1a, 0x7b, 0xeb, 0x25, 0xf1, 0xec, 0x33, 0xcb, 0xe9, 0xe2, 0x68, 0x44,
+  0x2a, 0x6e, 0x42, 0xd1, 0xb1, 0x3f, 0x38, 0x5c, 0xf7, 0xf9, 0x5e, 0x2e, 0x85, 0xa3, 0x4b, 0x09,
+  0x72, 0x80, 0x0b, 0xa4, 0xac, 0x01, 0x0c, 0xc8, 0xe9, 0x34, 0xd2, 0x89, 0xc0, 0xad, 0xeb, 0xd4,
+  0xd8, 0x73, 0xfa, 0xf0, 0xf8, 0xca, 0x15, 0x91, 0x7c, 0x85, 0x23, 0x7f, 0xa9, 0xfd, 0xaa, 0xce,
+  0x12, 0xb0, 0xba, 0x57, 0x05, 0x01, 0x70, 0x25, 0xac, 0x83, 0x94, 0xb2, 0x58, 0xe7, 0xd7, 0x7e,
+  0x90, 0xae, 0x82, 0xf8, 0xb3, 0xb1, 0x05, 0xb0, 0x67, 0xe3, 0x0a, 0xe0, 0xce, 0xc6, 0x21, 0xe6,
+  0x51, 0xf1, 0x14, 0x3e, 0x07, 0x1b, 0x0c, 0x44, 0x29, 0x80, 0x06, 0xe1, 0x45, 0xd2, 0x52, 0x95,
+  0x94, 0x4a, 0x95, 0x3c, 0xda, 0xb2, 0x74, 0xd9, 0xdf, 0xf5, 0x34, 0xbb, 0x58, 0x21, 0x32, 0xc1,
+  0x2f, 0x10, 0x94, 0xba, 0x32, 0xb2, 0x2c, 0x98, 0xbd, 0x0b, 0xe9, 0x37, 0x8d, 0xaa, 0xd2, 0x15,
+  0x98, 0xe3, 0xa3, 0x93, 0x63, 0xb5, 0xd0, 0x4a, 0x78, 0x8b, 0xf2, 0x50, 0xc9, 0x37, 0x26, 0xe7,
+  0x77, 0xf1, 0x31, 0xb0, 0x37, 0xb6, 0x77, 0xa8, 0xe3, 0x68, 0xc6, 0x5e, 0x36, 0xe8, 0x70, 0x48,
+  0x51, 0xa0, 0xcc, 0xf9, 0x2a, 0xb2, 0x21, 0xcd, 0xee, 0x9d, 0x99, 0xca, 0xc3, 0x54, 0x1c, 0x51,
+  0x74, 0x39, 0x4e, 0x32, 0x3f, 0xee, 0xc9, 0x5c, 0x32, 0x3a, 0x68, 0x66, 0xc0, 0x8e, 0x65, 0xea,
+  0xd3, 0x21, 0xe3, 0xa8, 0xbc, 0x68, 0x23, 0x6d, 0x59, 0xc4, 0x3b, 0x97, 0x58, 0xa7, 0x47, 0x1d,
+  0x05, 0x02, 0x1f, 0x56, 0x37, 0x08, 0x2c, 0x65, 0x8d, 0x9f, 0x41, 0xc1, 0xae, 0xa5, 0x70, 0xaa,
+  0x3b, 0x7d, 0x6a, 0x94, 0x2d, 0x6a, 0x0f, 0xc1, 0x91, 0x00, 0x25, 0x6b, 0xc4, 0xff, 0x5c, 0xff,
+  0x8d, 0x8d, 0x1e, 0x35, 0x6b, 0x0a, 0xa6, 0x6c, 0x38, 0xfc, 0xa1, 0x30, 0x70, 0xc7, 0x02, 0x0a,
+  0x2f, 0xfb, 0x02, 0x67, 0x3a, 0xec, 0xd3, 0x5a, 0xc7, 0xb1, 0xe0, 0xbf, 0xfe, 0xda, 0xe6, 0x36,
+  0x86, 0x0b, 0x2f, 0x30, 0xf9, 0x9d, 0x3c, 0xea, 0x34, 0xe0, 0x09, 0x3e, 0xdd, 0xba, 0xb1, 0x2e,
+  0x7a, 0xec, 0xfe, 0xd1, 0x7d, 0x8d, 0xd9, 0xf2, 0xe7, 0x5e, 0xa8, 0x70, 0x86, 0x3e, 0x16, 0x3c,
+  0xee, 0x73, 0xf7, 0x38, 0x1c, 0xf3, 0xdf, 0xf0, 0xf8, 0x35, 0xfc, 0x9e, 0x30, 0x67, 0x7c, 0x8c,
+  0xb1, 0x86, 0xfb, 0x43, 0xf8, 0xfa, 0x1b, 0xee, 0x99, 0xd9, 0x2c, 0x48, 0xbd, 0xf9, 0x8b, 0x06,
+  0x60, 0x23, 0xf0, 0x20, 0x4c, 0xaf, 0x81, 0xb4, 0xba, 0xc7, 0x32, 0x3c, 0x78, 0xd8, 0x90, 0x81,
+  0xa5, 0xfc, 0xef, 0x6c, 0x8a, 0xc3, 0x42, 0x37, 0x28, 0xed, 0xaf, 0x91, 0xd6, 0xcc, 0x61, 0xfc,
+  0xf8, 0x51, 0x5d, 0xfb, 0xd9, 0x43, 0x0e, 0xb4, 0xae, 0x0d, 0xc7, 0x80, 0x8f, 0x3a, 0xc3, 0x8c,
+  0x81, 0xac, 0xcc, 0x3a, 0x85, 0xff, 0x73, 0x8f, 0x15, 0x97, 0x20, 0x26, 0x97, 0xa4, 0x39, 0x01,
+  0x28, 0xe6, 0x80, 0x45, 0x19, 0xb3, 0xc0, 0xe8, 0x78, 0xc7, 0x18, 0x58, 0xbf, 0xd1, 0x94, 0xfb,
+  0xab, 0x25, 0xbb, 0x6f, 0x1e, 0x70, 0x11, 0xde, 0x34, 0x7a, 0x66, 0x59, 0x8a, 0x11, 0x06, 0x11,
+  0x9d, 0x94, 0x83, 0xb6, 0xe8, 0x75, 0x1c, 0x29, 0xa9, 0x52, 0x42, 0xc1, 0x79, 0x03, 0x31, 0xd9,
+  0x19, 0x08, 0xc3, 0x6b, 0x10, 0x89, 0x2f, 0x59, 0xd1, 0x05, 0x23, 0x3b, 0x91, 0x2c, 0x9d, 0x74,
+  0x1a, 0x1c, 0xc3, 0xb5, 0x7c, 0x7a, 0x98, 0xd4, 0xfc, 0x5a, 0x2c, 0x35, 0xe3, 0x8a, 0xf8, 0x79,
+  0x20, 0x14, 0x12, 0xcc, 0x66, 0x8a, 0x90, 0x25, 0x76, 0x59, 0xa1, 0xa1, 0x92, 0x50, 0xfa, 0x5d,
+  0x84, 0x22, 0x55, 0x20, 0xc6, 0x81, 0x80, 0xf8, 0x9f, 0x76, 0xb7, 0x3e, 0xf4, 0x7c, 0x1a, 0x4d,
+  0xc3, 0x8d, 0x22, 0x25, 0xb2, 0x29, 0x89, 0x7d, 0x00, 0xee, 0x57, 0xd9, 0x79, 0x76, 0x95, 0x78,
+  0x1c, 0x4d, 0xda, 0x97, 0x4c, 0x24, 0xd9, 0xa1, 0x04, 0x07, 0xb5, 0x25, 0x2b, 0x80, 0xdd, 0xbe,
+  0xac, 0x8f, 0x50, 0xfd, 0x01, 0x66, 0x7b, 0x66, 0x10, 0x68, 0x56, 0x23, 0x30, 0xc2, 0xdd, 0x9f,
+  0x1d, 0xd4, 0x3a, 0x27, 0x24, 0x02, 0x2d, 0x26, 0x2c, 0x05, 0x01, 0xaa, 0x01, 0x93, 0xb6, 0x10,
+  0xb4, 0x94, 0x76, 0xee, 0x12, 0x73, 0xee, 0x52, 0x3e, 0xbf, 0x59, 0xf9, 0x92, 0x41, 0x28, 0x17,
+  0xe6, 0x6c, 0x81, 0xa5, 0x31, 0x0c, 0x9b, 0xb2, 0xb2, 0x2d, 0xef, 0xd3, 0xc8, 0x4e, 0x8b, 0xcb,
+  0x4c, 0xb0, 0x57, 0x79, 0x39, 0x8a, 0x78, 0x8f, 0xdb, 0x02, 0x40, 0x06, 0x8f, 0xb4, 0x66, 0xdd,
+  0x6a, 0x11, 0x28, 0x7f, 0xb7, 0x56, 0xe7, 0xd9, 0xed, 0x9c, 0xa0, 0x29, 0xea, 0x29, 0xbd, 0x1e,
+  0x0d, 0x0d, 0x38, 0x03, 0xd6, 0x45, 0x90, 0x6e, 0x53, 0xa7, 0x6f, 0xaa, 0x2d, 0x22, 0x6d, 0xdf,
+  0xd9, 0xd9, 0x95, 0xaa, 0xe9, 0xe2, 0x26, 0xe4, 0xef, 0xd4, 0xb2, 0x5b, 0xe4, 0x21, 0x91, 0xbc,
+  0xc4, 0xa5, 0xb6, 0x7b, 0x38, 0xa4, 0x12, 0x4c, 0x91, 0x87, 0x43, 0xb0, 0x79, 0xac, 0xba, 0xdf,
+  0x40, 0x97, 0x2a, 0x91, 0x71, 0x1a, 0x00, 0xb6, 0x7b, 0xb4, 0xc8, 0x3f, 0xef, 0xdc, 0xb9, 0x0d,
+  0x9b, 0x6b, 0x41, 0xf8, 0xa4, 0xf5, 0x0e, 0xcb, 0x78, 0xd0, 0xad, 0xb4, 0x08, 0x53, 0xca, 0x88,
+  0x19, 0x6c, 0x79, 0x1a, 0x1a, 0x37, 0x7d, 0xad, 0x80, 0x51, 0xe3, 0xb8, 0xcb, 0x1e, 0x57, 0xb8,
+  0xc3, 0x86, 0x2d, 0x17, 0x3a, 0xaf, 0xa8, 0x48, 0xb6, 0xe7, 0x0b, 0x17, 0xa7, 0x18, 0x99, 0x64,
+  0x5c, 0x98, 0x13, 0xb2, 0xd8, 0x41, 0x7c, 0x79, 0x71, 0x91, 0x8a, 0x0f, 0x33, 0xdb, 0x77, 0x67,
+  0x0a, 0x96, 0x3c, 0xdc, 0xb1, 0x35, 0x35, 0x62, 0x3a, 0x7c, 0x58, 0x75, 0x79, 0x78, 0xcf, 0x86,
+  0x57, 0x22, 0x1b, 0x52, 0x00, 0xea, 0x36, 0x04, 0xf8, 0x07, 0xa6, 0x95, 0x05, 0x79, 0xe8, 0xbd,
+  0xce, 0x83, 0x2e, 0x7c, 0xe8, 0x55, 0x03, 0x46, 0x5d, 0x03, 0xf2, 0x76, 0xd6, 0xb5, 0x90, 0xa7,
+  0x36, 0x7c, 0x9c, 0x94, 0xe1, 0xb7, 0xa2, 0x50, 0x62, 0xae, 0x26, 0x0b, 0x23, 0x96, 0xa6, 0x61,
+  0xe0, 0x87, 0xa9, 0x5a, 0x93, 0xa5, 0x6a, 0xab, 0x64, 0x71, 0x79, 0x39, 0x33, 0x3f, 0x8b, 0x63,
+  0x6d, 0x0e, 0x99, 0xb0, 0x64, 0x17, 0x2f, 0xf8, 0x80, 0x2c, 0x74, 0xf1, 0x87, 0x8f, 0x08, 0x58,
+  0xaa, 0x4d, 0x1d, 0x99, 0x28, 0x34, 0x34, 0xdf, 0x5b, 0xac, 0x37, 0xaf, 0xad, 0xd4, 0xb1, 0x1e,
+  0xad, 0xe1, 0x09, 0x5c, 0xbd, 0x29, 0x65, 0xc3, 0xc0, 0x0c, 0x40, 0x63, 0xb1, 0x7f, 0x20, 0x62,
+  0x75, 0xce, 0x34, 0xdc, 0xb7, 0xa5, 0x4a, 0x1e, 0xc9, 0x11, 0x1c, 0x78, 0x77, 0x09, 0xc5, 0xa2,
+  0x8b, 0x63, 0x8d, 0x68, 0xf6, 0x7a, 0xe3, 0xcc, 0x37, 0xb1, 0xad, 0x02, 0x7b, 0x43, 0x0d, 0x95,
+  0x15, 0x35, 0xca, 0x7c, 0x89, 0x0c, 0x8e, 0x8d, 0x67, 0x8f, 0x16, 0xc0, 0x87, 0xe4, 0x28, 0xb2,
+  0x27, 0x7d, 0x81, 0xba, 0x09, 0xe8, 0xf7, 0xd4, 0xa6, 0x55, 0x54, 0xe5, 0xaa, 0x22, 0x08, 0xbe,
+  0x7a, 0xb4, 0x66, 0x51, 0xb1, 0x34, 0x24, 0xce, 0xb5, 0x16, 0x19, 0x62, 0x67, 0xdf, 0x26, 0x48,
+  0xd8, 0x54, 0x45, 0xe1, 0x90, 0x2a, 0x85, 0xcf, 0xa9, 0x84, 0x96, 0xed, 0xa7, 0xe3, 0x5f, 0x7c,
+  0x94, 0xf2, 0xfc, 0x85, 0xac, 0x53, 0x0b, 0x74, 0xcf, 0xfd, 0x13, 0xc4, 0xd0, 0x41, 0xd4, 0xec,
+  0xbe, 0x74, 0x4f, 0x09, 0x96, 0x7b, 0x27, 0x5f, 0xb1, 0x8f, 0x78, 0x5e, 0xc1, 0xde, 0x7e, 0xee,
+  0xbe, 0x75, 0x8f, 0xd9, 0xa9, 0xc7, 0xe4, 0x0b, 0xaf, 0xae, 0x8b, 0x39, 0xd9, 0x63, 0xa9, 0x22,
+  0x96, 0x2c, 0x2c, 0xb7, 0xfe, 0x05, 0x8f, 0x4e, 0xdc, 0x37, 0x58, 0x4a, 0xc5, 0xd3, 0x8c, 0x23,
+  0x02, 0x93, 0x8e, 0x85, 0x41, 0x3a, 0x16, 0x5c, 0x31, 0xa4, 0x47, 0xa8, 0x2d, 0x5e, 0x4c, 0x7e,
+  0x8b, 0xe3, 0x18, 0x80, 0x13, 0xf7, 0x75, 0x95, 0x3d, 0xc3, 0x72, 0xac, 0xfb, 0x9a, 0xb8, 0xdf,
+  0x21, 0x38, 0xf8, 0x10, 0x3f, 0x90, 0x88, 0x2d, 0xfd, 0xd6, 0x3d, 0x8b, 0x96, 0x73, 0x4f, 0xdd,
+  0x57, 0x48, 0xcc, 0x19, 0xab, 0x56, 0x1f, 0x4f, 0xfe, 0x1d, 0x1e, 0x3c, 0x0f, 0x20, 0x43, 0x52,
+  0xca, 0x5e, 0x47, 0xc6, 0xbf, 0x61, 0x95, 0xed, 0x64, 0xc1, 0x3b, 0xd6, 0x44, 0x80, 0x4d, 0x1e,
+  0x58, 0xdc, 0xd8, 0x36, 0x75, 0xdd, 0x66, 0x15, 0x2c, 0x91, 0x5a, 0x05, 0x25, 0x8c, 0x84, 0x68,
+  0x08, 0x66, 0x17, 0x72, 0x30, 0x38, 0xcf, 0x3f, 0x31, 0x49, 0xe4, 0x09, 0x52, 0x67, 0xb8, 0xe6,
+  0xb3, 0x1c, 0x52, 0xa2, 0xcf, 0x58, 0x37, 0xc4, 0x31, 0x2f, 0xd3, 0xd7, 0xeb, 0xf5, 0x4e, 0x63,
+  0x98, 0x4c, 0x4f, 0x52, 0x47, 0x30, 0xd2, 0xfb, 0x16, 0xed, 0x81, 0xef, 0xed, 0xaf, 0x36, 0xa5,
+  0x02, 0x9e, 0x3f, 0x36, 0xf7, 0xb7, 0x23, 0x6a, 0x1d, 0xe6, 0x05, 0x00, 0xac, 0x2b, 0x06, 0x19,
+  0x82, 0x36, 0x98, 0x0f, 0xe7, 0x5e, 0xb0, 0xf2, 0x37, 0xab, 0x5d, 0xa0, 0x5d, 0x67, 0x25, 0x80,
+  0xe8, 0xe1, 0x23, 0xa2, 0x64, 0x80, 0xb2, 0x48, 0x79, 0x56, 0x1d, 0x67, 0x5e, 0xb9, 0x12, 0xdf,
+  0xb5, 0x0e, 0x59, 0x5a, 0xa8, 0x44, 0x4f, 0xf0, 0x93, 0x3c, 0xa9, 0x62, 0x53, 0x55, 0x8e, 0x53,
+  0xb3, 0xa8, 0x33, 0xb2, 0x8c, 0xa2, 0x26, 0xdc, 0x17, 0x3c, 0xaf, 0xe7, 0xc9, 0x0e, 0xb6, 0xbd,
+  0x7f, 0x15, 0x0b, 0x21, 0xa1, 0x9a, 0x82, 0x56, 0xb2, 0x03, 0x18, 0x54, 0x39, 0xf7, 0xb4, 0xd5,
+  0x69, 0xc0, 0x80, 0xbc, 0x7a, 0x88, 0x0f, 0x30, 0x28, 0x88, 0xf8, 0x5d, 0x55, 0xb9, 0x15, 0x11,
+  0xee, 0x12, 0xa8, 0xa1, 0x58, 0x87, 0xbe, 0x7b, 0xf7, 0xe6, 0xd5, 0xa3, 0x0f, 0x81, 0xc3, 0xd7,
+  0xf1, 0x50, 0xf7, 0x0e, 0xb8, 0x2e, 0x76, 0x9e, 0xbb, 0x43, 0x95, 0x91, 0x25, 0x2c, 0xf1, 0xfb,
+  0x3f, 0x31, 0x02, 0xb1, 0xe4, 0x92, 0x5f, 0x84, 0x50, 0xb5, 0x7d, 0xc2, 0xea, 0xaa, 0xd8, 0x96,
+  0x1d, 0xf6, 0x84, 0x95, 0xf2, 0x6b, 0x17, 0x5e, 0x67, 0xb6, 0x65, 0x1a, 0x7b, 0x6b, 0x3f, 0x7b,
+  0xe8, 0x63, 0x8e, 0x1e, 0x6c, 0x8c, 0xdd, 0x48, 0xec, 0x79, 0xa7, 0x6b, 0x4d, 0x07, 0x02, 0x2a,
+  0x77, 0xea, 0x7e, 0x8b, 0x96, 0xcd, 0x7d, 0xd5, 0x22, 0x21, 0x28, 0x0b, 0x60, 0x8d, 0xd5, 0x0f,
+  0x06, 0xe4, 0x53, 0xe2, 0xfe, 0x17, 0xd8, 0x1c, 0x3c, 0x36, 0x3e, 0x72, 0x8f, 0x71, 0x48, 0xc8,
+  0x9f, 0x71, 0xa1, 0x25, 0x3a, 0xac, 0x5b, 0x95, 0x38, 0xe0, 0x16, 0x56, 0x4b, 0xbe, 0x8b, 0x2c,
+  0x11, 0x4d, 0x0d, 0xff, 0xba, 0x17, 0xa7, 0x21, 0x28, 0x79, 0x37, 0x7e, 0xf9, 0x6f, 0x72, 0xed,
+  0x93, 0x1b, 0xb5, 0x7f, 0x5d, 0xa8, 0xbd, 0xf7, 0xab, 0xc6, 0x5e, 0x95, 0x48, 0xf7, 0xa4, 0xca,
+  0xb8, 0x44, 0xd8, 0xdb, 0xbe, 0xa9, 0x83, 0xef, 0x59, 0x2d, 0xb9, 0x4f, 0x59, 0x65, 0xed, 0x0c,
+  0x2c, 0xdd, 0xd7, 0x25, 0xc2, 0x52, 0x50, 0xaf, 0xc5, 0x1d, 0x7b, 0x09, 0x05, 0x7d, 0x73, 0x45,
+  0x78, 0x9b, 0xac, 0x0b, 0x79, 0xa5, 0x8e, 0x5d, 0xd3, 0xd3, 0x0e, 0xac, 0x0c, 0xc5, 0xd8, 0x0e,
+  0xee, 0x33, 0x7c, 0x12, 0x61, 0x11, 0x56, 0x7c, 0x9e, 0xc6, 0x4c, 0x31, 0x3b, 0x39, 0x07, 0x71,
+  0x7f, 0x12, 0xd4, 0x76, 0xf2, 0x25, 0xa4, 0x01, 0x22, 0x92, 0x3d, 0x64, 0xc6, 0xa2, 0xcf, 0x3c,
+  0xa6, 0x39, 0x2a, 0xd1, 0xb3, 0x57, 0x72, 0x52, 0x9c, 0x43, 0x76, 0x55, 0x23, 0xaa, 0x27, 0x8e,
+  0xd6, 0x7c, 0xd1, 0xd8, 0x64, 0x87, 0x7e, 0x81, 0xa0, 0xb0, 0xd6, 0x8e, 0xa9, 0x22, 0xd2, 0xce,
+  0x01, 0x98, 0x93, 0x78, 0x84, 0x6b, 0x4e, 0xcf, 0xd2, 0xd1, 0xa4, 0x46, 0x2c, 0xc5, 0x3b, 0xcc,
+  0x52, 0x5c, 0xbe, 0x4c, 0xde, 0xf1, 0x81, 0x88, 0xec, 0xb1, 0x1f, 0xb4, 0x7c, 0xc3, 0xdb, 0xfe,
+  0xbe, 0xf7, 0x14, 0x8b, 0x37, 0x61, 0xf8, 0xad, 0x7f, 0xdc, 0xf0, 0x31, 0x2f, 0xce, 0x5a, 0x34,
+  0x58, 0xe7, 0x06, 0x68, 0xe9, 0x6b, 0xf4, 0xe9, 0x81, 0xa4, 0x8b, 0xd2, 0x0d, 0x91, 0x45, 0x1e,
+  0x67, 0x93, 0xe0, 0x97, 0x31, 0xfc, 0x23, 0xd1, 0x9b, 0xcc, 0xfb, 0x88, 0xfa, 0x6e, 0x58, 0x64,
+  0xcc, 0xf6, 0x2d, 0xf5, 0x2e, 0x8c, 0x79, 0xfd, 0x4f, 0x73, 0x45, 0xa1, 0xd1, 0x5e, 0xd5, 0x9f,
+  0x50, 0x24, 0x1a, 0x67, 0x4e, 0x32, 0x1e, 0xbd, 0x74, 0x0e, 0xa7, 0x3f, 0xcd, 0xe1, 0x0b, 0x9d,
+  0xbd, 0x8f, 0x4e, 0x8e, 0xbb, 0x3f, 0x90, 0x35, 0xe7, 0x96, 0x69, 0xb1, 0xb0, 0x8d, 0x6b, 0x9a,
+  0xc8, 0x87, 0x67, 0x36, 0x61, 0x44, 0xa5, 0xf4, 0xcf, 0x2c, 0xd2, 0x7c, 0xe6, 0x37, 0x0d, 0x8a,
+  0x9a, 0x05, 0xdd, 0x97, 0x81, 0xc0, 0x8a, 0x04, 0x72, 0x9c, 0xcb, 0x30, 0xd8, 0x11, 0xd8, 0x7f,
+  0xaf, 0x55, 0x6e, 0x2d, 0x47, 0x5d, 0xce, 0x87, 0xc8, 0x38, 0x3b, 0xc4, 0x7f, 0x2a, 0x6c, 0x0a,
+  0x61, 0xfd, 0x22, 0xdf, 0x61, 0x0c, 0x1d, 0x44, 0xfe, 0xb1, 0xf8, 0x5e, 0x10, 0x87, 0xf3, 0xd4,
+  0xe2, 0x11, 0x4b, 0x3d, 0x9e, 0xf8, 0xbd, 0x25, 0x2f, 0xb0, 0x63, 0xea, 0x94, 0x41, 0xfb, 0xd6,
+  0x3d, 0x4e, 0x5b, 0xc6, 0xf4, 0x56, 0x0d, 0x31, 0x32, 0x9b, 0x1e, 0x85, 0x7a, 0x87, 0xa8, 0xff,
+  0x2f, 0x71, 0x27, 0x4d, 0x49, 0x22, 0x5a, 0xbd, 0x61, 0x24, 0xa4, 0xcc, 0x0e, 0xba, 0x22, 0xc1,
+  0x26, 0x4f, 0xe2, 0x32, 0x38, 0x00, 0x36, 0xbe, 0x59, 0xb9, 0xf8, 0xf0, 0x93, 0x8b, 0x13, 0xa3,
+  0x24, 0xec, 0xf7, 0x86, 0xe0, 0x2e, 0x43, 0x0c, 0x22, 0x22, 0x45, 0x7c, 0xb7, 0x83, 0xb5, 0x17,
+  0xec, 0xa6, 0x7b, 0xcc, 0xc4, 0xf0, 0x15, 0x4f, 0x23, 0xdd, 0x33, 0x16, 0x1a, 0x5e, 0x80, 0xbe,
+  0x14, 0x3b, 0x59, 0x9e, 0xe6, 0x71, 0xc3, 0x5e, 0x94, 0x5b, 0x96, 0x39, 0x10, 0x26, 0x70, 0xb8,
+  0xa5, 0x0a, 0x9e, 0x22, 0x5b, 0x03, 0xa6, 0x5f, 0x47, 0xe9, 0xe8, 0x04, 0xbb, 0xd2, 0x8f, 0x08,
+  0x4b, 0x5a, 0x5f, 0x42, 0x32, 0x8b, 0x3e, 0xea, 0x07, 0x82, 0xc0, 0x02, 0x0a, 0xde, 0x17, 0x37,
+  0xae, 0xa5, 0xe4, 0x35, 0xc4, 0x07, 0x2d, 0x7b, 0xc2, 0x92, 0x27, 0xad, 0xc2, 0x39, 0x64, 0xb9,
+  0xa8, 0x3c, 0xc7, 0x4d, 0xcb, 0x51, 0x6c, 0x93, 0xce, 0x38, 0xd9, 0x31, 0x3a, 0xf3, 0x2a, 0x7b,
+  0xd3, 0x77, 0x6b, 0x5a, 0x3f, 0x40, 0x56, 0xc4, 0x36, 0x2e, 0x94, 0xc0, 0xfa, 0xeb, 0xfe, 0xd4,
+  0x6c, 0x06, 0xa6, 0x7a, 0x7c, 0xcd, 0x29, 0xc5, 0xd9, 0x29, 0xc6, 0x25, 0xd7, 0x9c, 0x44, 0xe1,
+  0x17, 0x4f, 0xb3, 0xf2, 0x7b, 0xc0, 0x66, 0x48, 0xbc, 0xb2, 0xed, 0x06, 0xee, 0x0c, 0x2b, 0x5a,
+  0x78, 0x23, 0x7f, 0x8c, 0x00, 0x3f, 0xec, 0xf6, 0x88, 0x5b, 0xb4, 0xbf, 0x09, 0xc7, 0x2e, 0x88,
+  0x5d, 0x67, 0x3e, 0xb3, 0x66, 0x4e, 0x5a, 0x4f, 0xd0, 0x4c, 0x61, 0x36, 0xca, 0x65, 0x87, 0x25,
+  0xbe, 0x45, 0xa6, 0x6e, 0x6e, 0x07, 0x93, 0xb0, 0xb9, 0x61, 0x9e, 0x14, 0x99, 0x4d, 0xf6, 0xf3,
+  0xe3, 0xf3, 0xec, 0xac, 0x30, 0xd1, 0x14, 0x19, 0xef, 0x20, 0xab, 0x15, 0x5d, 0x4d, 0x5a, 0x5a,
+  0xba, 0x7a, 0xf5, 0x1a, 0xe4, 0xb4, 0x53, 0xac, 0xb8, 0xb8, 0x24, 0x3a, 0x3d, 0x05, 0xcd, 0x17,
+  0xbf, 0x9f, 0xb0, 0x72, 0xfe, 0x49, 0x58, 0x04, 0x15, 0x88, 0xdc, 0x8f, 0xa1, 0x9c, 0xb3, 0xe7,
+  0xde, 0x7e, 0x67, 0x5c, 0x2c, 0xf3, 0x0e, 0x99, 0x38, 0x7b, 0x14, 0x90, 0x6e, 0x17, 0xfb, 0xfb,
+  0x39, 0xde, 0x54, 0x45, 0xbd, 0x16, 0xc1, 0x59, 0x56, 0xaa, 0xf3, 0xa6, 0x3d, 0x0f, 0xf4, 0x74,
+  0xfb, 0x45, 0x72, 0x81, 0x9c, 0x76, 0x8c, 0xa2, 0x87, 0x52, 0xb9, 0x1b, 0x10, 0xe4, 0xdf, 0xf0,
+  0x52, 0x98, 0x77, 0xc7, 0xce, 0xd6, 0x67, 0x60, 0x56, 0x35, 0x0b, 0x52, 0x70, 0x24, 0x3f, 0x1b,
+  0x6f, 0xfe, 0x51, 0xce, 0x95, 0x38, 0xab, 0xe7, 0x3c, 0x55, 0x12, 0x34, 0xfa, 0xcd, 0x70, 0xa0,
+  0x24, 0x56, 0x4b, 0xde, 0x6b, 0xf9, 0xf7, 0xd4, 0x76, 0xb0, 0x65, 0xaa, 0x74, 0xc3, 0xc0, 0x9e,
+  0x2e, 0x3c, 0xc0, 0x54, 0xfa, 0x54, 0xb9, 0xcf, 0x4e, 0x88, 0xa3, 0x5d, 0x02, 0x03, 0x18, 0x73,
+  0x8f, 0xf2, 0x41, 0xa8, 0x3c, 0x3d, 0x19, 0x5c, 0xc5, 0xac, 0xad, 0x65, 0xba, 0x06, 0x9f, 0xa7,
+  0xae, 0xc6, 0x87, 0x15, 0x5d, 0x71, 0x26, 0x8d, 0x15, 0xee, 0x4d, 0xa0, 0xb2, 0xf8, 0x36, 0xeb,
+  0x20, 0x39, 0x8a, 0x4d, 0x6b, 0x66, 0x66, 0x56, 0x05, 0x8d, 0x30, 0x29, 0x22, 0x5b, 0x73, 0x71,
+  0xee, 0x1f, 0x48, 0x8f, 0x91, 0xff, 0xf3, 0x2a, 0x32, 0x2f, 0xdf, 0xe0, 0x35, 0x9a, 0xf0, 0xd2,
+  0xeb, 0xec, 0x8a, 0xac, 0xe8, 0x54, 0xb6, 0x32, 0x5b, 0x0e, 0xe2, 0x09, 0xf6, 0x7f, 0x4e, 0x1e,
+  0xe3, 0xba, 0xcf, 0xbd, 0x9b, 0xb5, 0x00, 0xbe, 0x4a, 0x26, 0x5f, 0x61, 0x54, 0x46, 0xb0, 0xbc,
+  0x8b, 0x49, 0x26, 0x26, 0xda, 0x84, 0x45, 0x69, 0xa7, 0xcc, 0xbc, 0xf0, 0xfb, 0x75, 0xee, 0x73,
+  0x4c, 0x42, 0xd9, 0xc9, 0x73, 0x9c, 0x8c, 0x02, 0xb9, 0x37, 0x43, 0xb0, 0x16, 0xdd, 0xbe, 0x99,
+  0x52, 0xef, 0x69, 0x7c, 0xf4, 0x70, 0xfd, 0xbd, 0x80, 0x5d, 0xd3, 0xd3, 0x57, 0x30, 0x55, 0x78,
+  0x1b, 0x8e, 0x2b, 0xdb, 0x14, 0xe6, 0x3d, 0xf5, 0xef, 0x23, 0x47, 0xee, 0x68, 0x79, 0xb7, 0x0f,
+  0xd3, 0x36, 0xf9, 0xac, 0x00, 0x63, 0xbc, 0xc5, 0xc5, 0x1c, 0x29, 0x40, 0xc5, 0x05, 0xdd, 0x01,
+  0x2b, 0xd2, 0xc1, 0x96, 0x7d, 0x73, 0x21, 0x7d, 0xfd, 0xa7, 0xd3, 0xe0, 0x5f, 0x22, 0xd5, 0x41,
+  0x9d, 0xf1, 0x6e, 0x03, 0xc5, 0x23, 0x6b, 0xfe, 0x8d, 0x4a, 0x91, 0x20, 0xba, 0xd3, 0x6f, 0x66,
+  0x7d, 0xd1, 0x14, 0xbc, 0x49, 0x5f, 0xa8, 0x8b, 0xc2, 0x73, 0xe4, 0x6e, 0x22, 0x1c, 0xf7, 0x73,
+  0x99, 0x70, 0x00, 0xbf, 0x61, 0xe3, 0xdd, 0x13, 0x09, 0x73, 0x9c, 0xf0, 0x2a, 0x12, 0xbb, 0x62,
+  0x14, 0xdc, 0x0a, 0x81, 0x24, 0xe6, 0x2f, 0xe1, 0x85, 0x36, 0x71, 0x6e, 0x92, 0xb1, 0x48, 0x0e,
+  0xf4, 0xe8, 0xe5, 0x90, 0xd2, 0xda, 0x2c, 0x0d, 0x23, 0x17, 0x85, 0x41, 0x78, 0x93, 0xa4, 0x94,
+  0xd9, 0xe3, 0x10, 0x2b, 0x39, 0x9d, 0xe0, 0x2d, 0x81, 0x8b, 0x59, 0x3b, 0x7e, 0xad, 0x44, 0x4c,
+  0xbf, 0xf0, 0x0e, 0xc3, 0x05, 0x2f, 0xcf, 0x2f, 0x9f, 0xc0, 0xfa, 0xff, 0x97, 0x34, 0xbf, 0x58,
+  0x71, 0x17, 0x28, 0xb2, 0xfb, 0x3a, 0x8d, 0x43, 0x22, 0x1b, 0x63, 0xe2, 0x88, 0xe7, 0xc8, 0x5c,
+  0x80, 0x4a, 0x11, 0xbc, 0xfc, 0xfb, 0x66, 0x7e, 0xe6, 0x9c, 0xf8, 0xca, 0xa5, 0xa4, 0xe4, 0xf6,
+  0x17, 0x71, 0x63, 0xde, 0xa2, 0xed, 0x85, 0x95, 0x5f, 0x8a, 0x12, 0x47, 0x30, 0x72, 0x78, 0x71,
+  0x3a, 0x85, 0x29, 0xa8, 0xca, 0x62, 0x02, 0x9a, 0x8f, 0x96, 0xb0, 0x3f, 0xbe, 0xb4, 0x96, 0xa4,
+  0x22, 0x83, 0xa8, 0x50, 0x6e, 0x45, 0x84, 0x09, 0x08, 0x98, 0x49, 0xb2, 0x85, 0x48, 0x7b, 0xcb,
+  0x84, 0xdf, 0x69, 0x25, 0x48, 0xb8, 0x3b, 0xfc, 0x5b, 0xac, 0x60, 0xcc, 0x6a, 0x89, 0xf7, 0xc4,
+  0x95, 0x82, 0xcb, 0x30, 0x99, 0x9d, 0x57, 0xe5, 0x9d, 0x9d, 0xcd, 0x9b, 0x95, 0x56, 0xa7, 0xc1,
+  0x26, 0x0b, 0x80, 0x46, 0x7b, 0x04, 0xb0, 0xf9, 0x91, 0xf7, 0x07, 0xf8, 0xf0, 0x2f, 0x4d, 0x49,
+  0xc9, 0xe7, 0x44, 0xde, 0x6f, 0xc5, 0x63, 0x47, 0xf4, 0xc1, 0xc9, 0x6a, 0x36, 0x19, 0x05, 0xf1,
+  0x8f, 0xf7, 0x38, 0x44, 0x97, 0xf9, 0x51, 0xe8, 0xe0, 0x4d, 0x80, 0x7e, 0x9b, 0x01, 0xb7, 0x20,
+  0x40, 0x45, 0xd9, 0x6f, 0x1a, 0xfd, 0xf8, 0xe3, 0x8f, 0xeb, 0xcd, 0x3c, 0xde, 0xf3, 0x46, 0x4f,
+  0x86, 0xac, 0x0f, 0x0b, 0xbc, 0x0a, 0x7b, 0x38, 0x1d, 0xe3, 0xd4, 0x05, 0x9a, 0x44, 0x2b, 0x26,
+  0xb3, 0x78, 0x61, 0x6c, 0xe5, 0x85, 0x35, 0xa9, 0x78, 0x86, 0xdc, 0xd8, 0x2e, 0xae, 0xee, 0xbe,
+  0x3d, 0x2d, 0xa8, 0x17, 0x85, 0x2d, 0x6e, 0xa6, 0x22, 0x87, 0x05, 0x9a, 0x94, 0xf6, 0x8a, 0x99,
+  0x10, 0xd4, 0xfa, 0x45, 0x06, 0xdf, 0xff, 0xe6, 0x04, 0x76, 0xb8, 0x90, 0x6f, 0x68, 0x03, 0x88,
+  0xc9, 0x7a, 0x3f, 0xd6, 0xfb, 0xdc, 0x67, 0xde, 0x97, 0x06, 0xf9, 0xdf, 0xc5, 0x30, 0xd5, 0x77,
+  0x46, 0xe9, 0xf1, 0x9b, 0x3d, 0x0a, 0xdb, 0xa3, 0xa8, 0x27, 0x99, 0xdf, 0x22, 0x09, 0x7d, 0xcd,
+  0x85, 0x18, 0xa3, 0xb0, 0x0e, 0x52, 0xca, 0xbb, 0x9d, 0x37, 0xb3, 0x11, 0x8a, 0xc2, 0xfd, 0x51,
+  0x14, 0x38, 0x56, 0x73, 0x29, 0x65, 0xdc, 0x1a, 0xf4, 0xbf, 0x2b, 0x6a, 0x46, 0x92, 0x82, 0xaf,
+  0x06, 0x0c, 0x29, 0x09, 0x16, 0xea, 0x34, 0xfc, 0xb7, 0xf3, 0xa9, 0x79, 0xbc, 0xb8, 0x55, 0x54,
+  0xd1, 0x8b, 0x45, 0x1b, 0x53, 0x85, 0x10, 0xe3, 0x89, 0x82, 0x52, 0x38, 0x4b, 0xc4, 0x71, 0x4e,
+  0x49, 0x14, 0x57, 0x8a, 0x63, 0x82, 0xc5, 0x72, 0xf1, 0xae, 0xf9, 0xc0, 0xf7, 0x0e, 0x91, 0x4c,
+  0x3d, 0xa3, 0xbc, 0xed, 0xfe, 0x2f, 0xa0, 0xfd, 0x1d, 0xeb, 0x00, 0xca, 0x74, 0x4d, 0x69, 0x7c,
+  0x44, 0x22, 0x71, 0x7e, 0x89, 0x9d, 0x99, 0xc0, 0x54, 0x39, 0x62, 0x3a, 0x91, 0x18, 0x76, 0xe1,
+  0x26, 0x71, 0xf1, 0x67, 0x66, 0x7a, 0x7e, 0xf2, 0x72, 0x05, 0x97, 0xd7, 0x78, 0x0a, 0x4a, 0x6e,
+  0x41, 0x4b, 0x9d, 0xa8, 0x0b, 0x14, 0x3d, 0xbb, 0x49, 0xe4, 0xfd, 0xf3, 0xae, 0x9e, 0x48, 0xac,
+  0x73, 0x57, 0xef, 0xbd, 0xb7, 0xb2, 0x80, 0xdd, 0x90, 0x33, 0x66, 0xd8, 0xd3, 0x95, 0xf5, 0x9d,
+  0x5a, 0x8d, 0x7f, 0x6b, 0xd0, 0x0b, 0x3c, 0x33, 0x9b, 0x7c, 0xcd, 0xdc, 0x14, 0x56, 0x37, 0x80,
+  0x10, 0xef, 0x6b, 0x84, 0x58, 0xff, 0xdb, 0x69, 0xf2, 0x26, 0x2c, 0xef, 0x72, 0x17, 0xdf, 0x84,
+  0x25, 0xb5, 0x9a, 0xc0, 0x1e, 0x24, 0xee, 0x20, 0x06, 0x16, 0x81, 0xdd, 0xbc, 0x2b, 0x65, 0x8b,
+  0x7a, 0xec, 0xab, 0x2a, 0x45, 0xd2, 0x6e, 0x0f, 0xe5, 0x20, 0xcf, 0x61, 0x37, 0xd1, 0x4a, 0xd1,
+  0x2d, 0x0e, 0x6f, 0xa6, 0x95, 0xd6, 0x2e, 0x3b, 0xda, 0x80, 0xda, 0x6d, 0x08, 0x99, 0x60, 0x8a,
+  0x00, 0x12, 0x9a, 0xa0, 0x19, 0xef, 0xfc, 0x26, 0xad, 0xd0, 0x4c, 0x8a, 0x9a, 0x74, 0x2f, 0x89,
+  0x2b, 0x8d, 0x73, 0x3a, 0xc7, 0x1c, 0x07, 0x99, 0x5a, 0xe0, 0x52, 0xc1, 0x53, 0xb4, 0x8b, 0x20,
+  0x69, 0x8a, 0xdb, 0x9c, 0x42, 0x50, 0xcc, 0x3d, 0x8a, 0xa0, 0x66, 0xf9, 0xc8, 0x3c, 0xaa, 0xa2,
+  0x5c, 0xe2, 0xdf, 0x0f, 0x9d, 0xe2, 0xd3, 0x96, 0xac, 0x88, 0xd8, 0x94, 0x6d, 0xac, 0xf8, 0xdd,
+  0x58, 0x91, 0xa5, 0xca, 0x30, 0x0c, 0x99, 0x31, 0x9d, 0xf7, 0x11, 0xa6, 0xb1, 0x32, 0x11, 0x08,
+  0x1b, 0xfb, 0x06, 0xf2, 0xbf, 0x02, 0x9f, 0xfe, 0xf5, 0x9a, 0x99, 0x5c, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,166 @@
+/*
+  Неблокирующие подключение к WiFi и сканирование сетей
+
+  Раньше connectToWiFi() ждала в цикле delay(500) до 10 с, а scanNetworks()
+  звала синхронный WiFi.scanNetworks(): все это время не обслуживались ни
+  HTTP, ни WebSocket. Здесь обе операции - конечные автоматы: start...()
+  только запускает работу и сразу возвращается, update() раз в проход
+  loop() опрашивает драйвер (status(), scanComplete()) без ожидания и
+  переводит состояние. При каждой смене состояния вызывается onChange.
+
+  Драйвер - параметр шаблона с интерфейсом ESP8266WiFiClass: begin(ssid,
+  password), status(), disconnect(), scanNetworks(async), scanComplete(),
+  scanDelete(). На устройстве это WiFi, на ПК - подделка с теми же
+  методами. Константы WL_* берутся оттуда же (ESP8266WiFi.h или подделка
+  подключается раньше этого файла).
+
+  Использование:
+    WiFiJobs<ESP8266WiFiClass> jobs(WiFi);
+    jobs.startConnect("ssid", "password", millis());
+    loop(): jobs.update(millis());
+            if (jobs.connectState() == WiFiJobs<...>::CONNECT_OK) ...
+*/
+
+#ifndef WIFI_JOBS_H
+#define WIFI_JOBS_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Коды scanComplete() в ядре ESP8266
+#define WIFI_JOBS_SCAN_RUNNING  -1
+#define WIFI_JOBS_SCAN_FAILED   -2
+
+template <class WiFiType>
+class WiFiJobs {
+  public:
+    enum ConnectState { CONNECT_IDLE, CONNECT_WAITING, CONNECT_OK, CONNECT_FAILED };
+    enum ScanState { SCAN_IDLE, SCAN_RUNNING, SCAN_DONE, SCAN_FAILED };
+
+    // Какая операция сменила состояние: true - подключение, false - скан
+    typedef std::function<void(bool connectChanged)> ChangeCallback;
+
+    static const unsigned long DEFAULT_CONNECT_TIMEOUT_MS = 10000;
+
+    WiFiJobs(WiFiType &wifi) : wifi(wifi) {
+      ssid[0] = '\0';
+      password[0] = '\0';
+    }
+
+    void onChange(ChangeCallback callback) { changeCallback = callback; }
+
+    // Запускает подключение; предыдущее незавершенное отменяется
+    bool startConnect(const char* newSsid, const char* newPassword, unsigned long nowMs,
+                      unsigned long timeoutMs = DEFAULT_CONNECT_TIMEOUT_MS) {
+      if (newSsid == nullptr || newSsid[0] == '\0') return false;
+      strlcpy(ssid, newSsid, sizeof(ssid));
+      strlcpy(password, newPassword ? newPassword : "", sizeof(password));
+      wifi.begin(ssid, password);
+      connectStartMs = nowMs;
+      connectTimeoutMs = timeoutMs;
+      setConnectState(CONNECT_WAITING);
+      return true;
+    }
+
+    // WiFi.disconnect() сам по себе не ждет - задержка после него не нужна
+    void disconnect() {
+      wifi.disconnect();
+      setConnectState(CONNECT_IDLE);
+    }
+
+    // Асинхронный скан; повторный запуск во время текущего ничего не делает
+    bool startScan() {
+      if (scan == SCAN_RUNNING) return true;
+      wifi.scanDelete();
+      int result = wifi.scanNetworks(true);
+      if (result == WIFI_JOBS_SCAN_FAILED) {
+        setScanState(SCAN_FAILED);
+        return false;
+      }
+      scanFound = 0;
+      setScanState(SCAN_RUNNING);
+      return true;
+    }
+
+    // Один опрос драйвера, без ожидания
+    void update(unsigned long nowMs) {
+      if (connect == CONNECT_WAITING) {
+        int status = wifi.status();
+        if (status == WL_CONNECTED) {
+          setConnectState(CONNECT_OK);
+        } else if (status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL ||
+                   nowMs - connectStartMs >= connectTimeoutMs) {
+          setConnectState(CONNECT_FAILED);
+        }
+      } else if (connect == CONNECT_OK && wifi.status() != WL_CONNECTED) {
+        // Точка доступа пропала: ядро переподключится само, здесь только статус
+        connectStartMs = nowMs;
+        setConnectState(CONNECT_WAITING);
+      } else if (connect == CONNECT_FAILED && wifi.status() == WL_CONNECTED) {
+        // Ядро дозвонилось уже после таймаута
+        setConnectState(CONNECT_OK);
+      }
+
+      if (scan == SCAN_RUNNING) {
+        int result = wifi.scanComplete();
+        if (result >= 0) {
+          scanFound = result;
+          setScanState(SCAN_DONE);
+        } else if (result != WIFI_JOBS_SCAN_RUNNING) {
+          setScanState(SCAN_FAILED);
+        }
+      }
+    }
+
+    ConnectState connectState() const { return connect; }
+    ScanState scanState() const { return scan; }
+    int scanCount() const { return scan == SCAN_DONE ? scanFound : 0; }
+    const char* connectSsid() const { return ssid; }
+    const char* connectPassword() const { return password; }
+    unsigned long connectElapsedMs(unsigned long nowMs) const {
+      return connect == CONNECT_WAITING ? nowMs - connectStartMs : 0;
+    }
+
+    static const char* connectStateName(ConnectState state) {
+      switch (state) {
+        case CONNECT_WAITING: return "connecting";
+        case CONNECT_OK:      return "connected";
+        case CONNECT_FAILED:  return "failed";
+        default:              return "idle";
+      }
+    }
+
+    static const char* scanStateName(ScanState state) {
+      switch (state) {
+        case SCAN_RUNNING: return "scanning";
+        case SCAN_DONE:    return "done";
+        case SCAN_FAILED:  return "failed";
+        default:           return "idle";
+      }
+    }
+
+  private:
+    WiFiType &wifi;
+    ChangeCallback changeCallback;
+    ConnectState connect = CONNECT_IDLE;
+    ScanState scan = SCAN_IDLE;
+    char ssid[33];
+    char password[65];
+    unsigned long connectStartMs = 0;
+    unsigned long connectTimeoutMs = DEFAULT_CONNECT_TIMEOUT_MS;
+    int scanFound = 0;
+
+    void setConnectState(ConnectState state) {
+      if (state == connect) return;
+      connect = state;
+      if (changeCallback) changeCallback(true);
+    }
+
+    void setScanState(ScanState state) {
+      if (state == scan) return;
+      scan = state;
+      if (changeCallback) changeCallback(false);
+    }
+};
+
+#endif
@@ -1,12 +1,15 @@
 #include "Wifi_ESP8266.h"
+#include "HttpCache.h"
+#include "WebUi.h"
 
 const int EEPROM_SIZE = 512;
 const int SETTINGS_ADDR = 0;
 
 WiFiManager wifiManager;
 
-WiFiManager::WiFiManager() : server(80), webSocketServer(81), connectedDevicesCount(0) {
-  // Конструктор
+WiFiManager::WiFiManager() : server(80), webSocketServer(81), connectedDevicesCount(0),
+                             wifiJobs(WiFi), restartPending(false), restartAtMs(0) {
+  wifiJobs.onChange(std::bind(&WiFiManager::onWiFiJobChange, this, std::placeholders::_1));
 }
 
 void WiFiManager::begin() {
@@ -66,11 +69,20 @@ void WiFiManager::handleClient() {
 }
 
 void WiFiManager::update() {
+  // Подключение и скан опрашиваются на каждом проходе - они не ждут
+  unsigned long now = millis();
+  wifiJobs.update(now);
+  if (restartPending && (long)(now - restartAtMs) >= 0) {
+    ESP.restart();
+  }
+  
+  // Loop-обработчики - на каждом проходе, каждый по своему расписанию
+  processWebSocketLoopHandlers();
+  
   // Метод для периодического обновления состояния
   static unsigned long lastUpdate = 0;
   if (millis() - lastUpdate > 5000) {
     updateConnectedDevices();
-    processWebSocketLoopHandlers();
     lastUpdate = millis();
   }
 }
@@ -86,35 +98,116 @@ void WiFiManager::webSocket(const String& path, WebSocketCallback callback) {
   Serial.println("WebSocket handler registered for path: " + path);
 }
 
+void WiFiManager::webSocketView(const String& path, WebSocketViewCallback callback) {
+  WebSocketHandler handler;
+  handler.path = path;
+  handler.viewCallback = callback;
+  handler.useLoopMode = false;
+  webSocketHandlers.push_back(handler);
+  
+  Serial.println("WebSocket view handler registered for path: " + path);
+}
+
 void WiFiManager::webSocketLoop(const String& path, WebSocketLoopCallback loopCallback) {
+  webSocketLoop(path, loopCallback, WS_LOOP_DEFAULT_PERIOD_MS, WS_LOOP_DEFAULT_TRIGGERS);
+}
+
+void WiFiManager::webSocketLoop(const String& path, WebSocketLoopCallback loopCallback,
+                                uint32_t periodMs, uint8_t triggers, uint32_t budgetUs) {
   WebSocketHandler handler;
   handler.path = path;
   handler.loopCallback = loopCallback;
   handler.useLoopMode = true;
+  handler.schedule = LoopSchedule(periodMs, triggers, budgetUs);
   webSocketHandlers.push_back(handler);
   
   Serial.println("WebSocket loop handler registered for path: " + path);
 }
 
+// Строка отдается библиотеке как есть, без копии
 void WiFiManager::sendWebSocketMessage(uint8_t num, const String& message) {
+  sendWebSocketMessage(num, (const uint8_t*)message.c_str(), message.length());
+}
+
+void WiFiManager::sendWebSocketMessage(uint8_t num, const uint8_t* data, size_t length) {
   if (num < 10 && webSocketServer.connectedClients() > num) {
-    String msg = message; // Создаем неконстантную копию
-    webSocketServer.sendTXT(num, msg);
+    webSocketServer.sendTXT(num, data, length);
   }
 }
 
 void WiFiManager::sendWebSocketBroadcast(const String& message) {
-  String msg = message; // Создаем неконстантную копию
-  webSocketServer.broadcastTXT(msg);
+  sendWebSocketBroadcast((const uint8_t*)message.c_str(), message.length());
+}
+
+void WiFiManager::sendWebSocketBroadcast(const uint8_t* data, size_t length) {
+  webSocketServer.broadcastTXT(data, length);
 }
 
 String WiFiManager::readWebSocketCommand(uint8_t num) {
-  if (num < 10 && !webSocketCommands[num].empty()) {
-    String command = webSocketCommands[num].front();
-    webSocketCommands[num].erase(webSocketCommands[num].begin());
-    return command;
+  String command;
+  readWebSocketCommand(num, command);
+  return command;
+}
+
+// Буфер command уходит в очередь взамен, так что повторные вызовы с
+// одной и той же строкой не выделяют память
+bool WiFiManager::readWebSocketCommand(uint8_t num, String& command) {
+  return num < WS_DISPATCH_MAX_CLIENTS && webSocketCommands[num].pop(command);
+}
+
+void WiFiManager::setWebSocketQueuePolicy(CommandQueuePolicy policy) {
+  for (uint8_t i = 0; i < WS_DISPATCH_MAX_CLIENTS; i++) {
+    webSocketCommands[i].setPolicy(policy);
   }
-  return "";
+}
+
+String WiFiManager::getWebSocketStats() {
+  DynamicJsonDocument doc(3072);
+  JsonArray clients = doc.createNestedArray("clients");
+  
+  for (uint8_t i = 0; i < WS_DISPATCH_MAX_CLIENTS; i++) {
+    const CommandQueueStats& stats = webSocketCommands[i].stats();
+    uint8_t route = webSocketRoutes.route(i);
+    if (route == WS_DISPATCH_NO_ROUTE && stats.pushed == 0) continue;
+    
+    JsonObject client = clients.createNestedObject();
+    client["num"] = i;
+    if (route < webSocketHandlers.size()) {
+      client["path"] = webSocketHandlers[route].path;
+    } else {
+      client["path"] = nullptr;
+    }
+    client["queued"] = webSocketCommands[i].size();
+    client["pushed"] = stats.pushed;
+    client["dropped"] = stats.dropped;
+    client["high_water"] = stats.highWater;
+  }
+  
+  JsonArray loopHandlers = doc.createNestedArray("loop_handlers");
+  for (auto& handler : webSocketHandlers) {
+    if (!handler.useLoopMode) continue;
+    
+    const LoopScheduleStats& stats = handler.schedule.stats();
+    JsonObject loopHandler = loopHandlers.createNestedObject();
+    loopHandler["path"] = handler.path;
+    loopHandler["period_ms"] = handler.schedule.period();
+    loopHandler["budget_us"] = handler.schedule.budget();
+    loopHandler["runs"] = stats.runs;
+    loopHandler["overruns"] = stats.overruns;
+    loopHandler["last_us"] = stats.lastUs;
+    loopHandler["max_us"] = stats.maxUs;
+    loopHandler["avg_us"] = stats.runs > 0 ? (uint32_t)(stats.totalUs / stats.runs) : 0;
+  }
+  
+  const FragmentStats& fragments = webSocketFragments.stats();
+  JsonObject fragmentStats = doc.createNestedObject("fragments");
+  fragmentStats["assembled"] = fragments.assembled;
+  fragmentStats["overflowed"] = fragments.overflowed;
+  fragmentStats["interleaved"] = fragments.interleaved;
+  
+  String response;
+  serializeJson(doc, response);
+  return response;
 }
 
 bool WiFiManager::isWebSocketClientConnected(uint8_t num) {
@@ -132,9 +225,11 @@ void WiFiManager::handleWebSocketEvent(uint8_t num, WStype_t type, uint8_t * pay
     case WStype_DISCONNECTED:
       Serial.printf("[%u] Disconnected!\n", num);
       // Очищаем буфер команд при отключении
-      if (num < 10) {
+      if (num < WS_DISPATCH_MAX_CLIENTS) {
         webSocketCommands[num].clear();
       }
+      webSocketRoutes.unbind(num);
+      webSocketFragments.abandon(num);
       break;
       
     case WStype_CONNECTED:
@@ -142,6 +237,13 @@ void WiFiManager::handleWebSocketEvent(uint8_t num, WStype_t type, uint8_t * pay
         IPAddress ip = webSocketServer.remoteIP(num);
         Serial.printf("[%u] Connected from %d.%d.%d.%d url: %s\n", num, ip[0], ip[1], ip[2], ip[3], payload);
         
+        // Обработчик выбирается один раз по пути подключения
+        uint8_t route = findWebSocketRoute((const char*)payload);
+        webSocketRoutes.bind(num, route);
+        if (route < webSocketHandlers.size()) {
+          webSocketHandlers[route].schedule.signal(LOOP_TRIGGER_CONNECT);
+        }
+        
         // Отправляем приветственное сообщение
         webSocketServer.sendTXT(num, "Connected to ESP8266 WebSocket");
       }
@@ -149,23 +251,10 @@ void WiFiManager::handleWebSocketEvent(uint8_t num, WStype_t type, uint8_t * pay
       
     case WStype_TEXT:
       {
-        String message = String((char*)payload);
-        Serial.printf("[%u] Received: %s\n", num, message);
-        
-        // Сохраняем команду в буфер
-        if (num < 10) {
-          webSocketCommands[num].push_back(message);
-        }
-        
-        // Обрабатываем команду через зарегистрированные обработчики
-        for (auto& handler : webSocketHandlers) {
-          if (!handler.useLoopMode && handler.callback) {
-            String response = handler.callback(message);
-            if (response.length() > 0) {
-              webSocketServer.sendTXT(num, response);
-            }
-          }
-        }
+        // Библиотека завершает payload нулем; читаем на месте, без String
+        WebSocketMessage message = {(const char*)payload, length};
+        Serial.printf("[%u] Received: %s\n", num, message.data);
+        dispatchWebSocketText(num, message);
       }
       break;
       
@@ -182,56 +271,102 @@ void WiFiManager::handleWebSocketEvent(uint8_t num, WStype_t type, uint8_t * pay
       // Игнорируем ping/pong
       break;
       
+    // Фрагменты собираются в webSocketFragments; готовый текст идет
+    // тем же путем, что и целое сообщение, двоичный - отбрасывается, как WStype_BIN
     case WStype_FRAGMENT_TEXT_START:
+      webSocketFragments.start(num, true, payload, length);
+      break;
+      
     case WStype_FRAGMENT_BIN_START:
+      webSocketFragments.start(num, false, payload, length);
+      break;
+      
     case WStype_FRAGMENT:
+      webSocketFragments.append(num, payload, length);
+      break;
+      
     case WStype_FRAGMENT_FIN:
-      // Фрагментированные сообщения не поддерживаются
+      if (webSocketFragments.finish(num, payload, length) && webSocketFragments.text()) {
+        WebSocketMessage message = {webSocketFragments.data(), webSocketFragments.length()};
+        Serial.printf("[%u] Received fragmented: %u bytes\n", num, message.length);
+        dispatchWebSocketText(num, message);
+      }
       break;
   }
 }
 
+uint8_t WiFiManager::findWebSocketRoute(const char* url) {
+  for (size_t i = 0; i < webSocketHandlers.size() && i < WS_DISPATCH_NO_ROUTE; i++) {
+    if (WebSocketRoutes::pathMatches(url, webSocketHandlers[i].path.c_str())) {
+      return (uint8_t)i;
+    }
+  }
+  return WS_DISPATCH_NO_ROUTE;
+}
+
+void WiFiManager::dispatchWebSocketText(uint8_t num, const WebSocketMessage& message) {
+  // Ровно один обработчик - тот, чей путь совпал при подключении
+  uint8_t route = webSocketRoutes.route(num);
+  if (route < webSocketHandlers.size()) {
+    WebSocketHandler& handler = webSocketHandlers[route];
+    if (handler.viewCallback) {
+      handler.viewCallback(num, message);
+      return;
+    }
+    if (!handler.useLoopMode && handler.callback) {
+      // String только для обработчиков со старой сигнатурой
+      String response = handler.callback(String(message.data));
+      if (response.length() > 0) {
+        webSocketServer.sendTXT(num, response);
+      }
+      return;
+    }
+  }
+  
+  // Loop-обработчик (или путь без обработчика) читает очередь клиента сам;
+  // его расписание узнает о сообщении и позовет его на этом же проходе loop()
+  if (num < WS_DISPATCH_MAX_CLIENTS) {
+    webSocketCommands[num].push(message.data);
+  }
+  if (route < webSocketHandlers.size()) {
+    webSocketHandlers[route].schedule.signal(LOOP_TRIGGER_MESSAGE);
+  }
+}
+
 void WiFiManager::processWebSocketLoopHandlers() {
-  for (auto& handler : webSocketHandlers) {
-    if (handler.useLoopMode && handler.loopCallback) {
+  unsigned long nowMs = millis();
+  for (size_t route = 0; route < webSocketHandlers.size(); route++) {
+    WebSocketHandler& handler = webSocketHandlers[route];
+    if (handler.useLoopMode && handler.loopCallback && handler.schedule.due(nowMs)) {
+      uint32_t startUs = micros();
       handler.loopCallback();
+      handler.schedule.ran(nowMs, micros() - startUs);
+      // Обработчик прочитал не все: зовем его снова на следующем проходе,
+      // а не по периоду
+      if (hasQueuedWebSocketCommands(route)) {
+        handler.schedule.signal(LOOP_TRIGGER_MESSAGE);
+      }
     }
   }
 }
 
+bool WiFiManager::hasQueuedWebSocketCommands(size_t route) {
+  for (uint8_t i = 0; i < WS_DISPATCH_MAX_CLIENTS; i++) {
+    if (webSocketRoutes.route(i) == route && !webSocketCommands[i].empty()) return true;
+  }
+  return false;
+}
+
 bool WiFiManager::connectToWiFi(const char* ssid, const char* password) {
-  if (strlen(ssid) == 0) return false;
+  // Только запуск: итог придет в onWiFiJobChange()
+  if (!wifiJobs.startConnect(ssid, password, millis())) return false;
   
   Serial.println("Connecting to WiFi: " + String(ssid));
-  WiFi.begin(ssid, password);
-  
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
-  
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\nWiFi connected!");
-    Serial.println("IP address: " + WiFi.localIP().toString());
-    
-    // Сохраняем учетные данные
-    strlcpy(settings.sta_ssid, ssid, sizeof(settings.sta_ssid));
-    strlcpy(settings.sta_password, password, sizeof(settings.sta_password));
-    settings.client_mode_enabled = true;
-    saveSettings();
-    
-    return true;
-  } else {
-    Serial.println("\nFailed to connect to WiFi");
-    return false;
-  }
+  return true;
 }
 
 void WiFiManager::disconnectFromWiFi() {
-  WiFi.disconnect();
-  delay(1000);
+  wifiJobs.disconnect();
   
   // Очищаем сохраненные учетные данные
   memset(settings.sta_ssid, 0, sizeof(settings.sta_ssid));
@@ -242,8 +377,44 @@ void WiFiManager::disconnectFromWiFi() {
   Serial.println("Disconnected from WiFi");
 }
 
+void WiFiManager::onWiFiJobChange(bool connectChanged) {
+  WebSocketFrame<40> message;
+  
+  if (connectChanged) {
+    ESP8266WiFiJobs::ConnectState state = wifiJobs.connectState();
+    if (state == ESP8266WiFiJobs::CONNECT_OK) {
+      Serial.println("WiFi connected!");
+      Serial.println("IP address: " + WiFi.localIP().toString());
+      
+      // Сохраняем учетные данные, только если они новые (запись во флеш)
+      if (!settings.client_mode_enabled ||
+          strcmp(settings.sta_ssid, wifiJobs.connectSsid()) != 0 ||
+          strcmp(settings.sta_password, wifiJobs.connectPassword()) != 0) {
+        strlcpy(settings.sta_ssid, wifiJobs.connectSsid(), sizeof(settings.sta_ssid));
+        strlcpy(settings.sta_password, wifiJobs.connectPassword(), sizeof(settings.sta_password));
+        settings.client_mode_enabled = true;
+        saveSettings();
+      }
+    } else if (state == ESP8266WiFiJobs::CONNECT_FAILED) {
+      Serial.println("Failed to connect to WiFi");
+    }
+    message.appendf("WIFI_CONNECT:%s", ESP8266WiFiJobs::connectStateName(state));
+  } else {
+    message.appendf("WIFI_SCAN:%s:%d",
+                    ESP8266WiFiJobs::scanStateName(wifiJobs.scanState()), wifiJobs.scanCount());
+  }
+  
+  // Страница настройки слушает WebSocket и обновляется без опроса
+  broadcastWebSocketFrame(message);
+}
+
+bool WiFiManager::startWiFiScan() {
+  return wifiJobs.startScan();
+}
+
+// Результаты последнего завершенного скана (startWiFiScan())
 bool WiFiManager::scanNetworks(JsonArray& networks) {
-  int n = WiFi.scanNetworks();
+  int n = wifiJobs.scanCount();
   if (n == 0) return false;
   
   for (int i = 0; i < n; i++) {
@@ -284,6 +455,9 @@ String WiFiManager::getWiFiStatus() {
   } else {
     doc["connected"] = false;
   }
+  doc["state"] = ESP8266WiFiJobs::connectStateName(wifiJobs.connectState());
+  doc["elapsed_ms"] = wifiJobs.connectElapsedMs(millis());
+  doc["scan"] = ESP8266WiFiJobs::scanStateName(wifiJobs.scanState());
   
   String response;
   serializeJson(doc, response);
@@ -329,17 +503,23 @@ void WiFiManager::setupWebServer() {
   
   // API маршруты WiFi
   server.on("/api/wifi-scan", HTTP_GET, [this]() {
+    // Скан идет в фоне: запрос без готовых результатов (или с ?refresh=1)
+    // запускает его и сразу получает status "scanning"; сети - повторным
+    // запросом после WebSocket WIFI_SCAN:done
+    ESP8266WiFiJobs::ScanState state = wifiJobs.scanState();
+    if (server.hasArg("refresh") || state == ESP8266WiFiJobs::SCAN_IDLE ||
+        state == ESP8266WiFiJobs::SCAN_FAILED) {
+      this->startWiFiScan();
+    }
+    
     DynamicJsonDocument doc(2048);
+    doc["status"] = ESP8266WiFiJobs::scanStateName(wifiJobs.scanState());
     JsonArray networks = doc.createNestedArray("networks");
+    this->scanNetworks(networks);
     
-    if (this->scanNetworks(networks)) {
-      String response;
-      serializeJson(doc, response);
-      
-      server.send(200, "application/json", response);
-    } else {
-      server.send(200, "application/json", "{\"networks\":[]}");
-    }
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
   });
   
   server.on("/api/wifi-connect", HTTP_POST, [this]() {
@@ -350,10 +530,11 @@ void WiFiManager::setupWebServer() {
       String ssid = doc["ssid"];
       String password = doc["password"];
       
+      // 202: подключение только началось, итог - /api/wifi-status или WIFI_CONNECT:
       if (this->connectToWiFi(ssid.c_str(), password.c_str())) {
-        server.send(200, "application/json", "{\"status\":\"connected\"}");
+        server.send(202, "application/json", "{\"status\":\"connecting\"}");
       } else {
-        server.send(400, "application/json", "{\"error\":\"connection_failed\"}");
+        server.send(400, "application/json", "{\"error\":\"no_ssid\"}");
       }
     } else {
       server.send(400, "application/json", "{\"error\":\"no_data\"}");
@@ -369,6 +550,10 @@ void WiFiManager::setupWebServer() {
     server.send(200, "application/json", this->getWiFiStatus());
   });
   
+  server.on("/api/websocket-stats", HTTP_GET, [this]() {
+    server.send(200, "application/json", this->getWebSocketStats());
+  });
+  
   // API маршруты настроек и устройств
   server.on("/api/settings", HTTP_GET, std::bind(&WiFiManager::handleGetSettings, this));
   server.on("/api/settings", HTTP_POST, std::bind(&WiFiManager::handlePostSettings, this));
@@ -475,6 +660,10 @@ void WiFiManager::setupWebServer() {
   
   server.onNotFound(std::bind(&WiFiManager::handleNotFound, this));
   
+  // Без этого ESP8266WebServer отбрасывает заголовок и 304 не случится
+  static const char* collectedHeaders[] = {"If-None-Match"};
+  server.collectHeaders(collectedHeaders, 1);
+  
   server.begin();
   Serial.println("HTTP server started with full web interface");
 }
@@ -519,484 +708,19 @@ String WiFiManager::macToString(uint8_t* mac) {
 }
 
 void WiFiManager::handleRoot() {
-  WiFiClient client = server.client();
-  
-  // Отправляем HTTP заголовок
-  client.println("HTTP/1.1 200 OK");
-  client.println("Content-Type: text/html");
-  client.println("Connection: close");
-  client.println();
-  
-  // Отправляем HTML частями
-  client.println("<!DOCTYPE html>");
-  client.println("<html>");
-  client.println("<head>");
-  client.println("    <title>ESP8266 Configuration</title>");
-  client.println("    <meta charset=\"UTF-8\">");
-  client.println("    <meta name=\"viewport\" content=\"width=device-width, initial-scale=1.0\">");
-  client.println("    <style>");
-  client.println("        body { font-family: Arial, sans-serif; margin: 0; padding: 20px; background-color: #f5f5f5; }");
-  client.println("        .container { max-width: 800px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }");
-  client.println("        .tab { overflow: hidden; border: 1px solid #ccc; background-color: #f1f1f1; border-radius: 5px 5px 0 0; }");
-  client.println("        .tab button { background-color: inherit; float: left; border: none; outline: none; cursor: pointer; padding: 14px 16px; transition: 0.3s; font-size: 17px; }");
-  client.println("        .tab button:hover { background-color: #ddd; }");
-  client.println("        .tab button.active { background-color: #4CAF50; color: white; }");
-  client.println("        .tabcontent { display: none; padding: 20px; border: 1px solid #ccc; border-top: none; border-radius: 0 0 5px 5px; }");
-  client.println("        .form-group { margin-bottom: 15px; }");
-  client.println("        label { display: block; margin-bottom: 5px; font-weight: bold; }");
-  client.println("        input, select, textarea { width: 100%; padding: 8px; border: 1px solid #ddd; border-radius: 4px; box-sizing: border-box; }");
-  client.println("        button { background-color: #4CAF50; color: white; padding: 10px 15px; border: none; border-radius: 4px; cursor: pointer; margin: 5px; }");
-  client.println("        button:hover { background-color: #45a049; }");
-  client.println("        table { width: 100%; border-collapse: collapse; margin-top: 10px; }");
-  client.println("        th, td { border: 1px solid #ddd; padding: 8px; text-align: left; }");
-  client.println("        th { background-color: #f2f2f2; }");
-  client.println("        .modal { display: none; position: fixed; z-index: 1; left: 0; top: 0; width: 100%; height: 100%; background-color: rgba(0,0,0,0.4); }");
-  client.println("        .modal-content { background-color: #fefefe; margin: 15% auto; padding: 20px; border: 1px solid #888; width: 80%; max-width: 500px; border-radius: 5px; }");
-  client.println("        .close { color: #aaa; float: right; font-size: 28px; font-weight: bold; cursor: pointer; }");
-  client.println("        .close:hover { color: black; }");
-  client.println("        .wifi-network { border: 1px solid #ddd; padding: 10px; margin: 5px 0; border-radius: 4px; }");
-  client.println("        .wifi-connected { background-color: #e8f5e8; }");
-  client.println("        .wifi-disconnected { background-color: #f5f5f5; }");
-  client.println("        .tablinks{ color: black; }");
-  client.println("        .connection-status { padding: 10px; border-radius: 4px; margin: 10px 0; }");
-  client.println("        .connected { background-color: #d4edda; color: #155724; }");
-  client.println("        .disconnected { background-color: #f8d7da; color: #721c24; }");
-  client.println("    </style>");
-  
-  // WebSocket JavaScript
-  client.println("    <script>");
-  client.println("        // WebSocket функции для основной страницы");
-  client.println("        let mainWS = null;");
-  client.println("        ");
-  client.println("        function connectMainWebSocket() {");
-  client.println("            const wsUrl = 'ws://' + window.location.hostname + ':81/api/web_socket';");
-  client.println("            mainWS = new WebSocket(wsUrl);");
-  client.println("            ");
-  client.println("            mainWS.onopen = function() {");
-  client.println("                console.log('Main WebSocket connected');");
-  client.println("                updateWebSocketStatus('connected');");
-  client.println("            };");
-  client.println("            ");
-  client.println("            mainWS.onclose = function() {");
-  client.println("                console.log('Main WebSocket disconnected');");
-  client.println("                updateWebSocketStatus('disconnected');");
-  client.println("                // Попытка переподключения через 3 секунды");
-  client.println("                setTimeout(connectMainWebSocket, 3000);");
-  client.println("            };");
-  client.println("            ");
-  client.println("            mainWS.onmessage = function(event) {");
-  client.println("                console.log('WebSocket message:', event.data);");
-  client.println("                handleWebSocketMessage(event.data);");
-  client.println("            };");
-  client.println("            ");
-  client.println("            mainWS.onerror = function(error) {");
-  client.println("                console.error('WebSocket error:', error);");
-  client.println("                updateWebSocketStatus('error');");
-  client.println("            };");
-  client.println("        }");
-  client.println("        ");
-  client.println("        function updateWebSocketStatus(status) {");
-  client.println("            const statusElement = document.getElementById('websocketStatus');");
-  client.println("            if (statusElement) {");
-  client.println("                statusElement.textContent = 'WebSocket: ' + status;");
-  client.println("                statusElement.className = 'connection-status ' + ");
-  client.println("                    (status === 'connected' ? 'connected' : 'disconnected');");
-  client.println("            }");
-  client.println("        }");
-  client.println("        ");
-  client.println("        function handleWebSocketMessage(message) {");
-  client.println("            // Обработка входящих сообщений WebSocket");
-  client.println("            // Можно добавить свою логику здесь");
-  client.println("            if (message.startsWith('DEVICE_UPDATE')) {");
-  client.println("                loadConnectedDevices();");
-  client.println("            }");
-  client.println("        }");
-  client.println("        ");
-  client.println("        function sendWebSocketMessage(message) {");
-  client.println("            if (mainWS && mainWS.readyState === WebSocket.OPEN) {");
-  client.println("                mainWS.send(message);");
-  client.println("            } else {");
-  client.println("                console.warn('WebSocket not connected');");
-  client.println("            }");
-  client.println("        }");
-  client.println("        ");
-  client.println("        // Автоподключение при загрузке страницы");
-  client.println("        document.addEventListener('DOMContentLoaded', function() {");
-  client.println("            connectMainWebSocket();");
-  client.println("            ");
-  client.println("            // Добавляем статус WebSocket в интерфейс");
-  client.println("            const statusTab = document.getElementById('Status');");
-  client.println("            if (statusTab) {");
-  client.println("                const statusElement = document.createElement('div');");
-  client.println("                statusElement.id = 'websocketStatus';");
-  client.println("                statusElement.className = 'connection-status disconnected';");
-  client.println("                statusElement.textContent = 'WebSocket: disconnected';");
-  client.println("                statusTab.insertBefore(statusElement, statusTab.firstChild);");
-  client.println("            }");
-  client.println("        });");
-  client.println("    </script>");
-  
-  // Основной JavaScript
-  client.println("    <script>");
-  client.println("        function openTab(evt, tabName) {");
-  client.println("            var i, tabcontent, tablinks;");
-  client.println("            tabcontent = document.getElementsByClassName(\"tabcontent\");");
-  client.println("            for (i = 0; i < tabcontent.length; i++) {");
-  client.println("                tabcontent[i].style.display = \"none\";");
-  client.println("            }");
-  client.println("            tablinks = document.getElementsByClassName(\"tablinks\");");
-  client.println("            for (i = 0; i < tablinks.length; i++) {");
-  client.println("                tablinks[i].className = tablinks[i].className.replace(\" active\", \"\");");
-  client.println("            }");
-  client.println("            document.getElementById(tabName).style.display = \"block\";");
-  client.println("            evt.currentTarget.className += \" active\";");
-  client.println("            ");
-  client.println("            if (tabName === 'Status') {");
-  client.println("                loadConnectedDevices();");
-  client.println("            } else if (tabName === 'APSettings') {");
-  client.println("                loadAPSettings();");
-  client.println("            } else if (tabName === 'WiFiScan') {");
-  client.println("                loadWiFiStatus();");
-  client.println("                scanWiFi();");
-  client.println("            } else if (tabName === 'DeviceConfig') {");
-  client.println("                loadDeviceConfig();");
-  client.println("            } else if (tabName === 'DeviceControl') {");
-  client.println("                loadDeviceControl();");
-  client.println("            }");
-  client.println("        }");
-  client.println("");
-  client.println("        function loadConnectedDevices() {");
-  client.println("            fetch('/api/connected-devices')");
-  client.println("                .then(response => response.json())");
-  client.println("                .then(data => {");
-  client.println("                    let table = '<table><tr><th>IP Адрес</th><th>MAC Адрес</th><th>Имя устройства</th><th>Комментарий</th><th>Действия</th></tr>';");
-  client.println("                    data.devices.forEach(device => {");
-  client.println("                        table += `<tr>");
-  client.println("                            <td>${device.ip}</td>");
-  client.println("                            <td>${device.mac}</td>");
-  client.println("                            <td>${device.device_name || ''}</td>");
-  client.println("                            <td>${device.device_comment || ''}</td>");
-  client.println("                            <td><button onclick=\"showDeviceInfo('${device.mac}', '${device.device_name || ''}', '${device.device_comment || ''}')\">Информация об устройстве</button></td>");
-  client.println("                        </tr>`;");
-  client.println("                    });");
-  client.println("                    table += '</table>';");
-  client.println("                    document.getElementById('connectedDevicesTable').innerHTML = table;");
-  client.println("                });");
-  client.println("        }");
-  client.println("");
-  client.println("        function showDeviceInfo(mac, name, comment) {");
-  client.println("            document.getElementById('modalDeviceMac').value = mac;");
-  client.println("            document.getElementById('modalDeviceName').value = name || '';");
-  client.println("            document.getElementById('modalDeviceComment').value = comment || '';");
-  client.println("            document.getElementById('deviceInfoModal').style.display = 'block';");
-  client.println("        }");
-  client.println("");
-  client.println("        function closeModal() {");
-  client.println("            document.getElementById('deviceInfoModal').style.display = 'none';");
-  client.println("        }");
-  client.println("");
-  client.println("        function saveDeviceInfo() {");
-  client.println("            const mac = document.getElementById('modalDeviceMac').value;");
-  client.println("            const name = document.getElementById('modalDeviceName').value;");
-  client.println("            const comment = document.getElementById('modalDeviceComment').value;");
-  client.println("            ");
-  client.println("            fetch('/api/device-info', {");
-  client.println("                method: 'POST',");
-  client.println("                headers: { 'Content-Type': 'application/json' },");
-  client.println("                body: JSON.stringify({ mac: mac, device_name: name, device_comment: comment })");
-  client.println("            }).then(() => {");
-  client.println("                closeModal();");
-  client.println("                loadConnectedDevices();");
-  client.println("            });");
-  client.println("        }");
-  client.println("");
-  client.println("        function loadAPSettings() {");
-  client.println("            fetch('/api/settings')");
-  client.println("                .then(response => response.json())");
-  client.println("                .then(settings => {");
-  client.println("                    document.getElementById('apSsid').value = settings.ap_ssid || '';");
-  client.println("                    document.getElementById('apPassword').value = settings.ap_password || '';");
-  client.println("                    ");
-  client.println("                    const subnetSelect = document.getElementById('subnet');");
-  client.println("                    subnetSelect.innerHTML = '';");
-  client.println("                    for (let i = 1; i <= 255; i++) {");
-  client.println("                        const option = document.createElement('option');");
-  client.println("                        option.value = i;");
-  client.println("                        option.textContent = '192.168.' + i + '.1';");
-  client.println("                        if (i === (settings.subnet || 4)) {");
-  client.println("                            option.selected = true;");
-  client.println("                        }");
-  client.println("                        subnetSelect.appendChild(option);");
-  client.println("                    }");
-  client.println("                });");
-  client.println("        }");
-  client.println("");
-  client.println("        function saveAPSettings() {");
-  client.println("            const settings = {");
-  client.println("                ap_ssid: document.getElementById('apSsid').value,");
-  client.println("                ap_password: document.getElementById('apPassword').value,");
-  client.println("                subnet: parseInt(document.getElementById('subnet').value)");
-  client.println("            };");
-  client.println("            ");
-  client.println("            fetch('/api/settings', {");
-  client.println("                method: 'POST',");
-  client.println("                headers: { 'Content-Type': 'application/json' },");
-  client.println("                body: JSON.stringify(settings)");
-  client.println("            }).then(() => alert('Настройки точки доступа сохранены'));");
-  client.println("        }");
-  client.println("");
-  client.println("        function scanWiFi() {");
-  client.println("            fetch('/api/wifi-scan')");
-  client.println("                .then(response => response.json())");
-  client.println("                .then(data => {");
-  client.println("                    let networksHTML = '<h3>Доступные сети:</h3>';");
-  client.println("                    data.networks.forEach(network => {");
-  client.println("                        const encryption = network.encryption === 7 ? 'Open' : 'Secured';");
-  client.println("                        networksHTML += `");
-  client.println("                            <div class=\"wifi-network\">");
-  client.println("                                <strong>${network.ssid}</strong><br>");
-  client.println("                                Сигнал: ${network.rssi}dBm | Защита: ${encryption}<br>");
-  client.println("                                <input type=\"password\" id=\"password_${network.ssid.replace(/[^a-zA-Z0-9]/g, '_')}\" placeholder=\"Пароль\" style=\"width: 200px; margin: 5px 0;\">");
-  client.println("                                <button onclick=\"connectToNetwork('${network.ssid}', ${network.encryption})\">Подключиться</button>");
-  client.println("                            </div>");
-  client.println("                        `;");
-  client.println("                    });");
-  client.println("                    document.getElementById('wifiNetworks').innerHTML = networksHTML;");
-  client.println("                });");
-  client.println("        }");
-  client.println("");
-  client.println("        function connectToNetwork(ssid, encryption) {");
-  client.println("            const passwordId = 'password_' + ssid.replace(/[^a-zA-Z0-9]/g, '_');");
-  client.println("            const password = document.getElementById(passwordId).value;");
-  client.println("            ");
-  client.println("            if (encryption !== 7 && !password) {");
-  client.println("                alert('Для защищенной сети необходим пароль');");
-  client.println("                return;");
-  client.println("            }");
-  client.println("            ");
-  client.println("            const connectionData = {");
-  client.println("                ssid: ssid,");
-  client.println("                password: password");
-  client.println("            };");
-  client.println("            ");
-  client.println("            fetch('/api/wifi-connect', {");
-  client.println("                method: 'POST',");
-  client.println("                headers: { 'Content-Type': 'application/json' },");
-  client.println("                body: JSON.stringify(connectionData)");
-  client.println("            })");
-  client.println("            .then(response => response.json())");
-  client.println("            .then(data => {");
-  client.println("                alert('Подключение к сети ' + ssid + ' выполнено');");
-  client.println("                loadWiFiStatus();");
-  client.println("            })");
-  client.println("            .catch(error => {");
-  client.println("                alert('Ошибка подключения к сети');");
-  client.println("            });");
-  client.println("        }");
-  client.println("");
-  client.println("        function disconnectFromWiFi() {");
-  client.println("            if (confirm('Отключиться от текущей WiFi сети?')) {");
-  client.println("                fetch('/api/wifi-disconnect', { method: 'POST' })");
-  client.println("                    .then(response => response.json())");
-  client.println("                    .then(data => {");
-  client.println("                        alert('Отключено от WiFi сети');");
-  client.println("                        loadWiFiStatus();");
-  client.println("                        scanWiFi();");
-  client.println("                    });");
-  client.println("            }");
-  client.println("        }");
-  client.println("");
-  client.println("        function loadWiFiStatus() {");
-  client.println("            fetch('/api/wifi-status')");
-  client.println("                .then(response => response.json())");
-  client.println("                .then(data => {");
-  client.println("                    let statusHTML = '';");
-  client.println("                    if (data.connected) {");
-  client.println("                        statusHTML = `");
-  client.println("                            <div class=\"connection-status connected\">");
-  client.println("                                <strong>Подключено к WiFi</strong><br>");
-  client.println("                                Сеть: ${data.ssid}<br>");
-  client.println("                                IP: ${data.ip}<br>");
-  client.println("                                Сигнал: ${data.rssi}dBm");
-  client.println("                            </div>");
-  client.println("                            <button onclick=\"disconnectFromWiFi()\" style=\"background-color: #f44336;\">Отключиться от точки доступа</button>");
-  client.println("                        `;");
-  client.println("                    } else {");
-  client.println("                        statusHTML = `");
-  client.println("                            <div class=\"connection-status disconnected\">");
-  client.println("                                <strong>Не подключено к WiFi</strong>");
-  client.println("                            </div>");
-  client.println("                        `;");
-  client.println("                    }");
-  client.println("                    document.getElementById('wifiStatus').innerHTML = statusHTML;");
-  client.println("                });");
-  client.println("        }");
-  client.println("");
-  client.println("        function loadDeviceConfig() {");
-  client.println("            fetch('/api/settings')");
-  client.println("                .then(response => response.json())");
-  client.println("                .then(settings => {");
-  client.println("                    document.getElementById('deviceName').value = settings.device_name || '';");
-  client.println("                    document.getElementById('deviceComment').value = settings.device_comment || '';");
-  client.println("                });");
-  client.println("        }");
-  client.println("");
-  client.println("        function saveDeviceConfig() {");
-  client.println("            const config = {");
-  client.println("                device_name: document.getElementById('deviceName').value,");
-  client.println("                device_comment: document.getElementById('deviceComment').value");
-  client.println("            };");
-  client.println("            ");
-  client.println("            fetch('/api/settings', {");
-  client.println("                method: 'POST',");
-  client.println("                headers: { 'Content-Type': 'application/json' },");
-  client.println("                body: JSON.stringify(config)");
-  client.println("            }).then(() => alert('Настройки устройства сохранены'));");
-  client.println("        }");
-  client.println("");
-  client.println("        function loadDeviceControl() {");
-  client.println("            fetch('/api/settings')");
-  client.println("                .then(response => response.json())");
-  client.println("                .then(settings => {");
-  client.println("                    document.getElementById('apModeEnabled').checked = settings.ap_mode_enabled || false;");
-  client.println("                    document.getElementById('clientModeEnabled').checked = settings.client_mode_enabled || false;");
-  client.println("                });");
-  client.println("        }");
-  client.println("");
-  client.println("        function saveDeviceControl() {");
-  client.println("            const control = {");
-  client.println("                ap_mode_enabled: document.getElementById('apModeEnabled').checked,");
-  client.println("                client_mode_enabled: document.getElementById('clientModeEnabled').checked");
-  client.println("            };");
-  client.println("            ");
-  client.println("            fetch('/api/settings', {");
-  client.println("                method: 'POST',");
-  client.println("                headers: { 'Content-Type': 'application/json' },");
-  client.println("                body: JSON.stringify(control)");
-  client.println("            }).then(() => alert('Настройки управления сохранены'));");
-  client.println("        }");
-  client.println("");
-  client.println("        function clearSettings() {");
-  client.println("            if (confirm('Вы уверены, что хотите очистить все настройки?')) {");
-  client.println("                fetch('/api/clear-settings', { method: 'POST' })");
-  client.println("                    .then(() => alert('Настройки очищены'));");
-  client.println("            }");
-  client.println("        }");
-  client.println("");
-  client.println("        function restartDevice() {");
-  client.println("            if (confirm('Перезагрузить устройство?')) {");
-  client.println("                fetch('/api/restart', { method: 'POST' });");
-  client.println("            }");
-  client.println("        }");
-  client.println("");
-  client.println("        document.addEventListener('DOMContentLoaded', function() {");
-  client.println("            loadConnectedDevices();");
-  client.println("            loadAPSettings();");
-  client.println("        });");
-  client.println("    </script>");
-  client.println("</head>");
-  client.println("<body>");
-  client.println("    <div class=\"container\">");
-  client.println("        <h1>ESP8266 Configuration</h1>");
-  client.println("        ");
-  client.println("        <div class=\"tab\">");
-  client.println("            <button class=\"tablinks active\" onclick=\"openTab(event, 'Status')\">Статус</button>");
-  client.println("            <button class=\"tablinks\" onclick=\"openTab(event, 'APSettings')\">Настройки точки доступа</button>");
-  client.println("            <button class=\"tablinks\" onclick=\"openTab(event, 'WiFiScan')\">Сканирование WiFi сетей</button>");
-  client.println("            <button class=\"tablinks\" onclick=\"openTab(event, 'DeviceConfig')\">Настройки устройства</button>");
-  client.println("            <button class=\"tablinks\" onclick=\"openTab(event, 'DeviceControl')\">Управление устройством</button>");
-  client.println("        </div>");
-  
-  // Status Tab
-  client.println("        <div id=\"Status\" class=\"tabcontent\" style=\"display: block;\">");
-  client.println("            <h2>Список подключенных устройств</h2>");
-  client.println("            <div id=\"connectedDevicesTable\"></div>");
-  client.println("        </div>");
-  
-  // APSettings Tab
-  client.println("        <div id=\"APSettings\" class=\"tabcontent\">");
-  client.println("            <h2>Настройки точки доступа</h2>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label for=\"apSsid\">Имя точки доступа (SSID):</label>");
-  client.println("                <input type=\"text\" id=\"apSsid\">");
-  client.println("            </div>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label for=\"apPassword\">Пароль точки доступа:</label>");
-  client.println("                <input type=\"password\" id=\"apPassword\">");
-  client.println("            </div>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label for=\"subnet\">Подсеть (192.168.XXX.1):</label>");
-  client.println("                <select id=\"subnet\"></select>");
-  client.println("            </div>");
-  client.println("            <button onclick=\"saveAPSettings()\">Сохранить настройки AP</button>");
-  client.println("        </div>");
-  
-  // WiFiScan Tab
-  client.println("        <div id=\"WiFiScan\" class=\"tabcontent\">");
-  client.println("            <h2>Сканирование WiFi сетей</h2>");
-  client.println("            <div id=\"wifiStatus\"></div>");
-  client.println("            <button onclick=\"scanWiFi()\">Сканировать сети</button>");
-  client.println("            <button onclick=\"loadWiFiStatus()\">Обновить статус</button>");
-  client.println("            <div id=\"wifiNetworks\"></div>");
-  client.println("        </div>");
-  
-  // DeviceConfig Tab
-  client.println("        <div id=\"DeviceConfig\" class=\"tabcontent\">");
-  client.println("            <h2>Настройки устройства</h2>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label for=\"deviceName\">Имя устройства:</label>");
-  client.println("                <input type=\"text\" id=\"deviceName\">");
-  client.println("            </div>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label for=\"deviceComment\">Комментарий для устройства:</label>");
-  client.println("                <textarea id=\"deviceComment\"></textarea>");
-  client.println("            </div>");
-  client.println("            <button onclick=\"saveDeviceConfig()\">Сохранить настройки устройства</button>");
-  client.println("        </div>");
-  
-  // DeviceControl Tab
-  client.println("        <div id=\"DeviceControl\" class=\"tabcontent\">");
-  client.println("            <h2>Управление устройством</h2>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label>");
-  client.println("                    <input type=\"checkbox\" id=\"apModeEnabled\">");
-  client.println("                    Режим точки доступа");
-  client.println("                </label>");
-  client.println("            </div>");
-  client.println("            <div class=\"form-group\">");
-  client.println("                <label>");
-  client.println("                    <input type=\"checkbox\" id=\"clientModeEnabled\">");
-  client.println("                    Режим клиента WiFi");
-  client.println("                </label>");
-  client.println("            </div>");
-  client.println("            <button onclick=\"saveDeviceControl()\">Сохранить настройки</button>");
-  client.println("            <button onclick=\"clearSettings()\" style=\"background-color: #f44336;\">Очистить настройки</button>");
-  client.println("            <button onclick=\"restartDevice()\" style=\"background-color: #ff9800;\">Перезагрузить устройство</button>");
-  client.println("        </div>");
-  
-  // Modal Window
-  client.println("        <!-- Модальное окно для информации об устройстве -->");
-  client.println("        <div id=\"deviceInfoModal\" class=\"modal\">");
-  client.println("            <div class=\"modal-content\">");
-  client.println("                <span class=\"close\" onclick=\"closeModal()\">&times;</span>");
-  client.println("                <h2>Информация об устройстве</h2>");
-  client.println("                <div class=\"form-group\">");
-  client.println("                    <label for=\"modalDeviceName\">Имя устройства:</label>");
-  client.println("                    <input type=\"text\" id=\"modalDeviceName\">");
-  client.println("                </div>");
-  client.println("                <div class=\"form-group\">");
-  client.println("                    <label for=\"modalDeviceComment\">Комментарий:</label>");
-  client.println("                    <textarea id=\"modalDeviceComment\"></textarea>");
-  client.println("                </div>");
-  client.println("                <input type=\"hidden\" id=\"modalDeviceMac\">");
-  client.println("                <button onclick=\"saveDeviceInfo()\">Сохранить</button>");
-  client.println("            </div>");
-  client.println("        </div>");
-  client.println("    </div>");
-  client.println("</body>");
-  client.println("</html>");
-  
-  client.stop();
+  // Страница лежит во флеше уже сжатой (WebUi.h, собирается из
+  // webui/index.html скриптом webui/build_webui.py) и уходит одним send_P()
+  // кусками по размеру TCP-сегмента. no-cache: браузер хранит копию, но
+  // каждый раз переспрашивает с If-None-Match и до смены прошивки получает
+  // 304 без тела
+  server.sendHeader("ETag", WEB_UI_INDEX_ETAG);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (HttpCache::notModified(server.header("If-None-Match").c_str(), WEB_UI_INDEX_ETAG)) {
+    server.send(304);
+    return;
+  }
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, "text/html", (PGM_P)WEB_UI_INDEX_GZ, WEB_UI_INDEX_GZ_LEN);
 }
 
 void WiFiManager::handleGetSettings() {
@@ -1091,8 +815,11 @@ void WiFiManager::handleApiClearSettings() {
 
 void WiFiManager::handleApiRestart() {
   server.send(200, "application/json", "{\"status\":\"restarting\"}");
-  delay(1000);
-  ESP.restart();
+  
+  // Перезагрузка из update() через секунду: ответ успевает уйти,
+  // а сервер до тех пор продолжает работать
+  restartPending = true;
+  restartAtMs = millis() + 1000;
 }
 
 void WiFiManager::handleNotFound() {
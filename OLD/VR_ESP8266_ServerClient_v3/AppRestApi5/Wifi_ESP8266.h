@@ -9,10 +9,57 @@
 #include <WiFiUdp.h>
 #include <functional>
 #include <vector>
+#include "WiFiJobs.h"
+#include "WebSocketDispatch.h"
+#include "LoopSchedule.h"
+#include "WebSocketFrame.h"
+
+typedef WiFiJobs<ESP8266WiFiClass> ESP8266WiFiJobs;
+
+#define WS_COMMAND_QUEUE_SIZE    8     // команд на клиента, дальше - политика сброса
+#define WS_FRAGMENT_BUFFER_SIZE  1024  // самое длинное собираемое из фрагментов сообщение
+
+// Расписание webSocketLoop() без явных параметров
+#define WS_LOOP_DEFAULT_PERIOD_MS  100
+#define WS_LOOP_DEFAULT_TRIGGERS   (LOOP_TRIGGER_PERIOD | LOOP_TRIGGER_MESSAGE | LOOP_TRIGGER_CONNECT)
+#define WS_LOOP_DEFAULT_BUDGET_US  2000
 
 // Типы колбэков для WebSocket
 typedef std::function<String(const String&)> WebSocketCallback;
 typedef std::function<void()> WebSocketLoopCallback;
+// Без String: сообщение читается на месте, ответ - через sendWebSocketFrame()
+typedef std::function<void(uint8_t num, const WebSocketMessage& message)> WebSocketViewCallback;
+
+// WebSocketsFanoutServer берет защищенные _clients, clientIsConnected() и
+// write() библиотеки arduinoWebSockets: они не часть ее API и проверены
+// только на ветке 2.x начиная с 2.3.5
+#if !defined(WEBSOCKETS_VERSION_INT) || WEBSOCKETS_VERSION_INT < 2003005 || WEBSOCKETS_VERSION_INT >= 3000000
+#error "WebSocketsFanoutServer needs arduinoWebSockets 2.x, 2.3.5 or newer"
+#endif
+
+// WebSocketsServer, который отправляет готовый кадр WebSocketFrame:
+// заголовок закодирован один раз, каждому клиенту уходит один write()
+// тех же байт (sendTXT() на каждого клиента выделяет и копирует буфер)
+class WebSocketsFanoutServer : public WebSocketsServer {
+public:
+  WebSocketsFanoutServer(uint16_t port) : WebSocketsServer(port) {}
+  
+  bool sendWire(uint8_t num, uint8_t* wire, size_t length) {
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return false;
+    WSclient_t* client = &_clients[num];
+    // До конца рукопожатия кадры данных слать нельзя
+    if (client->status != WSC_CONNECTED || !clientIsConnected(client)) return false;
+    return write(client, wire, length) == length;
+  }
+  
+  uint8_t broadcastWire(uint8_t* wire, size_t length) {
+    uint8_t sent = 0;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+      if (sendWire(i, wire, length)) sent++;
+    }
+    return sent;
+  }
+};
 
 // Структура для информации о подключенных устройствах
 struct ConnectedDevice {
@@ -27,7 +74,9 @@ struct WebSocketHandler {
   String path;
   WebSocketCallback callback;
   WebSocketLoopCallback loopCallback;
+  WebSocketViewCallback viewCallback;
   bool useLoopMode;
+  LoopSchedule schedule;  // только для loop-обработчиков
 };
 
 // Расширенная структура для хранения настроек
@@ -56,10 +105,13 @@ public:
   void handleClient();
   void update();
   
-  // Методы работы с WiFi
+  // Методы работы с WiFi (не блокируют: результат - в getWiFiJobs(),
+  // в /api/wifi-status, /api/wifi-scan и в WebSocket WIFI_CONNECT:/WIFI_SCAN:)
   bool connectToWiFi(const char* ssid, const char* password);
   void disconnectFromWiFi();
+  bool startWiFiScan();
   bool scanNetworks(JsonArray& networks);
+  const ESP8266WiFiJobs& getWiFiJobs() const { return wifiJobs; }
   
   // Методы работы с подключенными устройствами
   void updateConnectedDevices();
@@ -68,10 +120,35 @@ public:
   
   // Методы работы с WebSocket
   void webSocket(const String& path, WebSocketCallback callback);
+  void webSocketView(const String& path, WebSocketViewCallback callback);
+  // Loop-обработчик вызывается из update() по периоду и/или событиям
+  // (LOOP_TRIGGER_*) и должен укладываться в budgetUs без delay()
   void webSocketLoop(const String& path, WebSocketLoopCallback loopCallback);
+  void webSocketLoop(const String& path, WebSocketLoopCallback loopCallback,
+                     uint32_t periodMs, uint8_t triggers, uint32_t budgetUs = WS_LOOP_DEFAULT_BUDGET_US);
   void sendWebSocketMessage(uint8_t num, const String& message);
+  void sendWebSocketMessage(uint8_t num, const uint8_t* data, size_t length);
   void sendWebSocketBroadcast(const String& message);
+  void sendWebSocketBroadcast(const uint8_t* data, size_t length);
   String readWebSocketCommand(uint8_t num);
+  bool readWebSocketCommand(uint8_t num, String& command);
+  
+  // Готовый кадр (частые рассылки): без копий и выделений памяти,
+  // заголовок кодируется один раз для всех клиентов
+  template <size_t SIZE>
+  bool sendWebSocketFrame(uint8_t num, WebSocketFrame<SIZE>& frame) {
+    if (!frame.finished() && !frame.finish()) return false;
+    return webSocketServer.sendWire(num, frame.wire(), frame.wireLength());
+  }
+  
+  template <size_t SIZE>
+  uint8_t broadcastWebSocketFrame(WebSocketFrame<SIZE>& frame) {
+    if (!frame.finished() && !frame.finish()) return 0;
+    return webSocketServer.broadcastWire(frame.wire(), frame.wireLength());
+  }
+  
+  void setWebSocketQueuePolicy(CommandQueuePolicy policy);
+  String getWebSocketStats();
   bool isWebSocketClientConnected(uint8_t num);
   void disconnectWebSocketClient(uint8_t num);
   
@@ -108,19 +185,27 @@ public:
 
 private:
   ESP8266WebServer server;
-  WebSocketsServer webSocketServer;
+  WebSocketsFanoutServer webSocketServer;
   WiFiSettings settings;
   ConnectedDevice connectedDevices[10];
   int connectedDevicesCount;
   
-  // WebSocket обработчики
+  // Подключение и скан в фоне; перезагрузка - после отправки ответа
+  ESP8266WiFiJobs wifiJobs;
+  bool restartPending;
+  unsigned long restartAtMs;
+  
+  // WebSocket обработчики; клиент привязан к одному из них по пути URL
   std::vector<WebSocketHandler> webSocketHandlers;
-  std::vector<String> webSocketCommands[10]; // Буфер команд для каждого клиента
+  WebSocketRoutes webSocketRoutes;
+  CommandQueue<String, WS_COMMAND_QUEUE_SIZE> webSocketCommands[WS_DISPATCH_MAX_CLIENTS]; // Буфер команд для каждого клиента
+  FragmentBuffer<WS_FRAGMENT_BUFFER_SIZE> webSocketFragments;
   
   void setupWiFi();
   void setupWebServer();
   void setupAPMode();
   void loadDefaultSettings();
+  void onWiFiJobChange(bool connectChanged);
   
   // Обработчики маршрутов
   void handleRoot();
@@ -135,6 +220,9 @@ private:
   // Обработчики WebSocket
   void handleWebSocketEvent(uint8_t num, WStype_t type, uint8_t * payload, size_t length);
   void processWebSocketLoopHandlers();
+  bool hasQueuedWebSocketCommands(size_t route);
+  uint8_t findWebSocketRoute(const char* url);
+  void dispatchWebSocketText(uint8_t num, const WebSocketMessage& message);
 };
 
 extern WiFiManager wifiManager;
@@ -0,0 +1,63 @@
+"""
+Сборка веб-интерфейса WiFiManager в WebUi.h
+
+Страница настройки (webui/index.html) хранится во флеше уже сжатой gzip
+и отдается handleRoot() одним send_P() с Content-Encoding: gzip. ETag -
+первые 16 символов SHA-1 от сжатых байт, поэтому меняется только вместе
+со страницей, и браузер после перепрошивки не возьмет старую из кэша.
+
+Запуск после правки index.html (из папки скетча):
+  python3 webui/build_webui.py
+Результат - WebUi.h рядом с Wifi_ESP8266.cpp. Нужна только стандартная
+библиотека. mtime=0 делает вывод одинаковым от запуска к запуску.
+"""
+
+import argparse
+import gzip
+import hashlib
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def render(name, page, data, source):
+    etag = hashlib.sha1(data).hexdigest()[:16]
+    lines = [
+        "/*",
+        "  Сгенерировано webui/build_webui.py из webui/%s - не править вручную" % source,
+        "  Исходник: %d байт, gzip: %d байт" % (len(page), len(data)),
+        "*/",
+        "",
+        "#ifndef WEB_UI_H",
+        "#define WEB_UI_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "static const char %s_ETAG[] = \"\\\"%s\\\"\";" % (name, etag),
+        "static const size_t %s_GZ_LEN = %d;" % (name, len(data)),
+        "static const uint8_t %s_GZ[] PROGMEM = {" % name,
+    ]
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    lines += ["};", "", "#endif", ""]
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="webui/index.html -> WebUi.h (gzip в PROGMEM)")
+    parser.add_argument("--input", default="index.html", help="файл в папке webui/")
+    parser.add_argument("--output", default=os.path.join(HERE, "..", "WebUi.h"))
+    args = parser.parse_args()
+
+    with open(os.path.join(HERE, args.input), "rb") as f:
+        page = f.read()
+    data = gzip.compress(page, compresslevel=9, mtime=0)
+    with open(args.output, "w", encoding="utf-8", newline="\n") as f:
+        f.write(render("WEB_UI_INDEX", page, data, args.input))
+    print("%s: %d -> %d байт (%.1f%%)" % (args.input, len(page), len(data), 100.0 * len(data) / len(page)),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -4,6 +4,8 @@
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <WebSocketsServer.h>
+#include <WiFiUdp.h>
+#include "ClockSync.h"
 
 Adafruit_MPU6050 mpu;
 
@@ -23,6 +25,11 @@ float lastSentPitch = 0, lastSentRoll = 0, lastSentYaw = 0;
 float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
 unsigned long lastTime = 0;
+unsigned long lastSampleMicros = 0;   // время отсчета, micros()
+
+// Общее время с хабом (ClockSync.h), ведущий - точка доступа
+WiFiUDP clockSyncUdp;
+ClockSyncClient<WiFiUDP> clockSync(clockSyncUdp);
 
 // Относительный ноль
 float zeroPitch = 0, zeroRoll = 0, zeroYaw = 0;
@@ -173,7 +180,12 @@ void sendSensorData() {
                 ",ACC_PITCH:" + String(accumulatedPitch, 2) +
                 ",ACC_ROLL:" + String(accumulatedRoll, 2) +
                 ",ACC_YAW:" + String(accumulatedYaw, 2) +
-                ",ZERO_SET:" + String(zeroSet ? "true" : "false");
+                ",ZERO_SET:" + String(zeroSet ? "true" : "false") +
+                ",TS:" + String(lastSampleMicros);
+  // Хаб сводит узлы по общему времени
+  if (clockSync.synced()) {
+    data += ",SYNC_US:" + String(clockSync.toShared(lastSampleMicros));
+  }
   
   webSocket.broadcastTXT(data);
   lastSentPitch = pitch;
@@ -608,6 +620,7 @@ void setup() {
     Serial.print(".");
   }
   Serial.println("\nConnected! IP: " + WiFi.localIP().toString());
+  clockSync.begin(WiFi.gatewayIP());
   
   Wire.begin();
   if (!mpu.begin()) {
@@ -645,11 +658,13 @@ void setup() {
 void loop() {
   server.handleClient();
   webSocket.loop();
+  clockSync.poll(micros());
   
   if (!calibrated) return;
   
   sensors_event_t a, g, temp;
   mpu.getEvent(&a, &g, &temp);
+  lastSampleMicros = micros();
   
   unsigned long currentTime = millis();
   float deltaTime = (currentTime - lastTime) / 1000.0;
@@ -5,6 +5,8 @@
 #include <Wire.h>
 #include <Adafruit_MPU6050.h>
 #include <ArduinoJson.h>
+#include <WiFiUdp.h>
+#include "ClockSync.h"
 
 // Настройки WiFi сети
 const char* ssid = "ESP8266_AP";
@@ -33,6 +35,7 @@ const float smoothingFactor = 0.3;
 float gyroOffsetX = 0, gyroOffsetY = 0, gyroOffsetZ = 0;
 bool calibrated = false;
 unsigned long lastTime = 0;
+unsigned long lastSampleMicros = 0;   // время последнего отсчета, micros()
 unsigned long calibrationStart = 0;
 const unsigned long calibrationTime = 3000;
 
@@ -49,6 +52,10 @@ unsigned long lastAutoCalibration = 0;
 unsigned long lastDataSend = 0;
 const unsigned long DATA_SEND_INTERVAL = 50;
 
+// Общее время с хабом (ClockSync.h), ведущий - точка доступа
+WiFiUDP clockSyncUdp;
+ClockSyncClient<WiFiUDP> clockSync(clockSyncUdp);
+
 // Режим работы для плечевой кости
 enum ArmMode {
   ARM_MODE_RELATIVE,    // Относительные углы
@@ -635,6 +642,7 @@ void processSensorData() {
     Serial.println("Ошибка чтения данных MPU6050");
     return;
   }
+  lastSampleMicros = micros();
   
   unsigned long currentTime = millis();
   float deltaTime = (currentTime - lastTime) / 1000.0;
@@ -734,6 +742,11 @@ void sendSensorData() {
   json += "\"calibrated\":" + String(calibrated ? "true" : "false") + ",";
   json += "\"autoCalibration\":" + String(autoCalibrationEnabled ? "true" : "false") + ",";
   json += "\"signal\":" + String(WiFi.RSSI()) + ",";
+  json += "\"sampleUs\":" + String(lastSampleMicros) + ",";
+  // Время отсчета в часах хаба, когда синхронизация есть
+  if (clockSync.synced()) {
+    json += "\"syncUs\":" + String(clockSync.toShared(lastSampleMicros)) + ",";
+  }
   json += "\"timestamp\":" + String(millis());
   json += "}";
   
@@ -996,6 +1009,7 @@ void setup() {
     Serial.print("📡 IP адрес: ");
     Serial.println(WiFi.localIP());
     digitalWrite(LED_BUILTIN, LOW);
+    clockSync.begin(WiFi.gatewayIP());
   } else {
     Serial.println("❌ Не удалось подключиться к WiFi!");
     WiFi.softAP("Shoulder_Sensor", "12345678");
@@ -1036,6 +1050,7 @@ void setup() {
 void loop() {
   server.handleClient();
   webSocket.loop();
+  clockSync.poll(micros());
   
   if (mpuConnected) {
     processSensorData();